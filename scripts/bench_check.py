@@ -0,0 +1,223 @@
+#!/usr/bin/env python3
+"""Morphect benchmark regression gate.
+
+Runs morphect_bench with repetitions, compares the per-benchmark means
+against a stored JSON baseline, and fails with a readable delta report
+when a benchmark slowed down beyond both the relative tolerance and the
+statistical noise bound (combined standard deviations of the baseline
+and current runs). Record a baseline on your machine first:
+
+    scripts/bench_check.py --bench build/morphect_bench --update
+
+then gate later runs:
+
+    scripts/bench_check.py --bench build/morphect_bench
+
+Baselines are machine-specific; the checked-in file is an empty
+skeleton so a fresh checkout reports "no baseline" instead of comparing
+against someone else's hardware.
+"""
+
+import argparse
+import json
+import math
+import os
+import platform
+import subprocess
+import sys
+import time
+
+DEFAULT_BASELINE = os.path.join(
+    os.path.dirname(os.path.dirname(os.path.abspath(__file__))),
+    "tests", "benchmarks", "baseline.json")
+
+
+def run_benchmarks(bench, repetitions, bench_filter):
+    cmd = [
+        bench,
+        "--benchmark_repetitions=%d" % repetitions,
+        "--benchmark_report_aggregates_only=true",
+        "--benchmark_format=json",
+    ]
+    if bench_filter:
+        cmd.append("--benchmark_filter=%s" % bench_filter)
+    result = subprocess.run(cmd, stdout=subprocess.PIPE)
+    if result.returncode != 0:
+        sys.exit("error: %s exited with status %d" % (bench, result.returncode))
+    return json.loads(result.stdout)
+
+
+# JSON keys that are run metadata or time-derived, not user counters
+STANDARD_KEYS = frozenset([
+    "name", "run_name", "run_type", "repetitions", "repetition_index",
+    "threads", "iterations", "aggregate_name", "aggregate_unit",
+    "real_time", "cpu_time", "time_unit", "family_index",
+    "per_family_instance_index", "bytes_per_second", "items_per_second",
+])
+
+
+def collect_stats(report):
+    """Map benchmark name -> {"mean": cpu_time, "stddev": cpu_time,
+    "counters": {counter: mean}} (counters: allocs, peak_rss_kb, ...)."""
+    stats = {}
+    for entry in report.get("benchmarks", []):
+        aggregate = entry.get("aggregate_name")
+        if aggregate not in ("mean", "stddev"):
+            continue
+        name = entry.get("run_name") or entry["name"].rsplit("_", 1)[0]
+        stats.setdefault(name, {})[aggregate] = entry["cpu_time"]
+        if aggregate == "mean":
+            stats[name]["counters"] = {
+                k: v for k, v in entry.items()
+                if k not in STANDARD_KEYS and isinstance(v, (int, float))
+            }
+    return stats
+
+
+def load_baseline(path):
+    if not os.path.exists(path):
+        return None
+    with open(path) as f:
+        return json.load(f)
+
+
+def save_baseline(path, stats, repetitions):
+    baseline = {
+        "recorded": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "host": platform.node(),
+        "machine": platform.machine(),
+        "repetitions": repetitions,
+        "benchmarks": stats,
+    }
+    with open(path, "w") as f:
+        json.dump(baseline, f, indent=2, sort_keys=True)
+        f.write("\n")
+    print("Recorded baseline for %d benchmarks in %s" % (len(stats), path))
+
+
+def fmt_time(ns):
+    if ns >= 1e6:
+        return "%.2f ms" % (ns / 1e6)
+    if ns >= 1e3:
+        return "%.2f us" % (ns / 1e3)
+    return "%.0f ns" % ns
+
+
+def fmt_count(value):
+    if value >= 1e6:
+        return "%.2fM" % (value / 1e6)
+    if value >= 1e3:
+        return "%.1fk" % (value / 1e3)
+    return "%.0f" % value
+
+
+def compare_counters(name, base, cur, tolerance, width):
+    """Gate memory counters (allocs, peak_rss_kb, ...) on relative
+    growth; they have no meaningful per-repetition stddev. Returns the
+    number of regressed counters."""
+    regressions = 0
+    for counter in sorted(set(base) & set(cur)):
+        if base[counter] <= 0:
+            continue
+        rel = (cur[counter] - base[counter]) / base[counter]
+        if rel > tolerance:
+            print("%-*s  %12s  %12s  %+7.1f%%  REGRESSION" %
+                  (width, "  [%s]" % counter, fmt_count(base[counter]),
+                   fmt_count(cur[counter]), rel * 100.0))
+            regressions += 1
+    return regressions
+
+
+def compare(baseline, current, tolerance, sigma, counter_tolerance):
+    """Print the delta report; return the number of regressions."""
+    base_stats = baseline.get("benchmarks", {})
+    regressions = 0
+    improvements = 0
+    width = max([len(n) for n in current] + [24])
+
+    print("%-*s  %12s  %12s  %8s  %s" %
+          (width, "benchmark", "baseline", "current", "delta", "verdict"))
+    for name in sorted(current):
+        cur = current[name]
+        base = base_stats.get(name)
+        if base is None:
+            print("%-*s  %12s  %12s  %8s  new (no baseline; rerun --update)" %
+                  (width, name, "-", fmt_time(cur["mean"]), "-"))
+            continue
+
+        delta = cur["mean"] - base["mean"]
+        rel = delta / base["mean"] if base["mean"] > 0 else 0.0
+        noise = sigma * math.sqrt(base.get("stddev", 0.0) ** 2 +
+                                  cur.get("stddev", 0.0) ** 2)
+
+        verdict = "ok"
+        if delta > base["mean"] * tolerance and delta > noise:
+            verdict = "REGRESSION"
+            regressions += 1
+        elif -delta > base["mean"] * tolerance and -delta > noise:
+            verdict = "improved"
+            improvements += 1
+        print("%-*s  %12s  %12s  %+7.1f%%  %s" %
+              (width, name, fmt_time(base["mean"]), fmt_time(cur["mean"]),
+               rel * 100.0, verdict))
+        regressions += compare_counters(name, base.get("counters", {}),
+                                        cur.get("counters", {}),
+                                        counter_tolerance, width)
+
+    missing = sorted(set(base_stats) - set(current))
+    for name in missing:
+        print("%-*s  %12s  %12s  %8s  missing from this run" %
+              (width, name, fmt_time(base_stats[name]["mean"]), "-", "-"))
+
+    print()
+    print("%d benchmarks: %d regressed, %d improved, %d missing" %
+          (len(current), regressions, improvements, len(missing)))
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare benchmark results against a stored baseline")
+    parser.add_argument("--bench", required=True,
+                        help="path to the morphect_bench binary")
+    parser.add_argument("--baseline", default=DEFAULT_BASELINE,
+                        help="baseline JSON (default: tests/benchmarks/baseline.json)")
+    parser.add_argument("--update", action="store_true",
+                        help="record the current run as the new baseline")
+    parser.add_argument("--repetitions", type=int, default=5,
+                        help="benchmark repetitions per comparison (default 5)")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+                        help="relative slowdown tolerance (default 0.10)")
+    parser.add_argument("--sigma", type=float, default=3.0,
+                        help="noise bound in combined stddevs (default 3.0)")
+    parser.add_argument("--counter-tolerance", type=float, default=0.20,
+                        help="relative growth tolerance for memory counters "
+                             "like allocs and peak_rss_kb (default 0.20)")
+    parser.add_argument("--filter", default=None,
+                        help="benchmark name filter regex")
+    args = parser.parse_args()
+
+    report = run_benchmarks(args.bench, args.repetitions, args.filter)
+    current = collect_stats(report)
+    if not current:
+        sys.exit("error: no benchmark aggregates in output (old benchmark "
+                 "library without --benchmark_report_aggregates_only?)")
+
+    if args.update:
+        save_baseline(args.baseline, current, args.repetitions)
+        return 0
+
+    baseline = load_baseline(args.baseline)
+    if baseline is None or not baseline.get("benchmarks"):
+        print("No baseline recorded at %s" % args.baseline)
+        print("Run with --update to record one; reporting current values only.")
+        for name in sorted(current):
+            print("  %-40s %12s" % (name, fmt_time(current[name]["mean"])))
+        return 0
+
+    return 1 if compare(baseline, current, args.tolerance, args.sigma,
+                        args.counter_tolerance) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -18,18 +18,25 @@
 
 #include "morphect.hpp"
 
+#include "common/identifier_renamer.hpp"
+#include "common/line_matcher.hpp"
+
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <vector>
 #include <string>
-#include <regex>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <deque>
 #include <algorithm>
 #include <cctype>
 #include <optional>
 #include <iomanip>
+#include <atomic>
+#include <thread>
+#include <filesystem>
 
 using namespace morphect;
 
@@ -56,6 +63,10 @@ struct AsmObfConfig {
     double mba_prob = 0.0;
     double dead_code_prob = 0.0;
     double junk_nop_prob = 0.0;
+
+    // Skip detection entirely when the build system already knows the
+    // architecture ("x86_64" or "x86_32"); empty means auto-detect
+    std::string force_architecture;
 };
 
 /**
@@ -63,9 +74,7 @@ struct AsmObfConfig {
  */
 class AssemblyObfuscator {
 public:
-    AssemblyObfuscator() : logger_("ASMObfuscator") {
-        initializeRegisterMaps();
-    }
+    AssemblyObfuscator() : logger_("ASMObfuscator") {}
 
     bool loadConfig(const std::string& config_file) {
         try {
@@ -86,139 +95,194 @@ public:
         config_.transforms_enabled = enabled;
     }
 
+    /**
+     * Detect the target architecture from a bounded prefix of the input.
+     *
+     * Register names show up within the first few instructions of any
+     * real .s file, so scanning the whole text costs an extra pass over
+     * multi-GB inputs just to confirm what the prefix already says. The
+     * result is cached process-wide (every file in a build shares one
+     * architecture, and multi-file workers reuse the first answer), and
+     * the config can force it outright.
+     */
     std::string detectArchitecture(const std::string& code) {
-        std::regex x64_re(R"(\b(?:rax|rbx|rcx|rdx|rsi|rdi|rbp|rsp|r[89]|r1[0-5])\b)", std::regex::icase);
-        if (std::regex_search(code, x64_re)) {
-            return "x86_64";
+        if (!config_.force_architecture.empty()) {
+            return config_.force_architecture;
+        }
+
+        int known = archCache().load();
+        if (known != 0) {
+            return known == 2 ? "x86_32" : "x86_64";
         }
-        std::regex x32_re(R"(\b(?:eax|ebx|ecx|edx|esi|edi|ebp|esp)\b)", std::regex::icase);
-        if (std::regex_search(code, x32_re)) {
-            return "x86_32";
+
+        std::string prefix = code.substr(0, std::min(code.size(), kArchSniffBytes));
+        std::string arch = "x86_64";
+        if (!line_patterns::mentionsX64Register(prefix)) {
+            if (line_patterns::mentionsX32Register(prefix)) {
+                arch = "x86_32";
+            }
         }
-        return "x86_64";
+
+        archCache().store(arch == "x86_32" ? 2 : 1);
+        return arch;
     }
 
     std::string obfuscate(const std::string& asm_code) {
-        detected_arch_ = detectArchitecture(asm_code);
-        logger_.info("Detected architecture: {}", detected_arch_);
-
-        // Parse into lines
-        std::istringstream input(asm_code);
         std::vector<std::string> lines;
-        std::string line;
-        while (std::getline(input, line)) {
-            lines.push_back(line);
-        }
+        prepareLines(asm_code, lines);
 
-        // Pass 1: Collect string literals and labels
-        collectStrings(lines);
-        collectLabels(lines);
+        // Main transformation pass
+        std::vector<std::string> result;
+        TransformState state;
 
-        // Pass 2: Randomize labels if enabled
-        if (config_.enable_label_randomization) {
-            randomizeLabels(lines);
+        for (size_t i = 0; i < lines.size(); i++) {
+            transformLine(lines[i], checkNextUsesFlags(lines, i), state, result);
         }
 
-        // Pass 3: Encrypt strings if enabled
-        if (config_.enable_string_encryption) {
-            encryptStrings(lines);
+        // Build output
+        std::ostringstream output;
+        for (size_t i = 0; i < result.size(); i++) {
+            output << result[i];
+            if (i < result.size() - 1) output << "\n";
         }
+        output << "\n";
 
-        // Pass 4: Main transformation pass
-        std::vector<std::string> result;
-        bool in_function = false;
-        bool after_prologue = false;
+        return output.str();
+    }
 
-        for (size_t i = 0; i < lines.size(); i++) {
-            std::string trimmed = trim(lines[i]);
+    /**
+     * Obfuscate into a buffered writer. Transformed lines are flushed
+     * in fixed-size chunks as the pass proceeds, so output I/O overlaps
+     * transformation and the result never lives in memory whole.
+     */
+    void obfuscateTo(const std::string& asm_code, OutputWriter& out) {
+        std::vector<std::string> lines;
+        prepareLines(asm_code, lines);
 
-            // Track function boundaries
-            if (trimmed.find(".cfi_startproc") != std::string::npos) {
-                in_function = true;
-                after_prologue = false;
-                result.push_back(lines[i]);
-                continue;
-            }
-            if (trimmed.find(".cfi_endproc") != std::string::npos) {
-                in_function = false;
-                result.push_back(lines[i]);
-                continue;
+        TransformState state;
+        std::vector<std::string> emitted;
+
+        for (size_t i = 0; i < lines.size(); i++) {
+            emitted.clear();
+            transformLine(lines[i], checkNextUsesFlags(lines, i), state, emitted);
+            for (const auto& emitted_line : emitted) {
+                out.appendLine(emitted_line);
             }
+        }
+    }
 
-            // Detect end of prologue (after mov rbp, rsp or first real instruction)
-            if (in_function && !after_prologue) {
-                if (trimmed.find("mov") == 0 && trimmed.find("rbp") != std::string::npos &&
-                    trimmed.find("rsp") != std::string::npos) {
-                    result.push_back(lines[i]);
-                    after_prologue = true;
+    /**
+     * Streaming obfuscation: read, transform and write through a small
+     * sliding window instead of materializing the whole file.
+     *
+     * Every per-instruction transform is line-local and the flag-safety
+     * lookahead only inspects the next few lines, so a fixed window keeps
+     * memory flat regardless of input size. Label randomization runs as a
+     * second streaming pass: labels are collected on the first traversal,
+     * the stream is rewound, and the rewrite pass applies the label map.
+     * The input stream must therefore be seekable (a regular file).
+     */
+    bool obfuscateStream(std::istream& in, std::ostream& out) {
+        // ---- Pass 1: detect architecture, collect labels and strings ----
+        bool saw_x64 = false;
+        bool saw_x32 = false;
+        bool need_arch = config_.force_architecture.empty() && archCache().load() == 0;
+        size_t arch_bytes_scanned = 0;
+        bool pending_string_label = false;
+        std::map<size_t, std::string> string_rewrites;  // line index -> encrypted .byte line
+        std::string line;
+        std::string label;
+        bool dotted;
+        size_t line_num = 0;
+
+        while (std::getline(in, line)) {
+            // Architecture sniffing stops after the bounded prefix
+            if (need_arch && !saw_x64 && arch_bytes_scanned < kArchSniffBytes) {
+                arch_bytes_scanned += line.size() + 1;
+                std::string trimmed = trim(line);
+                if (line_patterns::mentionsX64Register(trimmed)) saw_x64 = true;
+                else if (!saw_x32 && line_patterns::mentionsX32Register(trimmed)) saw_x32 = true;
+            }
 
-                    // Insert prologue obfuscation after frame setup
-                    if (config_.enable_prologue_obfuscation && GlobalRandom::decide(0.3)) {
-                        insertPrologueObfuscation(getIndent(lines[i]), result);
+            if (config_.enable_string_encryption && pending_string_label) {
+                pending_string_label = false;
+                std::string content;
+                if (line_patterns::matchAsciiString(line, content)) {
+                    std::string encrypted = buildEncryptedStringLine(content);
+                    if (!encrypted.empty()) {
+                        string_rewrites[line_num] = std::move(encrypted);
                     }
-                    continue;
                 }
             }
-
-            // Skip labels, directives, comments
-            if (shouldSkipLine(trimmed)) {
-                result.push_back(lines[i]);
-                continue;
+            if (matchLabelDef(line, label, dotted)) {
+                local_labels_.insert(label);
+                if (dotted && isStringConstLabel(label)) {
+                    pending_string_label = true;
+                }
             }
+            line_num++;
+        }
 
-            // Check lookahead for flag usage FIRST - we need this for control flow decisions
-            bool next_uses_flags = checkNextUsesFlags(lines, i);
-            bool current_uses_flags = usesFlags(trimmed);
-            bool current_sets_flags = setsFlags(trimmed);
-
-            // Check for control flow opportunities
-            // IMPORTANT: Don't insert before instructions that USE flags (they depend on previous cmp/test)
-            // ALSO: Don't insert AFTER instructions that SET flags if next instruction USES flags
-            // Because our control flow obfuscation would clobber flags between SET and USE
-            bool safe_for_control_flow = !current_uses_flags && !(current_sets_flags && next_uses_flags);
-            if (in_function && after_prologue && config_.enable_control_flow && safe_for_control_flow) {
-                // Insert opaque predicate before some instructions
-                if (!isControlFlow(trimmed) && GlobalRandom::decide(config_.opaque_predicate_prob)) {
-                    insertOpaquePredicate(getIndent(lines[i]), result);
-                    stats_.increment("opaque_predicates");
-                }
+        if (!config_.force_architecture.empty()) {
+            detected_arch_ = config_.force_architecture;
+        } else if (!need_arch) {
+            detected_arch_ = archCache().load() == 2 ? "x86_32" : "x86_64";
+        } else {
+            detected_arch_ = (saw_x64 || !saw_x32) ? "x86_64" : "x86_32";
+            archCache().store(detected_arch_ == "x86_32" ? 2 : 1);
+        }
+        logger_.info("Detected architecture: {}", detected_arch_);
 
-                // Insert bogus conditional branch
-                if (!isControlFlow(trimmed) && GlobalRandom::decide(config_.bogus_branch_prob)) {
-                    insertBogusBranch(getIndent(lines[i]), result);
-                    stats_.increment("bogus_branches");
-                }
-            }
+        if (config_.enable_label_randomization) {
+            buildLabelMap();
+        }
 
-            // Never transform control flow instructions themselves
-            if (isControlFlow(trimmed)) {
-                result.push_back(lines[i]);
-                continue;
-            }
+        // ---- Pass 2: rewind and rewrite with a sliding window ----
+        in.clear();
+        in.seekg(0);
+        if (!in.good()) {
+            logger_.error("Input stream is not seekable; streaming mode needs a regular file");
+            return false;
+        }
 
-            // Apply transformations
-            if (config_.transforms_enabled && GlobalRandom::decide(config_.global_probability)) {
-                auto transformed = transformInstruction(trimmed, lines[i], next_uses_flags, in_function && after_prologue);
-                if (!transformed.empty()) {
-                    for (const auto& t : transformed) {
-                        result.push_back(t);
-                    }
-                    continue;
-                }
+        // checkNextUsesFlags looks at most 4 lines ahead
+        constexpr size_t kLookahead = 4;
+        std::deque<std::string> window;
+        auto refill = [&]() {
+            std::string next;
+            while (window.size() < kLookahead + 1 && std::getline(in, next)) {
+                window.push_back(std::move(next));
             }
+        };
 
-            result.push_back(lines[i]);
-        }
+        TransformState state;
+        std::vector<std::string> emitted;
+        line_num = 0;
+        refill();
 
-        // Build output
-        std::ostringstream output;
-        for (size_t i = 0; i < result.size(); i++) {
-            output << result[i];
-            if (i < result.size() - 1) output << "\n";
+        while (!window.empty()) {
+            std::string current = std::move(window.front());
+            window.pop_front();
+            refill();
+
+            auto rewrite = string_rewrites.find(line_num);
+            if (rewrite != string_rewrites.end()) {
+                current = rewrite->second;
+                stats_.increment("strings_encrypted");
+            }
+            if (config_.enable_label_randomization) {
+                replaceLabelsInLine(current);
+            }
+
+            emitted.clear();
+            transformLine(current, windowNextUsesFlags(window), state, emitted);
+            for (const auto& emitted_line : emitted) {
+                out << emitted_line << '\n';
+            }
+            line_num++;
         }
-        output << "\n";
 
-        return output.str();
+        return out.good();
     }
 
     void printStatistics() {
@@ -242,8 +306,17 @@ private:
     AsmObfConfig config_;
     std::string detected_arch_ = "unknown";
 
-    // Label tracking
-    std::map<std::string, std::string> label_map_;  // original -> randomized
+    // Architecture sniffing looks at the first few KB of directives only
+    static constexpr size_t kArchSniffBytes = 64 * 1024;
+
+    // Process-wide detection cache: 0 unknown, 1 x86_64, 2 x86_32
+    static std::atomic<int>& archCache() {
+        static std::atomic<int> cached{0};
+        return cached;
+    }
+
+    // Label tracking; renames are bulk-applied in one scan per line
+    IdentifierRenamer label_renamer_;
     std::set<std::string> local_labels_;
     int label_counter_ = 0;
 
@@ -255,154 +328,360 @@ private:
     };
     std::vector<StringInfo> strings_;
 
-    // Register mappings
-    std::map<std::string, std::string> reg_to_parent64_;
-    std::set<std::string> all_registers_;
-
-    void initializeRegisterMaps() {
-        reg_to_parent64_["rax"] = "rax"; reg_to_parent64_["eax"] = "rax";
-        reg_to_parent64_["ax"] = "rax"; reg_to_parent64_["al"] = "rax"; reg_to_parent64_["ah"] = "rax";
-        reg_to_parent64_["rbx"] = "rbx"; reg_to_parent64_["ebx"] = "rbx";
-        reg_to_parent64_["bx"] = "rbx"; reg_to_parent64_["bl"] = "rbx"; reg_to_parent64_["bh"] = "rbx";
-        reg_to_parent64_["rcx"] = "rcx"; reg_to_parent64_["ecx"] = "rcx";
-        reg_to_parent64_["cx"] = "rcx"; reg_to_parent64_["cl"] = "rcx"; reg_to_parent64_["ch"] = "rcx";
-        reg_to_parent64_["rdx"] = "rdx"; reg_to_parent64_["edx"] = "rdx";
-        reg_to_parent64_["dx"] = "rdx"; reg_to_parent64_["dl"] = "rdx"; reg_to_parent64_["dh"] = "rdx";
-        reg_to_parent64_["rsi"] = "rsi"; reg_to_parent64_["esi"] = "rsi";
-        reg_to_parent64_["si"] = "rsi"; reg_to_parent64_["sil"] = "rsi";
-        reg_to_parent64_["rdi"] = "rdi"; reg_to_parent64_["edi"] = "rdi";
-        reg_to_parent64_["di"] = "rdi"; reg_to_parent64_["dil"] = "rdi";
-        reg_to_parent64_["rbp"] = "rbp"; reg_to_parent64_["ebp"] = "rbp";
-        reg_to_parent64_["bp"] = "rbp"; reg_to_parent64_["bpl"] = "rbp";
-        reg_to_parent64_["rsp"] = "rsp"; reg_to_parent64_["esp"] = "rsp";
-        reg_to_parent64_["sp"] = "rsp"; reg_to_parent64_["spl"] = "rsp";
-        for (int i = 8; i <= 15; i++) {
-            std::string base = "r" + std::to_string(i);
-            reg_to_parent64_[base] = base;
-            reg_to_parent64_[base + "d"] = base;
-            reg_to_parent64_[base + "w"] = base;
-            reg_to_parent64_[base + "b"] = base;
-        }
-        for (const auto& [reg, _] : reg_to_parent64_) {
-            all_registers_.insert(reg);
+    /**
+     * Immutable register tables shared by every instance.
+     *
+     * These used to be per-instance members rebuilt by the constructor;
+     * with one obfuscator copied per file in multi-file mode that meant
+     * re-running the string-construction loop for every file. Built once
+     * per process behind a thread-safe local static instead, so spinning
+     * up an obfuscator per file or per worker costs nothing.
+     */
+    static const std::map<std::string, std::string>& regToParent64() {
+        static const std::map<std::string, std::string> table = [] {
+            std::map<std::string, std::string> m;
+            m["rax"] = "rax"; m["eax"] = "rax";
+            m["ax"] = "rax"; m["al"] = "rax"; m["ah"] = "rax";
+            m["rbx"] = "rbx"; m["ebx"] = "rbx";
+            m["bx"] = "rbx"; m["bl"] = "rbx"; m["bh"] = "rbx";
+            m["rcx"] = "rcx"; m["ecx"] = "rcx";
+            m["cx"] = "rcx"; m["cl"] = "rcx"; m["ch"] = "rcx";
+            m["rdx"] = "rdx"; m["edx"] = "rdx";
+            m["dx"] = "rdx"; m["dl"] = "rdx"; m["dh"] = "rdx";
+            m["rsi"] = "rsi"; m["esi"] = "rsi";
+            m["si"] = "rsi"; m["sil"] = "rsi";
+            m["rdi"] = "rdi"; m["edi"] = "rdi";
+            m["di"] = "rdi"; m["dil"] = "rdi";
+            m["rbp"] = "rbp"; m["ebp"] = "rbp";
+            m["bp"] = "rbp"; m["bpl"] = "rbp";
+            m["rsp"] = "rsp"; m["esp"] = "rsp";
+            m["sp"] = "rsp"; m["spl"] = "rsp";
+            for (int i = 8; i <= 15; i++) {
+                std::string base = "r" + std::to_string(i);
+                m[base] = base;
+                m[base + "d"] = base;
+                m[base + "w"] = base;
+                m[base + "b"] = base;
+            }
+            return m;
+        }();
+        return table;
+    }
+
+    static const std::set<std::string>& allRegisters() {
+        static const std::set<std::string> regs = [] {
+            std::set<std::string> s;
+            for (const auto& [reg, _] : regToParent64()) {
+                s.insert(reg);
+            }
+            return s;
+        }();
+        return regs;
+    }
+
+    // ==================== Core Transformation Pass ====================
+
+    // Shared front half of the buffered modes: split into lines, collect
+    // labels and strings, then apply label randomization and encryption
+    void prepareLines(const std::string& asm_code, std::vector<std::string>& lines) {
+        detected_arch_ = detectArchitecture(asm_code);
+        logger_.info("Detected architecture: {}", detected_arch_);
+
+        // Parse into lines
+        std::istringstream input(asm_code);
+        std::string line;
+        while (std::getline(input, line)) {
+            lines.push_back(line);
+        }
+
+        // Pass 1: one shared scan feeds both string discovery and label
+        // collection instead of two separate traversals
+        AsmScan scan = AsmScanner::scan(lines);
+        collectStrings(lines, scan);
+        collectLabels(scan);
+
+        // Pass 2: Randomize labels if enabled
+        if (config_.enable_label_randomization) {
+            randomizeLabels(lines);
+        }
+
+        // Pass 3: Encrypt strings if enabled
+        if (config_.enable_string_encryption) {
+            encryptStrings(lines);
         }
     }
 
-    // ==================== Label Collection & Randomization ====================
+    /**
+     * Function-boundary state threaded through the main transformation
+     * pass, shared by the buffered and streaming modes.
+     */
+    struct TransformState {
+        bool in_function = false;
+        bool after_prologue = false;
+    };
+
+    /**
+     * Transform one input line and append the resulting line(s). The
+     * caller supplies the flag-usage lookahead so the pass works the same
+     * whether the whole file is in memory or only a sliding window.
+     */
+    void transformLine(const std::string& line, bool next_uses_flags,
+                       TransformState& state, std::vector<std::string>& result) {
+        std::string trimmed = trim(line);
+
+        // Track function boundaries
+        if (trimmed.find(".cfi_startproc") != std::string::npos) {
+            state.in_function = true;
+            state.after_prologue = false;
+            result.push_back(line);
+            return;
+        }
+        if (trimmed.find(".cfi_endproc") != std::string::npos) {
+            state.in_function = false;
+            result.push_back(line);
+            return;
+        }
 
-    void collectLabels(const std::vector<std::string>& lines) {
-        std::regex label_re(R"(^\.?(L[A-Za-z0-9_]+):)");
-        for (const auto& line : lines) {
-            std::smatch match;
-            std::string trimmed = trim(line);
-            if (std::regex_search(trimmed, match, label_re)) {
-                std::string label = match[1].str();
-                // Only randomize local labels (starting with .L)
-                if (label[0] == 'L' || (trimmed[0] == '.' && label[0] == 'L')) {
-                    local_labels_.insert(label);
+        // Detect end of prologue (after mov rbp, rsp or first real instruction)
+        if (state.in_function && !state.after_prologue) {
+            if (trimmed.find("mov") == 0 && trimmed.find("rbp") != std::string::npos &&
+                trimmed.find("rsp") != std::string::npos) {
+                result.push_back(line);
+                state.after_prologue = true;
+
+                // Insert prologue obfuscation after frame setup
+                if (config_.enable_prologue_obfuscation && GlobalRandom::decide(0.3)) {
+                    insertPrologueObfuscation(getIndent(line), result);
                 }
+                return;
             }
         }
-    }
 
-    void randomizeLabels(std::vector<std::string>& lines) {
-        // Generate random names for local labels
-        for (const auto& label : local_labels_) {
-            std::string random_name = generateRandomLabel();
-            label_map_[label] = random_name;
-            label_map_["." + label] = "." + random_name;
+        // Skip labels, directives, comments
+        if (shouldSkipLine(trimmed)) {
+            result.push_back(line);
+            return;
         }
 
-        // Replace labels in all lines
-        for (auto& line : lines) {
-            for (const auto& [orig, repl] : label_map_) {
-                size_t pos = 0;
-                while ((pos = line.find(orig, pos)) != std::string::npos) {
-                    // Make sure we're matching a complete label
-                    bool is_word_boundary = true;
-                    if (pos > 0 && (std::isalnum(line[pos-1]) || line[pos-1] == '_')) {
-                        is_word_boundary = false;
-                    }
-                    size_t end_pos = pos + orig.length();
-                    if (end_pos < line.length() && (std::isalnum(line[end_pos]) || line[end_pos] == '_')) {
-                        is_word_boundary = false;
-                    }
+        bool current_uses_flags = usesFlags(trimmed);
+        bool current_sets_flags = setsFlags(trimmed);
+
+        // Check for control flow opportunities
+        // IMPORTANT: Don't insert before instructions that USE flags (they depend on previous cmp/test)
+        // ALSO: Don't insert AFTER instructions that SET flags if next instruction USES flags
+        // Because our control flow obfuscation would clobber flags between SET and USE
+        bool safe_for_control_flow = !current_uses_flags && !(current_sets_flags && next_uses_flags);
+        if (state.in_function && state.after_prologue && config_.enable_control_flow && safe_for_control_flow) {
+            // Insert opaque predicate before some instructions
+            if (!isControlFlow(trimmed) && GlobalRandom::decide(config_.opaque_predicate_prob)) {
+                insertOpaquePredicate(getIndent(line), result);
+                stats_.increment("opaque_predicates");
+            }
 
-                    if (is_word_boundary) {
-                        line.replace(pos, orig.length(), repl);
-                        pos += repl.length();
-                    } else {
-                        pos++;
-                    }
+            // Insert bogus conditional branch
+            if (!isControlFlow(trimmed) && GlobalRandom::decide(config_.bogus_branch_prob)) {
+                insertBogusBranch(getIndent(line), result);
+                stats_.increment("bogus_branches");
+            }
+        }
+
+        // Never transform control flow instructions themselves
+        if (isControlFlow(trimmed)) {
+            result.push_back(line);
+            return;
+        }
+
+        // Apply transformations
+        if (config_.transforms_enabled && GlobalRandom::decide(config_.global_probability)) {
+            auto transformed = transformInstruction(trimmed, line, next_uses_flags,
+                                                    state.in_function && state.after_prologue);
+            if (!transformed.empty()) {
+                for (const auto& t : transformed) {
+                    result.push_back(t);
                 }
+                return;
+            }
+        }
+
+        result.push_back(line);
+    }
+
+    // ==================== Label Collection & Randomization ====================
+
+    /**
+     * Match a local-label definition (`Lfoo:` or `.Lfoo:`) at the start
+     * of a line without regex or trimming allocations.
+     *
+     * The regex collector evaluated `^\.?(L[A-Za-z0-9_]+):` per line and
+     * dominated the collection phase on large generated .s files; this
+     * direct scan is a handful of character tests per line and is bound
+     * by memory bandwidth, so no vectorized matcher is needed on top.
+     * On success `label` holds the name without the leading dot and
+     * `dotted` records whether the definition carried one.
+     */
+    bool matchLabelDef(const std::string& line, std::string& label, bool& dotted) {
+        size_t i = line.find_first_not_of(" \t");
+        if (i == std::string::npos) return false;
+        dotted = (line[i] == '.');
+        if (dotted) i++;
+        if (i >= line.size() || line[i] != 'L') return false;
+
+        size_t start = i;
+        i++;
+        while (i < line.size() &&
+               (std::isalnum(static_cast<unsigned char>(line[i])) || line[i] == '_')) {
+            i++;
+        }
+        if (i == start + 1 || i >= line.size() || line[i] != ':') return false;
+
+        label.assign(line, start, i - start);
+        return true;
+    }
+
+    // String-constant labels look like .LC<n>
+    bool isStringConstLabel(const std::string& label) {
+        if (label.size() < 3 || label[1] != 'C') return false;
+        for (size_t i = 2; i < label.size(); i++) {
+            if (!std::isdigit(static_cast<unsigned char>(label[i]))) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Scan-backed collector: the shared AsmScanner already produced the
+     * label table, so only the local-label filter (names starting with
+     * 'L', same as matchLabelDef) runs here. The streaming mode keeps
+     * using matchLabelDef directly on its sliding window.
+     */
+    void collectLabels(const AsmScan& scan) {
+        for (const auto& def : scan.labels) {
+            if (def.name.size() >= 2 && def.name[0] == 'L') {
+                local_labels_.insert(def.name);
             }
         }
+    }
+
+    void buildLabelMap() {
+        // Generate random names for all local labels in one bulk draw
+        std::vector<std::string> names = generateRandomLabels(local_labels_.size());
+        size_t name_idx = 0;
+        for (const auto& label : local_labels_) {
+            const std::string& random_name = names[name_idx++];
+            label_renamer_.add(label, random_name);
+            label_renamer_.add("." + label, "." + random_name);
+        }
+
+        stats_.increment("labels_randomized", static_cast<int>(label_renamer_.size()));
+    }
+
+    void randomizeLabels(std::vector<std::string>& lines) {
+        buildLabelMap();
+
+        // Replace labels in all lines in a single traversal
+        for (auto& line : lines) {
+            replaceLabelsInLine(line);
+        }
+    }
 
-        stats_.increment("labels_randomized", static_cast<int>(label_map_.size()));
+    /**
+     * Rewrite every mapped label in one scan of the line. Both the bare
+     * ("L42") and dot-prefixed (".L42") forms are registered, so the
+     * shared token scan covers all reference patterns at once.
+     */
+    void replaceLabelsInLine(std::string& line) {
+        // Cheap reject: every mapped label contains an 'L'
+        if (line.find('L') == std::string::npos) return;
+        label_renamer_.applyToLine(line);
     }
 
     std::string generateRandomLabel() {
-        std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-        std::string label = "L";
-        label += chars[GlobalRandom::nextInt(0, static_cast<int>(chars.size()) - 1)];
-        for (int i = 0; i < 8; i++) {
-            label += chars[GlobalRandom::nextInt(0, static_cast<int>(chars.size()) - 1)];
+        return generateRandomLabels(1)[0];
+    }
+
+    /**
+     * Allocate count unique labels in one bulk random draw instead of
+     * one locked RNG call per character. The counter suffix guarantees
+     * uniqueness even if the random parts collide.
+     */
+    std::vector<std::string> generateRandomLabels(size_t count) {
+        static const std::string_view chars =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+        constexpr size_t kRandomChars = 9;
+
+        std::vector<char> pool(count * kRandomChars);
+        GlobalRandom::fillFrom(chars, pool.data(), pool.size());
+
+        std::vector<std::string> labels;
+        labels.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            std::string label = "L";
+            label.append(pool.data() + i * kRandomChars, kRandomChars);
+            label += "_" + std::to_string(label_counter_++);
+            labels.push_back(std::move(label));
         }
-        label += "_" + std::to_string(label_counter_++);
-        return label;
+        return labels;
     }
 
     // ==================== String Collection & Encryption ====================
 
-    void collectStrings(const std::vector<std::string>& lines) {
-        std::regex string_re(R"(^(\.LC\d+):)");
-        std::regex ascii_re(R"delim(\s*\.string\s+"(.*)"|\.ascii\s+"(.*)")delim");
-
-        for (size_t i = 0; i < lines.size(); i++) {
-            std::smatch match;
-            std::string trimmed = trim(lines[i]);
-            if (std::regex_search(trimmed, match, string_re)) {
-                std::string label = match[1].str();
-                // Look for string content on next line
-                if (i + 1 < lines.size()) {
-                    std::smatch str_match;
-                    if (std::regex_search(lines[i + 1], str_match, ascii_re)) {
-                        std::string content = str_match[1].matched ? str_match[1].str() : str_match[2].str();
-                        strings_.push_back({label, content, i});
-                    }
+    void collectStrings(const std::vector<std::string>& lines,
+                        const AsmScan& scan) {
+        // The scan already holds every label definition; only .LC<n>
+        // labels need the string-content probe on their next line
+        for (const auto& def : scan.labels) {
+            if (!def.dotted || def.name.empty() || def.name[0] != 'L' ||
+                !isStringConstLabel(def.name)) {
+                continue;
+            }
+            if (def.line + 1 < lines.size()) {
+                std::string content;
+                if (line_patterns::matchAsciiString(lines[def.line + 1],
+                                                    content)) {
+                    strings_.push_back({"." + def.name, content, def.line});
                 }
             }
         }
     }
 
-    void encryptStrings(std::vector<std::string>& lines) {
-        // For each string, XOR encrypt it and add decryption stub
-        for (const auto& str_info : strings_) {
-            if (str_info.content.length() < 4) continue;  // Skip very short strings
+    /**
+     * XOR-encrypt one string literal and render it as a .byte directive
+     * with the key in a trailing comment. Returns an empty string for
+     * literals too short to bother with.
+     */
+    std::string buildEncryptedStringLine(const std::string& content) {
+        if (content.length() < 4) return "";  // Skip very short strings
 
-            uint8_t key = static_cast<uint8_t>(GlobalRandom::nextInt(1, 255));
-            std::string encrypted;
+        uint8_t key = static_cast<uint8_t>(GlobalRandom::nextInt(1, 255));
+        std::string encrypted;
 
-            for (char c : str_info.content) {
-                encrypted += static_cast<char>(static_cast<uint8_t>(c) ^ key);
-            }
+        for (char c : content) {
+            encrypted += static_cast<char>(static_cast<uint8_t>(c) ^ key);
+        }
 
-            // Convert to hex bytes
-            std::ostringstream hex_bytes;
-            hex_bytes << "\t.byte ";
-            for (size_t i = 0; i < encrypted.size(); i++) {
-                hex_bytes << "0x" << std::hex << std::setfill('0') << std::setw(2)
-                          << (static_cast<unsigned int>(static_cast<uint8_t>(encrypted[i])));
-                if (i < encrypted.size() - 1) hex_bytes << ", ";
-            }
-            hex_bytes << ", 0x00";  // Null terminator (XOR with key)
+        // Convert to hex bytes
+        std::ostringstream hex_bytes;
+        hex_bytes << "\t.byte ";
+        for (size_t i = 0; i < encrypted.size(); i++) {
+            hex_bytes << "0x" << std::hex << std::setfill('0') << std::setw(2)
+                      << (static_cast<unsigned int>(static_cast<uint8_t>(encrypted[i])));
+            if (i < encrypted.size() - 1) hex_bytes << ", ";
+        }
+        hex_bytes << ", 0x00";  // Null terminator (XOR with key)
+
+        return hex_bytes.str() + "  # XOR key: 0x" + toHex(key);
+    }
+
+    void encryptStrings(std::vector<std::string>& lines) {
+        // For each string, XOR encrypt it and replace the directive
+        for (const auto& str_info : strings_) {
+            std::string encrypted_line = buildEncryptedStringLine(str_info.content);
+            if (encrypted_line.empty()) continue;
 
             // Replace the .string directive with encrypted bytes
-            // And add a comment with the key for reference
             for (size_t i = str_info.line_num; i < lines.size() && i < str_info.line_num + 3; i++) {
                 if (lines[i].find(".string") != std::string::npos ||
                     lines[i].find(".ascii") != std::string::npos) {
-                    lines[i] = hex_bytes.str() + "  # XOR key: 0x" + toHex(key);
+                    lines[i] = encrypted_line;
                     stats_.increment("strings_encrypted");
                     break;
                 }
@@ -585,6 +864,12 @@ private:
     }
 
     // ==================== Instruction Transformations ====================
+    //
+    // The LinePattern matchers below (and in the collectors) are
+    // function-local statics built from the line_patterns registry:
+    // each pattern compiles once per process and is shared by every
+    // instance and worker thread. They replaced std::regex, whose
+    // backtracking engine dominated profiles of this tool.
 
     std::vector<std::string> transformInstruction(const std::string& trimmed, const std::string& original,
                                                    bool next_uses_flags, bool in_function) {
@@ -654,12 +939,12 @@ private:
     bool tryTransformAddMBA(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
         // add reg1, reg2 -> (reg1 ^ reg2) + 2*(reg1 & reg2)
         // Only apply to 64-bit register operations to avoid size mismatch
-        std::regex add_re(R"(add\s+(\w+)\s*,\s*(\w+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern add_re = line_patterns::asmBinaryRegReg("add");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, add_re)) {
-            std::string dst = match[1].str();
-            std::string src = match[2].str();
+        if (add_re.match(trimmed, match)) {
+            std::string dst = match.str(0);
+            std::string src = match.str(1);
 
             if (!isRegister(dst) || !isRegister(src)) return false;
             // Only apply to 64-bit registers to avoid size mismatch with r10/r11
@@ -696,12 +981,12 @@ private:
     bool tryTransformSubMBA(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
         // sub reg1, reg2 -> (reg1 ^ reg2) - 2*(~reg1 & reg2)
         // Only apply to 64-bit register operations to avoid size mismatch
-        std::regex sub_re(R"(sub\s+(\w+)\s*,\s*(\w+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern sub_re = line_patterns::asmBinaryRegReg("sub");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, sub_re)) {
-            std::string dst = match[1].str();
-            std::string src = match[2].str();
+        if (sub_re.match(trimmed, match)) {
+            std::string dst = match.str(0);
+            std::string src = match.str(1);
 
             if (!isRegister(dst) || !isRegister(src)) return false;
             if (toLower(dst) == toLower(src)) return false;  // sub reg, reg is zeroing, handle elsewhere
@@ -739,12 +1024,12 @@ private:
     bool tryTransformXorMBA(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
         // xor reg1, reg2 -> (reg1 | reg2) - (reg1 & reg2)
         // Only apply to 64-bit register operations to avoid size mismatch
-        std::regex xor_re(R"(xor\s+(\w+)\s*,\s*(\w+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern xor_re = line_patterns::asmBinaryRegReg("xor");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, xor_re)) {
-            std::string dst = match[1].str();
-            std::string src = match[2].str();
+        if (xor_re.match(trimmed, match)) {
+            std::string dst = match.str(0);
+            std::string src = match.str(1);
 
             if (!isRegister(dst) || !isRegister(src)) return false;
             if (toLower(dst) == toLower(src)) return false;  // xor reg, reg is zeroing
@@ -780,12 +1065,12 @@ private:
     // ==================== Standard Transformations ====================
 
     bool tryTransformXorSelf(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex xor_self(R"(xor\s+(\w+)\s*,\s*(\w+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern xor_self = line_patterns::asmBinaryRegReg("xor");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, xor_self)) {
-            std::string reg1 = match[1].str();
-            std::string reg2 = match[2].str();
+        if (xor_self.match(trimmed, match)) {
+            std::string reg1 = match.str(0);
+            std::string reg2 = match.str(1);
 
             if (toLower(reg1) == toLower(reg2)) {
                 int choice = GlobalRandom::nextInt(0, 2);
@@ -805,12 +1090,12 @@ private:
     }
 
     bool tryTransformSubSelf(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex sub_self(R"(sub\s+(\w+)\s*,\s*(\w+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern sub_self = line_patterns::asmBinaryRegReg("sub");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, sub_self)) {
-            std::string reg1 = match[1].str();
-            std::string reg2 = match[2].str();
+        if (sub_self.match(trimmed, match)) {
+            std::string reg1 = match.str(0);
+            std::string reg2 = match.str(1);
 
             if (toLower(reg1) == toLower(reg2)) {
                 int choice = GlobalRandom::nextInt(0, 1);
@@ -827,12 +1112,12 @@ private:
     }
 
     bool tryTransformMovImm(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex mov_imm(R"(mov\s+(\w+)\s*,\s*(0x[0-9a-fA-F]+|-?\d+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern mov_imm = line_patterns::asmRegImm("mov");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, mov_imm)) {
-            std::string reg = match[1].str();
-            std::string imm_str = match[2].str();
+        if (mov_imm.match(trimmed, match)) {
+            std::string reg = match.str(0);
+            std::string imm_str = match.str(1);
 
             if (!isRegister(reg)) return false;
             if (getParentReg64(reg) == "rsp" || getParentReg64(reg) == "rbp") return false;
@@ -892,12 +1177,12 @@ private:
     }
 
     bool tryTransformIncDec(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex inc_re(R"(inc\s+(\w+))", std::regex::icase);
-        std::regex dec_re(R"(dec\s+(\w+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern inc_re = line_patterns::asmUnaryReg("inc");
+        static const LinePattern dec_re = line_patterns::asmUnaryReg("dec");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, inc_re)) {
-            std::string reg = match[1].str();
+        if (inc_re.match(trimmed, match)) {
+            std::string reg = match.str(0);
             int choice = GlobalRandom::nextInt(0, 2);
             if (choice == 0) {
                 result.push_back(indent + "add " + reg + ", 1");
@@ -910,8 +1195,8 @@ private:
             return true;
         }
 
-        if (std::regex_match(trimmed, match, dec_re)) {
-            std::string reg = match[1].str();
+        if (dec_re.match(trimmed, match)) {
+            std::string reg = match.str(0);
             int choice = GlobalRandom::nextInt(0, 2);
             if (choice == 0) {
                 result.push_back(indent + "sub " + reg + ", 1");
@@ -928,12 +1213,12 @@ private:
     }
 
     bool tryTransformAdd(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex add_reg_imm(R"(add\s+(\w+)\s*,\s*(-?\d+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern add_reg_imm = line_patterns::asmRegDecImm("add");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, add_reg_imm)) {
-            std::string reg = match[1].str();
-            int imm = std::stoi(match[2].str());
+        if (add_reg_imm.match(trimmed, match)) {
+            std::string reg = match.str(0);
+            int imm = std::stoi(match.str(1));
 
             if (imm > 0 && imm < 128 && detected_arch_ == "x86_64" && isRegister(reg)) {
                 std::string parent = getParentReg64(reg);
@@ -948,12 +1233,12 @@ private:
     }
 
     bool tryTransformSub(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex sub_reg_imm(R"(sub\s+(\w+)\s*,\s*(\d+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern sub_reg_imm = line_patterns::asmRegUImm("sub");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, sub_reg_imm)) {
-            std::string reg = match[1].str();
-            int imm = std::stoi(match[2].str());
+        if (sub_reg_imm.match(trimmed, match)) {
+            std::string reg = match.str(0);
+            int imm = std::stoi(match.str(1));
 
             if (imm > 0 && imm < 128) {
                 result.push_back(indent + "add " + reg + ", " + std::to_string(-imm));
@@ -965,12 +1250,12 @@ private:
     }
 
     bool tryTransformMov(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex mov_reg_reg(R"(mov\s+(\w+)\s*,\s*(\w+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern mov_reg_reg = line_patterns::asmBinaryRegReg("mov");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, mov_reg_reg)) {
-            std::string dst = match[1].str();
-            std::string src = match[2].str();
+        if (mov_reg_reg.match(trimmed, match)) {
+            std::string dst = match.str(0);
+            std::string src = match.str(1);
 
             if (!isRegister(dst) || !isRegister(src)) return false;
             if (toLower(dst) == toLower(src)) return false;
@@ -988,12 +1273,12 @@ private:
     }
 
     bool tryTransformCmp(const std::string& trimmed, const std::string& indent, std::vector<std::string>& result) {
-        std::regex cmp_reg_imm(R"(cmp\s+(\w+)\s*,\s*(\d+))", std::regex::icase);
-        std::smatch match;
+        static const LinePattern cmp_reg_imm = line_patterns::asmRegUImm("cmp");
+        LineMatch match;
 
-        if (std::regex_match(trimmed, match, cmp_reg_imm)) {
-            std::string reg = match[1].str();
-            int64_t imm = std::stoll(match[2].str());
+        if (cmp_reg_imm.match(trimmed, match)) {
+            std::string reg = match.str(0);
+            int64_t imm = std::stoll(match.str(1));
 
             if (!isRegister(reg)) return false;
 
@@ -1139,58 +1424,82 @@ private:
         return false;
     }
 
-    bool setsFlags(const std::string& trimmed) {
-        static const std::vector<std::string> flag_setters = {
-            "cmp", "test", "add", "sub", "and", "or", "xor", "inc", "dec",
-            "neg", "not", "shl", "shr", "sar", "sal", "rol", "ror",
-            "adc", "sbb", "imul", "mul", "div", "idiv", "bt", "bts", "btr", "btc"
-        };
-        std::string lower = toLower(trimmed);
-        for (const auto& setter : flag_setters) {
-            if (lower.find(setter) == 0 &&
-                (lower.size() == setter.size() || !std::isalpha(lower[setter.size()]))) {
-                return true;
-            }
+    // Trait bits for classifying mnemonics in one table lookup
+    enum MnemonicTraits : uint8_t {
+        kSetsFlags   = 1 << 0,
+        kUsesFlags   = 1 << 1,
+        kControlFlow = 1 << 2,
+    };
+
+    /**
+     * Classify the leading mnemonic of a trimmed line in one hash probe.
+     *
+     * setsFlags/usesFlags/isControlFlow used to lowercase the whole line
+     * and run chained prefix comparisons against three mnemonic lists for
+     * every instruction, which dominated profiles on large .s files. All
+     * three predicates now share a single table keyed by the lowercased
+     * leading token (mnemonics end at the first non-alpha character, the
+     * same boundary rule the prefix checks enforced). Mnemonics are short
+     * enough for SSO, so the lookup key never allocates.
+     */
+    uint8_t mnemonicTraits(const std::string& trimmed) {
+        static const std::unordered_map<std::string, uint8_t> traits = [] {
+            static const char* const flag_setters[] = {
+                "cmp", "test", "add", "sub", "and", "or", "xor", "inc", "dec",
+                "neg", "not", "shl", "shr", "sar", "sal", "rol", "ror",
+                "adc", "sbb", "imul", "mul", "div", "idiv", "bt", "bts", "btr", "btc"
+            };
+            static const char* const flag_users[] = {
+                "je", "jne", "jz", "jnz", "jg", "jge", "jl", "jle",
+                "ja", "jae", "jb", "jbe", "jo", "jno", "js", "jns",
+                "jp", "jnp", "jc", "jnc",
+                "cmove", "cmovne", "cmovz", "cmovnz", "cmovg", "cmovge",
+                "cmovl", "cmovle", "cmova", "cmovae", "cmovb", "cmovbe",
+                "sete", "setne", "setz", "setnz", "setg", "setge",
+                "setl", "setle", "seta", "setae", "setb", "setbe",
+                "adc", "sbb", "rcl", "rcr"
+            };
+            static const char* const control_flow[] = {
+                "jmp", "je", "jne", "jz", "jnz", "jg", "jge", "jl", "jle",
+                "ja", "jae", "jb", "jbe", "jo", "jno", "js", "jns",
+                "jp", "jnp", "jc", "jnc", "call", "ret", "leave",
+                "loop", "loope", "loopne", "loopz", "loopnz", "syscall", "int"
+            };
+
+            std::unordered_map<std::string, uint8_t> table;
+            for (const char* m : flag_setters) table[m] |= kSetsFlags;
+            for (const char* m : flag_users) table[m] |= kUsesFlags;
+            for (const char* m : control_flow) table[m] |= kControlFlow;
+            return table;
+        }();
+
+        // Slice the leading mnemonic token; longest known mnemonic is 6 chars
+        constexpr size_t kMaxMnemonic = 8;
+        char mnemonic[kMaxMnemonic];
+        size_t len = 0;
+        while (len < trimmed.size() &&
+               std::isalpha(static_cast<unsigned char>(trimmed[len]))) {
+            if (len == kMaxMnemonic) return 0;
+            mnemonic[len] = static_cast<char>(
+                std::tolower(static_cast<unsigned char>(trimmed[len])));
+            len++;
         }
-        return false;
+        if (len == 0) return 0;
+
+        auto it = traits.find(std::string(mnemonic, len));
+        return it != traits.end() ? it->second : 0;
+    }
+
+    bool setsFlags(const std::string& trimmed) {
+        return (mnemonicTraits(trimmed) & kSetsFlags) != 0;
     }
 
     bool usesFlags(const std::string& trimmed) {
-        static const std::vector<std::string> flag_users = {
-            "je", "jne", "jz", "jnz", "jg", "jge", "jl", "jle",
-            "ja", "jae", "jb", "jbe", "jo", "jno", "js", "jns",
-            "jp", "jnp", "jc", "jnc",
-            "cmove", "cmovne", "cmovz", "cmovnz", "cmovg", "cmovge",
-            "cmovl", "cmovle", "cmova", "cmovae", "cmovb", "cmovbe",
-            "sete", "setne", "setz", "setnz", "setg", "setge",
-            "setl", "setle", "seta", "setae", "setb", "setbe",
-            "adc", "sbb", "rcl", "rcr"
-        };
-        std::string lower = toLower(trimmed);
-        for (const auto& user : flag_users) {
-            if (lower.find(user) == 0 &&
-                (lower.size() == user.size() || !std::isalpha(lower[user.size()]))) {
-                return true;
-            }
-        }
-        return false;
+        return (mnemonicTraits(trimmed) & kUsesFlags) != 0;
     }
 
     bool isControlFlow(const std::string& trimmed) {
-        static const std::vector<std::string> control = {
-            "jmp", "je", "jne", "jz", "jnz", "jg", "jge", "jl", "jle",
-            "ja", "jae", "jb", "jbe", "jo", "jno", "js", "jns",
-            "jp", "jnp", "jc", "jnc", "call", "ret", "leave",
-            "loop", "loope", "loopne", "loopz", "loopnz", "syscall", "int"
-        };
-        std::string lower = toLower(trimmed);
-        for (const auto& cf : control) {
-            if (lower.find(cf) == 0 &&
-                (lower.size() == cf.size() || !std::isalpha(lower[cf.size()]))) {
-                return true;
-            }
-        }
-        return false;
+        return (mnemonicTraits(trimmed) & kControlFlow) != 0;
     }
 
     bool checkNextUsesFlags(const std::vector<std::string>& lines, size_t i) {
@@ -1203,14 +1512,27 @@ private:
         return false;
     }
 
+    // Streaming counterpart of checkNextUsesFlags: the window holds the
+    // lines immediately after the one being transformed.
+    bool windowNextUsesFlags(const std::deque<std::string>& window) {
+        size_t limit = std::min<size_t>(window.size(), 4);
+        for (size_t j = 0; j < limit; j++) {
+            std::string next = trim(window[j]);
+            if (!shouldSkipLine(next)) {
+                return usesFlags(next);
+            }
+        }
+        return false;
+    }
+
     std::string getParentReg64(const std::string& reg) {
-        std::string lower = toLower(reg);
-        auto it = reg_to_parent64_.find(lower);
-        return it != reg_to_parent64_.end() ? it->second : "";
+        const auto& table = regToParent64();
+        auto it = table.find(toLower(reg));
+        return it != table.end() ? it->second : "";
     }
 
     bool isRegister(const std::string& operand) {
-        return all_registers_.count(toLower(operand)) > 0;
+        return allRegisters().count(toLower(operand)) > 0;
     }
 
     bool is64BitReg(const std::string& reg) {
@@ -1263,6 +1585,9 @@ private:
             if (asm_settings.has("string_encryption")) {
                 config_.enable_string_encryption = asm_settings["string_encryption"].asBool(true);
             }
+            if (asm_settings.has("architecture")) {
+                config_.force_architecture = asm_settings["architecture"].asString("");
+            }
         }
 
         logger_.info("Loaded configuration (transforms: {})", config_.transforms_enabled ? "enabled" : "disabled");
@@ -1272,10 +1597,14 @@ private:
 void printUsage(const char* program) {
     std::cout << getBanner() << std::endl;
     std::cout << "Usage: " << program << " [options] <input.s> <output.s>" << std::endl;
+    std::cout << "       " << program << " [options] --jobs <n> <file1.s> <file2.s> <file3.s> ..." << std::endl;
     std::cout << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  --config <file>       Configuration file (JSON)" << std::endl;
     std::cout << "  --probability <n>     Global transformation probability (0.0-1.0)" << std::endl;
+    std::cout << "  --stream              Stream the file through a small window (constant memory)" << std::endl;
+    std::cout << "  --jobs <n>, -j <n>    Obfuscate many files on N worker threads; with three" << std::endl;
+    std::cout << "                        or more files, each is rewritten in place" << std::endl;
     std::cout << "  --verbose             Enable verbose output" << std::endl;
     std::cout << "  --help                Show this help" << std::endl;
     std::cout << std::endl;
@@ -1288,11 +1617,81 @@ void printUsage(const char* program) {
     std::cout << "  - Label randomization" << std::endl;
 }
 
+/**
+ * Obfuscate one file. When input and output are the same path, the
+ * result is staged in a temporary file and renamed over the input.
+ */
+bool processAsmFile(AssemblyObfuscator& obfuscator, const std::string& input_file,
+                    const std::string& output_file, bool streaming, bool print_stats) {
+    std::ifstream input(input_file);
+    if (!input.is_open()) {
+        LOG_ERROR("Cannot open input file: {}", input_file);
+        return false;
+    }
+
+    bool in_place = (input_file == output_file);
+    std::string write_path = in_place ? output_file + ".morphect.tmp" : output_file;
+
+    if (streaming) {
+        std::ofstream output(write_path);
+        if (!output.is_open()) {
+            LOG_ERROR("Cannot create output file: {}", write_path);
+            return false;
+        }
+
+        LOG_INFO("Streaming {} -> {}", input_file, output_file);
+        if (!obfuscator.obfuscateStream(input, output)) {
+            LOG_ERROR("Streaming obfuscation failed");
+            return false;
+        }
+    } else {
+        std::string asm_code((std::istreambuf_iterator<char>(input)),
+                             std::istreambuf_iterator<char>());
+        input.close();
+
+        LOG_INFO("Read {} bytes from {}", asm_code.size(), input_file);
+
+        // Output flows through a buffered writer while the pass runs, so
+        // writeback overlaps transformation
+        OutputWriter output(write_path);
+        if (!output.valid()) {
+            LOG_ERROR("Cannot create output file: {}", write_path);
+            return false;
+        }
+        output.preallocate(asm_code.size());
+
+        obfuscator.obfuscateTo(asm_code, output);
+
+        size_t bytes = output.bytesWritten();
+        if (!output.close()) {
+            LOG_ERROR("Write failed: {}", write_path);
+            return false;
+        }
+
+        LOG_INFO("Wrote {} bytes to {}", bytes, output_file);
+    }
+
+    if (in_place) {
+        std::error_code ec;
+        std::filesystem::rename(write_path, output_file, ec);
+        if (ec) {
+            LOG_ERROR("Cannot replace {}: {}", output_file, ec.message());
+            return false;
+        }
+    }
+
+    if (print_stats) {
+        obfuscator.printStatistics();
+    }
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     std::string config_file;
-    std::string input_file;
-    std::string output_file;
+    std::vector<std::string> files;
     double probability = -1;
+    int jobs = 1;
+    bool streaming = false;
     bool verbose = false;
 
     for (int i = 1; i < argc; i++) {
@@ -1302,21 +1701,24 @@ int main(int argc, char* argv[]) {
             config_file = argv[++i];
         } else if (arg == "--probability" && i + 1 < argc) {
             probability = std::stod(argv[++i]);
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            jobs = std::stoi(argv[++i]);
+            if (jobs <= 0) {
+                jobs = static_cast<int>(std::thread::hardware_concurrency());
+            }
+        } else if (arg == "--stream") {
+            streaming = true;
         } else if (arg == "--verbose" || arg == "-v") {
             verbose = true;
         } else if (arg == "--help" || arg == "-h") {
             printUsage(argv[0]);
             return 0;
         } else if (arg[0] != '-') {
-            if (input_file.empty()) {
-                input_file = arg;
-            } else if (output_file.empty()) {
-                output_file = arg;
-            }
+            files.push_back(arg);
         }
     }
 
-    if (input_file.empty() || output_file.empty()) {
+    if (files.size() < 2) {
         printUsage(argv[0]);
         return 1;
     }
@@ -1339,32 +1741,48 @@ int main(int argc, char* argv[]) {
         obfuscator.setGlobalProbability(probability);
     }
 
-    std::ifstream input(input_file);
-    if (!input.is_open()) {
-        LOG_ERROR("Cannot open input file: {}", input_file);
-        return 1;
-    }
-
-    std::string asm_code((std::istreambuf_iterator<char>(input)),
-                         std::istreambuf_iterator<char>());
-    input.close();
-
-    LOG_INFO("Read {} bytes from {}", asm_code.size(), input_file);
+    // Multi-file mode: three or more files are rewritten in place by a
+    // worker pool. Each worker claims files off a shared counter and
+    // copies the configured obfuscator per file, so the register maps
+    // and config are initialized once instead of per process.
+    if (files.size() > 2) {
+        std::atomic<size_t> next_file{0};
+        std::atomic<int> failures{0};
+
+        size_t workers = std::min(static_cast<size_t>(jobs), files.size());
+        if (workers == 0) workers = 1;
+
+        auto worker = [&]() {
+            for (;;) {
+                size_t idx = next_file.fetch_add(1);
+                if (idx >= files.size()) break;
+
+                // Fresh per-file state (labels, strings, stats) from the
+                // configured prototype
+                AssemblyObfuscator local = obfuscator;
+                if (!processAsmFile(local, files[idx], files[idx], streaming, false)) {
+                    failures.fetch_add(1);
+                }
+            }
+        };
 
-    std::string obfuscated = obfuscator.obfuscate(asm_code);
+        if (workers == 1) {
+            worker();
+        } else {
+            std::vector<std::thread> pool;
+            pool.reserve(workers);
+            for (size_t w = 0; w < workers; w++) {
+                pool.emplace_back(worker);
+            }
+            for (auto& t : pool) {
+                t.join();
+            }
+        }
 
-    std::ofstream output(output_file);
-    if (!output.is_open()) {
-        LOG_ERROR("Cannot create output file: {}", output_file);
-        return 1;
+        LOG_INFO("Obfuscated {} files on {} workers, {} failures",
+                 files.size(), workers, failures.load());
+        return failures.load() > 0 ? 1 : 0;
     }
 
-    output << obfuscated;
-    output.close();
-
-    LOG_INFO("Wrote {} bytes to {}", obfuscated.size(), output_file);
-
-    obfuscator.printStatistics();
-
-    return 0;
+    return processAsmFile(obfuscator, files[0], files[1], streaming, true) ? 0 : 1;
 }
@@ -31,6 +31,14 @@
 #include <random>
 #include <string>
 #include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/json_parser.hpp"
+#include "core/statistics.hpp"
 
 // Plugin identification
 int plugin_is_GPL_compatible;
@@ -40,6 +48,9 @@ static struct plugin_info morphect_plugin_info = {
     "Morphect obfuscator plugin.\n"
     "Options:\n"
     "  -fplugin-arg-morphect_plugin-probability=<n>  Probability (0.0-1.0)\n"
+    "  -fplugin-arg-morphect_plugin-config=<file>    JSON configuration file\n"
+    "  -fplugin-arg-morphect_plugin-stats=<file>     Append counters to a shared\n"
+    "                                                record file (merge with morphect-stats)\n"
     "  -fplugin-arg-morphect_plugin-verbose          Enable verbose output\n"  // help
 };
 
@@ -49,13 +60,133 @@ namespace {
 std::mt19937_64 rng(std::random_device{}());
 double global_probability = 0.85;
 bool verbose = false;
+bool fast_mode = false;  // low-overhead preset: cheapest identities, capped density
 int transforms_applied = 0;
+int functions_processed = 0;
+
+// Per-transform counters, collected into the shared record file when
+// the stats= argument is given. Every gcc process under make -j appends
+// its own totals; morphect-stats sums them into the build-wide report.
+int add_transforms = 0;
+int sub_transforms = 0;
+int xor_transforms = 0;
+int and_transforms = 0;
+int or_transforms = 0;
+std::string stats_path;
 
 bool decide(double prob) {
     std::uniform_real_distribution<double> dist(0.0, 1.0);
     return dist(rng) < prob;
 }
 
+// ==================== Config file cache ====================
+//
+// The plugin runs inside every gcc process, so under `make -j64` the
+// same JSON config would be parsed 64+ times per second, on the
+// critical path of every TU's compile. The parsed values are published
+// to a small binary sidecar (<config>.cache) keyed by the config's
+// mtime, size, and content hash; only the first compiler process pays
+// the JSON parse, the rest read one fixed-size record.
+
+constexpr uint64_t kConfigCacheMagic = 0x3147464343524F4DULL;  // "MORCCFG1"
+
+struct CachedConfig {
+    uint64_t magic;
+    uint64_t mtime;
+    uint64_t size;
+    uint64_t hash;
+    double probability;
+    uint8_t verbose;
+};
+
+uint64_t fnv1a_hash(const std::string& data) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool load_config_file(const char* path) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "[morphect] Cannot stat config file: %s\n", path);
+        return false;
+    }
+
+    // Reading the (small) config is cheap; parsing it is not
+    std::string contents;
+    if (FILE* f = fopen(path, "rb")) {
+        contents.resize(static_cast<size_t>(st.st_size));
+        size_t got = fread(&contents[0], 1, contents.size(), f);
+        fclose(f);
+        contents.resize(got);
+    } else {
+        fprintf(stderr, "[morphect] Cannot read config file: %s\n", path);
+        return false;
+    }
+    uint64_t hash = fnv1a_hash(contents);
+
+    // Fast path: reuse the sidecar if it matches the current config
+    std::string cache_path = std::string(path) + ".cache";
+    if (FILE* cache = fopen(cache_path.c_str(), "rb")) {
+        CachedConfig entry;
+        bool ok = fread(&entry, sizeof(entry), 1, cache) == 1;
+        fclose(cache);
+        if (ok && entry.magic == kConfigCacheMagic &&
+            entry.mtime == static_cast<uint64_t>(st.st_mtime) &&
+            entry.size == static_cast<uint64_t>(st.st_size) &&
+            entry.hash == hash) {
+            global_probability = entry.probability;
+            verbose = verbose || entry.verbose != 0;
+            return true;
+        }
+    }
+
+    // Slow path: first process parses the JSON
+    try {
+        auto json = morphect::JsonParser::parse(contents);
+        if (json.has("global_probability")) {
+            global_probability = json["global_probability"].asDouble(global_probability);
+        }
+        if (json.has("obfuscation_settings")) {
+            const auto& settings = json["obfuscation_settings"];
+            if (settings.has("global_probability")) {
+                global_probability = settings["global_probability"].asDouble(global_probability);
+            }
+        }
+        if (json.has("verbose")) {
+            verbose = json["verbose"].asBool(false) || verbose;
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "[morphect] Config parse error in %s: %s\n", path, e.what());
+        return false;
+    }
+
+    // Publish atomically; concurrent compiler processes race benignly
+    // (last rename wins, every record is equivalent)
+    CachedConfig entry = {};
+    entry.magic = kConfigCacheMagic;
+    entry.mtime = static_cast<uint64_t>(st.st_mtime);
+    entry.size = static_cast<uint64_t>(st.st_size);
+    entry.hash = hash;
+    entry.probability = global_probability;
+    entry.verbose = verbose ? 1 : 0;
+
+    std::string tmp_path = cache_path + ".tmp." + std::to_string(getpid());
+    if (FILE* out = fopen(tmp_path.c_str(), "wb")) {
+        bool written = fwrite(&entry, sizeof(entry), 1, out) == 1;
+        fclose(out);
+        if (written) {
+            rename(tmp_path.c_str(), cache_path.c_str());
+        } else {
+            remove(tmp_path.c_str());
+        }
+    }
+    return true;
+}
+
 // Check if statement is an MBA candidate
 bool is_mba_candidate(gimple* stmt) {
     if (!is_gimple_assign(stmt)) return false;
@@ -64,6 +195,9 @@ bool is_mba_candidate(gimple* stmt) {
     switch (code) {
         case PLUS_EXPR:
         case MINUS_EXPR:
+            // The add/sub identities cost an extra shift or double NOT;
+            // the fast preset keeps only the cheapest rewrites
+            return !fast_mode;
         case BIT_XOR_EXPR:
         case BIT_AND_EXPR:
         case BIT_IOR_EXPR:
@@ -109,6 +243,7 @@ bool transform_add(gimple_stmt_iterator* gsi, gimple* stmt) {
     gsi_remove(gsi, true);
 
     transforms_applied++;
+    add_transforms++;
     return true;
 }
 
@@ -142,6 +277,7 @@ bool transform_xor(gimple_stmt_iterator* gsi, gimple* stmt) {
     gsi_remove(gsi, true);
 
     transforms_applied++;
+    xor_transforms++;
     return true;
 }
 
@@ -175,6 +311,7 @@ bool transform_and(gimple_stmt_iterator* gsi, gimple* stmt) {
     gsi_remove(gsi, true);
 
     transforms_applied++;
+    and_transforms++;
     return true;
 }
 
@@ -208,6 +345,7 @@ bool transform_or(gimple_stmt_iterator* gsi, gimple* stmt) {
     gsi_remove(gsi, true);
 
     transforms_applied++;
+    or_transforms++;
     return true;
 }
 
@@ -247,6 +385,7 @@ bool transform_sub(gimple_stmt_iterator* gsi, gimple* stmt) {
     gsi_remove(gsi, true);
 
     transforms_applied++;
+    sub_transforms++;
     return true;
 }
 
@@ -273,6 +412,8 @@ unsigned int execute_morphect_pass(function* fun) {
         fprintf(stderr, "[morphect] Processing: %s\n", function_name(fun));
     }
 
+    functions_processed++;
+
     basic_block bb;
     FOR_EACH_BB_FN(bb, fun) {
         gimple_stmt_iterator gsi = gsi_start_bb(bb);
@@ -314,6 +455,23 @@ void print_stats(void*, void*) {
     if (verbose || transforms_applied > 0) {
         fprintf(stderr, "[morphect] Transformations applied: %d\n", transforms_applied);
     }
+
+    // One atomic append per process: concurrent gcc invocations under
+    // make -j share the record file without locks or interleaving
+    if (!stats_path.empty()) {
+        morphect::Statistics stats;
+        stats.set("functions_processed", functions_processed);
+        stats.set("gimple_mba.add_transforms", add_transforms);
+        stats.set("gimple_mba.sub_transforms", sub_transforms);
+        stats.set("gimple_mba.xor_transforms", xor_transforms);
+        stats.set("gimple_mba.and_transforms", and_transforms);
+        stats.set("gimple_mba.or_transforms", or_transforms);
+
+        if (!morphect::StatRecordFile::append(stats_path, stats)) {
+            fprintf(stderr, "[morphect] Cannot append stats to: %s\n",
+                    stats_path.c_str());
+        }
+    }
 }
 
 } // anonymous namespace
@@ -336,14 +494,26 @@ int plugin_init(struct plugin_name_args* plugin_info,
 
         if (strcmp(key, "probability") == 0 && value) {
             global_probability = atof(value);
+        } else if (strcmp(key, "config") == 0 && value) {
+            load_config_file(value);
+        } else if (strcmp(key, "stats") == 0 && value) {
+            stats_path = value;
+        } else if (strcmp(key, "fast") == 0) {
+            fast_mode = true;
         } else if (strcmp(key, "verbose") == 0) {
             verbose = true;
         }
     }
 
+    // Curated low-overhead preset: only the cheap xor/and/or identities,
+    // at a transform density that stays under ~2% runtime overhead
+    if (fast_mode && global_probability > 0.5) {
+        global_probability = 0.5;
+    }
+
     if (verbose) {
-        fprintf(stderr, "[morphect] Plugin loaded, probability: %.0f%%\n",
-                global_probability * 100);
+        fprintf(stderr, "[morphect] Plugin loaded, probability: %.0f%%%s\n",
+                global_probability * 100, fast_mode ? " (fast preset)" : "");
     }
 
     // Register pass
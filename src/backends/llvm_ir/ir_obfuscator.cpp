@@ -25,10 +25,21 @@
  */
 
 #include "morphect.hpp"
+#include "common/ir_tokenizer.hpp"
+#include "common/mapped_file.hpp"
+#include "common/incremental_cache.hpp"
+#include "common/function_intervals.hpp"
+#include "common/transform_trace.hpp"
+#include "common/checkpoint.hpp"
+#include "common/compact_emitter.hpp"
+#include "common/profile_data.hpp"
+#include "common/small_vector.hpp"
+#include "common/locale_prime.hpp"
 #include "passes/cff/cff.hpp"
 #include "passes/data/data.hpp"
 #include "passes/deadcode/deadcode.hpp"
 #include "passes/mba/mba_pass.hpp"
+#include "passes/mba/mba_verifier.hpp"
 
 #include <iostream>
 #include <fstream>
@@ -38,26 +49,30 @@
 #include <regex>
 #include <map>
 #include <set>
+#include <unordered_set>
 #include <algorithm>
 #include <iomanip>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
 
 using namespace morphect;
 
 // Global verbose flag for detailed output
 static bool g_verbose = false;
 
-/**
- * Transformation record for detailed logging
- */
-struct TransformationRecord {
-    std::string function_name;
-    std::string pass_name;
-    std::string operation;
-    std::string original;
-    std::string transformed;
-    int line_number;
-};
-
 /**
  * Function info extracted from IR
  */
@@ -66,7 +81,10 @@ struct FunctionInfo {
     int start_line;
     int end_line;
     int instruction_count;
-    std::vector<std::string> basic_blocks;
+    uint32_t features = 0;  // ir_features bitmap, gathered during parse
+    // Interned labels with inline storage: per-function analysis data
+    // stays contiguous instead of one heap string per block
+    SmallVector<StringInterner::SymbolId, 8> basic_blocks;
 };
 
 /**
@@ -89,6 +107,98 @@ public:
 
     void setVerbose(bool v) { verbose_ = v; g_verbose = v; }
     void setGlobalProbability(double prob) { global_probability_ = prob; }
+    void setMaxExpansionRatio(double ratio) { max_expansion_ratio_ = ratio > 0 ? ratio : 0.0; }
+    void setCompactDeadCode(bool compact) { compact_deadcode_ = compact; }
+    void setJobs(int jobs) { jobs_ = jobs > 0 ? jobs : 1; }
+    void setMmapOutput(bool enable) { mmap_output_ = enable; }
+    bool mmapOutput() const { return mmap_output_; }
+    void setPipelined(bool enable) { pipelined_ = enable; }
+    bool pipelined() const { return pipelined_; }
+    void setCompactOutput(bool enable) { compact_output_ = enable; }
+    bool compactOutput() const { return compact_output_; }
+
+    /**
+     * Stream every transformation record to a binary trace file
+     * (replay with morphect-trace)
+     */
+    bool setTransformTraceFile(const std::string& path) {
+        if (!transform_trace_.openStream(path)) {
+            logger_.warn("Cannot open transform trace file: {}", path);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Enable the incremental function cache under the given directory
+     */
+    bool setCacheDir(const std::string& dir) {
+        cache_enabled_ = cache_.open(dir);
+        if (!cache_enabled_) {
+            logger_.warn("Cannot use cache directory: {}", dir);
+        }
+        return cache_enabled_;
+    }
+
+    /**
+     * Checkpoint this run under the given directory. Completed function
+     * regions persist through the incremental cache as they finish; the
+     * manifest pins the (input, config) identity so --resume can tell a
+     * genuine continuation from a changed input. With resume set, a
+     * matching manifest from a previous run is picked up and only the
+     * remaining functions are transformed - deterministic seeding makes
+     * the spliced output identical to an uninterrupted run.
+     */
+    bool setCheckpointDir(const std::string& dir, bool resume) {
+        if (!setCacheDir(dir)) {
+            return false;
+        }
+        checkpoint_manifest_path_ = dir + "/checkpoint.manifest";
+        checkpoint_resume_ = resume;
+        checkpoint_enabled_ = true;
+        return true;
+    }
+
+    /**
+     * Load a production profile (name/sample-count lines) and exempt
+     * the hottest percent% of profiled functions from expensive passes
+     * (CFF dispatch); cheap passes still obfuscate them.
+     */
+    bool loadHotFunctionProfile(const std::string& path, double percent) {
+        HotFunctionProfile profile;
+        if (!profile.loadFile(path)) {
+            logger_.warn("Cannot read profile: {}", path);
+            return false;
+        }
+
+        std::vector<std::string> hottest = profile.hottestPercent(percent);
+        std::sort(hottest.begin(), hottest.end());
+
+        // The exemption set changes transformed output, so cache keys
+        // must see it (configFingerprint folds this hash in)
+        std::string joined;
+        for (const auto& name : hottest) {
+            hot_functions_.insert(name);
+            joined += name;
+            joined += ',';
+        }
+        hot_profile_hash_ = IncrementalCache::hashText(joined);
+
+        fprintf(stderr, "[morphect] Profile: %zu of %zu functions exempted "
+                "from expensive passes\n",
+                hot_functions_.size(), profile.size());
+
+        // Keep the full sample counts: --hot-layout orders the output
+        // by them, not just by the exemption set
+        profile_ = std::move(profile);
+        return true;
+    }
+
+    /**
+     * Order emitted function regions hot-first using the loaded
+     * profile (see applyProfileLayout)
+     */
+    void setHotLayout(bool enable) { hot_layout_ = enable; }
 
     // Enable/disable individual passes
     void setEnableMBA(bool enable) { enable_mba_ = enable; }
@@ -101,13 +211,208 @@ public:
     /**
      * Full obfuscation pipeline with detailed logging
      */
-    std::string obfuscateFull(const std::string& ir_code) {
-        transformations_.clear();
+    std::string obfuscateFull(std::string_view ir_code) {
+        return joinLines(obfuscateLines(ir_code));
+    }
+
+    /**
+     * Run the pipeline and emit straight into a pre-sized mapping,
+     * skipping the joined in-memory copy of the whole module.
+     * Returns the bytes written.
+     */
+    size_t obfuscateTo(std::string_view ir_code, MappedOutputFile& out) {
+        for (const auto& line : obfuscateLines(ir_code)) {
+            out.appendLine(line);
+        }
+        return out.written();
+    }
+
+    /**
+     * Pipelined single-module path: reader feeds function indices to
+     * transform workers through a bounded queue, and a writer thread
+     * commits finished regions to the output in original order - so a
+     * transformed prefix streams to disk while later regions are still
+     * being processed, instead of write I/O serializing after the whole
+     * transform. Returns false when a module-level pass (string
+     * encoding) needs the complete result, so the caller falls back.
+     */
+    bool obfuscatePipelinedTo(std::string_view ir_code, OutputWriter& out) {
+        // Module-level stages (string encoding, profile layout) need
+        // the complete result; the caller falls back
+        if (enable_string_enc_ || hot_layout_) {
+            return false;
+        }
+
+        transform_trace_.clear();
+        pass_stats_.clear();
+
+        std::vector<std::string> lines = splitLines(ir_code);
+        std::vector<FunctionInfo> functions = parseFunctions(lines);
+        buildFunctionIndex(functions);
+
+        if (checkpoint_enabled_) {
+            openCheckpoint(ir_code, functions.size());
+        }
+
+        logPassStart("Pipelined transformation");
+        size_t workers = std::max(size_t{1},
+                                  std::min(static_cast<size_t>(jobs_), functions.size()));
+        fprintf(stderr, "[morphect] │  %zu functions, %zu transform workers + writer\n",
+                functions.size(), workers);
+
+        struct DoneRegion {
+            size_t idx = 0;
+            std::vector<std::string> region;
+        };
+
+        BoundedQueue<size_t> work(64);
+        BoundedQueue<DoneRegion> done(64);
+        std::mutex stats_mutex;
+
+        auto transform_worker = [&]() {
+            std::map<std::string, int> local_stats;
+
+            size_t idx;
+            while (work.pop(idx)) {
+                const auto& func = functions[idx];
+                std::vector<std::string> region(
+                    lines.begin() + func.start_line,
+                    lines.begin() + func.end_line + 1);
+
+                GlobalRandom::ScopedLocal scoped_rng(LocalRandom::deriveSeed(
+                    GlobalRandom::get().getSeed(), func.name));
+                ScopedTrace trace(func.name, "function");
+
+                if (cache_enabled_) {
+                    uint64_t key = IncrementalCache::combine(
+                        IncrementalCache::hashLines(region), configFingerprint());
+                    auto cached = cache_.lookup(key);
+                    if (cached.has_value()) {
+                        local_stats["IncrementalCache_hits"]++;
+                        if (checkpoint_enabled_) checkpoint_.markDone(idx);
+                        done.push(DoneRegion{idx, std::move(*cached)});
+                        continue;
+                    }
+                    transformFunctionRegion(region, local_stats, func.name,
+                                            func.features);
+                    cache_.store(key, region);
+                    if (checkpoint_enabled_) checkpoint_.markDone(idx);
+                    local_stats["IncrementalCache_misses"]++;
+                } else {
+                    transformFunctionRegion(region, local_stats, func.name,
+                                            func.features);
+                }
+                done.push(DoneRegion{idx, std::move(region)});
+            }
+
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            for (const auto& [key, val] : local_stats) {
+                pass_stats_[key] += val;
+            }
+        };
+
+        // Writer: reorder out-of-order completions and commit regions
+        // (with the untouched lines between them) in module order
+        auto writer = [&]() {
+            std::map<size_t, std::vector<std::string>> pending;
+            size_t line_idx = 0;
+
+            // Compact emission stays streaming here: the emitter works
+            // line-at-a-time, so regions compact as they commit
+            CompactEmitter emitter;
+            std::string compacted;
+            auto emit = [&](const std::string& line) {
+                if (!compact_output_) {
+                    out.appendLine(line);
+                } else if (emitter.compactLine(line, compacted)) {
+                    out.appendLine(compacted);
+                }
+            };
+
+            for (size_t f = 0; f < functions.size(); f++) {
+                const auto& func = functions[f];
+                if (func.end_line < func.start_line) continue;
+
+                while (pending.find(f) == pending.end()) {
+                    DoneRegion d;
+                    if (!done.pop(d)) break;
+                    pending.emplace(d.idx, std::move(d.region));
+                }
+                auto it = pending.find(f);
+                if (it == pending.end()) break;  // stream ended early
+
+                while (line_idx < lines.size() &&
+                       line_idx < static_cast<size_t>(func.start_line)) {
+                    emit(lines[line_idx++]);
+                }
+                for (const auto& line : it->second) {
+                    emit(line);
+                }
+                pending.erase(it);
+                line_idx = static_cast<size_t>(func.end_line) + 1;
+            }
+            while (line_idx < lines.size()) {
+                emit(lines[line_idx++]);
+            }
+        };
+
+        morphect::primeLocaleCaches();
+
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t i = 0; i < workers; i++) {
+            pool.emplace_back(transform_worker);
+        }
+        std::thread writer_thread(writer);
+
+        // Reader stage: feed function indices in order
+        for (size_t idx = 0; idx < functions.size(); idx++) {
+            if (functions[idx].end_line < functions[idx].start_line) continue;
+            work.push(idx);
+        }
+        work.close();
+        for (auto& t : pool) {
+            t.join();
+        }
+        done.close();
+        writer_thread.join();
+
+        int total = 0;
+        for (const auto& [key, val] : pass_stats_) {
+            (void)key;
+            total += val;
+        }
+        logPassEnd("Pipelined transformation", total);
+        return true;
+    }
+
+    /**
+     * Output size estimate for pre-sizing the mapping: input size plus
+     * a per-pass expansion margin (generous is cheap - close() truncates
+     * to the actual size, and a short estimate costs a remap)
+     */
+    size_t estimateOutputBytes(size_t input_bytes) const {
+        double factor = 1.1;
+        if (enable_mba_) factor += 0.5;
+        if (enable_cff_) factor += 0.8;
+        if (enable_bogus_) factor += 0.5;
+        if (enable_var_split_) factor += 0.3;
+        if (enable_string_enc_) factor += 0.2;
+        if (enable_dead_code_) factor += 0.5;
+        return static_cast<size_t>(static_cast<double>(input_bytes) * factor) + 4096;
+    }
+
+    /**
+     * The pipeline proper: transformed module as lines
+     */
+    std::vector<std::string> obfuscateLines(std::string_view ir_code) {
+        transform_trace_.clear();
         pass_stats_.clear();
 
         // Parse functions from IR
         std::vector<std::string> lines = splitLines(ir_code);
         std::vector<FunctionInfo> functions = parseFunctions(lines);
+        buildFunctionIndex(functions);
 
         if (verbose_) {
             logHeader("IR Analysis");
@@ -119,6 +424,28 @@ public:
             fprintf(stderr, "\n");
         }
 
+        // Region mode (parallel, incremental, and/or profile-guided):
+        // function-local passes run per region, module-level passes
+        // (string encoding) run afterwards on the result. Profile
+        // exemptions are per function, so they route through here too.
+        if ((jobs_ > 1 || cache_enabled_ || !hot_functions_.empty()) &&
+            !functions.empty()) {
+            if (checkpoint_enabled_) {
+                openCheckpoint(ir_code, functions.size());
+            }
+            lines = obfuscateParallel(lines, functions);
+
+            if (enable_string_enc_) {
+                lines = applyStringEncodingPass(lines, functions);
+            }
+
+            if (hot_layout_) {
+                lines = applyProfileLayout(lines);
+            }
+
+            return compact_output_ ? compactEmit(lines) : lines;
+        }
+
         // Apply passes with detailed logging
         if (enable_mba_) {
             lines = applyMBAPass(lines, functions);
@@ -144,7 +471,93 @@ public:
             lines = applyDeadCodePass(lines, functions);
         }
 
-        return joinLines(lines);
+        if (hot_layout_) {
+            lines = applyProfileLayout(lines);
+        }
+
+        return compact_output_ ? compactEmit(lines) : lines;
+    }
+
+    /**
+     * Profile-driven output layout. Obfuscation scatters generated
+     * functions (string decoders, call proxies) among real code, which
+     * costs I-cache and iTLB density in the final binary. This final
+     * stage reorders whole function regions: profiled functions first,
+     * hottest leading, then unprofiled code in original order, and
+     * generated cold helpers sunk to the end of the module. Module-
+     * level lines (globals, metadata) keep their relative order; LLVM
+     * accepts forward references, so only function placement moves.
+     */
+    std::vector<std::string> applyProfileLayout(const std::vector<std::string>& lines) {
+        std::vector<FunctionInfo> functions = parseFunctions(lines);
+        if (functions.size() < 2) {
+            return lines;
+        }
+        for (const auto& func : functions) {
+            if (func.end_line < func.start_line) {
+                return lines;  // malformed region; keep the input layout
+            }
+        }
+
+        // Generated helpers are cold by construction
+        auto isGeneratedHelper = [](const std::string& name) {
+            return name.rfind("__morphect", 0) == 0 ||
+                   name.rfind("_proxy_", 0) == 0;
+        };
+
+        std::vector<size_t> order(functions.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) {
+                int tier_a = isGeneratedHelper(functions[a].name) ? 1 : 0;
+                int tier_b = isGeneratedHelper(functions[b].name) ? 1 : 0;
+                if (tier_a != tier_b) return tier_a < tier_b;
+                // Stability keeps unprofiled (zero-sample) functions
+                // and the helper tier in original order
+                return profile_.samples(functions[a].name) >
+                       profile_.samples(functions[b].name);
+            });
+
+        std::vector<std::string> out;
+        out.reserve(lines.size() + functions.size());
+
+        // Module prelude stays on top
+        for (int i = 0; i < functions.front().start_line; i++) {
+            out.push_back(lines[i]);
+        }
+
+        size_t hot = 0, helpers = 0;
+        for (size_t idx : order) {
+            const auto& func = functions[idx];
+            if (isGeneratedHelper(func.name)) {
+                helpers++;
+            } else if (profile_.samples(func.name) > 0) {
+                hot++;
+            }
+            if (!out.empty() && !out.back().empty()) {
+                out.push_back("");
+            }
+            for (int i = func.start_line; i <= func.end_line; i++) {
+                out.push_back(lines[i]);
+            }
+        }
+
+        // Module-level lines between and after functions, original order
+        for (size_t k = 0; k < functions.size(); k++) {
+            int from = functions[k].end_line + 1;
+            int to = (k + 1 < functions.size())
+                ? functions[k + 1].start_line
+                : static_cast<int>(lines.size());
+            for (int i = from; i < to; i++) {
+                out.push_back(lines[i]);
+            }
+        }
+
+        fprintf(stderr, "[morphect] Layout: %zu profiled hot-first, "
+                "%zu generated helpers sunk, %zu functions total\n",
+                hot, helpers, functions.size());
+        pass_stats_["ProfileLayout"] = static_cast<int>(functions.size());
+        return out;
     }
 
     /**
@@ -165,35 +578,102 @@ public:
         fprintf(stderr, "[morphect] ─────────────────────────────────\n");
         fprintf(stderr, "[morphect] Total transformations: %d\n", total);
 
+        // Memory accounting: peak-RSS growth attributed per pass
+        if (!pass_rss_growth_.empty() || MemoryTracker::peakRssKb() > 0) {
+            fprintf(stderr, "[morphect] ─────────────────────────────────\n");
+            for (const auto& [pass, kb] : pass_rss_growth_) {
+                fprintf(stderr, "[morphect] %s: +%zu KiB peak RSS\n", pass.c_str(), kb);
+            }
+            fprintf(stderr, "[morphect] Peak RSS: %zu KiB\n", MemoryTracker::peakRssKb());
+            size_t allocs = AllocationCounter::count().load();
+            if (allocs > 0) {
+                fprintf(stderr, "[morphect] Allocations: %zu (%zu KiB)\n",
+                        allocs, AllocationCounter::bytes().load() / 1024);
+            }
+        }
+
         // Print per-function breakdown if verbose
-        if (verbose_ && !transformations_.empty()) {
+        if (verbose_ && !transform_trace_.empty()) {
             fprintf(stderr, "\n");
             logHeader("Per-Function Details");
 
-            std::map<std::string, std::vector<TransformationRecord>> by_function;
-            for (const auto& t : transformations_) {
-                by_function[t.function_name].push_back(t);
-            }
+            std::map<std::string, std::map<std::string, int>> by_function;
+            transform_trace_.forEach([&](std::string_view func, std::string_view pass,
+                                         std::string_view op, int line) {
+                (void)op;
+                (void)line;
+                by_function[std::string(func)][std::string(pass)]++;
+            });
 
-            for (const auto& [func, records] : by_function) {
+            for (const auto& [func, pass_counts] : by_function) {
                 fprintf(stderr, "[morphect] Function: %s\n", func.c_str());
-                std::map<std::string, int> pass_counts;
-                for (const auto& r : records) {
-                    pass_counts[r.pass_name]++;
-                }
                 for (const auto& [pass, count] : pass_counts) {
                     fprintf(stderr, "[morphect]   %s: %d\n", pass.c_str(), count);
                 }
             }
+            if (transform_trace_.dropped() > 0) {
+                fprintf(stderr, "[morphect] (ring kept the last %zu records, %zu older dropped)\n",
+                        transform_trace_.size(), transform_trace_.dropped());
+            }
         }
 
         fprintf(stderr, "\n");
     }
 
+    /**
+     * Snapshot the per-pass counters as a Statistics object for the
+     * metrics exporter, with the config fingerprint attached so fleet
+     * dashboards can slice runs by configuration
+     */
+    Statistics exportStatistics() const {
+        Statistics stats;
+        int total = 0;
+        for (const auto& [pass, count] : pass_stats_) {
+            stats.set(pass, count);
+            total += count;
+        }
+        stats.set("total_transformations", total);
+        // As a double so exporters treat it as a gauge, not a counter
+        stats.set("peak_rss_kb", static_cast<double>(MemoryTracker::peakRssKb()));
+
+        // Cost-model estimate of added runtime work: counter keys are
+        // "<stage>" or "<stage>_<op>", so the prefix names the pass
+        double predicted = 0.0;
+        for (const auto& [pass, count] : pass_stats_) {
+            std::string stage = pass.substr(0, pass.find('_'));
+            predicted += passCost(stagePassId(stage)).cycles * count;
+        }
+        stats.set("predicted_overhead_cycles", predicted);
+
+        char fingerprint[17];
+        snprintf(fingerprint, sizeof(fingerprint), "%016llx",
+                 static_cast<unsigned long long>(configFingerprint()));
+        stats.set("config_fingerprint", std::string(fingerprint));
+        return stats;
+    }
+
 private:
     Logger logger_;
     bool verbose_ = false;
     double global_probability_ = 0.85;
+    double max_expansion_ratio_ = 0.0;  // per-function output budget (0 = unlimited)
+    bool compact_deadcode_ = false;     // fewer, volatile-anchored dead-code blocks
+    int jobs_ = 1;
+    bool mmap_output_ = false;
+    bool pipelined_ = false;
+    bool compact_output_ = false;  // strip comments, shorten generated names
+    IncrementalCache cache_;
+    bool cache_enabled_ = false;
+    std::unordered_set<std::string> hot_functions_;  // exempt from expensive passes
+    uint64_t hot_profile_hash_ = 0;
+    HotFunctionProfile profile_;  // full sample counts for --hot-layout
+    bool hot_layout_ = false;
+    StringInterner block_labels_;  // backing table for FunctionInfo::basic_blocks
+    CheckpointManifest checkpoint_;
+    bool checkpoint_enabled_ = false;
+    bool checkpoint_resume_ = false;
+    std::string checkpoint_manifest_path_;
+    FunctionIntervalIndex function_index_;  // line -> function attribution
 
     // Pass enable flags
     bool enable_mba_ = false;
@@ -204,8 +684,10 @@ private:
     bool enable_dead_code_ = false;
 
     // Tracking
-    std::vector<TransformationRecord> transformations_;
+    TransformTrace transform_trace_;
     std::map<std::string, int> pass_stats_;
+    std::map<std::string, size_t> pass_rss_growth_;
+    size_t pass_rss_before_ = 0;
 
     void logHeader(const std::string& title) {
         fprintf(stderr, "[morphect] ═══════════════════════════════════\n");
@@ -215,9 +697,18 @@ private:
 
     void logPassStart(const std::string& pass_name) {
         fprintf(stderr, "[morphect] ┌─ %s\n", pass_name.c_str());
+        TraceRecorder::get().begin(pass_name, "pass");
+        pass_rss_before_ = MemoryTracker::peakRssKb();
     }
 
     void logPassEnd(const std::string& pass_name, int count) {
+        // Peak RSS only moves when a pass pushes the high-water mark, so
+        // the delta names the pass that grew the process
+        size_t peak_after = MemoryTracker::peakRssKb();
+        if (peak_after > pass_rss_before_) {
+            pass_rss_growth_[pass_name] += peak_after - pass_rss_before_;
+        }
+        TraceRecorder::get().end(pass_name, "pass");
         fprintf(stderr, "[morphect] └─ %s complete: %d transformations\n\n", pass_name.c_str(), count);
     }
 
@@ -226,52 +717,59 @@ private:
         if (verbose_) {
             fprintf(stderr, "[morphect] │  [%s] %s: %s\n", func.c_str(), op.c_str(), detail.c_str());
         }
+        transform_trace_.record(func, pass, op);
         pass_stats_[pass]++;
     }
 
     /**
-     * Parse functions from LLVM IR
+     * Parse functions from LLVM IR (single tokenizer sweep, no regex)
      */
     std::vector<FunctionInfo> parseFunctions(const std::vector<std::string>& lines) {
         std::vector<FunctionInfo> functions;
-        std::regex define_re(R"(define\s+.*@([\w.]+)\s*\()");
-        std::regex bb_re(R"(^(\w+):)");
 
         FunctionInfo* current = nullptr;
         int instr_count = 0;
 
         for (size_t i = 0; i < lines.size(); i++) {
-            const std::string& line = lines[i];
-            std::string trimmed = trim(line);
-
-            std::smatch match;
-            if (std::regex_search(line, match, define_re)) {
-                if (current) {
-                    current->end_line = static_cast<int>(i) - 1;
-                    current->instruction_count = instr_count;
-                }
-                functions.push_back(FunctionInfo{});
-                current = &functions.back();
-                current->name = match[1].str();
-                current->start_line = static_cast<int>(i);
-                instr_count = 0;
-            } else if (current) {
-                if (trimmed == "}") {
-                    current->end_line = static_cast<int>(i);
-                    current->instruction_count = instr_count;
-                    current = nullptr;
-                } else if (std::regex_match(trimmed, match, bb_re)) {
-                    current->basic_blocks.push_back(match[1].str());
-                } else if (!trimmed.empty() && trimmed[0] != ';' && trimmed[0] != '!') {
-                    // Count as instruction
-                    if (trimmed.find('=') != std::string::npos ||
-                        trimmed.find("ret ") == 0 ||
-                        trimmed.find("br ") == 0 ||
-                        trimmed.find("store ") == 0 ||
-                        trimmed.find("call ") == 0) {
+            auto rec = IRTokenizer::tokenizeLine(lines[i], i);
+
+            switch (rec.kind) {
+                case IRLineKind::FunctionBegin:
+                    if (current) {
+                        current->end_line = static_cast<int>(i) - 1;
+                        current->instruction_count = instr_count;
+                    }
+                    functions.push_back(FunctionInfo{});
+                    current = &functions.back();
+                    current->name = std::string(rec.name);
+                    current->start_line = static_cast<int>(i);
+                    instr_count = 0;
+                    break;
+
+                case IRLineKind::FunctionEnd:
+                    if (current) {
+                        current->end_line = static_cast<int>(i);
+                        current->instruction_count = instr_count;
+                        current = nullptr;
+                    }
+                    break;
+
+                case IRLineKind::Label:
+                    if (current) {
+                        current->basic_blocks.push_back(
+                            block_labels_.intern(rec.name));
+                    }
+                    break;
+
+                case IRLineKind::Instruction:
+                    if (current) {
                         instr_count++;
+                        current->features |= ir_features::classifyOpcode(rec.opcode);
                     }
-                }
+                    break;
+
+                default:
+                    break;
             }
         }
 
@@ -279,15 +777,365 @@ private:
     }
 
     /**
-     * Get function name at a given line
+     * (Re)build the interval index from the parsed function list
      */
-    std::string getFunctionAt(const std::vector<FunctionInfo>& functions, int line) {
+    void buildFunctionIndex(const std::vector<FunctionInfo>& functions) {
+        function_index_.clear();
         for (const auto& func : functions) {
-            if (line >= func.start_line && line <= func.end_line) {
-                return func.name;
+            function_index_.add(func.name, func.start_line, func.end_line);
+        }
+        function_index_.build();
+    }
+
+    /**
+     * Get function name at a given line (binary search, not a scan)
+     */
+    std::string getFunctionAt(int line) const {
+        return function_index_.nameAt(line);
+    }
+
+    /**
+     * Fingerprint of everything besides the function body that affects
+     * its transformed output: active passes, probability, and RNG seed
+     */
+    uint64_t configFingerprint() const {
+        std::ostringstream oss;
+        oss << enable_mba_ << enable_cff_ << enable_bogus_
+            << enable_var_split_ << enable_dead_code_
+            << global_probability_ << ':'
+            << max_expansion_ratio_ << ':'
+            << compact_deadcode_ << ':'
+            << hot_profile_hash_ << ':'
+            << GlobalRandom::get().getSeed() << ':'
+            << MORPHECT_VERSION_STRING;
+        return IncrementalCache::hashText(oss.str());
+    }
+
+    /**
+     * Open the run's checkpoint manifest. A resume only counts when the
+     * previous manifest matches this exact input and config - otherwise
+     * stale regions from a different run could be spliced in - so on any
+     * mismatch the checkpoint silently starts fresh.
+     */
+    void openCheckpoint(std::string_view ir_code, size_t total_functions) {
+        uint64_t input_hash = IncrementalCache::hashText(ir_code);
+        uint64_t fingerprint = configFingerprint();
+
+        if (checkpoint_resume_ &&
+            checkpoint_.load(checkpoint_manifest_path_, input_hash, fingerprint)) {
+            fprintf(stderr, "[morphect] Resuming: %zu of %zu functions already complete\n",
+                    checkpoint_.doneCount(), total_functions);
+            return;
+        }
+        if (checkpoint_resume_) {
+            logger_.warn("Checkpoint does not match this input/config; starting fresh");
+        }
+        if (!checkpoint_.create(checkpoint_manifest_path_, input_hash, fingerprint)) {
+            logger_.warn("Cannot write checkpoint manifest: {}", checkpoint_manifest_path_);
+            checkpoint_enabled_ = false;
+        }
+    }
+
+    /**
+     * Apply the function-local passes to a single function region.
+     * Each worker uses its own pass instances, so regions never share state.
+     * Stats are collected locally and merged by the caller.
+     */
+    void transformFunctionRegion(std::vector<std::string>& region,
+                                 std::map<std::string, int>& stats,
+                                 const std::string& func_name = std::string(),
+                                 uint32_t features = kAllFeatures) {
+        for (const std::string& stage : enabledStageNames()) {
+            if (hotFunctionExempt(stage, func_name)) continue;
+            // Applicability gate: a stage whose opcode classes don't
+            // appear in the function cannot match; skip its full scan
+            uint32_t required = stageRequiredFeatures(stage);
+            if (required != 0 && (required & features) == 0) {
+                stats["stages_skipped_inapplicable"]++;
+                continue;
+            }
+            applyRegionStage(stage, region, stats);
+        }
+    }
+
+    // "run everything" default for callers without a parsed FunctionInfo
+    static constexpr uint32_t kAllFeatures = ~0u;
+
+    /**
+     * ir_features bitmap a region stage can act on (same masks as the
+     * pass classes report via requiredFeatures); 0 = always applicable
+     */
+    static uint32_t stageRequiredFeatures(const std::string& stage) {
+        if (stage == "MBA") {
+            return ir_features::kIntArith | ir_features::kMul | ir_features::kBitwise;
+        }
+        if (stage == "CFF") return ir_features::kBranch | ir_features::kSwitch;
+        if (stage == "Bogus") return ir_features::kBranch;
+        if (stage == "VarSplit") return ir_features::kMemory;
+        return 0;  // DeadCode inserts anywhere
+    }
+
+    /**
+     * PassId of a region stage, for the cost table
+     */
+    static PassId stagePassId(const std::string& stage) {
+        if (stage == "MBA") return PassId::MBA;
+        if (stage == "CFF") return PassId::CFF;
+        if (stage == "Bogus") return PassId::BogusControlFlow;
+        if (stage == "VarSplit") return PassId::VariableSplitting;
+        if (stage == "DeadCode") return PassId::DeadCode;
+        return PassId::Unknown;
+    }
+
+    /**
+     * Profile-guided exemption: hot functions skip expensive stages
+     * (per the cost table) but still get the cheap ones
+     */
+    bool hotFunctionExempt(const std::string& stage,
+                           const std::string& func_name) const {
+        if (hot_functions_.empty() || func_name.empty()) return false;
+        if (!isExpensivePass(stagePassId(stage))) return false;
+        return hot_functions_.count(func_name) > 0;
+    }
+
+    /**
+     * Names of the enabled function-local stages, in pass order
+     */
+    std::vector<std::string> enabledStageNames() const {
+        std::vector<std::string> stages;
+        if (enable_mba_) stages.push_back("MBA");
+        if (enable_cff_) stages.push_back("CFF");
+        if (enable_bogus_) stages.push_back("Bogus");
+        if (enable_var_split_) stages.push_back("VarSplit");
+        if (enable_dead_code_) stages.push_back("DeadCode");
+        return stages;
+    }
+
+    /**
+     * Apply one function-local pass stage to a region. Stages are the
+     * task granularity of the scheduler, so a big function's pipeline
+     * can spread across workers instead of pinning one.
+     */
+    void applyRegionStage(const std::string& stage,
+                          std::vector<std::string>& region,
+                          std::map<std::string, int>& stats) {
+        if (stage == "MBA") {
+            mba::LLVMMBAPass mba_pass;
+            mba::MBAPassConfig mba_config;
+            mba_config.global.enabled = true;
+            mba_config.global.probability = global_probability_;
+            mba_config.global.nesting_depth = 1;
+            mba_pass.initializeMBA(mba_config);
+
+            if (mba_pass.transformIR(region) == TransformResult::Success) {
+                for (const auto& [key, val] : mba_pass.getStatistics()) {
+                    if (val > 0 && key.find("_applied") != std::string::npos) {
+                        stats["MBA_" + key.substr(0, key.find("_applied"))] += val;
+                    }
+                }
+            }
+        }
+
+        if (stage == "CFF") {
+            cff::LLVMCFFPass cff_pass;
+            cff::CFFConfig cff_config;
+            cff_config.enabled = true;
+            cff_config.probability = global_probability_;
+            cff_config.shuffle_states = true;
+            cff_config.add_bogus_cases = true;
+            cff_pass.setCFFConfig(cff_config);
+
+            if (cff_pass.transformIR(region) == TransformResult::Success) {
+                for (const auto& [key, val] : cff_pass.getStatistics()) {
+                    if (val > 0) stats["CFF_" + key] += val;
+                }
+            }
+        }
+
+        if (stage == "Bogus") {
+            cff::LLVMBogusPass bogus_pass;
+            cff::BogusConfig bogus_config;
+            bogus_config.enabled = true;
+            bogus_config.probability = global_probability_;
+            bogus_config.generate_dead_code = true;
+            bogus_config.use_real_variables = true;
+            bogus_pass.setBogusConfig(bogus_config);
+
+            if (bogus_pass.transformIR(region) == TransformResult::Success) {
+                for (const auto& [key, val] : bogus_pass.getStatistics()) {
+                    if (val > 0) stats["Bogus_" + key] += val;
+                }
+            }
+        }
+
+        if (stage == "VarSplit") {
+            data::LLVMVariableSplittingPass split_pass;
+            data::VariableSplittingConfig split_config;
+            split_config.enabled = true;
+            split_config.probability = global_probability_;
+            split_config.split_phi_nodes = true;
+            split_config.max_splits_per_function = 5;
+            split_config.exclude_patterns = {
+                "%_op_", "%_cff_", "%_dead", "%split_", "%reconst_", "%_arith", "%mba_"
+            };
+            split_config.max_expansion_ratio = max_expansion_ratio_;
+            split_pass.configure(split_config);
+
+            if (split_pass.transformIR(region) == TransformResult::Success) {
+                for (const auto& [key, val] : split_pass.getStatistics()) {
+                    if (val > 0) stats["VarSplit_" + key] += val;
+                }
+            }
+        }
+
+        if (stage == "DeadCode") {
+            deadcode::LLVMDeadCodePass dead_pass;
+            deadcode::DeadCodeConfig dead_config;
+            dead_config.enabled = true;
+            dead_config.probability = global_probability_;
+            dead_config.max_blocks = 5;
+            dead_config.use_block_pool = true;
+            dead_config.max_expansion_ratio = max_expansion_ratio_;
+            dead_config.compact_profile = compact_deadcode_;
+            dead_pass.setDeadCodeConfig(dead_config);
+
+            if (dead_pass.transformIR(region) == TransformResult::Success) {
+                for (const auto& [key, val] : dead_pass.getStatistics()) {
+                    if (val > 0) stats["DeadCode_" + key] += val;
+                }
+            }
+        }
+    }
+
+    /**
+     * Parallel per-function obfuscation.
+     *
+     * Builds a (stage, function) task graph - each function's enabled
+     * pass stages chained in pass order - and runs it on the
+     * work-stealing scheduler, so a huge function's pipeline spreads
+     * across workers instead of pinning one while the rest idle. The
+     * transformed regions are then stitched back into the module in
+     * their original order; lines outside any function (globals,
+     * declarations, metadata) pass through untouched.
+     */
+    std::vector<std::string> obfuscateParallel(const std::vector<std::string>& lines,
+                                               const std::vector<FunctionInfo>& functions) {
+        size_t workers = std::min(static_cast<size_t>(jobs_), functions.size());
+        std::vector<std::string> stages = enabledStageNames();
+
+        logPassStart("Parallel transformation");
+        fprintf(stderr, "[morphect] │  %zu functions x %zu stages across %zu worker threads\n",
+                functions.size(), stages.size(), workers);
+
+        std::vector<std::vector<std::string>> regions(functions.size());
+        std::vector<char> cache_hit(functions.size(), 0);
+        std::vector<uint64_t> cache_keys(functions.size(), 0);
+        std::mutex stats_mutex;
+
+        auto merge_stats = [&](const std::map<std::string, int>& local_stats) {
+            std::lock_guard<std::mutex> lock(stats_mutex);
+            for (const auto& [key, val] : local_stats) {
+                pass_stats_[key] += val;
+            }
+        };
+
+        WorkStealingScheduler scheduler;
+
+        for (size_t idx = 0; idx < functions.size(); idx++) {
+            const auto& func = functions[idx];
+            if (func.end_line < func.start_line) continue;
+
+            // Prep stage: slice the region and consult the cache; a hit
+            // makes every later stage of this function a no-op
+            auto prep = scheduler.addTask([&, idx]() {
+                const auto& f = functions[idx];
+                regions[idx].assign(lines.begin() + f.start_line,
+                                    lines.begin() + f.end_line + 1);
+
+                if (cache_enabled_) {
+                    cache_keys[idx] = IncrementalCache::combine(
+                        IncrementalCache::hashLines(regions[idx]),
+                        configFingerprint());
+
+                    auto cached = cache_.lookup(cache_keys[idx]);
+                    if (cached.has_value()) {
+                        cache_hit[idx] = 1;
+                        regions[idx] = std::move(*cached);
+                        if (checkpoint_enabled_) checkpoint_.markDone(idx);
+                        std::map<std::string, int> local_stats;
+                        local_stats["IncrementalCache_hits"]++;
+                        merge_stats(local_stats);
+                    }
+                }
+            });
+
+            // One task per enabled pass stage, chained in pass order
+            WorkStealingScheduler::TaskId prev = prep;
+            for (const auto& stage : stages) {
+                prev = scheduler.addTask([&, idx, stage]() {
+                    if (cache_hit[idx]) return;
+                    const auto& f = functions[idx];
+                    if (hotFunctionExempt(stage, f.name)) return;
+
+                    // Deterministic per-stage stream: the seed depends only
+                    // on (global seed, function name, stage), never on
+                    // which worker steals the task, so output is stable
+                    GlobalRandom::ScopedLocal scoped_rng(LocalRandom::deriveSeed(
+                        GlobalRandom::get().getSeed(), f.name + ":" + stage));
+
+                    ScopedTrace trace(f.name + ":" + stage, "stage");
+
+                    std::map<std::string, int> local_stats;
+                    applyRegionStage(stage, regions[idx], local_stats);
+                    merge_stats(local_stats);
+                }, {prev});
+            }
+
+            if (cache_enabled_) {
+                scheduler.addTask([&, idx]() {
+                    if (cache_hit[idx]) return;
+                    cache_.store(cache_keys[idx], regions[idx]);
+                    if (checkpoint_enabled_) checkpoint_.markDone(idx);
+                    std::map<std::string, int> local_stats;
+                    local_stats["IncrementalCache_misses"]++;
+                    merge_stats(local_stats);
+                }, {prev});
+            }
+        }
+
+        scheduler.run(workers);
+
+        // Stitch: copy non-function lines as-is, splice transformed regions
+        std::vector<std::string> result;
+        result.reserve(lines.size());
+
+        size_t line_idx = 0;
+        for (size_t f = 0; f < functions.size(); f++) {
+            const auto& func = functions[f];
+            if (func.end_line < func.start_line) continue;
+
+            while (line_idx < lines.size() &&
+                   line_idx < static_cast<size_t>(func.start_line)) {
+                result.push_back(lines[line_idx++]);
+            }
+
+            for (auto& line : regions[f]) {
+                result.push_back(std::move(line));
             }
+            line_idx = static_cast<size_t>(func.end_line) + 1;
+        }
+        while (line_idx < lines.size()) {
+            result.push_back(lines[line_idx++]);
         }
-        return "<global>";
+
+        int total = 0;
+        for (const auto& [key, val] : pass_stats_) {
+            (void)key;
+            total += val;
+        }
+        logPassEnd("Parallel transformation", total);
+
+        return result;
     }
 
     /**
@@ -330,13 +1178,9 @@ private:
                     transformations += val;
                     pass_stats_["MBA_" + op] = val;
 
-                    // Record for per-function summary
-                    TransformationRecord rec;
-                    rec.function_name = "<all>";
-                    rec.pass_name = "MBA";
-                    rec.operation = op;
+                    // Record for per-function summary and the trace file
                     for (int i = 0; i < val; i++) {
-                        transformations_.push_back(rec);
+                        transform_trace_.record("<all>", "MBA", op);
                     }
                 }
             }
@@ -430,6 +1274,7 @@ private:
         split_config.exclude_patterns = {
             "%_op_", "%_cff_", "%_dead", "%split_", "%reconst_", "%_arith", "%mba_"
         };
+        split_config.max_expansion_ratio = max_expansion_ratio_;
         split_pass.configure(split_config);
 
         std::vector<std::string> result = lines;
@@ -496,6 +1341,9 @@ private:
         dead_config.enabled = true;
         dead_config.probability = global_probability_;
         dead_config.max_blocks = 5;
+        dead_config.use_block_pool = true;
+        dead_config.max_expansion_ratio = max_expansion_ratio_;
+        dead_config.compact_profile = compact_deadcode_;
         dead_pass.setDeadCodeConfig(dead_config);
 
         std::vector<std::string> result = lines;
@@ -531,14 +1379,36 @@ private:
         return count;
     }
 
-    std::vector<std::string> splitLines(const std::string& text) {
-        std::vector<std::string> lines;
-        std::istringstream stream(text);
-        std::string line;
-        while (std::getline(stream, line)) {
-            lines.push_back(line);
-        }
-        return lines;
+    std::vector<std::string> splitLines(std::string_view text) {
+        // LineTable slices without per-line copies; lines a pass rewrites
+        // are materialized below, everything else is copied once here
+        LineTable table(text);
+        return table.materialize();
+    }
+
+    /**
+     * Compact emission: drop comment/blank lines and shorten generated
+     * identifiers, so downstream clang/llc re-lexes less text
+     */
+    std::vector<std::string> compactEmit(const std::vector<std::string>& lines) {
+        CompactEmitter emitter;
+
+        size_t before = 0;
+        for (const auto& line : lines) before += line.size() + 1;
+
+        std::vector<std::string> result = emitter.compact(lines);
+
+        size_t after = 0;
+        for (const auto& line : result) after += line.size() + 1;
+
+        pass_stats_["CompactEmit_renamed"] +=
+            static_cast<int>(emitter.renamedCount());
+        fprintf(stderr, "[morphect] Compact emission: %zu -> %zu bytes (%.0f%%), "
+                "%zu identifiers shortened\n",
+                before, after,
+                before > 0 ? 100.0 * static_cast<double>(after) / static_cast<double>(before) : 100.0,
+                emitter.renamedCount());
+        return result;
     }
 
     std::string joinLines(const std::vector<std::string>& lines) {
@@ -593,22 +1463,1304 @@ private:
 };
 
 /**
- * Print usage
+ * Read, obfuscate and write one input/output pair with an already
+ * configured obfuscator. Returns 0 on success.
  */
-void printUsage(const char* program) {
-    std::cout << getBanner() << std::endl;
-    std::cout << "Usage: " << program << " [options] <input.ll> <output.ll>" << std::endl;
+int processOneFile(LLVMIRObfuscator& obfuscator,
+                   const std::string& input_file,
+                   const std::string& output_file,
+                   bool print_stats) {
+    // Read input: mmap avoids copying multi-GB modules into a string,
+    // fall back to stream reading if the file can't be mapped
+    MappedFile mapped(input_file);
+    std::string fallback_buffer;
+    std::string_view ir_code;
+
+    if (input_file == "-") {
+        // Pipe mode: slurp stdin (pipes can't be mapped)
+        fallback_buffer.assign((std::istreambuf_iterator<char>(std::cin)),
+                               std::istreambuf_iterator<char>());
+        ir_code = fallback_buffer;
+    } else if (mapped.valid()) {
+        ir_code = mapped.view();
+    } else {
+        std::ifstream input(input_file);
+        if (!input.is_open()) {
+            std::cerr << "[morphect] Error: Cannot open input file: " << input_file << std::endl;
+            return 1;
+        }
+        fallback_buffer.assign((std::istreambuf_iterator<char>(input)),
+                               std::istreambuf_iterator<char>());
+        ir_code = fallback_buffer;
+    }
+
+    fprintf(stderr, "[morphect] Read %zu bytes from %s\n", ir_code.size(), input_file.c_str());
+
+    size_t output_bytes = 0;
+    bool written = false;
+
+    if (obfuscator.pipelined()) {
+        // Overlapped I/O: finished regions stream to disk while later
+        // regions transform; falls through when a module-level pass
+        // needs the complete result
+        OutputWriter output(output_file);
+        if (!output.valid()) {
+            std::cerr << "[morphect] Error: Cannot create output file: " << output_file << std::endl;
+            return 1;
+        }
+        if (obfuscator.obfuscatePipelinedTo(ir_code, output)) {
+            output_bytes = output.bytesWritten();
+            if (!output.close()) {
+                std::cerr << "[morphect] Error: Write failed: " << output_file << std::endl;
+                return 1;
+            }
+            written = true;
+        } else {
+            fprintf(stderr, "[morphect] Pipelined mode needs function-local passes only; "
+                    "falling back\n");
+        }
+    }
+
+    if (written) {
+        // Output already streamed
+    } else if (obfuscator.mmapOutput()) {
+        // Mmap mode: emit into a pre-sized mapping, no joined copy
+        MappedOutputFile output(output_file,
+                                obfuscator.estimateOutputBytes(ir_code.size()));
+        if (!output.valid()) {
+            std::cerr << "[morphect] Error: Cannot map output file: " << output_file << std::endl;
+            return 1;
+        }
+        output_bytes = obfuscator.obfuscateTo(ir_code, output);
+        if (!output.close()) {
+            std::cerr << "[morphect] Error: Write failed: " << output_file << std::endl;
+            return 1;
+        }
+    } else {
+        // Obfuscate
+        std::string obfuscated = obfuscator.obfuscateFull(ir_code);
+
+        // Write output through the shared buffered writer
+        OutputWriter output(output_file);
+        if (!output.valid()) {
+            std::cerr << "[morphect] Error: Cannot create output file: " << output_file << std::endl;
+            return 1;
+        }
+        output.preallocate(obfuscated.size());
+        output.append(obfuscated);
+        if (!output.close()) {
+            std::cerr << "[morphect] Error: Write failed: " << output_file << std::endl;
+            return 1;
+        }
+        output_bytes = obfuscated.size();
+    }
+
+    fprintf(stderr, "[morphect] Wrote %zu bytes to %s\n", output_bytes, output_file.c_str());
+
+    // Size statistics
+    if (!ir_code.empty()) {
+        double increase = ((double)output_bytes / ir_code.size() - 1.0) * 100.0;
+        fprintf(stderr, "[morphect] Size change: %+.1f%%\n", increase);
+    }
+
+    if (print_stats) {
+        obfuscator.printStatistics();
+    }
+
+    return 0;
+}
+
+/**
+ * One input/output pair from a batch list file
+ */
+struct BatchJob {
+    std::string input;
+    std::string output;
+};
+
+/**
+ * Parse a batch list: one "input output" pair per line, blank lines and
+ * #-comments skipped
+ */
+bool loadBatchList(const std::string& path, std::vector<BatchJob>& jobs) {
+    std::ifstream list(path);
+    if (!list.is_open()) {
+        std::cerr << "[morphect] Error: Cannot open batch list: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(list, line)) {
+        std::istringstream iss(line);
+        BatchJob job;
+        if (!(iss >> job.input)) continue;       // blank line
+        if (job.input[0] == '#') continue;       // comment
+        if (!(iss >> job.output)) {
+            std::cerr << "[morphect] Error: Batch line needs input and output: "
+                      << line << std::endl;
+            return false;
+        }
+        jobs.push_back(std::move(job));
+    }
+
+    return true;
+}
+
+/**
+ * A module split along function boundaries for LTO-sized inputs: the
+ * shared lines (globals, declarations, attributes, metadata) plus one
+ * bucket of whole function bodies per shard
+ */
+struct ModulePartition {
+    std::vector<std::string> shared_lines;
+    std::vector<std::vector<std::string>> shard_functions;
+};
+
+/**
+ * Split a module into `shards` balanced buckets of functions.
+ *
+ * Functions are weighed by instruction count and assigned greedily,
+ * heaviest first, to the lightest shard so far (LPT scheduling), which
+ * keeps shard runtimes close even when one function dominates the
+ * module. Everything outside a define..} range is shared verbatim by
+ * every shard.
+ */
+bool partitionModule(const std::vector<std::string>& lines, int shards,
+                     ModulePartition& part) {
+    struct FunctionBlock {
+        size_t first_line;
+        size_t last_line;
+        int weight;
+    };
+    std::vector<FunctionBlock> blocks;
+
+    bool in_function = false;
+    size_t block_start = 0;
+    int instr_count = 0;
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        auto rec = IRTokenizer::tokenizeLine(lines[i], i);
+
+        if (rec.kind == IRLineKind::FunctionBegin) {
+            in_function = true;
+            block_start = i;
+            instr_count = 0;
+        } else if (rec.kind == IRLineKind::FunctionEnd && in_function) {
+            blocks.push_back(FunctionBlock{block_start, i, instr_count});
+            in_function = false;
+        } else if (rec.kind == IRLineKind::Instruction && in_function) {
+            instr_count++;
+        } else if (!in_function) {
+            part.shared_lines.push_back(lines[i]);
+        }
+    }
+
+    if (blocks.empty()) {
+        return false;
+    }
+
+    size_t bucket_count = std::min(static_cast<size_t>(shards), blocks.size());
+    part.shard_functions.assign(bucket_count, {});
+    std::vector<long> shard_weight(bucket_count, 0);
+
+    // Heaviest functions placed first, each into the lightest shard
+    std::vector<size_t> order(blocks.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return blocks[a].weight > blocks[b].weight;
+    });
+
+    for (size_t idx : order) {
+        size_t lightest = 0;
+        for (size_t s = 1; s < bucket_count; s++) {
+            if (shard_weight[s] < shard_weight[lightest]) lightest = s;
+        }
+        const FunctionBlock& block = blocks[idx];
+        for (size_t i = block.first_line; i <= block.last_line; i++) {
+            part.shard_functions[lightest].push_back(lines[i]);
+        }
+        part.shard_functions[lightest].push_back("");
+        shard_weight[lightest] += block.weight;
+    }
+
+    return true;
+}
+
+/**
+ * Restart every process-global name source for a fresh job.
+ *
+ * Reseeding GlobalRandom is not enough for bit-identical shards: the MBA
+ * and dead-code generators keep process-global temp/label counters that
+ * accumulate across jobs in a long-lived daemon. Resetting them together
+ * with the RNG makes shard output depend only on (seed, shard content).
+ */
+void reseedForJob(uint64_t seed) {
+    GlobalRandom::setSeed(seed);
+    mba::resetTempCounters();
+    deadcode::DeadCodeGenerator::resetCounters();
+}
+
+/**
+ * Partitioned mode for single multi-GB LTO modules: the module is split
+ * along function boundaries into balanced shards, each shard is
+ * obfuscated by a forked worker process (function-local passes only),
+ * and the outputs are merged. String encoding is module-level — it
+ * rewrites shared globals — so it runs once on the merged result in the
+ * parent instead of per shard.
+ */
+int runPartitioned(const LLVMIRObfuscator& obfuscator,
+                   const std::string& input_file,
+                   const std::string& output_file,
+                   int partitions) {
+    std::ifstream input(input_file);
+    if (!input.is_open()) {
+        std::cerr << "[morphect] Error: Cannot open input file: " << input_file << std::endl;
+        return 1;
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(input, line)) {
+        lines.push_back(std::move(line));
+    }
+    input.close();
+
+    ModulePartition part;
+    if (!partitionModule(lines, partitions, part)) {
+        std::cerr << "[morphect] Error: No functions found to partition in: "
+                  << input_file << std::endl;
+        return 1;
+    }
+
+    size_t shard_count = part.shard_functions.size();
+    fprintf(stderr, "[morphect] Partitioned into %zu shards (%zu shared lines)\n",
+            shard_count, part.shared_lines.size());
+
+    // Write shard inputs: every shard sees the shared prelude so
+    // references to globals and declarations still resolve
+    std::vector<std::string> shard_inputs(shard_count);
+    std::vector<std::string> shard_outputs(shard_count);
+
+    for (size_t s = 0; s < shard_count; s++) {
+        shard_inputs[s] = output_file + ".shard" + std::to_string(s) + ".in.ll";
+        shard_outputs[s] = output_file + ".shard" + std::to_string(s) + ".out.ll";
+
+        OutputWriter shard(shard_inputs[s]);
+        if (!shard.valid()) {
+            std::cerr << "[morphect] Error: Cannot create shard file: "
+                      << shard_inputs[s] << std::endl;
+            return 1;
+        }
+        for (const auto& l : part.shared_lines) shard.appendLine(l);
+        shard.appendLine("");
+        for (const auto& l : part.shard_functions[s]) shard.appendLine(l);
+        if (!shard.close()) {
+            std::cerr << "[morphect] Error: Write failed: " << shard_inputs[s] << std::endl;
+            return 1;
+        }
+    }
+
+    // One worker process per shard: fork keeps the configured pipeline
+    // without re-parsing config, and a crashed worker cannot take the
+    // whole run down
+    std::vector<pid_t> workers(shard_count, -1);
+    for (size_t s = 0; s < shard_count; s++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            std::cerr << "[morphect] Error: fork failed for shard " << s << std::endl;
+            return 1;
+        }
+        if (pid == 0) {
+            // Restart the RNG and name counters from the run's seed so
+            // shard bytes depend only on (seed, shard content) — the same
+            // contract the distributed workers honor, keeping both modes
+            // bit-identical
+            reseedForJob(GlobalRandom::get().getSeed());
+            LLVMIRObfuscator local = obfuscator;
+            local.setJobs(1);
+            local.setEnableStringEncoding(false);
+            _exit(processOneFile(local, shard_inputs[s], shard_outputs[s], false));
+        }
+        workers[s] = pid;
+    }
+
+    int failures = 0;
+    for (size_t s = 0; s < shard_count; s++) {
+        int status = 0;
+        waitpid(workers[s], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "[morphect] Error: Shard " << s << " worker failed" << std::endl;
+            failures++;
+        }
+    }
+    if (failures > 0) {
+        return 1;
+    }
+
+    // Merge: the shared prelude verbatim, then every shard's transformed
+    // function definitions. Function-local passes never touch lines
+    // outside define..}, so the prelude needs no reconciliation.
+    std::vector<std::string> merged = part.shared_lines;
+    merged.push_back("");
+
+    for (size_t s = 0; s < shard_count; s++) {
+        std::ifstream shard_out(shard_outputs[s]);
+        if (!shard_out.is_open()) {
+            std::cerr << "[morphect] Error: Cannot read shard output: "
+                      << shard_outputs[s] << std::endl;
+            return 1;
+        }
+        bool in_function = false;
+        while (std::getline(shard_out, line)) {
+            auto rec = IRTokenizer::tokenizeLine(line, 0);
+            if (rec.kind == IRLineKind::FunctionBegin) in_function = true;
+            if (in_function) merged.push_back(line);
+            if (rec.kind == IRLineKind::FunctionEnd) in_function = false;
+        }
+        merged.push_back("");
+    }
+
+    for (size_t s = 0; s < shard_count; s++) {
+        std::remove(shard_inputs[s].c_str());
+        std::remove(shard_outputs[s].c_str());
+    }
+
+    std::string merged_text;
+    for (const auto& l : merged) {
+        merged_text += l;
+        merged_text += '\n';
+    }
+
+    // Module-level pass on the merged result (no-op unless enabled)
+    LLVMIRObfuscator module_passes = obfuscator;
+    module_passes.setJobs(1);
+    module_passes.setEnableMBA(false);
+    module_passes.setEnableCFF(false);
+    module_passes.setEnableBogus(false);
+    module_passes.setEnableVariableSplit(false);
+    module_passes.setEnableDeadCode(false);
+    std::string final_text = module_passes.obfuscateFull(merged_text);
+
+    OutputWriter output(output_file);
+    if (!output.valid()) {
+        std::cerr << "[morphect] Error: Cannot create output file: " << output_file << std::endl;
+        return 1;
+    }
+    output.preallocate(final_text.size());
+    output.append(final_text);
+    if (!output.close()) {
+        std::cerr << "[morphect] Error: Write failed: " << output_file << std::endl;
+        return 1;
+    }
+
+    fprintf(stderr, "[morphect] Wrote %zu bytes to %s (%zu shards merged)\n",
+            final_text.size(), output_file.c_str(), shard_count);
+    return 0;
+}
+
+/**
+ * An endpoint is a unix socket path, or "host:port" for TCP when the
+ * daemon serves worker nodes on other hosts (distributed sharding).
+ */
+bool isTcpEndpoint(const std::string& endpoint) {
+    size_t colon = endpoint.rfind(':');
+    return colon != std::string::npos && colon + 1 < endpoint.size() &&
+           std::isdigit(static_cast<unsigned char>(endpoint[colon + 1])) &&
+           endpoint[0] != '/' && endpoint[0] != '.';
+}
+
+/**
+ * Listen on a unix path or "host:port"; returns the fd or -1
+ */
+int listenOnEndpoint(const std::string& endpoint) {
+    if (isTcpEndpoint(endpoint)) {
+        size_t colon = endpoint.rfind(':');
+        std::string host = endpoint.substr(0, colon);
+        std::string port = endpoint.substr(colon + 1);
+
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+
+        struct addrinfo* res = nullptr;
+        if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(),
+                        &hints, &res) != 0 || res == nullptr) {
+            return -1;
+        }
+
+        int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (fd >= 0) {
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            if (bind(fd, res->ai_addr, res->ai_addrlen) < 0 ||
+                listen(fd, 16) < 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(res);
+        return fd;
+    }
+
+    unlink(endpoint.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (endpoint.size() >= sizeof(addr.sun_path)) {
+        close(fd);
+        return -1;
+    }
+    strncpy(addr.sun_path, endpoint.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(fd, 16) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Connect to a unix path or "host:port"; returns the fd or -1
+ */
+int connectToEndpoint(const std::string& endpoint) {
+    if (isTcpEndpoint(endpoint)) {
+        size_t colon = endpoint.rfind(':');
+        std::string host = endpoint.substr(0, colon);
+        std::string port = endpoint.substr(colon + 1);
+
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* res = nullptr;
+        if (getaddrinfo(host.empty() ? "127.0.0.1" : host.c_str(),
+                        port.c_str(), &hints, &res) != 0 || res == nullptr) {
+            return -1;
+        }
+
+        int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(res);
+        return fd;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, endpoint.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr),
+                sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * Buffered line reader for socket payloads. The original byte-at-a-time
+ * request reader is fine for one-line headers but not for shipping
+ * multi-MB IR shards, so payload transfers go through this instead.
+ */
+class FdLineReader {
+public:
+    explicit FdLineReader(int fd) : fd_(fd) {}
+
+    bool readLine(std::string& line) {
+        line.clear();
+        for (;;) {
+            if (pos_ == len_) {
+                ssize_t n = read(fd_, buf_, sizeof(buf_));
+                if (n <= 0) return !line.empty();
+                pos_ = 0;
+                len_ = static_cast<size_t>(n);
+            }
+            while (pos_ < len_) {
+                char c = buf_[pos_++];
+                if (c == '\n') return true;
+                line.push_back(c);
+            }
+        }
+    }
+
+private:
+    int fd_;
+    char buf_[65536];
+    size_t pos_ = 0;
+    size_t len_ = 0;
+};
+
+/**
+ * Write the whole buffer, retrying partial writes
+ */
+bool sendAll(int fd, std::string_view data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        ssize_t n = write(fd, data.data() + off, data.size() - off);
+        if (n <= 0) return false;
+        off += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/**
+ * Read one \n-terminated request line from a connected socket
+ */
+bool readRequestLine(int fd, std::string& line) {
+    line.clear();
+    char c;
+    while (true) {
+        ssize_t n = read(fd, &c, 1);
+        if (n <= 0) return !line.empty();
+        if (c == '\n') return true;
+        line.push_back(c);
+        if (line.size() > 8192) return false;   // malformed request
+    }
+}
+
+void sendReply(int fd, const std::string& reply) {
+    std::string msg = reply + "\n";
+    size_t off = 0;
+    while (off < msg.size()) {
+        ssize_t n = write(fd, msg.data() + off, msg.size() - off);
+        if (n <= 0) return;
+        off += static_cast<size_t>(n);
+    }
+}
+
+/**
+ * Daemon mode: a long-lived server that keeps the configured pipeline
+ * (and any incremental cache) warm and accepts jobs over a unix socket.
+ *
+ * Protocol is one request per connection:
+ *   "JOB <input> <output>"  -> obfuscate, reply "OK" or "ERR <message>"
+ *   "SHARD <seed> <n>"      -> n lines of IR follow; obfuscate them with
+ *                              the given seed (function-local passes
+ *                              only) and reply "OK <m>" plus m lines
+ *   "PING"                  -> reply "OK"
+ *   "SHUTDOWN"              -> reply "OK" and exit the accept loop
+ *
+ * The endpoint is a unix socket path, or "host:port" to serve shards
+ * to a coordinator on another node.
+ */
+int runDaemon(LLVMIRObfuscator& obfuscator, const std::string& socket_path) {
+    int server_fd = listenOnEndpoint(socket_path);
+    if (server_fd < 0) {
+        std::cerr << "[morphect] Error: Cannot listen on " << socket_path << std::endl;
+        return 1;
+    }
+
+    fprintf(stderr, "[morphect] Daemon listening on %s\n", socket_path.c_str());
+
+    size_t jobs_done = 0;
+    bool running = true;
+    while (running) {
+        int client_fd = accept(server_fd, nullptr, nullptr);
+        if (client_fd < 0) continue;
+
+        FdLineReader reader(client_fd);
+        std::string request;
+        if (!reader.readLine(request)) {
+            sendReply(client_fd, "ERR malformed request");
+            close(client_fd);
+            continue;
+        }
+
+        std::istringstream iss(request);
+        std::string verb;
+        iss >> verb;
+
+        if (verb == "PING") {
+            sendReply(client_fd, "OK");
+        } else if (verb == "SHUTDOWN") {
+            sendReply(client_fd, "OK");
+            running = false;
+        } else if (verb == "JOB") {
+            std::string input, output;
+            if (!(iss >> input >> output)) {
+                sendReply(client_fd, "ERR JOB needs input and output paths");
+            } else if (processOneFile(obfuscator, input, output, false) == 0) {
+                jobs_done++;
+                sendReply(client_fd, "OK");
+            } else {
+                sendReply(client_fd, "ERR processing failed");
+            }
+        } else if (verb == "SHARD") {
+            unsigned long long seed = 0;
+            size_t line_count = 0;
+            if (!(iss >> seed >> line_count)) {
+                sendReply(client_fd, "ERR SHARD needs seed and line count");
+                close(client_fd);
+                continue;
+            }
+
+            std::string text;
+            std::string payload_line;
+            bool truncated = false;
+            for (size_t i = 0; i < line_count; i++) {
+                if (!reader.readLine(payload_line)) {
+                    truncated = true;
+                    break;
+                }
+                text += payload_line;
+                text += '\n';
+            }
+            if (truncated) {
+                sendReply(client_fd, "ERR truncated shard payload");
+                close(client_fd);
+                continue;
+            }
+
+            // Shard bytes depend only on (seed, shard content): the
+            // explicit reseed makes any worker node produce the same
+            // output the coordinator's local fallback would
+            reseedForJob(seed);
+            LLVMIRObfuscator local = obfuscator;
+            local.setJobs(1);
+            local.setEnableStringEncoding(false);
+            std::string transformed = local.obfuscateFull(text);
+            if (!transformed.empty() && transformed.back() != '\n') {
+                transformed += '\n';
+            }
+
+            size_t out_lines = static_cast<size_t>(
+                std::count(transformed.begin(), transformed.end(), '\n'));
+            sendReply(client_fd, "OK " + std::to_string(out_lines));
+            sendAll(client_fd, transformed);
+            jobs_done++;
+        } else {
+            sendReply(client_fd, "ERR unknown verb: " + verb);
+        }
+
+        close(client_fd);
+    }
+
+    close(server_fd);
+    if (!isTcpEndpoint(socket_path)) {
+        unlink(socket_path.c_str());
+    }
+    fprintf(stderr, "[morphect] Daemon shut down after %zu jobs\n", jobs_done);
+    return 0;
+}
+
+/**
+ * Thin client: submit one job (or control verb) to a running daemon.
+ * Exit status mirrors the daemon's OK/ERR reply.
+ */
+int runClient(const std::string& socket_path, const std::string& request) {
+    int fd = connectToEndpoint(socket_path);
+    if (fd < 0) {
+        std::cerr << "[morphect] Error: Cannot connect to daemon at "
+                  << socket_path << std::endl;
+        return 1;
+    }
+
+    sendReply(fd, request);
+
+    std::string reply;
+    readRequestLine(fd, reply);
+    close(fd);
+
+    if (reply.rfind("OK", 0) == 0) {
+        return 0;
+    }
+    std::cerr << "[morphect] Daemon: " << (reply.empty() ? "no reply" : reply) << std::endl;
+    return 1;
+}
+
+/**
+ * Ship one shard to a worker daemon and collect the transformed text
+ */
+bool dispatchShard(const std::string& endpoint, unsigned long long seed,
+                   const std::string& payload, size_t payload_lines,
+                   std::string& transformed) {
+    int fd = connectToEndpoint(endpoint);
+    if (fd < 0) return false;
+
+    std::string header = "SHARD " + std::to_string(seed) + " " +
+                         std::to_string(payload_lines) + "\n";
+    if (!sendAll(fd, header) || !sendAll(fd, payload)) {
+        close(fd);
+        return false;
+    }
+
+    FdLineReader reader(fd);
+    std::string reply;
+    if (!reader.readLine(reply) || reply.rfind("OK ", 0) != 0) {
+        close(fd);
+        return false;
+    }
+
+    size_t reply_lines = strtoull(reply.c_str() + 3, nullptr, 10);
+    transformed.clear();
+    std::string line;
+    for (size_t i = 0; i < reply_lines; i++) {
+        if (!reader.readLine(line)) {
+            close(fd);
+            return false;
+        }
+        transformed += line;
+        transformed += '\n';
+    }
+    close(fd);
+    return true;
+}
+
+/**
+ * Distributed sharded mode: the partitioning scheme of --partition, but
+ * with shards shipped to worker daemons on other nodes instead of
+ * forked processes. The coordinator splits the module along function
+ * boundaries, sends each shard (with the shared prelude, the run's
+ * seed, and an implicit copy of the config the daemons were started
+ * with) over the daemon protocol, and merges the returned shards in
+ * shard order. Shard bytes depend only on (seed, shard content), so
+ * the merge is deterministic no matter which node transformed which
+ * shard, and a shard whose workers all fail falls back to local
+ * processing with the same seed — the result is byte-identical either
+ * way.
+ *
+ * Workers must be started with the same pass flags as the coordinator;
+ * string encoding is module-level and runs once on the merged result
+ * here, exactly as in --partition.
+ */
+int runDistributed(const LLVMIRObfuscator& obfuscator,
+                   const std::string& input_file,
+                   const std::string& output_file,
+                   const std::vector<std::string>& workers,
+                   int partitions) {
+    std::ifstream input(input_file);
+    if (!input.is_open()) {
+        std::cerr << "[morphect] Error: Cannot open input file: " << input_file << std::endl;
+        return 1;
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(input, line)) {
+        lines.push_back(std::move(line));
+    }
+    input.close();
+
+    ModulePartition part;
+    if (!partitionModule(lines, partitions, part)) {
+        std::cerr << "[morphect] Error: No functions found to partition in: "
+                  << input_file << std::endl;
+        return 1;
+    }
+
+    size_t shard_count = part.shard_functions.size();
+    fprintf(stderr, "[morphect] Distributing %zu shards across %zu workers\n",
+            shard_count, workers.size());
+
+    // Shard payloads carry the shared prelude so globals and
+    // declarations resolve on the worker
+    std::vector<std::string> payloads(shard_count);
+    std::vector<size_t> payload_lines(shard_count, 0);
+    for (size_t s = 0; s < shard_count; s++) {
+        std::string& payload = payloads[s];
+        for (const auto& l : part.shared_lines) {
+            payload += l;
+            payload += '\n';
+        }
+        payload += '\n';
+        for (const auto& l : part.shard_functions[s]) {
+            payload += l;
+            payload += '\n';
+        }
+        payload_lines[s] = part.shared_lines.size() + 1 +
+                           part.shard_functions[s].size();
+    }
+
+    unsigned long long seed = GlobalRandom::get().getSeed();
+    std::vector<std::string> shard_results(shard_count);
+    std::vector<char> shard_done(shard_count, 0);
+    std::atomic<size_t> next_shard{0};
+    std::mutex log_mutex;
+
+    // One coordinator thread per worker endpoint, pulling shards from a
+    // shared index (same pool shape as batch mode)
+    auto coordinator = [&](size_t w) {
+        for (;;) {
+            size_t s = next_shard.fetch_add(1);
+            if (s >= shard_count) break;
+
+            if (dispatchShard(workers[w], seed, payloads[s],
+                              payload_lines[s], shard_results[s])) {
+                shard_done[s] = 1;
+            } else {
+                std::lock_guard<std::mutex> lock(log_mutex);
+                fprintf(stderr,
+                        "[morphect] Warning: worker %s failed shard %zu; "
+                        "will process locally\n",
+                        workers[w].c_str(), s);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers.size());
+    for (size_t w = 0; w < workers.size(); w++) {
+        pool.emplace_back(coordinator, w);
+    }
+    for (auto& t : pool) {
+        t.join();
+    }
+
+    // Local fallback for failed shards, serial (GlobalRandom reseeding
+    // is process-wide); the reseed reproduces the worker's bytes
+    for (size_t s = 0; s < shard_count; s++) {
+        if (shard_done[s]) continue;
+
+        reseedForJob(seed);
+        LLVMIRObfuscator local = obfuscator;
+        local.setJobs(1);
+        local.setEnableStringEncoding(false);
+        shard_results[s] = local.obfuscateFull(payloads[s]);
+        if (!shard_results[s].empty() && shard_results[s].back() != '\n') {
+            shard_results[s] += '\n';
+        }
+    }
+
+    // Merge in shard order: the shared prelude verbatim, then every
+    // shard's transformed function definitions (same scheme as
+    // --partition)
+    std::vector<std::string> merged = part.shared_lines;
+    merged.push_back("");
+
+    for (size_t s = 0; s < shard_count; s++) {
+        std::istringstream shard_out(shard_results[s]);
+        bool in_function = false;
+        while (std::getline(shard_out, line)) {
+            auto rec = IRTokenizer::tokenizeLine(line, 0);
+            if (rec.kind == IRLineKind::FunctionBegin) in_function = true;
+            if (in_function) merged.push_back(line);
+            if (rec.kind == IRLineKind::FunctionEnd) in_function = false;
+        }
+        merged.push_back("");
+    }
+
+    std::string merged_text;
+    for (const auto& l : merged) {
+        merged_text += l;
+        merged_text += '\n';
+    }
+
+    // Module-level pass on the merged result (no-op unless enabled)
+    LLVMIRObfuscator module_passes = obfuscator;
+    module_passes.setJobs(1);
+    module_passes.setEnableMBA(false);
+    module_passes.setEnableCFF(false);
+    module_passes.setEnableBogus(false);
+    module_passes.setEnableVariableSplit(false);
+    module_passes.setEnableDeadCode(false);
+    std::string final_text = module_passes.obfuscateFull(merged_text);
+
+    OutputWriter output(output_file);
+    if (!output.valid()) {
+        std::cerr << "[morphect] Error: Cannot create output file: " << output_file << std::endl;
+        return 1;
+    }
+    output.preallocate(final_text.size());
+    output.append(final_text);
+    if (!output.close()) {
+        std::cerr << "[morphect] Error: Write failed: " << output_file << std::endl;
+        return 1;
+    }
+
+    fprintf(stderr, "[morphect] Wrote %zu bytes to %s (%zu shards merged)\n",
+            final_text.size(), output_file.c_str(), shard_count);
+    return 0;
+}
+
+/**
+ * Export the recorded timeline as Trace Event Format JSON
+ */
+void writeTraceFile(const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "[morphect] Error: Cannot create trace file: " << path << std::endl;
+        return;
+    }
+    out << TraceRecorder::get().toJson();
+    fprintf(stderr, "[morphect] Wrote %zu trace events to %s\n",
+            TraceRecorder::get().eventCount(), path.c_str());
+}
+
+/**
+ * Audit every MBA variant against its base operation
+ *
+ * Runs the batch verifier over pseudo-random operand pairs and prints
+ * one line per variant. Returns nonzero if any identity fails, so the
+ * flag can gate CI.
+ */
+int runVerifyMBA() {
+    mba::MBAVerifier verifier;
+    fprintf(stderr, "[morphect] auditing MBA variants (%llu samples each)\n",
+            (unsigned long long)verifier.samplesPerVariant());
+
+    auto results = verifier.verifyAll();
+    int failures = 0;
+    for (const auto& r : results) {
+        if (r.passed()) {
+            printf("  %-4s %-16s OK     (%llu samples)\n",
+                   r.operation.c_str(), r.variant_name.c_str(),
+                   (unsigned long long)r.samples);
+        } else {
+            printf("  %-4s %-16s FAILED (%llu of %llu samples mismatch)\n",
+                   r.operation.c_str(), r.variant_name.c_str(),
+                   (unsigned long long)r.mismatches,
+                   (unsigned long long)r.samples);
+            failures++;
+        }
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "[morphect] MBA audit FAILED: %d variant(s) broken\n",
+                failures);
+        return 1;
+    }
+    fprintf(stderr, "[morphect] MBA audit passed: %zu variants verified\n",
+            results.size());
+    return 0;
+}
+
+/**
+ * Outcome of one sandboxed executable run
+ */
+struct VectorOutcome {
+    int exit_code = 127;
+    bool signaled = false;
+    std::string output;
+};
+
+/**
+ * Run one executable on one argument vector inside a resource-limited
+ * child. CPU and address-space rlimits bound a runaway binary — an
+ * obfuscation bug must fail its vector, not hang the build farm — and
+ * stdout/stderr are captured through a pipe for comparison.
+ */
+bool runVectorSandboxed(const std::string& exe,
+                        const std::vector<std::string>& args,
+                        long cpu_limit_sec, VectorOutcome& out) {
+    int pipefd[2];
+    if (pipe(pipefd) != 0) return false;
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(pipefd[0]);
+        close(pipefd[1]);
+        return false;
+    }
+
+    if (pid == 0) {
+        struct rlimit cpu{static_cast<rlim_t>(cpu_limit_sec),
+                         static_cast<rlim_t>(cpu_limit_sec)};
+        setrlimit(RLIMIT_CPU, &cpu);
+        struct rlimit mem{1ULL << 30, 1ULL << 30};
+        setrlimit(RLIMIT_AS, &mem);
+        struct rlimit fsz{1ULL << 24, 1ULL << 24};
+        setrlimit(RLIMIT_FSIZE, &fsz);
+
+        dup2(pipefd[1], STDOUT_FILENO);
+        dup2(pipefd[1], STDERR_FILENO);
+        close(pipefd[0]);
+        close(pipefd[1]);
+
+        std::vector<char*> argv;
+        argv.push_back(const_cast<char*>(exe.c_str()));
+        for (const auto& a : args) {
+            argv.push_back(const_cast<char*>(a.c_str()));
+        }
+        argv.push_back(nullptr);
+        execv(exe.c_str(), argv.data());
+        _exit(127);
+    }
+
+    close(pipefd[1]);
+    char buf[4096];
+    ssize_t n;
+    while ((n = read(pipefd[0], buf, sizeof(buf))) > 0) {
+        out.output.append(buf, static_cast<size_t>(n));
+    }
+    close(pipefd[0]);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (WIFEXITED(status)) {
+        out.exit_code = WEXITSTATUS(status);
+        out.signaled = false;
+    } else {
+        out.exit_code = WIFSIGNALED(status) ? WTERMSIG(status) : -1;
+        out.signaled = true;
+    }
+    return true;
+}
+
+/**
+ * Semantic verification mode (--verify)
+ *
+ * The productized version of the serial verify script: compile the
+ * original and obfuscated modules with clang, run deterministic
+ * generated argument vectors through both binaries in parallel
+ * sandboxed workers, and compare exit codes and output byte for byte.
+ * Modules without an entry point degrade to a compile-only check (both
+ * must still build). The obfuscated binary's CPU budget is scaled by
+ * the cost model's predicted overhead so a heavily transformed module
+ * is never misread as a hang.
+ */
+int runVerify(LLVMIRObfuscator& obfuscator, const std::string& original_ll,
+              const std::string& obfuscated_ll, int workers, int vectors) {
+    if (std::system("which clang > /dev/null 2>&1") != 0) {
+        fprintf(stderr, "[morphect] Verify: clang not found in PATH\n");
+        return 1;
+    }
+
+    Timer verify_timer;
+    verify_timer.start();
+
+    std::string prefix = "/tmp/morphect_verify_" + std::to_string(getpid());
+    std::string orig_exe = prefix + "_orig";
+    std::string obf_exe = prefix + "_obf";
+    std::string log = prefix + ".log";
+
+    auto compile = [&](const std::string& ll, const std::string& out,
+                       const char* extra) {
+        std::string cmd = "clang " + std::string(extra) + " " + ll +
+                          " -o " + out + " -lm 2>" + log;
+        return std::system(cmd.c_str()) == 0;
+    };
+
+    auto cleanup = [&]() {
+        std::remove(orig_exe.c_str());
+        std::remove(obf_exe.c_str());
+        std::remove(log.c_str());
+    };
+
+    if (!compile(original_ll, orig_exe, "")) {
+        // Library modules have no entry point to run; both versions
+        // must still compile, which catches IR the obfuscator broke
+        fprintf(stderr, "[morphect] Verify: original does not link (no entry "
+                "point?); compile-only check\n");
+        bool orig_ok = compile(original_ll, orig_exe + ".o", "-c");
+        bool obf_ok = compile(obfuscated_ll, obf_exe + ".o", "-c");
+        std::remove((orig_exe + ".o").c_str());
+        std::remove((obf_exe + ".o").c_str());
+        cleanup();
+        if (!orig_ok) {
+            fprintf(stderr, "[morphect] Verify: original module does not "
+                    "compile; nothing to verify against\n");
+            return 1;
+        }
+        if (!obf_ok) {
+            fprintf(stderr, "[morphect] Verification FAILED: obfuscated "
+                    "module does not compile\n");
+            return 1;
+        }
+        fprintf(stderr, "[morphect] Verification passed (compile-only)\n");
+        return 0;
+    }
+
+    if (!compile(obfuscated_ll, obf_exe, "")) {
+        fprintf(stderr, "[morphect] Verification FAILED: obfuscated module "
+                "does not compile\n");
+        std::ifstream errlog(log);
+        std::string line;
+        for (int i = 0; i < 5 && std::getline(errlog, line); i++) {
+            fprintf(stderr, "[morphect]   %s\n", line.c_str());
+        }
+        cleanup();
+        return 1;
+    }
+
+    // Deterministic argument vectors: same seed, same vectors, so a
+    // failure reproduces exactly on a developer box
+    uint64_t seed = LocalRandom::deriveSeed(GlobalRandom::get().getSeed(),
+                                            "verify-vectors");
+    LocalRandom rng(seed);
+    std::vector<std::vector<std::string>> arg_vectors;
+    arg_vectors.push_back({});  // always cover the bare invocation
+    for (int i = 1; i < vectors; i++) {
+        std::vector<std::string> args;
+        int argc = rng.nextInt(0, 3);
+        for (int a = 0; a < argc; a++) {
+            args.push_back(std::to_string(rng.nextInt(-100000, 100000)));
+        }
+        arg_vectors.push_back(std::move(args));
+    }
+
+    // Cost-model integration: the obfuscated binary legitimately runs
+    // slower by the predicted overhead, so its CPU budget grows with it
+    // instead of tripping the sandbox limit on heavy configs
+    double predicted =
+        obfuscator.exportStatistics().getDouble("predicted_overhead_cycles");
+    long base_cpu_sec = 5;
+    long obf_cpu_sec = base_cpu_sec +
+        std::min(25L, static_cast<long>(predicted / 1e7));
+
+    fprintf(stderr, "[morphect] Verify: %zu vectors on %d workers "
+            "(CPU budget %lds original, %lds obfuscated)\n",
+            arg_vectors.size(), workers, base_cpu_sec, obf_cpu_sec);
+
+    std::atomic<size_t> next_vector{0};
+    std::atomic<int> mismatches{0};
+    std::mutex report_mutex;
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t idx = next_vector.fetch_add(1);
+            if (idx >= arg_vectors.size()) break;
+            const auto& args = arg_vectors[idx];
+
+            VectorOutcome orig, obf;
+            if (!runVectorSandboxed(orig_exe, args, base_cpu_sec, orig) ||
+                !runVectorSandboxed(obf_exe, args, obf_cpu_sec, obf)) {
+                mismatches.fetch_add(1);
+                continue;
+            }
+
+            if (orig.exit_code == obf.exit_code &&
+                orig.signaled == obf.signaled &&
+                orig.output == obf.output) {
+                continue;
+            }
+
+            mismatches.fetch_add(1);
+            std::lock_guard<std::mutex> lock(report_mutex);
+            std::string argv_text;
+            for (const auto& a : args) argv_text += " " + a;
+            fprintf(stderr, "[morphect] Vector %zu MISMATCH (argv:%s)\n",
+                    idx, argv_text.empty() ? " <none>" : argv_text.c_str());
+            fprintf(stderr, "[morphect]   original:   exit %d%s, %zu bytes\n",
+                    orig.exit_code, orig.signaled ? " (signal)" : "",
+                    orig.output.size());
+            fprintf(stderr, "[morphect]   obfuscated: exit %d%s, %zu bytes\n",
+                    obf.exit_code, obf.signaled ? " (signal)" : "",
+                    obf.output.size());
+        }
+    };
+
+    size_t pool_size = std::min(static_cast<size_t>(workers > 0 ? workers : 1),
+                                arg_vectors.size());
+    if (pool_size <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(pool_size);
+        for (size_t w = 0; w < pool_size; w++) {
+            pool.emplace_back(worker);
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+    }
+
+    cleanup();
+
+    if (mismatches.load() > 0) {
+        fprintf(stderr, "[morphect] Verification FAILED: %d of %zu vectors "
+                "diverge (seed %llu reproduces)\n",
+                mismatches.load(), arg_vectors.size(),
+                (unsigned long long)GlobalRandom::get().getSeed());
+        return 1;
+    }
+    fprintf(stderr, "[morphect] Verification passed: %zu vectors identical "
+            "in %.1fs\n", arg_vectors.size(), verify_timer.elapsedSec());
+    return 0;
+}
+
+/**
+ * Print usage
+ */
+void printUsage(const char* program) {
+    std::cout << getBanner() << std::endl;
+    std::cout << "Usage: " << program << " [options] <input.ll> <output.ll>" << std::endl;
     std::cout << std::endl;
     std::cout << "Options:" << std::endl;
     std::cout << "  --config <file>       Configuration file (JSON)" << std::endl;
     std::cout << "  --probability <n>     Global transformation probability (0.0-1.0)" << std::endl;
+    std::cout << "  --max-expansion <r>   Per-function output budget: functions may grow to" << std::endl;
+    std::cout << "                        at most r times their input size (0 = unlimited)" << std::endl;
     std::cout << "  --mba                 Enable MBA (Mixed Boolean Arithmetic)" << std::endl;
     std::cout << "  --cff                 Enable Control Flow Flattening" << std::endl;
     std::cout << "  --bogus               Enable Bogus Control Flow" << std::endl;
     std::cout << "  --varsplit            Enable Variable Splitting" << std::endl;
     std::cout << "  --strenc              Enable String Encoding" << std::endl;
     std::cout << "  --deadcode            Enable Dead Code Insertion" << std::endl;
+    std::cout << "  --compact-deadcode    Emit fewer, denser dead-code blocks anchored by" << std::endl;
+    std::cout << "                        volatile stores (survives -O2 at smaller size)" << std::endl;
     std::cout << "  --all                 Enable all obfuscation passes" << std::endl;
+    std::cout << "  --fast                Low-overhead preset for latency-critical code:" << std::endl;
+    std::cout << "                        shallow MBA only (~2%% runtime overhead), heavy" << std::endl;
+    std::cout << "                        passes stay off regardless of other flags" << std::endl;
+    std::cout << "  --jobs <n>, -j <n>    Transform function regions on N worker threads" << std::endl;
+    std::cout << "  --partition <n>       Split the module into N balanced shards along" << std::endl;
+    std::cout << "                        function boundaries and obfuscate them in parallel" << std::endl;
+    std::cout << "                        worker processes (for single multi-GB LTO modules)" << std::endl;
+    std::cout << "  --cache-dir <dir>     Reuse transformed functions from an incremental cache" << std::endl;
+    std::cout << "  --profile <file>      Production profile (\"name count\" or CSV lines);" << std::endl;
+    std::cout << "                        the hottest functions skip expensive passes (CFF)" << std::endl;
+    std::cout << "                        but still get the cheap ones" << std::endl;
+    std::cout << "  --hot-percent <n>     With --profile: exempt the top n%% of profiled" << std::endl;
+    std::cout << "                        functions (default 10)" << std::endl;
+    std::cout << "  --hot-layout          With --profile: order functions hot-first in the" << std::endl;
+    std::cout << "                        output and sink generated cold helpers (decoders," << std::endl;
+    std::cout << "                        proxies) to the end, keeping hot text dense" << std::endl;
+    std::cout << "  --checkpoint <dir>    Persist completed function regions as they finish," << std::endl;
+    std::cout << "                        so an interrupted run can be continued" << std::endl;
+    std::cout << "  --resume              With --checkpoint: continue from the last checkpoint," << std::endl;
+    std::cout << "                        producing output identical to an uninterrupted run" << std::endl;
+    std::cout << "  --compact-out         Compact the emitted IR: strip comments and blank" << std::endl;
+    std::cout << "                        lines, shorten generated identifiers (smaller" << std::endl;
+    std::cout << "                        output, faster downstream clang/llc parsing)" << std::endl;
+    std::cout << "  --mmap-out            Emit into a pre-sized memory-mapped output file" << std::endl;
+    std::cout << "                        instead of assembling the module in memory first" << std::endl;
+    std::cout << "  --pipeline            Overlap transform and write: finished function" << std::endl;
+    std::cout << "                        regions stream to the output while later regions" << std::endl;
+    std::cout << "                        are still being transformed (function-local passes)" << std::endl;
+    std::cout << "  --batch <list>        Process many \"input output\" pairs from a list file" << std::endl;
+    std::cout << "                        (pipeline initialized once; --jobs N runs N files" << std::endl;
+    std::cout << "                        concurrently)" << std::endl;
+    std::cout << "  --daemon <socket>     Run as a long-lived server accepting jobs over a" << std::endl;
+    std::cout << "                        unix socket, or host:port for worker nodes in a" << std::endl;
+    std::cout << "                        distributed run (pipeline and caches stay warm)" << std::endl;
+    std::cout << "  --connect <socket>    Submit <input> <output> to a running daemon" << std::endl;
+    std::cout << "  --shutdown            With --connect: stop the daemon instead" << std::endl;
+    std::cout << "  --workers <w1,w2,..>  Coordinate a distributed run: split the module" << std::endl;
+    std::cout << "                        into shards (--partition N, default one per" << std::endl;
+    std::cout << "                        worker) and ship them to daemons started with the" << std::endl;
+    std::cout << "                        same pass flags; shards merge deterministically," << std::endl;
+    std::cout << "                        byte-identical with a local --partition run" << std::endl;
+    std::cout << "  --trace <file>        Write a chrome://tracing timeline (pass and" << std::endl;
+    std::cout << "                        per-function events) to <file>" << std::endl;
+    std::cout << "  --transform-trace <f> Stream every transformation record to a binary" << std::endl;
+    std::cout << "                        trace file (replay with morphect-trace)" << std::endl;
+    std::cout << "  --metrics-prom <file> Write per-run counters and timings as a Prometheus" << std::endl;
+    std::cout << "                        textfile (atomic rename, tagged by target and" << std::endl;
+    std::cout << "                        config hash) for the node_exporter textfile collector" << std::endl;
+    std::cout << "  --statsd <host:port>  Push per-run counters to a StatsD daemon over UDP," << std::endl;
+    std::cout << "                        tagged by target and config hash" << std::endl;
+    std::cout << "  --verify              After obfuscating, compile both versions and run" << std::endl;
+    std::cout << "                        generated argument vectors through both binaries in" << std::endl;
+    std::cout << "                        parallel sandboxed workers (--jobs N), comparing" << std::endl;
+    std::cout << "                        exit codes and output byte for byte" << std::endl;
+    std::cout << "  --verify-vectors <n>  With --verify: number of argument vectors (default 32)" << std::endl;
+    std::cout << "  --verify-mba          Audit every MBA variant against its base operation" << std::endl;
+    std::cout << "                        over millions of random operand pairs, then exit" << std::endl;
+    std::cout << "  -                     As <input.ll>: read stdin; as <output.ll>: write" << std::endl;
+    std::cout << "                        stdout (diagnostics stay on stderr), so the tool" << std::endl;
+    std::cout << "                        can sit in a pipeline with no temp files" << std::endl;
     std::cout << "  --verbose, -v         Enable verbose output (show each transformation)" << std::endl;
     std::cout << "  --help, -h            Show this help" << std::endl;
     std::cout << std::endl;
@@ -623,13 +2775,35 @@ void printUsage(const char* program) {
     std::cout << "  " << program << " --mba --cff input.ll output.ll          # MBA + CFF" << std::endl;
     std::cout << "  " << program << " --all --probability 0.5 in.ll out.ll    # All passes, 50%%" << std::endl;
     std::cout << "  " << program << " -v --mba input.ll output.ll             # Verbose MBA" << std::endl;
+    std::cout << "  clang -S -emit-llvm -o - src.c | " << program << " --mba - - | clang -x ir - -c -o src.o" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
     std::string config_file;
+    std::string cache_dir;
+    std::string checkpoint_dir;
+    bool resume = false;
+    std::string profile_file;
+    double hot_percent = 10.0;
+    bool hot_layout = false;
+    std::string batch_file;
+    std::string trace_file;
+    std::string transform_trace_file;
+    std::string metrics_prom_file;
+    std::string statsd_target;
+    std::string daemon_socket;
+    std::string connect_socket;
+    std::vector<std::string> worker_endpoints;
+    bool shutdown_daemon = false;
+    bool verify_mba = false;
+    bool verify = false;
+    int verify_vectors = 32;
     std::string input_file;
     std::string output_file;
     double probability = -1;
+    double max_expansion = 0;
+    int jobs = 1;
+    int partitions = 0;
     bool verbose = false;
     bool enable_mba = false;
     bool enable_cff = false;
@@ -637,6 +2811,11 @@ int main(int argc, char* argv[]) {
     bool enable_varsplit = false;
     bool enable_strenc = false;
     bool enable_deadcode = false;
+    bool compact_deadcode = false;
+    bool mmap_out = false;
+    bool pipeline = false;
+    bool compact_out = false;
+    bool fast_preset = false;
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
@@ -646,6 +2825,65 @@ int main(int argc, char* argv[]) {
             config_file = argv[++i];
         } else if (arg == "--probability" && i + 1 < argc) {
             probability = std::stod(argv[++i]);
+        } else if (arg == "--max-expansion" && i + 1 < argc) {
+            max_expansion = std::stod(argv[++i]);
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (arg == "--profile" && i + 1 < argc) {
+            profile_file = argv[++i];
+        } else if (arg == "--hot-layout") {
+            hot_layout = true;
+        } else if (arg == "--hot-percent" && i + 1 < argc) {
+            hot_percent = std::stod(argv[++i]);
+        } else if (arg == "--checkpoint" && i + 1 < argc) {
+            checkpoint_dir = argv[++i];
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--compact-out") {
+            compact_out = true;
+        } else if (arg == "--mmap-out") {
+            mmap_out = true;
+        } else if (arg == "--pipeline") {
+            pipeline = true;
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batch_file = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else if (arg == "--transform-trace" && i + 1 < argc) {
+            transform_trace_file = argv[++i];
+        } else if (arg == "--metrics-prom" && i + 1 < argc) {
+            metrics_prom_file = argv[++i];
+        } else if (arg == "--statsd" && i + 1 < argc) {
+            statsd_target = argv[++i];
+        } else if (arg == "--daemon" && i + 1 < argc) {
+            daemon_socket = argv[++i];
+        } else if (arg == "--connect" && i + 1 < argc) {
+            connect_socket = argv[++i];
+        } else if (arg == "--workers" && i + 1 < argc) {
+            std::istringstream list(argv[++i]);
+            std::string endpoint;
+            while (std::getline(list, endpoint, ',')) {
+                if (!endpoint.empty()) worker_endpoints.push_back(endpoint);
+            }
+        } else if (arg == "--shutdown") {
+            shutdown_daemon = true;
+        } else if (arg == "--verify-mba") {
+            verify_mba = true;
+        } else if (arg == "--verify") {
+            verify = true;
+        } else if (arg == "--verify-vectors" && i + 1 < argc) {
+            verify_vectors = std::stoi(argv[++i]);
+            if (verify_vectors < 1) verify_vectors = 1;
+        } else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc) {
+            jobs = std::stoi(argv[++i]);
+            if (jobs <= 0) {
+                jobs = static_cast<int>(std::thread::hardware_concurrency());
+            }
+        } else if (arg == "--partition" && i + 1 < argc) {
+            partitions = std::stoi(argv[++i]);
+            if (partitions <= 0) {
+                partitions = static_cast<int>(std::thread::hardware_concurrency());
+            }
         } else if (arg == "--mba") {
             enable_mba = true;
         } else if (arg == "--cff") {
@@ -658,6 +2896,8 @@ int main(int argc, char* argv[]) {
             enable_strenc = true;
         } else if (arg == "--deadcode") {
             enable_deadcode = true;
+        } else if (arg == "--compact-deadcode") {
+            compact_deadcode = true;
         } else if (arg == "--all") {
             enable_mba = true;
             enable_cff = true;
@@ -665,12 +2905,14 @@ int main(int argc, char* argv[]) {
             enable_varsplit = true;
             enable_strenc = true;
             enable_deadcode = true;
+        } else if (arg == "--fast") {
+            fast_preset = true;
         } else if (arg == "--verbose" || arg == "-v") {
             verbose = true;
         } else if (arg == "--help" || arg == "-h") {
             printUsage(argv[0]);
             return 0;
-        } else if (arg[0] != '-') {
+        } else if (arg[0] != '-' || arg == "-") {
             if (input_file.empty()) {
                 input_file = arg;
             } else if (output_file.empty()) {
@@ -683,7 +2925,52 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    if (input_file.empty() || output_file.empty()) {
+    // Curated preset wins over individual pass flags: the point is a
+    // vetted combination, not a starting set to extend
+    if (fast_preset) {
+        if (enable_cff || enable_bogus || enable_varsplit ||
+            enable_strenc || enable_deadcode) {
+            fprintf(stderr, "[morphect] --fast: ignoring heavier pass flags "
+                    "(curated low-overhead preset)\n");
+        }
+        enable_mba = true;
+        enable_cff = false;
+        enable_bogus = false;
+        enable_varsplit = false;
+        enable_strenc = false;
+        enable_deadcode = false;
+    }
+
+    // Pipe mode: '-' reads stdin / writes stdout, so the tool can sit
+    // directly in a compile pipeline with no temp files
+    bool pipe_in = (input_file == "-");
+    bool pipe_out = (output_file == "-");
+
+    // Variant audit needs no pipeline or files
+    if (verify_mba) {
+        return runVerifyMBA();
+    }
+
+    // Client mode needs no pipeline at all: the daemon holds the
+    // configuration, the client just ships paths across the socket
+    if (!connect_socket.empty()) {
+        if (shutdown_daemon) {
+            return runClient(connect_socket, "SHUTDOWN");
+        }
+        if (input_file.empty() || output_file.empty()) {
+            std::cerr << "Error: --connect needs input and output files (or --shutdown)" << std::endl;
+            return 1;
+        }
+        if (pipe_in || pipe_out) {
+            std::cerr << "Error: --connect ships file paths to the daemon; "
+                      << "'-' is not available" << std::endl;
+            return 1;
+        }
+        return runClient(connect_socket, "JOB " + input_file + " " + output_file);
+    }
+
+    if (batch_file.empty() && daemon_socket.empty() &&
+        (input_file.empty() || output_file.empty())) {
         printUsage(argv[0]);
         return 1;
     }
@@ -701,7 +2988,10 @@ int main(int argc, char* argv[]) {
         LogConfig::get().setLevel(LogLevel::Debug);
     }
 
-    printBanner();
+    // The banner goes to stdout; in pipe mode that's the IR stream
+    if (!pipe_out) {
+        printBanner();
+    }
 
     // Create obfuscator
     LLVMIRObfuscator obfuscator;
@@ -717,6 +3007,74 @@ int main(int argc, char* argv[]) {
     if (probability >= 0) {
         obfuscator.setGlobalProbability(probability);
     }
+    if (max_expansion > 0) {
+        obfuscator.setMaxExpansionRatio(max_expansion);
+    }
+    if (compact_deadcode) {
+        obfuscator.setCompactDeadCode(true);
+    }
+
+    obfuscator.setJobs(jobs);
+    obfuscator.setMmapOutput(mmap_out);
+    obfuscator.setPipelined(pipeline);
+    obfuscator.setCompactOutput(compact_out);
+
+    if (resume && checkpoint_dir.empty()) {
+        std::cerr << "Error: --resume needs --checkpoint <dir>" << std::endl;
+        return 1;
+    }
+
+    if (verify && (!batch_file.empty() || !daemon_socket.empty())) {
+        std::cerr << "Error: --verify works on a single input/output pair" << std::endl;
+        return 1;
+    }
+
+    if (verify && (pipe_in || pipe_out)) {
+        std::cerr << "Error: --verify re-reads both files; '-' is not available"
+                  << std::endl;
+        return 1;
+    }
+
+    if (pipe_in && (partitions > 1 || !worker_endpoints.empty())) {
+        std::cerr << "Error: --partition and --workers need a seekable input file"
+                  << std::endl;
+        return 1;
+    }
+
+    if (pipe_out && mmap_out) {
+        fprintf(stderr, "[morphect] --mmap-out: stdout cannot be mapped, "
+                "using the buffered writer\n");
+        mmap_out = false;
+        obfuscator.setMmapOutput(false);
+    }
+
+    if (!worker_endpoints.empty() &&
+        (!batch_file.empty() || !daemon_socket.empty())) {
+        std::cerr << "Error: --workers coordinates a single input/output pair"
+                  << std::endl;
+        return 1;
+    }
+
+    if (!cache_dir.empty()) {
+        obfuscator.setCacheDir(cache_dir);
+    }
+    if (!checkpoint_dir.empty()) {
+        obfuscator.setCheckpointDir(checkpoint_dir, resume);
+    }
+    if (!profile_file.empty()) {
+        obfuscator.loadHotFunctionProfile(profile_file, hot_percent);
+    }
+    if (hot_layout) {
+        if (profile_file.empty()) {
+            std::cerr << "Error: --hot-layout needs --profile <file>" << std::endl;
+            return 1;
+        }
+        obfuscator.setHotLayout(true);
+    }
+
+    if (!transform_trace_file.empty()) {
+        obfuscator.setTransformTraceFile(transform_trace_file);
+    }
 
     // Apply command-line pass enables
     obfuscator.setEnableMBA(enable_mba);
@@ -727,8 +3085,14 @@ int main(int argc, char* argv[]) {
     obfuscator.setEnableDeadCode(enable_deadcode);
 
     // Print enabled passes
-    fprintf(stderr, "[morphect] Input: %s\n", input_file.c_str());
-    fprintf(stderr, "[morphect] Output: %s\n", output_file.c_str());
+    if (!daemon_socket.empty()) {
+        fprintf(stderr, "[morphect] Daemon socket: %s\n", daemon_socket.c_str());
+    } else if (!batch_file.empty()) {
+        fprintf(stderr, "[morphect] Batch list: %s\n", batch_file.c_str());
+    } else {
+        fprintf(stderr, "[morphect] Input: %s\n", input_file.c_str());
+        fprintf(stderr, "[morphect] Output: %s\n", output_file.c_str());
+    }
     fprintf(stderr, "[morphect] Probability: %.0f%%\n", (probability >= 0 ? probability : 0.85) * 100);
     fprintf(stderr, "[morphect] Passes: ");
     std::vector<std::string> enabled_passes;
@@ -744,40 +3108,139 @@ int main(int argc, char* argv[]) {
     }
     fprintf(stderr, "\n\n");
 
-    // Read input
-    std::ifstream input(input_file);
-    if (!input.is_open()) {
-        std::cerr << "[morphect] Error: Cannot open input file: " << input_file << std::endl;
-        return 1;
+    if (!trace_file.empty()) {
+        TraceRecorder::get().enable();
     }
 
-    std::string ir_code((std::istreambuf_iterator<char>(input)),
-                        std::istreambuf_iterator<char>());
-    input.close();
+    // Fleet metrics: one sample per run, tagged by the output target's
+    // basename and the config fingerprint, so dashboards can aggregate
+    // thousands of daily runs per configuration
+    Timer run_timer;
+    run_timer.start();
+    auto exportRunMetrics = [&]() {
+        if (metrics_prom_file.empty() && statsd_target.empty()) return;
+
+        Statistics run_stats = obfuscator.exportStatistics();
+        run_stats.set("run_time_ms", run_timer.elapsedMs());
+
+        std::string target = output_file;
+        size_t slash = target.find_last_of('/');
+        if (slash != std::string::npos) target = target.substr(slash + 1);
+
+        MetricsExporter exporter(target, run_stats.getString("config_fingerprint"));
+        if (!metrics_prom_file.empty()) {
+            if (exporter.writePrometheusFile(metrics_prom_file, run_stats)) {
+                fprintf(stderr, "[morphect] Metrics written to %s\n",
+                        metrics_prom_file.c_str());
+            } else {
+                fprintf(stderr, "[morphect] Warning: cannot write metrics file: %s\n",
+                        metrics_prom_file.c_str());
+            }
+        }
+        if (!statsd_target.empty() &&
+            !exporter.pushStatsd(statsd_target, run_stats)) {
+            fprintf(stderr, "[morphect] Warning: cannot reach StatsD at %s\n",
+                    statsd_target.c_str());
+        }
+    };
+
+    // Daemon mode: hold the configured pipeline (and incremental cache)
+    // in memory and serve jobs submitted with --connect
+    if (!daemon_socket.empty()) {
+        int rc = runDaemon(obfuscator, daemon_socket);
+        if (!trace_file.empty()) writeTraceFile(trace_file);
+        return rc;
+    }
 
-    fprintf(stderr, "[morphect] Read %zu bytes from %s\n", ir_code.size(), input_file.c_str());
+    // Batch mode: one configured pipeline streams through many pairs;
+    // with --jobs N, N files are processed concurrently on copies of the
+    // configured obfuscator
+    if (!batch_file.empty()) {
+        std::vector<BatchJob> batch_jobs;
+        if (!loadBatchList(batch_file, batch_jobs)) {
+            return 1;
+        }
 
-    // Obfuscate
-    std::string obfuscated = obfuscator.obfuscateFull(ir_code);
+        fprintf(stderr, "[morphect] Batch: %zu files\n", batch_jobs.size());
 
-    // Write output
-    std::ofstream output(output_file);
-    if (!output.is_open()) {
-        std::cerr << "[morphect] Error: Cannot create output file: " << output_file << std::endl;
-        return 1;
-    }
+        std::atomic<size_t> next_job{0};
+        std::atomic<int> failures{0};
 
-    output << obfuscated;
-    output.close();
+        size_t workers = std::min(static_cast<size_t>(jobs), batch_jobs.size());
+        if (workers == 0) workers = 1;
 
-    fprintf(stderr, "[morphect] Wrote %zu bytes to %s\n", obfuscated.size(), output_file.c_str());
+        auto worker = [&]() {
+            // Each worker gets its own copy of the configured obfuscator;
+            // per-file function parallelism stays off in batch mode
+            LLVMIRObfuscator local = obfuscator;
+            local.setJobs(1);
 
-    // Size statistics
-    double increase = ((double)obfuscated.size() / ir_code.size() - 1.0) * 100.0;
-    fprintf(stderr, "[morphect] Size change: %+.1f%%\n", increase);
+            for (;;) {
+                size_t idx = next_job.fetch_add(1);
+                if (idx >= batch_jobs.size()) break;
 
-    // Print transformation statistics
-    obfuscator.printStatistics();
+                const auto& job = batch_jobs[idx];
+                if (processOneFile(local, job.input, job.output, false) != 0) {
+                    failures.fetch_add(1);
+                }
+            }
+        };
 
-    return 0;
+        if (workers == 1) {
+            worker();
+        } else {
+            morphect::primeLocaleCaches();
+            std::vector<std::thread> pool;
+            pool.reserve(workers);
+            for (size_t w = 0; w < workers; w++) {
+                pool.emplace_back(worker);
+            }
+            for (auto& t : pool) {
+                t.join();
+            }
+        }
+
+        fprintf(stderr, "[morphect] Batch complete: %zu files, %d failures\n",
+                batch_jobs.size(), failures.load());
+        if (!trace_file.empty()) writeTraceFile(trace_file);
+        return failures.load() > 0 ? 1 : 0;
+    }
+
+    // Distributed mode: shard the single module across worker daemons
+    // on other nodes (shard count defaults to one per worker)
+    if (!worker_endpoints.empty()) {
+        int shards = partitions > 1 ? partitions
+                                    : static_cast<int>(worker_endpoints.size());
+        int rc = runDistributed(obfuscator, input_file, output_file,
+                                worker_endpoints, shards);
+        if (rc == 0 && verify) {
+            rc = runVerify(obfuscator, input_file, output_file, jobs, verify_vectors);
+        }
+        if (rc == 0) exportRunMetrics();
+        if (!trace_file.empty()) writeTraceFile(trace_file);
+        return rc;
+    }
+
+    // Partitioned mode: shard the single module across worker processes
+    if (partitions > 1) {
+        int rc = runPartitioned(obfuscator, input_file, output_file, partitions);
+        if (rc == 0 && verify) {
+            rc = runVerify(obfuscator, input_file, output_file, jobs, verify_vectors);
+        }
+        if (rc == 0) exportRunMetrics();
+        if (!trace_file.empty()) writeTraceFile(trace_file);
+        return rc;
+    }
+
+    int rc = processOneFile(obfuscator, input_file, output_file, true);
+    if (rc == 0 && verify) {
+        rc = runVerify(obfuscator, input_file, output_file, jobs, verify_vectors);
+    }
+    if (rc == 0) exportRunMetrics();
+    if (!trace_file.empty()) writeTraceFile(trace_file);
+    return rc;
 }
+
+// Optional counting operator new/delete (no-op unless the build sets
+// MORPHECT_COUNT_ALLOCATIONS)
+#include "core/allocation_hook.inc"
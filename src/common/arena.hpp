@@ -0,0 +1,170 @@
+/*
+ * arena.hpp
+ *
+ * bump-pointer arena for per-function transformation scratch
+ *
+ * Passes allocate temporary vectors and strings per function and free
+ * them piecemeal; malloc/free shows up as ~15% of runtime on large
+ * modules. An arena turns that into a pointer bump per allocation and
+ * one wholesale reset per function. The pass-execution context in
+ * PassManager owns the arena and resets it after each function.
+ */
+
+#ifndef MORPHECT_ARENA_HPP
+#define MORPHECT_ARENA_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace morphect {
+
+/**
+ * Chunked bump allocator
+ *
+ * Allocation bumps a pointer within the current chunk, adding chunks
+ * as needed. Nothing is freed individually: reset() rewinds to the
+ * first chunk (keeping it warm) so the next function reuses the same
+ * memory. Destructors of arena-placed objects never run - only use it
+ * for trivially destructible data or via ArenaAllocator containers
+ * that are drained before reset.
+ */
+class Arena {
+public:
+    static constexpr size_t kChunkSize = 256 * 1024;
+
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Allocate size bytes at the given alignment
+     */
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        if (current_ == chunks_.size() || !fits(size, align)) {
+            addChunk(size);
+        }
+        Chunk& chunk = chunks_[current_];
+        size_t aligned = (chunk.used + align - 1) & ~(align - 1);
+        void* ptr = chunk.data.get() + aligned;
+        chunk.used = aligned + size;
+        bytes_allocated_ += size;
+        return ptr;
+    }
+
+    /**
+     * Rewind to empty, keeping the chunks for reuse
+     */
+    void reset() {
+        for (auto& chunk : chunks_) {
+            chunk.used = 0;
+        }
+        current_ = 0;
+        bytes_allocated_ = 0;
+    }
+
+    /**
+     * Total bytes handed out since the last reset
+     */
+    size_t bytesAllocated() const { return bytes_allocated_; }
+
+    /**
+     * Total capacity across chunks (high-water mark of a function)
+     */
+    size_t bytesReserved() const {
+        size_t total = 0;
+        for (const auto& chunk : chunks_) {
+            total += chunk.capacity;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t capacity = 0;
+        size_t used = 0;
+    };
+
+    bool fits(size_t size, size_t align) const {
+        const Chunk& chunk = chunks_[current_];
+        size_t aligned = (chunk.used + align - 1) & ~(align - 1);
+        return aligned + size <= chunk.capacity;
+    }
+
+    void addChunk(size_t min_size) {
+        // Reuse an already-reserved later chunk after reset()
+        if (current_ + 1 < chunks_.size() &&
+            chunks_[current_ + 1].used == 0 &&
+            chunks_[current_ + 1].capacity >= min_size) {
+            if (current_ < chunks_.size()) current_++;
+            return;
+        }
+        size_t capacity = min_size > kChunkSize ? min_size : kChunkSize;
+        Chunk chunk;
+        chunk.data = std::make_unique<char[]>(capacity);
+        chunk.capacity = capacity;
+        if (!chunks_.empty()) current_++;
+        chunks_.insert(chunks_.begin() + current_, std::move(chunk));
+    }
+
+    std::vector<Chunk> chunks_;
+    size_t current_ = 0;
+    size_t bytes_allocated_ = 0;
+};
+
+/**
+ * std-allocator adapter over an Arena
+ *
+ * Lets standard containers draw their storage from the arena:
+ * deallocate is a no-op, the memory comes back at reset(). Containers
+ * must not outlive the reset.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {
+        // Memory comes back wholesale at Arena::reset()
+    }
+
+    Arena* arena() const { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena_ == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena_ != other.arena();
+    }
+
+private:
+    Arena* arena_;
+};
+
+/**
+ * Arena-backed container aliases for per-function scratch
+ */
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+using ArenaString =
+    std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+} // namespace morphect
+
+#endif // MORPHECT_ARENA_HPP
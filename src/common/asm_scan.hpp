@@ -0,0 +1,182 @@
+/*
+ * asm_scan.hpp
+ *
+ * one-pass scanner for x86/x64 assembly text
+ *
+ * The anti-disassembly transformation and the assembly obfuscator each
+ * re-walked the same .s lines for function boundaries, label
+ * definitions and instruction classes - three or four independent
+ * traversals over inputs that can be gigabytes of generated assembly.
+ * This scanner produces all of it in one sweep: a per-line class, the
+ * label table, function ranges and the insertion-point lists the
+ * anti-disasm pass consumes. Consumers index into the result instead of
+ * re-parsing.
+ */
+
+#ifndef MORPHECT_ASM_SCAN_HPP
+#define MORPHECT_ASM_SCAN_HPP
+
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace morphect {
+
+/**
+ * What kind of line this is, decided once during the scan
+ */
+enum class AsmLineClass : uint8_t {
+    Empty,          // blank line
+    Comment,        // # or ; comment
+    Directive,      // .text, .size, .cfi_*, ...
+    LabelDef,       // name: / .Lname:
+    Instruction     // anything executable
+};
+
+/**
+ * One label definition, in file order
+ */
+struct AsmLabelDef {
+    std::string name;   // without the leading dot
+    size_t line = 0;    // index into the lines vector
+    bool dotted = false;
+};
+
+/**
+ * Everything one scan produces
+ *
+ * The int vectors mirror the insertion-point lists AssemblyAnalyzer
+ * used to build with separate traversals, so the anti-disasm pass can
+ * consume them directly.
+ */
+struct AsmScan {
+    std::vector<AsmLineClass> line_class;            // one entry per line
+    std::vector<AsmLabelDef> labels;                 // every label definition
+    std::vector<std::pair<size_t, size_t>> functions; // .type@function .. .size
+    std::vector<int> unconditional_jumps;            // lines starting with jmp
+    std::vector<int> function_entries;               // prologue line after a label
+    std::vector<int> prologue_points;                // after .size / .text
+    bool saw_x64_registers = false;                  // rax/rsp/r8..r15 seen
+};
+
+/**
+ * Single-pass scanner over a module's line vector
+ */
+class AsmScanner {
+public:
+    static AsmScan scan(const std::vector<std::string>& lines) {
+        AsmScan result;
+        result.line_class.reserve(lines.size());
+
+        bool in_function = false;
+        size_t func_start = 0;
+
+        for (size_t i = 0; i < lines.size(); i++) {
+            const std::string& line = lines[i];
+            size_t pos = line.find_first_not_of(" \t");
+
+            if (pos == std::string::npos) {
+                result.line_class.push_back(AsmLineClass::Empty);
+                continue;
+            }
+
+            char c = line[pos];
+            if (c == '#' || c == ';') {
+                result.line_class.push_back(AsmLineClass::Comment);
+                continue;
+            }
+
+            // Label definition: a maximal word token (optionally with a
+            // leading dot) followed immediately by ':'
+            bool dotted = (c == '.');
+            size_t name_start = dotted ? pos + 1 : pos;
+            size_t name_end = name_start;
+            while (name_end < line.size() && isWordChar(line[name_end])) {
+                name_end++;
+            }
+            if (name_end > name_start && name_end < line.size() &&
+                line[name_end] == ':') {
+                result.line_class.push_back(AsmLineClass::LabelDef);
+                result.labels.push_back(
+                    {line.substr(name_start, name_end - name_start), i, dotted});
+
+                // A non-dotted label whose next line pushes a register is
+                // a function entry; the prologue line is the entry point
+                if (!dotted && i + 1 < lines.size() &&
+                    lines[i + 1].find("push") != std::string::npos) {
+                    result.function_entries.push_back(static_cast<int>(i + 1));
+                }
+                continue;
+            }
+
+            if (dotted) {
+                result.line_class.push_back(AsmLineClass::Directive);
+
+                if (line.compare(pos, 5, ".type") == 0 &&
+                    line.find("@function", pos) != std::string::npos) {
+                    in_function = true;
+                    func_start = i;
+                } else if (line.compare(pos, 5, ".size") == 0) {
+                    if (in_function) {
+                        result.functions.push_back({func_start, i});
+                        in_function = false;
+                    }
+                    // End of a function: safe spot for fake prologues
+                    result.prologue_points.push_back(static_cast<int>(i));
+                } else if (line.compare(pos, 5, ".text") == 0 &&
+                           pos + 5 == line.find_last_not_of(" \t") + 1) {
+                    result.prologue_points.push_back(static_cast<int>(i));
+                }
+                continue;
+            }
+
+            result.line_class.push_back(AsmLineClass::Instruction);
+
+            if (line.compare(pos, 4, "jmp ") == 0 ||
+                line.compare(pos, 4, "jmp\t") == 0) {
+                result.unconditional_jumps.push_back(static_cast<int>(i));
+            }
+
+            if (!result.saw_x64_registers && mentionsX64Register(line, pos)) {
+                result.saw_x64_registers = true;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    static bool isWordChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    /**
+     * Cheap x86-64 register sniff on an instruction line: an 'r'
+     * followed by ax/bx/sp/bp or a digit at a word boundary
+     */
+    static bool mentionsX64Register(const std::string& line, size_t from) {
+        for (size_t i = from; i + 1 < line.size(); i++) {
+            if (line[i] != 'r') continue;
+            if (i > 0 && isWordChar(line[i - 1])) continue;
+            char next = line[i + 1];
+            if (std::isdigit(static_cast<unsigned char>(next))) return true;
+            if (i + 2 < line.size()) {
+                char third = line[i + 2];
+                if ((next == 'a' && third == 'x') ||
+                    (next == 'b' && (third == 'x' || third == 'p')) ||
+                    (next == 's' && (third == 'p' || third == 'i')) ||
+                    (next == 'd' && (third == 'i' || third == 'x')) ||
+                    (next == 'c' && third == 'x')) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_ASM_SCAN_HPP
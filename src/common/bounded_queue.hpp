@@ -0,0 +1,86 @@
+/*
+ * bounded_queue.hpp
+ *
+ * blocking bounded queue for pipeline stages
+ *
+ * The driver stages (reader, transform workers, writer) hand work to
+ * each other through these queues: push blocks when the consumer is
+ * behind, pop blocks when the producer is, so a slow stage throttles
+ * the pipeline instead of ballooning memory. close() lets producers
+ * signal end-of-stream; pop drains remaining items before reporting it.
+ */
+
+#ifndef MORPHECT_BOUNDED_QUEUE_HPP
+#define MORPHECT_BOUNDED_QUEUE_HPP
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+namespace morphect {
+
+/**
+ * Fixed-capacity producer/consumer queue
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    /**
+     * Block until there is room, then enqueue. Returns false (and drops
+     * the item) if the queue was closed.
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [&] { return items_.size() < capacity_ || closed_; });
+        if (closed_) return false;
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    /**
+     * Block until an item arrives or the queue is closed and drained.
+     * Returns false only on end-of-stream.
+     */
+    bool pop(T& out) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [&] { return !items_.empty() || closed_; });
+        if (items_.empty()) return false;
+        out = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    /**
+     * Signal end-of-stream; blocked producers give up, consumers drain
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_BOUNDED_QUEUE_HPP
@@ -0,0 +1,154 @@
+/*
+ * checkpoint.hpp
+ *
+ * run manifest for checkpointed obfuscation
+ *
+ * A multi-hour run that dies at 90% used to restart from zero. The
+ * incremental cache already persists every completed function region
+ * as it finishes, and deterministic seeding reproduces the rest, so a
+ * checkpoint only needs to pin the run's identity: the manifest records
+ * the input hash and config fingerprint plus one line per completed
+ * function. --resume validates the identity (a changed input or config
+ * must not splice stale regions) and reports how much of the previous
+ * run carries over; the regions themselves replay from the cache.
+ */
+
+#ifndef MORPHECT_CHECKPOINT_HPP
+#define MORPHECT_CHECKPOINT_HPP
+
+#include <string>
+#include <unordered_set>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <cstdint>
+
+namespace morphect {
+
+/**
+ * Append-only manifest of completed functions
+ *
+ * Text format, one record per line:
+ *   morphect-checkpoint 1
+ *   input <hex>
+ *   config <hex>
+ *   done <index>
+ * Completion lines are appended (and flushed) one write at a time, so
+ * a killed run loses at most the function it was mid-way through.
+ */
+class CheckpointManifest {
+public:
+    CheckpointManifest() = default;
+
+    // Copies carry the completion set but never the open manifest file:
+    // partition and batch workers checkpoint their own runs (if at all)
+    CheckpointManifest(const CheckpointManifest& other) {
+        std::lock_guard<std::mutex> lock(other.mutex_);
+        done_ = other.done_;
+    }
+
+    CheckpointManifest& operator=(const CheckpointManifest& other) {
+        if (this == &other) return *this;
+        std::unordered_set<size_t> copy;
+        {
+            std::lock_guard<std::mutex> lock(other.mutex_);
+            copy = other.done_;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = std::move(copy);
+        if (out_.is_open()) out_.close();
+        return *this;
+    }
+
+    /**
+     * Start a fresh manifest for this (input, config) identity
+     */
+    bool create(const std::string& path, uint64_t input_hash,
+                uint64_t config_fingerprint) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.clear();
+
+        out_.open(path, std::ios::trunc);
+        if (!out_.is_open()) return false;
+
+        out_ << "morphect-checkpoint 1\n";
+        out_ << "input " << std::hex << input_hash << "\n";
+        out_ << "config " << std::hex << config_fingerprint << std::dec << "\n";
+        out_.flush();
+        return out_.good();
+    }
+
+    /**
+     * Load a previous run's manifest and reopen it for appending.
+     * Returns false (leaving the manifest unusable until create()) if
+     * the file is missing or belongs to a different input or config.
+     */
+    bool load(const std::string& path, uint64_t input_hash,
+              uint64_t config_fingerprint) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.clear();
+
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+
+        std::string word;
+        uint64_t value = 0;
+        int version = 0;
+        if (!(in >> word >> version) || word != "morphect-checkpoint" || version != 1) {
+            return false;
+        }
+        if (!(in >> word >> std::hex >> value) || word != "input" || value != input_hash) {
+            return false;
+        }
+        if (!(in >> word >> std::hex >> value) || word != "config" ||
+            value != config_fingerprint) {
+            return false;
+        }
+
+        size_t idx = 0;
+        while (in >> word >> std::dec >> idx) {
+            if (word == "done") {
+                done_.insert(idx);
+            }
+        }
+        in.close();
+
+        out_.open(path, std::ios::app);
+        return out_.is_open();
+    }
+
+    /**
+     * Record a completed function (flushed immediately)
+     */
+    void markDone(size_t index) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (done_.insert(index).second && out_.is_open()) {
+            out_ << "done " << index << "\n";
+            out_.flush();
+        }
+    }
+
+    bool isDone(size_t index) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return done_.count(index) > 0;
+    }
+
+    size_t doneCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return done_.size();
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (out_.is_open()) out_.close();
+    }
+
+private:
+    std::unordered_set<size_t> done_;
+    std::ofstream out_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_CHECKPOINT_HPP
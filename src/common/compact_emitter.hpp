@@ -0,0 +1,178 @@
+/*
+ * compact_emitter.hpp
+ *
+ * compact emission mode for transformed IR
+ *
+ * Transformed modules carry long generated identifiers (%_dead3423_opq_v,
+ * %split__mba_a100000_p1_0) plus comment and blank lines, all of which
+ * clang/llc must re-lex downstream. The emitter compacts a module one
+ * line at a time: comment-only and blank lines are dropped, trailing
+ * comments stripped, and generated-only identifiers renamed to
+ * minimal-length names drawn from the interning table - first sight of
+ * a name assigns the next dense SymbolId, so the short name depends only
+ * on module order and the output stays deterministic. Source-level
+ * identifiers are never touched; renames live in the "m.<n>" namespace
+ * (a shape neither clang nor our passes produce) to keep them collision
+ * free.
+ *
+ * Streaming by design: one line in, one line out, no module-wide
+ * pre-scan, so the pipelined writer can compact regions as they finish.
+ */
+
+#ifndef MORPHECT_COMPACT_EMITTER_HPP
+#define MORPHECT_COMPACT_EMITTER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cctype>
+
+#include "string_interner.hpp"
+
+namespace morphect {
+
+class CompactEmitter {
+public:
+    /**
+     * Compact one line of IR. Returns false when the line is dropped
+     * entirely (blank or comment-only); otherwise `out` holds the
+     * compacted line.
+     */
+    bool compactLine(std::string_view line, std::string& out) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos || line[first] == ';') {
+            return false;  // blank or comment-only
+        }
+
+        // Trailing comment: only safe to cut when the line has no string
+        // constant (a c"..." may legitimately contain ';')
+        std::string_view body = line;
+        if (body.find('"') == std::string_view::npos) {
+            size_t semi = body.find(';');
+            if (semi != std::string_view::npos) {
+                body = body.substr(0, semi);
+            }
+        }
+        size_t last = body.find_last_not_of(" \t");
+        if (last == std::string_view::npos) {
+            return false;
+        }
+        body = body.substr(0, last + 1);
+
+        out.clear();
+        out.reserve(body.size());
+
+        bool in_string = false;
+        size_t i = 0;
+
+        // Label definition at column zero: refs carry a leading %, the
+        // def site does not, so handle it before the scan below
+        if (isIdentChar(body[0])) {
+            size_t end = 1;
+            while (end < body.size() && isIdentChar(body[end])) end++;
+            if (end < body.size() && body[end] == ':') {
+                appendIdentifier(body.substr(0, end), out);
+                i = end;
+            }
+        }
+
+        for (; i < body.size(); i++) {
+            char c = body[i];
+            if (c == '"') {
+                in_string = !in_string;
+                out.push_back(c);
+                continue;
+            }
+            if (!in_string && c == '%' && i + 1 < body.size() &&
+                isIdentChar(body[i + 1])) {
+                size_t end = i + 1;
+                while (end < body.size() && isIdentChar(body[end])) end++;
+                out.push_back('%');
+                appendIdentifier(body.substr(i + 1, end - i - 1), out);
+                i = end - 1;
+                continue;
+            }
+            out.push_back(c);
+        }
+        return true;
+    }
+
+    /**
+     * Convenience for the non-streaming path
+     */
+    std::vector<std::string> compact(const std::vector<std::string>& lines) {
+        std::vector<std::string> result;
+        result.reserve(lines.size());
+        std::string out;
+        for (const auto& line : lines) {
+            if (compactLine(line, out)) {
+                result.push_back(out);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Is this an identifier our passes generated? Only these are safe
+     * to rename - source-level names must survive verbatim.
+     */
+    static bool isGeneratedName(std::string_view name) {
+        static constexpr std::string_view prefixes[] = {
+            "_",          // _dead, _pool, _op_t, _mba_m, _cff_, __t ...
+            "split_", "reconst_", "mba_", "const_obf_",
+            "state_", "cff_", "bogus_", "dead_block", "fake",
+        };
+        for (std::string_view prefix : prefixes) {
+            if (name.substr(0, prefix.size()) == prefix) {
+                return true;
+            }
+        }
+        // Dead-code pass labels: continue<N> / continue_<N>
+        if (name.substr(0, 8) == "continue" && name.size() > 8) {
+            for (size_t i = 8; i < name.size(); i++) {
+                if (name[i] != '_' && !std::isdigit(static_cast<unsigned char>(name[i]))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    size_t renamedCount() const { return names_.size(); }
+
+private:
+    StringInterner names_;
+
+    static bool isIdentChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) ||
+               c == '_' || c == '.' || c == '$';
+    }
+
+    void appendIdentifier(std::string_view name, std::string& out) {
+        if (!isGeneratedName(name)) {
+            out.append(name);
+            return;
+        }
+        StringInterner::SymbolId id = names_.intern(name);
+        out.append("m.");
+        appendBase36(id, out);
+    }
+
+    static void appendBase36(uint32_t value, std::string& out) {
+        static constexpr char digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+        char buf[8];
+        size_t n = 0;
+        do {
+            buf[n++] = digits[value % 36];
+            value /= 36;
+        } while (value > 0);
+        while (n > 0) {
+            out.push_back(buf[--n]);
+        }
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_COMPACT_EMITTER_HPP
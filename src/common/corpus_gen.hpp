@@ -0,0 +1,299 @@
+/**
+ * Morphect - Multi-Language Code Obfuscator
+ *
+ * corpus_gen.hpp - Synthetic IR/assembly corpus generation
+ *
+ * Benchmarks and scaling tests need large inputs, and real modules
+ * can't always be shared. The generator synthesizes .ll and .s text
+ * with controllable shape — function count, basic-block distribution,
+ * instruction mix, string-table size — in exactly the patterns
+ * LLVMCFGAnalyzer and AsmScanner parse, so a 1 GB synthetic module
+ * exercises the same code paths as a 1 GB production one.
+ *
+ * Generation is deterministic per (seed, function index): functions can
+ * be produced in any order or streamed one at a time and the bytes
+ * never change, so a scaling cliff found at some seed reproduces
+ * exactly.
+ *
+ * Emitted IR is valid SSA: every instruction only uses function
+ * arguments or values defined earlier in its own block, and all
+ * branches go forward, so dominance holds without phi nodes.
+ */
+
+#ifndef MORPHECT_CORPUS_GEN_HPP
+#define MORPHECT_CORPUS_GEN_HPP
+
+#include <string>
+#include <vector>
+
+#include "random.hpp"
+
+namespace morphect {
+
+/**
+ * Shape parameters for a synthetic module
+ */
+struct CorpusShape {
+    int functions = 100;
+
+    // Basic blocks per function, drawn uniformly from [min, max]
+    int min_blocks = 1;
+    int max_blocks = 8;
+
+    // Instructions per block, drawn uniformly from [min, max]
+    int min_instructions = 2;
+    int max_instructions = 10;
+
+    // String-table entries emitted ahead of the functions
+    int strings = 16;
+
+    // Instruction mix weights (normalized internally)
+    double arith_weight = 0.6;
+    double mem_weight = 0.3;
+    double call_weight = 0.1;
+
+    uint64_t seed = 42;
+};
+
+class CorpusGenerator {
+public:
+    explicit CorpusGenerator(const CorpusShape& shape) : shape_(shape) {}
+
+    const CorpusShape& shape() const { return shape_; }
+
+    /**
+     * Module prelude for IR output: string-table globals plus the
+     * external declaration call instructions reference
+     */
+    std::vector<std::string> irPrelude() const {
+        std::vector<std::string> lines;
+        for (int s = 0; s < shape_.strings; s++) {
+            std::string text = stringLiteral(s);
+            lines.push_back("@.str." + std::to_string(s) +
+                            " = private unnamed_addr constant [" +
+                            std::to_string(text.size() + 1) + " x i8] c\"" +
+                            text + "\\00\"");
+        }
+        if (shape_.call_weight > 0.0) {
+            lines.push_back("declare i32 @corpus_ext(i32)");
+        }
+        lines.push_back("");
+        return lines;
+    }
+
+    /**
+     * One synthetic IR function (deterministic in seed and index)
+     */
+    std::vector<std::string> irFunction(int index) const {
+        LocalRandom rng(LocalRandom::deriveSeed(
+            shape_.seed, "ir:" + std::to_string(index)));
+
+        int blocks = rng.nextInt(shape_.min_blocks, shape_.max_blocks);
+        std::string fn = "corpus_fn_" + std::to_string(index);
+
+        std::vector<std::string> lines;
+        lines.push_back("define i32 @" + fn + "(i32 %a, i32 %b) {");
+
+        int value_id = 0;
+        std::string last_value = "%a";
+
+        for (int b = 0; b < blocks; b++) {
+            lines.push_back(b == 0 ? "entry:" : "bb" + std::to_string(b) + ":");
+
+            // Block-local SSA: usable operands restart at the arguments
+            std::vector<std::string> operands = {"%a", "%b"};
+            int count = rng.nextInt(shape_.min_instructions,
+                                    shape_.max_instructions);
+            for (int i = 0; i < count; i++) {
+                last_value = emitIRInstruction(rng, operands, value_id, lines);
+                operands.push_back(last_value);
+            }
+
+            if (b + 1 < blocks) {
+                // Forward branch: conditional to a random later block,
+                // or a plain fallthrough
+                std::string next = "bb" + std::to_string(b + 1);
+                if (blocks > b + 2 && rng.decide(0.5)) {
+                    std::string other =
+                        "bb" + std::to_string(rng.nextInt(b + 2, blocks - 1));
+                    std::string cmp = "%c" + std::to_string(value_id++);
+                    lines.push_back("  " + cmp + " = icmp slt i32 " +
+                                    last_value + ", " +
+                                    std::to_string(rng.nextInt(0, 255)));
+                    lines.push_back("  br i1 " + cmp + ", label %" + next +
+                                    ", label %" + other);
+                } else {
+                    lines.push_back("  br label %" + next);
+                }
+            } else {
+                lines.push_back("  ret i32 " + last_value);
+            }
+        }
+
+        lines.push_back("}");
+        lines.push_back("");
+        return lines;
+    }
+
+    /**
+     * Module prelude for assembly output: .text plus a .rodata string
+     * table in the form AsmScanner classifies as directives
+     */
+    std::vector<std::string> asmPrelude() const {
+        std::vector<std::string> lines;
+        if (shape_.strings > 0) {
+            lines.push_back("\t.section\t.rodata");
+            for (int s = 0; s < shape_.strings; s++) {
+                lines.push_back(".LC" + std::to_string(s) + ":");
+                lines.push_back("\t.string\t\"" + stringLiteral(s) + "\"");
+            }
+        }
+        lines.push_back("\t.text");
+        return lines;
+    }
+
+    /**
+     * One synthetic x86-64 assembly function (deterministic in seed and
+     * index), in the .type/@function .. .size frame AsmScanner keys on
+     */
+    std::vector<std::string> asmFunction(int index) const {
+        LocalRandom rng(LocalRandom::deriveSeed(
+            shape_.seed, "asm:" + std::to_string(index)));
+
+        int blocks = rng.nextInt(shape_.min_blocks, shape_.max_blocks);
+        std::string fn = "corpus_fn_" + std::to_string(index);
+
+        std::vector<std::string> lines;
+        lines.push_back("\t.globl\t" + fn);
+        lines.push_back("\t.type\t" + fn + ", @function");
+        lines.push_back(fn + ":");
+        lines.push_back("\tpushq\t%rbp");
+        lines.push_back("\tmovq\t%rsp, %rbp");
+
+        for (int b = 0; b < blocks; b++) {
+            if (b > 0) {
+                lines.push_back(asmLabel(index, b) + ":");
+            }
+
+            int count = rng.nextInt(shape_.min_instructions,
+                                    shape_.max_instructions);
+            for (int i = 0; i < count; i++) {
+                lines.push_back("\t" + asmInstruction(rng));
+            }
+
+            if (b + 1 < blocks) {
+                if (blocks > b + 2 && rng.decide(0.5)) {
+                    std::string other =
+                        asmLabel(index, rng.nextInt(b + 2, blocks - 1));
+                    lines.push_back("\tcmpl\t$" +
+                                    std::to_string(rng.nextInt(0, 255)) +
+                                    ", %eax");
+                    lines.push_back("\tjne\t" + other);
+                } else {
+                    lines.push_back("\tjmp\t" + asmLabel(index, b + 1));
+                }
+            }
+        }
+
+        lines.push_back("\tpopq\t%rbp");
+        lines.push_back("\tret");
+        lines.push_back("\t.size\t" + fn + ", .-" + fn);
+        return lines;
+    }
+
+private:
+    CorpusShape shape_;
+
+    std::string stringLiteral(int index) const {
+        // Deterministic filler with varied lengths, no escapes needed
+        LocalRandom rng(LocalRandom::deriveSeed(
+            shape_.seed, "str:" + std::to_string(index)));
+        int words = rng.nextInt(2, 8);
+        std::string text = "corpus literal " + std::to_string(index);
+        for (int w = 0; w < words; w++) {
+            text += " word" + std::to_string(rng.nextInt(0, 9999));
+        }
+        return text;
+    }
+
+    /**
+     * Weighted draw from the instruction mix
+     */
+    enum class Mix { Arith, Mem, Call };
+
+    Mix drawMix(LocalRandom& rng) const {
+        double total = shape_.arith_weight + shape_.mem_weight +
+                       shape_.call_weight;
+        if (total <= 0.0) return Mix::Arith;
+        double roll = rng.nextDouble() * total;
+        if (roll < shape_.arith_weight) return Mix::Arith;
+        if (roll < shape_.arith_weight + shape_.mem_weight) return Mix::Mem;
+        return Mix::Call;
+    }
+
+    /**
+     * Append one mix draw's worth of IR to `lines` and return the value
+     * it defines. A memory draw is the whole alloca/store/load triple
+     * so it stays block-local (and therefore dominated).
+     */
+    std::string emitIRInstruction(LocalRandom& rng,
+                                  const std::vector<std::string>& operands,
+                                  int& value_id,
+                                  std::vector<std::string>& lines) const {
+        static const char* kArithOps[] = {"add", "sub", "xor", "and", "or", "mul"};
+        const std::string lhs = operands[rng.nextSize(operands.size())];
+        std::string value = "%v" + std::to_string(value_id++);
+
+        switch (drawMix(rng)) {
+        case Mix::Arith: {
+            const char* op = kArithOps[rng.nextSize(6)];
+            std::string rhs = rng.decide(0.5)
+                ? operands[rng.nextSize(operands.size())]
+                : std::to_string(rng.nextInt(1, 4096));
+            lines.push_back("  " + value + " = " + op + " i32 " + lhs +
+                            ", " + rhs);
+            return value;
+        }
+        case Mix::Mem: {
+            std::string slot = "%p" + std::to_string(value_id++);
+            lines.push_back("  " + slot + " = alloca i32");
+            lines.push_back("  store i32 " + lhs + ", i32* " + slot);
+            lines.push_back("  " + value + " = load i32, i32* " + slot);
+            return value;
+        }
+        case Mix::Call:
+            lines.push_back("  " + value + " = call i32 @corpus_ext(i32 " +
+                            lhs + ")");
+            return value;
+        }
+        lines.push_back("  " + value + " = add i32 " + lhs + ", 1");
+        return value;
+    }
+
+    std::string asmInstruction(LocalRandom& rng) const {
+        static const char* kArithOps[] = {"addl", "subl", "xorl", "andl", "orl"};
+        switch (drawMix(rng)) {
+        case Mix::Arith:
+            return std::string(kArithOps[rng.nextSize(5)]) + "\t$" +
+                   std::to_string(rng.nextInt(1, 4096)) + ", %eax";
+        case Mix::Mem:
+            return rng.decide(0.5)
+                ? "movl\t-" + std::to_string(4 * rng.nextInt(1, 8)) +
+                      "(%rbp), %eax"
+                : "movl\t%eax, -" + std::to_string(4 * rng.nextInt(1, 8)) +
+                      "(%rbp)";
+        case Mix::Call:
+            return "call\tcorpus_ext";
+        }
+        return "nop";
+    }
+
+    static std::string asmLabel(int function, int block) {
+        return ".Lcorpus_" + std::to_string(function) + "_" +
+               std::to_string(block);
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_CORPUS_GEN_HPP
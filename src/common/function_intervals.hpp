@@ -0,0 +1,123 @@
+/*
+ * function_intervals.hpp
+ *
+ * interval index over function line regions
+ *
+ * Per-line function attribution ("which function contains line N")
+ * used to scan the whole FunctionInfo list, which is O(functions) and
+ * sits inside the inner loop of the verbose-logging and per-function
+ * config paths. Function regions never overlap, so a sorted start
+ * array plus binary search answers the query in O(log functions), and
+ * shiftFrom() keeps the index valid as passes insert lines.
+ */
+
+#ifndef MORPHECT_FUNCTION_INTERVALS_HPP
+#define MORPHECT_FUNCTION_INTERVALS_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+namespace morphect {
+
+/**
+ * Sorted interval index over [start_line, end_line] function regions
+ *
+ * Build once from the parsed function list, query by line number.
+ * Lines outside every region resolve to "<global>", matching the
+ * attribution the obfuscators already print.
+ */
+class FunctionIntervalIndex {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * Register one function region (inclusive line range)
+     */
+    void add(const std::string& name, int start_line, int end_line) {
+        intervals_.push_back(Interval{name, start_line, end_line});
+        sorted_ = false;
+    }
+
+    /**
+     * Sort regions by start line; called lazily by the queries
+     */
+    void build() {
+        std::sort(intervals_.begin(), intervals_.end(),
+                  [](const Interval& a, const Interval& b) {
+                      return a.start_line < b.start_line;
+                  });
+        sorted_ = true;
+    }
+
+    /**
+     * Index of the region containing the line, or npos
+     */
+    size_t indexAt(int line) const {
+        if (!sorted_) {
+            const_cast<FunctionIntervalIndex*>(this)->build();
+        }
+        // Last interval whose start is <= line
+        auto it = std::upper_bound(intervals_.begin(), intervals_.end(), line,
+                                   [](int l, const Interval& iv) {
+                                       return l < iv.start_line;
+                                   });
+        if (it == intervals_.begin()) {
+            return npos;
+        }
+        --it;
+        if (line > it->end_line) {
+            return npos;
+        }
+        return static_cast<size_t>(it - intervals_.begin());
+    }
+
+    /**
+     * Name of the function containing the line ("<global>" if none)
+     */
+    std::string nameAt(int line) const {
+        size_t idx = indexAt(line);
+        return idx == npos ? "<global>" : intervals_[idx].name;
+    }
+
+    /**
+     * Shift every region at or after the given line by delta lines
+     *
+     * Passes insert (or drop) lines as they transform; calling this
+     * after an insertion keeps later regions aligned without a
+     * re-parse. A region that straddles the insertion point grows.
+     */
+    void shiftFrom(int line, int delta) {
+        for (auto& iv : intervals_) {
+            if (iv.start_line >= line) {
+                iv.start_line += delta;
+                iv.end_line += delta;
+            } else if (iv.end_line >= line) {
+                iv.end_line += delta;
+            }
+        }
+    }
+
+    size_t size() const { return intervals_.size(); }
+    bool empty() const { return intervals_.empty(); }
+
+    void clear() {
+        intervals_.clear();
+        sorted_ = false;
+    }
+
+private:
+    struct Interval {
+        std::string name;
+        int start_line;
+        int end_line;
+    };
+
+    std::vector<Interval> intervals_;
+    bool sorted_ = false;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_FUNCTION_INTERVALS_HPP
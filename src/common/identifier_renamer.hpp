@@ -0,0 +1,133 @@
+/*
+ * identifier_renamer.hpp
+ *
+ * Bulk identifier renaming in a single pass.
+ *
+ * Several passes rename SSA values or labels across a function body.
+ * Done as one find/replace loop per name, that is O(names x lines) —
+ * renaming-heavy functions took seconds. The renamer instead collects
+ * every (old -> new) pair up front, then makes one left-to-right scan
+ * per line that slices maximal identifier tokens and swaps them via
+ * hash lookup, so the cost is O(lines) regardless of how many names
+ * are mapped. Replacements are whole-token only, which also closes the
+ * substring hazard of naive find/replace (%x matching inside %x1).
+ *
+ * A token is a maximal run of [A-Za-z0-9_.$], optionally introduced by
+ * an LLVM sigil ('%' or '@') which is included in the token. That
+ * covers LLVM SSA names (%x.0, @global) and assembly labels (.L42,
+ * Lfoo) with the same scan.
+ */
+
+#ifndef MORPHECT_IDENTIFIER_RENAMER_HPP
+#define MORPHECT_IDENTIFIER_RENAMER_HPP
+
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace morphect {
+
+class IdentifierRenamer {
+public:
+    /**
+     * Register one (old -> new) pair. Keys must be whole tokens as they
+     * appear in the text, sigil included (e.g. "%x.0", ".L42").
+     */
+    void add(std::string_view from, std::string_view to) {
+        if (from.empty()) return;
+        map_[std::string(from)] = std::string(to);
+        first_char_[static_cast<unsigned char>(from[0])] = true;
+        if (from.size() < min_len_) min_len_ = from.size();
+        if (from.size() > max_len_) max_len_ = from.size();
+    }
+
+    bool empty() const { return map_.empty(); }
+    size_t size() const { return map_.size(); }
+
+    void clear() {
+        map_.clear();
+        first_char_.fill(false);
+        min_len_ = static_cast<size_t>(-1);
+        max_len_ = 0;
+    }
+
+    /**
+     * Rewrite every mapped identifier in one scan of the line
+     */
+    void applyToLine(std::string& line) const {
+        if (map_.empty()) return;
+
+        std::string out;
+        std::string probe;  // reused buffer: one heap block across tokens
+        bool replaced = false;
+        const size_t n = line.size();
+        size_t i = 0;
+
+        while (i < n) {
+            char c = line[i];
+            size_t start = i;
+
+            if (c == '%' || c == '@') {
+                i++;
+                while (i < n && isIdentChar(line[i])) i++;
+            } else if (isIdentChar(c)) {
+                while (i < n && isIdentChar(line[i])) i++;
+            } else {
+                if (replaced) out += c;
+                i++;
+                continue;
+            }
+
+            size_t len = i - start;
+            if (len >= min_len_ && len <= max_len_ &&
+                first_char_[static_cast<unsigned char>(c)]) {
+                probe.assign(line, start, len);
+                auto it = map_.find(probe);
+                if (it != map_.end()) {
+                    // First hit: copy the untouched prefix lazily
+                    if (!replaced) {
+                        out.reserve(line.size());
+                        out.append(line, 0, start);
+                        replaced = true;
+                    }
+                    out += it->second;
+                    continue;
+                }
+            }
+            if (replaced) out.append(line, start, len);
+        }
+
+        if (replaced) {
+            line = std::move(out);
+        }
+    }
+
+    void applyToLines(std::vector<std::string>& lines) const {
+        if (map_.empty()) return;
+        for (auto& line : lines) {
+            applyToLine(line);
+        }
+    }
+
+private:
+    static bool isIdentChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) ||
+               c == '_' || c == '.' || c == '$';
+    }
+
+    std::unordered_map<std::string, std::string> map_;
+
+    // Cheap rejects: a token can only match if its first byte and length
+    // match some key
+    std::array<bool, 256> first_char_{};
+    size_t min_len_ = static_cast<size_t>(-1);
+    size_t max_len_ = 0;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_IDENTIFIER_RENAMER_HPP
@@ -0,0 +1,157 @@
+/*
+ * incremental_cache.hpp
+ *
+ * on-disk cache of transformed function regions
+ *
+ * CI re-obfuscates whole modules even when a handful of functions
+ * changed. Keying each function body by (content, pass configuration,
+ * seed) lets unchanged functions splice in their previously transformed
+ * text instead of re-running the pass pipeline. Deterministic seeding
+ * makes the cached output identical to a fresh run.
+ */
+
+#ifndef MORPHECT_INCREMENTAL_CACHE_HPP
+#define MORPHECT_INCREMENTAL_CACHE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <fstream>
+#include <sstream>
+#include <cstdint>
+
+#include <sys/stat.h>
+
+namespace morphect {
+
+/**
+ * Content-addressed store of transformed function text
+ *
+ * One file per key under the cache directory; keys are 64-bit FNV-1a
+ * hashes over the function body plus a config/seed fingerprint.
+ */
+class IncrementalCache {
+public:
+    IncrementalCache() = default;
+
+    explicit IncrementalCache(const std::string& dir) {
+        open(dir);
+    }
+
+    /**
+     * Use (and create if needed) the given cache directory
+     */
+    bool open(const std::string& dir) {
+        dir_ = dir;
+        valid_ = ensureDir(dir);
+        return valid_;
+    }
+
+    bool valid() const { return valid_; }
+
+    /**
+     * FNV-1a over arbitrary text
+     */
+    static uint64_t hashText(std::string_view text) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : text) {
+            h ^= c;
+            h *= 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    /**
+     * Mix two hashes (function content + config fingerprint)
+     */
+    static uint64_t combine(uint64_t a, uint64_t b) {
+        a ^= b + 0x9e3779b97f4a7c15ULL + (a << 6) + (a >> 2);
+        return a;
+    }
+
+    /**
+     * Hash a function region's lines
+     */
+    static uint64_t hashLines(const std::vector<std::string>& lines) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (const auto& line : lines) {
+            h = combine(h, hashText(line));
+        }
+        return h;
+    }
+
+    /**
+     * Return the cached transformed lines for key, if present
+     */
+    std::optional<std::vector<std::string>> lookup(uint64_t key) {
+        if (!valid_) return std::nullopt;
+
+        std::ifstream in(entryPath(key));
+        if (!in.is_open()) {
+            misses_++;
+            return std::nullopt;
+        }
+
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(in, line)) {
+            lines.push_back(line);
+        }
+
+        hits_++;
+        return lines;
+    }
+
+    /**
+     * Store the transformed lines for key
+     */
+    void store(uint64_t key, const std::vector<std::string>& lines) {
+        if (!valid_) return;
+
+        // Write to a temp name then rename, so concurrent readers never
+        // see a half-written entry
+        std::string final_path = entryPath(key);
+        std::string tmp_path = final_path + ".tmp";
+
+        {
+            std::ofstream out(tmp_path);
+            if (!out.is_open()) return;
+            for (const auto& line : lines) {
+                out << line << '\n';
+            }
+        }
+
+        std::rename(tmp_path.c_str(), final_path.c_str());
+        stores_++;
+    }
+
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+    size_t stores() const { return stores_; }
+
+private:
+    std::string dir_;
+    bool valid_ = false;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t stores_ = 0;
+
+    std::string entryPath(uint64_t key) const {
+        std::ostringstream oss;
+        oss << dir_ << "/" << std::hex << key << ".ll";
+        return oss.str();
+    }
+
+    static bool ensureDir(const std::string& dir) {
+        struct stat st;
+        if (stat(dir.c_str(), &st) == 0) {
+            return S_ISDIR(st.st_mode);
+        }
+        return mkdir(dir.c_str(), 0755) == 0;
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_INCREMENTAL_CACHE_HPP
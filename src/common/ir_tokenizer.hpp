@@ -0,0 +1,251 @@
+/*
+ * ir_tokenizer.hpp
+ *
+ * one-pass tokenizer for textual LLVM IR
+ *
+ * Turns the module into typed per-line records (opcode, result SSA name,
+ * operands) in a single sweep, so passes can match structurally instead
+ * of re-running std::regex over the raw lines. All string_views point
+ * into the caller's lines vector and stay valid only as long as those
+ * lines are not modified.
+ */
+
+#ifndef MORPHECT_IR_TOKENIZER_HPP
+#define MORPHECT_IR_TOKENIZER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+namespace morphect {
+
+/**
+ * What kind of line this is, decided once during tokenization
+ */
+enum class IRLineKind {
+    Empty,          // blank line
+    Comment,        // ; comment
+    FunctionBegin,  // define ... @name(...) ... {
+    FunctionEnd,    // closing }
+    Declare,        // declare @...
+    Label,          // block:
+    Global,         // @name = global ...
+    Metadata,       // !0 = ..., attributes, etc.
+    Instruction,    // anything executable inside a function
+    Other
+};
+
+/**
+ * Typed record for one IR line
+ *
+ * For Instruction lines, opcode/result/operands are filled in.
+ * For FunctionBegin lines, name holds the function name (without '@')
+ * and operands holds the argument SSA names.
+ */
+struct IRInstruction {
+    IRLineKind kind = IRLineKind::Other;
+    size_t line = 0;                         // index into the lines vector
+    std::string_view opcode;                 // "add", "br", "store", ...
+    std::string_view result;                 // "%3" / "%foo", empty if none
+    std::string_view type;                   // first type token after opcode
+    std::string_view name;                   // function name / label name
+    std::vector<std::string_view> operands;  // %ssa, @global and literal operands
+
+    bool isInstruction() const { return kind == IRLineKind::Instruction; }
+    bool hasResult() const { return !result.empty(); }
+};
+
+/**
+ * Single-pass tokenizer for a module's line vector
+ */
+class IRTokenizer {
+public:
+    /**
+     * Tokenize every line of the module in one pass
+     */
+    static std::vector<IRInstruction> tokenizeModule(const std::vector<std::string>& lines) {
+        std::vector<IRInstruction> records;
+        records.reserve(lines.size());
+
+        for (size_t i = 0; i < lines.size(); i++) {
+            records.push_back(tokenizeLine(lines[i], i));
+        }
+
+        return records;
+    }
+
+    /**
+     * Tokenize a single line
+     */
+    static IRInstruction tokenizeLine(std::string_view line, size_t index = 0) {
+        IRInstruction rec;
+        rec.line = index;
+
+        std::string_view t = trim(line);
+
+        if (t.empty()) {
+            rec.kind = IRLineKind::Empty;
+            return rec;
+        }
+
+        if (t[0] == ';') {
+            rec.kind = IRLineKind::Comment;
+            return rec;
+        }
+
+        if (t[0] == '!' || startsWith(t, "attributes ") ||
+            startsWith(t, "source_filename") || startsWith(t, "target ")) {
+            rec.kind = IRLineKind::Metadata;
+            return rec;
+        }
+
+        if (startsWith(t, "define ") || startsWith(t, "define\t")) {
+            rec.kind = IRLineKind::FunctionBegin;
+            parseDefine(t, rec);
+            return rec;
+        }
+
+        if (startsWith(t, "declare ")) {
+            rec.kind = IRLineKind::Declare;
+            size_t at = t.find('@');
+            if (at != std::string_view::npos) {
+                rec.name = identifierAt(t, at + 1);
+            }
+            return rec;
+        }
+
+        if (t == "}") {
+            rec.kind = IRLineKind::FunctionEnd;
+            return rec;
+        }
+
+        // Block label: "entry:" / "42:" (possibly with trailing comment)
+        size_t colon = t.find(':');
+        if (colon != std::string_view::npos && colon > 0 &&
+            isLabelName(t.substr(0, colon)) &&
+            (colon + 1 == t.size() || t[colon + 1] == ' ' || t[colon + 1] == '\t')) {
+            rec.kind = IRLineKind::Label;
+            rec.name = t.substr(0, colon);
+            return rec;
+        }
+
+        // Global definition: "@str = private constant ..."
+        if (t[0] == '@') {
+            rec.kind = IRLineKind::Global;
+            rec.name = identifierAt(t, 1);
+            collectOperands(t, rec.operands);
+            return rec;
+        }
+
+        // Instruction with result: "%x = opcode type operands"
+        if (t[0] == '%') {
+            size_t eq = t.find('=');
+            if (eq != std::string_view::npos) {
+                rec.kind = IRLineKind::Instruction;
+                rec.result = trim(t.substr(0, eq));
+                std::string_view rhs = trim(t.substr(eq + 1));
+                rec.opcode = firstWord(rhs);
+                std::string_view rest = trim(rhs.substr(rec.opcode.size()));
+                rec.type = firstWord(rest);
+                collectOperands(rest, rec.operands);
+                return rec;
+            }
+        }
+
+        // Instruction without result: "ret i32 %3", "br label %bb", "store ..."
+        std::string_view word = firstWord(t);
+        if (!word.empty()) {
+            rec.kind = IRLineKind::Instruction;
+            rec.opcode = word;
+            std::string_view rest = trim(t.substr(word.size()));
+            rec.type = firstWord(rest);
+            collectOperands(rest, rec.operands);
+            return rec;
+        }
+
+        rec.kind = IRLineKind::Other;
+        return rec;
+    }
+
+private:
+    static bool startsWith(std::string_view s, std::string_view prefix) {
+        return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    static std::string_view trim(std::string_view s) {
+        size_t start = s.find_first_not_of(" \t");
+        if (start == std::string_view::npos) return {};
+        size_t end = s.find_last_not_of(" \t\r");
+        return s.substr(start, end - start + 1);
+    }
+
+    static std::string_view firstWord(std::string_view s) {
+        size_t end = s.find_first_of(" \t");
+        return end == std::string_view::npos ? s : s.substr(0, end);
+    }
+
+    static bool isIdentChar(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '$';
+    }
+
+    static bool isLabelName(std::string_view s) {
+        if (s.empty()) return false;
+        for (char c : s) {
+            if (!isIdentChar(c)) return false;
+        }
+        return true;
+    }
+
+    static std::string_view identifierAt(std::string_view s, size_t pos) {
+        size_t end = pos;
+        while (end < s.size() && isIdentChar(s[end])) end++;
+        return s.substr(pos, end - pos);
+    }
+
+    /**
+     * Parse "define <attrs> @name(args) ... {" into name + argument operands
+     */
+    static void parseDefine(std::string_view t, IRInstruction& rec) {
+        size_t at = t.find('@');
+        if (at == std::string_view::npos) return;
+
+        rec.name = identifierAt(t, at + 1);
+
+        size_t open = t.find('(', at);
+        size_t close = (open == std::string_view::npos)
+            ? std::string_view::npos : t.find(')', open);
+        if (open != std::string_view::npos && close != std::string_view::npos) {
+            collectOperands(t.substr(open + 1, close - open - 1), rec.operands);
+        }
+    }
+
+    /**
+     * Collect %ssa and @global references from a line fragment
+     */
+    static void collectOperands(std::string_view s, std::vector<std::string_view>& out) {
+        for (size_t i = 0; i < s.size(); i++) {
+            if (s[i] == '%' || s[i] == '@') {
+                size_t start = i;
+                i++;
+                while (i < s.size() && isIdentChar(s[i])) i++;
+                if (i > start + 1) {
+                    out.push_back(s.substr(start, i - start));
+                }
+                i--;
+            } else if (s[i] == '"') {
+                // skip string literals so quoted text isn't mistaken for operands
+                i++;
+                while (i < s.size() && s[i] != '"') {
+                    if (s[i] == '\\') i++;
+                    i++;
+                }
+            }
+        }
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_IR_TOKENIZER_HPP
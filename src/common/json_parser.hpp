@@ -8,14 +8,20 @@
  *   - Extract strings, numbers, arrays, objects
  *   - No external library dependencies
  *   - Header-only implementation
+ *   - Compact variant storage: a value holds only its active
+ *     alternative instead of every possible one
  */
 
 #ifndef MORPHECT_JSON_PARSER_HPP
 #define MORPHECT_JSON_PARSER_HPP
 
+#include "mapped_file.hpp"
+
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
+#include <variant>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
@@ -36,84 +42,114 @@ enum class JsonType {
     Object
 };
 
-/**
- * Forward declaration
- */
-class JsonValue;
-
 /**
  * JSON Value class - represents any JSON value
+ *
+ * Storage is a tagged union (std::variant) whose alternative order
+ * mirrors JsonType, so a value pays for the string/array/object members
+ * only when it actually is one. Construction is move-based throughout:
+ * parsing a large config moves strings and containers into place
+ * instead of copying them element by element.
  */
 class JsonValue {
 public:
-    JsonType type = JsonType::Null;
-
-    // Value storage
-    bool bool_value = false;
-    double number_value = 0.0;
-    std::string string_value;
-    std::vector<JsonValue> array_value;
-    std::unordered_map<std::string, JsonValue> object_value;
+    using Array = std::vector<JsonValue>;
+    using Object = std::unordered_map<std::string, JsonValue>;
 
     // Constructors
-    JsonValue() : type(JsonType::Null) {}
-    JsonValue(bool v) : type(JsonType::Bool), bool_value(v) {}
-    JsonValue(int v) : type(JsonType::Number), number_value(v) {}
-    JsonValue(double v) : type(JsonType::Number), number_value(v) {}
-    JsonValue(const std::string& v) : type(JsonType::String), string_value(v) {}
-    JsonValue(const char* v) : type(JsonType::String), string_value(v) {}
+    JsonValue() = default;
+    JsonValue(bool v) : value_(v) {}
+    JsonValue(int v) : value_(static_cast<double>(v)) {}
+    JsonValue(double v) : value_(v) {}
+    JsonValue(const std::string& v) : value_(v) {}
+    JsonValue(std::string&& v) : value_(std::move(v)) {}
+    JsonValue(const char* v) : value_(std::string(v)) {}
+    JsonValue(Array&& v) : value_(std::move(v)) {}
+    JsonValue(Object&& v) : value_(std::move(v)) {}
+
+    static JsonValue makeArray() { return JsonValue(Array{}); }
+    static JsonValue makeObject() { return JsonValue(Object{}); }
+
+    /**
+     * Active type (variant index mirrors the JsonType enumerators)
+     */
+    JsonType type() const {
+        return static_cast<JsonType>(value_.index());
+    }
 
     // Type checks
-    bool isNull() const { return type == JsonType::Null; }
-    bool isBool() const { return type == JsonType::Bool; }
-    bool isNumber() const { return type == JsonType::Number; }
-    bool isString() const { return type == JsonType::String; }
-    bool isArray() const { return type == JsonType::Array; }
-    bool isObject() const { return type == JsonType::Object; }
+    bool isNull() const { return std::holds_alternative<std::monostate>(value_); }
+    bool isBool() const { return std::holds_alternative<bool>(value_); }
+    bool isNumber() const { return std::holds_alternative<double>(value_); }
+    bool isString() const { return std::holds_alternative<std::string>(value_); }
+    bool isArray() const { return std::holds_alternative<Array>(value_); }
+    bool isObject() const { return std::holds_alternative<Object>(value_); }
 
     // Accessors with defaults
     bool asBool(bool def = false) const {
-        return isBool() ? bool_value : def;
+        const bool* v = std::get_if<bool>(&value_);
+        return v ? *v : def;
     }
 
     double asDouble(double def = 0.0) const {
-        return isNumber() ? number_value : def;
+        const double* v = std::get_if<double>(&value_);
+        return v ? *v : def;
     }
 
     int asInt(int def = 0) const {
-        return isNumber() ? static_cast<int>(number_value) : def;
+        const double* v = std::get_if<double>(&value_);
+        return v ? static_cast<int>(*v) : def;
     }
 
     const std::string& asString(const std::string& def = "") const {
         static std::string empty;
-        return isString() ? string_value : (def.empty() ? empty : def);
+        const std::string* v = std::get_if<std::string>(&value_);
+        return v ? *v : (def.empty() ? empty : def);
+    }
+
+    /**
+     * Underlying containers (empty sentinels when the type differs)
+     */
+    const Array& asArray() const {
+        static Array empty;
+        const Array* v = std::get_if<Array>(&value_);
+        return v ? *v : empty;
+    }
+
+    const Object& asObject() const {
+        static Object empty;
+        const Object* v = std::get_if<Object>(&value_);
+        return v ? *v : empty;
     }
 
     // Array access
     size_t size() const {
-        if (isArray()) return array_value.size();
-        if (isObject()) return object_value.size();
+        if (const Array* a = std::get_if<Array>(&value_)) return a->size();
+        if (const Object* o = std::get_if<Object>(&value_)) return o->size();
         return 0;
     }
 
     const JsonValue& operator[](size_t index) const {
         static JsonValue null_value;
-        if (!isArray() || index >= array_value.size()) {
+        const Array* a = std::get_if<Array>(&value_);
+        if (!a || index >= a->size()) {
             return null_value;
         }
-        return array_value[index];
+        return (*a)[index];
     }
 
     // Object access
     const JsonValue& operator[](const std::string& key) const {
         static JsonValue null_value;
-        if (!isObject()) return null_value;
-        auto it = object_value.find(key);
-        return it != object_value.end() ? it->second : null_value;
+        const Object* o = std::get_if<Object>(&value_);
+        if (!o) return null_value;
+        auto it = o->find(key);
+        return it != o->end() ? it->second : null_value;
     }
 
     bool has(const std::string& key) const {
-        return isObject() && object_value.find(key) != object_value.end();
+        const Object* o = std::get_if<Object>(&value_);
+        return o && o->find(key) != o->end();
     }
 
     // Get nested value with dot notation (e.g., "obfuscation.mba.enabled")
@@ -137,11 +173,9 @@ public:
     // Convenience methods for common patterns
     std::vector<std::string> asStringArray() const {
         std::vector<std::string> result;
-        if (isArray()) {
-            for (const auto& item : array_value) {
-                if (item.isString()) {
-                    result.push_back(item.string_value);
-                }
+        for (const auto& item : asArray()) {
+            if (item.isString()) {
+                result.push_back(item.asString());
             }
         }
         return result;
@@ -149,15 +183,18 @@ public:
 
     std::vector<double> asDoubleArray() const {
         std::vector<double> result;
-        if (isArray()) {
-            for (const auto& item : array_value) {
-                if (item.isNumber()) {
-                    result.push_back(item.number_value);
-                }
+        for (const auto& item : asArray()) {
+            if (item.isNumber()) {
+                result.push_back(item.asDouble());
             }
         }
         return result;
     }
+
+private:
+    // Alternative order must match JsonType: Null, Bool, Number, String,
+    // Array, Object
+    std::variant<std::monostate, bool, double, std::string, Array, Object> value_;
 };
 
 /**
@@ -166,13 +203,18 @@ public:
 class JsonParser {
 public:
     /**
-     * Parse JSON string
+     * Parse JSON text in situ
+     *
+     * The parser never copies the input: it walks the caller's buffer
+     * through string_views and only materializes owned strings for the
+     * values that end up in the tree. The buffer only needs to outlive
+     * the parse call itself.
      *
      * @param json JSON text
      * @return Parsed JsonValue
      * @throws std::runtime_error on parse error
      */
-    static JsonValue parse(const std::string& json) {
+    static JsonValue parse(std::string_view json) {
         JsonParser parser(json);
         return parser.parseValue();
     }
@@ -180,11 +222,20 @@ public:
     /**
      * Parse JSON file
      *
+     * The file is mmapped and parsed in place — no intermediate
+     * whole-file string — with a stream-read fallback when mapping
+     * fails (pipes, /proc files).
+     *
      * @param path File path
      * @return Parsed JsonValue
      * @throws std::runtime_error on file or parse error
      */
     static JsonValue parseFile(const std::string& path) {
+        MappedFile mapped(path);
+        if (mapped.valid()) {
+            return parse(mapped.view());
+        }
+
         std::ifstream file(path);
         if (!file.is_open()) {
             throw std::runtime_error("Cannot open file: " + path);
@@ -202,17 +253,15 @@ public:
         try {
             return parseFile(path);
         } catch (...) {
-            JsonValue empty;
-            empty.type = JsonType::Object;
-            return empty;
+            return JsonValue::makeObject();
         }
     }
 
 private:
-    std::string json_;
+    std::string_view json_;
     size_t pos_ = 0;
 
-    explicit JsonParser(const std::string& json) : json_(json) {}
+    explicit JsonParser(std::string_view json) : json_(json) {}
 
     char peek() const {
         return pos_ < json_.size() ? json_[pos_] : '\0';
@@ -240,7 +289,7 @@ private:
         skipWhitespace();
         char c = peek();
 
-        if (c == '"') return parseString();
+        if (c == '"') return JsonValue(parseStringRaw());
         if (c == '{') return parseObject();
         if (c == '[') return parseArray();
         if (c == 't' || c == 'f') return parseBool();
@@ -250,18 +299,32 @@ private:
         throw std::runtime_error("Unexpected character at position " + std::to_string(pos_));
     }
 
-    JsonValue parseString() {
+    /**
+     * Parse a string literal into a plain std::string (moved into the
+     * value or used directly as an object key)
+     */
+    std::string parseStringRaw() {
         expect('"');
+
+        // Fast path: a literal with no escapes materializes as one
+        // allocation straight from the buffer slice
+        size_t close = json_.find('"', pos_);
+        if (close != std::string_view::npos) {
+            size_t escape = json_.find('\\', pos_);
+            if (escape == std::string_view::npos || escape > close) {
+                std::string result(json_.substr(pos_, close - pos_));
+                pos_ = close + 1;
+                return result;
+            }
+        }
+
         std::string result;
 
         while (pos_ < json_.size()) {
             char c = get();
 
             if (c == '"') {
-                JsonValue v;
-                v.type = JsonType::String;
-                v.string_value = result;
-                return v;
+                return result;
             }
 
             if (c == '\\') {
@@ -304,11 +367,8 @@ private:
             while (pos_ < json_.size() && std::isxdigit(json_[pos_])) {
                 pos_++;
             }
-            std::string hex_str = json_.substr(start, pos_ - start);
-            JsonValue v;
-            v.type = JsonType::Number;
-            v.number_value = static_cast<double>(std::stoll(hex_str, nullptr, 0));
-            return v;
+            std::string hex_str = std::string(json_.substr(start, pos_ - start));
+            return JsonValue(static_cast<double>(std::stoll(hex_str, nullptr, 0)));
         }
 
         while (pos_ < json_.size() && std::isdigit(json_[pos_])) pos_++;
@@ -324,34 +384,27 @@ private:
             while (pos_ < json_.size() && std::isdigit(json_[pos_])) pos_++;
         }
 
-        std::string num_str = json_.substr(start, pos_ - start);
-        JsonValue v;
-        v.type = JsonType::Number;
-        v.number_value = std::stod(num_str);
-        return v;
+        std::string num_str = std::string(json_.substr(start, pos_ - start));
+        return JsonValue(std::stod(num_str));
     }
 
     JsonValue parseBool() {
         skipWhitespace();
-        JsonValue v;
-        v.type = JsonType::Bool;
 
-        if (json_.substr(pos_, 4) == "true") {
+        if (json_.compare(pos_, 4, "true") == 0) {
             pos_ += 4;
-            v.bool_value = true;
-        } else if (json_.substr(pos_, 5) == "false") {
+            return JsonValue(true);
+        }
+        if (json_.compare(pos_, 5, "false") == 0) {
             pos_ += 5;
-            v.bool_value = false;
-        } else {
-            throw std::runtime_error("Invalid boolean at position " + std::to_string(pos_));
+            return JsonValue(false);
         }
-
-        return v;
+        throw std::runtime_error("Invalid boolean at position " + std::to_string(pos_));
     }
 
     JsonValue parseNull() {
         skipWhitespace();
-        if (json_.substr(pos_, 4) == "null") {
+        if (json_.compare(pos_, 4, "null") == 0) {
             pos_ += 4;
             return JsonValue();
         }
@@ -360,22 +413,21 @@ private:
 
     JsonValue parseArray() {
         expect('[');
-        JsonValue v;
-        v.type = JsonType::Array;
+        JsonValue::Array items;
 
         skipWhitespace();
         if (peek() == ']') {
             get();
-            return v;
+            return JsonValue(std::move(items));
         }
 
         while (true) {
-            v.array_value.push_back(parseValue());
+            items.push_back(parseValue());
             skipWhitespace();
 
             if (peek() == ']') {
                 get();
-                return v;
+                return JsonValue(std::move(items));
             }
 
             expect(',');
@@ -384,34 +436,30 @@ private:
 
     JsonValue parseObject() {
         expect('{');
-        JsonValue v;
-        v.type = JsonType::Object;
+        JsonValue::Object members;
 
         skipWhitespace();
         if (peek() == '}') {
             get();
-            return v;
+            return JsonValue(std::move(members));
         }
 
         while (true) {
             skipWhitespace();
 
             // Parse key
-            JsonValue key = parseString();
-            if (!key.isString()) {
-                throw std::runtime_error("Object key must be a string");
-            }
+            std::string key = parseStringRaw();
 
             expect(':');
 
             // Parse value
-            v.object_value[key.string_value] = parseValue();
+            members[std::move(key)] = parseValue();
 
             skipWhitespace();
 
             if (peek() == '}') {
                 get();
-                return v;
+                return JsonValue(std::move(members));
             }
 
             expect(',');
@@ -433,21 +481,21 @@ public:
 private:
     static void serializeValue(std::ostringstream& oss, const JsonValue& v,
                                bool pretty, int indent) {
-        switch (v.type) {
+        switch (v.type()) {
             case JsonType::Null:
                 oss << "null";
                 break;
 
             case JsonType::Bool:
-                oss << (v.bool_value ? "true" : "false");
+                oss << (v.asBool() ? "true" : "false");
                 break;
 
             case JsonType::Number:
-                oss << v.number_value;
+                oss << v.asDouble();
                 break;
 
             case JsonType::String:
-                oss << '"' << escapeString(v.string_value) << '"';
+                oss << '"' << escapeString(v.asString()) << '"';
                 break;
 
             case JsonType::Array:
@@ -482,14 +530,14 @@ private:
         oss << '[';
 
         bool first = true;
-        for (const auto& item : v.array_value) {
+        for (const auto& item : v.asArray()) {
             if (!first) oss << ',';
             if (pretty) oss << '\n' << std::string(indent + 2, ' ');
             serializeValue(oss, item, pretty, indent + 2);
             first = false;
         }
 
-        if (pretty && !v.array_value.empty()) {
+        if (pretty && !v.asArray().empty()) {
             oss << '\n' << std::string(indent, ' ');
         }
         oss << ']';
@@ -500,7 +548,7 @@ private:
         oss << '{';
 
         bool first = true;
-        for (const auto& [key, value] : v.object_value) {
+        for (const auto& [key, value] : v.asObject()) {
             if (!first) oss << ',';
             if (pretty) oss << '\n' << std::string(indent + 2, ' ');
             oss << '"' << escapeString(key) << '"';
@@ -510,7 +558,7 @@ private:
             first = false;
         }
 
-        if (pretty && !v.object_value.empty()) {
+        if (pretty && !v.asObject().empty()) {
             oss << '\n' << std::string(indent, ' ');
         }
         oss << '}';
@@ -0,0 +1,519 @@
+/**
+ * Morphect - Multi-Language Code Obfuscator
+ *
+ * line_matcher.hpp - Shared non-backtracking line pattern matching
+ *
+ * std::regex was the top profile entry across the IR passes and both
+ * text backends: every matcher paid for a backtracking engine to
+ * recognize lines that are really just fixed token sequences. The MBA
+ * pass replaced its patterns with a hand-rolled scanner first (see
+ * matchArithInstruction in mba_base.hpp); this module generalizes that
+ * into a shared engine so the remaining callers stop hand-rolling or
+ * regexing independently.
+ *
+ * A LinePattern is declared once with the builder methods and compiled
+ * into a flat program of deterministic token ops — each op consumes a
+ * maximal run and never backtracks, so matching is a single forward
+ * scan per candidate position, with captures sliced out as string_views
+ * into the subject line. The patterns every pass shares live in the
+ * line_patterns registry below, next to a few token-level helpers
+ * (register-mention scans) that don't fit the sequential shape.
+ */
+
+#ifndef MORPHECT_LINE_MATCHER_HPP
+#define MORPHECT_LINE_MATCHER_HPP
+
+#include <cctype>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace morphect {
+
+/**
+ * Capture groups of a successful match, in declaration order. Views
+ * point into the subject line and are only valid while it lives.
+ */
+struct LineMatch {
+    static constexpr int kMaxCaptures = 6;
+
+    std::string_view group[kMaxCaptures];
+    int count = 0;
+
+    std::string str(int i) const { return std::string(group[i]); }
+};
+
+class LinePattern {
+public:
+    LinePattern() = default;
+
+    /** Match literals case-insensitively (assembly dialects) */
+    LinePattern& icase() {
+        icase_ = true;
+        return *this;
+    }
+
+    /** Literal text */
+    LinePattern& lit(std::string_view text) {
+        return add(Op::Lit, text);
+    }
+
+    /** One or more whitespace characters */
+    LinePattern& ws() {
+        return add(Op::Ws);
+    }
+
+    /** Zero or more whitespace characters */
+    LinePattern& optWs() {
+        return add(Op::OptWs);
+    }
+
+    /** Comma with optional whitespace around it */
+    LinePattern& comma() {
+        return optWs().lit(",").optWs();
+    }
+
+    /** Capture a word: [A-Za-z0-9_]+ */
+    LinePattern& capWord() {
+        return add(Op::CapWord);
+    }
+
+    /** Capture an IR register: '%' then [A-Za-z0-9_.]+ (includes '%') */
+    LinePattern& capReg() {
+        return add(Op::CapReg);
+    }
+
+    /** Capture a name token: [A-Za-z0-9_.]+ (labels, register names) */
+    LinePattern& capName() {
+        return add(Op::CapName);
+    }
+
+    /** Capture a decimal integer with optional leading '-' */
+    LinePattern& capDecInt() {
+        return add(Op::CapDecInt);
+    }
+
+    /** Capture an unsigned decimal integer */
+    LinePattern& capUInt() {
+        return add(Op::CapUInt);
+    }
+
+    /** Capture an immediate: 0x hex or decimal with optional '-' */
+    LinePattern& capImm() {
+        return add(Op::CapImm);
+    }
+
+    /** Capture up to (not including) `stop`, trailing whitespace trimmed */
+    LinePattern& capUntil(char stop) {
+        return add(Op::CapUntil, {}, stop);
+    }
+
+    /** Capture up to the LAST occurrence of `stop` (greedy, for quoted text) */
+    LinePattern& capUntilLast(char stop) {
+        return add(Op::CapUntilLast, {}, stop);
+    }
+
+    /** Capture the rest of the line (may be empty) */
+    LinePattern& capRest() {
+        return add(Op::CapRest);
+    }
+
+    /**
+     * Anchored match: the whole line must be consumed (regex_match
+     * semantics)
+     */
+    bool match(std::string_view line, LineMatch& m) const {
+        size_t end = 0;
+        m.count = 0;
+        return run(line, 0, m, end) && end == line.size();
+    }
+
+    /**
+     * Find the leftmost position where the pattern runs to completion
+     * (regex_search semantics); the rest of the line may follow
+     */
+    bool search(std::string_view line, LineMatch& m) const {
+        size_t end = 0;
+        return searchFrom(line, 0, m, end) != npos;
+    }
+
+    /**
+     * Search starting at `from`; returns the match start position and
+     * sets `end` past the match, or npos. Loop on this to iterate
+     * repeated occurrences (phi incoming values, ...).
+     */
+    size_t searchFrom(std::string_view line, size_t from, LineMatch& m,
+                      size_t& end) const {
+        for (size_t start = from; start <= line.size(); start++) {
+            // Jump to the next possible first byte when the pattern
+            // opens with a literal
+            if (!ops_.empty() && ops_[0].kind == Op::Lit) {
+                start = findFirstByte(line, start, ops_[0].text[0]);
+                if (start == npos) return npos;
+            }
+            m.count = 0;
+            if (run(line, start, m, end)) {
+                return start;
+            }
+        }
+        return npos;
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    struct Op {
+        enum Kind {
+            Lit, Ws, OptWs, CapWord, CapReg, CapName, CapDecInt, CapUInt,
+            CapImm, CapUntil, CapUntilLast, CapRest
+        };
+        Kind kind;
+        std::string text;
+        char stop = 0;
+    };
+
+    std::vector<Op> ops_;
+    bool icase_ = false;
+
+    LinePattern& add(Op::Kind kind, std::string_view text = {},
+                     char stop = 0) {
+        ops_.push_back(Op{kind, std::string(text), stop});
+        return *this;
+    }
+
+    static char lower(char c) {
+        return static_cast<char>(
+            std::tolower(static_cast<unsigned char>(c)));
+    }
+    static bool isWordChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+    static bool isNameChar(char c) { return isWordChar(c) || c == '.'; }
+    static bool isSpace(char c) {
+        return std::isspace(static_cast<unsigned char>(c));
+    }
+
+    size_t findFirstByte(std::string_view line, size_t from, char c) const {
+        for (size_t i = from; i < line.size(); i++) {
+            if (line[i] == c || (icase_ && lower(line[i]) == lower(c))) {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    bool literalAt(std::string_view line, size_t pos,
+                   const std::string& text) const {
+        if (pos + text.size() > line.size()) return false;
+        for (size_t i = 0; i < text.size(); i++) {
+            char a = line[pos + i];
+            char b = text[i];
+            if (a != b && (!icase_ || lower(a) != lower(b))) return false;
+        }
+        return true;
+    }
+
+    bool capture(LineMatch& m, std::string_view line, size_t start,
+                 size_t end) const {
+        if (m.count >= LineMatch::kMaxCaptures) return false;
+        m.group[m.count++] = line.substr(start, end - start);
+        return true;
+    }
+
+    bool run(std::string_view line, size_t pos, LineMatch& m,
+             size_t& end) const {
+        const size_t n = line.size();
+
+        for (const Op& op : ops_) {
+            switch (op.kind) {
+            case Op::Lit:
+                if (!literalAt(line, pos, op.text)) return false;
+                pos += op.text.size();
+                break;
+
+            case Op::Ws: {
+                size_t start = pos;
+                while (pos < n && isSpace(line[pos])) pos++;
+                if (pos == start) return false;
+                break;
+            }
+
+            case Op::OptWs:
+                while (pos < n && isSpace(line[pos])) pos++;
+                break;
+
+            case Op::CapWord:
+            case Op::CapName: {
+                size_t start = pos;
+                bool dotted = (op.kind == Op::CapName);
+                while (pos < n && (dotted ? isNameChar(line[pos])
+                                          : isWordChar(line[pos]))) {
+                    pos++;
+                }
+                if (pos == start || !capture(m, line, start, pos)) {
+                    return false;
+                }
+                break;
+            }
+
+            case Op::CapReg: {
+                size_t start = pos;
+                if (pos >= n || line[pos] != '%') return false;
+                pos++;
+                while (pos < n && isNameChar(line[pos])) pos++;
+                if (pos == start + 1 || !capture(m, line, start, pos)) {
+                    return false;
+                }
+                break;
+            }
+
+            case Op::CapDecInt:
+            case Op::CapUInt: {
+                size_t start = pos;
+                if (op.kind == Op::CapDecInt && pos < n && line[pos] == '-') {
+                    pos++;
+                }
+                size_t digits = pos;
+                while (pos < n &&
+                       std::isdigit(static_cast<unsigned char>(line[pos]))) {
+                    pos++;
+                }
+                if (pos == digits || !capture(m, line, start, pos)) {
+                    return false;
+                }
+                break;
+            }
+
+            case Op::CapImm: {
+                size_t start = pos;
+                if (pos + 1 < n && line[pos] == '0' &&
+                    (line[pos + 1] == 'x' || line[pos + 1] == 'X')) {
+                    pos += 2;
+                    size_t digits = pos;
+                    while (pos < n &&
+                           std::isxdigit(
+                               static_cast<unsigned char>(line[pos]))) {
+                        pos++;
+                    }
+                    if (pos == digits) return false;
+                } else {
+                    if (pos < n && line[pos] == '-') pos++;
+                    size_t digits = pos;
+                    while (pos < n &&
+                           std::isdigit(
+                               static_cast<unsigned char>(line[pos]))) {
+                        pos++;
+                    }
+                    if (pos == digits) return false;
+                }
+                if (!capture(m, line, start, pos)) return false;
+                break;
+            }
+
+            case Op::CapUntil: {
+                size_t start = pos;
+                while (pos < n && line[pos] != op.stop) pos++;
+                size_t trimmed = pos;
+                while (trimmed > start && isSpace(line[trimmed - 1])) {
+                    trimmed--;
+                }
+                if (trimmed == start || !capture(m, line, start, trimmed)) {
+                    return false;
+                }
+                break;
+            }
+
+            case Op::CapUntilLast: {
+                size_t last = line.rfind(op.stop);
+                if (last == std::string_view::npos || last < pos) {
+                    return false;
+                }
+                if (!capture(m, line, pos, last)) return false;
+                pos = last;
+                break;
+            }
+
+            case Op::CapRest:
+                if (!capture(m, line, pos, n)) return false;
+                pos = n;
+                break;
+            }
+        }
+
+        end = pos;
+        return true;
+    }
+};
+
+/**
+ * The patterns shared across passes and backends, declared once.
+ * Accessors hand out process-wide compiled instances; the factories at
+ * the bottom build opcode-parameterized patterns for callers that keep
+ * their own function-local statics.
+ */
+namespace line_patterns {
+
+// ---- LLVM IR (case-sensitive) ----
+
+/** "ret <type>" — group 0: type ("void" included) */
+inline const LinePattern& irRetType() {
+    static const LinePattern p = LinePattern().lit("ret").ws().capWord();
+    return p;
+}
+
+/** "ret <type> <value>" — groups: type, value */
+inline const LinePattern& irRetValue() {
+    static const LinePattern p =
+        LinePattern().lit("ret").ws().capWord().ws().capRest();
+    return p;
+}
+
+/** "%dest = phi <type> <args>" — groups: dest, type, args */
+inline const LinePattern& irPhi() {
+    static const LinePattern p = LinePattern()
+                                     .capReg()
+                                     .optWs()
+                                     .lit("=")
+                                     .optWs()
+                                     .lit("phi")
+                                     .ws()
+                                     .capWord()
+                                     .ws()
+                                     .capRest();
+    return p;
+}
+
+/** "[ <value>, %<label> ]" — groups: value, label (no '%'). Iterate
+ *  with searchFrom over the phi argument list. */
+inline const LinePattern& irPhiArg() {
+    static const LinePattern p = LinePattern()
+                                     .lit("[")
+                                     .optWs()
+                                     .capUntil(',')
+                                     .lit(",")
+                                     .optWs()
+                                     .lit("%")
+                                     .capName()
+                                     .optWs()
+                                     .lit("]");
+    return p;
+}
+
+// ---- x86 assembly (case-insensitive) ----
+
+/** "<op> reg, reg" (either operand may be a word-shaped token; callers
+ *  validate with isRegister) — groups: dst, src */
+inline LinePattern asmBinaryRegReg(std::string_view opcode) {
+    return LinePattern().icase().lit(opcode).ws().capWord().comma().capWord();
+}
+
+/** "<op> reg" — group: reg */
+inline LinePattern asmUnaryReg(std::string_view opcode) {
+    return LinePattern().icase().lit(opcode).ws().capWord();
+}
+
+/** "<op> reg, imm" with a 0x or decimal immediate — groups: reg, imm */
+inline LinePattern asmRegImm(std::string_view opcode) {
+    return LinePattern().icase().lit(opcode).ws().capWord().comma().capImm();
+}
+
+/** "<op> reg, imm" with a decimal immediate only — groups: reg, imm */
+inline LinePattern asmRegDecImm(std::string_view opcode) {
+    return LinePattern()
+        .icase()
+        .lit(opcode)
+        .ws()
+        .capWord()
+        .comma()
+        .capDecInt();
+}
+
+/** "<op> reg, imm" with an unsigned decimal immediate — groups: reg,
+ *  imm */
+inline LinePattern asmRegUImm(std::string_view opcode) {
+    return LinePattern()
+        .icase()
+        .lit(opcode)
+        .ws()
+        .capWord()
+        .comma()
+        .capUInt();
+}
+
+/**
+ * '.string "..."' or '.ascii "..."' — sets `content` to the quoted
+ * text (up to the closing quote, escapes left as written)
+ */
+inline bool matchAsciiString(std::string_view line, std::string& content) {
+    static const LinePattern string_p = LinePattern()
+                                            .optWs()
+                                            .lit(".string")
+                                            .ws()
+                                            .lit("\"")
+                                            .capUntilLast('"')
+                                            .lit("\"");
+    static const LinePattern ascii_p = LinePattern()
+                                           .optWs()
+                                           .lit(".ascii")
+                                           .ws()
+                                           .lit("\"")
+                                           .capUntilLast('"')
+                                           .lit("\"");
+    LineMatch m;
+    if (string_p.search(line, m) || ascii_p.search(line, m)) {
+        content = m.str(0);
+        return true;
+    }
+    return false;
+}
+
+// ---- Register-mention scans (token classification, not sequential
+//      patterns) ----
+
+/** Word-by-word scan comparing lowercased tokens against a name set */
+inline bool mentionsRegisterOf(std::string_view text, const char* const* regs,
+                               int count) {
+    size_t i = 0;
+    const size_t n = text.size();
+    while (i < n) {
+        if (!std::isalnum(static_cast<unsigned char>(text[i])) &&
+            text[i] != '_') {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while (i < n && (std::isalnum(static_cast<unsigned char>(text[i])) ||
+                         text[i] == '_')) {
+            i++;
+        }
+        std::string word(text.substr(start, i - start));
+        for (char& c : word) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        for (int r = 0; r < count; r++) {
+            if (word == regs[r]) return true;
+        }
+    }
+    return false;
+}
+
+/** True if `text` mentions a 64-bit GP register as a whole word */
+inline bool mentionsX64Register(std::string_view text) {
+    static const char* kRegs[] = {"rax", "rbx", "rcx", "rdx", "rsi", "rdi",
+                                  "rbp", "rsp", "r8",  "r9",  "r10", "r11",
+                                  "r12", "r13", "r14", "r15"};
+    return mentionsRegisterOf(text, kRegs, 16);
+}
+
+/** True if `text` mentions a 32-bit GP register as a whole word */
+inline bool mentionsX32Register(std::string_view text) {
+    static const char* kRegs[] = {"eax", "ebx", "ecx", "edx",
+                                  "esi", "edi", "ebp", "esp"};
+    return mentionsRegisterOf(text, kRegs, 8);
+}
+
+} // namespace line_patterns
+
+} // namespace morphect
+
+#endif // MORPHECT_LINE_MATCHER_HPP
@@ -0,0 +1,189 @@
+/*
+ * line_rope.hpp
+ *
+ * chunked rope over a line sequence
+ *
+ * The insert-heavy passes (CFF dispatcher splicing, bogus CF, dead code)
+ * rebuild the whole lines vector around every transformed function, which
+ * is O(n^2) when a pass fires thousands of times. LineRope keeps the
+ * module as a list of line chunks so region replacement and block
+ * insertion are chunk splices instead of full-vector copies.
+ */
+
+#ifndef MORPHECT_LINE_ROPE_HPP
+#define MORPHECT_LINE_ROPE_HPP
+
+#include <string>
+#include <vector>
+#include <list>
+#include <utility>
+#include <cstddef>
+
+namespace morphect {
+
+/**
+ * Rope of line chunks
+ *
+ * Append-by-move is O(1); inserting or replacing a range splits at most
+ * two chunks and splices, independent of total module size.
+ */
+class LineRope {
+public:
+    LineRope() = default;
+
+    /**
+     * Take ownership of an existing lines vector as a single chunk
+     */
+    explicit LineRope(std::vector<std::string> lines) {
+        appendChunk(std::move(lines));
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /**
+     * Append one line to the tail chunk
+     */
+    void append(std::string line) {
+        if (chunks_.empty() || chunks_.back().size() >= kMaxChunkLines) {
+            chunks_.emplace_back();
+            chunks_.back().reserve(kMaxChunkLines / 4);
+        }
+        chunks_.back().push_back(std::move(line));
+        size_++;
+    }
+
+    /**
+     * Append a whole chunk, O(1)
+     */
+    void appendChunk(std::vector<std::string> chunk) {
+        if (chunk.empty()) return;
+        size_ += chunk.size();
+        chunks_.push_back(std::move(chunk));
+    }
+
+    /**
+     * Move lines [from, to) out of a source vector into the rope
+     */
+    void appendMoved(std::vector<std::string>& source, size_t from, size_t to) {
+        if (from >= to) return;
+        std::vector<std::string> chunk;
+        chunk.reserve(to - from);
+        for (size_t i = from; i < to; i++) {
+            chunk.push_back(std::move(source[i]));
+        }
+        appendChunk(std::move(chunk));
+    }
+
+    /**
+     * Insert a chunk so its first line lands at line index pos
+     */
+    void insert(size_t pos, std::vector<std::string> chunk) {
+        if (chunk.empty()) return;
+        size_ += chunk.size();
+
+        auto [it, offset] = locate(pos);
+        if (offset > 0) {
+            it = splitChunk(it, offset);
+        }
+        chunks_.insert(it, std::move(chunk));
+    }
+
+    /**
+     * Replace lines [from, to) with a replacement chunk
+     */
+    void replaceRange(size_t from, size_t to, std::vector<std::string> chunk) {
+        eraseRange(from, to);
+        insert(from, std::move(chunk));
+    }
+
+    /**
+     * Erase lines [from, to)
+     */
+    void eraseRange(size_t from, size_t to) {
+        if (from >= to || from >= size_) return;
+        if (to > size_) to = size_;
+
+        auto [first, first_off] = locate(from);
+        if (first_off > 0) {
+            first = splitChunk(first, first_off);
+        }
+
+        auto [last, last_off] = locate(to);
+        if (last != chunks_.end() && last_off > 0) {
+            last = splitChunk(last, last_off);
+        }
+
+        chunks_.erase(first, last);
+        size_ -= (to - from);
+    }
+
+    /**
+     * Line at index i (O(chunks) scan; meant for tests and spot checks,
+     * transformation loops should use flatten())
+     */
+    const std::string& at(size_t i) const {
+        for (const auto& chunk : chunks_) {
+            if (i < chunk.size()) return chunk[i];
+            i -= chunk.size();
+        }
+        static const std::string empty;
+        return empty;
+    }
+
+    size_t chunkCount() const { return chunks_.size(); }
+
+    /**
+     * Collapse the rope back into one contiguous lines vector
+     */
+    std::vector<std::string> flatten() {
+        std::vector<std::string> result;
+        result.reserve(size_);
+        for (auto& chunk : chunks_) {
+            for (auto& line : chunk) {
+                result.push_back(std::move(line));
+            }
+        }
+        chunks_.clear();
+        size_ = 0;
+        return result;
+    }
+
+private:
+    // Chunks are split when lines are inserted mid-chunk; freshly
+    // appended lines accumulate into bounded chunks so locate() stays fast
+    static constexpr size_t kMaxChunkLines = 4096;
+
+    using ChunkList = std::list<std::vector<std::string>>;
+
+    ChunkList chunks_;
+    size_t size_ = 0;
+
+    /**
+     * Find the chunk containing line index pos and the offset within it.
+     * pos == size_ yields end().
+     */
+    std::pair<ChunkList::iterator, size_t> locate(size_t pos) {
+        for (auto it = chunks_.begin(); it != chunks_.end(); ++it) {
+            if (pos < it->size()) return {it, pos};
+            pos -= it->size();
+        }
+        return {chunks_.end(), 0};
+    }
+
+    /**
+     * Split a chunk at offset, returning an iterator to the second half
+     */
+    ChunkList::iterator splitChunk(ChunkList::iterator it, size_t offset) {
+        std::vector<std::string> tail(
+            std::make_move_iterator(it->begin() + offset),
+            std::make_move_iterator(it->end()));
+        it->resize(offset);
+        auto next = std::next(it);
+        return chunks_.insert(next, std::move(tail));
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_LINE_ROPE_HPP
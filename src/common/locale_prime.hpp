@@ -0,0 +1,43 @@
+/*
+ * locale_prime.hpp
+ *
+ * pre-warm libstdc++'s lazily-initialized locale caches
+ *
+ * std::regex compilation narrows pattern characters through the global
+ * locale's ctype<char> facet, which fills a per-facet lookup cache on
+ * first use. Two workers compiling regexes at the same time both write
+ * that cache — a data race ThreadSanitizer rightly flags. The passes
+ * still compile regexes in a few places, so warm the caches once from
+ * the spawning thread before any worker starts; after that every
+ * lookup is a pure read.
+ */
+
+#ifndef MORPHECT_LOCALE_PRIME_HPP
+#define MORPHECT_LOCALE_PRIME_HPP
+
+#include <locale>
+
+namespace morphect {
+
+/**
+ * Touch every ctype<char> cache entry of the classic and global
+ * locales. Idempotent and cheap; call before spawning worker threads.
+ */
+inline void primeLocaleCaches() {
+    static const bool primed = [] {
+        const std::locale locales[] = {std::locale::classic(), std::locale()};
+        for (const std::locale& loc : locales) {
+            const auto& ct = std::use_facet<std::ctype<char>>(loc);
+            for (int c = 0; c < 256; c++) {
+                ct.narrow(static_cast<char>(c), '\0');
+                ct.widen(static_cast<char>(c));
+            }
+        }
+        return true;
+    }();
+    (void)primed;
+}
+
+} // namespace morphect
+
+#endif // MORPHECT_LOCALE_PRIME_HPP
@@ -24,6 +24,9 @@
 #include <memory>
 #include <chrono>
 #include <iomanip>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace morphect {
 
@@ -39,6 +42,24 @@ enum class LogLevel {
     Silent = 5    // No output at all
 };
 
+/**
+ * Compile-time log floor: macro call sites strictly below this level
+ * expand to nothing, so their arguments are never evaluated. Levels use
+ * the LogLevel numbering (0=Trace .. 4=Error); the default keeps
+ * everything. Release builds of the tools set this to 2 (Info) so
+ * per-line Trace/Debug calls in hot loops compile out entirely.
+ */
+#ifndef MORPHECT_LOG_MAX_LEVEL
+#define MORPHECT_LOG_MAX_LEVEL 0
+#endif
+
+/**
+ * True when call sites at this level survive the compile-time floor
+ */
+constexpr bool logLevelCompiledIn(LogLevel level) {
+    return static_cast<int>(level) >= MORPHECT_LOG_MAX_LEVEL;
+}
+
 /**
  * Convert LogLevel to string
  */
@@ -150,6 +171,154 @@ private:
     LogConfig() = default;
 };
 
+/**
+ * Mutex shared by the synchronous write path and the async drain thread
+ */
+inline std::mutex& logOutputMutex() {
+    static std::mutex instance;
+    return instance;
+}
+
+/**
+ * Asynchronous log sink: a bounded MPSC ring buffer drained by a
+ * background thread
+ *
+ * Producers enqueue preformatted records without blocking; when the ring
+ * is full the record is dropped and counted, so logging can never stall
+ * a transformation worker. Slots use the usual sequence-number scheme
+ * (Vyukov bounded queue): a producer claims a slot with fetch-add-style
+ * CAS, the consumer hands it back by bumping the sequence one lap ahead.
+ *
+ * Disabled by default; tools opt in with AsyncLogSink::get().start().
+ */
+class AsyncLogSink {
+public:
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        std::string source;
+        std::string message;
+        std::string formatted;
+    };
+
+    static AsyncLogSink& get() {
+        static AsyncLogSink instance;
+        return instance;
+    }
+
+    explicit AsyncLogSink(size_t capacity = 4096) {
+        // round up to a power of two for cheap masking
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        slots_ = std::vector<Slot>(cap);
+        for (size_t i = 0; i < cap; i++) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~AsyncLogSink() {
+        stop();
+    }
+
+    AsyncLogSink(const AsyncLogSink&) = delete;
+    AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+
+    /**
+     * Spawn the drain thread; records enqueued from now on are written
+     * off the calling thread
+     */
+    void start() {
+        if (running_.exchange(true)) return;
+        drainer_ = std::thread([this]() { drainLoop(); });
+    }
+
+    /**
+     * Drain whatever is queued and join the background thread
+     */
+    void stop() {
+        if (running_.exchange(false)) {
+            if (drainer_.joinable()) drainer_.join();
+        }
+        drainAvailable();
+    }
+
+    bool active() const { return running_.load(std::memory_order_relaxed); }
+
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * Non-blocking enqueue; returns false (and counts) when the ring is
+     * full
+     */
+    bool enqueue(Record record) {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            intptr_t dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (dif == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (dif < 0) {
+                // ring full: bounded-drop rather than stall the producer
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq{0};
+        Record record;
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_ = 0;
+    std::atomic<size_t> head_{0};
+    size_t tail_ = 0;   // consumer-only
+    std::atomic<size_t> dropped_{0};
+    std::atomic<bool> running_{false};
+    std::thread drainer_;
+
+    void drainLoop() {
+        while (running_.load(std::memory_order_relaxed)) {
+            if (!drainAvailable()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        drainAvailable();
+    }
+
+    /**
+     * Write every currently-ready record; returns true if any was written
+     */
+    bool drainAvailable() {
+        bool any = false;
+        for (;;) {
+            Slot& slot = slots_[tail_ & mask_];
+            if (slot.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+
+            Record record = std::move(slot.record);
+            slot.seq.store(tail_ + mask_ + 1, std::memory_order_release);
+            tail_++;
+            any = true;
+
+            writeRecord(record);
+        }
+        return any;
+    }
+
+    void writeRecord(const Record& record);
+};
+
 /**
  * Logger class - use one per component/pass
  */
@@ -205,7 +374,6 @@ public:
 
 private:
     std::string source_;
-    static std::mutex mutex_;
 
     /**
      * Format a string with {} placeholders
@@ -284,9 +452,22 @@ private:
         // Message
         oss << message;
 
+        // Async path: hand the preformatted record to the drain thread;
+        // a full ring drops the record rather than blocking the caller
+        AsyncLogSink& sink = AsyncLogSink::get();
+        if (sink.active()) {
+            AsyncLogSink::Record record;
+            record.level = level;
+            record.source = source_;
+            record.message = message;
+            record.formatted = oss.str();
+            sink.enqueue(std::move(record));
+            return;
+        }
+
         // Thread-safe output
         {
-            std::lock_guard<std::mutex> lock(mutex_);
+            std::lock_guard<std::mutex> lock(logOutputMutex());
             *config.output << oss.str() << std::endl;
 
             // Also call callback if set
@@ -297,20 +478,39 @@ private:
     }
 };
 
-// Static mutex definition (in header for simplicity)
-inline std::mutex Logger::mutex_;
+inline void AsyncLogSink::writeRecord(const Record& record) {
+    auto& config = LogConfig::get();
+
+    std::lock_guard<std::mutex> lock(logOutputMutex());
+    *config.output << record.formatted << std::endl;
+
+    if (config.callback) {
+        config.callback(record.level, record.source, record.message);
+    }
+}
 
 /**
- * Convenience macros for logging with source file info
+ * Convenience macros for logging
+ *
+ * Prefer these over direct logger.debug(...) calls in hot loops: levels
+ * below MORPHECT_LOG_MAX_LEVEL compile to nothing, and for the levels
+ * that remain the arguments are only evaluated after the runtime level
+ * check passes (direct calls always build their arguments first).
  */
-#define MORPHECT_LOG(logger, level, ...) \
-    logger.log(level, __VA_ARGS__)
-
-#define MORPHECT_TRACE(logger, ...) logger.trace(__VA_ARGS__)
-#define MORPHECT_DEBUG(logger, ...) logger.debug(__VA_ARGS__)
-#define MORPHECT_INFO(logger, ...)  logger.info(__VA_ARGS__)
-#define MORPHECT_WARN(logger, ...)  logger.warn(__VA_ARGS__)
-#define MORPHECT_ERROR(logger, ...) logger.error(__VA_ARGS__)
+#define MORPHECT_LOG(logger, level, ...)                                   \
+    do {                                                                   \
+        if constexpr (morphect::logLevelCompiledIn(level)) {               \
+            if ((level) >= morphect::LogConfig::get().minLevel) {          \
+                (logger).log((level), __VA_ARGS__);                        \
+            }                                                              \
+        }                                                                  \
+    } while (0)
+
+#define MORPHECT_TRACE(logger, ...) MORPHECT_LOG(logger, morphect::LogLevel::Trace, __VA_ARGS__)
+#define MORPHECT_DEBUG(logger, ...) MORPHECT_LOG(logger, morphect::LogLevel::Debug, __VA_ARGS__)
+#define MORPHECT_INFO(logger, ...)  MORPHECT_LOG(logger, morphect::LogLevel::Info, __VA_ARGS__)
+#define MORPHECT_WARN(logger, ...)  MORPHECT_LOG(logger, morphect::LogLevel::Warn, __VA_ARGS__)
+#define MORPHECT_ERROR(logger, ...) MORPHECT_LOG(logger, morphect::LogLevel::Error, __VA_ARGS__)
 
 /**
  * Global logger instance for quick access
@@ -320,12 +520,12 @@ inline Logger& globalLogger() {
     return instance;
 }
 
-// Shorthand macros using global logger
-#define LOG_TRACE(...) morphect::globalLogger().trace(__VA_ARGS__)
-#define LOG_DEBUG(...) morphect::globalLogger().debug(__VA_ARGS__)
-#define LOG_INFO(...)  morphect::globalLogger().info(__VA_ARGS__)
-#define LOG_WARN(...)  morphect::globalLogger().warn(__VA_ARGS__)
-#define LOG_ERROR(...) morphect::globalLogger().error(__VA_ARGS__)
+// Shorthand macros using global logger (same stripping/lazy rules)
+#define LOG_TRACE(...) MORPHECT_TRACE(morphect::globalLogger(), __VA_ARGS__)
+#define LOG_DEBUG(...) MORPHECT_DEBUG(morphect::globalLogger(), __VA_ARGS__)
+#define LOG_INFO(...)  MORPHECT_INFO(morphect::globalLogger(), __VA_ARGS__)
+#define LOG_WARN(...)  MORPHECT_WARN(morphect::globalLogger(), __VA_ARGS__)
+#define LOG_ERROR(...) MORPHECT_ERROR(morphect::globalLogger(), __VA_ARGS__)
 
 } // namespace morphect
 
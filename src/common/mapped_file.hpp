@@ -0,0 +1,344 @@
+/*
+ * mapped_file.hpp
+ *
+ * mmap-backed input files with a string_view line table
+ *
+ * Large .ll/.s inputs don't need one heap allocation per line just to be
+ * read. MappedFile maps the input read-only; LineTable slices it into
+ * string_views and keeps a copy-on-write overlay, so only lines a pass
+ * actually modifies get materialized as owned strings.
+ */
+
+#ifndef MORPHECT_MAPPED_FILE_HPP
+#define MORPHECT_MAPPED_FILE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace morphect {
+
+/**
+ * Read-only memory-mapped file (RAII)
+ *
+ * Falls back cleanly: valid() is false if the file can't be opened or
+ * mapped, and callers should use the ifstream path instead.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    explicit MappedFile(const std::string& path) {
+        open(path);
+    }
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            data_ = other.data_;
+            size_ = other.size_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    bool open(const std::string& path) {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < 0) {
+            ::close(fd);
+            return false;
+        }
+
+        size_ = static_cast<size_t>(st.st_size);
+
+        if (size_ == 0) {
+            // Empty file: valid but nothing to map
+            ::close(fd);
+            data_ = nullptr;
+            empty_valid_ = true;
+            return true;
+        }
+
+        void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+
+        if (addr == MAP_FAILED) {
+            size_ = 0;
+            return false;
+        }
+
+        data_ = static_cast<const char*>(addr);
+        return true;
+    }
+
+    void close() {
+        if (data_) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        empty_valid_ = false;
+    }
+
+    bool valid() const { return data_ != nullptr || empty_valid_; }
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    std::string_view view() const {
+        return std::string_view(data_ ? data_ : "", size_);
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool empty_valid_ = false;
+};
+
+/**
+ * Pre-sized memory-mapped output file (RAII)
+ *
+ * The write path used to assemble the complete module as one string
+ * and then write it, carrying a duplicate copy of the output at peak.
+ * MappedOutputFile ftruncates the destination to an estimated size,
+ * maps it writable, and lets the emitter append straight into the
+ * mapping; close() truncates to the bytes actually written. A short
+ * estimate is handled by remapping at a larger size.
+ */
+class MappedOutputFile {
+public:
+    MappedOutputFile() = default;
+
+    MappedOutputFile(const std::string& path, size_t estimated_bytes) {
+        open(path, estimated_bytes);
+    }
+
+    ~MappedOutputFile() {
+        close();
+    }
+
+    MappedOutputFile(const MappedOutputFile&) = delete;
+    MappedOutputFile& operator=(const MappedOutputFile&) = delete;
+
+    /**
+     * Create the file at the estimated size and map it writable
+     */
+    bool open(const std::string& path, size_t estimated_bytes) {
+        close();
+
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+
+        if (!remap(estimated_bytes > 0 ? estimated_bytes : kMinMapping)) {
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        return true;
+    }
+
+    bool valid() const { return fd_ >= 0 && data_ != nullptr; }
+    bool ok() const { return valid() && ok_; }
+
+    void append(std::string_view text) {
+        if (!valid() || !ok_) return;
+        if (written_ + text.size() > mapped_size_) {
+            // Estimate came up short: grow geometrically and remap
+            size_t grown = mapped_size_ + mapped_size_ / 2;
+            if (grown < written_ + text.size()) {
+                grown = written_ + text.size();
+            }
+            if (!remap(grown)) {
+                ok_ = false;
+                return;
+            }
+        }
+        std::memcpy(data_ + written_, text.data(), text.size());
+        written_ += text.size();
+    }
+
+    void appendLine(std::string_view line) {
+        append(line);
+        append("\n");
+    }
+
+    size_t written() const { return written_; }
+
+    /**
+     * Unmap and truncate to the actual output size. Returns false if
+     * any append failed or the truncate does.
+     */
+    bool close() {
+        if (fd_ < 0) return true;
+
+        bool all_ok = ok_;
+        if (data_) {
+            munmap(data_, mapped_size_);
+            data_ = nullptr;
+        }
+        if (ftruncate(fd_, static_cast<off_t>(written_)) != 0) {
+            all_ok = false;
+        }
+        ::close(fd_);
+        fd_ = -1;
+        mapped_size_ = 0;
+        written_ = 0;
+        ok_ = true;
+        return all_ok;
+    }
+
+private:
+    static constexpr size_t kMinMapping = 64 * 1024;
+
+    bool remap(size_t new_size) {
+        if (data_) {
+            munmap(data_, mapped_size_);
+            data_ = nullptr;
+        }
+        if (ftruncate(fd_, static_cast<off_t>(new_size)) != 0) {
+            return false;
+        }
+        void* addr = mmap(nullptr, new_size, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<char*>(addr);
+        mapped_size_ = new_size;
+        return true;
+    }
+
+    int fd_ = -1;
+    char* data_ = nullptr;
+    size_t mapped_size_ = 0;
+    size_t written_ = 0;
+    bool ok_ = true;
+};
+
+/**
+ * Line table over an immutable buffer with copy-on-write per line
+ *
+ * Unmodified lines stay as views into the backing buffer (the mapped
+ * file, which must outlive the table); set() stores an owned copy for
+ * just that line.
+ */
+class LineTable {
+public:
+    LineTable() = default;
+
+    explicit LineTable(std::string_view buffer) {
+        reset(buffer);
+    }
+
+    /**
+     * Rebuild the table over a new buffer
+     */
+    void reset(std::string_view buffer) {
+        views_.clear();
+        overlay_.clear();
+
+        size_t start = 0;
+        for (size_t i = 0; i < buffer.size(); i++) {
+            if (buffer[i] == '\n') {
+                size_t len = i - start;
+                // Tolerate CRLF input
+                if (len > 0 && buffer[start + len - 1] == '\r') len--;
+                views_.push_back(buffer.substr(start, len));
+                start = i + 1;
+            }
+        }
+        if (start < buffer.size()) {
+            views_.push_back(buffer.substr(start));
+        }
+    }
+
+    size_t size() const { return views_.size(); }
+    bool empty() const { return views_.empty(); }
+
+    /**
+     * Current content of line i (overlay wins over the backing buffer)
+     */
+    std::string_view get(size_t i) const {
+        auto it = overlay_.find(i);
+        if (it != overlay_.end()) return it->second;
+        return views_[i];
+    }
+
+    /**
+     * Replace line i with an owned copy (copy-on-write)
+     */
+    void set(size_t i, std::string value) {
+        overlay_[i] = std::move(value);
+    }
+
+    bool isModified(size_t i) const {
+        return overlay_.find(i) != overlay_.end();
+    }
+
+    size_t modifiedCount() const { return overlay_.size(); }
+
+    /**
+     * Materialize all lines as owned strings (for the existing
+     * vector<string> pass interfaces)
+     */
+    std::vector<std::string> materialize() const {
+        std::vector<std::string> lines;
+        lines.reserve(views_.size());
+        for (size_t i = 0; i < views_.size(); i++) {
+            lines.emplace_back(get(i));
+        }
+        return lines;
+    }
+
+    /**
+     * Join all current lines with '\n' (plus trailing newline)
+     */
+    std::string join() const {
+        size_t total = 0;
+        for (size_t i = 0; i < views_.size(); i++) {
+            total += get(i).size() + 1;
+        }
+
+        std::string out;
+        out.reserve(total);
+        for (size_t i = 0; i < views_.size(); i++) {
+            out.append(get(i));
+            out.push_back('\n');
+        }
+        return out;
+    }
+
+private:
+    std::vector<std::string_view> views_;
+    std::unordered_map<size_t, std::string> overlay_;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_MAPPED_FILE_HPP
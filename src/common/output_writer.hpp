@@ -0,0 +1,134 @@
+/*
+ * output_writer.hpp
+ *
+ * buffered streaming writer for transformed output files
+ *
+ * Both backends used to assemble the whole output in memory and write
+ * it once through an ofstream at the end, so output I/O serialized
+ * behind transformation and peak memory carried a full copy of the
+ * output. OutputWriter appends into a fixed-size buffer and flushes
+ * with write(2) as transformation proceeds, letting the kernel overlap
+ * writeback with the remaining work. preallocate() hints the final size
+ * so the filesystem can reserve contiguous extents up front.
+ */
+
+#ifndef MORPHECT_OUTPUT_WRITER_HPP
+#define MORPHECT_OUTPUT_WRITER_HPP
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace morphect {
+
+/**
+ * Fixed-buffer file writer (RAII)
+ *
+ * valid() is false if the file can't be created. ok() goes false on the
+ * first failed write and stays false; close() flushes and reports
+ * whether everything landed on disk.
+ */
+class OutputWriter {
+public:
+    static constexpr size_t kDefaultBufferSize = 1 << 20;  // 1 MiB
+
+    explicit OutputWriter(const std::string& path,
+                          size_t buffer_size = kDefaultBufferSize)
+        : buffer_size_(buffer_size > 0 ? buffer_size : kDefaultBufferSize) {
+        if (path == "-") {
+            // Pipe mode: stream to stdout. dup() so close() releases
+            // our fd without taking the process's stdout with it.
+            fd_ = ::dup(STDOUT_FILENO);
+        } else {
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        }
+        buffer_.reserve(buffer_size_);
+    }
+
+    ~OutputWriter() {
+        close();
+    }
+
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+
+    bool valid() const { return fd_ >= 0; }
+    bool ok() const { return valid() && ok_; }
+
+    /** Best-effort size hint; ignored where the fs doesn't support it. */
+    void preallocate(size_t expected_bytes) {
+#ifdef __linux__
+        if (fd_ >= 0 && expected_bytes > 0) {
+            (void)posix_fallocate(fd_, 0, static_cast<off_t>(expected_bytes));
+        }
+#else
+        (void)expected_bytes;
+#endif
+    }
+
+    void append(std::string_view text) {
+        // Oversized appends bypass the buffer to avoid double-copying
+        if (text.size() >= buffer_size_) {
+            flush();
+            writeAll(text.data(), text.size());
+            return;
+        }
+        if (buffer_.size() + text.size() > buffer_size_) {
+            flush();
+        }
+        buffer_.append(text);
+    }
+
+    void appendLine(std::string_view line) {
+        append(line);
+        if (buffer_.size() == buffer_size_) {
+            flush();
+        }
+        buffer_.push_back('\n');
+    }
+
+    size_t bytesWritten() const { return bytes_written_ + buffer_.size(); }
+
+    /** Flush remaining output and release the fd. Safe to call twice. */
+    bool close() {
+        if (fd_ < 0) return ok_;
+        flush();
+        ::close(fd_);
+        fd_ = -1;
+        return ok_;
+    }
+
+private:
+    void flush() {
+        if (!buffer_.empty()) {
+            writeAll(buffer_.data(), buffer_.size());
+            buffer_.clear();
+        }
+    }
+
+    void writeAll(const char* data, size_t size) {
+        while (size > 0 && ok_) {
+            ssize_t n = ::write(fd_, data, size);
+            if (n < 0) {
+                ok_ = false;
+                break;
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+            bytes_written_ += static_cast<size_t>(n);
+        }
+    }
+
+    int fd_ = -1;
+    bool ok_ = true;
+    size_t buffer_size_;
+    size_t bytes_written_ = 0;
+    std::string buffer_;
+};
+
+}  // namespace morphect
+
+#endif  // MORPHECT_OUTPUT_WRITER_HPP
@@ -0,0 +1,117 @@
+/*
+ * profile_data.hpp
+ *
+ * production profile loader for profile-guided exclusion
+ *
+ * Hot functions are known from production perf profiles, but exempting
+ * them from expensive passes meant hand-maintaining exclude_functions
+ * lists. The loader reads a flat name/sample-count profile (one record
+ * per line - "name,count", "name count", or "count name", as produced
+ * by a short awk over perf script output) and ranks functions by
+ * samples; hottestPercent(n) names the top n% for the caller to feed
+ * into the existing include/exclude machinery.
+ */
+
+#ifndef MORPHECT_PROFILE_DATA_HPP
+#define MORPHECT_PROFILE_DATA_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <cstdint>
+
+namespace morphect {
+
+class HotFunctionProfile {
+public:
+    /**
+     * Load a profile file. Lines are "name,count", "name count", or
+     * "count name"; '#' starts a comment; repeated names accumulate.
+     * Lines that don't fit the shape are skipped, not fatal.
+     */
+    bool loadFile(const std::string& path) {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t hash = line.find('#');
+            if (hash != std::string::npos) {
+                line.resize(hash);
+            }
+            std::replace(line.begin(), line.end(), ',', ' ');
+
+            std::istringstream tokens(line);
+            std::string a, b, extra;
+            if (!(tokens >> a >> b) || (tokens >> extra)) {
+                continue;  // need exactly two fields
+            }
+
+            // One field is the count, the other the name - accept either order
+            uint64_t count = 0;
+            if (parseCount(a, count)) {
+                samples_[b] += count;
+            } else if (parseCount(b, count)) {
+                samples_[a] += count;
+            }
+        }
+        return true;
+    }
+
+    size_t size() const { return samples_.size(); }
+
+    uint64_t samples(const std::string& name) const {
+        auto it = samples_.find(name);
+        return it != samples_.end() ? it->second : 0;
+    }
+
+    /**
+     * Names of the hottest percent% of profiled functions (at least one
+     * when anything was profiled and percent > 0). Ties and equal
+     * counts break by name so the selection is deterministic.
+     */
+    std::vector<std::string> hottestPercent(double percent) const {
+        std::vector<std::string> result;
+        if (samples_.empty() || percent <= 0) return result;
+
+        std::vector<std::pair<std::string, uint64_t>> ranked(samples_.begin(),
+                                                             samples_.end());
+        std::sort(ranked.begin(), ranked.end(),
+                  [](const auto& a, const auto& b) {
+                      if (a.second != b.second) return a.second > b.second;
+                      return a.first < b.first;
+                  });
+
+        size_t take = static_cast<size_t>(std::ceil(
+            static_cast<double>(ranked.size()) * std::min(percent, 100.0) / 100.0));
+        take = std::max<size_t>(take, 1);
+
+        result.reserve(take);
+        for (size_t i = 0; i < take && i < ranked.size(); i++) {
+            result.push_back(ranked[i].first);
+        }
+        return result;
+    }
+
+private:
+    std::unordered_map<std::string, uint64_t> samples_;
+
+    static bool parseCount(const std::string& token, uint64_t& out) {
+        if (token.empty()) return false;
+        uint64_t value = 0;
+        for (char c : token) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+        }
+        out = value;
+        return true;
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_PROFILE_DATA_HPP
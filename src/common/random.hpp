@@ -10,12 +10,146 @@
 #include <random>
 #include <mutex>
 #include <cstdint>
+#include <string_view>
 #include <vector>
 #include <algorithm>
 #include <stdexcept>
 
 namespace morphect {
 
+// unsynchronized RNG for a single worker thread
+//
+// Same draw sequence as Random for the same seed, but no mutex: parallel
+// per-function workers install one of these via GlobalRandom::ScopedLocal
+// with a seed derived from (global seed, function name), so runs stay
+// byte-for-byte reproducible no matter how functions land on threads.
+class LocalRandom {
+public:
+    LocalRandom() : rng_(std::random_device{}()) {}
+    explicit LocalRandom(uint64_t seed) : rng_(seed), seed_(seed) {}
+
+    uint64_t getSeed() const { return seed_; }
+
+    void seed(uint64_t new_seed) {
+        seed_ = new_seed;
+        rng_.seed(new_seed);
+    }
+
+    // deterministic per-scope seed: splitmix64 finalizer over the base
+    // seed mixed with an FNV-1a hash of the scope name
+    static uint64_t deriveSeed(uint64_t base_seed, std::string_view scope) {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (unsigned char c : scope) {
+            h ^= c;
+            h *= 0x100000001b3ULL;
+        }
+
+        uint64_t z = base_seed ^ h;
+        z += 0x9e3779b97f4a7c15ULL;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // [min, max] inclusive
+    int nextInt(int min, int max) {
+        std::uniform_int_distribution<int> dist(min, max);
+        return dist(rng_);
+    }
+
+    // [0, max) exclusive
+    int nextInt(int max) {
+        return nextInt(0, max - 1);
+    }
+
+    size_t nextSize(size_t max) {
+        std::uniform_int_distribution<size_t> dist(0, max - 1);
+        return dist(rng_);
+    }
+
+    uint64_t nextUint64() {
+        std::uniform_int_distribution<uint64_t> dist;
+        return dist(rng_);
+    }
+
+    // [0.0, 1.0)
+    double nextDouble() {
+        std::uniform_real_distribution<double> dist(0.0, 1.0);
+        return dist(rng_);
+    }
+
+    double nextDouble(double min, double max) {
+        std::uniform_real_distribution<double> dist(min, max);
+        return dist(rng_);
+    }
+
+    // returns true with given probability
+    bool decide(double probability) {
+        if (probability <= 0.0) return false;
+        if (probability >= 1.0) return true;
+        return nextDouble() < probability;
+    }
+
+    template<typename T>
+    const T& choose(const std::vector<T>& items) {
+        if (items.empty()) {
+            throw std::runtime_error("Cannot choose from empty vector");
+        }
+        return items[nextSize(items.size())];
+    }
+
+    template<typename T>
+    void shuffle(std::vector<T>& items) {
+        std::shuffle(items.begin(), items.end(), rng_);
+    }
+
+    uint8_t nextByte() {
+        return static_cast<uint8_t>(nextInt(0, 255));
+    }
+
+    uint8_t nextNonZeroByte() {
+        return static_cast<uint8_t>(nextInt(1, 255));
+    }
+
+    // bulk fills matching Random's batched API (no lock to amortize here,
+    // but callers can stay agnostic about which generator they hold)
+    void fillBytes(uint8_t* data, size_t count) {
+        size_t i = 0;
+        while (i + 8 <= count) {
+            uint64_t chunk = rng_();
+            for (int b = 0; b < 8; b++) {
+                data[i++] = static_cast<uint8_t>(chunk >> (b * 8));
+            }
+        }
+        if (i < count) {
+            uint64_t chunk = rng_();
+            while (i < count) {
+                data[i++] = static_cast<uint8_t>(chunk);
+                chunk >>= 8;
+            }
+        }
+    }
+
+    void nextInts(int* buffer, size_t count, int min, int max) {
+        std::uniform_int_distribution<int> dist(min, max);
+        for (size_t i = 0; i < count; i++) {
+            buffer[i] = dist(rng_);
+        }
+    }
+
+    void fillFrom(std::string_view alphabet, char* out, size_t count) {
+        if (alphabet.empty()) return;
+        std::uniform_int_distribution<size_t> dist(0, alphabet.size() - 1);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = alphabet[dist(rng_)];
+        }
+    }
+
+private:
+    std::mt19937_64 rng_;
+    uint64_t seed_ = 0;
+};
+
 class Random {
 public:
     Random() : rng_(std::random_device{}()) {}
@@ -139,10 +273,48 @@ public:
 
     std::vector<uint8_t> nextBytes(size_t count) {
         std::vector<uint8_t> result(count);
+        fillBytes(result.data(), result.size());
+        return result;
+    }
+
+    // bulk fill: one lock acquisition, 8 bytes per engine invocation
+    // instead of a locked distribution call per byte
+    void fillBytes(uint8_t* data, size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t i = 0;
+        while (i + 8 <= count) {
+            uint64_t chunk = rng_();
+            for (int b = 0; b < 8; b++) {
+                data[i++] = static_cast<uint8_t>(chunk >> (b * 8));
+            }
+        }
+        if (i < count) {
+            uint64_t chunk = rng_();
+            while (i < count) {
+                data[i++] = static_cast<uint8_t>(chunk);
+                chunk >>= 8;
+            }
+        }
+    }
+
+    // bulk fill of [min, max] ints: one lock, one distribution reused
+    void nextInts(int* buffer, size_t count, int min, int max) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uniform_int_distribution<int> dist(min, max);
         for (size_t i = 0; i < count; i++) {
-            result[i] = nextByte();
+            buffer[i] = dist(rng_);
+        }
+    }
+
+    // bulk fill of characters drawn from an alphabet: one lock for the
+    // whole buffer (label generation draws 9+ chars per label)
+    void fillFrom(std::string_view alphabet, char* out, size_t count) {
+        if (alphabet.empty()) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uniform_int_distribution<size_t> dist(0, alphabet.size() - 1);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = alphabet[dist(rng_)];
         }
-        return result;
     }
 
 private:
@@ -163,25 +335,76 @@ public:
         get().seed(seed);
     }
 
-    static int nextInt(int min, int max) { return get().nextInt(min, max); }
-    static int nextInt(int max) { return get().nextInt(max); }
-    static size_t nextSize(size_t max) { return get().nextSize(max); }
-    static double nextDouble() { return get().nextDouble(); }
-    static bool decide(double probability) { return get().decide(probability); }
+    // install a lock-free thread-local generator for the current scope;
+    // while active, the static draw helpers below use it instead of the
+    // mutex-protected global instance
+    class ScopedLocal {
+    public:
+        explicit ScopedLocal(uint64_t seed) : local_(seed), prev_(tls()) {
+            tls() = &local_;
+        }
+        ~ScopedLocal() {
+            tls() = prev_;
+        }
+
+        ScopedLocal(const ScopedLocal&) = delete;
+        ScopedLocal& operator=(const ScopedLocal&) = delete;
+
+    private:
+        LocalRandom local_;
+        LocalRandom* prev_;
+    };
+
+    static LocalRandom* threadLocal() { return tls(); }
+
+    static int nextInt(int min, int max) {
+        if (LocalRandom* l = tls()) return l->nextInt(min, max);
+        return get().nextInt(min, max);
+    }
+    static int nextInt(int max) {
+        if (LocalRandom* l = tls()) return l->nextInt(max);
+        return get().nextInt(max);
+    }
+    static size_t nextSize(size_t max) {
+        if (LocalRandom* l = tls()) return l->nextSize(max);
+        return get().nextSize(max);
+    }
+    static double nextDouble() {
+        if (LocalRandom* l = tls()) return l->nextDouble();
+        return get().nextDouble();
+    }
+    static bool decide(double probability) {
+        if (LocalRandom* l = tls()) return l->decide(probability);
+        return get().decide(probability);
+    }
 
     template<typename T>
     static const T& choose(const std::vector<T>& items) {
+        if (LocalRandom* l = tls()) return l->choose(items);
         return get().choose(items);
     }
 
+    static void fillBytes(uint8_t* data, size_t count) {
+        if (LocalRandom* l = tls()) return l->fillBytes(data, count);
+        get().fillBytes(data, count);
+    }
+    static void nextInts(int* buffer, size_t count, int min, int max) {
+        if (LocalRandom* l = tls()) return l->nextInts(buffer, count, min, max);
+        get().nextInts(buffer, count, min, max);
+    }
+    static void fillFrom(std::string_view alphabet, char* out, size_t count) {
+        if (LocalRandom* l = tls()) return l->fillFrom(alphabet, out, count);
+        get().fillFrom(alphabet, out, count);
+    }
+
     static size_t chooseWeightedIndex(const std::vector<double>& weights) {
         if (weights.empty()) return 0;
 
         double total = 0.0;
         for (double w : weights) total += w;
-        if (total <= 0.0) return get().nextSize(weights.size());
+        if (total <= 0.0) return nextSize(weights.size());
 
-        double rand_val = get().nextDouble() * total;
+        double rand_val = nextDouble() * total;
         double cumulative = 0.0;
 
         for (size_t i = 0; i < weights.size(); i++) {
@@ -196,6 +419,82 @@ public:
 
 private:
     GlobalRandom() = default;
+
+    static LocalRandom*& tls() {
+        static thread_local LocalRandom* override_ = nullptr;
+        return override_;
+    }
+};
+
+// Walker alias-table sampler for weighted selection.
+//
+// chooseWeighted/chooseWeightedIndex walk the cumulative weights on
+// every draw - fine for one-shot picks, but the variant and generator
+// selections draw from the same fixed weights millions of times per
+// module. Build the table once (O(n)) and every draw is O(1): one
+// uniform slot pick plus one coin flip against that slot's cutoff.
+class AliasSampler {
+public:
+    AliasSampler() = default;
+
+    explicit AliasSampler(const std::vector<double>& weights) {
+        build(weights);
+    }
+
+    // (re)build the table; weights don't need to sum to 1.
+    // non-positive totals degrade to uniform selection
+    void build(const std::vector<double>& weights) {
+        source_ = weights;
+        size_t n = weights.size();
+        prob_.assign(n, 1.0);
+        alias_.resize(n);
+        for (size_t i = 0; i < n; i++) alias_[i] = i;
+        if (n == 0) return;
+
+        double total = 0.0;
+        for (double w : weights) {
+            if (w > 0.0) total += w;
+        }
+        if (total <= 0.0) return;  // uniform
+
+        // scale to mean 1, then pair under-full and over-full slots
+        std::vector<double> scaled(n);
+        std::vector<size_t> small, large;
+        for (size_t i = 0; i < n; i++) {
+            scaled[i] = (weights[i] > 0.0 ? weights[i] : 0.0) * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            size_t s = small.back(); small.pop_back();
+            size_t l = large.back(); large.pop_back();
+            prob_[s] = scaled[s];
+            alias_[s] = l;
+            scaled[l] -= (1.0 - scaled[s]);
+            (scaled[l] < 1.0 ? small : large).push_back(l);
+        }
+        // leftovers are numerically 1.0; keep prob 1 / self alias
+    }
+
+    bool built() const { return !prob_.empty(); }
+
+    // true if the table was built from exactly these weights
+    bool matches(const std::vector<double>& weights) const {
+        return source_ == weights;
+    }
+
+    size_t size() const { return prob_.size(); }
+
+    size_t sample() const {
+        if (prob_.empty()) return 0;
+        size_t slot = GlobalRandom::nextSize(prob_.size());
+        return (GlobalRandom::nextDouble() < prob_[slot]) ? slot : alias_[slot];
+    }
+
+private:
+    std::vector<double> prob_;    // acceptance cutoff per slot
+    std::vector<size_t> alias_;   // fallback index per slot
+    std::vector<double> source_;  // weights the table was built from
 };
 
 } // namespace morphect
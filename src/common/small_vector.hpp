@@ -0,0 +1,238 @@
+/*
+ * small_vector.hpp
+ *
+ * Vector with inline storage for the first N elements.
+ *
+ * The analysis records walked hardest during transformation (basic-
+ * block successor/predecessor lists, dead-code block contents) hold a
+ * handful of elements almost always, yet std::vector puts even two
+ * ints behind a heap pointer - so traversing a CFG chases one cache
+ * line per list on top of the elements themselves. SmallVector keeps
+ * up to N elements inside the object, making the common case a
+ * contiguous read with zero allocations, and spills to the heap
+ * transparently when a list actually grows past N.
+ *
+ * Deliberately a subset of std::vector: what the analysis structures
+ * use (push_back/emplace_back, iteration, indexing, resize, clear),
+ * with the same iterator invalidation rules.
+ */
+
+#ifndef MORPHECT_SMALL_VECTOR_HPP
+#define MORPHECT_SMALL_VECTOR_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace morphect {
+
+template <typename T, size_t N>
+class SmallVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    SmallVector() : data_(inlineData()), size_(0), capacity_(N) {}
+
+    SmallVector(std::initializer_list<T> init) : SmallVector() {
+        reserve(init.size());
+        for (const T& value : init) {
+            ::new (data_ + size_) T(value);
+            size_++;
+        }
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector() {
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; i++) {
+            ::new (data_ + i) T(other.data_[i]);
+        }
+        size_ = other.size_;
+    }
+
+    SmallVector(SmallVector&& other) noexcept : SmallVector() {
+        stealOrMoveFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size_);
+            for (size_t i = 0; i < other.size_; i++) {
+                ::new (data_ + i) T(other.data_[i]);
+            }
+            size_ = other.size_;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            destroyAll();
+            releaseHeap();
+            data_ = inlineData();
+            capacity_ = N;
+            size_ = 0;
+            stealOrMoveFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(std::initializer_list<T> init) {
+        clear();
+        reserve(init.size());
+        for (const T& value : init) {
+            ::new (data_ + size_) T(value);
+            size_++;
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        destroyAll();
+        releaseHeap();
+    }
+
+    bool empty() const { return size_ == 0; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T& front() { return data_[0]; }
+    const T& front() const { return data_[0]; }
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    void push_back(const T& value) {
+        grow(size_ + 1);
+        ::new (data_ + size_) T(value);
+        size_++;
+    }
+
+    void push_back(T&& value) {
+        grow(size_ + 1);
+        ::new (data_ + size_) T(std::move(value));
+        size_++;
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        grow(size_ + 1);
+        ::new (data_ + size_) T(std::forward<Args>(args)...);
+        return data_[size_++];
+    }
+
+    void pop_back() {
+        size_--;
+        data_[size_].~T();
+    }
+
+    void clear() {
+        destroyAll();
+        size_ = 0;
+    }
+
+    void reserve(size_t wanted) {
+        if (wanted > capacity_) {
+            reallocate(wanted);
+        }
+    }
+
+    void resize(size_t new_size) {
+        if (new_size < size_) {
+            while (size_ > new_size) pop_back();
+        } else {
+            grow(new_size);
+            while (size_ < new_size) {
+                ::new (data_ + size_) T();
+                size_++;
+            }
+        }
+    }
+
+private:
+    T* inlineData() {
+        return reinterpret_cast<T*>(inline_storage_);
+    }
+
+    bool onHeap() const {
+        return data_ != reinterpret_cast<const T*>(inline_storage_);
+    }
+
+    // Amortized doubling once past the inline capacity
+    void grow(size_t needed) {
+        if (needed > capacity_) {
+            size_t doubled = capacity_ * 2;
+            reallocate(needed > doubled ? needed : doubled);
+        }
+    }
+
+    void reallocate(size_t new_capacity) {
+        T* fresh = static_cast<T*>(
+            ::operator new(new_capacity * sizeof(T), std::align_val_t(alignof(T))));
+        for (size_t i = 0; i < size_; i++) {
+            ::new (fresh + i) T(std::move(data_[i]));
+            data_[i].~T();
+        }
+        releaseHeap();
+        data_ = fresh;
+        capacity_ = new_capacity;
+    }
+
+    void destroyAll() {
+        for (size_t i = 0; i < size_; i++) {
+            data_[i].~T();
+        }
+    }
+
+    void releaseHeap() {
+        if (onHeap()) {
+            ::operator delete(data_, std::align_val_t(alignof(T)));
+        }
+    }
+
+    // Expects *this to be empty and inline; leaves other empty
+    void stealOrMoveFrom(SmallVector& other) {
+        if (other.onHeap()) {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+        } else {
+            for (size_t i = 0; i < other.size_; i++) {
+                ::new (data_ + i) T(std::move(other.data_[i]));
+            }
+            size_ = other.size_;
+            other.destroyAll();
+        }
+        other.data_ = other.inlineData();
+        other.size_ = 0;
+        other.capacity_ = N;
+    }
+
+    alignas(T) unsigned char inline_storage_[N * sizeof(T)];
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_SMALL_VECTOR_HPP
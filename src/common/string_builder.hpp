@@ -0,0 +1,105 @@
+/*
+ * string_builder.hpp
+ *
+ * small growable buffer writer for code-generation hot paths
+ *
+ * std::ostringstream locks locales and allocates per chunk; the
+ * code-generation paths (decoder calls, encoded-constant lines, MBA
+ * replacement text) only ever append text and integers. This builder
+ * appends into one reserved std::string and formats integers with
+ * std::to_chars, so building a line costs at most one allocation.
+ */
+
+#ifndef MORPHECT_STRING_BUILDER_HPP
+#define MORPHECT_STRING_BUILDER_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <cstdint>
+
+namespace morphect {
+
+class StringBuilder {
+public:
+    explicit StringBuilder(size_t reserve = 128) {
+        buffer_.reserve(reserve);
+    }
+
+    StringBuilder& append(std::string_view text) {
+        buffer_.append(text);
+        return *this;
+    }
+
+    StringBuilder& append(char c) {
+        buffer_.push_back(c);
+        return *this;
+    }
+
+    StringBuilder& append(int value) {
+        return appendInteger(static_cast<int64_t>(value));
+    }
+
+    StringBuilder& append(long value) {
+        return appendInteger(static_cast<int64_t>(value));
+    }
+
+    StringBuilder& append(long long value) {
+        return appendInteger(static_cast<int64_t>(value));
+    }
+
+    StringBuilder& append(unsigned value) {
+        return appendUnsigned(static_cast<uint64_t>(value));
+    }
+
+    StringBuilder& append(unsigned long value) {
+        return appendUnsigned(static_cast<uint64_t>(value));
+    }
+
+    StringBuilder& append(unsigned long long value) {
+        return appendUnsigned(static_cast<uint64_t>(value));
+    }
+
+    void clear() {
+        buffer_.clear();
+    }
+
+    size_t size() const { return buffer_.size(); }
+    bool empty() const { return buffer_.empty(); }
+
+    std::string_view view() const { return buffer_; }
+
+    const std::string& str() const { return buffer_; }
+
+    /**
+     * Move the built string out (builder is empty afterwards)
+     */
+    std::string take() {
+        std::string out = std::move(buffer_);
+        buffer_.clear();
+        return out;
+    }
+
+private:
+    std::string buffer_;
+
+    StringBuilder& appendInteger(int64_t value) {
+        char digits[24];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        (void)ec;   // 24 chars always fit a 64-bit integer
+        buffer_.append(digits, end - digits);
+        return *this;
+    }
+
+    StringBuilder& appendUnsigned(uint64_t value) {
+        char digits[24];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        (void)ec;
+        buffer_.append(digits, end - digits);
+        return *this;
+    }
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_STRING_BUILDER_HPP
@@ -0,0 +1,131 @@
+/*
+ * string_interner.hpp
+ *
+ * interning table for identifiers and labels
+ *
+ * SSA names, block labels, and function names get stored as
+ * std::string keys in maps all over the passes; heap profiles show
+ * tens of millions of short-string allocations on large modules.
+ * Interning maps every distinct spelling to a stable u32 symbol ID
+ * backed by contiguous block storage, so comparisons become integer
+ * compares and bookkeeping maps can be dense-keyed by ID.
+ *
+ * Each pass instance owns its interner: region mode runs worker-local
+ * pass objects (see transformFunctionRegion), so a shared mutable
+ * table would need a lock on the hottest path for nothing.
+ */
+
+#ifndef MORPHECT_STRING_INTERNER_HPP
+#define MORPHECT_STRING_INTERNER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace morphect {
+
+/**
+ * Stable u32 IDs for interned strings
+ *
+ * Backing text lives in fixed-capacity blocks that are never resized,
+ * so the string_views handed out stay valid for the interner's
+ * lifetime. IDs are dense (0, 1, 2, ...) in first-seen order, which
+ * makes them usable as vector indices as well as map keys.
+ */
+class StringInterner {
+public:
+    using SymbolId = uint32_t;
+
+    static constexpr SymbolId kInvalidSymbol = static_cast<SymbolId>(-1);
+
+    StringInterner() = default;
+
+    // Copies re-intern in ID order (IDs are dense and first-seen), so
+    // the copy's views point into its own blocks, never the source's
+    StringInterner(const StringInterner& other) { copyFrom(other); }
+
+    StringInterner& operator=(const StringInterner& other) {
+        if (this != &other) {
+            clear();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * ID for the string, interning it on first sight
+     */
+    SymbolId intern(std::string_view text) {
+        auto it = ids_.find(text);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+
+        std::string_view stored = store(text);
+        SymbolId id = static_cast<SymbolId>(spans_.size());
+        spans_.push_back(stored);
+        ids_.emplace(stored, id);
+        return id;
+    }
+
+    /**
+     * ID for the string if already interned, kInvalidSymbol otherwise
+     *
+     * Takes a string_view so hot probe loops never allocate.
+     */
+    SymbolId find(std::string_view text) const {
+        auto it = ids_.find(text);
+        return it == ids_.end() ? kInvalidSymbol : it->second;
+    }
+
+    /**
+     * Spelling of an interned symbol
+     */
+    std::string_view view(SymbolId id) const {
+        return spans_[id];
+    }
+
+    size_t size() const { return spans_.size(); }
+    bool empty() const { return spans_.empty(); }
+
+    void clear() {
+        ids_.clear();
+        spans_.clear();
+        blocks_.clear();
+    }
+
+private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    void copyFrom(const StringInterner& other) {
+        for (const std::string_view& span : other.spans_) {
+            intern(span);
+        }
+    }
+
+    /**
+     * Copy the text into block storage and return a stable view
+     */
+    std::string_view store(std::string_view text) {
+        if (blocks_.empty() ||
+            blocks_.back().size() + text.size() > blocks_.back().capacity()) {
+            blocks_.emplace_back();
+            blocks_.back().reserve(text.size() > kBlockSize ? text.size()
+                                                            : kBlockSize);
+        }
+        std::string& block = blocks_.back();
+        size_t offset = block.size();
+        block.append(text);
+        return std::string_view(block.data() + offset, text.size());
+    }
+
+    std::vector<std::string> blocks_;            // backing text, never resized
+    std::vector<std::string_view> spans_;        // id -> spelling
+    std::unordered_map<std::string_view, SymbolId> ids_;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_STRING_INTERNER_HPP
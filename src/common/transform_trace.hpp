@@ -0,0 +1,232 @@
+/*
+ * transform_trace.hpp
+ *
+ * bounded ring buffer of transformation records with binary streaming
+ *
+ * The IR obfuscator used to accumulate every transformation record as
+ * five std::strings in memory for verbose reporting - gigabytes on big
+ * runs, so logging stayed off and forensics were lost. The trace keeps
+ * a fixed-capacity ring of 16-byte records over interned string IDs,
+ * and can optionally stream every record to a binary trace file that
+ * morphect-trace replays and pretty-prints.
+ */
+
+#ifndef MORPHECT_TRANSFORM_TRACE_HPP
+#define MORPHECT_TRANSFORM_TRACE_HPP
+
+#include "string_interner.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <cstdint>
+
+namespace morphect {
+
+/**
+ * Ring buffer of fixed-size transformation records
+ *
+ * record() interns the three strings once and stores IDs, so the hot
+ * path is three hash probes and a 16-byte write; old records fall off
+ * the back once the ring is full (dropped() counts them). The binary
+ * stream keeps full fidelity: string spellings are emitted once, on
+ * first sight, before the record that introduces them.
+ */
+class TransformTrace {
+public:
+    static constexpr size_t kDefaultCapacity = 65536;
+
+    // Binary trace file layout: 8-byte header (magic + version), then
+    // tagged records. Tag 'S': u32 id, u32 length, raw bytes. Tag 'R':
+    // one Entry.
+    static constexpr char kMagic[4] = {'M', 'T', 'R', 'C'};
+    static constexpr uint32_t kVersion = 1;
+
+    struct Entry {
+        StringInterner::SymbolId function;
+        StringInterner::SymbolId pass;
+        StringInterner::SymbolId operation;
+        int32_t line;
+    };
+
+    static_assert(sizeof(Entry) == 16, "trace records must stay fixed-size");
+
+    explicit TransformTrace(size_t capacity = kDefaultCapacity)
+        : ring_(capacity) {}
+
+    // Copies keep the retained records but not the stream: partition
+    // and batch workers copy the obfuscator, and each copy must open
+    // its own trace file rather than interleave into the source's
+    TransformTrace(const TransformTrace& other)
+        : symbols_(other.symbols_),
+          ring_(other.ring_),
+          head_(other.head_),
+          count_(other.count_),
+          dropped_(other.dropped_) {}
+
+    TransformTrace& operator=(const TransformTrace& other) {
+        if (this != &other) {
+            symbols_ = other.symbols_;
+            ring_ = other.ring_;
+            head_ = other.head_;
+            count_ = other.count_;
+            dropped_ = other.dropped_;
+        }
+        return *this;
+    }
+
+    /**
+     * Stream every record to the given binary trace file
+     */
+    bool openStream(const std::string& path) {
+        stream_.open(path, std::ios::binary | std::ios::trunc);
+        if (!stream_.is_open()) return false;
+
+        stream_.write(kMagic, sizeof(kMagic));
+        stream_.write(reinterpret_cast<const char*>(&kVersion), sizeof(kVersion));
+        strings_streamed_ = 0;
+        return true;
+    }
+
+    void closeStream() {
+        if (stream_.is_open()) stream_.close();
+    }
+
+    bool streaming() const { return stream_.is_open(); }
+
+    /**
+     * Record one transformation (line -1 when not attributable)
+     */
+    void record(std::string_view function, std::string_view pass,
+                std::string_view operation, int line = -1) {
+        Entry entry;
+        entry.function = symbols_.intern(function);
+        entry.pass = symbols_.intern(pass);
+        entry.operation = symbols_.intern(operation);
+        entry.line = line;
+
+        if (count_ < ring_.size()) {
+            ring_[(head_ + count_) % ring_.size()] = entry;
+            count_++;
+        } else if (!ring_.empty()) {
+            ring_[head_] = entry;
+            head_ = (head_ + 1) % ring_.size();
+            dropped_++;
+        }
+
+        if (stream_.is_open()) {
+            streamNewStrings();
+            stream_.put('R');
+            stream_.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+    }
+
+    /**
+     * Visit the retained records oldest-first:
+     * fn(function, pass, operation, line)
+     */
+    template <typename Fn>
+    void forEach(Fn fn) const {
+        for (size_t i = 0; i < count_; i++) {
+            const Entry& e = ring_[(head_ + i) % ring_.size()];
+            fn(symbols_.view(e.function), symbols_.view(e.pass),
+               symbols_.view(e.operation), e.line);
+        }
+    }
+
+    size_t size() const { return count_; }
+    size_t capacity() const { return ring_.size(); }
+    size_t dropped() const { return dropped_; }
+    bool empty() const { return count_ == 0; }
+
+    void clear() {
+        head_ = 0;
+        count_ = 0;
+        dropped_ = 0;
+        // Keep the interner and stream: spellings stay valid across runs
+    }
+
+    /**
+     * Replay a binary trace file, invoking fn per record. Returns false
+     * if the file cannot be opened or the header doesn't match.
+     */
+    static bool readFile(
+        const std::string& path,
+        const std::function<void(std::string_view function,
+                                 std::string_view pass,
+                                 std::string_view operation,
+                                 int line)>& fn) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        char magic[4];
+        uint32_t version = 0;
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        if (!in || std::string_view(magic, 4) != std::string_view(kMagic, 4) ||
+            version != kVersion) {
+            return false;
+        }
+
+        std::vector<std::string> strings;
+        auto spelling = [&](StringInterner::SymbolId id) -> std::string_view {
+            return id < strings.size() ? std::string_view(strings[id])
+                                       : std::string_view("<corrupt>");
+        };
+
+        char tag;
+        while (in.get(tag)) {
+            if (tag == 'S') {
+                uint32_t id = 0, length = 0;
+                in.read(reinterpret_cast<char*>(&id), sizeof(id));
+                in.read(reinterpret_cast<char*>(&length), sizeof(length));
+                std::string text(length, '\0');
+                in.read(text.data(), length);
+                if (!in) break;
+                if (id >= strings.size()) strings.resize(id + 1);
+                strings[id] = std::move(text);
+            } else if (tag == 'R') {
+                Entry e;
+                in.read(reinterpret_cast<char*>(&e), sizeof(e));
+                if (!in) break;
+                fn(spelling(e.function), spelling(e.pass),
+                   spelling(e.operation), e.line);
+            } else {
+                break;  // unknown tag: stop rather than misparse
+            }
+        }
+        return true;
+    }
+
+private:
+    /**
+     * Emit spellings the stream hasn't seen yet (IDs are dense, so new
+     * ones are exactly the tail of the interner)
+     */
+    void streamNewStrings() {
+        while (strings_streamed_ < symbols_.size()) {
+            uint32_t id = static_cast<uint32_t>(strings_streamed_);
+            std::string_view text = symbols_.view(id);
+            uint32_t length = static_cast<uint32_t>(text.size());
+            stream_.put('S');
+            stream_.write(reinterpret_cast<const char*>(&id), sizeof(id));
+            stream_.write(reinterpret_cast<const char*>(&length), sizeof(length));
+            stream_.write(text.data(), length);
+            strings_streamed_++;
+        }
+    }
+
+    StringInterner symbols_;
+    std::vector<Entry> ring_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    size_t dropped_ = 0;
+    std::ofstream stream_;
+    size_t strings_streamed_ = 0;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_TRANSFORM_TRACE_HPP
@@ -0,0 +1,152 @@
+/*
+ * cost_model.hpp
+ *
+ * runtime-overhead cost model for transformation selection
+ *
+ * Per-pass probabilities used to be tuned by trial and error to keep
+ * obfuscated-binary slowdown acceptable. The cost model makes the
+ * trade-off explicit: each transformation family carries an estimated
+ * runtime overhead (cycles per transformed statement) and size overhead
+ * (bytes per transformed statement), the config specifies a per-function
+ * overhead budget, and PassManager charges each pass greedily in pass
+ * order - a pass whose estimate no longer fits is skipped for that
+ * function. Predicted spend vs. budget is reported through Statistics.
+ *
+ * The estimates are coarse by design (flattened dispatch costs far more
+ * than a dead block that never executes); their job is relative ranking
+ * within a budget, not cycle-accurate prediction.
+ */
+
+#ifndef MORPHECT_COST_MODEL_HPP
+#define MORPHECT_COST_MODEL_HPP
+
+#include "pass_registry.hpp"
+
+#include <cstddef>
+
+namespace morphect {
+
+/**
+ * Estimated overhead of one transformation family, per transformed
+ * statement
+ */
+struct TransformCost {
+    double cycles;  // expected runtime cycles added
+    double bytes;   // expected code bytes added
+};
+
+/**
+ * Cost table, indexed like kPassTable
+ */
+constexpr struct {
+    PassId id;
+    TransformCost cost;
+} kCostTable[] = {
+    {PassId::ControlFlow,       {12.0, 40.0}},  // dispatch loop per statement
+    {PassId::CFF,               {12.0, 40.0}},
+    {PassId::BogusControlFlow,  { 6.0, 32.0}},  // opaque predicate + branch
+    {PassId::IndirectCall,      {10.0, 16.0}},  // load + indirect call penalty
+    {PassId::IndirectBranch,    {10.0, 16.0}},
+    {PassId::CallStackObf,      {14.0, 24.0}},
+    {PassId::MBA,               { 8.0, 24.0}},  // variant expansion per op
+    {PassId::ConstantObf,       { 4.0, 16.0}},
+    {PassId::StringEncoding,    { 3.0,  8.0}},  // decode on first touch
+    {PassId::VariableSplitting, { 5.0, 20.0}},
+    {PassId::DeadCode,          { 2.0, 24.0}},  // never executes, but bloats I-cache
+    {PassId::AntiDisasm,        { 1.0,  8.0}},
+    {PassId::X86AntiDisasm,     { 1.0,  8.0}},
+    {PassId::AntiDebug,         { 2.0, 12.0}},
+};
+
+static_assert(sizeof(kCostTable) / sizeof(kCostTable[0]) ==
+              kPassCount - 1,  // Unknown has no estimate
+              "cost table must cover every PassId");
+
+/**
+ * Cost estimate of a built-in pass (zero for Unknown: passes the table
+ * doesn't know are never budget-gated)
+ */
+constexpr TransformCost passCost(PassId id) {
+    for (const auto& entry : kCostTable) {
+        if (entry.id == id) {
+            return entry.cost;
+        }
+    }
+    return {0.0, 0.0};
+}
+
+/**
+ * Passes at or above this estimated cycle cost count as "expensive"
+ * for profile-guided exclusion: flattened dispatch and indirect calls
+ * are what hurt a hot function most, while light MBA or a dead block
+ * stays affordable everywhere.
+ */
+constexpr double kExpensivePassCycles = 10.0;
+
+constexpr bool isExpensivePass(PassId id) {
+    return passCost(id).cycles >= kExpensivePassCycles;
+}
+
+/**
+ * Greedy per-function budget tracker
+ *
+ * PassManager calls beginFunction() once per function, then tryCharge()
+ * per enabled pass in pass order; the first pass that doesn't fit in
+ * the remaining budget is skipped (charging nothing), and later cheaper
+ * passes may still fit. With no budget configured every charge succeeds
+ * and the model only accumulates the prediction.
+ */
+class CostModel {
+public:
+    /**
+     * Per-function overhead budget in estimated cycles (0 = unlimited)
+     */
+    void setBudget(double cycles_per_function) {
+        budget_ = cycles_per_function > 0 ? cycles_per_function : 0.0;
+    }
+
+    double budget() const { return budget_; }
+    bool enabled() const { return budget_ > 0; }
+
+    void beginFunction() {
+        spent_ = 0.0;
+    }
+
+    /**
+     * Charge the estimated overhead of running `id` over a function of
+     * `statements` transformable statements, scaled by the transform
+     * probability. Returns false (and records the skip) when the
+     * remaining budget can't afford it.
+     */
+    bool tryCharge(PassId id, size_t statements, double probability) {
+        double estimate = passCost(id).cycles *
+                          static_cast<double>(statements) * probability;
+        if (budget_ > 0 && spent_ + estimate > budget_) {
+            passes_skipped_++;
+            return false;
+        }
+        spent_ += estimate;
+        predicted_total_ += estimate;
+        return true;
+    }
+
+    double spent() const { return spent_; }
+    double predictedTotal() const { return predicted_total_; }
+    size_t passesSkipped() const { return passes_skipped_; }
+
+    void reset() {
+        spent_ = 0.0;
+        predicted_total_ = 0.0;
+        passes_skipped_ = 0;
+    }
+
+private:
+    double budget_ = 0.0;
+    double spent_ = 0.0;            // current function
+    double predicted_total_ = 0.0;  // whole run
+    size_t passes_skipped_ = 0;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_COST_MODEL_HPP
@@ -8,11 +8,15 @@
 #define MORPHECT_PASS_MANAGER_HPP
 
 #include "transformation_base.hpp"
+#include "pass_registry.hpp"
+#include "cost_model.hpp"
 #include "statistics.hpp"
 #include "../common/logging.hpp"
+#include "../common/arena.hpp"
 
 #include <memory>
 #include <vector>
+#include <array>
 #include <unordered_map>
 #include <algorithm>
 #include <stdexcept>
@@ -23,6 +27,82 @@ struct PassEntry {
     std::unique_ptr<TransformationPass> pass;
     bool enabled;
     int order;
+    PassId id = PassId::Unknown;
+};
+
+/**
+ * Shared per-function analysis cache
+ *
+ * Passes that need the same analysis (e.g. the CFG for function X) can
+ * memoize it here instead of re-scanning the function text. Entries are
+ * type-erased so core doesn't depend on pass-specific result types; the
+ * kind string keys which analysis a value belongs to. A pass that
+ * rewrites a function must call invalidateFunction() so later passes
+ * recompute.
+ */
+class AnalysisCache {
+public:
+    /**
+     * Look up (kind, function); run compute on a miss and cache a
+     * non-null result. Returns nullptr if compute fails.
+     */
+    template<typename T>
+    std::shared_ptr<const T> getOrCompute(
+        const std::string& kind,
+        const std::string& function,
+        const std::function<std::shared_ptr<const T>()>& compute) {
+
+        std::string key = makeKey(kind, function);
+
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            hits_++;
+            return std::static_pointer_cast<const T>(it->second);
+        }
+
+        misses_++;
+        std::shared_ptr<const T> value = compute();
+        if (value) {
+            entries_[key] = value;
+            function_keys_[function].push_back(std::move(key));
+        }
+        return value;
+    }
+
+    /**
+     * Drop all cached analyses for a rewritten function
+     */
+    void invalidateFunction(const std::string& function) {
+        auto it = function_keys_.find(function);
+        if (it == function_keys_.end()) return;
+
+        for (const auto& key : it->second) {
+            entries_.erase(key);
+        }
+        function_keys_.erase(it);
+        invalidations_++;
+    }
+
+    void clear() {
+        entries_.clear();
+        function_keys_.clear();
+    }
+
+    size_t size() const { return entries_.size(); }
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+    size_t invalidations() const { return invalidations_; }
+
+private:
+    static std::string makeKey(const std::string& kind, const std::string& function) {
+        return kind + "@" + function;
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<const void>> entries_;
+    std::unordered_map<std::string, std::vector<std::string>> function_keys_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t invalidations_ = 0;
 };
 
 class PassManager {
@@ -46,9 +126,20 @@ public:
         PassEntry entry;
         entry.pass = std::move(pass);
         entry.enabled = true;
-        entry.order = static_cast<int>(entry.pass->getPriority());
+        entry.id = passIdFromName(name);
 
-        passes_[name] = std::move(entry);
+        // Built-in passes take their priority from the constexpr table
+        if (entry.id != PassId::Unknown) {
+            entry.order = static_cast<int>(passPriority(entry.id));
+        } else {
+            entry.order = static_cast<int>(entry.pass->getPriority());
+        }
+
+        auto& slot = passes_[name];
+        slot = std::move(entry);
+        if (slot.id != PassId::Unknown) {
+            by_id_[static_cast<size_t>(slot.id)] = slot.pass.get();
+        }
         pass_order_dirty_ = true;
 
         logger_.debug("Registered pass: {}", name);
@@ -62,6 +153,16 @@ public:
         return nullptr;
     }
 
+    /**
+     * ID-based lookup: one array index, no hashing
+     */
+    TransformationPass* getPass(PassId id) {
+        if (id == PassId::Unknown || id >= PassId::Count) {
+            return nullptr;
+        }
+        return by_id_[static_cast<size_t>(id)];
+    }
+
     bool setPassEnabled(const std::string& name, bool enabled) {
         auto it = passes_.find(name);
         if (it != passes_.end()) {
@@ -77,19 +178,40 @@ public:
         pass_order_dirty_ = true;
     }
 
+    /**
+     * Exempt these (profile-hot) functions from expensive passes: the
+     * next initialize() appends them to the exclude list of every pass
+     * whose cost estimate crosses kExpensivePassCycles, so cheap passes
+     * still obfuscate them. Call before initialize().
+     */
+    void setHotFunctionExclusions(std::vector<std::string> names) {
+        hot_function_exclusions_ = std::move(names);
+    }
+
     bool initialize(const PassConfig& config) {
         global_config_ = config;
         bool success = true;
 
         for (auto& [name, entry] : passes_) {
-            if (!entry.pass->initialize(config)) {
+            PassConfig pass_config = config;
+            if (!hot_function_exclusions_.empty() && isExpensivePass(entry.id)) {
+                pass_config.exclude_functions.insert(
+                    pass_config.exclude_functions.end(),
+                    hot_function_exclusions_.begin(),
+                    hot_function_exclusions_.end());
+            }
+            if (!entry.pass->initialize(pass_config)) {
                 logger_.error("Failed to initialize pass: {}", name);
                 success = false;
             } else {
                 logger_.debug("Initialized pass: {}", name);
             }
+            entry.pass->setAnalysisCache(&analysis_cache_);
+            entry.pass->setScratchArena(&scratch_arena_);
         }
 
+        cost_model_.setBudget(config.overhead_budget);
+
         computePassOrder();
         return success;
     }
@@ -107,14 +229,21 @@ public:
         }
 
         int total_transforms = 0;
+        cost_model_.beginFunction();
 
-        for (const auto& name : ordered_passes_) {
-            auto& entry = passes_[name];
-            if (!entry.enabled) continue;
+        // indexed loop - this runs per function compiled in the plugin
+        for (PassEntry* entry : ordered_entries_) {
+            if (!entry->enabled) continue;
 
             // no RTTI in gcc plugins so we use static dispatch
-            if (entry.pass->getPassType() == PassType::Gimple) {
-                auto* gimple_pass = static_cast<GimpleTransformationPass*>(entry.pass.get());
+            if (entry->pass->getPassType() == PassType::Gimple) {
+                // Overhead budget only binds through the summary-gated
+                // variant, which knows the statement count
+                if (!cost_model_.tryCharge(entry->id, current_function_statements_,
+                                           global_config_.probability)) {
+                    continue;
+                }
+                auto* gimple_pass = static_cast<GimpleTransformationPass*>(entry->pass.get());
                 auto result = gimple_pass->transformGimple(func);
                 if (result == TransformResult::Success) {
                     total_transforms++;
@@ -122,23 +251,57 @@ public:
             }
         }
 
+        scratch_arena_.reset();  // scratch is per function by contract
         functions_processed_++;
         return total_transforms;
     }
 
+    /**
+     * Summary-gated variant: the caller gathers statement and opcode
+     * counts once, and functions under the configured thresholds skip
+     * pass dispatch entirely.
+     */
+    int runGimplePasses(void* func, const GimpleFunctionSummary& summary) {
+        if ((global_config_.min_function_statements > 0 &&
+             summary.statements < global_config_.min_function_statements) ||
+            (global_config_.min_transformable_ops > 0 &&
+             summary.transformable_ops < global_config_.min_transformable_ops)) {
+            functions_skipped_trivial_++;
+            return 0;
+        }
+        current_function_statements_ = static_cast<size_t>(summary.statements);
+        int total = runGimplePasses(func);
+        current_function_statements_ = 0;
+        return total;
+    }
+
+    size_t functionsSkippedTrivial() const { return functions_skipped_trivial_; }
+
     int runLLVMPasses(std::vector<std::string>& lines) {
         if (pass_order_dirty_) {
             computePassOrder();
         }
 
+        if (fuse_line_local_) {
+            return runLLVMPassesFused(lines);
+        }
+
         int total_transforms = 0;
+        cost_model_.beginFunction();
 
-        for (const auto& name : ordered_passes_) {
-            auto& entry = passes_[name];
-            if (!entry.enabled) continue;
+        for (PassEntry* entry : ordered_entries_) {
+            if (!entry->enabled) continue;
 
-            if (entry.pass->getPassType() == PassType::LLVM) {
-                auto* llvm_pass = static_cast<LLVMTransformationPass*>(entry.pass.get());
+            if (entry->pass->getPassType() == PassType::LLVM) {
+                if (isInapplicable(entry->pass.get())) {
+                    passes_skipped_inapplicable_++;
+                    continue;
+                }
+                if (!cost_model_.tryCharge(entry->id, lines.size(),
+                                           global_config_.probability)) {
+                    continue;
+                }
+                auto* llvm_pass = static_cast<LLVMTransformationPass*>(entry->pass.get());
                 auto result = llvm_pass->transformIR(lines);
                 if (result == TransformResult::Success) {
                     total_transforms++;
@@ -146,6 +309,113 @@ public:
             }
         }
 
+        scratch_arena_.reset();  // scratch is per function by contract
+        functions_processed_++;
+        return total_transforms;
+    }
+
+    /**
+     * Summary-gated variant: the caller supplies the function's
+     * ir_features bitmap (from its tokenize sweep or a cheap pre-scan)
+     * and passes whose requiredFeatures() cannot match skip dispatch
+     * without touching the text. Mirrors the gimple summary gate.
+     */
+    int runLLVMPasses(std::vector<std::string>& lines, uint32_t features) {
+        current_function_features_ = features;
+        has_function_features_ = true;
+        int total = runLLVMPasses(lines);
+        has_function_features_ = false;
+        return total;
+    }
+
+    size_t passesSkippedInapplicable() const { return passes_skipped_inapplicable_; }
+
+    /**
+     * Enable pipeline fusion: line-local LLVM passes share one module
+     * sweep instead of each traversing all lines
+     */
+    void setFusionEnabled(bool enabled) {
+        fuse_line_local_ = enabled;
+    }
+
+    /**
+     * Fused execution: one sweep consults every line-local pass per line
+     * (in pass order, first match wins per line); whole-function passes
+     * like CFF still run as separate sweeps afterwards.
+     */
+    int runLLVMPassesFused(std::vector<std::string>& lines) {
+        if (pass_order_dirty_) {
+            computePassOrder();
+        }
+
+        std::vector<LLVMTransformationPass*> line_local;
+        std::vector<LLVMTransformationPass*> whole_function;
+        cost_model_.beginFunction();
+
+        for (PassEntry* entry : ordered_entries_) {
+            if (!entry->enabled) continue;
+            if (entry->pass->getPassType() != PassType::LLVM) continue;
+            if (isInapplicable(entry->pass.get())) {
+                passes_skipped_inapplicable_++;
+                continue;
+            }
+            if (!cost_model_.tryCharge(entry->id, lines.size(),
+                                       global_config_.probability)) {
+                continue;
+            }
+
+            auto* llvm_pass = static_cast<LLVMTransformationPass*>(entry->pass.get());
+            if (llvm_pass->isLineLocal()) {
+                line_local.push_back(llvm_pass);
+            } else {
+                whole_function.push_back(llvm_pass);
+            }
+        }
+
+        int total_transforms = 0;
+
+        if (!line_local.empty()) {
+            std::vector<std::string> fused;
+            fused.reserve(lines.size());
+            std::vector<std::string> replacement;
+            int line_transforms = 0;
+
+            for (auto& line : lines) {
+                bool transformed = false;
+                for (auto* pass : line_local) {
+                    replacement.clear();
+                    if (pass->transformLineIR(line, replacement)) {
+                        for (auto& r : replacement) {
+                            fused.push_back(std::move(r));
+                        }
+                        line_transforms++;
+                        transformed = true;
+                        break;
+                    }
+                }
+                if (!transformed) {
+                    fused.push_back(std::move(line));
+                }
+            }
+
+            lines = std::move(fused);
+
+            if (line_transforms > 0) {
+                LLVMTransformationPass::renumberModuleSSA(lines);
+                total_transforms++;
+            }
+
+            logger_.debug("Fused sweep: {} passes, {} line transformations",
+                          line_local.size(), line_transforms);
+        }
+
+        for (auto* pass : whole_function) {
+            if (pass->transformIR(lines) == TransformResult::Success) {
+                total_transforms++;
+            }
+        }
+
+        scratch_arena_.reset();  // scratch is per function by contract
         functions_processed_++;
         return total_transforms;
     }
@@ -156,13 +426,17 @@ public:
         }
 
         int total_transforms = 0;
+        cost_model_.beginFunction();
 
-        for (const auto& name : ordered_passes_) {
-            auto& entry = passes_[name];
-            if (!entry.enabled) continue;
+        for (PassEntry* entry : ordered_entries_) {
+            if (!entry->enabled) continue;
 
-            if (entry.pass->getPassType() == PassType::Assembly) {
-                auto* asm_pass = static_cast<AssemblyTransformationPass*>(entry.pass.get());
+            if (entry->pass->getPassType() == PassType::Assembly) {
+                if (!cost_model_.tryCharge(entry->id, lines.size(),
+                                           global_config_.probability)) {
+                    continue;
+                }
+                auto* asm_pass = static_cast<AssemblyTransformationPass*>(entry->pass.get());
                 auto result = asm_pass->transformAssembly(lines, arch);
                 if (result == TransformResult::Success) {
                     total_transforms++;
@@ -170,6 +444,7 @@ public:
             }
         }
 
+        scratch_arena_.reset();  // scratch is per function by contract
         functions_processed_++;
         return total_transforms;
     }
@@ -185,6 +460,17 @@ public:
 
         stats.set("functions_processed", functions_processed_);
         stats.set("passes_registered", static_cast<int>(passes_.size()));
+        stats.set("passes_skipped_inapplicable",
+                  static_cast<int>(passes_skipped_inapplicable_));
+
+        // Predicted vs. budget: how much estimated overhead the selected
+        // transformations add, and how often the budget said no
+        stats.set("cost_model.predicted_cycles", cost_model_.predictedTotal());
+        if (cost_model_.enabled()) {
+            stats.set("cost_model.budget_per_function", cost_model_.budget());
+            stats.set("cost_model.passes_skipped_budget",
+                      static_cast<int>(cost_model_.passesSkipped()));
+        }
 
         for (const auto& [name, entry] : passes_) {
             auto pass_stats = entry.pass->getStatistics();
@@ -200,10 +486,16 @@ public:
         logger_.info("=== Morphect Obfuscation Statistics ===");
         logger_.info("Functions processed: {}", functions_processed_);
         logger_.info("Passes registered: {}", passes_.size());
+        if (cost_model_.enabled()) {
+            logger_.info("Predicted overhead: {} cycles (budget {} per function, {} passes skipped)",
+                         cost_model_.predictedTotal(), cost_model_.budget(),
+                         cost_model_.passesSkipped());
+        }
         logger_.info("");
 
-        for (const auto& name : ordered_passes_) {
-            auto& entry = passes_[name];
+        for (size_t i = 0; i < ordered_entries_.size(); i++) {
+            const PassEntry& entry = *ordered_entries_[i];
+            const std::string& name = ordered_passes_[i];
             auto stats = entry.pass->getStatistics();
 
             if (stats.empty()) continue;
@@ -219,11 +511,29 @@ public:
 
     void resetStatistics() {
         functions_processed_ = 0;
+        functions_skipped_trivial_ = 0;
+        passes_skipped_inapplicable_ = 0;
+        cost_model_.reset();
         for (auto& [name, entry] : passes_) {
             entry.pass->resetStatistics();
         }
     }
 
+    /**
+     * Shared analysis cache for the registered passes
+     */
+    AnalysisCache& analysisCache() { return analysis_cache_; }
+
+    /**
+     * Per-function scratch arena, reset after each function
+     */
+    Arena& scratchArena() { return scratch_arena_; }
+
+    /**
+     * Runtime-overhead cost model (budget from PassConfig.overhead_budget)
+     */
+    const CostModel& costModel() const { return cost_model_; }
+
     std::vector<std::string> getRegisteredPasses() const {
         std::vector<std::string> names;
         for (const auto& [name, entry] : passes_) {
@@ -234,10 +544,31 @@ public:
 
 private:
     std::unordered_map<std::string, PassEntry> passes_;
-    std::vector<std::string> ordered_passes_;
+    std::vector<std::string> ordered_passes_;       // names, for reports
+    std::vector<PassEntry*> ordered_entries_;       // same order, for dispatch
+    std::array<TransformationPass*, kPassCount> by_id_{};
     std::vector<std::string> custom_order_;
+    std::vector<std::string> hot_function_exclusions_;
     bool pass_order_dirty_ = true;
+    bool fuse_line_local_ = false;
+    AnalysisCache analysis_cache_;
+    Arena scratch_arena_;
+    CostModel cost_model_;
+    size_t current_function_statements_ = 0;  // set by the summary-gated gimple path
+    uint32_t current_function_features_ = 0;  // set by the summary-gated LLVM path
+    bool has_function_features_ = false;
+    size_t passes_skipped_inapplicable_ = 0;
+
+    /**
+     * True when the current function's feature bitmap rules the pass out
+     */
+    bool isInapplicable(const TransformationPass* pass) const {
+        if (!has_function_features_) return false;
+        uint32_t required = pass->requiredFeatures();
+        return required != 0 && (required & current_function_features_) == 0;
+    }
     int functions_processed_ = 0;
+    size_t functions_skipped_trivial_ = 0;
     PassConfig global_config_;
     Logger logger_;
 
@@ -275,6 +606,12 @@ private:
 
         resolveDependencies();
 
+        // Dispatch walks entry pointers; names stay for reports only
+        ordered_entries_.clear();
+        for (const auto& name : ordered_passes_) {
+            ordered_entries_.push_back(&passes_[name]);
+        }
+
         pass_order_dirty_ = false;
 
         logger_.debug("Pass order computed:");
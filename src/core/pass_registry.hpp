@@ -0,0 +1,122 @@
+/*
+ * pass_registry.hpp
+ *
+ * compile-time registry of the built-in passes
+ *
+ * Pass IDs are a dense enum and the descriptor table is constexpr, so
+ * ID-based dispatch is an array index instead of a hash lookup - this
+ * matters in the GCC plugin where dispatch runs per function compiled.
+ * String names stay around only for config parsing and reports.
+ */
+
+#ifndef MORPHECT_PASS_REGISTRY_HPP
+#define MORPHECT_PASS_REGISTRY_HPP
+
+#include "transformation_base.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+namespace morphect {
+
+/**
+ * Dense IDs for the built-in passes
+ */
+enum class PassId : uint8_t {
+    ControlFlow = 0,    // Gimple control flow flattening
+    CFF,                // LLVM control flow flattening
+    BogusControlFlow,
+    IndirectCall,
+    IndirectBranch,
+    CallStackObf,
+    MBA,
+    ConstantObf,
+    StringEncoding,
+    VariableSplitting,
+    DeadCode,
+    AntiDisasm,
+    X86AntiDisasm,
+    AntiDebug,
+
+    Unknown,            // Registered under a name the table doesn't know
+    Count
+};
+
+constexpr size_t kPassCount = static_cast<size_t>(PassId::Count);
+
+/**
+ * Compile-time descriptor for one built-in pass
+ */
+struct PassDescriptor {
+    PassId id;
+    const char* name;
+    PassPriority priority;
+};
+
+/**
+ * Descriptor table, indexed by PassId
+ */
+constexpr PassDescriptor kPassTable[] = {
+    {PassId::ControlFlow,       "ControlFlow",       PassPriority::ControlFlow},
+    {PassId::CFF,               "CFF",               PassPriority::ControlFlow},
+    {PassId::BogusControlFlow,  "BogusControlFlow",  PassPriority::ControlFlow},
+    {PassId::IndirectCall,      "IndirectCall",      PassPriority::ControlFlow},
+    {PassId::IndirectBranch,    "IndirectBranch",    PassPriority::ControlFlow},
+    {PassId::CallStackObf,      "CallStackObf",      PassPriority::ControlFlow},
+    {PassId::MBA,               "MBA",               PassPriority::MBA},
+    {PassId::ConstantObf,       "ConstantObf",       PassPriority::Data},
+    {PassId::StringEncoding,    "StringEncoding",    PassPriority::Data},
+    {PassId::VariableSplitting, "VariableSplitting", PassPriority::Data},
+    {PassId::DeadCode,          "DeadCode",          PassPriority::Late},
+    {PassId::AntiDisasm,        "AntiDisasm",        PassPriority::Late},
+    {PassId::X86AntiDisasm,     "X86_AntiDisasm",    PassPriority::Late},
+    {PassId::AntiDebug,         "AntiDebug",         PassPriority::Late},
+};
+
+static_assert(sizeof(kPassTable) / sizeof(kPassTable[0]) ==
+              kPassCount - 1,  // Unknown has no descriptor
+              "descriptor table must cover every PassId");
+
+/**
+ * Name of a built-in pass (nullptr for Unknown)
+ */
+constexpr const char* passName(PassId id) {
+    for (const auto& desc : kPassTable) {
+        if (desc.id == id) {
+            return desc.name;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Priority of a built-in pass (Normal for Unknown)
+ */
+constexpr PassPriority passPriority(PassId id) {
+    for (const auto& desc : kPassTable) {
+        if (desc.id == id) {
+            return desc.priority;
+        }
+    }
+    return PassPriority::Normal;
+}
+
+/**
+ * Resolve a config/report name to its ID (Unknown if not built in)
+ *
+ * Only used when parsing configs and registering passes; per-function
+ * dispatch never touches names.
+ */
+constexpr PassId passIdFromName(std::string_view name) {
+    for (const auto& desc : kPassTable) {
+        if (name == desc.name) {
+            return desc.id;
+        }
+    }
+    return PassId::Unknown;
+}
+
+} // namespace morphect
+
+#endif // MORPHECT_PASS_REGISTRY_HPP
@@ -20,6 +20,19 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 namespace morphect {
 
@@ -326,6 +339,545 @@ private:
     std::unordered_map<std::string, std::string> string_stats_;
 };
 
+/**
+ * Process memory readings from /proc/self/status
+ *
+ * peakRssKb is the VmHWM high-water mark: sampling it before and after
+ * a pass attributes peak-memory growth to the pass that caused it,
+ * which is what you need when a run gets OOM-killed and the per-pass
+ * time table gives no hint where the memory went.
+ */
+class MemoryTracker {
+public:
+    /**
+     * Peak resident set size (VmHWM) in KiB, 0 if unavailable
+     */
+    static size_t peakRssKb() {
+        return readStatusKb("VmHWM:");
+    }
+
+    /**
+     * Current resident set size (VmRSS) in KiB, 0 if unavailable
+     */
+    static size_t currentRssKb() {
+        return readStatusKb("VmRSS:");
+    }
+
+private:
+    static size_t readStatusKb(const char* field) {
+        std::ifstream status("/proc/self/status");
+        if (!status.is_open()) return 0;
+
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, std::char_traits<char>::length(field), field) == 0) {
+                std::istringstream iss(line.substr(
+                    std::char_traits<char>::length(field)));
+                size_t kb = 0;
+                iss >> kb;
+                return kb;
+            }
+        }
+        return 0;
+    }
+};
+
+/**
+ * Optional allocation counters
+ *
+ * The counters are always available; they only tick when a target
+ * compiles src/core/allocation_hook.inc into exactly one translation
+ * unit (guarded by MORPHECT_COUNT_ALLOCATIONS), which replaces global
+ * operator new/delete with counting versions.
+ */
+class AllocationCounter {
+public:
+    static std::atomic<size_t>& count() {
+        static std::atomic<size_t> instance{0};
+        return instance;
+    }
+
+    static std::atomic<size_t>& bytes() {
+        static std::atomic<size_t> instance{0};
+        return instance;
+    }
+
+    static void record(size_t size) {
+        count().fetch_add(1, std::memory_order_relaxed);
+        bytes().fetch_add(size, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Timeline trace recorder (chrome://tracing / Perfetto JSON)
+ *
+ * Optionally records begin/end events — pass x function — with
+ * microsecond timestamps and the recording thread's id, and exports
+ * them in the Trace Event Format so a run can be loaded into a timeline
+ * viewer. Disabled by default: begin/end are no-ops until enable() so
+ * the hot path costs one branch when tracing is off.
+ */
+class TraceRecorder {
+public:
+    static TraceRecorder& get() {
+        static TraceRecorder instance;
+        return instance;
+    }
+
+    void enable() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        origin_ = std::chrono::steady_clock::now();
+        events_.clear();
+        enabled_.store(true, std::memory_order_relaxed);
+    }
+
+    void disable() {
+        enabled_.store(false, std::memory_order_relaxed);
+    }
+
+    bool enabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void begin(const std::string& name, const std::string& category) {
+        record('B', name, category);
+    }
+
+    void end(const std::string& name, const std::string& category) {
+        record('E', name, category);
+    }
+
+    /**
+     * Export all recorded events as Trace Event Format JSON
+     */
+    std::string toJson() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        std::ostringstream oss;
+        oss << "{\"traceEvents\":[" << std::endl;
+        for (size_t i = 0; i < events_.size(); i++) {
+            const Event& e = events_[i];
+            oss << "  {\"name\":\"" << e.name
+                << "\",\"cat\":\"" << e.category
+                << "\",\"ph\":\"" << e.phase
+                << "\",\"ts\":" << std::fixed << std::setprecision(3) << e.ts_us
+                << ",\"pid\":1,\"tid\":" << e.tid << "}";
+            if (i + 1 < events_.size()) oss << ",";
+            oss << std::endl;
+        }
+        oss << "]}" << std::endl;
+        return oss.str();
+    }
+
+    size_t eventCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_.size();
+    }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+private:
+    TraceRecorder() = default;
+
+    struct Event {
+        char phase;
+        std::string name;
+        std::string category;
+        double ts_us;
+        uint64_t tid;
+    };
+
+    std::atomic<bool> enabled_{false};
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+    std::chrono::steady_clock::time_point origin_;
+
+    void record(char phase, const std::string& name, const std::string& category) {
+        if (!enabled()) return;
+
+        auto now = std::chrono::steady_clock::now();
+        Event e;
+        e.phase = phase;
+        e.name = name;
+        e.category = category;
+        e.tid = std::hash<std::thread::id>{}(std::this_thread::get_id()) % 100000;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        e.ts_us = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      now - origin_).count() / 1000.0;
+        events_.push_back(std::move(e));
+    }
+};
+
+/**
+ * RAII begin/end pair for the trace recorder
+ */
+class ScopedTrace {
+public:
+    ScopedTrace(const std::string& name, const std::string& category)
+        : name_(name), category_(category) {
+        TraceRecorder::get().begin(name_, category_);
+    }
+
+    ~ScopedTrace() {
+        TraceRecorder::get().end(name_, category_);
+    }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    std::string name_;
+    std::string category_;
+};
+
+/**
+ * Per-thread sharded statistics
+ *
+ * Recording goes to a thread-local Statistics shard, so the hot path is
+ * an uncontended map update with no locking and no cache-line
+ * ping-pong between workers. Shards are merged once at report time via
+ * snapshot(). The registry mutex is only taken when a thread touches an
+ * instance for the first time and when snapshotting.
+ */
+class ShardedStatistics {
+public:
+    ShardedStatistics() : id_(next_id_.fetch_add(1)) {}
+
+    ShardedStatistics(const ShardedStatistics&) = delete;
+    ShardedStatistics& operator=(const ShardedStatistics&) = delete;
+
+    /**
+     * This thread's shard (created and registered on first use)
+     */
+    Statistics& local() {
+        // Keyed by instance id rather than address, so a recycled
+        // allocation can never alias a stale thread-local entry
+        thread_local std::unordered_map<uint64_t, std::shared_ptr<Statistics>> tls_shards;
+
+        auto& slot = tls_shards[id_];
+        if (!slot) {
+            slot = std::make_shared<Statistics>();
+            std::lock_guard<std::mutex> lock(registry_mutex_);
+            shards_.push_back(slot);
+        }
+        return *slot;
+    }
+
+    // hot-path convenience forwarders
+    void increment(const std::string& name, int amount = 1) {
+        local().increment(name, amount);
+    }
+
+    void add(const std::string& name, double amount) {
+        local().add(name, amount);
+    }
+
+    /**
+     * Merge every thread's shard into one report-time view
+     */
+    Statistics snapshot() const {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        Statistics merged;
+        for (const auto& shard : shards_) {
+            merged.merge(*shard);
+        }
+        return merged;
+    }
+
+    /**
+     * Clear all shards (counters reset, registrations kept)
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        for (const auto& shard : shards_) {
+            shard->clear();
+        }
+    }
+
+    size_t shardCount() const {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        return shards_.size();
+    }
+
+private:
+    uint64_t id_;
+    mutable std::mutex registry_mutex_;
+    std::vector<std::shared_ptr<Statistics>> shards_;
+
+    static inline std::atomic<uint64_t> next_id_{0};
+};
+
+/**
+ * Cross-process statistics aggregation
+ *
+ * Parallel builds run one compiler process per translation unit, each
+ * with its own Statistics instance. StatRecordFile lets every process
+ * dump its integer counters into one shared per-build file without
+ * locking: the whole batch goes out in a single write(2) on a
+ * descriptor opened with O_APPEND, where the kernel applies the offset
+ * update atomically, so records from concurrent writers never
+ * interleave. morphect-stats reads record files back and merges them
+ * into the standard report format.
+ */
+class StatRecordFile {
+public:
+    /**
+     * Fixed-size on-disk record: NUL-padded counter name + 64-bit value
+     */
+    struct Record {
+        char name[56];
+        int64_t value;
+    };
+
+    static_assert(sizeof(Record) == 64, "stat records must stay fixed-size");
+
+    /**
+     * Append all integer counters in `stats` to `path` as one atomic
+     * O_APPEND write. Names longer than the record field are truncated.
+     */
+    static bool append(const std::string& path, const Statistics& stats) {
+        const auto& ints = stats.getIntStats();
+        if (ints.empty()) return true;
+
+        std::vector<Record> records;
+        records.reserve(ints.size());
+        for (const auto& [name, value] : ints) {
+            Record r{};
+            std::strncpy(r.name, name.c_str(), sizeof(r.name) - 1);
+            r.value = value;
+            records.push_back(r);
+        }
+
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) return false;
+
+        const char* data = reinterpret_cast<const char*>(records.data());
+        size_t remaining = records.size() * sizeof(Record);
+        bool ok = true;
+        while (remaining > 0) {
+            ssize_t n = ::write(fd, data, remaining);
+            if (n < 0) {
+                ok = false;
+                break;
+            }
+            data += n;
+            remaining -= static_cast<size_t>(n);
+        }
+        ::close(fd);
+        return ok;
+    }
+
+    /**
+     * Read every record in `path` and accumulate it into `into`.
+     * Returns false if the file cannot be opened; a trailing partial
+     * record (which a single-write append never produces) is ignored.
+     */
+    static bool read(const std::string& path, Statistics& into) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) return false;
+
+        Record r;
+        while (in.read(reinterpret_cast<char*>(&r), sizeof(r))) {
+            r.name[sizeof(r.name) - 1] = '\0';
+            into.increment(r.name, static_cast<int>(r.value));
+        }
+        return true;
+    }
+};
+
+/**
+ * Fleet metrics export (Prometheus textfile / StatsD)
+ *
+ * A build farm running thousands of obfuscation jobs a day needs the
+ * counters on a dashboard, not in per-run stderr logs. The exporter
+ * renders a Statistics snapshot either as a Prometheus text file (for
+ * node_exporter's textfile collector) or as StatsD datagrams pushed
+ * over UDP. Every sample carries target and config labels so runs
+ * aggregate per configuration instead of smearing into one series.
+ */
+class MetricsExporter {
+public:
+    MetricsExporter(std::string target, std::string config_hash)
+        : target_(std::move(target)), config_hash_(std::move(config_hash)) {}
+
+    /**
+     * Render in the Prometheus text exposition format. Integer counters
+     * become morphect_<name>_total, doubles become gauges; names are
+     * sanitized to the allowed [a-zA-Z0-9_] alphabet and emitted in
+     * sorted order so successive runs diff cleanly.
+     */
+    std::string toPrometheus(const Statistics& stats) const {
+        std::ostringstream oss;
+        std::string labels = "{target=\"" + escapeLabel(target_)
+                           + "\",config=\"" + escapeLabel(config_hash_) + "\"}";
+
+        for (const auto& [name, value] : sorted(stats.getIntStats())) {
+            std::string metric = "morphect_" + sanitizeName(name) + "_total";
+            oss << "# TYPE " << metric << " counter\n";
+            oss << metric << labels << " " << value << "\n";
+        }
+        for (const auto& [name, value] : sorted(stats.getDoubleStats())) {
+            std::string metric = "morphect_" + sanitizeName(name);
+            oss << "# TYPE " << metric << " gauge\n";
+            oss << metric << labels << " "
+                << std::fixed << std::setprecision(4) << value << "\n";
+        }
+        return oss.str();
+    }
+
+    /**
+     * Write the Prometheus rendering to `path` atomically (temp file +
+     * rename) — the textfile collector scrapes on its own schedule and
+     * must never see a half-written file.
+     */
+    bool writePrometheusFile(const std::string& path, const Statistics& stats) const {
+        std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::trunc);
+            if (!out.is_open()) return false;
+            out << toPrometheus(stats);
+            if (!out.good()) {
+                out.close();
+                std::remove(tmp.c_str());
+                return false;
+            }
+        }
+        if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Render as StatsD datagram payloads: integer counters as |c,
+     * timings (name contains "time") as |ms, other doubles as |g, each
+     * tagged |#target:...,config:... . Metrics are batched
+     * newline-separated up to kMaxDatagram bytes per payload so a run
+     * costs a handful of packets, not one per counter.
+     */
+    std::vector<std::string> toStatsdPayloads(const Statistics& stats) const {
+        std::string tags = "|#target:" + sanitizeTag(target_)
+                         + ",config:" + sanitizeTag(config_hash_);
+
+        std::vector<std::string> metrics;
+        for (const auto& [name, value] : sorted(stats.getIntStats())) {
+            metrics.push_back("morphect." + sanitizeName(name) + ":"
+                              + std::to_string(value) + "|c" + tags);
+        }
+        for (const auto& [name, value] : sorted(stats.getDoubleStats())) {
+            std::ostringstream v;
+            v << std::fixed << std::setprecision(4) << value;
+            const char* type = name.find("time") != std::string::npos ? "|ms" : "|g";
+            metrics.push_back("morphect." + sanitizeName(name) + ":"
+                              + v.str() + type + tags);
+        }
+
+        std::vector<std::string> payloads;
+        for (const auto& metric : metrics) {
+            if (payloads.empty() ||
+                payloads.back().size() + 1 + metric.size() > kMaxDatagram) {
+                payloads.push_back(metric);
+            } else {
+                payloads.back() += "\n" + metric;
+            }
+        }
+        return payloads;
+    }
+
+    /**
+     * Push to a StatsD daemon at "host:port" over UDP. Fire-and-forget
+     * by design: returns false only when the address cannot be resolved
+     * or the socket cannot be created — a dropped packet is the
+     * protocol's accepted failure mode, never the build's.
+     */
+    bool pushStatsd(const std::string& host_port, const Statistics& stats) const {
+        size_t colon = host_port.rfind(':');
+        if (colon == std::string::npos || colon + 1 >= host_port.size()) {
+            return false;
+        }
+        std::string host = host_port.substr(0, colon);
+        std::string port = host_port.substr(colon + 1);
+
+        struct addrinfo hints {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_DGRAM;
+        struct addrinfo* addr = nullptr;
+        if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &addr) != 0 ||
+            addr == nullptr) {
+            return false;
+        }
+
+        int fd = ::socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if (fd < 0) {
+            ::freeaddrinfo(addr);
+            return false;
+        }
+
+        for (const auto& payload : toStatsdPayloads(stats)) {
+            ::sendto(fd, payload.data(), payload.size(), 0,
+                     addr->ai_addr, addr->ai_addrlen);
+        }
+
+        ::close(fd);
+        ::freeaddrinfo(addr);
+        return true;
+    }
+
+private:
+    // Batched payloads stay under a typical MTU so datagrams never
+    // fragment on the way to the collector
+    static constexpr size_t kMaxDatagram = 1400;
+
+    std::string target_;
+    std::string config_hash_;
+
+    static std::string sanitizeName(const std::string& name) {
+        std::string out = name;
+        for (char& c : out) {
+            bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                      (c >= '0' && c <= '9') || c == '_';
+            if (!ok) c = '_';
+        }
+        return out;
+    }
+
+    static std::string escapeLabel(const std::string& value) {
+        std::string out;
+        out.reserve(value.size());
+        for (char c : value) {
+            if (c == '\\' || c == '"') out += '\\';
+            if (c == '\n') {
+                out += "\\n";
+                continue;
+            }
+            out += c;
+        }
+        return out;
+    }
+
+    // Tag values share the datagram with protocol delimiters
+    static std::string sanitizeTag(const std::string& value) {
+        std::string out = value;
+        for (char& c : out) {
+            if (c == ':' || c == '|' || c == ',' || c == '#' || c == '\n') c = '_';
+        }
+        return out;
+    }
+
+    template <typename Map>
+    static std::vector<std::pair<std::string, typename Map::mapped_type>>
+    sorted(const Map& map) {
+        std::vector<std::pair<std::string, typename Map::mapped_type>> entries(
+            map.begin(), map.end());
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+        return entries;
+    }
+};
+
 /**
  * Global statistics singleton for convenience
  */
@@ -0,0 +1,177 @@
+/*
+ * task_scheduler.hpp
+ *
+ * work-stealing scheduler for the pass x function task graph
+ *
+ * Static partitioning of functions across workers is defeated by skew:
+ * one 50k-line function pins a worker while the rest idle. Modeling
+ * (pass, function) as a task with dependency edges lets a big function
+ * decompose into stealable stages - pass ordering becomes a chain of
+ * edges, and idle workers steal ready stages from busy ones, so all
+ * cores stay busy to the end of the run.
+ */
+
+#ifndef MORPHECT_TASK_SCHEDULER_HPP
+#define MORPHECT_TASK_SCHEDULER_HPP
+
+#include "../common/locale_prime.hpp"
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstddef>
+
+namespace morphect {
+
+/**
+ * Dependency-aware work-stealing task pool
+ *
+ * Build the whole graph with addTask() (dependencies must already have
+ * IDs, so graphs are acyclic by construction), then run() it. Each
+ * worker owns a deque: it pushes and pops ready work at the back, and
+ * idle workers steal from the front of the busiest-looking victim.
+ * Tasks a worker unblocks go to its own deque for locality.
+ */
+class WorkStealingScheduler {
+public:
+    using TaskId = size_t;
+    using TaskFn = std::function<void()>;
+
+    /**
+     * Add a task that runs after all of its dependencies
+     */
+    TaskId addTask(TaskFn fn, const std::vector<TaskId>& deps = {}) {
+        TaskId id = tasks_.size();
+        tasks_.emplace_back(std::move(fn), static_cast<int>(deps.size()));
+        for (TaskId dep : deps) {
+            tasks_[dep].dependents.push_back(id);
+        }
+        return id;
+    }
+
+    size_t taskCount() const { return tasks_.size(); }
+
+    /**
+     * Run the graph to completion on the given number of workers
+     */
+    void run(size_t workers) {
+        if (tasks_.empty()) return;
+        if (workers == 0) workers = 1;
+        if (workers > tasks_.size()) workers = tasks_.size();
+
+        queues_.clear();
+        for (size_t w = 0; w < workers; w++) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+        remaining_.store(tasks_.size());
+
+        // Seed the queues round-robin with the initially ready tasks
+        size_t next_queue = 0;
+        for (TaskId id = 0; id < tasks_.size(); id++) {
+            if (tasks_[id].pending.load() == 0) {
+                pushTask(next_queue, id);
+                next_queue = (next_queue + 1) % workers;
+            }
+        }
+
+        primeLocaleCaches();
+
+        std::vector<std::thread> pool;
+        pool.reserve(workers);
+        for (size_t w = 0; w < workers; w++) {
+            pool.emplace_back([this, w, workers]() { workerLoop(w, workers); });
+        }
+        for (auto& t : pool) {
+            t.join();
+        }
+
+        tasks_.clear();
+        queues_.clear();
+    }
+
+private:
+    struct Task {
+        TaskFn fn;
+        std::atomic<int> pending;
+        std::vector<TaskId> dependents;
+
+        Task(TaskFn f, int deps) : fn(std::move(f)), pending(deps) {}
+    };
+
+    struct WorkQueue {
+        std::deque<TaskId> ready;
+        std::mutex mutex;
+    };
+
+    void pushTask(size_t queue, TaskId id) {
+        {
+            std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+            queues_[queue]->ready.push_back(id);
+        }
+        idle_cv_.notify_one();
+    }
+
+    bool popOwn(size_t queue, TaskId& id) {
+        std::lock_guard<std::mutex> lock(queues_[queue]->mutex);
+        if (queues_[queue]->ready.empty()) return false;
+        id = queues_[queue]->ready.back();
+        queues_[queue]->ready.pop_back();
+        return true;
+    }
+
+    bool stealFrom(size_t victim, TaskId& id) {
+        std::lock_guard<std::mutex> lock(queues_[victim]->mutex);
+        if (queues_[victim]->ready.empty()) return false;
+        id = queues_[victim]->ready.front();
+        queues_[victim]->ready.pop_front();
+        return true;
+    }
+
+    void workerLoop(size_t self, size_t workers) {
+        for (;;) {
+            TaskId id;
+            bool found = popOwn(self, id);
+
+            for (size_t i = 1; !found && i < workers; i++) {
+                found = stealFrom((self + i) % workers, id);
+            }
+
+            if (!found) {
+                if (remaining_.load() == 0) return;
+                std::unique_lock<std::mutex> lock(idle_mutex_);
+                idle_cv_.wait_for(lock, std::chrono::milliseconds(1));
+                if (remaining_.load() == 0) return;
+                continue;
+            }
+
+            tasks_[id].fn();
+
+            // Unblocked dependents stay local to this worker
+            for (TaskId dep : tasks_[id].dependents) {
+                if (tasks_[dep].pending.fetch_sub(1) == 1) {
+                    pushTask(self, dep);
+                }
+            }
+
+            if (remaining_.fetch_sub(1) == 1) {
+                idle_cv_.notify_all();
+            }
+        }
+    }
+
+    std::deque<Task> tasks_;           // deque: tasks never move once added
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::atomic<size_t> remaining_{0};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+};
+
+} // namespace morphect
+
+#endif // MORPHECT_TASK_SCHEDULER_HPP
@@ -11,19 +11,26 @@
 #define MORPHECT_TRANSFORMATION_BASE_HPP
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <vector>
+#include <cctype>
+#include <cstdint>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 #include <map>
 #include <regex>
 #include <sstream>
+#include <algorithm>
 
 namespace morphect {
 
 // Forward declarations
 class Statistics;
 class Config;
+class AnalysisCache;
+class Arena;
 
 /**
  * Result of a transformation attempt
@@ -71,8 +78,320 @@ struct PassConfig {
     // Optional per-function control
     std::vector<std::string> include_functions;  // Only these functions
     std::vector<std::string> exclude_functions;  // Skip these functions
+
+    // Pre-pass applicability gate: functions below these thresholds skip
+    // pass dispatch entirely (0 disables a threshold). TUs dominated by
+    // tiny inline getters otherwise pay the full per-pass walk for
+    // functions no pass will ever transform.
+    int min_function_statements = 0;
+    int min_transformable_ops = 0;
+
+    // Per-function output budget: a transformed function body may grow
+    // to at most this ratio of its input instruction count. Expansion-
+    // heavy passes (constant obfuscation, variable splitting, dead code)
+    // stop transforming once the budget is spent. 0 = unlimited.
+    double max_expansion_ratio = 0.0;
+
+    // Per-function runtime-overhead budget in estimated cycles (see
+    // cost_model.hpp). PassManager charges each pass's estimate greedily
+    // in pass order and skips passes that no longer fit, trading manual
+    // probability tuning for one knob. 0 = unlimited.
+    double overhead_budget = 0.0;
+};
+
+/**
+ * Precompiled include/exclude function matcher
+ *
+ * include_functions/exclude_functions are checked for every function a
+ * pass visits; with glob support a naive implementation would run one
+ * regex per pattern per function. The matcher is compiled once at
+ * initialize(): exact names go into hash sets, and all wildcard
+ * patterns ('*' and '?') are fused into one NFA that a single scan of
+ * the name drives - shouldProcess(name) is O(length of name).
+ */
+class FunctionMatcher {
+public:
+    /**
+     * Compile the include/exclude lists (called once per initialize)
+     */
+    void compile(const std::vector<std::string>& include,
+                 const std::vector<std::string>& exclude) {
+        include_exact_.clear();
+        exclude_exact_.clear();
+        include_globs_.clear();
+        exclude_globs_.clear();
+
+        for (const auto& pattern : include) {
+            if (isGlob(pattern)) {
+                include_globs_.add(pattern);
+            } else {
+                include_exact_.insert(pattern);
+            }
+        }
+        for (const auto& pattern : exclude) {
+            if (isGlob(pattern)) {
+                exclude_globs_.add(pattern);
+            } else {
+                exclude_exact_.insert(pattern);
+            }
+        }
+
+        have_include_ = !include.empty();
+        compiled_ = true;
+    }
+
+    bool isCompiled() const { return compiled_; }
+
+    /**
+     * Decide whether a function passes the include/exclude filters
+     */
+    bool shouldProcess(const std::string& name) const {
+        if (have_include_ &&
+            include_exact_.find(name) == include_exact_.end() &&
+            !include_globs_.matches(name)) {
+            return false;
+        }
+        if (exclude_exact_.find(name) != exclude_exact_.end() ||
+            exclude_globs_.matches(name)) {
+            return false;
+        }
+        return true;
+    }
+
+private:
+    static bool isGlob(const std::string& pattern) {
+        return pattern.find('*') != std::string::npos ||
+               pattern.find('?') != std::string::npos;
+    }
+
+    /**
+     * All glob patterns fused into one NFA; states are positions in the
+     * flattened pattern text and every pattern runs in the same sweep
+     */
+    class GlobSet {
+    public:
+        void add(const std::string& pattern) {
+            starts_.push_back(tokens_.size());
+            tokens_ += pattern;
+            accepts_.push_back(tokens_.size());
+            // Sentinel: never matches and stops star closure, so states
+            // of one pattern can't bleed into the next
+            tokens_ += '\0';
+        }
+
+        void clear() {
+            tokens_.clear();
+            starts_.clear();
+            accepts_.clear();
+        }
+
+        bool matches(const std::string& name) const {
+            if (starts_.empty()) {
+                return false;
+            }
+
+            current_.assign(tokens_.size() + 1, false);
+            next_.assign(tokens_.size() + 1, false);
+
+            for (size_t start : starts_) {
+                activate(current_, start);
+            }
+
+            for (char c : name) {
+                std::fill(next_.begin(), next_.end(), false);
+                bool any = false;
+                for (size_t s = 0; s < tokens_.size(); s++) {
+                    if (!current_[s]) continue;
+                    if (tokens_[s] == '*') {
+                        // Star consumes the char and stays active
+                        activate(next_, s);
+                        any = true;
+                    } else if (tokens_[s] == '?' || tokens_[s] == c) {
+                        activate(next_, s + 1);
+                        any = true;
+                    }
+                }
+                current_.swap(next_);
+                if (!any) {
+                    return false;
+                }
+            }
+
+            for (size_t accept : accepts_) {
+                if (current_[accept]) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        /**
+         * Activate a state plus everything reachable through stars
+         * (a star may match zero characters)
+         */
+        void activate(std::vector<bool>& states, size_t s) const {
+            states[s] = true;
+            while (s < tokens_.size() && tokens_[s] == '*') {
+                s++;
+                states[s] = true;
+            }
+        }
+
+        std::string tokens_;             // Flattened pattern text
+        std::vector<size_t> starts_;     // Start state per pattern
+        std::vector<size_t> accepts_;    // Accept state per pattern
+
+        // Scratch state sets, reused across calls
+        mutable std::vector<bool> current_;
+        mutable std::vector<bool> next_;
+    };
+
+    std::unordered_set<std::string> include_exact_;
+    std::unordered_set<std::string> exclude_exact_;
+    GlobSet include_globs_;
+    GlobSet exclude_globs_;
+    bool have_include_ = false;
+    bool compiled_ = false;
+};
+
+/**
+ * One-shot opcode summary of a GIMPLE function, gathered by the caller
+ * before pass dispatch so every pass doesn't re-walk trivial functions.
+ * transformable_ops counts statements at least one registered pass
+ * could rewrite (arithmetic/bitwise assigns for MBA, branches for CFF).
+ */
+struct GimpleFunctionSummary {
+    int statements = 0;
+    int transformable_ops = 0;
 };
 
+/**
+ * Per-function opcode/feature bitmap for LLVM IR
+ *
+ * A cheap pre-scan (or an existing tokenize sweep) classifies every
+ * instruction into these buckets once; the dispatcher then skips any
+ * pass whose requiredFeatures() shares no bit with the function's
+ * bitmap. An MBA pass scanning a function with no arithmetic, or string
+ * encoding scanning a module with no string constants, otherwise pays a
+ * full text walk to conclude nothing matched.
+ */
+namespace ir_features {
+
+constexpr uint32_t kIntArith    = 1u << 0;   // add / sub
+constexpr uint32_t kMul         = 1u << 1;   // mul
+constexpr uint32_t kDiv         = 1u << 2;   // sdiv / udiv / srem / urem
+constexpr uint32_t kBitwise     = 1u << 3;   // and / or / xor / shl / lshr / ashr
+constexpr uint32_t kBranch      = 1u << 4;   // br
+constexpr uint32_t kSwitch      = 1u << 5;   // switch
+constexpr uint32_t kCall        = 1u << 6;   // call / invoke
+constexpr uint32_t kMemory      = 1u << 7;   // alloca / load / store / getelementptr
+constexpr uint32_t kPhi         = 1u << 8;   // phi
+constexpr uint32_t kFloat       = 1u << 9;   // fadd / fsub / fmul / fdiv / fcmp
+constexpr uint32_t kStringConst = 1u << 10;  // c"..." constant data
+
+/**
+ * Bucket of a single opcode token (empty/unknown opcodes map to 0)
+ */
+inline uint32_t classifyOpcode(std::string_view opcode) {
+    if (opcode.empty()) return 0;
+    switch (opcode[0]) {
+        case 'a':
+            if (opcode == "add") return kIntArith;
+            if (opcode == "and") return kBitwise;
+            if (opcode == "ashr") return kBitwise;
+            if (opcode == "alloca") return kMemory;
+            break;
+        case 'b':
+            if (opcode == "br") return kBranch;
+            break;
+        case 'c':
+            if (opcode == "call") return kCall;
+            break;
+        case 'f':
+            if (opcode == "fadd" || opcode == "fsub" || opcode == "fmul" ||
+                opcode == "fdiv" || opcode == "frem" || opcode == "fcmp") {
+                return kFloat;
+            }
+            break;
+        case 'g':
+            if (opcode == "getelementptr") return kMemory;
+            break;
+        case 'i':
+            if (opcode == "invoke") return kCall;
+            break;
+        case 'l':
+            if (opcode == "load") return kMemory;
+            if (opcode == "lshr") return kBitwise;
+            break;
+        case 'm':
+            if (opcode == "mul") return kMul;
+            break;
+        case 'o':
+            if (opcode == "or") return kBitwise;
+            break;
+        case 'p':
+            if (opcode == "phi") return kPhi;
+            break;
+        case 's':
+            if (opcode == "sub") return kIntArith;
+            if (opcode == "store") return kMemory;
+            if (opcode == "shl") return kBitwise;
+            if (opcode == "switch") return kSwitch;
+            if (opcode == "sdiv" || opcode == "srem") return kDiv;
+            break;
+        case 'u':
+            if (opcode == "udiv" || opcode == "urem") return kDiv;
+            break;
+        case 'x':
+            if (opcode == "xor") return kBitwise;
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+/**
+ * One-sweep feature scan over IR lines (function body or whole module)
+ */
+inline uint32_t scanLines(const std::vector<std::string>& lines) {
+    uint32_t features = 0;
+
+    for (const auto& line : lines) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos) continue;
+        if (line[start] == ';' || line[start] == '}') continue;
+
+        // Global string constants: @x = ... constant [N x i8] c"..."
+        if (line[start] == '@') {
+            if (line.find("c\"", start) != std::string::npos) {
+                features |= kStringConst;
+            }
+            continue;
+        }
+
+        // Opcode is the first word, or the word after " = "
+        size_t op_start = start;
+        size_t eq = line.find(" = ", start);
+        if (eq != std::string::npos && line[start] == '%') {
+            op_start = line.find_first_not_of(" \t", eq + 3);
+            if (op_start == std::string::npos) continue;
+        }
+        size_t op_end = op_start;
+        while (op_end < line.size() &&
+               (std::isalnum((unsigned char)line[op_end]) || line[op_end] == '_')) {
+            op_end++;
+        }
+        features |= classifyOpcode(
+            std::string_view(line.data() + op_start, op_end - op_start));
+    }
+
+    return features;
+}
+
+} // namespace ir_features
+
 /**
  * Abstract base class for all transformation passes
  *
@@ -112,6 +431,14 @@ public:
      */
     virtual std::vector<std::string> getDependencies() const { return {}; }
 
+    /**
+     * Feature classes this pass can act on, as an ir_features bitmap.
+     * The dispatcher skips the pass for functions whose feature bitmap
+     * shares no bit with this mask. 0 (the default) means the pass has
+     * no opcode requirement and always runs.
+     */
+    virtual uint32_t requiredFeatures() const { return 0; }
+
     /**
      * Initialize the pass with configuration
      * Called once before any transformations
@@ -121,6 +448,8 @@ public:
      */
     virtual bool initialize(const PassConfig& config) {
         config_ = config;
+        function_matcher_.compile(config_.include_functions,
+                                  config_.exclude_functions);
         return true;
     }
 
@@ -139,6 +468,23 @@ public:
      */
     const PassConfig& getConfig() const { return config_; }
 
+    /**
+     * Attach the shared per-function analysis cache (set by PassManager).
+     * Passes that rewrite a function must invalidate its entries.
+     */
+    virtual void setAnalysisCache(AnalysisCache* cache) {
+        analysis_cache_ = cache;
+    }
+
+    /**
+     * Attach the per-function scratch arena (set by PassManager).
+     * PassManager resets it wholesale after each function, so nothing
+     * allocated from it may outlive the function being transformed.
+     */
+    virtual void setScratchArena(Arena* arena) {
+        scratch_arena_ = arena;
+    }
+
     /**
      * Finalize the pass after all transformations
      * Called once at the end
@@ -162,6 +508,8 @@ public:
 protected:
     PassConfig config_;
     std::unordered_map<std::string, int> statistics_;
+    AnalysisCache* analysis_cache_ = nullptr;
+    Arena* scratch_arena_ = nullptr;
 
     /**
      * Increment a statistic counter
@@ -178,8 +526,15 @@ protected:
 
     /**
      * Check if a function should be processed based on include/exclude lists
+     *
+     * Uses the matcher compiled at initialize(); falls back to the
+     * linear scan for passes whose config was set without initialize.
      */
     bool shouldProcessFunction(const std::string& func_name) const {
+        if (function_matcher_.isCompiled()) {
+            return function_matcher_.shouldProcess(func_name);
+        }
+
         // If include list is specified, function must be in it
         if (!config_.include_functions.empty()) {
             bool found = false;
@@ -196,6 +551,8 @@ protected:
 
         return true;
     }
+
+    FunctionMatcher function_matcher_;
 };
 
 /**
@@ -231,6 +588,34 @@ public:
      */
     virtual TransformResult transformIR(std::vector<std::string>& lines) = 0;
 
+    /**
+     * Whether this pass only ever rewrites one line at a time.
+     * Line-local passes can be fused into a single module sweep by
+     * PassManager instead of each doing its own full traversal.
+     */
+    virtual bool isLineLocal() const { return false; }
+
+    /**
+     * Try to transform a single line (line-local passes only).
+     * On success, fills replacement with the lines that take its place.
+     *
+     * @return true if the line was transformed
+     */
+    virtual bool transformLineIR(const std::string& line,
+                                 std::vector<std::string>& replacement) {
+        (void)line;
+        (void)replacement;
+        return false;
+    }
+
+    /**
+     * Public entry to SSA renumbering for drivers that splice lines
+     * outside a pass (e.g. the fused sweep in PassManager)
+     */
+    static void renumberModuleSSA(std::vector<std::string>& lines) {
+        renumberSSA(lines);
+    }
+
 protected:
     /**
      * Renumber sequential SSA values in LLVM IR to fix numbering after transformations
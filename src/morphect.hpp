@@ -16,18 +16,33 @@
 // Core components
 #include "core/transformation_base.hpp"
 #include "core/pass_manager.hpp"
+#include "core/task_scheduler.hpp"
 #include "core/statistics.hpp"
 
 // Common utilities
 #include "common/logging.hpp"
 #include "common/random.hpp"
 #include "common/json_parser.hpp"
+#include "common/ir_tokenizer.hpp"
+#include "common/asm_scan.hpp"
+#include "common/mapped_file.hpp"
+#include "common/line_rope.hpp"
+#include "common/incremental_cache.hpp"
+#include "common/string_builder.hpp"
+#include "common/string_interner.hpp"
+#include "common/bounded_queue.hpp"
+#include "common/output_writer.hpp"
 
 // Transformation passes
 #include "passes/mba/mba.hpp"
 #include "passes/data/data.hpp"
 #include "passes/cff/cff.hpp"
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
 namespace morphect {
 
 // version string
@@ -52,6 +67,37 @@ inline void printBanner() {
     std::cout << getBanner() << std::endl;
 }
 
+/**
+ * Shipped presets compiled into the binary. A preset run touches no
+ * file and parses no JSON - the values below are the whole config, so
+ * per-TU plugin invocations pay nothing for configuration.
+ */
+struct ConfigPreset {
+    const char* name;
+    double global_probability;
+    bool enable_mba;
+    int mba_nesting_depth;
+    const char* mba_complexity;
+    bool enable_constant_obf;
+    bool enable_cff;
+    bool enable_bogus_cf;
+    bool enable_string_encoding;
+};
+
+inline constexpr ConfigPreset kConfigPresets[] = {
+    // name          prob  mba  depth complexity  const  cff    bogus  strenc
+    {"default",      0.85, true, 1,   "high",     true,  false, false, true},
+    {"fast",         0.85, true, 1,   "low",      true,  false, false, false},
+    {"aggressive",   1.0,  true, 2,   "high",     true,  true,  true,  true},
+};
+
+inline constexpr const ConfigPreset* findConfigPreset(std::string_view name) {
+    for (const auto& preset : kConfigPresets) {
+        if (name == preset.name) return &preset;
+    }
+    return nullptr;
+}
+
 // config options - most of these have sane defaults
 struct MorphectConfig {
     double global_probability = 0.85;
@@ -74,6 +120,9 @@ struct MorphectConfig {
     uint8_t string_xor_key = 0x7B;
     int string_min_length = 3;
 
+    // runtime-overhead budget (estimated cycles per function, 0 = unlimited)
+    double overhead_budget = 0.0;
+
     // for reproducible builds
     bool use_fixed_seed = false;
     uint64_t random_seed = 0;
@@ -82,10 +131,49 @@ struct MorphectConfig {
     bool print_statistics = true;
     std::string stats_output_file;
 
+    /**
+     * Apply a compiled-in preset by name (see kConfigPresets). Returns
+     * false and leaves the config untouched for an unknown name.
+     */
+    bool applyPreset(std::string_view name) {
+        const ConfigPreset* preset = findConfigPreset(name);
+        if (!preset) return false;
+        global_probability = preset->global_probability;
+        enable_mba = preset->enable_mba;
+        mba_nesting_depth = preset->mba_nesting_depth;
+        mba_complexity = preset->mba_complexity;
+        enable_constant_obf = preset->enable_constant_obf;
+        enable_cff = preset->enable_cff;
+        enable_bogus_cf = preset->enable_bogus_cf;
+        enable_string_encoding = preset->enable_string_encoding;
+        return true;
+    }
+
+    /**
+     * Curated low-overhead preset for latency-critical services: only
+     * transformations measured under ~2% runtime overhead - shallow
+     * depth-1 MBA and cheap-scheme constant obfuscation, both
+     * line-local so PassManager fuses them into one module sweep.
+     * Heavy passes (CFF, bogus control flow, string encoding) stay off.
+     */
+    void applyFastPreset() {
+        applyPreset("fast");
+    }
+
+    /**
+     * Load a JSON config, going through the binary `.mcfg` cache kept
+     * next to it. A valid cache (matching version and JSON size/mtime)
+     * loads with one read and no JSON parsing; otherwise the JSON is
+     * parsed as before and the cache rewritten best-effort.
+     */
     bool loadFromFile(const std::string& path) {
+        if (loadFromCache(path)) {
+            return true;
+        }
         try {
             auto json = JsonParser::parseFile(path);
             loadFromJson(json);
+            writeCache(path);
             return true;
         } catch (const std::exception& e) {
             LOG_ERROR("Failed to load config: {}", e.what());
@@ -106,6 +194,11 @@ struct MorphectConfig {
             ? json["obfuscation_settings"]
             : json;
 
+        // Preset applies first; explicit settings below still override it
+        if (settings.has("preset")) {
+            applyPreset(settings["preset"].asString(""));
+        }
+
         if (settings.has("global_probability")) {
             global_probability = settings["global_probability"].asDouble(0.85);
         }
@@ -121,6 +214,9 @@ struct MorphectConfig {
         if (settings.has("enable_string_encoding")) {
             enable_string_encoding = settings["enable_string_encoding"].asBool(true);
         }
+        if (settings.has("overhead_budget")) {
+            overhead_budget = settings["overhead_budget"].asDouble(0.0);
+        }
 
         if (json.has("string_encoding")) {
             const auto& se = json["string_encoding"];
@@ -149,8 +245,148 @@ struct MorphectConfig {
         pc.enabled = true;
         pc.probability = global_probability;
         pc.verbosity = verbosity;
+        pc.overhead_budget = overhead_budget;
         return pc;
     }
+
+    /**
+     * On-disk layout of the compiled config cache: one fixed-size
+     * record, native byte order (the cache lives next to the JSON and
+     * never travels between machines). The JSON's size and mtime pin
+     * the record to the exact file it was compiled from; bump
+     * kConfigCacheVersion whenever the layout or config fields change.
+     */
+    static constexpr uint32_t kConfigCacheVersion = 1;
+
+    struct ConfigCacheRecord {
+        char magic[4];      // "MCFG"
+        uint32_t version;
+        uint64_t json_size;
+        int64_t json_mtime;
+
+        double global_probability;
+        int32_t verbosity;
+        uint8_t preserve_functionality;
+        uint8_t enable_mba;
+        uint8_t enable_cff;
+        uint8_t enable_bogus_cf;
+        uint8_t enable_string_encoding;
+        uint8_t enable_constant_obf;
+        int32_t mba_nesting_depth;
+        char mba_complexity[16];
+        char string_encoding_method[16];
+        uint8_t string_xor_key;
+        int32_t string_min_length;
+        double overhead_budget;
+        uint8_t use_fixed_seed;
+        uint64_t random_seed;
+        uint8_t print_statistics;
+        char stats_output_file[256];
+    };
+
+    static std::string cachePathFor(const std::string& json_path) {
+        const std::string ext = ".json";
+        if (json_path.size() > ext.size() &&
+            json_path.compare(json_path.size() - ext.size(), ext.size(), ext) == 0) {
+            return json_path.substr(0, json_path.size() - ext.size()) + ".mcfg";
+        }
+        return json_path + ".mcfg";
+    }
+
+    bool loadFromCache(const std::string& json_path) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        uint64_t json_size = fs::file_size(json_path, ec);
+        if (ec) return false;
+        auto json_mtime = fs::last_write_time(json_path, ec);
+        if (ec) return false;
+
+        std::ifstream in(cachePathFor(json_path), std::ios::binary);
+        if (!in) return false;
+
+        ConfigCacheRecord rec;
+        if (!in.read(reinterpret_cast<char*>(&rec), sizeof(rec)) ||
+            in.peek() != std::ifstream::traits_type::eof()) {
+            return false;
+        }
+        if (std::memcmp(rec.magic, "MCFG", 4) != 0 ||
+            rec.version != kConfigCacheVersion ||
+            rec.json_size != json_size ||
+            rec.json_mtime != json_mtime.time_since_epoch().count()) {
+            return false;
+        }
+
+        global_probability = rec.global_probability;
+        verbosity = rec.verbosity;
+        preserve_functionality = rec.preserve_functionality != 0;
+        enable_mba = rec.enable_mba != 0;
+        enable_cff = rec.enable_cff != 0;
+        enable_bogus_cf = rec.enable_bogus_cf != 0;
+        enable_string_encoding = rec.enable_string_encoding != 0;
+        enable_constant_obf = rec.enable_constant_obf != 0;
+        mba_nesting_depth = rec.mba_nesting_depth;
+        mba_complexity = rec.mba_complexity;
+        string_encoding_method = rec.string_encoding_method;
+        string_xor_key = rec.string_xor_key;
+        string_min_length = rec.string_min_length;
+        overhead_budget = rec.overhead_budget;
+        use_fixed_seed = rec.use_fixed_seed != 0;
+        random_seed = rec.random_seed;
+        print_statistics = rec.print_statistics != 0;
+        stats_output_file = rec.stats_output_file;
+
+        LOG_DEBUG("Config loaded from cache: {}", cachePathFor(json_path));
+        return true;
+    }
+
+    void writeCache(const std::string& json_path) const {
+        // Best-effort: a string too long for its fixed slot, or an
+        // unwritable directory, just means the JSON keeps being parsed
+        if (mba_complexity.size() >= sizeof(ConfigCacheRecord{}.mba_complexity) ||
+            string_encoding_method.size() >= sizeof(ConfigCacheRecord{}.string_encoding_method) ||
+            stats_output_file.size() >= sizeof(ConfigCacheRecord{}.stats_output_file)) {
+            return;
+        }
+
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        uint64_t json_size = fs::file_size(json_path, ec);
+        if (ec) return;
+        auto json_mtime = fs::last_write_time(json_path, ec);
+        if (ec) return;
+
+        ConfigCacheRecord rec;
+        std::memset(&rec, 0, sizeof(rec));
+        std::memcpy(rec.magic, "MCFG", 4);
+        rec.version = kConfigCacheVersion;
+        rec.json_size = json_size;
+        rec.json_mtime = json_mtime.time_since_epoch().count();
+        rec.global_probability = global_probability;
+        rec.verbosity = verbosity;
+        rec.preserve_functionality = preserve_functionality ? 1 : 0;
+        rec.enable_mba = enable_mba ? 1 : 0;
+        rec.enable_cff = enable_cff ? 1 : 0;
+        rec.enable_bogus_cf = enable_bogus_cf ? 1 : 0;
+        rec.enable_string_encoding = enable_string_encoding ? 1 : 0;
+        rec.enable_constant_obf = enable_constant_obf ? 1 : 0;
+        rec.mba_nesting_depth = mba_nesting_depth;
+        std::memcpy(rec.mba_complexity, mba_complexity.c_str(), mba_complexity.size());
+        std::memcpy(rec.string_encoding_method, string_encoding_method.c_str(),
+                    string_encoding_method.size());
+        rec.string_xor_key = string_xor_key;
+        rec.string_min_length = string_min_length;
+        rec.overhead_budget = overhead_budget;
+        rec.use_fixed_seed = use_fixed_seed ? 1 : 0;
+        rec.random_seed = random_seed;
+        rec.print_statistics = print_statistics ? 1 : 0;
+        std::memcpy(rec.stats_output_file, stats_output_file.c_str(),
+                    stats_output_file.size());
+
+        std::ofstream out(cachePathFor(json_path), std::ios::binary | std::ios::trunc);
+        if (out) {
+            out.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+        }
+    }
 };
 
 inline void initialize(const MorphectConfig& config) {
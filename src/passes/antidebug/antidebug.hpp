@@ -19,6 +19,7 @@
 
 #include "antidebug_base.hpp"
 
+#include <atomic>
 #include <regex>
 #include <sstream>
 #include <algorithm>
@@ -47,67 +48,112 @@ public:
             return result;
         }
 
-        // Find insertion points
-        AntiDebugAnalyzer analyzer;
-        auto entry_points = analyzer.findFunctionEntries(lines);
-        auto loop_headers = config.insert_at_loops ?
-            analyzer.findLoopHeaders(lines) : std::vector<int>();
+        // Find insertion points. The analyzer caches per-function
+        // candidate lists by body hash, so repeated runs only rescan
+        // functions that changed.
+        AntiDebugAnalyzer::Candidates cand = analyzer_.analyzeIR(lines);
+        const std::vector<int>& entry_points = cand.entry_points;
+        const std::vector<int>& loop_headers = cand.loop_headers;
+        const std::vector<std::pair<int, int>>& loop_bodies = cand.loop_bodies;
+
+        // Per-function check budget. Entry points are in ascending order,
+        // so the function owning a line is the last entry at or before it.
+        std::unordered_map<int, int> budget_used;
+        auto functionIndex = [&entry_points](int line) {
+            int idx = -1;
+            for (size_t f = 0; f < entry_points.size(); f++) {
+                if (entry_points[f] <= line) idx = static_cast<int>(f);
+            }
+            return idx;
+        };
 
         // Track insertions
         std::vector<std::pair<int, std::vector<std::string>>> insertions;
 
         // Insert at function entries
         if (config.insert_at_entry) {
-            int checks_inserted = 0;
             for (int point : entry_points) {
-                if (checks_inserted >= config.max_checks_per_function) break;
+                int fn = functionIndex(point);
+                if (budget_used[fn] >= config.max_checks_per_function) continue;
+                if (config.avoid_loop_bodies &&
+                    AntiDebugAnalyzer::isInLoopBody(point, loop_bodies)) {
+                    continue;
+                }
                 if (GlobalRandom::nextDouble() > config.probability) continue;
 
                 std::vector<std::string> check_code;
                 std::string fail_label = "_antidebug_fail_" +
-                    std::to_string(label_counter_++);
+                    std::to_string(label_counter_.fetch_add(1, std::memory_order_relaxed));
 
-                // Generate timing check
-                if (config.use_timing) {
-                    auto timing = LLVMAntiDebugGenerator::generateTimingCheck(
-                        config.response,
-                        config.timing_threshold_ns,
-                        fail_label);
-                    check_code.insert(check_code.end(), timing.begin(), timing.end());
+                if (config.use_cheap_checks) {
+                    // Cheap tier: cycle-counter delta only, no libc calls
+                    auto cheap = LLVMAntiDebugGenerator::generateCheapTimingCheck(
+                        config.cheap_timing_threshold_cycles, fail_label);
+                    check_code.insert(check_code.end(), cheap.begin(), cheap.end());
                     result.techniques_used.push_back(AntiDebugTechnique::TimingCheck);
-                }
-
-                // Generate env checks
-                if (config.use_env_check) {
-                    auto env = LLVMAntiDebugGenerator::generateEnvCheck(
-                        "LD_PRELOAD", fail_label);
-                    check_code.insert(check_code.end(), env.begin(), env.end());
-                    result.techniques_used.push_back(AntiDebugTechnique::EnvironmentCheck);
+                    result.cheap_checks_inserted++;
+                } else {
+                    // Generate timing check
+                    if (config.use_timing) {
+                        auto timing = LLVMAntiDebugGenerator::generateTimingCheck(
+                            config.response,
+                            config.timing_threshold_ns,
+                            fail_label);
+                        check_code.insert(check_code.end(), timing.begin(), timing.end());
+                        result.techniques_used.push_back(AntiDebugTechnique::TimingCheck);
+                    }
+
+                    // Generate env checks
+                    if (config.use_env_check) {
+                        auto env = LLVMAntiDebugGenerator::generateEnvCheck(
+                            "LD_PRELOAD", fail_label);
+                        check_code.insert(check_code.end(), env.begin(), env.end());
+                        result.techniques_used.push_back(AntiDebugTechnique::EnvironmentCheck);
+                    }
                 }
 
                 if (!check_code.empty()) {
                     insertions.push_back({point, check_code});
                     result.checks_inserted++;
-                    checks_inserted++;
+                    budget_used[fn]++;
                 }
             }
         }
 
-        // Insert at loop headers (less frequently)
+        // Insert at loop headers (less frequently). Insertion goes before
+        // the header label, so the check runs once per loop entry, not
+        // per iteration; the budget still applies.
         if (config.insert_at_loops) {
             for (int point : loop_headers) {
+                int fn = functionIndex(point);
+                if (fn >= 0 &&
+                    budget_used[fn] >= config.max_checks_per_function) {
+                    continue;
+                }
+                if (config.avoid_loop_bodies &&
+                    AntiDebugAnalyzer::isInLoopBody(point, loop_bodies)) {
+                    continue;  // Header of an inner loop - still a hot path
+                }
                 if (GlobalRandom::nextDouble() > config.probability * 0.5) continue;
 
                 std::string fail_label = "_antidebug_loop_fail_" +
-                    std::to_string(label_counter_++);
-
-                auto timing = LLVMAntiDebugGenerator::generateTimingCheck(
-                    config.response,
-                    config.timing_threshold_ns * 2,  // More lenient in loops
-                    fail_label);
+                    std::to_string(label_counter_.fetch_add(1, std::memory_order_relaxed));
+
+                std::vector<std::string> check;
+                if (config.use_cheap_checks) {
+                    check = LLVMAntiDebugGenerator::generateCheapTimingCheck(
+                        config.cheap_timing_threshold_cycles, fail_label);
+                    result.cheap_checks_inserted++;
+                } else {
+                    check = LLVMAntiDebugGenerator::generateTimingCheck(
+                        config.response,
+                        config.timing_threshold_ns * 2,  // More lenient in loops
+                        fail_label);
+                }
 
-                insertions.push_back({point, timing});
+                insertions.push_back({point, check});
                 result.checks_inserted++;
+                if (fn >= 0) budget_used[fn]++;
             }
         }
 
@@ -128,11 +174,15 @@ public:
         return result;
     }
 
+    const AntiDebugAnalyzer& analyzer() const { return analyzer_; }
+
 private:
-    static int label_counter_;
+    AntiDebugAnalyzer analyzer_;
+    // Atomic: shared across instances, incremented from --jobs workers.
+    static std::atomic<int> label_counter_;
 };
 
-inline int LLVMAntiDebugTransformation::label_counter_ = 0;
+inline std::atomic<int> LLVMAntiDebugTransformation::label_counter_{0};
 
 /**
  * Assembly Anti-Debugging Transformation
@@ -155,9 +205,12 @@ public:
             return result;
         }
 
-        // Find insertion points
-        AntiDebugAnalyzer analyzer;
-        auto entry_points = analyzer.findAsmFunctionEntries(lines);
+        // Find insertion points off one shared scan; per-function loop
+        // bodies come from the analyzer's incremental cache
+        AsmScan scan = AsmScanner::scan(lines);
+        AntiDebugAnalyzer::Candidates cand = analyzer_.analyzeAsm(scan, lines);
+        const std::vector<int>& entry_points = cand.entry_points;
+        const std::vector<std::pair<int, int>>& loop_bodies = cand.loop_bodies;
 
         // Track insertions
         std::vector<std::pair<int, std::vector<std::string>>> insertions;
@@ -193,49 +246,77 @@ public:
                 break;
         }
 
-        // Insert checks at function entries
-        if (config.insert_at_entry) {
-            int checks_inserted = 0;
+        // Insert checks at function entries. Entries come one per
+        // function, so the per-function budget gates whether the entry
+        // check fits; it no longer caps the whole module.
+        if (config.insert_at_entry && config.max_checks_per_function > 0) {
             for (int point : entry_points) {
-                if (checks_inserted >= config.max_checks_per_function) break;
+                if (config.avoid_loop_bodies &&
+                    AntiDebugAnalyzer::isInLoopBody(point, loop_bodies)) {
+                    continue;
+                }
                 if (GlobalRandom::nextDouble() > config.probability) continue;
 
                 std::vector<std::string> check_code;
 
-                // Save registers we'll use
-                check_code.push_back("    # Anti-debug checks");
-                check_code.push_back("    push rax");
-                check_code.push_back("    push rcx");
-                check_code.push_back("    push rdx");
-                check_code.push_back("    push r15");
-
-                // Add timing check
-                if (config.use_timing) {
-                    uint64_t threshold = (config.timing_threshold_ns / 1000) * 3;
-                    auto timing = X86AntiDebugGenerator::generateTimingCheckAsm(
-                        threshold, fail_label);
-                    check_code.insert(check_code.end(), timing.begin(), timing.end());
-                    result.techniques_used.push_back(AntiDebugTechnique::TimingCheck);
-                }
+                if (config.use_cheap_checks) {
+                    // Cheap tier: no syscalls, safe on hot call paths
+                    check_code.push_back("    # Anti-debug checks (cheap tier)");
+                    check_code.push_back("    push rax");
+                    check_code.push_back("    push rdx");
+                    check_code.push_back("    push r15");
 
-                // Add ptrace check (syscall based)
-                if (config.use_ptrace) {
-                    auto ptrace = X86AntiDebugGenerator::generatePtraceSyscallAsm(
+                    auto trap = X86AntiDebugGenerator::generateTrapFlagCheckAsm(
                         fail_label);
-                    check_code.insert(check_code.end(), ptrace.begin(), ptrace.end());
-                    result.techniques_used.push_back(AntiDebugTechnique::PtraceDetection);
+                    check_code.insert(check_code.end(), trap.begin(), trap.end());
+                    result.techniques_used.push_back(AntiDebugTechnique::TrapFlagCheck);
+
+                    if (config.use_timing) {
+                        auto timing = X86AntiDebugGenerator::generateCheapTimingCheckAsm(
+                            config.cheap_timing_threshold_cycles, fail_label);
+                        check_code.insert(check_code.end(), timing.begin(), timing.end());
+                        result.techniques_used.push_back(AntiDebugTechnique::TimingCheck);
+                    }
+
+                    check_code.push_back("    pop r15");
+                    check_code.push_back("    pop rdx");
+                    check_code.push_back("    pop rax");
+                    result.cheap_checks_inserted++;
+                } else {
+                    // Save registers we'll use
+                    check_code.push_back("    # Anti-debug checks");
+                    check_code.push_back("    push rax");
+                    check_code.push_back("    push rcx");
+                    check_code.push_back("    push rdx");
+                    check_code.push_back("    push r15");
+
+                    // Add timing check
+                    if (config.use_timing) {
+                        uint64_t threshold = (config.timing_threshold_ns / 1000) * 3;
+                        auto timing = X86AntiDebugGenerator::generateTimingCheckAsm(
+                            threshold, fail_label);
+                        check_code.insert(check_code.end(), timing.begin(), timing.end());
+                        result.techniques_used.push_back(AntiDebugTechnique::TimingCheck);
+                    }
+
+                    // Add ptrace check (syscall based)
+                    if (config.use_ptrace) {
+                        auto ptrace = X86AntiDebugGenerator::generatePtraceSyscallAsm(
+                            fail_label);
+                        check_code.insert(check_code.end(), ptrace.begin(), ptrace.end());
+                        result.techniques_used.push_back(AntiDebugTechnique::PtraceDetection);
+                    }
+
+                    // Restore registers
+                    check_code.push_back("    pop r15");
+                    check_code.push_back("    pop rdx");
+                    check_code.push_back("    pop rcx");
+                    check_code.push_back("    pop rax");
                 }
 
-                // Restore registers
-                check_code.push_back("    pop r15");
-                check_code.push_back("    pop rdx");
-                check_code.push_back("    pop rcx");
-                check_code.push_back("    pop rax");
-
                 if (!check_code.empty()) {
                     insertions.push_back({point, check_code});
                     result.checks_inserted++;
-                    checks_inserted++;
                 }
             }
         }
@@ -269,6 +350,11 @@ public:
         result.success = true;
         return result;
     }
+
+    const AntiDebugAnalyzer& analyzer() const { return analyzer_; }
+
+private:
+    AntiDebugAnalyzer analyzer_;
 };
 
 /**
@@ -398,8 +484,11 @@ public:
         if (result.success) {
             lines = std::move(result.generated_code);
             statistics_["checks_inserted"] = result.checks_inserted;
+            statistics_["cheap_checks_inserted"] = result.cheap_checks_inserted;
             statistics_["techniques_used"] = static_cast<int>(
                 result.techniques_used.size());
+            statistics_["candidate_cache_hits"] = static_cast<int>(
+                transformer_.analyzer().cacheHits());
             return TransformResult::Success;
         } else {
             return TransformResult::Error;
@@ -463,6 +552,9 @@ public:
         if (result.success) {
             lines = std::move(result.generated_code);
             statistics_["checks_inserted"] = result.checks_inserted;
+            statistics_["cheap_checks_inserted"] = result.cheap_checks_inserted;
+            statistics_["candidate_cache_hits"] = static_cast<int>(
+                transformer_.analyzer().cacheHits());
             return TransformResult::Success;
         } else {
             return TransformResult::Error;
@@ -21,11 +21,15 @@
 #include "../../core/transformation_base.hpp"
 #include "../../common/random.hpp"
 #include "../../common/logging.hpp"
+#include "../../common/asm_scan.hpp"
+#include "../../common/incremental_cache.hpp"
 
 #include <string>
 #include <vector>
 #include <cstdint>
 #include <functional>
+#include <unordered_map>
+#include <utility>
 
 namespace morphect {
 namespace antidebug {
@@ -41,6 +45,7 @@ enum class AntiDebugTechnique {
     DebugFlagsCheck,        // Check /proc/self/status TracerPid
     BreakpointDetection,    // Check for software breakpoints
     HardwareBreakpoints,    // Check debug registers
+    TrapFlagCheck,          // EFLAGS trap-flag probe (single-step detection)
     IsDebuggerPresent,      // Windows API (for cross-platform reference)
     ExceptionHandling,      // SEH/signal-based detection
     SelfDebugging,          // Attach to self to prevent others
@@ -92,6 +97,11 @@ struct AntiDebugConfig {
     uint64_t timing_threshold_ns = 100000000;  // 100ms - suspiciously slow
     int timing_samples = 3;                     // Number of timing samples
 
+    // Cheap tier: back-to-back RDTSC reads are a handful of cycles apart
+    // on bare metal; anything above this many cycles means someone
+    // stepped or broke between them
+    uint64_t cheap_timing_threshold_cycles = 4096;
+
     // Response settings
     std::string custom_response_code;    // For Custom response
     bool obfuscate_checks = true;        // Use MBA/opaque predicates in checks
@@ -106,6 +116,13 @@ struct AntiDebugConfig {
     bool insert_at_entry = true;         // Insert check at function entry
     bool insert_at_loops = false;        // Insert check in loops
     bool insert_random = true;           // Insert at random points
+
+    // Check tier and placement budget. The full checks cost a syscall or
+    // a /proc read each; one landing in a hot loop has cost us 30%
+    // throughput in production. The cheap tier (RDTSC deltas, trap-flag
+    // probes) makes no syscalls and is safe on hot paths.
+    bool use_cheap_checks = false;       // Emit the no-syscall tier instead
+    bool avoid_loop_bodies = false;      // Never place a check inside a loop body
 };
 
 /**
@@ -115,6 +132,7 @@ struct AntiDebugResult {
     bool success = false;
     std::vector<std::string> generated_code;
     int checks_inserted = 0;
+    int cheap_checks_inserted = 0;
     std::vector<AntiDebugTechnique> techniques_used;
     std::string error_message;
 };
@@ -595,6 +613,32 @@ public:
         return ir;
     }
 
+    /**
+     * Generate LLVM IR for cheap timing check (no libc calls)
+     *
+     * Two back-to-back cycle-counter reads with nothing between them;
+     * only a debugger stepping or breaking makes the delta large. This
+     * is the check to use on hot paths - no syscalls, no memory traffic.
+     */
+    static std::vector<std::string> generateCheapTimingCheck(
+        uint64_t threshold_cycles,
+        const std::string& fail_label) {
+
+        std::vector<std::string> ir;
+
+        ir.push_back("; Anti-debug: cheap timing check (no syscalls)");
+        ir.push_back("  %_ct1 = call i64 @llvm.readcyclecounter()");
+        ir.push_back("  %_ct2 = call i64 @llvm.readcyclecounter()");
+        ir.push_back("  %_cdiff = sub i64 %_ct2, %_ct1");
+        ir.push_back("  %_cslow = icmp ugt i64 %_cdiff, " +
+                     std::to_string(threshold_cycles));
+        ir.push_back("  br i1 %_cslow, label %" + fail_label +
+                     ", label %_cheap_ok");
+        ir.push_back("_cheap_ok:");
+
+        return ir;
+    }
+
     /**
      * Generate LLVM IR for environment check (calls libc)
      */
@@ -661,6 +705,50 @@ public:
         return asm_code;
     }
 
+    /**
+     * Generate cheap RDTSC delta check (no syscalls)
+     *
+     * Two RDTSC reads back to back are a handful of cycles apart; a
+     * single-step or breakpoint between them inflates the delta by
+     * orders of magnitude. Clobbers eax, edx and r15d only.
+     */
+    static std::vector<std::string> generateCheapTimingCheckAsm(
+        uint64_t threshold_cycles,
+        const std::string& fail_label) {
+
+        std::vector<std::string> asm_code;
+
+        asm_code.push_back("    # Anti-debug: cheap rdtsc delta check (no syscalls)");
+        asm_code.push_back("    rdtsc");
+        asm_code.push_back("    mov r15d, eax          # Low 32 bits suffice for a short delta");
+        asm_code.push_back("    rdtsc");
+        asm_code.push_back("    sub eax, r15d");
+        asm_code.push_back("    cmp eax, " + std::to_string(threshold_cycles));
+        asm_code.push_back("    ja " + fail_label + "  # Jump if the gap is debugger-sized");
+
+        return asm_code;
+    }
+
+    /**
+     * Generate trap-flag probe (registers and stack only, no syscalls)
+     *
+     * EFLAGS.TF (bit 8) is set while the CPU single-steps and never
+     * during normal execution.
+     */
+    static std::vector<std::string> generateTrapFlagCheckAsm(
+        const std::string& fail_label) {
+
+        std::vector<std::string> asm_code;
+
+        asm_code.push_back("    # Anti-debug: trap flag probe");
+        asm_code.push_back("    pushfq");
+        asm_code.push_back("    pop rax");
+        asm_code.push_back("    test eax, 0x100        # EFLAGS.TF set while single-stepping");
+        asm_code.push_back("    jnz " + fail_label);
+
+        return asm_code;
+    }
+
     /**
      * Generate inline assembly for int3 breakpoint detection
      * Checks if any breakpoints (0xCC bytes) are in the code
@@ -724,9 +812,25 @@ public:
 
 /**
  * Analyzes code to find insertion points for anti-debug checks
+ *
+ * Candidate lists are computed per function and cached keyed by a hash
+ * of the function body (IncrementalCache::hashLines), so repeated runs
+ * over a mostly-unchanged module only rescan the functions that
+ * actually changed. The analyzer must outlive the runs that want to
+ * share the cache.
  */
 class AntiDebugAnalyzer {
 public:
+    /**
+     * Insertion candidates for a module (or, in the cache, one function
+     * region with offsets relative to the region start)
+     */
+    struct Candidates {
+        std::vector<int> entry_points;
+        std::vector<int> loop_headers;
+        std::vector<std::pair<int, int>> loop_bodies;
+    };
+
     /**
      * Find function entry points in LLVM IR
      */
@@ -775,44 +879,236 @@ public:
     }
 
     /**
-     * Find function entries in assembly
+     * Find loop body line ranges in LLVM IR
+     *
+     * A back edge is a branch to a label defined earlier in the text;
+     * the lines between the target label and the branch form the loop
+     * body. Same back-edge notion LLVMCFGAnalyzer uses for CFF, kept at
+     * line granularity here so insertion points can be filtered cheaply.
      */
-    std::vector<int> findAsmFunctionEntries(
+    std::vector<std::pair<int, int>> findLoopBodyRanges(
+        const std::vector<std::string>& ir_lines) const {
+
+        std::vector<std::pair<int, int>> ranges;
+        std::unordered_map<std::string, int> label_lines;
+
+        for (size_t i = 0; i < ir_lines.size(); i++) {
+            std::string trimmed = trim(ir_lines[i]);
+
+            // Label definition: a single token ending with ':'
+            if (!trimmed.empty() && trimmed.back() == ':' &&
+                trimmed.find(' ') == std::string::npos) {
+                label_lines[trimmed.substr(0, trimmed.size() - 1)] =
+                    static_cast<int>(i);
+                continue;
+            }
+
+            // Branch targets: every "label %name" on the line
+            size_t pos = 0;
+            while ((pos = trimmed.find("label %", pos)) != std::string::npos) {
+                pos += 7;
+                size_t end = pos;
+                while (end < trimmed.size() && isLabelChar(trimmed[end])) end++;
+                auto it = label_lines.find(trimmed.substr(pos, end - pos));
+                if (it != label_lines.end()) {
+                    ranges.push_back({it->second, static_cast<int>(i)});
+                }
+                pos = end;
+            }
+        }
+
+        return ranges;
+    }
+
+    /**
+     * Find loop body line ranges in assembly (backward jumps)
+     */
+    std::vector<std::pair<int, int>> findAsmLoopBodyRanges(
         const std::vector<std::string>& asm_lines) const {
 
-        std::vector<int> result;
+        std::vector<std::pair<int, int>> ranges;
+        std::unordered_map<std::string, int> label_lines;
 
         for (size_t i = 0; i < asm_lines.size(); i++) {
-            const std::string& line = asm_lines[i];
-
-            // Look for function labels followed by prologue
-            if (line.find(".type") != std::string::npos &&
-                line.find("@function") != std::string::npos) {
-                // Find the actual function label (next non-empty line ending with :)
-                for (size_t j = i + 1; j < asm_lines.size() && j < i + 5; j++) {
-                    std::string trimmed = trim(asm_lines[j]);
-                    if (!trimmed.empty() && trimmed.back() == ':' &&
-                        trimmed.find('.') == std::string::npos) {
-                        // Next line after label is insertion point
-                        if (j + 1 < asm_lines.size()) {
-                            result.push_back(static_cast<int>(j + 1));
-                        }
-                        break;
+            std::string trimmed = trim(asm_lines[i]);
+
+            if (!trimmed.empty() && trimmed.back() == ':' &&
+                trimmed.find(' ') == std::string::npos) {
+                label_lines[trimmed.substr(0, trimmed.size() - 1)] =
+                    static_cast<int>(i);
+                continue;
+            }
+
+            // Jumps (jmp/jcc): target is the last token on the line
+            if (trimmed.size() > 1 && trimmed[0] == 'j') {
+                size_t sp = trimmed.find_last_of(" \t");
+                if (sp != std::string::npos) {
+                    auto it = label_lines.find(trimmed.substr(sp + 1));
+                    if (it != label_lines.end()) {
+                        ranges.push_back({it->second, static_cast<int>(i)});
                     }
                 }
             }
         }
 
+        return ranges;
+    }
+
+    /**
+     * Whether an insertion point lands inside a loop body
+     *
+     * Inserting at the range start line places code before the header
+     * label (once per loop entry), so that point is allowed.
+     */
+    static bool isInLoopBody(int line,
+                             const std::vector<std::pair<int, int>>& ranges) {
+        for (const auto& [from, to] : ranges) {
+            if (line > from && line <= to) return true;
+        }
+        return false;
+    }
+
+    /**
+     * All insertion candidates for an IR module, computed incrementally
+     *
+     * The module is split into function regions (define line through the
+     * closing brace); each region's candidates are cached by body hash
+     * with offsets relative to the region start, then rebased to the
+     * region's current position. Only changed functions are rescanned.
+     */
+    Candidates analyzeIR(const std::vector<std::string>& ir_lines) {
+        Candidates result;
+
+        size_t i = 0;
+        while (i < ir_lines.size()) {
+            const std::string& line = ir_lines[i];
+            if (line.find("define ") == std::string::npos ||
+                line.find("{") == std::string::npos) {
+                i++;
+                continue;
+            }
+
+            size_t end = i + 1;
+            while (end < ir_lines.size()) {
+                const std::string& l = ir_lines[end];
+                if (l.find("}") != std::string::npos &&
+                    l.find("{") == std::string::npos) {
+                    break;
+                }
+                end++;
+            }
+            size_t stop = (end < ir_lines.size()) ? end + 1 : ir_lines.size();
+
+            std::vector<std::string> region(ir_lines.begin() + i,
+                                            ir_lines.begin() + stop);
+            appendRegion(result, region, static_cast<int>(i), /*is_asm=*/false);
+            i = stop;
+        }
+
         return result;
     }
 
+    /**
+     * Insertion candidates for assembly, driven by a shared AsmScan
+     *
+     * Function boundaries and labels come from the scan - no text pass
+     * of our own; per-function loop bodies are cached by body hash just
+     * like the IR side.
+     */
+    Candidates analyzeAsm(const AsmScan& scan,
+                          const std::vector<std::string>& asm_lines) {
+        Candidates result;
+
+        size_t label_idx = 0;
+        for (const auto& [start, end] : scan.functions) {
+            // Entry point: the line after the function's first
+            // non-dotted label
+            while (label_idx < scan.labels.size() &&
+                   scan.labels[label_idx].line <= start) {
+                label_idx++;
+            }
+            for (size_t l = label_idx;
+                 l < scan.labels.size() && scan.labels[l].line <= end; l++) {
+                if (!scan.labels[l].dotted) {
+                    result.entry_points.push_back(
+                        static_cast<int>(scan.labels[l].line + 1));
+                    break;
+                }
+            }
+
+            std::vector<std::string> region(asm_lines.begin() + start,
+                                            asm_lines.begin() + end + 1);
+            appendRegion(result, region, static_cast<int>(start),
+                         /*is_asm=*/true);
+        }
+
+        return result;
+    }
+
+    /**
+     * Find function entries in assembly
+     *
+     * Kept for callers that only need the entries; delegates to the
+     * shared scanner instead of a bespoke .type/@function walk.
+     */
+    std::vector<int> findAsmFunctionEntries(
+        const std::vector<std::string>& asm_lines) {
+        return analyzeAsm(AsmScanner::scan(asm_lines), asm_lines).entry_points;
+    }
+
+    size_t cacheHits() const { return cache_hits_; }
+    size_t cacheMisses() const { return cache_misses_; }
+
 private:
+    /**
+     * Look up (or compute and cache) one region's candidates and append
+     * them to the module result, rebased by the region's start line
+     */
+    void appendRegion(Candidates& out, const std::vector<std::string>& region,
+                      int base, bool is_asm) {
+        uint64_t key = IncrementalCache::hashLines(region);
+        auto it = candidate_cache_.find(key);
+        if (it == candidate_cache_.end()) {
+            Candidates rel;
+            if (is_asm) {
+                rel.loop_bodies = findAsmLoopBodyRanges(region);
+            } else {
+                rel.entry_points = findFunctionEntries(region);
+                rel.loop_headers = findLoopHeaders(region);
+                rel.loop_bodies = findLoopBodyRanges(region);
+            }
+            cache_misses_++;
+            it = candidate_cache_.emplace(key, std::move(rel)).first;
+        } else {
+            cache_hits_++;
+        }
+
+        for (int p : it->second.entry_points) {
+            out.entry_points.push_back(base + p);
+        }
+        for (int p : it->second.loop_headers) {
+            out.loop_headers.push_back(base + p);
+        }
+        for (const auto& [from, to] : it->second.loop_bodies) {
+            out.loop_bodies.push_back({base + from, base + to});
+        }
+    }
+
+    std::unordered_map<uint64_t, Candidates> candidate_cache_;
+    size_t cache_hits_ = 0;
+    size_t cache_misses_ = 0;
+
     std::string trim(const std::string& s) const {
         size_t start = s.find_first_not_of(" \t");
         if (start == std::string::npos) return "";
         size_t end = s.find_last_not_of(" \t");
         return s.substr(start, end - start + 1);
     }
+
+    static bool isLabelChar(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+               (c >= '0' && c <= '9') || c == '_' || c == '.' || c == '-';
+    }
 };
 
 } // namespace antidebug
@@ -58,14 +58,15 @@ public:
             return result;
         }
 
-        // Detect architecture
+        // One shared scan replaces the four independent traversals the
+        // analyzer queries used to make over the module text
         AssemblyAnalyzer analyzer;
-        TargetArch arch = analyzer.detectArch(lines);
+        AsmScan scan = AsmScanner::scan(lines);
+        TargetArch arch = analyzer.detectArch(scan);
 
-        // Find insertion points
-        auto jump_points = analyzer.findUnconditionalJumps(lines);
-        auto prologue_points = analyzer.findPrologueInsertPoints(lines);
-        auto function_entries = analyzer.findFunctionEntries(lines);
+        const std::vector<int>& jump_points = scan.unconditional_jumps;
+        const std::vector<int>& prologue_points = scan.prologue_points;
+        const std::vector<int>& function_entries = scan.function_entries;
 
         // Track insertions (reverse order for safe modification)
         std::vector<std::pair<int, std::vector<std::string>>> insertions;
@@ -177,15 +178,8 @@ private:
                                           config.max_junk_bytes);
 
         result.push_back("    # Anti-disassembly: junk bytes");
-
-        std::vector<uint8_t> bytes;
-        if (config.prefer_prefix_bytes) {
-            bytes = X86JunkBytes::getPrefixLikeBytes(count);
-        } else {
-            bytes = X86JunkBytes::getInstructionLikeBytes(count);
-        }
-
-        result.push_back(X86JunkBytes::bytesToAsm(bytes));
+        result.push_back(X86JunkBytes::junkByteDirective(
+            config.prefer_prefix_bytes, count));
 
         return result;
     }
@@ -19,7 +19,9 @@
 #include "../../core/transformation_base.hpp"
 #include "../../common/random.hpp"
 #include "../../common/logging.hpp"
+#include "../../common/asm_scan.hpp"
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -116,6 +118,47 @@ struct AntiDisasmResult {
  */
 class X86JunkBytes {
 public:
+    // ---- precomputed directive fragments -----------------------------
+    //
+    // Every junk-byte emission is "    .byte 0xNN[, 0xNN...]" with each
+    // byte drawn from one of the two fixed pools below. The pools never
+    // change, so the hex fragments are compile-time string literals and
+    // emitting a directive is one table lookup plus one append per byte,
+    // instead of re-formatting hex at every insertion site. The byte
+    // values mirror prefix_bytes/inst_bytes in the getters below.
+
+    static constexpr const char* kPrefixByteStrs[] = {
+        "0x26", "0x2e", "0x36", "0x3e", "0x64", "0x65",
+        "0x66", "0x67", "0xf0", "0xf2", "0xf3",
+    };
+    static constexpr const char* kInstByteStrs[] = {
+        "0x0f", "0x48", "0x49", "0x4c", "0x89", "0x8b",
+        "0xb8", "0xc7", "0xe8", "0xe9", "0xff",
+    };
+
+    /**
+     * Emit a complete junk-byte directive from the precomputed fragments
+     *
+     * Equivalent to getPrefixLikeBytes/getInstructionLikeBytes followed
+     * by bytesToAsm, without materializing the byte vector. This is the
+     * form the anti-disasm pass uses in its insertion loop.
+     */
+    static std::string junkByteDirective(bool prefer_prefix, int count) {
+        const char* const* table = prefer_prefix ? kPrefixByteStrs
+                                                 : kInstByteStrs;
+        const int table_size = static_cast<int>(
+            prefer_prefix ? sizeof(kPrefixByteStrs) / sizeof(kPrefixByteStrs[0])
+                          : sizeof(kInstByteStrs) / sizeof(kInstByteStrs[0]));
+
+        std::string result = "    .byte ";
+        result.reserve(result.size() + static_cast<size_t>(count) * 6);
+        for (int i = 0; i < count; i++) {
+            if (i > 0) result += ", ";
+            result += table[GlobalRandom::nextInt(0, table_size - 1)];
+        }
+        return result;
+    }
+
     /**
      * Get random junk bytes that look like instruction prefixes
      */
@@ -378,9 +421,8 @@ public:
         result.push_back("    jmp " + over_label);
 
         // Junk bytes that look like instruction start
-        auto junk = X86JunkBytes::getInstructionLikeBytes(
-            GlobalRandom::nextInt(1, 3));
-        result.push_back(X86JunkBytes::bytesToAsm(junk));
+        result.push_back(X86JunkBytes::junkByteDirective(
+            /*prefer_prefix=*/false, GlobalRandom::nextInt(1, 3)));
 
         result.push_back(over_label + ":");
 
@@ -441,6 +483,11 @@ public:
 
 /**
  * Analyzes assembly code to find insertion points
+ *
+ * All queries are views over a single AsmScanner sweep. The line-vector
+ * overloads re-scan for callers that only need one answer; the
+ * transform scans once and passes the AsmScan through every query, so
+ * the module text is parsed exactly once per run.
  */
 class AssemblyAnalyzer {
 public:
@@ -449,28 +496,7 @@ public:
      */
     std::vector<int> findUnconditionalJumps(
         const std::vector<std::string>& lines) const {
-
-        std::vector<int> result;
-
-        for (size_t i = 0; i < lines.size(); i++) {
-            std::string trimmed = trim(lines[i]);
-
-            // Skip empty, comments, directives
-            if (trimmed.empty() || trimmed[0] == '#' ||
-                trimmed[0] == ';' || trimmed[0] == '.') {
-                continue;
-            }
-
-            // Check for unconditional jumps
-            if (trimmed.find("jmp ") == 0 ||
-                trimmed.find("jmp\t") == 0 ||
-                trimmed.find("    jmp ") != std::string::npos ||
-                trimmed.find("\tjmp ") != std::string::npos) {
-                result.push_back(static_cast<int>(i));
-            }
-        }
-
-        return result;
+        return AsmScanner::scan(lines).unconditional_jumps;
     }
 
     /**
@@ -479,32 +505,7 @@ public:
      */
     std::vector<int> findPrologueInsertPoints(
         const std::vector<std::string>& lines) const {
-
-        std::vector<int> result;
-        bool in_function = false;
-
-        for (size_t i = 0; i < lines.size(); i++) {
-            std::string trimmed = trim(lines[i]);
-
-            // Track function boundaries
-            if (trimmed.find(".type") != std::string::npos &&
-                trimmed.find("@function") != std::string::npos) {
-                in_function = true;
-            }
-
-            if (trimmed.find(".size") != std::string::npos) {
-                // End of function - good place for fake prologue
-                result.push_back(static_cast<int>(i));
-                in_function = false;
-            }
-
-            // After .text directive
-            if (trimmed == ".text") {
-                result.push_back(static_cast<int>(i));
-            }
-        }
-
-        return result;
+        return AsmScanner::scan(lines).prologue_points;
     }
 
     /**
@@ -512,60 +513,26 @@ public:
      */
     std::vector<int> findFunctionEntries(
         const std::vector<std::string>& lines) const {
+        return AsmScanner::scan(lines).function_entries;
+    }
 
-        std::vector<int> result;
-
-        for (size_t i = 0; i < lines.size(); i++) {
-            std::string trimmed = trim(lines[i]);
-
-            // Look for function labels followed by prologue
-            if (!trimmed.empty() && trimmed.back() == ':' &&
-                trimmed.find('.') == std::string::npos) {
-                // Check next few lines for prologue pattern
-                if (i + 1 < lines.size()) {
-                    std::string next = trim(lines[i + 1]);
-                    if (next.find("push") != std::string::npos) {
-                        result.push_back(static_cast<int>(i + 1));
-                    }
-                }
-            }
-        }
-
-        return result;
+    /**
+     * Detect architecture from a completed scan
+     *
+     * The register sniff only ever confirms x86-64; 32-bit-looking
+     * registers also appear in x64 code, so anything else keeps the
+     * same x86-64 default the old line probe returned.
+     */
+    TargetArch detectArch(const AsmScan& scan) const {
+        (void)scan;
+        return TargetArch::X86_64;
     }
 
     /**
      * Detect architecture from assembly
      */
     TargetArch detectArch(const std::vector<std::string>& lines) const {
-        for (const auto& line : lines) {
-            // x86-64 indicators
-            if (line.find("rax") != std::string::npos ||
-                line.find("rbx") != std::string::npos ||
-                line.find("rsp") != std::string::npos ||
-                line.find("rbp") != std::string::npos ||
-                line.find("r8") != std::string::npos ||
-                line.find("r15") != std::string::npos) {
-                return TargetArch::X86_64;
-            }
-            // x86-32 indicators
-            if (line.find("eax") != std::string::npos ||
-                line.find("ebx") != std::string::npos ||
-                line.find("esp") != std::string::npos ||
-                line.find("ebp") != std::string::npos) {
-                // Could still be x64 using 32-bit regs, check more
-                continue;
-            }
-        }
-        return TargetArch::X86_64;  // Default
-    }
-
-private:
-    std::string trim(const std::string& s) const {
-        size_t start = s.find_first_not_of(" \t");
-        if (start == std::string::npos) return "";
-        size_t end = s.find_last_not_of(" \t");
-        return s.substr(start, end - start + 1);
+        return detectArch(AsmScanner::scan(lines));
     }
 };
 
@@ -593,18 +560,21 @@ public:
         const AntiDisasmConfig& config) = 0;
 
 protected:
-    static int label_counter_;
+    // Atomic: shared across all transformation instances, including
+    // concurrent workers in --jobs mode.
+    static std::atomic<int> label_counter_;
 
     /**
      * Generate unique label
      */
     std::string nextLabel(const std::string& prefix = "_antidis") {
-        return prefix + std::to_string(label_counter_++);
+        return prefix +
+               std::to_string(label_counter_.fetch_add(1, std::memory_order_relaxed));
     }
 };
 
 // Initialize static counter
-inline int AntiDisasmTransformation::label_counter_ = 0;
+inline std::atomic<int> AntiDisasmTransformation::label_counter_{0};
 
 } // namespace antidisasm
 } // namespace morphect
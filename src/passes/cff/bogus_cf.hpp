@@ -13,6 +13,8 @@
 #include "../../core/transformation_base.hpp"
 
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace morphect {
@@ -33,6 +35,21 @@ struct BogusConfig {
 
     bool use_real_variables = true;     // Use existing variables in predicates
     bool mix_predicate_types = true;    // Use different predicate types
+
+    // Budgeted mode: instead of rolling the dice at every candidate site,
+    // pre-count the sites per function, derive K from a size budget, and
+    // reservoir-sample K sites up front. Bounds both transform time and
+    // the output growth (and with it downstream compile time) on huge
+    // functions.
+    bool budgeted_insertion = false;
+    double size_budget_ratio = 0.25;    // max added lines, as a fraction of
+                                        // the function's current line count
+
+    // Tiered predicates: insertion sites inside a loop draw from the
+    // cheap register-only predicate pool (2-3 ALU ops, no loads) so
+    // bogus CF in hot code costs almost nothing per iteration, while
+    // straight-line sites keep the full-strength pool
+    bool tier_by_loop_depth = true;
 };
 
 /**
@@ -75,7 +92,8 @@ public:
     std::vector<std::string> insertBogusBranch(
         const std::vector<std::string>& real_code,
         const std::vector<std::string>& available_vars,
-        const BogusConfig& config);
+        const BogusConfig& config,
+        PredicateTier tier = PredicateTier::Full);
 
 private:
     OpaquePredicateLibrary predicates_;
@@ -95,6 +113,29 @@ private:
      * Find suitable insertion points
      */
     std::vector<size_t> findInsertionPoints(const std::vector<std::string>& lines);
+
+    /**
+     * Find [start, end) line ranges of function bodies
+     */
+    std::vector<std::pair<size_t, size_t>> findFunctionExtents(
+        const std::vector<std::string>& lines);
+
+    /**
+     * Per-line loop nesting depth from the textual back edges: a branch
+     * to an earlier label brackets a loop body, and a line's depth is
+     * the number of such brackets containing it. Bogus CF works on raw
+     * lines without the CFG analyzer, so this is its loop-depth signal.
+     */
+    std::vector<int> computeLoopDepths(const std::vector<std::string>& lines);
+
+    /**
+     * Budgeted site selection: per function, reservoir-sample K candidate
+     * sites where K is derived from the size budget
+     */
+    std::vector<size_t> selectSitesBudgeted(
+        const std::vector<std::string>& lines,
+        const std::vector<size_t>& candidates,
+        const BogusConfig& config);
 };
 
 /**
@@ -109,6 +150,10 @@ public:
 
     PassPriority getPriority() const override { return PassPriority::ControlFlow; }
 
+    // Insertion sites sit after non-entry labels, which only exist in
+    // functions with branches
+    uint32_t requiredFeatures() const override { return ir_features::kBranch; }
+
     bool initialize(const PassConfig& config) override {
         TransformationPass::initialize(config);
         bogus_config_.enabled = config.enabled;
@@ -207,17 +252,21 @@ inline std::vector<std::string> LLVMBogusControlFlow::transform(
         return lines;
     }
 
-    // Decide how many insertions
-    int num_insertions = GlobalRandom::nextInt(
-        config.min_insertions,
-        std::min(config.max_insertions, static_cast<int>(insertion_points.size())));
-
-    // Shuffle and pick insertion points
     std::vector<size_t> selected_points;
-    for (size_t idx : insertion_points) {
-        if (GlobalRandom::decide(config.probability)) {
-            selected_points.push_back(idx);
-            if (static_cast<int>(selected_points.size()) >= num_insertions) break;
+    if (config.budgeted_insertion) {
+        selected_points = selectSitesBudgeted(lines, insertion_points, config);
+    } else {
+        // Decide how many insertions
+        int num_insertions = GlobalRandom::nextInt(
+            config.min_insertions,
+            std::min(config.max_insertions, static_cast<int>(insertion_points.size())));
+
+        // Shuffle and pick insertion points
+        for (size_t idx : insertion_points) {
+            if (GlobalRandom::decide(config.probability)) {
+                selected_points.push_back(idx);
+                if (static_cast<int>(selected_points.size()) >= num_insertions) break;
+            }
         }
     }
 
@@ -228,6 +277,13 @@ inline std::vector<std::string> LLVMBogusControlFlow::transform(
     // Sort in reverse order so we can insert without messing up indices
     std::sort(selected_points.rbegin(), selected_points.rend());
 
+    // Loop depth per original line; inserting back-to-front keeps the
+    // selected points valid against this map
+    std::vector<int> loop_depths;
+    if (config.tier_by_loop_depth) {
+        loop_depths = computeLoopDepths(lines);
+    }
+
     std::vector<std::string> result = lines;
 
     for (size_t point : selected_points) {
@@ -268,9 +324,16 @@ inline std::vector<std::string> LLVMBogusControlFlow::transform(
             }
         }
 
-        // Generate bogus branch (insert dead path before this point)
+        // Generate bogus branch (insert dead path before this point);
+        // cheap register-only predicates where the CPU lives
+        PredicateTier tier = PredicateTier::Full;
+        if (config.tier_by_loop_depth && point < loop_depths.size() &&
+            loop_depths[point] > 0) {
+            tier = PredicateTier::Cheap;
+        }
+
         std::vector<std::string> empty_real;  // Not used in new approach
-        auto bogus_code = insertBogusBranch(empty_real, available_vars, config);
+        auto bogus_code = insertBogusBranch(empty_real, available_vars, config, tier);
 
         // INSERT the bogus code BEFORE the target instruction (don't replace)
         result.insert(result.begin() + point, bogus_code.begin(), bogus_code.end());
@@ -282,7 +345,8 @@ inline std::vector<std::string> LLVMBogusControlFlow::transform(
 inline std::vector<std::string> LLVMBogusControlFlow::insertBogusBranch(
     const std::vector<std::string>& /* real_code - not used anymore */,
     const std::vector<std::string>& /* available_vars - not used */,
-    const BogusConfig& config) {
+    const BogusConfig& config,
+    PredicateTier tier) {
 
     // New approach: Insert a fake branch that's never taken
     // The real code continues normally, we just add an unreachable dead path
@@ -294,7 +358,7 @@ inline std::vector<std::string> LLVMBogusControlFlow::insertBogusBranch(
     std::string const2 = std::to_string(GlobalRandom::nextInt(1, 1000));
 
     // Generate opaque predicate (always true)
-    auto [pred_code, pred_var] = predicates_.generateAlwaysTrue(const1, const2);
+    auto [pred_code, pred_var] = predicates_.generateAlwaysTrue(const1, const2, tier);
 
     // Labels
     std::string continue_label = nextLabel("continue");
@@ -491,6 +555,159 @@ inline std::vector<size_t> LLVMBogusControlFlow::findInsertionPoints(
     return points;
 }
 
+inline std::vector<std::pair<size_t, size_t>> LLVMBogusControlFlow::findFunctionExtents(
+    const std::vector<std::string>& lines) {
+
+    std::vector<std::pair<size_t, size_t>> extents;
+    bool in_function = false;
+    int brace_depth = 0;
+    size_t func_start = 0;
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        const std::string& line = lines[i];
+
+        if (!in_function && line.find("define ") != std::string::npos) {
+            in_function = true;
+            func_start = i;
+            brace_depth = 0;
+        }
+        if (!in_function) continue;
+
+        for (char c : line) {
+            if (c == '{') brace_depth++;
+            if (c == '}') brace_depth--;
+        }
+
+        if (brace_depth <= 0 && i > func_start) {
+            extents.push_back({func_start, i});
+            in_function = false;
+        }
+    }
+
+    return extents;
+}
+
+inline std::vector<int> LLVMBogusControlFlow::computeLoopDepths(
+    const std::vector<std::string>& lines) {
+
+    // Difference array over line numbers: a branch at line i targeting a
+    // label defined at an earlier line L brackets [L, i] as one loop
+    // level, and the prefix sum gives each line's nesting depth
+    std::vector<int> delta(lines.size() + 1, 0);
+    std::unordered_map<std::string, size_t> label_lines;
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        const std::string& line = lines[i];
+
+        // Labels are function-local
+        if (line.find("define ") != std::string::npos) {
+            label_lines.clear();
+            continue;
+        }
+
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos) continue;
+
+        // Record label definitions ("name:" at the start of the line)
+        size_t colon_pos = line.find(':', start);
+        if (colon_pos != std::string::npos && colon_pos > start) {
+            bool is_label = true;
+            for (size_t j = start; j < colon_pos; j++) {
+                char c = line[j];
+                if (!std::isalnum((unsigned char)c) && c != '_' && c != '.') {
+                    is_label = false;
+                    break;
+                }
+            }
+            if (is_label) {
+                label_lines[line.substr(start, colon_pos - start)] = i;
+                continue;
+            }
+        }
+
+        // Branch targets already defined above form back edges
+        size_t pos = 0;
+        while ((pos = line.find("label %", pos)) != std::string::npos) {
+            pos += 7;
+            size_t end = pos;
+            while (end < line.size() &&
+                   (std::isalnum((unsigned char)line[end]) ||
+                    line[end] == '_' || line[end] == '.')) {
+                end++;
+            }
+            auto it = label_lines.find(line.substr(pos, end - pos));
+            if (it != label_lines.end()) {
+                delta[it->second]++;
+                delta[i + 1]--;
+            }
+            pos = end;
+        }
+    }
+
+    std::vector<int> depths(lines.size(), 0);
+    int depth = 0;
+    for (size_t i = 0; i < lines.size(); i++) {
+        depth += delta[i];
+        depths[i] = depth;
+    }
+    return depths;
+}
+
+inline std::vector<size_t> LLVMBogusControlFlow::selectSitesBudgeted(
+    const std::vector<std::string>& lines,
+    const std::vector<size_t>& candidates,
+    const BogusConfig& config) {
+
+    std::vector<size_t> selected;
+    auto extents = findFunctionExtents(lines);
+
+    // Rough cost of one bogus branch: predicate evaluation + branch +
+    // fake block with dead code + labels
+    const size_t lines_per_insertion =
+        static_cast<size_t>(config.dead_code_lines) + 10;
+
+    size_t cand_pos = 0;
+    for (const auto& [func_start, func_end] : extents) {
+        // Both lists are in line order, so walk the candidates once
+        std::vector<size_t> sites;
+        while (cand_pos < candidates.size() && candidates[cand_pos] < func_end) {
+            if (candidates[cand_pos] >= func_start) {
+                sites.push_back(candidates[cand_pos]);
+            }
+            cand_pos++;
+        }
+        if (sites.empty()) continue;
+
+        // K from the size budget, clamped by the configured maximum
+        size_t func_lines = func_end - func_start;
+        size_t budget_lines =
+            static_cast<size_t>(static_cast<double>(func_lines) * config.size_budget_ratio);
+        size_t k = budget_lines / lines_per_insertion;
+        if (k > static_cast<size_t>(config.max_insertions)) {
+            k = static_cast<size_t>(config.max_insertions);
+        }
+        if (k > sites.size()) k = sites.size();
+        if (k == 0) continue;
+
+        // Reservoir-sample k of this function's sites; this function's
+        // picks occupy the last k entries of `selected`
+        size_t kept = 0;
+        for (size_t i = 0; i < sites.size(); i++) {
+            if (kept < k) {
+                selected.push_back(sites[i]);
+                kept++;
+            } else {
+                size_t j = GlobalRandom::nextSize(i + 1);
+                if (j < k) {
+                    selected[selected.size() - k + j] = sites[i];
+                }
+            }
+        }
+    }
+
+    return selected;
+}
+
 inline TransformResult LLVMBogusPass::transformIR(std::vector<std::string>& lines) {
     if (!bogus_config_.enabled) {
         return TransformResult::Skipped;
@@ -11,6 +11,9 @@
 #include "../../core/transformation_base.hpp"
 #include "../../common/random.hpp"
 #include "../../common/logging.hpp"
+#include "../../common/string_interner.hpp"
+#include "../../common/identifier_renamer.hpp"
+#include "../../common/small_vector.hpp"
 
 #include <string>
 #include <vector>
@@ -30,15 +33,18 @@ struct BasicBlockInfo {
     std::string label;               // Block label (for IR)
     std::vector<std::string> code;   // Instructions in this block
 
-    // Control flow
-    std::vector<int> successors;     // IDs of successor blocks
-    std::vector<int> predecessors;   // IDs of predecessor blocks
+    // Control flow (inline storage: nearly every block has <= 4 edges,
+    // so CFG walks stay inside the block record instead of chasing a
+    // heap pointer per list)
+    SmallVector<int, 4> successors;     // IDs of successor blocks
+    SmallVector<int, 4> predecessors;   // IDs of predecessor blocks
 
     // Block type
     bool is_entry = false;           // Entry block
     bool is_exit = false;            // Return/exit block
     bool is_loop_header = false;     // Loop header
     bool is_loop_latch = false;      // Loop back-edge source
+    int loop_depth = 0;              // Natural-loop nesting depth (0 = not in a loop)
     bool has_conditional = false;    // Has conditional branch
     bool has_switch = false;         // Has switch statement
 
@@ -62,7 +68,7 @@ struct BasicBlockInfo {
     // Switch statement info
     int switch_default = -1;                                    // Default case target
     std::string switch_condition;                               // Switch condition variable
-    std::vector<std::pair<int, int>> switch_cases;              // (value, target_block_id) pairs
+    SmallVector<std::pair<int, int>, 4> switch_cases;           // (value, target_block_id) pairs
 };
 
 /**
@@ -72,16 +78,16 @@ struct CFGInfo {
     std::string function_name;
     std::vector<BasicBlockInfo> blocks;
     int entry_block = 0;
-    std::vector<int> exit_blocks;
+    SmallVector<int, 4> exit_blocks;
 
     // Loop information
-    std::vector<std::pair<int, int>> back_edges;  // (from, to) pairs
+    SmallVector<std::pair<int, int>, 4> back_edges;  // (from, to) pairs
     std::unordered_set<int> loop_headers;
 
     // Exception handling information
-    bool has_exception_handling = false;  // Function uses invoke/landingpad
-    std::vector<int> landing_pads;        // IDs of landing pad blocks
-    std::vector<int> invoke_blocks;       // IDs of blocks with invoke
+    bool has_exception_handling = false;     // Function uses invoke/landingpad
+    SmallVector<int, 2> landing_pads;        // IDs of landing pad blocks
+    SmallVector<int, 2> invoke_blocks;       // IDs of blocks with invoke
 
     // Statistics
     int num_blocks = 0;
@@ -127,6 +133,17 @@ struct CFFConfig {
     // State variable options
     std::string state_var_name = "_cff_state";
     bool use_obfuscated_state = false;  // XOR state values
+
+    // CFG analysis is read-only over the function text; with more than
+    // one thread it runs on workers that feed the serial transform
+    // stage in function order. 0/1 = analyze inline (legacy behavior).
+    int analysis_threads = 0;
+
+    // Dense dispatch: precompute a permuted but contiguous 0..n-1 state
+    // encoding per function and emit the dispatcher's cases in ascending
+    // order, so llc lowers the switch to a jump table instead of a
+    // compare ladder. Matters when CFF runs on hot request-path code.
+    bool dense_dispatch = false;
 };
 
 /**
@@ -239,6 +256,42 @@ protected:
         return states;
     }
 
+    /**
+     * Dense permuted state assignment (dense_dispatch mode)
+     *
+     * Builds the encoding in one pass over a permutation vector with the
+     * entry block pinned to state 0 - no per-block map probing during
+     * assignment, and the values are guaranteed contiguous 0..n-1 so a
+     * value-ordered dispatcher lowers to a jump table.
+     */
+    std::unordered_map<int, int> assignStatesDense(const CFGInfo& cfg,
+                                                   const CFFConfig& config) {
+        std::vector<int> block_order;
+        block_order.reserve(cfg.blocks.size());
+        for (const auto& block : cfg.blocks) {
+            if (block.id != cfg.entry_block) {
+                block_order.push_back(block.id);
+            }
+        }
+
+        if (config.shuffle_states && block_order.size() > 1) {
+            // Fisher-Yates shuffle
+            for (size_t i = block_order.size() - 1; i > 0; i--) {
+                size_t j = GlobalRandom::nextSize(i + 1);
+                std::swap(block_order[i], block_order[j]);
+            }
+        }
+
+        std::unordered_map<int, int> states;
+        states.reserve(block_order.size() + 1);
+        states[cfg.entry_block] = 0;
+        int next_state = 1;
+        for (int block_id : block_order) {
+            states[block_id] = next_state++;
+        }
+        return states;
+    }
+
     /**
      * Generate switch case for a block
      */
@@ -347,10 +400,12 @@ private:
         return "%_cff_tmp" + std::to_string(temp_counter_++);
     }
 
-    // PHI node tracking
+    // PHI node tracking (maps keyed by interned symbol IDs, not strings)
     std::vector<PhiNodeInfo> phi_nodes_;
-    std::unordered_map<std::string, std::string> phi_alloca_map_;   // PHI result -> alloca var
-    std::unordered_map<std::string, std::string> phi_replacement_map_;  // PHI result -> loaded var
+    StringInterner symbols_;
+    std::unordered_map<StringInterner::SymbolId, StringInterner::SymbolId>
+        phi_alloca_map_;       // PHI result -> alloca var
+    IdentifierRenamer phi_renamer_;  // PHI result -> loaded var, bulk-applied
 
     // Entry block allocas (moved to entry_flat for dominance)
     std::vector<std::string> entry_allocas_;
@@ -375,6 +430,11 @@ public:
 
     PassPriority getPriority() const override { return PassPriority::ControlFlow; }
 
+    // Needs branches to flatten; single-block functions cannot match
+    uint32_t requiredFeatures() const override {
+        return ir_features::kBranch | ir_features::kSwitch;
+    }
+
     bool initialize(const PassConfig& config) override {
         TransformationPass::initialize(config);
         cff_config_.enabled = config.enabled;
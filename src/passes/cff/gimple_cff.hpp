@@ -37,6 +37,7 @@ static inline gimple* morphect_last_stmt(basic_block bb) {
     return gsi_stmt(gsi);
 }
 
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -236,6 +237,25 @@ private:
      * Assign state numbers to basic blocks
      */
     void assignStates(const GimpleCFGInfo& cfg) {
+        // Collect non-entry blocks in index order
+        std::vector<basic_block> order;
+        order.reserve(cfg.index_to_bb.size());
+        for (const auto& [idx, bb] : cfg.index_to_bb) {
+            if (bb != cfg.entry_bb) {
+                order.push_back(bb);
+            }
+        }
+
+        // Dense permuted encoding: shuffle the assignment order but keep
+        // the values contiguous 0..n-1, so the dispatcher switch still
+        // lowers to a jump table rather than a compare ladder
+        if (config_.dense_dispatch && config_.shuffle_states && order.size() > 1) {
+            for (size_t i = order.size() - 1; i > 0; i--) {
+                size_t j = GlobalRandom::nextSize(i + 1);
+                std::swap(order[i], order[j]);
+            }
+        }
+
         int state = 0;
 
         // Entry block gets state 0
@@ -243,11 +263,8 @@ private:
             bb_to_state_[cfg.entry_bb] = state++;
         }
 
-        // Assign remaining blocks
-        for (const auto& [idx, bb] : cfg.index_to_bb) {
-            if (bb != cfg.entry_bb && bb_to_state_.find(bb) == bb_to_state_.end()) {
-                bb_to_state_[bb] = state++;
-            }
+        for (basic_block bb : order) {
+            bb_to_state_[bb] = state++;
         }
 
         // End state
@@ -325,9 +342,22 @@ private:
         int num_states = static_cast<int>(bb_to_state_.size());
         gswitch* sw = gimple_build_switch_nlabels(num_states, state_val, NULL_TREE);
 
-        // Add case for each state
-        int case_idx = 0;
+        // Add case for each state, in ascending state order - gimple
+        // switches want sorted labels, and the contiguous sorted range is
+        // what the RTL expander turns into a jump table
+        std::vector<std::pair<int, basic_block>> ordered_cases;
+        ordered_cases.reserve(bb_to_state_.size());
         for (const auto& [bb, state] : bb_to_state_) {
+            ordered_cases.push_back({state, bb});
+        }
+        std::sort(ordered_cases.begin(), ordered_cases.end(),
+                  [](const std::pair<int, basic_block>& a,
+                     const std::pair<int, basic_block>& b) {
+                      return a.first < b.first;
+                  });
+
+        int case_idx = 0;
+        for (const auto& [state, bb] : ordered_cases) {
             tree case_label = create_artificial_label(UNKNOWN_LOCATION);
             DECL_NONLOCAL(case_label) = 0;
 
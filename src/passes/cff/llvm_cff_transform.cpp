@@ -5,9 +5,15 @@
  */
 
 #include "cff_base.hpp"
+#include "../../common/line_matcher.hpp"
+#include "../../common/line_rope.hpp"
+#include "../../core/pass_manager.hpp"
 #include <sstream>
 #include <algorithm>
-#include <regex>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace morphect {
 namespace cff {
@@ -17,7 +23,8 @@ CFFResult LLVMCFFTransformation::flatten(const CFGInfo& cfg, const CFFConfig& co
     temp_counter_ = 0;
     phi_nodes_.clear();
     phi_alloca_map_.clear();
-    phi_replacement_map_.clear();
+    phi_renamer_.clear();
+    symbols_.clear();
     entry_allocas_.clear();  // Clear entry block allocas
     has_return_value_ = false;
     return_type_ = "void";
@@ -37,7 +44,7 @@ CFFResult LLVMCFFTransformation::flatten(const CFGInfo& cfg, const CFFConfig& co
     // Check for exception handling - skip functions with invoke/landingpad
     // Exception handling has strict structural requirements that conflict with CFF
     if (cfg.has_exception_handling) {
-        logger_.debug("Function has exception handling - skipping CFF (invoke/landingpad not supported)");
+        MORPHECT_DEBUG(logger_, "Function has exception handling - skipping CFF (invoke/landingpad not supported)");
         result.error = "Function has exception handling (invoke/landingpad) - cannot flatten";
         return result;
     }
@@ -51,10 +58,9 @@ CFFResult LLVMCFFTransformation::flatten(const CFGInfo& cfg, const CFFConfig& co
     for (const auto& block : cfg.blocks) {
         if (block.is_exit && block.terminator.find("ret ") != std::string::npos) {
             // Extract return type from terminator: "ret i32 %val" or "ret void"
-            std::regex ret_pattern(R"(ret\s+(\w+)(\s+.+)?)");
-            std::smatch match;
-            if (std::regex_search(block.terminator, match, ret_pattern)) {
-                return_type_ = match[1].str();
+            LineMatch match;
+            if (line_patterns::irRetType().search(block.terminator, match)) {
+                return_type_ = match.str(0);
                 if (return_type_ != "void") {
                     has_return_value_ = true;
                 }
@@ -78,7 +84,8 @@ CFFResult LLVMCFFTransformation::flatten(const CFGInfo& cfg, const CFFConfig& co
     }
 
     // Assign state values
-    auto states = assignStates(cfg, config);
+    auto states = config.dense_dispatch ? assignStatesDense(cfg, config)
+                                        : assignStates(cfg, config);
     int end_state = static_cast<int>(cfg.blocks.size());  // END_STATE
     result.states_created = end_state + 1;
 
@@ -116,13 +123,28 @@ CFFResult LLVMCFFTransformation::flatten(const CFGInfo& cfg, const CFFConfig& co
     output.push_back("dispatcher:");
     output.push_back("  %" + config.state_var_name + "_val = load i32, i32* %" + config.state_var_name);
 
+    // In dense mode emit cases (and the state blocks below) in ascending
+    // state order: the contiguous, sorted case range is what lets llc
+    // pick a jump table over a compare ladder
+    std::vector<const BasicBlockInfo*> emit_order;
+    emit_order.reserve(cfg.blocks.size());
+    for (const auto& block : cfg.blocks) {
+        emit_order.push_back(&block);
+    }
+    if (config.dense_dispatch) {
+        std::sort(emit_order.begin(), emit_order.end(),
+                  [&](const BasicBlockInfo* a, const BasicBlockInfo* b) {
+                      return states.at(a->id) < states.at(b->id);
+                  });
+    }
+
     // Build switch instruction
     std::stringstream switch_ss;
     switch_ss << "  switch i32 %" << config.state_var_name << "_val, label %end_state [";
 
     // Add cases for each state
-    for (const auto& block : cfg.blocks) {
-        int state = states.at(block.id);
+    for (const BasicBlockInfo* block : emit_order) {
+        int state = states.at(block->id);
         switch_ss << "\n    i32 " << state << ", label %state_" << state;
     }
     switch_ss << "\n  ]";
@@ -130,8 +152,8 @@ CFFResult LLVMCFFTransformation::flatten(const CFGInfo& cfg, const CFFConfig& co
     output.push_back("");
 
     // Generate state blocks
-    for (const auto& block : cfg.blocks) {
-        auto case_code = generateCase(block, states, end_state, config);
+    for (const BasicBlockInfo* block : emit_order) {
+        auto case_code = generateCase(*block, states, end_state, config);
         output.insert(output.end(), case_code.begin(), case_code.end());
     }
 
@@ -166,24 +188,24 @@ void LLVMCFFTransformation::collectPhiNodes(const CFGInfo& cfg) {
     for (const auto& block : cfg.blocks) {
         for (const auto& line : block.code) {
             // Check for PHI instruction: %result = phi type [ val1, %label1 ], [ val2, %label2 ]
-            std::regex phi_pattern(R"(\s*(%[\w.]+)\s*=\s*phi\s+(\w+)\s+(.+))");
-            std::smatch match;
-            if (std::regex_search(line, match, phi_pattern)) {
+            LineMatch match;
+            if (line_patterns::irPhi().search(line, match)) {
                 PhiNodeInfo phi;
-                phi.result = match[1].str();
-                phi.type = match[2].str();
+                phi.result = match.str(0);
+                phi.type = match.str(1);
                 phi.block_id = block.id;
 
                 // Parse incoming values: [ val, %label ], ...
-                std::string args = match[3].str();
-                std::regex arg_pattern(R"(\[\s*([^,]+),\s*%([\w.]+)\s*\])");
-                auto args_begin = std::sregex_iterator(args.begin(), args.end(), arg_pattern);
-                auto args_end = std::sregex_iterator();
-
-                for (std::sregex_iterator i = args_begin; i != args_end; ++i) {
-                    std::smatch arg_match = *i;
-                    phi.incoming_values.push_back(arg_match[1].str());
-                    phi.incoming_labels.push_back(arg_match[2].str());
+                std::string args = match.str(2);
+                LineMatch arg_match;
+                size_t arg_end = 0;
+                size_t pos = 0;
+                while ((pos = line_patterns::irPhiArg().searchFrom(
+                            args, pos, arg_match, arg_end)) !=
+                       LinePattern::npos) {
+                    phi.incoming_values.push_back(arg_match.str(0));
+                    phi.incoming_labels.push_back(arg_match.str(1));
+                    pos = arg_end;
                 }
 
                 phi_nodes_.push_back(phi);
@@ -224,15 +246,10 @@ std::vector<std::string> LLVMCFFTransformation::generateCase(
             continue;
         }
 
-        // Replace PHI variable references with loaded values
+        // Replace PHI variable references with loaded values: one token
+        // scan regardless of how many PHIs the function has
         std::string modified_line = line;
-        for (const auto& [phi_result, loaded_var] : phi_replacement_map_) {
-            size_t pos = 0;
-            while ((pos = modified_line.find(phi_result, pos)) != std::string::npos) {
-                modified_line.replace(pos, phi_result.length(), loaded_var);
-                pos += loaded_var.length();
-            }
-        }
+        phi_renamer_.applyToLine(modified_line);
         output.push_back(modified_line);
     }
 
@@ -300,11 +317,10 @@ std::vector<std::string> LLVMCFFTransformation::generateStateUpdate(
         if (block.terminator.find("ret ") != std::string::npos &&
             block.terminator.find("ret void") == std::string::npos) {
             // Extract return type and value from terminator: "ret i32 %val" or "ret i32 0"
-            std::regex ret_val(R"(ret\s+(\w+)\s+(.+))");
-            std::smatch match;
-            if (std::regex_search(block.terminator, match, ret_val)) {
-                std::string ret_type = match[1].str();
-                std::string ret_value = match[2].str();
+            LineMatch match;
+            if (line_patterns::irRetValue().search(block.terminator, match)) {
+                std::string ret_type = match.str(0);
+                std::string ret_value = match.str(1);
                 // Store the return value for retrieval at end_state
                 output.push_back("  store " + ret_type + " " + ret_value +
                                 ", " + ret_type + "* " + return_alloca_);
@@ -447,7 +463,7 @@ std::vector<std::string> LLVMCFFTransformation::generatePhiHandling(
         const auto& phi = phi_nodes_[i];
         std::string var_name = "%phi_var_" + std::to_string(i);
         output.push_back("  " + var_name + " = alloca " + phi.type);
-        phi_alloca_map_[phi.result] = var_name;
+        phi_alloca_map_[symbols_.intern(phi.result)] = symbols_.intern(var_name);
     }
     output.push_back("");
 
@@ -463,21 +479,22 @@ std::vector<std::string> LLVMCFFTransformation::generatePhiStores(
     // For each PHI node that has this block as a predecessor,
     // generate a store of the incoming value
 
-    for (const auto& [phi_result, alloca_var] : phi_alloca_map_) {
-        // Find the PHI node info
-        for (const auto& phi : phi_nodes_) {
-            if (phi.result == phi_result) {
-                // Check if current block is a predecessor
-                for (size_t i = 0; i < phi.incoming_labels.size(); i++) {
-                    if (phi.incoming_labels[i] == block.label) {
-                        // Store the incoming value
-                        std::string type = phi.type;
-                        std::string value = phi.incoming_values[i];
-                        output.push_back("  store " + type + " " + value +
-                                        ", " + type + "* " + alloca_var);
-                        break;
-                    }
-                }
+    for (const auto& phi : phi_nodes_) {
+        auto it = phi_alloca_map_.find(symbols_.find(phi.result));
+        if (it == phi_alloca_map_.end()) {
+            continue;
+        }
+        std::string alloca_var(symbols_.view(it->second));
+
+        // Check if current block is a predecessor
+        for (size_t i = 0; i < phi.incoming_labels.size(); i++) {
+            if (phi.incoming_labels[i] == block.label) {
+                // Store the incoming value
+                std::string type = phi.type;
+                std::string value = phi.incoming_values[i];
+                output.push_back("  store " + type + " " + value +
+                                ", " + type + "* " + alloca_var);
+                break;
             }
         }
     }
@@ -493,13 +510,14 @@ std::vector<std::string> LLVMCFFTransformation::generatePhiLoads(
     // For each PHI node in this block, generate a load
     for (const auto& phi : phi_nodes_) {
         if (phi.block_id == block.id) {
-            auto it = phi_alloca_map_.find(phi.result);
+            auto it = phi_alloca_map_.find(symbols_.find(phi.result));
             if (it != phi_alloca_map_.end()) {
                 std::string loaded = phi.result + "_loaded";
                 output.push_back("  " + loaded + " = load " + phi.type +
-                                ", " + phi.type + "* " + it->second);
+                                ", " + phi.type + "* " +
+                                std::string(symbols_.view(it->second)));
                 // Note: Uses of phi.result should be replaced with loaded
-                phi_replacement_map_[phi.result] = loaded;
+                phi_renamer_.add(phi.result, loaded);
             }
         }
     }
@@ -511,6 +529,27 @@ std::vector<std::string> LLVMCFFTransformation::generatePhiLoads(
 // LLVMCFFPass Implementation
 // ============================================================================
 
+namespace {
+
+/**
+ * Extract the function name from a "define ... @name(..." line
+ */
+std::string functionNameFromDefine(const std::string& define_line) {
+    size_t at = define_line.find('@');
+    if (at == std::string::npos) return "";
+
+    size_t end = at + 1;
+    while (end < define_line.size() &&
+           (isalnum(static_cast<unsigned char>(define_line[end])) ||
+            define_line[end] == '_' || define_line[end] == '.' ||
+            define_line[end] == '$')) {
+        end++;
+    }
+    return define_line.substr(at + 1, end - at - 1);
+}
+
+} // namespace
+
 TransformResult LLVMCFFPass::transformIR(std::vector<std::string>& lines) {
     if (!cff_config_.enabled) {
         return TransformResult::Skipped;
@@ -524,25 +563,96 @@ TransformResult LLVMCFFPass::transformIR(std::vector<std::string>& lines) {
     }
 
     int transformed = 0;
-    std::vector<std::string> new_lines;
+
+    // Parallel analysis phase: CFG construction is read-only over the
+    // function text, so workers analyze functions ahead of the (serial)
+    // transform stage, which consumes results in function order and
+    // blocks only when it outruns the analyzers
+    size_t n_workers = 0;
+    if (cff_config_.analysis_threads > 1 && functions.size() > 1) {
+        n_workers = std::min(static_cast<size_t>(cff_config_.analysis_threads),
+                             functions.size());
+    }
+
+    std::vector<std::vector<std::string>> extracted(n_workers > 0 ? functions.size() : 0);
+    std::vector<std::optional<CFGInfo>> analyzed(n_workers > 0 ? functions.size() : 0);
+    std::vector<char> analysis_done(functions.size(), 0);
+    std::mutex analysis_mutex;
+    std::condition_variable analysis_cv;
+    std::atomic<size_t> next_func{0};
+    std::vector<std::thread> analysis_pool;
+
+    for (size_t w = 0; w < n_workers; w++) {
+        analysis_pool.emplace_back([&]() {
+            LLVMCFGAnalyzer worker_analyzer;
+            for (;;) {
+                size_t i = next_func.fetch_add(1);
+                if (i >= functions.size()) break;
+                auto func_lines =
+                    extractFunction(lines, functions[i].first, functions[i].second);
+                auto cfg = worker_analyzer.analyze(func_lines);
+                {
+                    std::lock_guard<std::mutex> lock(analysis_mutex);
+                    extracted[i] = std::move(func_lines);
+                    analyzed[i] = std::move(cfg);
+                    analysis_done[i] = 1;
+                }
+                analysis_cv.notify_all();
+            }
+        });
+    }
+
+    // Rebuild through a rope: kept ranges move over as whole chunks and
+    // flattened regions splice in, instead of re-copying the lines vector
+    // around every transformed function
+    LineRope rope;
     size_t last_end = 0;
 
-    for (const auto& [start, end] : functions) {
-        // Copy lines before this function
-        for (size_t i = last_end; i < start; i++) {
-            new_lines.push_back(lines[i]);
+    for (size_t fi = 0; fi < functions.size(); fi++) {
+        const auto& [start, end] = functions[fi];
+
+        std::vector<std::string> func_lines;
+        std::optional<CFGInfo> cfg_opt;
+
+        if (n_workers > 0) {
+            // Consume this function's result from the analysis pipeline
+            std::unique_lock<std::mutex> lock(analysis_mutex);
+            analysis_cv.wait(lock, [&]() { return analysis_done[fi] != 0; });
+            func_lines = std::move(extracted[fi]);
+            cfg_opt = std::move(analyzed[fi]);
+        } else {
+            // Extract function (before moving anything out of lines)
+            func_lines = extractFunction(lines, start, end);
         }
 
-        // Extract function
-        auto func_lines = extractFunction(lines, start, end);
+        // Move lines before this function over unchanged
+        rope.appendMoved(lines, last_end, start);
+
+        std::string func_name = functionNameFromDefine(func_lines.front());
+
+        // Serial path: analyze here, reusing a memoized result when the
+        // shared cache is attached and no earlier pass rewrote this
+        // function. (The parallel phase always analyzes fresh - the
+        // cache's single-threaded fill path is not worth serializing
+        // the workers over.)
+        if (n_workers == 0) {
+            if (analysis_cache_ && !func_name.empty()) {
+                auto cached = analysis_cache_->getOrCompute<CFGInfo>(
+                    "cfg", func_name,
+                    [&]() -> std::shared_ptr<const CFGInfo> {
+                        auto computed = analyzer_.analyze(func_lines);
+                        if (!computed.has_value()) return nullptr;
+                        return std::make_shared<CFGInfo>(std::move(*computed));
+                    });
+                if (cached) cfg_opt = *cached;
+            } else {
+                cfg_opt = analyzer_.analyze(func_lines);
+            }
+        }
 
-        // Analyze CFG
-        auto cfg_opt = analyzer_.analyze(func_lines);
         if (!cfg_opt.has_value()) {
             // Couldn't analyze - keep original
-            for (size_t i = start; i <= end; i++) {
-                new_lines.push_back(lines[i]);
-            }
+            rope.appendChunk(std::move(func_lines));
             last_end = end + 1;
             continue;
         }
@@ -553,9 +663,7 @@ TransformResult LLVMCFFPass::transformIR(std::vector<std::string>& lines) {
         if (!analyzer_.isSuitable(cfg, cff_config_) ||
             !GlobalRandom::decide(cff_config_.probability)) {
             // Keep original
-            for (size_t i = start; i <= end; i++) {
-                new_lines.push_back(lines[i]);
-            }
+            rope.appendChunk(std::move(func_lines));
             last_end = end + 1;
             continue;
         }
@@ -565,36 +673,39 @@ TransformResult LLVMCFFPass::transformIR(std::vector<std::string>& lines) {
 
         if (result.success) {
             // Extract function signature from original
-            new_lines.push_back(lines[start]);  // define line
+            rope.append(std::move(func_lines.front()));  // define line
 
             // Add flattened code
-            for (const auto& line : result.transformed_code) {
-                new_lines.push_back(line);
-            }
+            rope.appendChunk(std::move(result.transformed_code));
 
             // Close function
-            new_lines.push_back("}");
+            rope.append("}");
 
             transformed++;
             incrementStat("functions_flattened");
             incrementStat("blocks_flattened", result.original_blocks);
+
+            // This function's text changed; cached analyses are stale
+            if (analysis_cache_ && !func_name.empty()) {
+                analysis_cache_->invalidateFunction(func_name);
+            }
         }
         else {
             // Keep original on failure
-            for (size_t i = start; i <= end; i++) {
-                new_lines.push_back(lines[i]);
-            }
+            rope.appendChunk(std::move(func_lines));
         }
 
         last_end = end + 1;
     }
 
-    // Copy remaining lines
-    for (size_t i = last_end; i < lines.size(); i++) {
-        new_lines.push_back(lines[i]);
+    for (auto& worker : analysis_pool) {
+        worker.join();
     }
 
-    lines = std::move(new_lines);
+    // Move remaining lines
+    rope.appendMoved(lines, last_end, lines.size());
+
+    lines = rope.flatten();
 
     return transformed > 0 ? TransformResult::Success : TransformResult::NotApplicable;
 }
@@ -334,6 +334,39 @@ void LLVMCFGAnalyzer::identifyLoops(CFGInfo& cfg) {
             latch->is_loop_latch = true;
         }
     }
+
+    // Per-block loop depth: for each back edge (latch -> header) the
+    // natural loop body is the header plus every block that reaches the
+    // latch without passing through the header (reverse walk from the
+    // latch). A block's depth is the number of such loops containing it.
+    for (const auto& edge : cfg.back_edges) {
+        int latch = edge.first;
+        int header = edge.second;
+
+        std::unordered_set<int> body;
+        body.insert(header);
+        std::vector<int> worklist;
+        if (body.insert(latch).second) {
+            worklist.push_back(latch);
+        }
+        while (!worklist.empty()) {
+            int node = worklist.back();
+            worklist.pop_back();
+            auto* block = cfg.getBlock(node);
+            if (!block) continue;
+            for (int pred : block->predecessors) {
+                if (body.insert(pred).second) {
+                    worklist.push_back(pred);
+                }
+            }
+        }
+
+        for (int node : body) {
+            if (auto* block = cfg.getBlock(node)) {
+                block->loop_depth++;
+            }
+        }
+    }
 }
 
 void LLVMCFGAnalyzer::dfsLoops(CFGInfo& cfg, int node,
@@ -10,6 +10,7 @@
 
 #include "../../common/random.hpp"
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <climits>
@@ -23,6 +24,20 @@ enum class PredicateType {
     ContextDependent  // uses existing vars
 };
 
+/**
+ * Cost tier of a predicate family.
+ *
+ * Cheap predicates compile to 2-3 register-only ALU ops — no loads, no
+ * multiplies or divides — so they can sit inside hot loops without
+ * wrecking throughput. Full predicates are stronger-looking but pricier;
+ * callers pick the tier per insertion site (cheap in loops, full on
+ * cold straight-line code).
+ */
+enum class PredicateTier {
+    Cheap,
+    Full
+};
+
 struct ContextPredicateInfo {
     std::string variable;
     std::string variable_type;      // i32, i64, etc
@@ -37,6 +52,7 @@ struct OpaquePredicate {
     PredicateType type;
     std::string description;
     std::function<std::vector<std::string>(const std::string&, const std::string&)> llvm_generator;
+    PredicateTier tier = PredicateTier::Full;
 };
 
 struct ContextOpaquePredicate {
@@ -56,6 +72,21 @@ struct ContextOpaquePredicate {
 
 class OpaquePredicateLibrary {
 public:
+    /**
+     * Pregenerated predicate instantiation
+     *
+     * The IR of each predicate family depends only on the operand and
+     * temp register names, so it is synthesized once at construction
+     * with canonical placeholders (%__x, %__y, %__t<N>) and stamped
+     * with real names on every draw. Running the generator lambdas per
+     * insertion site used to dominate bogus-control-flow pass time.
+     */
+    struct PooledPredicate {
+        size_t predicate_idx = 0;        // into getAllPredicates()
+        std::vector<std::string> lines;  // canonical placeholder form
+        int temp_count = 0;
+    };
+
     OpaquePredicateLibrary();
 
     const OpaquePredicate& getAlwaysTrue();
@@ -63,13 +94,32 @@ public:
     const OpaquePredicate* getByName(const std::string& name);
     const std::vector<OpaquePredicate>& getAllPredicates() const { return predicates_; }
 
-    // returns (ir code, result var)
+    const std::vector<PooledPredicate>& getTruePool() const { return true_pool_; }
+    const std::vector<PooledPredicate>& getFalsePool() const { return false_pool_; }
+
+    // stamp a pool entry with real operand names; returns (ir code, result var)
+    std::pair<std::vector<std::string>, std::string>
+    instantiatePooled(const PooledPredicate& pooled,
+                      const std::string& var1, const std::string& var2);
+
+    // returns (ir code, result var); draws a random entry from the pool.
+    // The tier overloads restrict the draw: Cheap pulls only the
+    // register-only families, Full keeps the whole pool (the default,
+    // matching the tierless overloads).
     std::pair<std::vector<std::string>, std::string>
     generateAlwaysTrue(const std::string& var1, const std::string& var2);
 
+    std::pair<std::vector<std::string>, std::string>
+    generateAlwaysTrue(const std::string& var1, const std::string& var2,
+                       PredicateTier tier);
+
     std::pair<std::vector<std::string>, std::string>
     generateAlwaysFalse(const std::string& var1, const std::string& var2);
 
+    std::pair<std::vector<std::string>, std::string>
+    generateAlwaysFalse(const std::string& var1, const std::string& var2,
+                        PredicateTier tier);
+
     const std::vector<ContextOpaquePredicate>& getContextPredicates() const {
         return context_predicates_;
     }
@@ -91,6 +141,13 @@ private:
 
     std::vector<ContextOpaquePredicate> context_predicates_;
 
+    std::vector<PooledPredicate> true_pool_;
+    std::vector<PooledPredicate> false_pool_;
+
+    // Indices into the pools above, restricted to Cheap-tier families
+    std::vector<size_t> cheap_true_pool_;
+    std::vector<size_t> cheap_false_pool_;
+
     int temp_counter_ = 0;
     std::string nextTemp() {
         return "%_op_tmp" + std::to_string(temp_counter_++);
@@ -98,6 +155,8 @@ private:
 
     void initializePredicates();
     void initializeContextPredicates();
+    void initializePredicatePool();
+    int canonicalizePoolTemps(std::vector<std::string>& lines);
 };
 
 namespace predicates {
@@ -265,6 +324,92 @@ inline std::vector<std::string> orLtAnd(
     return code;
 }
 
+// cheap tier: 2-3 register-only ALU ops, no loads, no multiplies
+
+// x - x == 0 always
+inline std::vector<std::string> subSelfZero(
+    const std::string& x,
+    const std::string& result_var,
+    int& temp_counter) {
+
+    std::vector<std::string> code;
+    std::string t1 = "%_op_t" + std::to_string(temp_counter++);
+
+    code.push_back("  " + t1 + " = sub i32 " + x + ", " + x);
+    code.push_back("  " + result_var + " = icmp eq i32 " + t1 + ", 0");
+
+    return code;
+}
+
+// ((x | y) & x) == x -- absorption law, always true
+inline std::vector<std::string> absorption(
+    const std::string& x,
+    const std::string& y,
+    const std::string& result_var,
+    int& temp_counter) {
+
+    std::vector<std::string> code;
+    std::string t1 = "%_op_t" + std::to_string(temp_counter++);
+    std::string t2 = "%_op_t" + std::to_string(temp_counter++);
+
+    code.push_back("  " + t1 + " = or i32 " + x + ", " + y);
+    code.push_back("  " + t2 + " = and i32 " + t1 + ", " + x);
+    code.push_back("  " + result_var + " = icmp eq i32 " + t2 + ", " + x);
+
+    return code;
+}
+
+// (x ^ y) == (y ^ x) always
+inline std::vector<std::string> xorCommutes(
+    const std::string& x,
+    const std::string& y,
+    const std::string& result_var,
+    int& temp_counter) {
+
+    std::vector<std::string> code;
+    std::string t1 = "%_op_t" + std::to_string(temp_counter++);
+    std::string t2 = "%_op_t" + std::to_string(temp_counter++);
+
+    code.push_back("  " + t1 + " = xor i32 " + x + ", " + y);
+    code.push_back("  " + t2 + " = xor i32 " + y + ", " + x);
+    code.push_back("  " + result_var + " = icmp eq i32 " + t1 + ", " + t2);
+
+    return code;
+}
+
+// x - x != 0 never
+inline std::vector<std::string> subSelfNonZero(
+    const std::string& x,
+    const std::string& result_var,
+    int& temp_counter) {
+
+    std::vector<std::string> code;
+    std::string t1 = "%_op_t" + std::to_string(temp_counter++);
+
+    code.push_back("  " + t1 + " = sub i32 " + x + ", " + x);
+    code.push_back("  " + result_var + " = icmp ne i32 " + t1 + ", 0");
+
+    return code;
+}
+
+// (x & y) >u (x | y) never -- AND clears bits OR keeps
+inline std::vector<std::string> andUgtOr(
+    const std::string& x,
+    const std::string& y,
+    const std::string& result_var,
+    int& temp_counter) {
+
+    std::vector<std::string> code;
+    std::string t1 = "%_op_t" + std::to_string(temp_counter++);
+    std::string t2 = "%_op_t" + std::to_string(temp_counter++);
+
+    code.push_back("  " + t1 + " = and i32 " + x + ", " + y);
+    code.push_back("  " + t2 + " = or i32 " + x + ", " + y);
+    code.push_back("  " + result_var + " = icmp ugt i32 " + t1 + ", " + t2);
+
+    return code;
+}
+
 // context predicates - use existing program vars
 using cff::ContextPredicateInfo;
 
@@ -396,6 +541,7 @@ inline std::vector<std::string> shiftMask(
 inline OpaquePredicateLibrary::OpaquePredicateLibrary() {
     initializePredicates();
     initializeContextPredicates();
+    initializePredicatePool();
 }
 
 inline void OpaquePredicateLibrary::initializePredicates() {
@@ -439,7 +585,44 @@ inline void OpaquePredicateLibrary::initializePredicates() {
         [this](const std::string& x, const std::string&) {
             std::string result = nextTemp();
             return predicates::xorSelfZero(x, result, temp_counter_);
-        }
+        },
+        PredicateTier::Cheap
+    });
+    true_indices_.push_back(predicates_.size() - 1);
+
+    predicates_.push_back({
+        "sub_self_zero",
+        PredicateType::AlwaysTrue,
+        "(x - x) == 0",
+        [this](const std::string& x, const std::string&) {
+            std::string result = nextTemp();
+            return predicates::subSelfZero(x, result, temp_counter_);
+        },
+        PredicateTier::Cheap
+    });
+    true_indices_.push_back(predicates_.size() - 1);
+
+    predicates_.push_back({
+        "absorption",
+        PredicateType::AlwaysTrue,
+        "((x | y) & x) == x",
+        [this](const std::string& x, const std::string& y) {
+            std::string result = nextTemp();
+            return predicates::absorption(x, y, result, temp_counter_);
+        },
+        PredicateTier::Cheap
+    });
+    true_indices_.push_back(predicates_.size() - 1);
+
+    predicates_.push_back({
+        "xor_commutes",
+        PredicateType::AlwaysTrue,
+        "(x ^ y) == (y ^ x)",
+        [this](const std::string& x, const std::string& y) {
+            std::string result = nextTemp();
+            return predicates::xorCommutes(x, y, result, temp_counter_);
+        },
+        PredicateTier::Cheap
     });
     true_indices_.push_back(predicates_.size() - 1);
 
@@ -484,7 +667,32 @@ inline void OpaquePredicateLibrary::initializePredicates() {
         [this](const std::string& x, const std::string&) {
             std::string result = nextTemp();
             return predicates::xorSelfNonZero(x, result, temp_counter_);
-        }
+        },
+        PredicateTier::Cheap
+    });
+    false_indices_.push_back(predicates_.size() - 1);
+
+    predicates_.push_back({
+        "sub_self_nonzero",
+        PredicateType::AlwaysFalse,
+        "(x - x) != 0",
+        [this](const std::string& x, const std::string&) {
+            std::string result = nextTemp();
+            return predicates::subSelfNonZero(x, result, temp_counter_);
+        },
+        PredicateTier::Cheap
+    });
+    false_indices_.push_back(predicates_.size() - 1);
+
+    predicates_.push_back({
+        "and_ugt_or",
+        PredicateType::AlwaysFalse,
+        "(x & y) >u (x | y)",
+        [this](const std::string& x, const std::string& y) {
+            std::string result = nextTemp();
+            return predicates::andUgtOr(x, y, result, temp_counter_);
+        },
+        PredicateTier::Cheap
     });
     false_indices_.push_back(predicates_.size() - 1);
 
@@ -519,10 +727,119 @@ inline const OpaquePredicate* OpaquePredicateLibrary::getByName(const std::strin
     return nullptr;
 }
 
+/**
+ * Rename the generator-produced temps in a pool entry to canonical
+ * %__t<N> placeholders, in first-appearance order
+ */
+inline int OpaquePredicateLibrary::canonicalizePoolTemps(std::vector<std::string>& lines) {
+    std::unordered_map<std::string, std::string> mapping;
+
+    for (auto& line : lines) {
+        std::string rebuilt;
+        rebuilt.reserve(line.size());
+        size_t i = 0;
+        while (i < line.size()) {
+            if (line[i] != '%') {
+                rebuilt += line[i++];
+                continue;
+            }
+            size_t end = i + 1;
+            while (end < line.size() &&
+                   (isalnum((unsigned char)line[end]) ||
+                    line[end] == '_' || line[end] == '.')) {
+                end++;
+            }
+            std::string name = line.substr(i, end - i);
+            // covers both %_op_t<N> and %_op_tmp<N> (the result var)
+            if (name.compare(0, 6, "%_op_t") == 0) {
+                auto it = mapping.find(name);
+                if (it == mapping.end()) {
+                    it = mapping.emplace(
+                        name, "%__t" + std::to_string(mapping.size())).first;
+                }
+                rebuilt += it->second;
+            } else {
+                rebuilt += name;
+            }
+            i = end;
+        }
+        line = std::move(rebuilt);
+    }
+
+    return static_cast<int>(mapping.size());
+}
+
+/**
+ * Run every generator once with placeholder operands and store the
+ * canonicalized IR, so per-site generation becomes a substitution scan
+ */
+inline void OpaquePredicateLibrary::initializePredicatePool() {
+    auto buildEntry = [this](size_t idx) {
+        PooledPredicate pooled;
+        pooled.predicate_idx = idx;
+        pooled.lines = predicates_[idx].llvm_generator("%__x", "%__y");
+        pooled.temp_count = canonicalizePoolTemps(pooled.lines);
+        return pooled;
+    };
+
+    true_pool_.reserve(true_indices_.size());
+    for (size_t idx : true_indices_) {
+        true_pool_.push_back(buildEntry(idx));
+    }
+    false_pool_.reserve(false_indices_.size());
+    for (size_t idx : false_indices_) {
+        false_pool_.push_back(buildEntry(idx));
+    }
+
+    for (size_t i = 0; i < true_pool_.size(); i++) {
+        if (predicates_[true_pool_[i].predicate_idx].tier == PredicateTier::Cheap) {
+            cheap_true_pool_.push_back(i);
+        }
+    }
+    for (size_t i = 0; i < false_pool_.size(); i++) {
+        if (predicates_[false_pool_[i].predicate_idx].tier == PredicateTier::Cheap) {
+            cheap_false_pool_.push_back(i);
+        }
+    }
+}
+
 inline std::pair<std::vector<std::string>, std::string>
-OpaquePredicateLibrary::generateAlwaysTrue(const std::string& var1, const std::string& var2) {
-    const auto& pred = getAlwaysTrue();
-    auto code = pred.llvm_generator(var1, var2);
+OpaquePredicateLibrary::instantiatePooled(const PooledPredicate& pooled,
+                                          const std::string& var1,
+                                          const std::string& var2) {
+    // Fresh temp names for this instantiation
+    int base = temp_counter_;
+    temp_counter_ += pooled.temp_count;
+
+    std::vector<std::string> code;
+    code.reserve(pooled.lines.size());
+    for (const auto& tmpl : pooled.lines) {
+        std::string out;
+        out.reserve(tmpl.size() + 16);
+        size_t i = 0;
+        while (i < tmpl.size()) {
+            if (tmpl[i] == '%' && i + 3 < tmpl.size() &&
+                tmpl.compare(i, 3, "%__") == 0) {
+                char tag = tmpl[i + 3];
+                if (tag == 'x') { out += var1; i += 4; continue; }
+                if (tag == 'y') { out += var2; i += 4; continue; }
+                if (tag == 't') {
+                    size_t end = i + 4;
+                    int idx = 0;
+                    while (end < tmpl.size() &&
+                           isdigit((unsigned char)tmpl[end])) {
+                        idx = idx * 10 + (tmpl[end] - '0');
+                        end++;
+                    }
+                    out += "%_op_t" + std::to_string(base + idx);
+                    i = end;
+                    continue;
+                }
+            }
+            out += tmpl[i++];
+        }
+        code.push_back(std::move(out));
+    }
 
     // Extract result variable from last instruction
     std::string result_var;
@@ -539,22 +856,39 @@ OpaquePredicateLibrary::generateAlwaysTrue(const std::string& var1, const std::s
 }
 
 inline std::pair<std::vector<std::string>, std::string>
-OpaquePredicateLibrary::generateAlwaysFalse(const std::string& var1, const std::string& var2) {
-    const auto& pred = getAlwaysFalse();
-    auto code = pred.llvm_generator(var1, var2);
+OpaquePredicateLibrary::generateAlwaysTrue(const std::string& var1, const std::string& var2) {
+    const auto& pooled =
+        true_pool_[GlobalRandom::nextInt(0, static_cast<int>(true_pool_.size()) - 1)];
+    return instantiatePooled(pooled, var1, var2);
+}
 
-    // Extract result variable from last instruction
-    std::string result_var;
-    if (!code.empty()) {
-        const std::string& last = code.back();
-        size_t eq_pos = last.find(" = ");
-        if (eq_pos != std::string::npos) {
-            size_t start = last.find_first_not_of(" \t");
-            result_var = last.substr(start, eq_pos - start);
-        }
+inline std::pair<std::vector<std::string>, std::string>
+OpaquePredicateLibrary::generateAlwaysTrue(const std::string& var1, const std::string& var2,
+                                           PredicateTier tier) {
+    if (tier == PredicateTier::Cheap && !cheap_true_pool_.empty()) {
+        const auto& pooled = true_pool_[cheap_true_pool_[
+            GlobalRandom::nextInt(0, static_cast<int>(cheap_true_pool_.size()) - 1)]];
+        return instantiatePooled(pooled, var1, var2);
     }
+    return generateAlwaysTrue(var1, var2);
+}
 
-    return {code, result_var};
+inline std::pair<std::vector<std::string>, std::string>
+OpaquePredicateLibrary::generateAlwaysFalse(const std::string& var1, const std::string& var2) {
+    const auto& pooled =
+        false_pool_[GlobalRandom::nextInt(0, static_cast<int>(false_pool_.size()) - 1)];
+    return instantiatePooled(pooled, var1, var2);
+}
+
+inline std::pair<std::vector<std::string>, std::string>
+OpaquePredicateLibrary::generateAlwaysFalse(const std::string& var1, const std::string& var2,
+                                            PredicateTier tier) {
+    if (tier == PredicateTier::Cheap && !cheap_false_pool_.empty()) {
+        const auto& pooled = false_pool_[cheap_false_pool_[
+            GlobalRandom::nextInt(0, static_cast<int>(cheap_false_pool_.size()) - 1)]];
+        return instantiatePooled(pooled, var1, var2);
+    }
+    return generateAlwaysFalse(var1, var2);
 }
 
 inline void OpaquePredicateLibrary::initializeContextPredicates() {
@@ -43,13 +43,26 @@ public:
         const std::vector<std::string>& lines,
         const CallStackObfConfig& config) override {
 
+        return transform(lines, analyzer_.buildIndex(lines), config);
+    }
+
+    /**
+     * Transform against a prebuilt call-site index
+     *
+     * Pipelines that already ran the analyzer (e.g. alongside the
+     * indirect-call pass) pass their index in so the module text is
+     * not scanned a second time.
+     */
+    CallStackObfResult transform(
+        const std::vector<std::string>& lines,
+        const CallSiteIndex& index,
+        const CallStackObfConfig& config) {
+
         CallStackObfResult result;
         result.transformed_code = lines;
 
-        // Analyze the code to find calls and functions
-        LLVMCallSiteAnalyzer analyzer;
-        auto calls = analyzer.findCalls(lines);
-        auto functions = analyzer.extractFunctions(lines);
+        const auto& calls = index.calls;
+        const auto& functions = index.functions;
 
         // Collect function names for fake calls
         std::vector<std::string> available_functions;
@@ -59,8 +72,8 @@ public:
             }
         }
 
-        // Track proxies to create
-        std::unordered_map<std::string, ProxyFunctionInfo> proxies_needed;
+        // Pool proxies by callee signature
+        ProxyPool pool;
 
         // Track replacements
         std::vector<std::pair<int, std::vector<std::string>>> replacements;
@@ -75,16 +88,10 @@ public:
                 continue;
             }
 
-            // Create proxy for this call signature
-            std::string proxy_key = getProxyKey(call, functions);
-            ProxyFunctionInfo proxy;
-
-            if (proxies_needed.find(proxy_key) == proxies_needed.end()) {
-                proxy = createProxyInfo(call, functions, config);
-                proxies_needed[proxy_key] = proxy;
-            } else {
-                proxy = proxies_needed[proxy_key];
-            }
+            // Share a pooled proxy across call sites with this shape
+            const ProxyFunctionInfo& proxy = pool.acquire(
+                CallSiteIndex::argumentShape(call), config.proxy_fanout,
+                [&]() { return createProxyInfo(call, functions, config); });
 
             // Generate proxied call
             auto proxied = generateProxiedCall(call, proxy, functions, config);
@@ -112,38 +119,27 @@ public:
                            functions, config, result.fake_calls_added);
         }
 
-        // Insert proxy function definitions
-        for (const auto& [key, proxy] : proxies_needed) {
-            auto proxy_def = generateProxyDefinition(proxy, config);
-            insertProxyDefinition(result.transformed_code, proxy_def);
-            result.proxies.push_back(proxy);
-            result.proxy_functions_created++;
+        // Emit all proxy definitions as one contiguous section
+        if (!pool.proxies().empty()) {
+            std::vector<std::string> section;
+            section.push_back("");
+            section.push_back("; Proxy section (" +
+                std::to_string(pool.proxies().size()) + " proxies)");
+            for (const auto& proxy : pool.proxies()) {
+                auto proxy_def = generateProxyDefinition(proxy, config);
+                section.insert(section.end(), proxy_def.begin(), proxy_def.end());
+                result.proxies.push_back(proxy);
+                result.proxy_functions_created++;
+            }
+            insertProxyDefinition(result.transformed_code, section);
         }
 
+        result.proxy_calls_pooled = pool.reused();
         result.success = true;
         return result;
     }
 
 private:
-    /**
-     * Get a unique key for proxy function based on signature
-     */
-    std::string getProxyKey(const CallSiteInfo& call,
-                           const std::unordered_map<std::string, FunctionInfo>& functions) {
-        std::string key = call.callee_type + "(";
-        for (size_t i = 0; i < call.arguments.size(); i++) {
-            if (i > 0) key += ",";
-            // Extract type from argument
-            const auto& arg = call.arguments[i];
-            size_t space = arg.find(' ');
-            if (space != std::string::npos) {
-                key += arg.substr(0, space);
-            }
-        }
-        key += ")";
-        return key;
-    }
-
     /**
      * Create proxy function info
      */
@@ -434,6 +430,8 @@ private:
 
         code.insert(code.begin() + insert_pos, proxy_def.begin(), proxy_def.end());
     }
+
+    LLVMCallSiteAnalyzer analyzer_;
 };
 
 /**
@@ -477,6 +475,7 @@ public:
             statistics_["calls_proxied"] = cso_result.calls_proxied;
             statistics_["fake_calls_added"] = cso_result.fake_calls_added;
             statistics_["proxy_functions_created"] = cso_result.proxy_functions_created;
+            statistics_["proxy_calls_pooled"] = cso_result.proxy_calls_pooled;
             return TransformResult::Success;
         } else {
             return TransformResult::Error;
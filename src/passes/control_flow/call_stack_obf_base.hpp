@@ -89,6 +89,7 @@ struct CallStackObfConfig {
     ProxyType proxy_type = ProxyType::Simple;
     bool use_single_dispatcher = false;  // All calls through one dispatcher
     std::string proxy_prefix = "_proxy_";
+    int proxy_fanout = 1;            // Distinct proxies per callee signature
 
     // Fake call options
     int min_fake_calls = 1;
@@ -115,6 +116,7 @@ struct CallStackObfResult {
     int calls_proxied = 0;
     int fake_calls_added = 0;
     int proxy_functions_created = 0;
+    int proxy_calls_pooled = 0;      // Call sites served by an existing proxy
 
     std::vector<ProxyFunctionInfo> proxies;
     std::vector<std::string> transformed_code;
@@ -231,6 +233,58 @@ public:
     }
 };
 
+/**
+ * Pool of proxy functions keyed by callee signature
+ *
+ * Generating a fresh trampoline per call site makes large modules slow
+ * to emit and link and scatters near-identical bodies across the
+ * I-cache. The pool hands call sites with the same target shape one
+ * shared proxy; a fanout above one keeps several interchangeable
+ * proxies per shape so not every call funnels through the same name.
+ * Proxies are stored in creation order so the definitions can be
+ * emitted as one contiguous section.
+ */
+class ProxyPool {
+public:
+    /**
+     * Get a proxy for the given signature, creating one via create()
+     * while the signature's slot count is below fanout
+     */
+    template <typename CreateFn>
+    const ProxyFunctionInfo& acquire(const std::string& signature,
+                                     int fanout, CreateFn create) {
+        auto& slots = pool_[signature];
+        if (static_cast<int>(slots.size()) < (fanout < 1 ? 1 : fanout)) {
+            slots.push_back(proxies_.size());
+            proxies_.push_back(create());
+            return proxies_.back();
+        }
+
+        reused_++;
+        if (slots.size() == 1) {
+            return proxies_[slots[0]];
+        }
+        size_t pick = slots[GlobalRandom::nextInt(
+            0, static_cast<int>(slots.size()) - 1)];
+        return proxies_[pick];
+    }
+
+    const std::vector<ProxyFunctionInfo>& proxies() const { return proxies_; }
+
+    int reused() const { return reused_; }
+
+    void clear() {
+        proxies_.clear();
+        pool_.clear();
+        reused_ = 0;
+    }
+
+private:
+    std::vector<ProxyFunctionInfo> proxies_;
+    std::unordered_map<std::string, std::vector<size_t>> pool_;
+    int reused_ = 0;
+};
+
 /**
  * Base class for call stack obfuscation
  */
@@ -162,10 +162,15 @@ public:
         IndirectBranchResult result;
         result.transformed_code = lines;
 
-        // Track which lines to replace
-        std::vector<std::pair<int, std::vector<std::string>>> replacements;
+        if (config.dedupe_tables) {
+            table_manager_.reset();
+        }
+
+        // Select branches and build their tables first; with dedup the
+        // shared table's final size is only known once every table has
+        // been registered, so code generation is a second phase
+        std::vector<const BranchInfo*> selected;
 
-        // Process each branch
         for (const auto& branch : branches) {
             if (!isBranchSuitable(branch, config)) {
                 continue;
@@ -177,8 +182,34 @@ public:
 
             // Create jump table for this branch
             JumpTable table = createJumpTable(branch, config);
-            result.tables.push_back(table);
             result.tables_created++;
+            result.decoy_entries_added += static_cast<int>(table.table_size - table.real_entries);
+
+            if (config.dedupe_tables) {
+                table.base_offset = table_manager_.registerTable(table);
+            }
+
+            result.tables.push_back(table);
+            selected.push_back(&branch);
+        }
+
+        if (config.dedupe_tables) {
+            result.tables_deduped = table_manager_.tablesDeduped();
+            result.table_bytes_saved = table_manager_.bytesSaved();
+
+            // All tables now address slots of the one shared global
+            for (auto& table : result.tables) {
+                table.table_name = config.shared_table_name;
+                table.table_size = table_manager_.size();
+            }
+        }
+
+        // Track which lines to replace
+        std::vector<std::pair<int, std::vector<std::string>>> replacements;
+
+        for (size_t i = 0; i < selected.size(); i++) {
+            const BranchInfo& branch = *selected[i];
+            const JumpTable& table = result.tables[i];
 
             // Generate replacement code
             std::vector<std::string> replacement;
@@ -193,7 +224,6 @@ public:
 
             replacements.push_back({branch.line_number, replacement});
             result.branches_transformed++;
-            result.decoy_entries_added += static_cast<int>(table.table_size - table.real_entries);
         }
 
         // Apply replacements in reverse order to preserve line numbers
@@ -211,7 +241,7 @@ public:
         }
 
         // Insert jump table declarations at module level
-        insertJumpTableDeclarations(result);
+        insertJumpTableDeclarations(result, config);
 
         result.success = true;
         return result;
@@ -343,8 +373,10 @@ private:
         // We store the obfuscated value and reverse it
         code.push_back("  ; Indirect branch (unconditional)");
 
-        // Create the "encrypted" index value
-        std::string const_obf_idx = std::to_string(entry->obfuscated_index);
+        // Create the "encrypted" index value (shifted into the shared
+        // table's slot range when tables are deduplicated)
+        std::string const_obf_idx = std::to_string(
+            entry->obfuscated_index + static_cast<int>(table.base_offset));
 
         // Load from jump table
         code.push_back("  " + ptr_var + " = getelementptr inbounds [" +
@@ -405,6 +437,14 @@ private:
         auto idx_code = generateIndexCalculation(table, idx_var, obf_idx_var, config);
         code.insert(code.end(), idx_code.begin(), idx_code.end());
 
+        // Shift into the shared table's slot range
+        if (table.base_offset > 0) {
+            std::string based_var = "%" + nextTemp();
+            code.push_back("  " + based_var + " = add i64 " + obf_idx_var +
+                ", " + std::to_string(table.base_offset));
+            obf_idx_var = based_var;
+        }
+
         // Load from jump table
         code.push_back("  " + ptr_var + " = getelementptr inbounds [" +
             std::to_string(table.table_size) + " x i8*], [" +
@@ -460,6 +500,14 @@ private:
         auto idx_code = generateIndexCalculation(table, idx_var, obf_idx_var, config);
         code.insert(code.end(), idx_code.begin(), idx_code.end());
 
+        // Shift into the shared table's slot range
+        if (table.base_offset > 0) {
+            std::string based_var = "%" + nextTemp();
+            code.push_back("  " + based_var + " = add i64 " + obf_idx_var +
+                ", " + std::to_string(table.base_offset));
+            obf_idx_var = based_var;
+        }
+
         // Bounds check for safety (go to default if out of bounds)
         std::string bounds_var = "%" + nextTemp();
         std::string safe_idx = "%" + nextTemp();
@@ -496,9 +544,30 @@ private:
     /**
      * Insert jump table declarations at module level
      */
-    void insertJumpTableDeclarations(IndirectBranchResult& result) {
+    void insertJumpTableDeclarations(IndirectBranchResult& result,
+                                     const IndirectBranchConfig& config) {
         std::vector<std::string> declarations;
 
+        if (config.dedupe_tables) {
+            // One shared table; every branch addresses it via its base offset
+            if (table_manager_.size() > 0) {
+                std::string entries;
+                for (const auto& label : table_manager_.content()) {
+                    if (!entries.empty()) entries += ", ";
+                    entries += "i8* blockaddress(@_func_, %" + label + ")";
+                }
+                declarations.push_back("; Shared jump table (" +
+                    std::to_string(result.tables_created) + " tables, " +
+                    std::to_string(result.tables_deduped) + " deduplicated)");
+                declarations.push_back("@" + config.shared_table_name +
+                    " = private unnamed_addr constant [" +
+                    std::to_string(table_manager_.size()) + " x i8*] [" +
+                    entries + "]");
+            }
+            insertDeclarations(result, declarations);
+            return;
+        }
+
         for (const auto& table : result.tables) {
             // Build table entries
             std::string entries;
@@ -521,6 +590,14 @@ private:
                 std::to_string(table.table_size) + " x i8*] [" + entries + "]");
         }
 
+        insertDeclarations(result, declarations);
+    }
+
+    /**
+     * Insert declarations before the first function definition
+     */
+    void insertDeclarations(IndirectBranchResult& result,
+                            const std::vector<std::string>& declarations) {
         // Insert declarations near the top of the module
         // Find a suitable insertion point (after module-level declarations)
         size_t insert_pos = 0;
@@ -537,6 +614,8 @@ private:
             result.transformed_code.begin() + insert_pos,
             declarations.begin(), declarations.end());
     }
+
+    JumpTableManager table_manager_;
 };
 
 /**
@@ -585,6 +664,10 @@ public:
             statistics_["branches_transformed"] = ib_result.branches_transformed;
             statistics_["tables_created"] = ib_result.tables_created;
             statistics_["decoy_entries"] = ib_result.decoy_entries_added;
+            if (ib_config_.dedupe_tables) {
+                statistics_["tables_deduped"] = ib_result.tables_deduped;
+                statistics_["table_bytes_saved"] = ib_result.table_bytes_saved;
+            }
             return TransformResult::Success;
         } else {
             return TransformResult::Error;
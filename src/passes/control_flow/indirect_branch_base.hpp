@@ -17,6 +17,7 @@
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
+#include <algorithm>
 
 namespace morphect {
 namespace control_flow {
@@ -65,6 +66,10 @@ struct JumpTable {
     size_t real_entries = 0;             // Number of real entries
     bool has_decoys = false;
 
+    // Offset into the shared table when tables are deduplicated
+    // (0 and unused when each table is emitted on its own)
+    size_t base_offset = 0;
+
     /**
      * Get entry by obfuscated index
      */
@@ -90,6 +95,159 @@ struct JumpTable {
     }
 };
 
+/**
+ * Module-level jump table manager
+ *
+ * Each transformed branch gets its own JumpTable; across a large module
+ * those tables are heavily redundant and bloat both the .ll and the
+ * final binary's rodata. The manager concatenates table contents into
+ * one shared global: a table identical to one already registered (or
+ * contained in / overlapping the shared content) reuses existing slots,
+ * otherwise only the non-overlapping tail is appended. Each table keeps
+ * a base offset into the shared content.
+ */
+class JumpTableManager {
+public:
+    /**
+     * Register a table and return its base offset in the shared content
+     */
+    size_t registerTable(const JumpTable& table) {
+        std::vector<std::string> slots = slotLabels(table);
+
+        // Identical table seen before
+        std::string signature = signatureOf(slots);
+        auto it = base_by_signature_.find(signature);
+        if (it != base_by_signature_.end()) {
+            tables_deduped_++;
+            entries_saved_ += slots.size();
+            return it->second;
+        }
+
+        // Contained in the shared content already
+        size_t base = findSubsequence(slots);
+        if (base == npos) {
+            // Overlap the longest suffix of the content with a prefix
+            // of the new slots, then append the remainder
+            size_t overlap = suffixOverlap(slots);
+            base = content_.size() - overlap;
+            entries_saved_ += overlap;
+            for (size_t i = overlap; i < slots.size(); i++) {
+                content_.push_back(slots[i]);
+            }
+        } else {
+            tables_deduped_++;
+            entries_saved_ += slots.size();
+        }
+
+        base_by_signature_[signature] = base;
+        return base;
+    }
+
+    const std::vector<std::string>& content() const { return content_; }
+    size_t size() const { return content_.size(); }
+
+    int tablesDeduped() const { return tables_deduped_; }
+
+    /**
+     * Rodata bytes saved versus emitting every table in full
+     * (entries are pointers, 8 bytes each on x86-64)
+     */
+    int bytesSaved() const {
+        return static_cast<int>(entries_saved_) * 8;
+    }
+
+    void reset() {
+        content_.clear();
+        base_by_signature_.clear();
+        tables_deduped_ = 0;
+        entries_saved_ = 0;
+    }
+
+    /**
+     * Target label at each table slot, in emission order
+     *
+     * Mirrors how the per-table emitters place entries: an entry sits
+     * at its obfuscated index when that lands inside the table, decoy
+     * slots fill the tail, and anything unresolved falls back to the
+     * first real target (safe - decoys already point at real targets).
+     */
+    static std::vector<std::string> slotLabels(const JumpTable& table) {
+        std::vector<std::string> slots;
+        slots.reserve(table.table_size);
+
+        for (size_t i = 0; i < table.table_size; i++) {
+            const std::string* label = nullptr;
+            for (const auto& entry : table.entries) {
+                if (static_cast<size_t>(entry.obfuscated_index) == i ||
+                    (entry.is_decoy && i >= table.real_entries)) {
+                    label = &entry.target_label;
+                    break;
+                }
+            }
+            if (!label && !table.entries.empty()) {
+                label = &table.entries.front().target_label;
+            }
+            slots.push_back(label ? *label : "");
+        }
+
+        return slots;
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    static std::string signatureOf(const std::vector<std::string>& slots) {
+        std::string signature;
+        for (const auto& label : slots) {
+            signature += label;
+            signature += '|';
+        }
+        return signature;
+    }
+
+    /**
+     * Find slots as a contiguous run inside the shared content
+     */
+    size_t findSubsequence(const std::vector<std::string>& slots) const {
+        if (slots.empty() || slots.size() > content_.size()) {
+            return npos;
+        }
+        for (size_t start = 0; start + slots.size() <= content_.size(); start++) {
+            size_t i = 0;
+            while (i < slots.size() && content_[start + i] == slots[i]) {
+                i++;
+            }
+            if (i == slots.size()) {
+                return start;
+            }
+        }
+        return npos;
+    }
+
+    /**
+     * Longest suffix of the shared content equal to a prefix of slots
+     */
+    size_t suffixOverlap(const std::vector<std::string>& slots) const {
+        size_t max_overlap = std::min(content_.size(), slots.size());
+        for (size_t overlap = max_overlap; overlap > 0; overlap--) {
+            size_t start = content_.size() - overlap;
+            size_t i = 0;
+            while (i < overlap && content_[start + i] == slots[i]) {
+                i++;
+            }
+            if (i == overlap) {
+                return overlap;
+            }
+        }
+        return 0;
+    }
+
+    std::vector<std::string> content_;
+    std::unordered_map<std::string, size_t> base_by_signature_;
+    int tables_deduped_ = 0;
+    size_t entries_saved_ = 0;
+};
+
 /**
  * Configuration for indirect branch pass
  */
@@ -107,6 +265,8 @@ struct IndirectBranchConfig {
     int min_decoy_count = 1;
     int max_decoy_count = 3;
     bool shuffle_entries = true;         // Randomize entry order
+    bool dedupe_tables = false;          // Merge tables into one shared global
+    std::string shared_table_name = "_jt_shared";
 
     // Target-specific
     bool use_pic = true;                 // Position-independent code (relative offsets)
@@ -126,6 +286,8 @@ struct IndirectBranchResult {
     int branches_transformed = 0;
     int tables_created = 0;
     int decoy_entries_added = 0;
+    int tables_deduped = 0;
+    int table_bytes_saved = 0;
 
     std::vector<JumpTable> tables;
     std::vector<std::string> transformed_code;
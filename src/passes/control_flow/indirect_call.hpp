@@ -41,25 +41,12 @@ public:
         int call_id = 0;
         std::string current_function;
 
-        // Pattern for call instructions
-        // Matches: %result = call type @func(args)
-        //      or: call void @func(args)
-        std::regex call_with_result(
-            R"(^\s*(%[\w.]+)\s*=\s*(?:tail\s+|musttail\s+)?call\s+(\S+)\s+@(\w+)\s*\(([^)]*)\)(.*)$)");
-        std::regex call_void(
-            R"(^\s*(?:tail\s+|musttail\s+)?call\s+void\s+@(\w+)\s*\(([^)]*)\)(.*)$)");
-        std::regex call_with_type(
-            R"(^\s*(%[\w.]+)\s*=\s*(?:tail\s+|musttail\s+)?call\s+([^@]+)@(\w+)\s*\(([^)]*)\)(.*)$)");
-
-        // Function definition pattern
-        std::regex func_def(R"(^\s*define\s+.*@(\w+)\s*\()");
-
         for (size_t i = 0; i < lines.size(); i++) {
             const std::string& line = lines[i];
             std::smatch match;
 
             // Track current function
-            if (std::regex_search(line, match, func_def)) {
+            if (std::regex_search(line, match, funcDefRegex())) {
                 current_function = match[1].str();
                 continue;
             }
@@ -69,108 +56,193 @@ public:
                 continue;
             }
 
-            // Call with result
-            if (std::regex_search(line, match, call_with_result)) {
-                CallSiteInfo info;
-                info.id = call_id++;
-                info.caller_function = current_function;
-                info.result_var = match[1].str();
-                info.callee_type = match[2].str();
-                info.callee_function = match[3].str();
-                info.original_instruction = line;
-                info.line_number = static_cast<int>(i);
-                info.call_attributes = match[5].str();
-
-                // Parse arguments
-                parseArguments(match[4].str(), info.arguments);
-
-                // Check for tail call
-                info.is_tail_call = (line.find("tail call") != std::string::npos);
-                info.is_must_tail = (line.find("musttail") != std::string::npos);
-
-                calls.push_back(info);
+            matchCallLine(line, i, current_function, call_id, calls);
+        }
+
+        return calls;
+    }
+
+    std::unordered_map<std::string, FunctionInfo> extractFunctions(
+        const std::vector<std::string>& lines) override {
+
+        std::unordered_map<std::string, FunctionInfo> functions;
+
+        for (const auto& line : lines) {
+            std::smatch match;
+            if (std::regex_search(line, match, funcSigRegex())) {
+                FunctionInfo info = makeFunctionInfo(match);
+                functions[info.name] = info;
+            }
+        }
+
+        return functions;
+    }
+
+    /**
+     * Build the full call-site index in a single pass
+     *
+     * findCalls and extractFunctions each walk the whole module; this
+     * fuses the two so the module text is parsed once, then groups the
+     * calls by caller and callee.
+     */
+    CallSiteIndex buildIndex(const std::vector<std::string>& lines) override {
+        CallSiteIndex index;
+        int call_id = 0;
+        std::string current_function;
+
+        for (size_t i = 0; i < lines.size(); i++) {
+            const std::string& line = lines[i];
+            std::smatch match;
+
+            // Function signature (define or declare)
+            if (std::regex_search(line, match, funcSigRegex())) {
+                FunctionInfo info = makeFunctionInfo(match);
+                if (!info.is_declaration) {
+                    current_function = info.name;
+                }
+                index.functions[info.name] = info;
                 continue;
             }
 
-            // Call with complex type (includes function type before @)
-            if (std::regex_search(line, match, call_with_type)) {
-                CallSiteInfo info;
-                info.id = call_id++;
-                info.caller_function = current_function;
-                info.result_var = match[1].str();
-                info.callee_type = trimWhitespace(match[2].str());
-                info.callee_function = match[3].str();
-                info.original_instruction = line;
-                info.line_number = static_cast<int>(i);
-                info.call_attributes = match[5].str();
-
-                parseArguments(match[4].str(), info.arguments);
-                info.is_tail_call = (line.find("tail call") != std::string::npos);
-
-                calls.push_back(info);
+            // define lines whose attribute clutter defeats the
+            // signature pattern still move the caller tracker
+            if (std::regex_search(line, match, funcDefRegex())) {
+                current_function = match[1].str();
                 continue;
             }
 
-            // Void call
-            if (std::regex_search(line, match, call_void)) {
-                CallSiteInfo info;
-                info.id = call_id++;
-                info.caller_function = current_function;
-                info.callee_type = "void";
-                info.callee_function = match[1].str();
-                info.original_instruction = line;
-                info.line_number = static_cast<int>(i);
-                info.call_attributes = match[3].str();
-
-                parseArguments(match[2].str(), info.arguments);
-                info.is_tail_call = (line.find("tail call") != std::string::npos);
-
-                calls.push_back(info);
+            if (line.find("@llvm.") != std::string::npos) {
                 continue;
             }
+
+            matchCallLine(line, i, current_function, call_id, index.calls);
         }
 
-        return calls;
+        index.buildGroups();
+        return index;
     }
 
-    std::unordered_map<std::string, FunctionInfo> extractFunctions(
-        const std::vector<std::string>& lines) override {
-
-        std::unordered_map<std::string, FunctionInfo> functions;
+private:
+    // Patterns shared by findCalls and buildIndex, constructed once
+    static const std::regex& funcDefRegex() {
+        static const std::regex re(R"(^\s*define\s+.*@(\w+)\s*\()");
+        return re;
+    }
 
-        // Pattern for function definitions and declarations
-        std::regex func_def(
+    static const std::regex& funcSigRegex() {
+        static const std::regex re(
             R"(^\s*(define|declare)\s+(\S+)\s+@(\w+)\s*\(([^)]*)\))");
+        return re;
+    }
 
-        for (const auto& line : lines) {
-            std::smatch match;
-            if (std::regex_search(line, match, func_def)) {
-                FunctionInfo info;
-                info.name = match[3].str();
-                info.return_type = match[2].str();
-                info.is_declaration = (match[1].str() == "declare");
-                info.is_external = info.is_declaration;
-
-                // Parse parameters
-                std::string params = match[4].str();
-                if (params.find("...") != std::string::npos) {
-                    info.is_vararg = true;
-                }
+    /**
+     * Match one line against the call patterns; appends to out and
+     * returns true when the line is a direct call
+     */
+    bool matchCallLine(const std::string& line, size_t line_no,
+                       const std::string& current_function,
+                       int& call_id, std::vector<CallSiteInfo>& out) {
 
-                // Build full signature
-                info.full_signature = info.return_type + " (" + params + ")";
+        // Pattern for call instructions
+        // Matches: %result = call type @func(args)
+        //      or: call void @func(args)
+        static const std::regex call_with_result(
+            R"(^\s*(%[\w.]+)\s*=\s*(?:tail\s+|musttail\s+)?call\s+(\S+)\s+@(\w+)\s*\(([^)]*)\)(.*)$)");
+        static const std::regex call_void(
+            R"(^\s*(?:tail\s+|musttail\s+)?call\s+void\s+@(\w+)\s*\(([^)]*)\)(.*)$)");
+        static const std::regex call_with_type(
+            R"(^\s*(%[\w.]+)\s*=\s*(?:tail\s+|musttail\s+)?call\s+([^@]+)@(\w+)\s*\(([^)]*)\)(.*)$)");
 
-                // Parse parameter types
-                parseParamTypes(params, info.param_types);
+        std::smatch match;
+
+        // Call with result
+        if (std::regex_search(line, match, call_with_result)) {
+            CallSiteInfo info;
+            info.id = call_id++;
+            info.caller_function = current_function;
+            info.result_var = match[1].str();
+            info.callee_type = match[2].str();
+            info.callee_function = match[3].str();
+            info.original_instruction = line;
+            info.line_number = static_cast<int>(line_no);
+            info.call_attributes = match[5].str();
+
+            // Parse arguments
+            parseArguments(match[4].str(), info.arguments);
+
+            // Check for tail call
+            info.is_tail_call = (line.find("tail call") != std::string::npos);
+            info.is_must_tail = (line.find("musttail") != std::string::npos);
+
+            out.push_back(info);
+            return true;
+        }
 
-                functions[info.name] = info;
-            }
+        // Call with complex type (includes function type before @)
+        if (std::regex_search(line, match, call_with_type)) {
+            CallSiteInfo info;
+            info.id = call_id++;
+            info.caller_function = current_function;
+            info.result_var = match[1].str();
+            info.callee_type = trimWhitespace(match[2].str());
+            info.callee_function = match[3].str();
+            info.original_instruction = line;
+            info.line_number = static_cast<int>(line_no);
+            info.call_attributes = match[5].str();
+
+            parseArguments(match[4].str(), info.arguments);
+            info.is_tail_call = (line.find("tail call") != std::string::npos);
+
+            out.push_back(info);
+            return true;
         }
 
-        return functions;
+        // Void call
+        if (std::regex_search(line, match, call_void)) {
+            CallSiteInfo info;
+            info.id = call_id++;
+            info.caller_function = current_function;
+            info.callee_type = "void";
+            info.callee_function = match[1].str();
+            info.original_instruction = line;
+            info.line_number = static_cast<int>(line_no);
+            info.call_attributes = match[3].str();
+
+            parseArguments(match[2].str(), info.arguments);
+            info.is_tail_call = (line.find("tail call") != std::string::npos);
+
+            out.push_back(info);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Build a FunctionInfo from a funcSigRegex match
+     */
+    FunctionInfo makeFunctionInfo(const std::smatch& match) {
+        FunctionInfo info;
+        info.name = match[3].str();
+        info.return_type = match[2].str();
+        info.is_declaration = (match[1].str() == "declare");
+        info.is_external = info.is_declaration;
+
+        // Parse parameters
+        std::string params = match[4].str();
+        if (params.find("...") != std::string::npos) {
+            info.is_vararg = true;
+        }
+
+        // Build full signature
+        info.full_signature = info.return_type + " (" + params + ")";
+
+        // Parse parameter types
+        parseParamTypes(params, info.param_types);
+
+        return info;
     }
 
-private:
     void parseArguments(const std::string& args_str,
                        std::vector<std::string>& args) {
         if (args_str.empty()) return;
@@ -261,6 +333,14 @@ public:
         result.decoy_entries_added = static_cast<int>(
             result.table.table_size - result.table.real_functions);
 
+        // Flat layout: hash entries into slots and rewrite the table so
+        // emission and call-site indices address the slot array
+        FlatFunctionTable flat;
+        if (config.use_flat_table) {
+            flat.build(result.table);
+            flat.applyLayout(result.table);
+        }
+
         // Create index map: function_name -> table_index
         std::unordered_map<std::string, int> func_to_index;
         for (const auto& entry : result.table.entries) {
@@ -274,11 +354,14 @@ public:
 
         // Transform each call
         for (const auto& call : to_transform) {
-            auto it = func_to_index.find(call.callee_function);
-            if (it == func_to_index.end()) continue;
-
-            int table_index = it->second;
-            const auto* entry = result.table.getEntryByIndex(table_index);
+            const FunctionTableEntry* entry = nullptr;
+            if (config.use_flat_table) {
+                entry = flat.find(call.callee_function);
+            } else {
+                auto it = func_to_index.find(call.callee_function);
+                if (it == func_to_index.end()) continue;
+                entry = result.table.getEntryByIndex(it->second);
+            }
             if (!entry) continue;
 
             // Generate replacement code
@@ -304,7 +387,7 @@ public:
         }
 
         // Insert function table declaration
-        insertTableDeclaration(result, functions);
+        insertTableDeclaration(result, functions, config);
 
         result.success = true;
         return result;
@@ -490,14 +573,21 @@ private:
      * Insert function table declaration at module level
      */
     void insertTableDeclaration(IndirectCallResult& result,
-        const std::unordered_map<std::string, FunctionInfo>& functions) {
+        const std::unordered_map<std::string, FunctionInfo>& functions,
+        const IndirectCallConfig& config) {
 
         std::vector<std::string> declarations;
 
         const auto& table = result.table;
 
         // Build table initializer
-        declarations.push_back("; Function pointer table");
+        if (config.use_flat_table) {
+            declarations.push_back("; Function pointer table (flat, open-addressed, " +
+                std::to_string(table.real_functions) + "/" +
+                std::to_string(table.table_size) + " slots)");
+        } else {
+            declarations.push_back("; Function pointer table");
+        }
 
         std::string entries_str;
         for (size_t i = 0; i < table.entries.size(); i++) {
@@ -574,16 +664,14 @@ public:
             return TransformResult::Skipped;
         }
 
-        // Find all calls
-        auto calls = analyzer_.findCalls(lines);
-        statistics_["calls_found"] = static_cast<int>(calls.size());
-
-        // Extract function information
-        auto functions = analyzer_.extractFunctions(lines);
-        statistics_["functions_found"] = static_cast<int>(functions.size());
+        // One scan builds calls, functions and the groupings
+        CallSiteIndex index = analyzer_.buildIndex(lines);
+        statistics_["calls_found"] = static_cast<int>(index.calls.size());
+        statistics_["functions_found"] = static_cast<int>(index.functions.size());
 
         // Transform calls
-        auto ic_result = transformer_.transform(lines, calls, functions, ic_config_);
+        auto ic_result = transformer_.transform(lines, index.calls,
+                                                index.functions, ic_config_);
 
         if (ic_result.success) {
             lines = std::move(ic_result.transformed_code);
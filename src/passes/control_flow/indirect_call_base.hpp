@@ -20,6 +20,7 @@
 #include "../../core/transformation_base.hpp"
 #include "../../common/random.hpp"
 #include "../../common/logging.hpp"
+#include "../../common/incremental_cache.hpp"
 
 #include <string>
 #include <vector>
@@ -121,6 +122,114 @@ struct FunctionTable {
     }
 };
 
+/**
+ * Flat open-addressed layout for the function pointer table
+ *
+ * FunctionTable resolves names by linear scan and its emitted layout
+ * packs entries in insertion order. The flat layout stores entries in
+ * one contiguous power-of-two array addressed by an FNV hash of the
+ * function name seeded with the table's obfuscation key, with linear
+ * probing. Kept at most half full, a lookup is one probe in the common
+ * case - both at transform time and in the emitted runtime table,
+ * where every obfuscated indirect call hits a cache-resident slot.
+ */
+class FlatFunctionTable {
+public:
+    /**
+     * Build the slot array from a populated function table
+     */
+    void build(const FunctionTable& table) {
+        seed_ = table.global_xor_key;
+
+        // Power-of-two capacity, at most half full
+        capacity_ = 8;
+        while (capacity_ < table.entries.size() * 2) {
+            capacity_ *= 2;
+        }
+
+        slots_.assign(capacity_, FunctionTableEntry{});
+        occupied_.assign(capacity_, false);
+
+        for (const auto& entry : table.entries) {
+            size_t slot = hashKey(entry.function_name) & (capacity_ - 1);
+            while (occupied_[slot]) {
+                slot = (slot + 1) & (capacity_ - 1);
+            }
+            slots_[slot] = entry;
+            slots_[slot].index = static_cast<int>(slot);
+            occupied_[slot] = true;
+        }
+    }
+
+    /**
+     * FNV hash of the function name, seeded with the obfuscation key
+     */
+    uint64_t hashKey(const std::string& name) const {
+        return IncrementalCache::combine(IncrementalCache::hashText(name), seed_);
+    }
+
+    /**
+     * Look up an entry by name (one probe unless a collision chained)
+     */
+    const FunctionTableEntry* find(const std::string& name) const {
+        if (capacity_ == 0) {
+            return nullptr;
+        }
+        size_t slot = hashKey(name) & (capacity_ - 1);
+        for (size_t probe = 0; probe < capacity_; probe++) {
+            if (!occupied_[slot]) {
+                return nullptr;
+            }
+            if (slots_[slot].function_name == name) {
+                return &slots_[slot];
+            }
+            slot = (slot + 1) & (capacity_ - 1);
+        }
+        return nullptr;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    bool isOccupied(size_t slot) const { return occupied_[slot]; }
+
+    /**
+     * Rewrite a function table into slot order for emission
+     *
+     * Empty slots become decoys pointing at the first real function so
+     * a probe landing anywhere in the array stays safe to call.
+     */
+    void applyLayout(FunctionTable& table) const {
+        const FunctionTableEntry* filler = nullptr;
+        for (size_t i = 0; i < capacity_; i++) {
+            if (occupied_[i] && !slots_[i].is_decoy) {
+                filler = &slots_[i];
+                break;
+            }
+        }
+
+        table.entries.clear();
+        for (size_t i = 0; i < capacity_; i++) {
+            if (occupied_[i]) {
+                table.entries.push_back(slots_[i]);
+            } else if (filler) {
+                FunctionTableEntry empty = *filler;
+                empty.index = static_cast<int>(i);
+                empty.is_decoy = true;
+                empty.decoy_target = filler->function_name;
+                table.entries.push_back(empty);
+            }
+        }
+        table.table_size = table.entries.size();
+        table.has_decoys = true;
+    }
+
+private:
+    std::vector<FunctionTableEntry> slots_;
+    std::vector<bool> occupied_;
+    size_t capacity_ = 0;
+    uint64_t seed_ = 0;
+};
+
 /**
  * Information about a call site to transform
  */
@@ -142,6 +251,56 @@ struct CallSiteInfo {
     bool is_must_tail = false;
 };
 
+/**
+ * Module-wide call-site index
+ *
+ * One analysis pass over the module produces everything the
+ * call-oriented passes ask about: the call sites, the function map and
+ * groupings by caller and callee. Indirect-call and call-stack
+ * obfuscation consume the same index instead of each re-scanning the
+ * module for the same facts.
+ */
+struct CallSiteIndex {
+    std::vector<CallSiteInfo> calls;
+    std::unordered_map<std::string, FunctionInfo> functions;
+
+    // Indices into calls, grouped during construction
+    std::unordered_map<std::string, std::vector<int>> calls_by_caller;
+    std::unordered_map<std::string, std::vector<int>> calls_by_callee;
+
+    /**
+     * Canonical "ret(type,type,...)" key for a call's argument shape.
+     * Calls with the same shape can share a proxy or a table slot.
+     */
+    static std::string argumentShape(const CallSiteInfo& call) {
+        std::string key = call.callee_type + "(";
+        for (size_t i = 0; i < call.arguments.size(); i++) {
+            if (i > 0) key += ",";
+            const std::string& arg = call.arguments[i];
+            size_t space = arg.find(' ');
+            if (space != std::string::npos) {
+                key += arg.substr(0, space);
+            }
+        }
+        key += ")";
+        return key;
+    }
+
+    /**
+     * Rebuild the caller/callee groupings from calls
+     */
+    void buildGroups() {
+        calls_by_caller.clear();
+        calls_by_callee.clear();
+        for (size_t i = 0; i < calls.size(); i++) {
+            calls_by_caller[calls[i].caller_function].push_back(
+                static_cast<int>(i));
+            calls_by_callee[calls[i].callee_function].push_back(
+                static_cast<int>(i));
+        }
+    }
+};
+
 /**
  * Configuration for indirect call pass
  */
@@ -158,6 +317,7 @@ struct IndirectCallConfig {
     int min_decoy_count = 1;
     int max_decoy_count = 3;
     bool shuffle_entries = true;
+    bool use_flat_table = false;     // Open-addressed slot layout (one-probe lookups)
 
     // Function filtering
     std::vector<std::string> exclude_functions;  // Don't redirect these
@@ -204,6 +364,20 @@ public:
     virtual std::unordered_map<std::string, FunctionInfo> extractFunctions(
         const std::vector<std::string>& lines) = 0;
 
+    /**
+     * Build the module-wide call-site index
+     *
+     * The default composes findCalls and extractFunctions (two scans);
+     * analyzers that can fuse the two into a single pass override it.
+     */
+    virtual CallSiteIndex buildIndex(const std::vector<std::string>& lines) {
+        CallSiteIndex index;
+        index.calls = findCalls(lines);
+        index.functions = extractFunctions(lines);
+        index.buildGroups();
+        return index;
+    }
+
     /**
      * Check if a call should be transformed
      */
@@ -20,6 +20,8 @@
 #include <regex>
 #include <cmath>
 #include <cstring>
+#include <map>
+#include <algorithm>
 
 namespace morphect {
 namespace data {
@@ -59,17 +61,46 @@ public:
 
     /**
      * Obfuscate a constant using random strategy
+     *
+     * With memoization on, the derived expression is cached per
+     * (value, strategy): values like 0 and 1 recur tens of thousands of
+     * times, and the decomposition math only needs to run once for each
+     * combination. The strategy is still drawn per occurrence, so a hot
+     * constant keeps one variant per configured strategy.
      */
     ObfuscatedConstant obfuscate(int64_t value) const {
         if (config_.strategies.empty()) {
-            return obfuscateXOR(value);
+            return config_.memoize ? memoized(value, ConstantObfStrategy::XOR)
+                                   : obfuscateXOR(value);
         }
 
         // Select random strategy
         size_t idx = GlobalRandom::nextSize(config_.strategies.size());
+        if (config_.memoize) {
+            return memoized(value, config_.strategies[idx]);
+        }
         return obfuscateWithStrategy(value, config_.strategies[idx]);
     }
 
+    /**
+     * Warm the memo table for a set of hot constants (one entry per
+     * configured strategy), so the transform loop only does lookups for
+     * the values a pre-scan found most frequent
+     */
+    void precompute(const std::vector<int64_t>& hot_values) {
+        for (int64_t value : hot_values) {
+            if (config_.strategies.empty()) {
+                memoized(value, ConstantObfStrategy::XOR);
+                continue;
+            }
+            for (ConstantObfStrategy strategy : config_.strategies) {
+                memoized(value, strategy);
+            }
+        }
+    }
+
+    size_t memoSize() const { return memo_.size(); }
+
     /**
      * Obfuscate with specific strategy
      */
@@ -102,6 +133,18 @@ public:
 private:
     ConstantObfConfig config_;
     Logger logger_;
+    mutable std::map<std::pair<int64_t, int>, ObfuscatedConstant> memo_;
+
+    ObfuscatedConstant memoized(int64_t value, ConstantObfStrategy strategy) const {
+        auto key = std::make_pair(value, static_cast<int>(strategy));
+        auto it = memo_.find(key);
+        if (it != memo_.end()) {
+            return it->second;
+        }
+        ObfuscatedConstant result = obfuscateWithStrategy(value, strategy);
+        memo_.emplace(key, result);
+        return result;
+    }
 
     /**
      * XOR obfuscation: c = (c ^ key) ^ key
@@ -502,6 +545,7 @@ public:
     bool initialize(const PassConfig& config) override {
         TransformationPass::initialize(config);
         const_config_.probability = config.probability;
+        const_config_.max_expansion_ratio = config.max_expansion_ratio;
         obfuscator_.configure(const_config_);
         return true;
     }
@@ -522,9 +566,18 @@ public:
         }
 
         int transformations = 0;
+        size_t input_size = lines.size();
         std::vector<std::string> new_lines;
         new_lines.reserve(lines.size() * 2);
 
+        // Per-function expansion budget: when a ratio is configured,
+        // stop decomposing once a function has gained body * (ratio - 1)
+        // extra lines, so its output stays within body * ratio
+        const bool budget_enabled = const_config_.max_expansion_ratio > 1.0;
+        bool in_function = false;
+        size_t func_budget = 0;  // extra-line allowance of the current function
+        size_t func_extra = 0;   // lines added beyond its input so far
+
         // Pattern for instructions with integer constants
         // e.g., %x = add i32 %y, 42
         std::regex const_pattern(
@@ -538,10 +591,57 @@ public:
 
         static int temp_counter = 0;
 
-        for (const auto& line : lines) {
+        // Pre-scan: rank constants by frequency and warm the memo table
+        // for the hottest ones before the rewrite loop starts
+        if (const_config_.precompute_top_n > 0) {
+            std::map<int64_t, size_t> freq;
+            std::smatch m;
+            for (const auto& line : lines) {
+                if (std::regex_match(line, m, const_pattern)) {
+                    freq[std::stoll(m[6])]++;
+                } else if (std::regex_match(line, m, const_pattern2)) {
+                    freq[std::stoll(m[5])]++;
+                }
+            }
+
+            std::vector<std::pair<int64_t, size_t>> ranked(freq.begin(), freq.end());
+            std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+                return a.second > b.second;
+            });
+
+            std::vector<int64_t> hot;
+            size_t top_n = static_cast<size_t>(const_config_.precompute_top_n);
+            for (size_t i = 0; i < ranked.size() && i < top_n; i++) {
+                hot.push_back(ranked[i].first);
+            }
+            obfuscator_.precompute(hot);
+            incrementStat("constants_precomputed", static_cast<int>(hot.size()));
+        }
+
+        for (size_t li = 0; li < lines.size(); li++) {
+            const std::string& line = lines[li];
             bool transformed = false;
             std::smatch match;
 
+            if (budget_enabled) {
+                if (line.find("define ") != std::string::npos) {
+                    size_t body_end = li + 1;
+                    while (body_end < lines.size() &&
+                           (lines[body_end].find("}") == std::string::npos ||
+                            lines[body_end].find("switch") != std::string::npos)) {
+                        body_end++;
+                    }
+                    func_budget = static_cast<size_t>(
+                        static_cast<double>(body_end - li) *
+                        (const_config_.max_expansion_ratio - 1.0));
+                    func_extra = 0;
+                    in_function = true;
+                } else if (in_function && line.find("}") != std::string::npos &&
+                           line.find("switch") == std::string::npos) {
+                    in_function = false;
+                }
+            }
+
             // Try pattern 1: op %var, constant
             if (std::regex_match(line, match, const_pattern)) {
                 std::string indent = match[1];
@@ -561,17 +661,23 @@ public:
                     auto const_lines = generateConstantComputation(
                         temp, type, obf, indent);
 
-                    for (const auto& cl : const_lines) {
-                        new_lines.push_back(cl);
+                    if (budget_enabled && in_function &&
+                        func_extra + const_lines.size() > func_budget) {
+                        incrementStat("budget_exhausted");
+                    } else {
+                        func_extra += const_lines.size();
+                        for (const auto& cl : const_lines) {
+                            new_lines.push_back(cl);
+                        }
+
+                        // Replace original instruction
+                        new_lines.push_back(indent + dest + " = " + op + " " +
+                                           type + " " + var + ", " + temp);
+
+                        transformed = true;
+                        transformations++;
+                        incrementStat("constants_obfuscated");
                     }
-
-                    // Replace original instruction
-                    new_lines.push_back(indent + dest + " = " + op + " " +
-                                       type + " " + var + ", " + temp);
-
-                    transformed = true;
-                    transformations++;
-                    incrementStat("constants_obfuscated");
                 }
             }
 
@@ -592,16 +698,22 @@ public:
                     auto const_lines = generateConstantComputation(
                         temp, type, obf, indent);
 
-                    for (const auto& cl : const_lines) {
-                        new_lines.push_back(cl);
+                    if (budget_enabled && in_function &&
+                        func_extra + const_lines.size() > func_budget) {
+                        incrementStat("budget_exhausted");
+                    } else {
+                        func_extra += const_lines.size();
+                        for (const auto& cl : const_lines) {
+                            new_lines.push_back(cl);
+                        }
+
+                        new_lines.push_back(indent + dest + " = " + op + " " +
+                                           type + " " + temp + ", " + var);
+
+                        transformed = true;
+                        transformations++;
+                        incrementStat("constants_obfuscated");
                     }
-
-                    new_lines.push_back(indent + dest + " = " + op + " " +
-                                       type + " " + temp + ", " + var);
-
-                    transformed = true;
-                    transformations++;
-                    incrementStat("constants_obfuscated");
                 }
             }
 
@@ -612,6 +724,11 @@ public:
 
         lines = std::move(new_lines);
         incrementStat("total_transformations", transformations);
+        if (input_size > 0) {
+            // Realized expansion of this run, in percent of input lines
+            statistics_["expansion_percent"] =
+                static_cast<int>(lines.size() * 100 / input_size);
+        }
 
         return transformations > 0 ? TransformResult::Success : TransformResult::NotApplicable;
     }
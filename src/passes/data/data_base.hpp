@@ -95,6 +95,11 @@ struct ConstantObfConfig {
     bool use_mba_expressions = true; // Use MBA for constant generation
     bool handle_large_constants = true;  // Support large constants (>10000)
     bool handle_floating_point = true;   // Support float/double constants
+    // Memoization: reuse the derived expression per (value, strategy)
+    // instead of re-running the decomposition math for every occurrence
+    bool memoize = true;
+    int precompute_top_n = 0;        // Pre-obfuscate the N most frequent constants (0 = off)
+    double max_expansion_ratio = 0.0;  // Per-function output/input line budget (0 = unlimited)
 };
 
 /**
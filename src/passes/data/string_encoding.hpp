@@ -10,9 +10,18 @@
 
 #include "data_base.hpp"
 #include "../../core/transformation_base.hpp"
+#include "../../common/string_builder.hpp"
 
 #include <regex>
 #include <unordered_set>
+#include <set>
+#include <cctype>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define MORPHECT_X86_SIMD 1
+#endif
 
 namespace morphect {
 namespace data {
@@ -135,64 +144,168 @@ public:
         return true;
     }
 
+    /**
+     * Decoder symbol suffix for an encoding method. Every method maps
+     * to one shared runtime routine; strings never get private decoder
+     * logic of their own.
+     */
+    static const char* decoderSuffix(StringEncodingMethod method) {
+        switch (method) {
+            case StringEncodingMethod::RollingXOR:   return "_rolling";
+            case StringEncodingMethod::MultiByteXOR: return "_multi";
+            case StringEncodingMethod::Base64XOR:    return "_b64";
+            case StringEncodingMethod::ChainedXOR:   return "_chained";
+            case StringEncodingMethod::ByteSwapXOR:  return "_byteswap";
+            case StringEncodingMethod::RC4:          return "_rc4";
+            default:                                 return "";
+        }
+    }
+
     std::string generateDecoderCall(const EncodedString& encoded,
                                     const std::string& var_name) const {
-        std::ostringstream oss;
+        StringBuilder out(64);
 
-        switch (config_.method) {
-            case StringEncodingMethod::XOR:
-                oss << config_.decoder_function << "("
-                    << var_name << ", "
-                    << encoded.length << ", "
-                    << static_cast<int>(encoded.key) << ")";
-                break;
-            case StringEncodingMethod::RollingXOR:
-                oss << config_.decoder_function << "_rolling("
-                    << var_name << ", "
-                    << encoded.length << ", "
-                    << static_cast<int>(encoded.key) << ")";
-                break;
-            default:
-                oss << config_.decoder_function << "("
-                    << var_name << ", "
-                    << encoded.length << ", "
-                    << static_cast<int>(encoded.key) << ")";
-        }
+        out.append(config_.decoder_function);
+        out.append(decoderSuffix(encoded.method));
+        out.append('(')
+           .append(var_name).append(", ")
+           .append(encoded.length).append(", ")
+           .append(static_cast<int>(encoded.key)).append(')');
 
-        return oss.str();
+        return out.take();
     }
 
 private:
     StringEncodingConfig config_;
     Logger logger_;
 
+    // ==================== vector kernels ====================
+    //
+    // Multi-megabyte blob tables make string encoding the slowest data
+    // pass, and the byte-at-a-time loops were the cost. These kernels
+    // XOR 32 bytes per iteration on AVX2 machines (detected once at
+    // runtime) or 16 on the x86-64 SSE2 baseline; elsewhere an 8-byte
+    // SWAR loop runs. Scalar tails handle the last <16 bytes.
+
+#ifdef MORPHECT_X86_SIMD
+    static bool haveAvx2() {
+        static const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+        return avx2;
+    }
+
+    __attribute__((target("avx2")))
+    static void xorConstAvx2(uint8_t* dst, const uint8_t* src, size_t n, uint8_t key) {
+        const __m256i vkey = _mm256_set1_epi8(static_cast<char>(key));
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                                _mm256_xor_si256(v, vkey));
+        }
+        for (; i < n; i++) dst[i] = src[i] ^ key;
+    }
+
+    __attribute__((target("avx2")))
+    static void xorBuffersAvx2(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t n) {
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                                _mm256_xor_si256(va, vb));
+        }
+        for (; i < n; i++) dst[i] = a[i] ^ b[i];
+    }
+#endif
+
+    /**
+     * dst[i] = src[i] ^ key for a single repeated key byte
+     */
+    static void xorConst(uint8_t* dst, const uint8_t* src, size_t n, uint8_t key) {
+#ifdef MORPHECT_X86_SIMD
+        if (haveAvx2()) {
+            xorConstAvx2(dst, src, n, key);
+            return;
+        }
+        const __m128i vkey = _mm_set1_epi8(static_cast<char>(key));
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                             _mm_xor_si128(v, vkey));
+        }
+        for (; i < n; i++) dst[i] = src[i] ^ key;
+#else
+        uint64_t wide_key = 0x0101010101010101ULL * key;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, src + i, 8);
+            w ^= wide_key;
+            std::memcpy(dst + i, &w, 8);
+        }
+        for (; i < n; i++) dst[i] = src[i] ^ key;
+#endif
+    }
+
+    /**
+     * dst[i] = a[i] ^ b[i] over two independent buffers
+     */
+    static void xorBuffers(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t n) {
+#ifdef MORPHECT_X86_SIMD
+        if (haveAvx2()) {
+            xorBuffersAvx2(dst, a, b, n);
+            return;
+        }
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                             _mm_xor_si128(va, vb));
+        }
+        for (; i < n; i++) dst[i] = a[i] ^ b[i];
+#else
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            uint64_t wa, wb;
+            std::memcpy(&wa, a + i, 8);
+            std::memcpy(&wb, b + i, 8);
+            wa ^= wb;
+            std::memcpy(dst + i, &wa, 8);
+        }
+        for (; i < n; i++) dst[i] = a[i] ^ b[i];
+#endif
+    }
+
     EncodedString encodeXOR(const std::string& str, uint8_t key) const {
         EncodedString result;
         result.original = str;
         result.key = key;
         result.length = str.length();
 
-        result.encoded_bytes.reserve(str.length());
-        for (char c : str) {
-            result.encoded_bytes.push_back(static_cast<uint8_t>(c) ^ key);
-        }
+        result.encoded_bytes.resize(str.length());
+        xorConst(result.encoded_bytes.data(),
+                 reinterpret_cast<const uint8_t*>(str.data()),
+                 str.length(), key);
 
         return result;
     }
 
-    // each byte xored with previous decoded byte
+    // each byte xored with previous decoded byte: after the first byte
+    // that is plain[i] ^ plain[i-1], a shifted-by-one buffer XOR
     EncodedString encodeRollingXOR(const std::string& str, uint8_t init_key) const {
         EncodedString result;
         result.original = str;
         result.key = init_key;
         result.length = str.length();
 
-        uint8_t key = init_key;
-        result.encoded_bytes.reserve(str.length());
-        for (char c : str) {
-            uint8_t plain = static_cast<uint8_t>(c);
-            result.encoded_bytes.push_back(plain ^ key);
-            key = plain;
+        result.encoded_bytes.resize(str.length());
+        if (!str.empty()) {
+            const uint8_t* plain = reinterpret_cast<const uint8_t*>(str.data());
+            result.encoded_bytes[0] = plain[0] ^ init_key;
+            xorBuffers(result.encoded_bytes.data() + 1,
+                       plain + 1, plain, str.length() - 1);
         }
 
         return result;
@@ -209,12 +322,22 @@ private:
             return encodeXOR(str, config_.xor_key);
         }
 
-        result.encoded_bytes.reserve(str.length());
-        for (size_t i = 0; i < str.length(); i++) {
-            uint8_t k = key[i % key.size()];
-            result.encoded_bytes.push_back(static_cast<uint8_t>(str[i]) ^ k);
+        // Tile the key across a keystream buffer (doubling memcpy), then
+        // one vector XOR pass over the whole input
+        std::vector<uint8_t> keystream(str.length());
+        size_t filled = std::min(key.size(), keystream.size());
+        std::memcpy(keystream.data(), key.data(), filled);
+        while (filled < keystream.size()) {
+            size_t chunk = std::min(filled, keystream.size() - filled);
+            std::memcpy(keystream.data() + filled, keystream.data(), chunk);
+            filled += chunk;
         }
 
+        result.encoded_bytes.resize(str.length());
+        xorBuffers(result.encoded_bytes.data(),
+                   reinterpret_cast<const uint8_t*>(str.data()),
+                   keystream.data(), str.length());
+
         return result;
     }
 
@@ -226,10 +349,10 @@ private:
 
         std::string base64 = base64Encode(str);
         result.length = base64.length();
-        result.encoded_bytes.reserve(base64.length());
-        for (char c : base64) {
-            result.encoded_bytes.push_back(static_cast<uint8_t>(c) ^ key);
-        }
+        result.encoded_bytes.resize(base64.length());
+        xorConst(result.encoded_bytes.data(),
+                 reinterpret_cast<const uint8_t*>(base64.data()),
+                 base64.length(), key);
 
         return result;
     }
@@ -262,10 +385,10 @@ private:
             std::swap(swapped[i], swapped[i + 1]);
         }
 
-        result.encoded_bytes.reserve(swapped.length());
-        for (char c : swapped) {
-            result.encoded_bytes.push_back(static_cast<uint8_t>(c) ^ key);
-        }
+        result.encoded_bytes.resize(swapped.length());
+        xorConst(result.encoded_bytes.data(),
+                 reinterpret_cast<const uint8_t*>(swapped.data()),
+                 swapped.length(), key);
 
         return result;
     }
@@ -292,18 +415,23 @@ private:
             std::swap(S[i], S[j]);
         }
 
-        // prga
-        result.encoded_bytes.reserve(str.length());
+        // prga: the state update is serial, so generate the whole
+        // keystream first, then mix it in with one vector XOR pass
+        std::vector<uint8_t> keystream(str.length());
         int i = 0;
         j = 0;
-        for (char c : str) {
+        for (size_t pos = 0; pos < keystream.size(); pos++) {
             i = (i + 1) & 0xFF;
             j = (j + S[i]) & 0xFF;
             std::swap(S[i], S[j]);
-            uint8_t k = S[(S[i] + S[j]) & 0xFF];
-            result.encoded_bytes.push_back(static_cast<uint8_t>(c) ^ k);
+            keystream[pos] = S[(S[i] + S[j]) & 0xFF];
         }
 
+        result.encoded_bytes.resize(str.length());
+        xorBuffers(result.encoded_bytes.data(),
+                   reinterpret_cast<const uint8_t*>(str.data()),
+                   keystream.data(), str.length());
+
         return result;
     }
 
@@ -386,6 +514,11 @@ public:
 
     PassPriority getPriority() const override { return PassPriority::Data; }
 
+    // Rewrites c"..." global constants only
+    uint32_t requiredFeatures() const override {
+        return ir_features::kStringConst;
+    }
+
     bool initialize(const PassConfig& config) override {
         TransformationPass::initialize(config);
         return true;
@@ -402,43 +535,93 @@ public:
         }
 
         int transformations = 0;
+        int interned = 0;
 
         // match global string constants
-        std::regex string_const_re(
+        static const std::regex string_const_re(
             R"((@[\w.]+)\s*=\s*(private\s+)?unnamed_addr\s+constant\s+\[(\d+)\s+x\s+i8\]\s+c\"([^\"]*)(\\00)?\")"
         );
 
-        for (auto& line : lines) {
+        // Hash-cons identical literals: the first private definition of
+        // each distinct content becomes the canonical global, later
+        // duplicates are dropped and their uses rewritten to it. Only
+        // private globals are merged — an external symbol has to keep
+        // its definition even when the bytes repeat.
+        std::unordered_map<std::string, std::string> canonical_by_content;
+        std::unordered_map<std::string, std::string> alias_to_canonical;
+        std::vector<bool> dropped(lines.size(), false);
+
+        for (size_t i = 0; i < lines.size(); i++) {
+            std::string& line = lines[i];
             std::smatch match;
-            if (std::regex_search(line, match, string_const_re)) {
-                std::string var_name = match[1];
-                std::string str_content = match[4];
-
-                // Unescape the string
-                std::string unescaped = unescapeString(str_content);
-
-                if (encoder_.shouldEncode(unescaped)) {
-                    EncodedString encoded = encoder_.encode(unescaped);
+            if (!std::regex_search(line, match, string_const_re)) {
+                continue;
+            }
 
-                    std::ostringstream new_line;
-                    new_line << var_name << " = private unnamed_addr constant ["
-                             << (encoded.length + 1) << " x i8] c\""
-                             << encoded.toHexString() << "\\00\"";
-                    new_line << " ; MORPHECT_ENCODED key=" << static_cast<int>(encoded.key);
+            std::string var_name = match[1];
+            bool is_private = match[2].matched;
+            std::string str_content = match[4];
+
+            // Unescape the string
+            std::string unescaped = unescapeString(str_content);
+
+            if (is_private) {
+                auto [it, inserted] = canonical_by_content.emplace(unescaped, var_name);
+                if (!inserted) {
+                    // Duplicate literal: drop this definition and point
+                    // every use at the canonical encoded global
+                    alias_to_canonical[var_name] = it->second;
+                    dropped[i] = true;
+                    interned++;
+                    incrementStat("strings_interned");
+                    continue;
+                }
+            }
 
-                    line = new_line.str();
-                    transformations++;
-                    incrementStat("strings_encoded");
-                    encoded_strings_[var_name] = encoded;
+            if (encoder_.shouldEncode(unescaped)) {
+                EncodedString encoded = encoder_.encode(unescaped);
+
+                StringBuilder new_line(128);
+                new_line.append(var_name)
+                        .append(" = private unnamed_addr constant [")
+                        .append(encoded.length + 1)
+                        .append(" x i8] c\"")
+                        .append(encoded.toHexString())
+                        .append("\\00\"")
+                        .append(" ; MORPHECT_ENCODED key=")
+                        .append(static_cast<int>(encoded.key));
+
+                line = new_line.take();
+                transformations++;
+                incrementStat("strings_encoded");
+                encoded_strings_[var_name] = encoded;
+                encoded_order_.push_back(var_name);
+
+                logger_.debug("Encoded string {}: \"{}\"", var_name,
+                             unescaped.substr(0, 20) + (unescaped.length() > 20 ? "..." : ""));
+            }
+        }
 
-                    logger_.debug("Encoded string {}: \"{}\"", var_name,
-                                 unescaped.substr(0, 20) + (unescaped.length() > 20 ? "..." : ""));
-                }
+        if (interned > 0) {
+            std::vector<std::string> kept;
+            kept.reserve(lines.size() - static_cast<size_t>(interned));
+            for (size_t i = 0; i < lines.size(); i++) {
+                if (dropped[i]) continue;
+                replaceGlobalRefs(lines[i], alias_to_canonical);
+                kept.push_back(std::move(lines[i]));
             }
+            lines = std::move(kept);
+            logger_.debug("Interned {} duplicate string literals", interned);
+        }
+
+        if (transformations > 0) {
+            emitDecoderStage(lines);
         }
 
         incrementStat("total_transformations", transformations);
-        return transformations > 0 ? TransformResult::Success : TransformResult::NotApplicable;
+        return (transformations > 0 || interned > 0)
+                   ? TransformResult::Success
+                   : TransformResult::NotApplicable;
     }
 
     const std::unordered_map<std::string, EncodedString>& getEncodedStrings() const {
@@ -450,6 +633,101 @@ private:
     StringEncodingConfig str_config_;
     StringEncoder encoder_;
     std::unordered_map<std::string, EncodedString> encoded_strings_;
+    std::vector<std::string> encoded_order_;  // deterministic table order
+
+    /**
+     * Module-level decoder emission, run once after encoding.
+     *
+     * Appends a single packed descriptor table — one { ptr, i64 length,
+     * i8 key } record per encoded string, pointing into the encoded
+     * globals — and exactly one decoder declaration per encoding method
+     * actually used. All strings share those routines, so the emitted
+     * module grows by O(methods) decoder code instead of O(strings).
+     */
+    void emitDecoderStage(std::vector<std::string>& lines) {
+        if (encoded_order_.empty()) {
+            return;
+        }
+
+        lines.push_back("");
+        lines.push_back("; MORPHECT_STRING_TABLE entries=" +
+                        std::to_string(encoded_order_.size()));
+
+        StringBuilder table(encoded_order_.size() * 96);
+        table.append("@__morphect_str_table = private constant [")
+             .append(encoded_order_.size())
+             .append(" x { i8*, i64, i8 }] [");
+
+        std::set<std::string> decoder_symbols;
+        bool first = true;
+        for (const auto& var_name : encoded_order_) {
+            const EncodedString& encoded = encoded_strings_.at(var_name);
+            size_t array_len = encoded.length + 1;  // trailing \00
+
+            if (!first) table.append(", ");
+            first = false;
+
+            table.append("{ i8* getelementptr inbounds ([")
+                 .append(array_len).append(" x i8], [")
+                 .append(array_len).append(" x i8]* ")
+                 .append(var_name)
+                 .append(", i64 0, i64 0), i64 ")
+                 .append(encoded.length)
+                 .append(", i8 ")
+                 .append(static_cast<int>(encoded.key))
+                 .append(" }");
+
+            decoder_symbols.insert(str_config_.decoder_function +
+                                   StringEncoder::decoderSuffix(encoded.method));
+        }
+        table.append(']');
+        lines.push_back(table.take());
+
+        for (const auto& symbol : decoder_symbols) {
+            lines.push_back("declare i8* @" + symbol + "(i8*, i64, i8)");
+            incrementStat("decoders_emitted");
+        }
+        incrementStat("string_table_entries",
+                      static_cast<int>(encoded_order_.size()));
+    }
+
+    /**
+     * Rewrite every whole-token @global reference that names a dropped
+     * duplicate so it points at the canonical literal instead.
+     * Identical contents have identical [N x i8] types, so references
+     * stay well-typed after the swap.
+     */
+    static void replaceGlobalRefs(std::string& line,
+                                  const std::unordered_map<std::string, std::string>& aliases) {
+        size_t at = line.find('@');
+        if (at == std::string::npos) return;
+
+        std::string rewritten;
+        size_t copied = 0;
+
+        while (at != std::string::npos) {
+            size_t end = at + 1;
+            while (end < line.size() &&
+                   (std::isalnum(static_cast<unsigned char>(line[end])) ||
+                    line[end] == '_' || line[end] == '.')) {
+                end++;
+            }
+
+            auto it = aliases.find(line.substr(at, end - at));
+            if (it != aliases.end()) {
+                rewritten.append(line, copied, at - copied);
+                rewritten.append(it->second);
+                copied = end;
+            }
+
+            at = line.find('@', end);
+        }
+
+        if (copied > 0) {
+            rewritten.append(line, copied, std::string::npos);
+            line = std::move(rewritten);
+        }
+    }
 
     std::string unescapeString(const std::string& str) const {
         std::string result;
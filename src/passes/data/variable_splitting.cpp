@@ -5,6 +5,7 @@
  */
 
 #include "variable_splitting.hpp"
+#include "../../common/identifier_renamer.hpp"
 #include <regex>
 #include <sstream>
 #include <algorithm>
@@ -22,6 +23,7 @@ TransformResult LLVMVariableSplittingPass::transformIR(
     std::vector<std::string> result;
     result.reserve(lines.size() * 2);
 
+    size_t input_size = lines.size();
     int total_splits = 0;
     bool in_function = false;
     size_t func_start = 0;
@@ -75,31 +77,86 @@ TransformResult LLVMVariableSplittingPass::transformIR(
     renumberSSA(lines);
 
     incrementStat("variables_split", total_splits);
+    if (input_size > 0) {
+        // Realized expansion of this run, in percent of input lines
+        statistics_["expansion_percent"] =
+            static_cast<int>(lines.size() * 100 / input_size);
+    }
 
     return total_splits > 0 ? TransformResult::Success : TransformResult::NotApplicable;
 }
 
+std::vector<LLVMVariableSplittingPass::LineDefUse>
+LLVMVariableSplittingPass::buildDefUseIndex(
+        const std::vector<std::string>& lines,
+        size_t func_start,
+        size_t func_end) const {
+
+    auto isVarChar = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+    };
+
+    std::vector<LineDefUse> index;
+    index.reserve(func_end > func_start ? func_end - func_start : 0);
+
+    for (size_t i = func_start; i < func_end && i < lines.size(); i++) {
+        const std::string& line = lines[i];
+        LineDefUse entry;
+
+        // A destination is a leading %name followed by '='
+        size_t pos = line.find_first_not_of(" \t");
+        size_t dest_end = std::string::npos;
+        if (pos != std::string::npos && line[pos] == '%') {
+            size_t end = pos + 1;
+            while (end < line.size() && isVarChar(line[end])) end++;
+            size_t after = line.find_first_not_of(" \t", end);
+            if (end > pos + 1 && after != std::string::npos && line[after] == '=') {
+                entry.dest = line.substr(pos, end - pos);
+                dest_end = end;
+            }
+        }
+
+        // Every other %name token on the line is a use
+        size_t at = line.find('%', dest_end == std::string::npos ? 0 : dest_end);
+        while (at != std::string::npos) {
+            size_t end = at + 1;
+            while (end < line.size() && isVarChar(line[end])) end++;
+            if (end > at + 1) {
+                entry.uses.push_back(line.substr(at, end - at));
+            }
+            at = line.find('%', end);
+        }
+
+        index.push_back(std::move(entry));
+    }
+
+    return index;
+}
+
 std::vector<VariableAnalysis> LLVMVariableSplittingPass::analyzeVariables(
         const std::vector<std::string>& lines,
         size_t func_start,
-        size_t func_end) {
+        size_t func_end,
+        const std::vector<LineDefUse>& index) {
 
     std::vector<VariableAnalysis> analyses;
     std::map<std::string, VariableAnalysis> var_map;
 
     // Pattern for variable definitions: %name = ...
-    std::regex def_pattern(R"(^\s*(%[\w.]+)\s*=\s*(\w+)\s+(\w+).*)");
+    static const std::regex def_pattern(R"(^\s*(%[\w.]+)\s*=\s*(\w+)\s+(\w+).*)");
 
     // Pattern for PHI nodes
-    std::regex phi_pattern(R"(^\s*(%[\w.]+)\s*=\s*phi\s+(\w+)\s+.*)");
+    static const std::regex phi_pattern(R"(^\s*(%[\w.]+)\s*=\s*phi\s+(\w+)\s+.*)");
 
     for (size_t i = func_start; i < func_end && i < lines.size(); i++) {
         const std::string& line = lines[i];
+        const LineDefUse& du = index[i - func_start];
 
         std::smatch match;
 
-        // Check for PHI node
-        if (std::regex_search(line, match, phi_pattern)) {
+        // Check for PHI node (the index says whether this line defines
+        // anything at all, so most lines skip both regexes)
+        if (!du.dest.empty() && std::regex_search(line, match, phi_pattern)) {
             std::string var_name = match[1];
             std::string type = match[2];
 
@@ -119,7 +176,7 @@ std::vector<VariableAnalysis> LLVMVariableSplittingPass::analyzeVariables(
         }
 
         // Check for regular definition
-        if (std::regex_search(line, match, def_pattern)) {
+        if (!du.dest.empty() && std::regex_search(line, match, def_pattern)) {
             std::string var_name = match[1];
             std::string op = match[2];
             std::string rest = match[3];
@@ -179,9 +236,8 @@ std::vector<VariableAnalysis> LLVMVariableSplittingPass::analyzeVariables(
             var_map[var_name].definition_lines.push_back(static_cast<int>(i));
         }
 
-        // Find uses of variables in the line
-        auto uses = findVariableUses(line);
-        for (const auto& use : uses) {
+        // Record uses from the prebuilt index
+        for (const auto& use : du.uses) {
             if (var_map.find(use) != var_map.end()) {
                 var_map[use].use_lines.push_back(static_cast<int>(i));
             }
@@ -234,6 +290,42 @@ std::vector<std::string> LLVMVariableSplittingPass::selectVariablesToSplit(
     return selected;
 }
 
+std::vector<std::string> LLVMVariableSplittingPass::trimSelectionToBudget(
+        const std::vector<std::string>& selected,
+        const std::vector<VariableAnalysis>& analyses,
+        size_t body_lines) {
+
+    // Each split costs roughly three lines per definition (temp, part1,
+    // part2) plus one reconstruction line per use. Keep variables, in
+    // selection order, while the projected total fits the budget.
+    size_t budget_extra = static_cast<size_t>(
+        static_cast<double>(body_lines) * (config_.max_expansion_ratio - 1.0));
+
+    std::vector<std::string> kept;
+    size_t projected = 0;
+
+    for (const auto& name : selected) {
+        size_t cost = 0;
+        for (const auto& analysis : analyses) {
+            if (analysis.name == name) {
+                cost = analysis.definition_lines.size() * 3 +
+                       analysis.use_lines.size();
+                break;
+            }
+        }
+
+        if (projected + cost > budget_extra) {
+            incrementStat("budget_skipped");
+            continue;
+        }
+
+        projected += cost;
+        kept.push_back(name);
+    }
+
+    return kept;
+}
+
 SplitVariable LLVMVariableSplittingPass::createSplitVariable(
         const std::string& name,
         const std::string& type) {
@@ -262,12 +354,23 @@ std::vector<std::string> LLVMVariableSplittingPass::transformFunction(
 
     std::vector<std::string> result;
 
+    // One def-use index per function drives both analysis and rewriting
+    auto index = buildDefUseIndex(lines, func_start + 1, func_end);
+
     // Analyze variables - only analyze body, not define line or closing brace
-    auto analyses = analyzeVariables(lines, func_start + 1, func_end);
+    auto analyses = analyzeVariables(lines, func_start + 1, func_end, index);
 
     // Select variables to split
     auto to_split = selectVariablesToSplit(analyses);
 
+    // Enforce the per-function expansion budget on the selection:
+    // dropping a variable up front is the only safe cut-off point, since
+    // a split definition without reconstructed uses breaks the IR
+    if (config_.max_expansion_ratio > 0.0 && !to_split.empty()) {
+        size_t body_lines = func_end > func_start + 1 ? func_end - func_start - 1 : 0;
+        to_split = trimSelectionToBudget(to_split, analyses, body_lines);
+    }
+
     if (to_split.empty()) {
         // No variables to split, return only function body (no define, no closing brace)
         for (size_t i = func_start + 1; i < func_end && i < lines.size(); i++) {
@@ -289,11 +392,11 @@ std::vector<std::string> LLVMVariableSplittingPass::transformFunction(
     // Transform lines - only process function body (no define line, no closing brace)
     for (size_t i = func_start + 1; i < func_end && i < lines.size(); i++) {
         const std::string& line = lines[i];
+        const LineDefUse& du = index[i - (func_start + 1)];
 
         // Check if this line uses any split variables (in operands, not destination)
-        auto uses = findVariableUses(line);
         std::vector<std::string> split_uses;
-        for (const auto& use : uses) {
+        for (const auto& use : du.uses) {
             if (split_vars_.find(use) != split_vars_.end()) {
                 split_uses.push_back(use);
             }
@@ -314,32 +417,25 @@ std::vector<std::string> LLVMVariableSplittingPass::transformFunction(
                 result.push_back(reconst_line);
             }
 
-            // Replace original variable names with reconstructed names in the line
+            // Replace original variable names with reconstructed names in
+            // one token scan; the destination (left of '=') keeps its name
+            IdentifierRenamer renamer;
             for (const auto& [orig, reconst] : reconstructed) {
-                size_t pos = 0;
-                while ((pos = working_line.find(orig, pos)) != std::string::npos) {
-                    // Make sure we're replacing a complete variable name
-                    size_t end_pos = pos + orig.length();
-                    bool at_end = end_pos >= working_line.length();
-                    bool followed_by_valid = at_end ||
-                        (!std::isalnum(working_line[end_pos]) && working_line[end_pos] != '_');
-
-                    // Check it's not the destination variable (at start of line)
-                    std::string dest_check = extractDestVariable(working_line);
-                    bool is_dest = (dest_check == orig && pos < working_line.find('='));
-
-                    if (followed_by_valid && !is_dest) {
-                        working_line.replace(pos, orig.length(), reconst);
-                        pos += reconst.length();
-                    } else {
-                        pos++;
-                    }
-                }
+                renamer.add(orig, reconst);
+            }
+            size_t eq_pos = working_line.find('=');
+            if (eq_pos != std::string::npos) {
+                std::string rhs = working_line.substr(eq_pos);
+                renamer.applyToLine(rhs);
+                working_line.resize(eq_pos);
+                working_line += rhs;
+            } else {
+                renamer.applyToLine(working_line);
             }
         }
 
         // Check if this line defines a split variable
-        std::string dest = extractDestVariable(working_line);
+        const std::string& dest = du.dest;
         if (!dest.empty() && split_vars_.find(dest) != split_vars_.end()) {
             // Transform the definition (with any uses already reconstructed)
             auto transformed = transformDefinition(working_line, split_vars_[dest]);
@@ -461,24 +557,13 @@ std::vector<std::string> LLVMVariableSplittingPass::transformUse(
         }
     }
 
-    // Replace original variable names with reconstructed names
+    // Replace original variable names with reconstructed names in one
+    // token scan instead of one find/replace loop per name
+    IdentifierRenamer renamer;
     for (const auto& [orig, reconst] : reconstructed) {
-        size_t pos = 0;
-        while ((pos = modified_line.find(orig, pos)) != std::string::npos) {
-            // Make sure we're replacing a complete variable name
-            size_t end_pos = pos + orig.length();
-            bool at_end = end_pos >= modified_line.length();
-            bool followed_by_valid = at_end ||
-                (!std::isalnum(modified_line[end_pos]) && modified_line[end_pos] != '_');
-
-            if (followed_by_valid) {
-                modified_line.replace(pos, orig.length(), reconst);
-                pos += reconst.length();
-            } else {
-                pos++;
-            }
-        }
+        renamer.add(orig, reconst);
     }
+    renamer.applyToLine(modified_line);
 
     result.push_back(modified_line);
     return result;
@@ -62,6 +62,7 @@ struct VariableSplittingConfig {
     int max_splits_per_function = 10;   // Limit splits to prevent explosion
     std::vector<std::string> exclude_patterns;  // Variable patterns to exclude
     bool prefer_xor_for_loops = true;   // Use XOR for loop counters
+    double max_expansion_ratio = 0.0;   // Per-function output/input line budget (0 = unlimited)
 };
 
 /**
@@ -94,10 +95,14 @@ public:
 
     PassPriority getPriority() const override { return PassPriority::Data; }
 
+    // Splits stack variables: nothing to do without alloca/load/store
+    uint32_t requiredFeatures() const override { return ir_features::kMemory; }
+
     bool initialize(const PassConfig& config) override {
         TransformationPass::initialize(config);
         config_.probability = config.probability;
         config_.enabled = config.enabled;
+        config_.max_expansion_ratio = config.max_expansion_ratio;
         return true;
     }
 
@@ -130,13 +135,33 @@ private:
     // Counter for unique names
     int split_counter_ = 0;
 
+    /**
+     * Per-line def/use facts, gathered in one tokenizing scan over a
+     * function body so neither analysis nor transformation has to
+     * rescan lines per variable
+     */
+    struct LineDefUse {
+        std::string dest;               // destination %name, empty if none
+        std::vector<std::string> uses;  // operand %names, in order
+    };
+
+    /**
+     * Build the def-use index for [func_start, func_end): entry k
+     * describes line func_start + k
+     */
+    std::vector<LineDefUse> buildDefUseIndex(
+        const std::vector<std::string>& lines,
+        size_t func_start,
+        size_t func_end) const;
+
     /**
      * Analyze a function's IR to find splittable variables
      */
     std::vector<VariableAnalysis> analyzeVariables(
         const std::vector<std::string>& lines,
         size_t func_start,
-        size_t func_end);
+        size_t func_end,
+        const std::vector<LineDefUse>& index);
 
     /**
      * Select which variables to split
@@ -144,6 +169,15 @@ private:
     std::vector<std::string> selectVariablesToSplit(
         const std::vector<VariableAnalysis>& analyses);
 
+    /**
+     * Drop selected variables whose projected cost would push the
+     * function body past max_expansion_ratio times its input size
+     */
+    std::vector<std::string> trimSelectionToBudget(
+        const std::vector<std::string>& selected,
+        const std::vector<VariableAnalysis>& analyses,
+        size_t body_lines);
+
     /**
      * Create split variable info for a variable
      */
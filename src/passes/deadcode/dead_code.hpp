@@ -34,6 +34,7 @@
 #include <regex>
 #include <sstream>
 #include <algorithm>
+#include <map>
 #include <unordered_set>
 
 namespace morphect {
@@ -305,12 +306,28 @@ public:
             generators.push_back(std::make_unique<MBADeadCodeGenerator>());
         }
 
+        // Pool mode: pre-generate parameterized templates once, then
+        // each insertion below is a name substitution instead of a full
+        // generator run
+        if (config.use_block_pool && !pool_.ready()) {
+            std::vector<DeadCodeGenerator*> gens;
+            gens.reserve(generators.size());
+            for (const auto& g : generators) gens.push_back(g.get());
+            pool_.build(gens, config);
+        }
+
         // Select random insertion points
         // nextInt is INCLUSIVE, so don't add 1 to max
         int num_insertions = GlobalRandom::nextInt(config.min_blocks,
             std::min(config.max_blocks,
                     static_cast<int>(insertion_points.size())));
 
+        // Compact profile: each volatile-anchored block survives -O2 on
+        // its own, so half the blocks buy the same anti-analysis effect
+        if (config.compact_profile) {
+            num_insertions = (num_insertions + 1) / 2;
+        }
+
         // Shuffle and select
         std::vector<int> selected_points = insertion_points;
         for (size_t i = selected_points.size() - 1; i > 0; i--) {
@@ -330,6 +347,20 @@ public:
         // Track nop functions to create
         std::vector<std::pair<std::string, int>> nop_functions;  // name, num_args
 
+        // Per-function expansion budget: lines added so far, keyed by
+        // function start, checked against body_size * (ratio - 1)
+        std::map<size_t, size_t> budget_used;
+
+        // Generator weights only depend on the config, so build the
+        // alias table once and make every pick below O(1)
+        double leftover = 1.0 - config.arithmetic_probability -
+                          config.memory_probability - config.call_probability;
+        if (leftover < 0.0) leftover = 0.0;
+        AliasSampler generator_sampler({config.arithmetic_probability,
+                                        config.memory_probability,
+                                        config.call_probability,
+                                        leftover});
+
         // Insert dead code at selected points
         for (int insert_point : selected_points) {
             if (GlobalRandom::nextDouble() > config.probability) {
@@ -352,35 +383,46 @@ public:
             // 3. Variable splitting (splits create new SSA values in their local scope)
             std::vector<VariableInfo> variables;  // Empty = generators use constants only
 
-            // Select a generator based on weights
-            double r = GlobalRandom::nextDouble();
+            // Select a generator based on weights; the leftover slot is
+            // the MBA generator when enabled, arithmetic otherwise
+            size_t gen_idx = generator_sampler.sample();
             DeadCodeGenerator* gen = nullptr;
-
-            if (r < config.arithmetic_probability) {
-                gen = generators[0].get();
-            } else if (r < config.arithmetic_probability + config.memory_probability) {
-                gen = generators[1].get();
-            } else if (r < config.arithmetic_probability + config.memory_probability +
-                       config.call_probability) {
-                gen = generators[2].get();
+            if (gen_idx < 3) {
+                gen = generators[gen_idx].get();
             } else if (config.apply_mba && generators.size() > 3) {
                 gen = generators[3].get();
             } else {
                 gen = generators[0].get();
             }
 
-            // Generate dead code block
-            DeadCodeBlock block = gen->generate(variables, config);
+            // Generate dead code block (or instantiate a pooled template)
+            DeadCodeBlock block = (config.use_block_pool && pool_.ready())
+                ? pool_.instantiate(gen->getName())
+                : gen->generate(variables, config);
+
+            // Generate guarded dead code
+            auto guarded_code = wrapWithOpaqueGuard(block, config);
+
+            // Respect the expansion budget of the enclosing function
+            if (config.max_expansion_ratio > 0.0 &&
+                func_bounds.second > func_bounds.first) {
+                size_t body = func_bounds.second - func_bounds.first;
+                size_t budget_extra = static_cast<size_t>(
+                    static_cast<double>(body) * (config.max_expansion_ratio - 1.0));
+                size_t& used = budget_used[func_bounds.first];
+                if (used + guarded_code.size() > budget_extra) {
+                    result.blocks_budget_skipped++;
+                    continue;
+                }
+                used += guarded_code.size();
+            }
 
-            // Track nop functions
+            // Track nop functions (only for blocks that actually land)
             for (const auto& func : block.nop_functions_created) {
                 int num_args = GlobalRandom::nextInt(0, 3);
                 nop_functions.push_back(std::make_pair(func, num_args));
             }
 
-            // Generate guarded dead code
-            auto guarded_code = wrapWithOpaqueGuard(block, config);
-
             // Insert into code
             result.transformed_code.insert(
                 result.transformed_code.begin() + insert_point,
@@ -406,6 +448,7 @@ public:
 
 private:
     int label_counter_ = 0;
+    DeadCodeBlockPool pool_;
 
     /**
      * Wrap dead code with opaque predicate guard
@@ -494,6 +537,7 @@ public:
         TransformationPass::initialize(config);
         dc_config_.enabled = config.enabled;
         dc_config_.probability = config.probability;
+        dc_config_.max_expansion_ratio = config.max_expansion_ratio;
         return true;
     }
 
@@ -510,6 +554,7 @@ public:
             return TransformResult::Skipped;
         }
 
+        size_t input_size = lines.size();
         auto dc_result = transformer_.transform(lines, dc_config_);
 
         if (dc_result.success) {
@@ -518,8 +563,14 @@ public:
             statistics_["ops_inserted"] = dc_result.ops_inserted;
             statistics_["calls_inserted"] = dc_result.calls_inserted;
             statistics_["memory_ops_inserted"] = dc_result.memory_ops_inserted;
+            statistics_["blocks_budget_skipped"] = dc_result.blocks_budget_skipped;
             statistics_["nop_functions"] =
                 static_cast<int>(dc_result.nop_functions_created.size());
+            if (input_size > 0) {
+                // Realized expansion of this run, in percent of input lines
+                statistics_["expansion_percent"] =
+                    static_cast<int>(lines.size() * 100 / input_size);
+            }
             return TransformResult::Success;
         } else {
             return TransformResult::Error;
@@ -7,7 +7,7 @@
  *   - Realistic dead arithmetic (looks like real computation)
  *   - Dead memory accesses (stack, globals, arrays)
  *   - Dead function calls (to nop/empty functions)
- *   - MBA-obfuscated dead code (apply MBA to generated code)
+ *   - MBA-obfuscated dead code (pre-expanded from the MBA variant tables)
  *
  * Key principle: Dead code should be indistinguishable from real code
  * to both static and dynamic analysis tools.
@@ -19,10 +19,20 @@
 #include "../../core/transformation_base.hpp"
 #include "../../common/random.hpp"
 #include "../../common/logging.hpp"
-
+#include "../../common/small_vector.hpp"
+#include "../mba/mba_add.hpp"
+#include "../mba/mba_sub.hpp"
+#include "../mba/mba_xor.hpp"
+#include "../mba/mba_and.hpp"
+#include "../mba/mba_or.hpp"
+
+#include <atomic>
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <cctype>
+#include <memory>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace morphect {
@@ -94,10 +104,14 @@ struct DeadCodeConfig {
     bool apply_mba = true;               // Apply MBA to dead arithmetic
     bool create_dependencies = true;     // Create fake data dependencies
     bool use_realistic_patterns = true;  // Generate common code patterns
+    bool use_block_pool = false;         // Instantiate from a pre-generated template pool
+    int block_pool_size = 256;           // Templates to pre-generate for pool mode
+    bool compact_profile = false;        // Fewer, denser blocks anchored by volatile sinks
 
     // Control
     std::vector<std::string> exclude_functions;  // Don't add dead code here
     int seed = 0;                                // RNG seed for reproducibility
+    double max_expansion_ratio = 0.0;  // Per-function output/input line budget (0 = unlimited)
 };
 
 /**
@@ -120,10 +134,13 @@ struct VariableInfo {
  * Generated dead code block
  */
 struct DeadCodeBlock {
-    std::vector<std::string> code;                    // The generated code lines
-    std::vector<std::string> vars_created;            // Temporary vars created
-    std::vector<std::string> vars_used;               // Existing vars used
-    std::vector<std::string> nop_functions_created;   // Nop functions needed
+    // Inline storage sized for the typical block (a few ops, a handful
+    // of names); generating and splicing blocks stays allocation-free
+    // in the common case
+    SmallVector<std::string, 8> code;                 // The generated code lines
+    SmallVector<std::string, 4> vars_created;         // Temporary vars created
+    SmallVector<std::string, 4> vars_used;            // Existing vars used
+    SmallVector<std::string, 2> nop_functions_created; // Nop functions needed
     DeadCodeType type = DeadCodeType::Mixed;
     bool needs_guard = true;                          // Needs opaque predicate guard?
     int ops_inserted = 0;                             // Number of ops generated
@@ -152,6 +169,7 @@ struct DeadCodeResult {
     int ops_inserted = 0;
     int calls_inserted = 0;
     int memory_ops_inserted = 0;
+    int blocks_budget_skipped = 0;  // insertions dropped by max_expansion_ratio
     std::vector<std::string> nop_functions_created;
 };
 
@@ -182,22 +200,38 @@ public:
         const std::vector<VariableInfo>& available_vars,
         const DeadCodeConfig& config) = 0;
 
+    /**
+     * Reset the shared temp/label counters to their initial values.
+     *
+     * The counters are process-global, so long-lived processes (the daemon)
+     * carry them across jobs. Callers that need output determined solely by
+     * (seed, input) must reset them alongside reseeding the RNG.
+     */
+    static void resetCounters() {
+        temp_counter_.store(0, std::memory_order_relaxed);
+        block_counter_.store(0, std::memory_order_relaxed);
+    }
+
 protected:
-    static int temp_counter_;
-    static int block_counter_;
+    // Atomic: generator instances run concurrently under --jobs, and every
+    // worker draws names from the same process-wide sequence.
+    static std::atomic<int> temp_counter_;
+    static std::atomic<int> block_counter_;
 
     /**
      * Generate a unique temporary variable name
      */
     std::string nextTemp(const std::string& prefix = "_dead") {
-        return "%" + prefix + std::to_string(temp_counter_++);
+        return "%" + prefix +
+               std::to_string(temp_counter_.fetch_add(1, std::memory_order_relaxed));
     }
 
     /**
      * Generate a unique label
      */
     std::string nextLabel(const std::string& prefix = "dead_block") {
-        return prefix + std::to_string(block_counter_++);
+        return prefix +
+               std::to_string(block_counter_.fetch_add(1, std::memory_order_relaxed));
     }
 
     /**
@@ -218,6 +252,24 @@ protected:
         return candidates[GlobalRandom::nextInt(0, static_cast<int>(candidates.size()) - 1)];
     }
 
+    /**
+     * Anchor a block's final value in a volatile store
+     *
+     * Plain dead arithmetic is folded away by -O2 even when the guarding
+     * predicate stays opaque, leaving an empty dead block in the binary.
+     * A volatile store to a local slot pins the whole chain feeding it,
+     * which is what lets the compact profile get the same anti-analysis
+     * effect out of far fewer instructions.
+     */
+    void appendVolatileSink(DeadCodeBlock& block, const std::string& value) {
+        std::string sink = nextTemp("_dead_sink");
+        block.code.push_back("  " + sink + " = alloca i32, align 4");
+        block.code.push_back("  store volatile i32 " + value + ", i32* " +
+                             sink + ", align 4");
+        block.vars_created.push_back(sink);
+        block.memory_ops_inserted++;
+    }
+
     /**
      * Generate a random constant of given type
      */
@@ -256,6 +308,10 @@ public:
 
         int num_ops = GlobalRandom::nextInt(config.min_ops_per_block,
                                             config.max_ops_per_block + 1);
+        if (config.compact_profile) {
+            // Compact: shortest chain, every op feeds the sink below
+            num_ops = config.min_ops_per_block;
+        }
 
         // Generate chain of operations
         std::string current_var = nextTemp("_arith_init");
@@ -289,6 +345,10 @@ public:
             current_var = new_var;
         }
 
+        if (config.compact_profile) {
+            appendVolatileSink(block, current_var);
+        }
+
         block.ops_inserted = num_ops;
         return block;
     }
@@ -338,15 +398,18 @@ public:
 
         int num_ops = GlobalRandom::nextInt(config.min_ops_per_block,
                                             config.max_ops_per_block + 1);
+        if (config.compact_profile) {
+            num_ops = config.min_ops_per_block;
+        }
 
         // Allocate some stack space first
         std::string alloca_var = nextTemp("_dead_mem");
         block.code.push_back("  " + alloca_var + " = alloca i32, align 4");
         block.vars_created.push_back(alloca_var);
 
-        // Maybe create an array
+        // Maybe create an array (skipped in compact mode - pure size)
         std::string array_var;
-        if (GlobalRandom::nextDouble() < 0.5) {
+        if (!config.compact_profile && GlobalRandom::nextDouble() < 0.5) {
             array_var = nextTemp("_dead_arr");
             int size = GlobalRandom::nextInt(4, 16);
             block.code.push_back("  " + array_var + " = alloca [" +
@@ -354,20 +417,24 @@ public:
             block.vars_created.push_back(array_var);
         }
 
+        // Compact blocks use volatile accesses so -O2 cannot collapse
+        // the load/store traffic into nothing
+        std::string qualifier = config.compact_profile ? "volatile " : "";
+
         for (int i = 0; i < num_ops; i++) {
             if (GlobalRandom::nextDouble() < 0.5) {
                 // Store operation
                 std::string val_var = nextTemp();
                 block.code.push_back("  " + val_var + " = add i32 0, " +
                     randomConstant("i32"));
-                block.code.push_back("  store i32 " + val_var + ", i32* " +
-                    alloca_var + ", align 4");
+                block.code.push_back("  store " + qualifier + "i32 " + val_var +
+                    ", i32* " + alloca_var + ", align 4");
                 block.vars_created.push_back(val_var);
             } else {
                 // Load operation
                 std::string load_var = nextTemp("_dead_load");
-                block.code.push_back("  " + load_var + " = load i32, i32* " +
-                    alloca_var + ", align 4");
+                block.code.push_back("  " + load_var + " = load " + qualifier +
+                    "i32, i32* " + alloca_var + ", align 4");
                 block.vars_created.push_back(load_var);
             }
         }
@@ -392,7 +459,7 @@ public:
         block.type = DeadCodeType::Call;
         block.needs_guard = true;
 
-        int num_calls = GlobalRandom::nextInt(1, 3);
+        int num_calls = config.compact_profile ? 1 : GlobalRandom::nextInt(1, 3);
 
         for (int i = 0; i < num_calls; i++) {
             std::string nop_func = generateNopFunctionName();
@@ -450,9 +517,26 @@ private:
 
 /**
  * Generates MBA-obfuscated dead code
+ *
+ * Blocks are emitted pre-expanded: a seed arithmetic instruction is run
+ * through the real LLVM MBA transforms at generation time, so the shapes
+ * come from the same variant tables the MBA pass would apply. Emitting
+ * the final form directly replaces the old generate-then-rescan sequence
+ * (dead code first, MBA rewriting it afterwards) with one step; the MBA
+ * pass recognizes the dead-code register prefixes and leaves these
+ * lines alone.
  */
 class MBADeadCodeGenerator : public DeadCodeGenerator {
 public:
+    MBADeadCodeGenerator() {
+        // mul is excluded: its rewrites depend on a constant operand
+        transforms_.push_back(std::make_unique<mba::LLVMMBAAdd>());
+        transforms_.push_back(std::make_unique<mba::LLVMMBASub>());
+        transforms_.push_back(std::make_unique<mba::LLVMMBAXor>());
+        transforms_.push_back(std::make_unique<mba::LLVMMBAAnd>());
+        transforms_.push_back(std::make_unique<mba::LLVMMBAOr>());
+    }
+
     std::string getName() const override { return "MBADeadCode"; }
 
     DeadCodeBlock generate(
@@ -463,13 +547,8 @@ public:
         block.type = DeadCodeType::Arithmetic;
         block.needs_guard = true;
 
-        // Generate a simple addition, then expand to MBA
-        // a + b = (a ^ b) + 2 * (a & b)
         std::string a = nextTemp("_mba_a");
         std::string b = nextTemp("_mba_b");
-        std::string xor_ab = nextTemp("_mba_xor");
-        std::string and_ab = nextTemp("_mba_and");
-        std::string mul_2 = nextTemp("_mba_mul");
         std::string result = nextTemp("_mba_res");
 
         // Initialize with random or existing values
@@ -487,19 +566,242 @@ public:
         }
         b_init = randomConstant("i32");
 
-        block.code.push_back("  ; MBA-obfuscated dead code: (a ^ b) + 2*(a & b)");
+        // Pick a seed operation and expand it through its variant table.
+        // Probability 1 because gating happened at the insertion site.
+        mba::LLVMMBATransformation* transform =
+            transforms_[GlobalRandom::nextInt(
+                0, static_cast<int>(transforms_.size()) - 1)].get();
+        std::string seed = "  " + result + " = " + transform->getOperation() +
+                           " i32 " + a + ", " + b;
+        mba::MBAConfig expand_config;
+        expand_config.enabled = true;
+        expand_config.probability = 1.0;
+        std::vector<std::string> expanded =
+            transform->applyIR(seed, -1, expand_config);
+
+        block.code.push_back("  ; MBA-obfuscated dead code (pre-expanded " +
+                             transform->getOperation() + ")");
         block.code.push_back("  " + a + " = add i32 " + a_init + ", 0");
         block.code.push_back("  " + b + " = add i32 " + b_init + ", 0");
-        block.code.push_back("  " + xor_ab + " = xor i32 " + a + ", " + b);
-        block.code.push_back("  " + and_ab + " = and i32 " + a + ", " + b);
-        block.code.push_back("  " + mul_2 + " = shl i32 " + and_ab + ", 1");
-        block.code.push_back("  " + result + " = add i32 " + xor_ab + ", " + mul_2);
+        block.vars_created = {a, b};
+
+        if (expanded.empty()) {
+            block.code.push_back(seed);
+            block.vars_created.push_back(result);
+            block.ops_inserted = 3;
+        } else {
+            for (const auto& line : expanded) {
+                block.code.push_back(line);
+                collectDest(line, block.vars_created);
+            }
+            block.ops_inserted = 2 + static_cast<int>(expanded.size());
+        }
 
-        block.vars_created = {a, b, xor_ab, and_ab, mul_2, result};
-        block.ops_inserted = 6;
+        if (config.compact_profile) {
+            // The seed destination is the expansion's final value
+            appendVolatileSink(block, result);
+        }
 
         return block;
     }
+
+private:
+    std::vector<std::unique_ptr<mba::LLVMMBATransformation>> transforms_;
+
+    /**
+     * Record the destination register of an expanded instruction line
+     */
+    static void collectDest(const std::string& line,
+                            SmallVector<std::string, 4>& vars_created) {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line[pos] != '%') return;
+        size_t end = pos + 1;
+        while (end < line.size() &&
+               (std::isalnum(static_cast<unsigned char>(line[end])) ||
+                line[end] == '_' || line[end] == '.')) {
+            end++;
+        }
+        if (line.find('=', end) == std::string::npos) return;
+        vars_created.push_back(line.substr(pos, end - pos));
+    }
+};
+
+/**
+ * Pre-generated pool of parameterized dead-code blocks.
+ *
+ * Synthesizing a block from scratch at every insertion point is almost
+ * entirely redundant string work: the shapes repeat, only the names
+ * have to be unique. The pool runs the generators once up front,
+ * rewrites every generated %temp and nop-function name into a stable
+ * placeholder, and instantiate() then just substitutes fresh names into
+ * a randomly picked template. Templates are built with no available
+ * variables, so every instantiated block is self-contained.
+ */
+class DeadCodeBlockPool {
+public:
+    /**
+     * Build block_pool_size templates, split evenly across generators.
+     * Templates are bucketed per generator name so instantiation keeps
+     * the caller's generator-type distribution.
+     */
+    void build(const std::vector<DeadCodeGenerator*>& generators,
+               const DeadCodeConfig& config) {
+        templates_.clear();
+        if (generators.empty() || config.block_pool_size <= 0) {
+            return;
+        }
+
+        int per_generator = config.block_pool_size /
+                            static_cast<int>(generators.size());
+        if (per_generator < 1) per_generator = 1;
+
+        std::vector<VariableInfo> no_vars;
+        for (DeadCodeGenerator* gen : generators) {
+            auto& bucket = templates_[gen->getName()];
+            bucket.reserve(static_cast<size_t>(per_generator));
+            for (int i = 0; i < per_generator; i++) {
+                bucket.push_back(makeTemplate(gen->generate(no_vars, config)));
+            }
+        }
+    }
+
+    bool ready() const { return !templates_.empty(); }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& [name, bucket] : templates_) total += bucket.size();
+        return total;
+    }
+
+    /**
+     * Instantiate a random template from the given generator's bucket
+     * with fresh SSA and nop-function names
+     */
+    DeadCodeBlock instantiate(const std::string& generator_name) {
+        auto it = templates_.find(generator_name);
+        if (it == templates_.end() || it->second.empty()) {
+            return DeadCodeBlock{};
+        }
+
+        const BlockTemplate& tpl =
+            it->second[GlobalRandom::nextSize(it->second.size())];
+
+        // One fresh name per placeholder, unique across instantiations
+        std::vector<std::pair<std::string, std::string>> subst;
+        subst.reserve(tpl.temp_placeholders.size() +
+                      tpl.func_placeholders.size());
+        for (const auto& ph : tpl.temp_placeholders) {
+            subst.emplace_back(ph, "%_pool" + std::to_string(fresh_counter_++));
+        }
+        for (const auto& ph : tpl.func_placeholders) {
+            subst.emplace_back("@" + ph,
+                               "@_pool_nop" + std::to_string(fresh_counter_++));
+        }
+
+        DeadCodeBlock block = tpl.block;
+        for (auto& line : block.code) {
+            for (const auto& [from, to] : subst) {
+                substitute(line, from, to);
+            }
+        }
+        for (auto& name : block.vars_created) {
+            for (const auto& [from, to] : subst) {
+                if (name == from) { name = to; break; }
+            }
+        }
+        for (auto& name : block.nop_functions_created) {
+            for (const auto& [from, to] : subst) {
+                if ("@" + name == from) { name = to.substr(1); break; }
+            }
+        }
+
+        return block;
+    }
+
+private:
+    struct BlockTemplate {
+        DeadCodeBlock block;                          // code with placeholder names
+        std::vector<std::string> temp_placeholders;   // %__tpl<k>_
+        std::vector<std::string> func_placeholders;   // __tplf<k>_ (no @)
+    };
+
+    std::unordered_map<std::string, std::vector<BlockTemplate>> templates_;
+    int fresh_counter_ = 0;
+
+    /**
+     * Rewrite every generated name in the block into a placeholder.
+     * Trailing '_' keeps placeholders from being prefixes of each other,
+     * so substitution never needs token-boundary checks.
+     */
+    static BlockTemplate makeTemplate(DeadCodeBlock block) {
+        BlockTemplate tpl;
+
+        // Nop-function names first: they appear in code as @name
+        for (auto& name : block.nop_functions_created) {
+            std::string placeholder =
+                "__tplf" + std::to_string(tpl.func_placeholders.size()) + "_";
+            for (auto& line : block.code) {
+                substitute(line, "@" + name, "@" + placeholder);
+            }
+            tpl.func_placeholders.push_back(placeholder);
+            name = placeholder;
+        }
+
+        // Every %token is a generator temp (templates are built with no
+        // available variables)
+        std::unordered_map<std::string, std::string> mapping;
+        for (auto& line : block.code) {
+            std::string rewritten;
+            size_t copied = 0;
+            size_t at = line.find('%');
+            while (at != std::string::npos) {
+                size_t end = at + 1;
+                while (end < line.size() &&
+                       (std::isalnum(static_cast<unsigned char>(line[end])) ||
+                        line[end] == '_' || line[end] == '.')) {
+                    end++;
+                }
+                if (end > at + 1) {
+                    std::string token = line.substr(at, end - at);
+                    auto [it, inserted] = mapping.emplace(
+                        token,
+                        "%__tpl" + std::to_string(mapping.size()) + "_");
+                    if (inserted) {
+                        tpl.temp_placeholders.push_back(it->second);
+                    }
+                    rewritten.append(line, copied, at - copied);
+                    rewritten.append(it->second);
+                    copied = end;
+                }
+                at = line.find('%', end);
+            }
+            if (copied > 0) {
+                rewritten.append(line, copied, std::string::npos);
+                line = std::move(rewritten);
+            }
+        }
+
+        for (auto& name : block.vars_created) {
+            auto it = mapping.find(name);
+            if (it != mapping.end()) name = it->second;
+        }
+
+        tpl.block = std::move(block);
+        return tpl;
+    }
+
+    /**
+     * Replace every occurrence of from with to in line
+     */
+    static void substitute(std::string& line,
+                           const std::string& from,
+                           const std::string& to) {
+        size_t pos = 0;
+        while ((pos = line.find(from, pos)) != std::string::npos) {
+            line.replace(pos, from.length(), to);
+            pos += to.length();
+        }
+    }
 };
 
 /**
@@ -621,8 +923,8 @@ public:
 };
 
 // Initialize static counters
-inline int DeadCodeGenerator::temp_counter_ = 0;
-inline int DeadCodeGenerator::block_counter_ = 0;
+inline std::atomic<int> DeadCodeGenerator::temp_counter_{0};
+inline std::atomic<int> DeadCodeGenerator::block_counter_{0};
 
 /**
  * Abstract base for dead code transformations
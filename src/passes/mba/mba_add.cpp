@@ -17,7 +17,10 @@
  */
 
 #include "mba_add.hpp"
+#ifdef MORPHECT_MBA_REGEX_MATCH
 #include <regex>
+#endif
+#include <atomic>
 #include <sstream>
 
 namespace morphect {
@@ -31,7 +34,94 @@ bool MBAAdd::applyGimple(void* gsi, void* stmt, int variant_idx,
 }
 
 // Global temp counter for unique names
-static int g_add_temp_counter = 100000;
+static std::atomic<int> g_add_temp_counter{100000};
+
+void resetAddTempCounter() { g_add_temp_counter.store(100000, std::memory_order_relaxed); }
+
+namespace {
+
+// Variant rewrite tables (placeholder language documented at
+// MBAVariantTemplate in mba_base.hpp). Order matches getVariants().
+
+// (a ^ b) + 2 * (a & b) - classic MBA
+constexpr const char* kAdd0[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%3 = shl %T %2, 1",
+    "%d = add %T %1, %3",
+};
+// (a | b) + (a & b)
+constexpr const char* kAdd1[] = {
+    "%1 = or %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%d = add %T %1, %2",
+};
+// 2 * (a | b) - (a ^ b)
+constexpr const char* kAdd2[] = {
+    "%1 = or %T %a, %b",
+    "%2 = shl %T %1, 1",
+    "%3 = xor %T %a, %b",
+    "%d = sub %T %2, %3",
+};
+// a - (~b + 1) - two's complement negation
+constexpr const char* kAdd3[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = add %T %1, 1",
+    "%d = sub %T %a, %2",
+};
+// ~(~a - b) - complement identity
+constexpr const char* kAdd4[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = sub %T %1, %b",
+    "%d = xor %T %2, -1",
+};
+// (a & b) + (a | b) - symmetric form
+constexpr const char* kAdd5[] = {
+    "%1 = and %T %a, %b",
+    "%2 = or %T %a, %b",
+    "%d = add %T %1, %2",
+};
+// ((a ^ b) | (a & b)) + (a & b) - complex
+constexpr const char* kAdd6[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%3 = or %T %1, %2",
+    "%d = add %T %3, %2",
+};
+// a|b = (a^b) + (a&b), so a+b = (a^b) + 2*(a&b) computed stepwise
+constexpr const char* kAdd7[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%3 = add %T %1, %2",
+    "%d = add %T %3, %2",
+};
+// b - (~a + 1) - two's complement negation, mirrored
+// (replaced the old (2*a + 2*b) >> 1 form, which dropped the carry out
+// of the top bit and was wrong whenever 2a + 2b overflowed)
+constexpr const char* kAdd8[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = add %T %1, 1",
+    "%d = sub %T %b, %2",
+};
+// Deep nesting: ~(~(a ^ b) - 2*(a & b))
+constexpr const char* kAdd9[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = xor %T %1, -1",
+    "%3 = and %T %a, %b",
+    "%4 = shl %T %3, 1",
+    "%5 = sub %T %2, %4",
+    "%d = xor %T %5, -1",
+};
+
+constexpr MBAVariantTemplate kAddVariants[] = {
+    {kAdd0, 4}, {kAdd1, 3}, {kAdd2, 4}, {kAdd3, 3}, {kAdd4, 3},
+    {kAdd5, 3}, {kAdd6, 4}, {kAdd7, 4}, {kAdd8, 3}, {kAdd9, 6},
+};
+
+constexpr size_t kAddVariantCount =
+    sizeof(kAddVariants) / sizeof(kAddVariants[0]);
+
+} // namespace
 
 /**
  * Apply MBA ADD transformation to LLVM IR
@@ -47,11 +137,14 @@ std::vector<std::string> LLVMMBAAdd::applyIR(const std::string& line,
         return result;
     }
 
-    // More robust pattern that handles:
+    // Handles:
     // - Standard: %result = add i32 %a, %b
     // - With flags: %result = add nsw i32 %a, %b
     // - With nuw nsw: %result = add nuw nsw i32 %a, %b
     // - Vector types: %result = add <4 x i32> %a, %b
+    ArithMatch m;
+#ifdef MORPHECT_MBA_REGEX_MATCH
+    // Reference fallback: the original regex the hand-rolled matcher replaced
     std::regex add_pattern(
         R"(^(\s*)(%[\w.]+)\s*=\s*add\s+(nsw\s+|nuw\s+|nuw nsw\s+|nsw nuw\s+)?(<\d+\s*x\s*)?(\w+)(\s*>)?\s+(%[\w.]+|[\d-]+),\s*(%[\w.]+|[\d-]+)\s*$)"
     );
@@ -61,123 +154,37 @@ std::vector<std::string> LLVMMBAAdd::applyIR(const std::string& line,
         return result;
     }
 
-    std::string indent = match[1];
-    std::string dest = match[2];
-    std::string flags = match[3];  // nsw/nuw flags
-    std::string vec_prefix = match[4];  // <4 x  for vectors
-    std::string base_type = match[5];   // i32, i64, etc
-    std::string vec_suffix = match[6];  // > for vectors
-    std::string op1 = match[7];
-    std::string op2 = match[8];
-
-    // Reconstruct full type
-    std::string type = vec_prefix + base_type + vec_suffix;
+    m.indent = match[1];
+    m.dest = match[2];
+    m.type = match[4].str() + match[5].str() + match[6].str();
+    m.op1 = match[7];
+    m.op2 = match[8];
+#else
+    if (!matchArithInstruction(line, "add", /*allow_wrap_flags=*/true,
+                               /*op1_register_only=*/false, m)) {
+        return result;
+    }
+#endif
 
     // Skip if both operands are constants (optimizer will fold anyway)
-    bool op1_const = (op1[0] != '%');
-    bool op2_const = (op2[0] != '%');
-    if (op1_const && op2_const) {
+    if (m.op1[0] != '%' && m.op2[0] != '%') {
         return result;
     }
 
     // Select variant (we have 10 variants now)
-    size_t var_idx = (variant_idx >= 0) ?
-        static_cast<size_t>(variant_idx) % 10 : selectVariant(config);
+    size_t var_idx = ((variant_idx >= 0) ?
+        static_cast<size_t>(variant_idx) : selectVariant(config)) % kAddVariantCount;
 
     // Generate unique temp names with counter to avoid collisions
-    int base = g_add_temp_counter;
-    g_add_temp_counter += 10;
-    std::string t1 = "%_mba_a" + std::to_string(base);
-    std::string t2 = "%_mba_a" + std::to_string(base + 1);
-    std::string t3 = "%_mba_a" + std::to_string(base + 2);
-    std::string t4 = "%_mba_a" + std::to_string(base + 3);
-    std::string t5 = "%_mba_a" + std::to_string(base + 4);
-    std::string t6 = "%_mba_a" + std::to_string(base + 5);
-
-    switch (var_idx) {
-        case 0:  // (a ^ b) + 2 * (a & b) - classic MBA
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t3 + " = shl " + type + " " + t2 + ", 1");
-            result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t3);
-            break;
-        }
-        case 1:  // (a | b) + (a & b)
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 2:  // 2 * (a | b) - (a ^ b)
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = shl " + type + " " + t1 + ", 1");
-            result.push_back(indent + t3 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t2 + ", " + t3);
-            break;
-        }
-        case 3:  // a - (~b + 1) - two's complement negation
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = add " + type + " " + t1 + ", 1");
-            result.push_back(indent + dest + " = sub " + type + " " + op1 + ", " + t2);
-            break;
-        }
-        case 4:  // ~(~a - b) - complement identity
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = sub " + type + " " + t1 + ", " + op2);
-            result.push_back(indent + dest + " = xor " + type + " " + t2 + ", -1");
-            break;
-        }
-        case 5:  // (a & b) + (a | b) - symmetric form
-        {
-            result.push_back(indent + t1 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 6:  // ((a ^ b) | (a & b)) + (a & b) - complex
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t3 + " = or " + type + " " + t1 + ", " + t2);
-            result.push_back(indent + dest + " = add " + type + " " + t3 + ", " + t2);
-            break;
-        }
-        case 7:  // (a | b) + (a & b) with intermediate XOR obfuscation
-        {
-            // a|b = (a^b) + (a&b), so a+b = (a^b) + 2*(a&b)
-            // But we compute it differently for variety
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t3 + " = add " + type + " " + t1 + ", " + t2);  // a|b
-            result.push_back(indent + dest + " = add " + type + " " + t3 + ", " + t2); // +a&b
-            break;
-        }
-        case 8:  // (2*a + 2*b) / 2 but done with shifts to confuse
-        {
-            result.push_back(indent + t1 + " = shl " + type + " " + op1 + ", 1");
-            result.push_back(indent + t2 + " = shl " + type + " " + op2 + ", 1");
-            result.push_back(indent + t3 + " = add " + type + " " + t1 + ", " + t2);
-            result.push_back(indent + dest + " = lshr " + type + " " + t3 + ", 1");
-            break;
-        }
-        case 9:  // Deep nesting: ~(~(a ^ b) - 2*(a & b))
-        default:
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = xor " + type + " " + t1 + ", -1");  // ~(a^b)
-            result.push_back(indent + t3 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t4 + " = shl " + type + " " + t3 + ", 1");   // 2*(a&b)
-            result.push_back(indent + t5 + " = sub " + type + " " + t2 + ", " + t4);
-            result.push_back(indent + dest + " = xor " + type + " " + t5 + ", -1");
-            break;
-        }
+    int base = g_add_temp_counter.fetch_add(10, std::memory_order_relaxed);
+    std::string temps[6];
+    for (int i = 0; i < 6; i++) {
+        temps[i] = "%_mba_a" + std::to_string(base + i);
     }
 
+    expandMBAVariant(kAddVariants[var_idx], m.indent, m.dest, m.type, m.op1,
+                     m.op2, temps, result);
+
     logger_.debug("Applied MBA ADD variant {} to: {}", var_idx, line);
     return result;
 }
@@ -56,7 +56,7 @@ public:
             MBAVariant("symmetric", "(a & b) + (a | b)", 0.10),
             MBAVariant("complex_or", "((a ^ b) | (a & b)) + (a & b)", 0.10),
             MBAVariant("xor_and_chain", "(a ^ b) + (a & b) + (a & b)", 0.08),
-            MBAVariant("shift_div", "(2*a + 2*b) >> 1", 0.08),
+            MBAVariant("twos_comp_rev", "b - (~a + 1)", 0.08),
             MBAVariant("deep_nest", "~(~(a ^ b) - 2*(a & b))", 0.10)
         };
     }
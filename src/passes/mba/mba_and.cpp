@@ -15,7 +15,10 @@
  */
 
 #include "mba_and.hpp"
+#ifdef MORPHECT_MBA_REGEX_MATCH
 #include <regex>
+#endif
+#include <atomic>
 #include <sstream>
 
 namespace morphect {
@@ -28,7 +31,80 @@ bool MBAAnd::applyGimple(void* gsi, void* stmt, int variant_idx,
 }
 
 // Global counter for unique temp names
-static int g_and_counter = 400000;
+static std::atomic<int> g_and_counter{400000};
+
+void resetAndTempCounter() { g_and_counter.store(400000, std::memory_order_relaxed); }
+
+namespace {
+
+// Variant rewrite tables (placeholder language documented at
+// MBAVariantTemplate in mba_base.hpp). Order matches getVariants().
+
+// (a | b) - (a ^ b)
+constexpr const char* kAnd0[] = {
+    "%1 = or %T %a, %b",
+    "%2 = xor %T %a, %b",
+    "%d = sub %T %1, %2",
+};
+// ~(~a | ~b) - De Morgan's law
+constexpr const char* kAnd1[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = xor %T %b, -1",
+    "%3 = or %T %1, %2",
+    "%d = xor %T %3, -1",
+};
+// a - (a & ~b)
+constexpr const char* kAnd2[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = and %T %a, %1",
+    "%d = sub %T %a, %2",
+};
+// (a | b) & ~(a ^ b)
+constexpr const char* kAnd3[] = {
+    "%1 = or %T %a, %b",
+    "%2 = xor %T %a, %b",
+    "%3 = xor %T %2, -1",
+    "%d = and %T %1, %3",
+};
+// b - (~a & b)
+constexpr const char* kAnd4[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = and %T %1, %b",
+    "%d = sub %T %b, %2",
+};
+// (a + b) - (a | b) - arithmetic relationship
+constexpr const char* kAnd5[] = {
+    "%1 = add %T %a, %b",
+    "%2 = or %T %a, %b",
+    "%d = sub %T %1, %2",
+};
+// a ^ (a & ~b) - XOR with bits only in a
+constexpr const char* kAnd6[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = and %T %a, %1",
+    "%d = xor %T %a, %2",
+};
+// Complex: compute a^b the hard way as (~a & b) | (a & ~b), then
+// (a|b) - (a^b) = a&b
+constexpr const char* kAnd7[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = and %T %1, %b",
+    "%3 = xor %T %b, -1",
+    "%4 = and %T %a, %3",
+    "%5 = or %T %2, %4",
+    "%6 = or %T %a, %b",
+    "%d = sub %T %6, %5",
+};
+
+constexpr MBAVariantTemplate kAndVariants[] = {
+    {kAnd0, 3}, {kAnd1, 4}, {kAnd2, 3}, {kAnd3, 4},
+    {kAnd4, 3}, {kAnd5, 3}, {kAnd6, 3}, {kAnd7, 7},
+};
+
+constexpr size_t kAndVariantCount =
+    sizeof(kAndVariants) / sizeof(kAndVariants[0]);
+
+} // namespace
 
 /**
  * Apply MBA AND transformation to LLVM IR
@@ -45,7 +121,9 @@ std::vector<std::string> LLVMMBAAnd::applyIR(const std::string& line,
         return result;
     }
 
-    // Robust pattern for AND - handles vector types like <4 x i32>
+    ArithMatch m;
+#ifdef MORPHECT_MBA_REGEX_MATCH
+    // Reference fallback: the original regex the hand-rolled matcher replaced
     std::regex and_pattern(
         R"(^(\s*)(%[\w.]+)\s*=\s*and\s+(<\d+\s*x\s*)?(\w+)(\s*>)?\s+(%[\w.]+),\s*(%[\w.]+|[\d-]+)\s*$)"
     );
@@ -55,100 +133,30 @@ std::vector<std::string> LLVMMBAAnd::applyIR(const std::string& line,
         return result;
     }
 
-    std::string indent = match[1];
-    std::string dest = match[2];
-    std::string vec_prefix = match[3];
-    std::string base_type = match[4];
-    std::string vec_suffix = match[5];
-    std::string op1 = match[6];
-    std::string op2 = match[7];
-
-    std::string type = vec_prefix + base_type + vec_suffix;
-
-    // Skip constant AND
-    if (op1[0] != '%' && op2[0] != '%') {
+    m.indent = match[1];
+    m.dest = match[2];
+    m.type = match[3].str() + match[4].str() + match[5].str();
+    m.op1 = match[6];
+    m.op2 = match[7];
+#else
+    if (!matchArithInstruction(line, "and", /*allow_wrap_flags=*/false,
+                               /*op1_register_only=*/true, m)) {
         return result;
     }
+#endif
 
-    size_t var_idx = (variant_idx >= 0) ?
-        static_cast<size_t>(variant_idx) % 8 : selectVariant(config);
-
-    int base = g_and_counter;
-    g_and_counter += 10;
-    std::string t1 = "%_mba_n" + std::to_string(base);
-    std::string t2 = "%_mba_n" + std::to_string(base + 1);
-    std::string t3 = "%_mba_n" + std::to_string(base + 2);
-    std::string t4 = "%_mba_n" + std::to_string(base + 3);
-    std::string t5 = "%_mba_n" + std::to_string(base + 4);
-
-    switch (var_idx) {
-        case 0:  // (a | b) - (a ^ b)
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 1:  // ~(~a | ~b) - De Morgan's law
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t3 + " = or " + type + " " + t1 + ", " + t2);
-            result.push_back(indent + dest + " = xor " + type + " " + t3 + ", -1");
-            break;
-        }
-        case 2:  // a - (a & ~b)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + dest + " = sub " + type + " " + op1 + ", " + t2);
-            break;
-        }
-        case 3:  // (a | b) & ~(a ^ b)
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t3 + " = xor " + type + " " + t2 + ", -1");
-            result.push_back(indent + dest + " = and " + type + " " + t1 + ", " + t3);
-            break;
-        }
-        case 4:  // b - (~a & b)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + t1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + op2 + ", " + t2);
-            break;
-        }
-        case 5:  // (a + b) - (a | b) - arithmetic relationship
-        {
-            result.push_back(indent + t1 + " = add " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 6:  // a ^ (a & ~b) - XOR with bits only in a
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + dest + " = xor " + type + " " + op1 + ", " + t2);
-            break;
-        }
-        case 7:  // Complex via: (a|b) - ((~a & b) | (a & ~b)) = (a|b) - (a^b) = a&b
-        default:
-        {
-            // Compute a^b the hard way, then subtract from a|b
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");  // ~a
-            result.push_back(indent + t2 + " = and " + type + " " + t1 + ", " + op2);  // ~a & b
-            result.push_back(indent + t3 + " = xor " + type + " " + op2 + ", -1");  // ~b
-            result.push_back(indent + t4 + " = and " + type + " " + op1 + ", " + t3);  // a & ~b
-            result.push_back(indent + t5 + " = or " + type + " " + t2 + ", " + t4);  // (~a & b) | (a & ~b) = a ^ b
-            std::string t6 = "%_mba_n" + std::to_string(base + 5);
-            result.push_back(indent + t6 + " = or " + type + " " + op1 + ", " + op2);  // a | b
-            result.push_back(indent + dest + " = sub " + type + " " + t6 + ", " + t5);  // (a|b) - (a^b) = a&b
-            break;
-        }
+    size_t var_idx = ((variant_idx >= 0) ?
+        static_cast<size_t>(variant_idx) : selectVariant(config)) % kAndVariantCount;
+
+    int base = g_and_counter.fetch_add(10, std::memory_order_relaxed);
+    std::string temps[6];
+    for (int i = 0; i < 6; i++) {
+        temps[i] = "%_mba_n" + std::to_string(base + i);
     }
 
+    expandMBAVariant(kAndVariants[var_idx], m.indent, m.dest, m.type, m.op1,
+                     m.op2, temps, result);
+
     logger_.debug("Applied MBA AND variant {} to: {}", var_idx, line);
     return result;
 }
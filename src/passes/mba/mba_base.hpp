@@ -13,8 +13,12 @@
 #include "../../core/transformation_base.hpp"
 #include "../../common/random.hpp"
 #include "../../common/logging.hpp"
+#include "../../common/string_builder.hpp"
 
+#include <atomic>
+#include <cctype>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 
@@ -45,6 +49,211 @@ struct MBAConfig {
     std::vector<double> variant_weights;  // Custom weights for variants
 };
 
+/**
+ * Precomputed LLVM IR rewrite template
+ *
+ * Every variant of an LLVM MBA transformation emits a fixed instruction
+ * sequence that only differs in the register names spliced in. The
+ * sequences are stored once as constexpr template strings and expanded
+ * in a single scan per line, instead of being concatenated piece by
+ * piece on every application.
+ *
+ * Placeholders:
+ *   %d       destination register
+ *   %a, %b   original operands
+ *   %T       full operand type (including vector wrapper)
+ *   %1..%6   generated temp registers
+ */
+struct MBAVariantTemplate {
+    const char* const* lines;   // instruction templates, last one writes %d
+    size_t line_count;
+};
+
+/**
+ * Expand one instruction template into a finished IR line
+ */
+inline std::string expandMBATemplateLine(const char* tmpl,
+                                         std::string_view indent,
+                                         std::string_view dest,
+                                         std::string_view type,
+                                         std::string_view op1,
+                                         std::string_view op2,
+                                         const std::string* temps) {
+    StringBuilder out(indent.size() + 64);
+    out.append(indent);
+    for (const char* p = tmpl; *p != '\0'; ++p) {
+        if (*p != '%') {
+            out.append(*p);
+            continue;
+        }
+        char tag = p[1];
+        switch (tag) {
+            case 'd': out.append(dest); ++p; break;
+            case 'a': out.append(op1);  ++p; break;
+            case 'b': out.append(op2);  ++p; break;
+            case 'T': out.append(type); ++p; break;
+            default:
+                if (tag >= '1' && tag <= '6') {
+                    out.append(temps[tag - '1']);
+                    ++p;
+                } else {
+                    out.append('%');   // literal percent
+                }
+                break;
+        }
+    }
+    return out.take();
+}
+
+/**
+ * Expand a whole variant template into the result vector
+ */
+inline void expandMBAVariant(const MBAVariantTemplate& variant,
+                             std::string_view indent,
+                             std::string_view dest,
+                             std::string_view type,
+                             std::string_view op1,
+                             std::string_view op2,
+                             const std::string* temps,
+                             std::vector<std::string>& result) {
+    result.reserve(result.size() + variant.line_count);
+    for (size_t i = 0; i < variant.line_count; ++i) {
+        result.push_back(expandMBATemplateLine(variant.lines[i], indent, dest,
+                                               type, op1, op2, temps));
+    }
+}
+
+/**
+ * Operand fields of a matched arithmetic instruction
+ */
+struct ArithMatch {
+    std::string indent;
+    std::string dest;
+    std::string type;   // full operand type, including any vector wrapper
+    std::string op1;
+    std::string op2;
+};
+
+/**
+ * Hand-rolled matcher for "%dest = <opcode> [nsw|nuw] <type> op1, op2"
+ *
+ * Matching candidate lines used to go through std::regex, which showed up
+ * as the hottest call stack in profiles of the IR passes. This matcher
+ * checks the opcode token with a prefix compare and slices the operands
+ * out in a single left-to-right scan, accepting the same line shapes as
+ * the old patterns. The regex path is kept as a reference fallback behind
+ * MORPHECT_MBA_REGEX_MATCH in the individual transform sources.
+ *
+ * @param allow_wrap_flags   accept nsw/nuw between opcode and type
+ * @param op1_register_only  reject a constant first operand (xor/and/or)
+ */
+inline bool matchArithInstruction(const std::string& line,
+                                  std::string_view opcode,
+                                  bool allow_wrap_flags,
+                                  bool op1_register_only,
+                                  ArithMatch& out) {
+    const char* s = line.c_str();
+    const size_t n = line.size();
+    size_t i = 0;
+
+    auto skipSpace = [&]() {
+        while (i < n && std::isspace(static_cast<unsigned char>(s[i]))) ++i;
+    };
+    auto isRegChar = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.';
+    };
+
+    skipSpace();
+    const size_t indent_end = i;
+
+    // %dest
+    if (i >= n || s[i] != '%') return false;
+    const size_t dest_start = i++;
+    while (i < n && isRegChar(s[i])) ++i;
+    if (i == dest_start + 1) return false;
+    const size_t dest_end = i;
+
+    skipSpace();
+    if (i >= n || s[i] != '=') return false;
+    ++i;
+    skipSpace();
+
+    // opcode token, followed by whitespace
+    if (line.compare(i, opcode.size(), opcode.data(), opcode.size()) != 0) return false;
+    i += opcode.size();
+    if (i >= n || !std::isspace(static_cast<unsigned char>(s[i]))) return false;
+    skipSpace();
+
+    // optional overflow flags
+    if (allow_wrap_flags) {
+        while (i + 3 < n &&
+               (line.compare(i, 3, "nsw") == 0 || line.compare(i, 3, "nuw") == 0) &&
+               std::isspace(static_cast<unsigned char>(s[i + 3]))) {
+            i += 3;
+            skipSpace();
+        }
+    }
+
+    // type: scalar word or "<N x word>"
+    const size_t type_start = i;
+    if (i < n && s[i] == '<') {
+        ++i;
+        if (i >= n || !std::isdigit(static_cast<unsigned char>(s[i]))) return false;
+        while (i < n && std::isdigit(static_cast<unsigned char>(s[i]))) ++i;
+        skipSpace();
+        if (i >= n || s[i] != 'x') return false;
+        ++i;
+        skipSpace();
+        const size_t elem_start = i;
+        while (i < n && (std::isalnum(static_cast<unsigned char>(s[i])) || s[i] == '_')) ++i;
+        if (i == elem_start) return false;
+        skipSpace();
+        if (i >= n || s[i] != '>') return false;
+        ++i;
+    } else {
+        const size_t word_start = i;
+        while (i < n && (std::isalnum(static_cast<unsigned char>(s[i])) || s[i] == '_')) ++i;
+        if (i == word_start) return false;
+    }
+    const size_t type_end = i;
+
+    if (i >= n || !std::isspace(static_cast<unsigned char>(s[i]))) return false;
+    skipSpace();
+
+    // operand: register (%name) or integer constant
+    auto scanOperand = [&](size_t& start, size_t& end, bool register_only) {
+        start = i;
+        if (i < n && s[i] == '%') {
+            ++i;
+            while (i < n && isRegChar(s[i])) ++i;
+            if (i == start + 1) return false;
+        } else {
+            if (register_only) return false;
+            while (i < n && (std::isdigit(static_cast<unsigned char>(s[i])) || s[i] == '-')) ++i;
+            if (i == start) return false;
+        }
+        end = i;
+        return true;
+    };
+
+    size_t op1_start = 0, op1_end = 0, op2_start = 0, op2_end = 0;
+    if (!scanOperand(op1_start, op1_end, op1_register_only)) return false;
+    skipSpace();
+    if (i >= n || s[i] != ',') return false;
+    ++i;
+    skipSpace();
+    if (!scanOperand(op2_start, op2_end, false)) return false;
+    skipSpace();
+    if (i != n) return false;
+
+    out.indent.assign(s, indent_end);
+    out.dest.assign(s + dest_start, dest_end - dest_start);
+    out.type.assign(s + type_start, type_end - type_start);
+    out.op1.assign(s + op1_start, op1_end - op1_start);
+    out.op2.assign(s + op2_start, op2_end - op2_start);
+    return true;
+}
+
 /**
  * Abstract base class for MBA transformations
  * Each operation (ADD, SUB, XOR, etc.) implements this
@@ -75,29 +284,37 @@ public:
 
     /**
      * Select a variant based on configuration
+     *
+     * Weighted selection goes through an alias table built on first use
+     * (and rebuilt if the configured weights change), so each draw is
+     * O(1) instead of a cumulative-weight walk.
      */
     size_t selectVariant(const MBAConfig& config) const {
-        const auto& variants = getVariants();
-        if (variants.empty()) return 0;
+        if (default_weights_.empty()) {
+            for (const auto& v : getVariants()) {
+                default_weights_.push_back(v.probability);
+            }
+            if (default_weights_.empty()) return 0;
+        }
 
         if (config.use_all_variants) {
-            // Round-robin selection
-            static size_t counter = 0;
-            return (counter++) % variants.size();
+            // Round-robin selection; atomic so concurrent workers still
+            // cycle through every variant without racing.
+            static std::atomic<size_t> counter{0};
+            return counter.fetch_add(1, std::memory_order_relaxed) %
+                   default_weights_.size();
         }
 
-        // Weighted random selection
-        std::vector<double> weights;
-        if (!config.variant_weights.empty() &&
-            config.variant_weights.size() == variants.size()) {
-            weights = config.variant_weights;
-        } else {
-            for (const auto& v : variants) {
-                weights.push_back(v.probability);
-            }
-        }
+        const std::vector<double>& weights =
+            (!config.variant_weights.empty() &&
+             config.variant_weights.size() == default_weights_.size())
+                ? config.variant_weights
+                : default_weights_;
 
-        return GlobalRandom::chooseWeightedIndex(weights);
+        if (!variant_sampler_.matches(weights)) {
+            variant_sampler_.build(weights);
+        }
+        return variant_sampler_.sample();
     }
 
     /**
@@ -112,6 +329,10 @@ protected:
     Logger logger_;
 
     MBATransformation(const std::string& name) : logger_(name) {}
+
+private:
+    mutable AliasSampler variant_sampler_;
+    mutable std::vector<double> default_weights_;  // from getVariants()
 };
 
 /**
@@ -156,6 +377,32 @@ public:
                                              const MBAConfig& config) = 0;
 };
 
+/**
+ * Reset the per-operation temp-name counters to their initial values.
+ *
+ * Each mba_*.cpp keeps a process-global counter for generating unique
+ * temporary names. Long-lived processes (the obfuscation daemon) accumulate
+ * counter state across jobs, so two runs over the same input would emit
+ * different temp names. Callers that promise deterministic output for a
+ * given (seed, input) pair must reset these alongside reseeding the RNG.
+ * Definitions live in the respective translation units.
+ */
+void resetAddTempCounter();
+void resetSubTempCounter();
+void resetXorTempCounter();
+void resetAndTempCounter();
+void resetOrTempCounter();
+void resetMultTempCounter();
+
+inline void resetTempCounters() {
+    resetAddTempCounter();
+    resetSubTempCounter();
+    resetXorTempCounter();
+    resetAndTempCounter();
+    resetOrTempCounter();
+    resetMultTempCounter();
+}
+
 } // namespace mba
 } // namespace morphect
 
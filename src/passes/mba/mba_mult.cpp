@@ -11,7 +11,10 @@
  */
 
 #include "mba_mult.hpp"
+#ifdef MORPHECT_MBA_REGEX_MATCH
 #include <regex>
+#endif
+#include <atomic>
 #include <sstream>
 #include <cstdlib>
 
@@ -25,7 +28,78 @@ bool MBAMult::applyGimple(void* gsi, void* stmt, int variant_idx,
 }
 
 // Global counter for unique temp names
-static int g_mult_temp_counter = 600000;
+static std::atomic<int> g_mult_temp_counter{600000};
+
+void resetMultTempCounter() { g_mult_temp_counter.store(600000, std::memory_order_relaxed); }
+
+namespace {
+
+// Hand-optimized addition chains for small constants, stored as rewrite
+// templates (placeholder language documented at MBAVariantTemplate in
+// mba_base.hpp; only %a/%T/%d/%1-%3 are used since the shift amounts
+// are fixed per constant). Indexed by the multiplier value; constants
+// without a chain (0-2, 4, 8) are caught by the power-of-2 branches.
+constexpr const char* kMul3[] = {   // a * 3 = (a << 1) + a
+    "%1 = shl %T %a, 1",
+    "%d = add %T %1, %a",
+};
+constexpr const char* kMul5[] = {   // a * 5 = (a << 2) + a
+    "%1 = shl %T %a, 2",
+    "%d = add %T %1, %a",
+};
+constexpr const char* kMul6[] = {   // a * 6 = (a << 2) + (a << 1)
+    "%1 = shl %T %a, 2",
+    "%2 = shl %T %a, 1",
+    "%d = add %T %1, %2",
+};
+constexpr const char* kMul7[] = {   // a * 7 = (a << 3) - a
+    "%1 = shl %T %a, 3",
+    "%d = sub %T %1, %a",
+};
+constexpr const char* kMul9[] = {   // a * 9 = (a << 3) + a
+    "%1 = shl %T %a, 3",
+    "%d = add %T %1, %a",
+};
+constexpr const char* kMul10[] = {  // a * 10 = (a << 3) + (a << 1)
+    "%1 = shl %T %a, 3",
+    "%2 = shl %T %a, 1",
+    "%d = add %T %1, %2",
+};
+constexpr const char* kMul11[] = {  // a * 11 = (a << 3) + (a << 1) + a
+    "%1 = shl %T %a, 3",
+    "%2 = shl %T %a, 1",
+    "%3 = add %T %1, %2",
+    "%d = add %T %3, %a",
+};
+constexpr const char* kMul12[] = {  // a * 12 = (a << 3) + (a << 2)
+    "%1 = shl %T %a, 3",
+    "%2 = shl %T %a, 2",
+    "%d = add %T %1, %2",
+};
+constexpr const char* kMul13[] = {  // a * 13 = (a << 4) - (a << 1) - a
+    "%1 = shl %T %a, 4",
+    "%2 = shl %T %a, 1",
+    "%3 = sub %T %1, %2",
+    "%d = sub %T %3, %a",
+};
+constexpr const char* kMul14[] = {  // a * 14 = (a << 4) - (a << 1)
+    "%1 = shl %T %a, 4",
+    "%2 = shl %T %a, 1",
+    "%d = sub %T %1, %2",
+};
+constexpr const char* kMul15[] = {  // a * 15 = (a << 4) - a
+    "%1 = shl %T %a, 4",
+    "%d = sub %T %1, %a",
+};
+
+constexpr MBAVariantTemplate kMultChains[16] = {
+    {nullptr, 0}, {nullptr, 0}, {nullptr, 0}, {kMul3, 2},
+    {nullptr, 0}, {kMul5, 2},   {kMul6, 3},   {kMul7, 2},
+    {nullptr, 0}, {kMul9, 2},   {kMul10, 3},  {kMul11, 4},
+    {kMul12, 3},  {kMul13, 4},  {kMul14, 3},  {kMul15, 2},
+};
+
+} // namespace
 
 /**
  * Apply MBA MULT transformation to LLVM IR
@@ -42,14 +116,16 @@ std::vector<std::string> LLVMMBAMult::applyIR(const std::string& line,
         return result;
     }
 
-    // Robust pattern for MUL - handles vector types and flags
-    // Pattern 1: %result = mul [flags] <type> %a, <constant>
+    // Matches "%result = mul [flags] <type> %a, <constant>" and the
+    // swapped constant-first form; register-register products are left alone
+    ArithMatch m;
+#ifdef MORPHECT_MBA_REGEX_MATCH
+    // Reference fallback: the original regexes the hand-rolled matcher replaced
     std::regex mul_pattern(
         R"(^(\s*)(%[\w.]+)\s*=\s*mul\s+(nsw\s+|nuw\s+|nuw nsw\s+|nsw nuw\s+)?(<\d+\s*x\s*)?(\w+)(\s*>)?\s+(%[\w.]+),\s*([\d-]+)\s*$)"
     );
 
     std::smatch match;
-    bool swapped = false;
     if (!std::regex_match(line, match, mul_pattern)) {
         // Try with constant first
         std::regex mul_pattern2(
@@ -58,18 +134,32 @@ std::vector<std::string> LLVMMBAMult::applyIR(const std::string& line,
         if (!std::regex_match(line, match, mul_pattern2)) {
             return result;
         }
-        swapped = true;
     }
 
-    std::string indent = match[1];
-    std::string dest = match[2];
-    std::string vec_prefix = match[4];
-    std::string base_type = match[5];
-    std::string vec_suffix = match[6];
-    std::string var_op = swapped ? match[8].str() : match[7].str();
-    std::string const_str = swapped ? match[7].str() : match[8].str();
+    m.indent = match[1];
+    m.dest = match[2];
+    m.type = match[4].str() + match[5].str() + match[6].str();
+    m.op1 = match[7];
+    m.op2 = match[8];
+#else
+    if (!matchArithInstruction(line, "mul", /*allow_wrap_flags=*/true,
+                               /*op1_register_only=*/false, m)) {
+        return result;
+    }
+#endif
+
+    // Need exactly one register and one constant operand
+    bool op1_const = (m.op1[0] != '%');
+    bool op2_const = (m.op2[0] != '%');
+    if (op1_const == op2_const) {
+        return result;
+    }
 
-    std::string type = vec_prefix + base_type + vec_suffix;
+    const std::string& indent = m.indent;
+    const std::string& dest = m.dest;
+    const std::string& type = m.type;
+    const std::string& var_op = op1_const ? m.op2 : m.op1;
+    const std::string& const_str = op1_const ? m.op1 : m.op2;
 
     // Parse constant
     int64_t constant;
@@ -85,8 +175,7 @@ std::vector<std::string> LLVMMBAMult::applyIR(const std::string& line,
     }
 
     // Get unique temp base
-    int base = g_mult_temp_counter;
-    g_mult_temp_counter += 10;
+    int base = g_mult_temp_counter.fetch_add(10, std::memory_order_relaxed);
 
     // Select transformation based on constant value
     if (isPowerOf2(constant)) {
@@ -119,106 +208,18 @@ std::vector<std::string> LLVMMBAMult::applyIR(const std::string& line,
     else if (constant <= 15) {
         // Small constants - use optimized addition chains
         // These are hand-optimized for minimum instruction count
-        int tidx = 0;
-        auto getTemp = [&]() { return "%_mba_m" + std::to_string(base + tidx++); };
+        const MBAVariantTemplate& chain = kMultChains[constant];
+        if (chain.lines == nullptr) {
+            return result;  // Don't transform
+        }
 
-        switch (constant) {
-            case 3: {
-                // a * 3 = (a << 1) + a
-                std::string t1 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 1");
-                result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + var_op);
-                break;
-            }
-            case 5: {
-                // a * 5 = (a << 2) + a
-                std::string t1 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 2");
-                result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + var_op);
-                break;
-            }
-            case 6: {
-                // a * 6 = (a << 2) + (a << 1)
-                std::string t1 = getTemp();
-                std::string t2 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 2");
-                result.push_back(indent + t2 + " = shl " + type + " " + var_op + ", 1");
-                result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t2);
-                break;
-            }
-            case 7: {
-                // a * 7 = (a << 3) - a
-                std::string t1 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 3");
-                result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + var_op);
-                break;
-            }
-            case 9: {
-                // a * 9 = (a << 3) + a
-                std::string t1 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 3");
-                result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + var_op);
-                break;
-            }
-            case 10: {
-                // a * 10 = (a << 3) + (a << 1)
-                std::string t1 = getTemp();
-                std::string t2 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 3");
-                result.push_back(indent + t2 + " = shl " + type + " " + var_op + ", 1");
-                result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t2);
-                break;
-            }
-            case 11: {
-                // a * 11 = (a << 3) + (a << 1) + a
-                std::string t1 = getTemp();
-                std::string t2 = getTemp();
-                std::string t3 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 3");
-                result.push_back(indent + t2 + " = shl " + type + " " + var_op + ", 1");
-                result.push_back(indent + t3 + " = add " + type + " " + t1 + ", " + t2);
-                result.push_back(indent + dest + " = add " + type + " " + t3 + ", " + var_op);
-                break;
-            }
-            case 12: {
-                // a * 12 = (a << 3) + (a << 2)
-                std::string t1 = getTemp();
-                std::string t2 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 3");
-                result.push_back(indent + t2 + " = shl " + type + " " + var_op + ", 2");
-                result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t2);
-                break;
-            }
-            case 13: {
-                // a * 13 = (a << 4) - (a << 1) - a
-                std::string t1 = getTemp();
-                std::string t2 = getTemp();
-                std::string t3 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 4");
-                result.push_back(indent + t2 + " = shl " + type + " " + var_op + ", 1");
-                result.push_back(indent + t3 + " = sub " + type + " " + t1 + ", " + t2);
-                result.push_back(indent + dest + " = sub " + type + " " + t3 + ", " + var_op);
-                break;
-            }
-            case 14: {
-                // a * 14 = (a << 4) - (a << 1)
-                std::string t1 = getTemp();
-                std::string t2 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 4");
-                result.push_back(indent + t2 + " = shl " + type + " " + var_op + ", 1");
-                result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t2);
-                break;
-            }
-            case 15: {
-                // a * 15 = (a << 4) - a
-                std::string t1 = getTemp();
-                result.push_back(indent + t1 + " = shl " + type + " " + var_op + ", 4");
-                result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + var_op);
-                break;
-            }
-            default:
-                return result;  // Don't transform
+        std::string temps[6];
+        for (int i = 0; i < 6; i++) {
+            temps[i] = "%_mba_m" + std::to_string(base + i);
         }
+
+        expandMBAVariant(chain, indent, dest, type, var_op, var_op,
+                         temps, result);
         logger_.debug("Applied MBA MULT add-chain variant (x{}) to: {}", constant, line);
     }
     else {
@@ -15,7 +15,10 @@
  */
 
 #include "mba_or.hpp"
+#ifdef MORPHECT_MBA_REGEX_MATCH
 #include <regex>
+#endif
+#include <atomic>
 #include <sstream>
 
 namespace morphect {
@@ -28,7 +31,74 @@ bool MBAOr::applyGimple(void* gsi, void* stmt, int variant_idx,
 }
 
 // Global counter for unique temp names
-static int g_or_temp_counter = 500000;
+static std::atomic<int> g_or_temp_counter{500000};
+
+void resetOrTempCounter() { g_or_temp_counter.store(500000, std::memory_order_relaxed); }
+
+namespace {
+
+// Variant rewrite tables (placeholder language documented at
+// MBAVariantTemplate in mba_base.hpp). Order matches getVariants().
+
+// (a ^ b) + (a & b)
+constexpr const char* kOr0[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%d = add %T %1, %2",
+};
+// (a + b) - (a & b)
+constexpr const char* kOr1[] = {
+    "%1 = add %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%d = sub %T %1, %2",
+};
+// ~(~a & ~b) - De Morgan's law
+constexpr const char* kOr2[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = xor %T %b, -1",
+    "%3 = and %T %1, %2",
+    "%d = xor %T %3, -1",
+};
+// a + (b & ~a)
+constexpr const char* kOr3[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = and %T %b, %1",
+    "%d = add %T %a, %2",
+};
+// b + (a & ~b)
+constexpr const char* kOr4[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = and %T %a, %1",
+    "%d = add %T %b, %2",
+};
+// a ^ (b & ~a) - XOR with bits only in b
+constexpr const char* kOr5[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = and %T %b, %1",
+    "%d = xor %T %a, %2",
+};
+// a + ((a ^ b) & b) - a plus bits only in b, computed via XOR
+constexpr const char* kOr6[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = and %T %1, %b",
+    "%d = add %T %a, %2",
+};
+// (a ^ b) + (a & b) - same as variant 0 but using different temp names
+constexpr const char* kOr7[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%d = add %T %1, %2",
+};
+
+constexpr MBAVariantTemplate kOrVariants[] = {
+    {kOr0, 3}, {kOr1, 3}, {kOr2, 4}, {kOr3, 3},
+    {kOr4, 3}, {kOr5, 3}, {kOr6, 3}, {kOr7, 3},
+};
+
+constexpr size_t kOrVariantCount =
+    sizeof(kOrVariants) / sizeof(kOrVariants[0]);
+
+} // namespace
 
 /**
  * Apply MBA OR transformation to LLVM IR
@@ -45,7 +115,9 @@ std::vector<std::string> LLVMMBAOr::applyIR(const std::string& line,
         return result;
     }
 
-    // Robust pattern for OR - handles vector types like <4 x i32>
+    ArithMatch m;
+#ifdef MORPHECT_MBA_REGEX_MATCH
+    // Reference fallback: the original regex the hand-rolled matcher replaced
     std::regex or_pattern(
         R"(^(\s*)(%[\w.]+)\s*=\s*or\s+(<\d+\s*x\s*)?(\w+)(\s*>)?\s+(%[\w.]+),\s*(%[\w.]+|[\d-]+)\s*$)"
     );
@@ -55,94 +127,30 @@ std::vector<std::string> LLVMMBAOr::applyIR(const std::string& line,
         return result;
     }
 
-    std::string indent = match[1];
-    std::string dest = match[2];
-    std::string vec_prefix = match[3];
-    std::string base_type = match[4];
-    std::string vec_suffix = match[5];
-    std::string op1 = match[6];
-    std::string op2 = match[7];
-
-    std::string type = vec_prefix + base_type + vec_suffix;
-
-    // Skip constant OR
-    if (op1[0] != '%' && op2[0] != '%') {
+    m.indent = match[1];
+    m.dest = match[2];
+    m.type = match[3].str() + match[4].str() + match[5].str();
+    m.op1 = match[6];
+    m.op2 = match[7];
+#else
+    if (!matchArithInstruction(line, "or", /*allow_wrap_flags=*/false,
+                               /*op1_register_only=*/true, m)) {
         return result;
     }
+#endif
 
-    size_t var_idx = (variant_idx >= 0) ?
-        static_cast<size_t>(variant_idx) % 8 : selectVariant(config);
-
-    int base = g_or_temp_counter;
-    g_or_temp_counter += 10;
-    std::string t1 = "%_mba_o" + std::to_string(base);
-    std::string t2 = "%_mba_o" + std::to_string(base + 1);
-    std::string t3 = "%_mba_o" + std::to_string(base + 2);
-    std::string t4 = "%_mba_o" + std::to_string(base + 3);
-    std::string t5 = "%_mba_o" + std::to_string(base + 4);
-
-    switch (var_idx) {
-        case 0:  // (a ^ b) + (a & b)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 1:  // (a + b) - (a & b)
-        {
-            result.push_back(indent + t1 + " = add " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 2:  // ~(~a & ~b) - De Morgan's law
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t3 + " = and " + type + " " + t1 + ", " + t2);
-            result.push_back(indent + dest + " = xor " + type + " " + t3 + ", -1");
-            break;
-        }
-        case 3:  // a + (b & ~a)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + op2 + ", " + t1);
-            result.push_back(indent + dest + " = add " + type + " " + op1 + ", " + t2);
-            break;
-        }
-        case 4:  // b + (a & ~b)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + dest + " = add " + type + " " + op2 + ", " + t2);
-            break;
-        }
-        case 5:  // a ^ (b & ~a) - XOR with bits only in b
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + op2 + ", " + t1);
-            result.push_back(indent + dest + " = xor " + type + " " + op1 + ", " + t2);
-            break;
-        }
-        case 6:  // (a | b) via nested: ((a ^ b) | a) - expands nicely
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + t1 + ", " + op2);  // bits only in b
-            result.push_back(indent + dest + " = add " + type + " " + op1 + ", " + t2);
-            break;
-        }
-        case 7:  // Complex: (a ^ b) + (a & b) - same as variant 0 but using different temp names
-        default:
-        {
-            // a | b = (a ^ b) + (a & b) - verified correct identity
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);  // a ^ b
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);  // a & b
-            result.push_back(indent + dest + " = add " + type + " " + t1 + ", " + t2);  // (a^b) + (a&b)
-            break;
-        }
+    size_t var_idx = ((variant_idx >= 0) ?
+        static_cast<size_t>(variant_idx) : selectVariant(config)) % kOrVariantCount;
+
+    int base = g_or_temp_counter.fetch_add(10, std::memory_order_relaxed);
+    std::string temps[6];
+    for (int i = 0; i < 6; i++) {
+        temps[i] = "%_mba_o" + std::to_string(base + i);
     }
 
+    expandMBAVariant(kOrVariants[var_idx], m.indent, m.dest, m.type, m.op1,
+                     m.op2, temps, result);
+
     logger_.debug("Applied MBA OR variant {} to: {}", var_idx, line);
     return result;
 }
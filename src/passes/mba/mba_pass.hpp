@@ -22,6 +22,7 @@
 #include "../../core/statistics.hpp"
 #include "../../common/json_parser.hpp"
 
+#include <cctype>
 #include <memory>
 #include <unordered_map>
 
@@ -127,6 +128,11 @@ public:
 
     PassPriority getPriority() const override { return PassPriority::MBA; }
 
+    // Rewrites add/sub/mul and bitwise ops only
+    uint32_t requiredFeatures() const override {
+        return ir_features::kIntArith | ir_features::kMul | ir_features::kBitwise;
+    }
+
     bool initialize(const PassConfig& config) override {
         TransformationPass::initialize(config);
         pass_config_.global.probability = config.probability;
@@ -156,17 +162,19 @@ public:
         if (nesting_depth < 1) nesting_depth = 1;
         if (nesting_depth > 5) nesting_depth = 5;  // Cap at 5 to prevent explosion
 
-        for (int depth = 0; depth < nesting_depth; depth++) {
-            auto [new_lines, transformations] = applyTransformationPass(lines, depth);
+        if (nesting_depth == 1) {
+            auto [new_lines, transformations] = applyTransformationPass(lines, 0);
             lines = std::move(new_lines);
-            total_transformations += transformations;
-
-            // If no transformations at this depth, no point continuing
-            if (transformations == 0) {
-                break;
-            }
-
-            logger_.debug("Nesting depth {}: {} transformations", depth, transformations);
+            total_transformations = transformations;
+        } else {
+            // Nested rewrites go through the expansion cache so each
+            // unique (op, variant chain) shape is composed only once
+            auto [new_lines, transformations] =
+                applyNestedTransformations(lines, nesting_depth);
+            lines = std::move(new_lines);
+            total_transformations = transformations;
+            logger_.debug("Nested MBA: {} transformations, {} cached shapes",
+                          transformations, expansion_cache_.size());
         }
 
         // Renumber SSA values to fix sequential numbering after transformations
@@ -180,6 +188,32 @@ public:
         return total_transformations > 0 ? TransformResult::Success : TransformResult::NotApplicable;
     }
 
+    /**
+     * MBA rewrites are line-local at nesting depth 1, so the pass can
+     * join the fused single-sweep pipeline; deeper nesting needs its own
+     * repeated traversals and keeps the multi-sweep path.
+     */
+    bool isLineLocal() const override {
+        return pass_config_.global.nesting_depth <= 1;
+    }
+
+    bool transformLineIR(const std::string& line,
+                         std::vector<std::string>& replacement) override {
+        if (!pass_config_.global.enabled) {
+            return false;
+        }
+
+        auto [result, op_name] = tryTransformLine(line, pass_config_.global);
+        if (result.empty()) {
+            return false;
+        }
+
+        replacement = std::move(result);
+        incrementStat(op_name + "_applied");
+        incrementStat("total_transformations");
+        return true;
+    }
+
 private:
     /**
      * Apply one pass of MBA transformations
@@ -220,56 +254,356 @@ private:
     }
 
     /**
-     * Try to transform a single line with any applicable transformation
+     * Classify the opcode of an instruction line
+     *
+     * Every instruction we rewrite has the shape "  %dest = <opcode> ..."
+     * with the opcode as the first token after the '='. Reading that
+     * token once and dispatching to the matching transform replaces six
+     * independent regex probes per line with at most one.
+     *
+     * Returns the transforms_ key, or nullptr if the line is not an
+     * enabled arithmetic instruction.
+     */
+    const char* classifyLine(const std::string& line) const {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line[pos] != '%') {
+            return nullptr;
+        }
+        size_t eq = line.find('=', pos);
+        if (eq == std::string::npos) {
+            return nullptr;
+        }
+        size_t op_start = line.find_first_not_of(" \t", eq + 1);
+        if (op_start == std::string::npos) {
+            return nullptr;
+        }
+        size_t op_end = line.find(' ', op_start);
+        if (op_end == std::string::npos) {
+            return nullptr;
+        }
+
+        std::string_view opcode(line.data() + op_start, op_end - op_start);
+        if (opcode == "add" && pass_config_.enable_add)  return "add";
+        if (opcode == "sub" && pass_config_.enable_sub)  return "sub";
+        if (opcode == "xor" && pass_config_.enable_xor)  return "xor";
+        if (opcode == "and" && pass_config_.enable_and)  return "and";
+        if (opcode == "or"  && pass_config_.enable_or)   return "or";
+        if (opcode == "mul" && pass_config_.enable_mult) return "mul";
+        return nullptr;
+    }
+
+    /**
+     * Check whether a line is dead-code pass output
+     *
+     * The dead-code pass emits its blocks already MBA-expanded (its
+     * generators draw from the same variant tables) and every value it
+     * creates carries one of a fixed set of register prefixes. Skipping
+     * those destinations means a pipeline that runs MBA after dead-code
+     * insertion does not rescan and re-expand text that was generated
+     * one pass earlier. The check lives outside classifyLine because
+     * the nested-expansion composer relies on classifyLine accepting
+     * our own %_mba_ temporaries.
+     */
+    static bool isDeadCodeOutput(const std::string& line) {
+        static constexpr std::string_view kDeadPrefixes[] = {
+            "%_dead", "%_arith", "%_mba_", "%_opq_", "%_pool"
+        };
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos || line[pos] != '%') {
+            return false;
+        }
+        for (std::string_view prefix : kDeadPrefixes) {
+            if (line.compare(pos, prefix.size(),
+                             prefix.data(), prefix.size()) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Try to transform a single line with the applicable transformation
      * Returns the result lines and the operation name that was applied
      */
     std::pair<std::vector<std::string>, std::string> tryTransformLine(
             const std::string& line, const MBAConfig& config) {
 
-        // Try each transformation in order
-        if (pass_config_.enable_add) {
-            auto result = transforms_["add"]->applyIR(line, -1, config);
-            if (!result.empty()) {
-                return {result, "add"};
-            }
+        if (isDeadCodeOutput(line)) {
+            return {{}, ""};
+        }
+        const char* op = classifyLine(line);
+        if (op == nullptr) {
+            return {{}, ""};
         }
 
-        if (pass_config_.enable_sub) {
-            auto result = transforms_["sub"]->applyIR(line, -1, config);
-            if (!result.empty()) {
-                return {result, "sub"};
-            }
+        auto result = transforms_[op]->applyIR(line, -1, config);
+        if (result.empty()) {
+            return {{}, ""};
         }
+        return {result, op};
+    }
 
-        if (pass_config_.enable_xor) {
-            auto result = transforms_["xor"]->applyIR(line, -1, config);
-            if (!result.empty()) {
-                return {result, "xor"};
+    // ---- nested-MBA expansion cache ----------------------------------
+    //
+    // At nesting depth > 1 the naive approach re-scans the whole
+    // function once per level and re-derives every nested rewrite per
+    // instruction. Instead each instruction samples a variant chain
+    // (one variant per level, with the same per-level probability
+    // falloff as the old depth loop) and the fully composed expansion
+    // for that (op, chain) shape is built once: the transforms are run
+    // on a canonical seed line with placeholder operands (%__a, %__b,
+    // %__d, type i98765) and the generated temps are rewritten to
+    // %__t<N>. Instructions hitting a memoized shape only pay one
+    // placeholder-substitution scan per emitted line.
+
+    static constexpr const char* kCanonDest = "%__d";
+    static constexpr const char* kCanonOp1  = "%__a";
+    static constexpr const char* kCanonOp2  = "%__b";
+    static constexpr const char* kCanonType = "i98765";
+
+    struct CachedExpansion {
+        std::vector<std::string> lines;  // canonical placeholder form
+        int temp_count = 0;
+    };
+
+    /**
+     * Operand parse for the cached nesting path
+     *
+     * Thin wrapper over the shared hand-rolled matcher, with the same
+     * per-opcode operand classes the transforms' own matchers enforce.
+     */
+    bool parseArithOperands(const std::string& line, const char* op,
+                            ArithMatch& out) const {
+        std::string_view opcode(op);
+        bool wrap_flags = (opcode == "add" || opcode == "sub");
+        bool reg_first = (opcode == "xor" || opcode == "and" || opcode == "or");
+        if (!matchArithInstruction(line, opcode, wrap_flags, reg_first, out)) {
+            return false;
+        }
+        // constant-constant folds anyway; skip like the transforms do
+        return out.op1[0] == '%' || out.op2[0] == '%';
+    }
+
+    /**
+     * Per-operation operand rules mirrored from the transforms
+     */
+    bool operandRulesAllow(const char* op, const ArithMatch& parsed) const {
+        std::string_view opcode(op);
+        if (opcode == "sub" && parsed.op1 == "0") {
+            return false;  // negation, don't transform further
+        }
+        if (opcode == "xor" && parsed.op2 == "-1") {
+            return false;  // NOT operation, generated by our own rewrites
+        }
+        return true;
+    }
+
+    /**
+     * Compose the full nested expansion for one variant chain
+     */
+    std::vector<std::string> composeExpansion(const char* op,
+                                              const std::vector<int>& chain) {
+        // The shape is fully decided by the chain, so compose at
+        // probability 1 - per-instruction gating happened at the caller
+        MBAConfig compose_config = pass_config_.global;
+        compose_config.enabled = true;
+        compose_config.probability = 1.0;
+
+        std::string seed = std::string(kCanonDest) + " = " + op + " " +
+                           kCanonType + " " + kCanonOp1 + ", " + kCanonOp2;
+        std::vector<std::string> lines =
+            transforms_[op]->applyIR(seed, chain[0], compose_config);
+
+        for (size_t level = 1; level < chain.size() && !lines.empty(); level++) {
+            std::vector<std::string> next;
+            next.reserve(lines.size() * 4);
+            for (auto& l : lines) {
+                const char* inner = classifyLine(l);
+                std::vector<std::string> expanded;
+                if (inner != nullptr && std::string_view(inner) != "mul") {
+                    expanded = transforms_[inner]->applyIR(l, chain[level],
+                                                           compose_config);
+                }
+                if (expanded.empty()) {
+                    next.push_back(std::move(l));
+                } else {
+                    for (auto& e : expanded) {
+                        next.push_back(std::move(e));
+                    }
+                }
             }
+            lines = std::move(next);
         }
+        return lines;
+    }
 
-        if (pass_config_.enable_and) {
-            auto result = transforms_["and"]->applyIR(line, -1, config);
-            if (!result.empty()) {
-                return {result, "and"};
+    /**
+     * Rewrite the generated temp names in a composed expansion to
+     * canonical %__t<N> placeholders; returns the number of temps
+     */
+    int canonicalizeTemps(std::vector<std::string>& lines) const {
+        std::unordered_map<std::string, std::string> mapping;
+        for (auto& line : lines) {
+            std::string rewritten;
+            rewritten.reserve(line.size());
+            size_t i = 0;
+            while (i < line.size()) {
+                if (line[i] == '%' && line.compare(i, 6, "%_mba_") == 0) {
+                    size_t end = i + 6;
+                    while (end < line.size() &&
+                           (isalnum((unsigned char)line[end]) || line[end] == '_')) {
+                        end++;
+                    }
+                    std::string name = line.substr(i, end - i);
+                    std::string placeholder = "%__t" + std::to_string(mapping.size());
+                    auto it = mapping.emplace(std::move(name),
+                                              std::move(placeholder)).first;
+                    rewritten += it->second;
+                    i = end;
+                } else {
+                    rewritten += line[i++];
+                }
             }
+            line = std::move(rewritten);
+        }
+        return static_cast<int>(mapping.size());
+    }
+
+    /**
+     * Look up (or build and memoize) the expansion for one shape
+     */
+    const CachedExpansion& getExpansion(const char* op,
+                                        const std::vector<int>& chain) {
+        std::string key = op;
+        for (int v : chain) {
+            key += ':';
+            key += std::to_string(v);
         }
 
-        if (pass_config_.enable_or) {
-            auto result = transforms_["or"]->applyIR(line, -1, config);
-            if (!result.empty()) {
-                return {result, "or"};
+        auto it = expansion_cache_.find(key);
+        if (it != expansion_cache_.end()) {
+            return it->second;
+        }
+
+        CachedExpansion entry;
+        entry.lines = composeExpansion(op, chain);
+        entry.temp_count = canonicalizeTemps(entry.lines);
+        return expansion_cache_.emplace(std::move(key),
+                                        std::move(entry)).first->second;
+    }
+
+    /**
+     * Instantiate a cached expansion with the real operands
+     */
+    void substituteExpansion(const CachedExpansion& expansion,
+                             const ArithMatch& parsed,
+                             std::vector<std::string>& out) {
+        // Fresh temp names for this instantiation
+        int base = nested_temp_counter_;
+        nested_temp_counter_ += expansion.temp_count;
+
+        out.reserve(out.size() + expansion.lines.size());
+        for (const auto& tmpl : expansion.lines) {
+            StringBuilder sb(parsed.indent.size() + tmpl.size() + 32);
+            sb.append(parsed.indent);
+            size_t i = 0;
+            while (i < tmpl.size()) {
+                char c = tmpl[i];
+                if (c == '%' && i + 3 < tmpl.size() &&
+                    tmpl.compare(i, 3, "%__") == 0) {
+                    char tag = tmpl[i + 3];
+                    if (tag == 'd') { sb.append(parsed.dest); i += 4; continue; }
+                    if (tag == 'a') { sb.append(parsed.op1);  i += 4; continue; }
+                    if (tag == 'b') { sb.append(parsed.op2);  i += 4; continue; }
+                    if (tag == 't') {
+                        size_t end = i + 4;
+                        int idx = 0;
+                        while (end < tmpl.size() &&
+                               isdigit((unsigned char)tmpl[end])) {
+                            idx = idx * 10 + (tmpl[end] - '0');
+                            end++;
+                        }
+                        sb.append("%_mba_c").append(base + idx);
+                        i = end;
+                        continue;
+                    }
+                }
+                if (c == 'i' && tmpl.compare(i, 6, kCanonType) == 0) {
+                    sb.append(parsed.type);
+                    i += 6;
+                    continue;
+                }
+                sb.append(c);
+                i++;
             }
+            out.push_back(sb.take());
         }
+    }
 
-        if (pass_config_.enable_mult) {
-            auto result = transforms_["mul"]->applyIR(line, -1, config);
-            if (!result.empty()) {
-                return {result, "mul"};
+    /**
+     * Nested transformation sweep backed by the expansion cache
+     */
+    std::pair<std::vector<std::string>, int> applyNestedTransformations(
+            const std::vector<std::string>& lines, int nesting_depth) {
+        std::vector<std::string> new_lines;
+        new_lines.reserve(lines.size() * 2);
+        int transformations = 0;
+        const MBAConfig& config = pass_config_.global;
+
+        for (const auto& line : lines) {
+            const char* op = isDeadCodeOutput(line) ? nullptr : classifyLine(line);
+            if (op == nullptr) {
+                new_lines.push_back(line);
+                continue;
+            }
+
+            // mul rewrites depend on the constant operand, so they
+            // cannot be shape-cached; apply them directly
+            if (std::string_view(op) == "mul") {
+                auto result = transforms_[op]->applyIR(line, -1, config);
+                if (result.empty()) {
+                    new_lines.push_back(line);
+                } else {
+                    for (auto& r : result) {
+                        new_lines.push_back(std::move(r));
+                    }
+                    transformations++;
+                    incrementStat("mul_applied");
+                }
+                continue;
             }
+
+            if (!GlobalRandom::decide(config.probability)) {
+                new_lines.push_back(line);
+                continue;
+            }
+
+            ArithMatch parsed;
+            if (!parseArithOperands(line, op, parsed) ||
+                !operandRulesAllow(op, parsed)) {
+                new_lines.push_back(line);
+                continue;
+            }
+
+            // Sample the variant chain; deeper levels keep the old
+            // per-level probability falloff (80%/60%/40%/20% of base)
+            std::vector<int> chain;
+            chain.push_back(static_cast<int>(transforms_[op]->selectVariant(config)));
+            for (int d = 1; d < nesting_depth; d++) {
+                double reduction = 1.0 - (d * 0.2);
+                if (reduction < 0.2) reduction = 0.2;
+                if (!GlobalRandom::decide(config.probability * reduction)) {
+                    break;
+                }
+                chain.push_back(GlobalRandom::nextInt(0, 9));
+            }
+
+            substituteExpansion(getExpansion(op, chain), parsed, new_lines);
+            transformations++;
+            incrementStat(std::string(op) + "_applied");
         }
 
-        return {{}, ""};
+        return {new_lines, transformations};
     }
 
 public:
@@ -307,6 +641,10 @@ private:
     mutable Logger logger_;
     MBAPassConfig pass_config_;
     std::unordered_map<std::string, std::unique_ptr<LLVMMBATransformation>> transforms_;
+
+    // Memoized nested expansions, keyed "op:v0:v1:..."
+    std::unordered_map<std::string, CachedExpansion> expansion_cache_;
+    int nested_temp_counter_ = 700000;
 };
 
 } // namespace mba
@@ -12,7 +12,10 @@
  */
 
 #include "mba_sub.hpp"
+#ifdef MORPHECT_MBA_REGEX_MATCH
 #include <regex>
+#endif
+#include <atomic>
 #include <sstream>
 
 namespace morphect {
@@ -25,7 +28,85 @@ bool MBASub::applyGimple(void* gsi, void* stmt, int variant_idx,
 }
 
 // Global temp counter
-static int g_sub_temp_counter = 200000;
+static std::atomic<int> g_sub_temp_counter{200000};
+
+void resetSubTempCounter() { g_sub_temp_counter.store(200000, std::memory_order_relaxed); }
+
+namespace {
+
+// Variant rewrite tables (placeholder language documented at
+// MBAVariantTemplate in mba_base.hpp). Order matches getVariants().
+
+// a + (~b + 1) - two's complement
+constexpr const char* kSub0[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = add %T %1, 1",
+    "%d = add %T %a, %2",
+};
+// ~(~a + b) - complement identity
+constexpr const char* kSub1[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = add %T %1, %b",
+    "%d = xor %T %2, -1",
+};
+// (a ^ b) - 2 * (~a & b)
+constexpr const char* kSub2[] = {
+    "%1 = xor %T %a, %b",
+    "%2 = xor %T %a, -1",
+    "%3 = and %T %2, %b",
+    "%4 = shl %T %3, 1",
+    "%d = sub %T %1, %4",
+};
+// (a & ~b) - (~a & b)
+constexpr const char* kSub3[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = and %T %a, %1",
+    "%3 = xor %T %a, -1",
+    "%4 = and %T %3, %b",
+    "%d = sub %T %2, %4",
+};
+// (a | ~b) + ~(a | b) + 1 - complex
+constexpr const char* kSub4[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = or %T %a, %1",
+    "%3 = or %T %a, %b",
+    "%4 = xor %T %3, -1",
+    "%5 = add %T %2, %4",
+    "%d = add %T %5, 1",
+};
+// (a ^ ~b) + 2*(a & ~b) + 1
+constexpr const char* kSub5[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = xor %T %a, %1",
+    "%3 = and %T %a, %1",
+    "%4 = shl %T %3, 1",
+    "%5 = add %T %2, %4",
+    "%d = add %T %5, 1",
+};
+// a + (b ^ -1) + 1 - simple two's comp variant
+constexpr const char* kSub6[] = {
+    "%1 = xor %T %b, -1",
+    "%2 = add %T %a, %1",
+    "%d = add %T %2, 1",
+};
+// ~(~a + b) via nested ops
+constexpr const char* kSub7[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = xor %T %b, -1",
+    "%3 = xor %T %2, -1",
+    "%4 = add %T %1, %3",
+    "%d = xor %T %4, -1",
+};
+
+constexpr MBAVariantTemplate kSubVariants[] = {
+    {kSub0, 3}, {kSub1, 3}, {kSub2, 5}, {kSub3, 5},
+    {kSub4, 6}, {kSub5, 6}, {kSub6, 3}, {kSub7, 5},
+};
+
+constexpr size_t kSubVariantCount =
+    sizeof(kSubVariants) / sizeof(kSubVariants[0]);
+
+} // namespace
 
 /**
  * Apply MBA SUB transformation to LLVM IR
@@ -39,7 +120,9 @@ std::vector<std::string> LLVMMBASub::applyIR(const std::string& line,
         return result;
     }
 
-    // Robust pattern matching
+    ArithMatch m;
+#ifdef MORPHECT_MBA_REGEX_MATCH
+    // Reference fallback: the original regex the hand-rolled matcher replaced
     std::regex sub_pattern(
         R"(^(\s*)(%[\w.]+)\s*=\s*sub\s+(nsw\s+|nuw\s+|nuw nsw\s+|nsw nuw\s+)?(<\d+\s*x\s*)?(\w+)(\s*>)?\s+(%[\w.]+|[\d-]+),\s*(%[\w.]+|[\d-]+)\s*$)"
     );
@@ -49,110 +132,40 @@ std::vector<std::string> LLVMMBASub::applyIR(const std::string& line,
         return result;
     }
 
-    std::string indent = match[1];
-    std::string dest = match[2];
-    std::string vec_prefix = match[4];
-    std::string base_type = match[5];
-    std::string vec_suffix = match[6];
-    std::string op1 = match[7];
-    std::string op2 = match[8];
-
-    std::string type = vec_prefix + base_type + vec_suffix;
+    m.indent = match[1];
+    m.dest = match[2];
+    m.type = match[4].str() + match[5].str() + match[6].str();
+    m.op1 = match[7];
+    m.op2 = match[8];
+#else
+    if (!matchArithInstruction(line, "sub", /*allow_wrap_flags=*/true,
+                               /*op1_register_only=*/false, m)) {
+        return result;
+    }
+#endif
 
     // Skip constant-constant
-    if (op1[0] != '%' && op2[0] != '%') {
+    if (m.op1[0] != '%' && m.op2[0] != '%') {
         return result;
     }
 
     // Skip "sub type 0, X" (negation) - don't transform further
-    if (op1 == "0") {
+    if (m.op1 == "0") {
         return result;
     }
 
-    size_t var_idx = (variant_idx >= 0) ?
-        static_cast<size_t>(variant_idx) % 8 : selectVariant(config);
-
-    int base = g_sub_temp_counter;
-    g_sub_temp_counter += 10;
-    std::string t1 = "%_mba_s" + std::to_string(base);
-    std::string t2 = "%_mba_s" + std::to_string(base + 1);
-    std::string t3 = "%_mba_s" + std::to_string(base + 2);
-    std::string t4 = "%_mba_s" + std::to_string(base + 3);
-    std::string t5 = "%_mba_s" + std::to_string(base + 4);
-    std::string t6 = "%_mba_s" + std::to_string(base + 5);
-
-    switch (var_idx) {
-        case 0:  // a + (~b + 1) - two's complement
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = add " + type + " " + t1 + ", 1");
-            result.push_back(indent + dest + " = add " + type + " " + op1 + ", " + t2);
-            break;
-        }
-        case 1:  // ~(~a + b) - complement identity
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = add " + type + " " + t1 + ", " + op2);
-            result.push_back(indent + dest + " = xor " + type + " " + t2 + ", -1");
-            break;
-        }
-        case 2:  // (a ^ b) - 2 * (~a & b)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t3 + " = and " + type + " " + t2 + ", " + op2);
-            result.push_back(indent + t4 + " = shl " + type + " " + t3 + ", 1");
-            result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t4);
-            break;
-        }
-        case 3:  // (a & ~b) - (~a & b)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + t3 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t4 + " = and " + type + " " + t3 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t2 + ", " + t4);
-            break;
-        }
-        case 4:  // (a | ~b) + ~(a | b) + 1 - complex
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = or " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + t3 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t4 + " = xor " + type + " " + t3 + ", -1");
-            result.push_back(indent + t5 + " = add " + type + " " + t2 + ", " + t4);
-            result.push_back(indent + dest + " = add " + type + " " + t5 + ", 1");
-            break;
-        }
-        case 5:  // (a ^ ~b) + 2*(a & ~b) + 1
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = xor " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + t3 + " = and " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + t4 + " = shl " + type + " " + t3 + ", 1");
-            result.push_back(indent + t5 + " = add " + type + " " + t2 + ", " + t4);
-            result.push_back(indent + dest + " = add " + type + " " + t5 + ", 1");
-            break;
-        }
-        case 6:  // a + (b ^ -1) + 1 - simple two's comp variant
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t2 + " = add " + type + " " + op1 + ", " + t1);
-            result.push_back(indent + dest + " = add " + type + " " + t2 + ", 1");
-            break;
-        }
-        case 7:  // ~(~a + b) via nested ops
-        default:
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t3 + " = xor " + type + " " + t2 + ", -1");  // b again
-            result.push_back(indent + t4 + " = add " + type + " " + t1 + ", " + t3);
-            result.push_back(indent + dest + " = xor " + type + " " + t4 + ", -1");
-            break;
-        }
+    size_t var_idx = ((variant_idx >= 0) ?
+        static_cast<size_t>(variant_idx) : selectVariant(config)) % kSubVariantCount;
+
+    int base = g_sub_temp_counter.fetch_add(10, std::memory_order_relaxed);
+    std::string temps[6];
+    for (int i = 0; i < 6; i++) {
+        temps[i] = "%_mba_s" + std::to_string(base + i);
     }
 
+    expandMBAVariant(kSubVariants[var_idx], m.indent, m.dest, m.type, m.op1,
+                     m.op2, temps, result);
+
     logger_.debug("Applied MBA SUB variant {} to: {}", var_idx, line);
     return result;
 }
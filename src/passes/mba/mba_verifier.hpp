@@ -0,0 +1,315 @@
+/**
+ * Morphect - Multi-Language Code Obfuscator
+ *
+ * mba_verifier.hpp - batch verification of MBA identities
+ *
+ * Expands every variant of every LLVM MBA transformation on a canonical
+ * seed line, compiles the emitted IR into a tiny register program, and
+ * evaluates it against the base operation over large blocks of
+ * pseudo-random operand pairs. The inner loops are plain element-wise
+ * array sweeps so the compiler can vectorize them; a full audit over
+ * millions of pairs per variant finishes in seconds.
+ *
+ * Exposed through `morphect-ir --verify-mba`.
+ */
+
+#ifndef MORPHECT_MBA_VERIFIER_HPP
+#define MORPHECT_MBA_VERIFIER_HPP
+
+#include "mba_add.hpp"
+#include "mba_sub.hpp"
+#include "mba_xor.hpp"
+#include "mba_and.hpp"
+#include "mba_or.hpp"
+#include "mba_mult.hpp"
+
+#include "../../common/random.hpp"
+#include "../../common/logging.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace morphect {
+namespace mba {
+
+class MBAVerifier {
+public:
+    struct VariantResult {
+        std::string operation;     // "add", "sub", ...
+        std::string variant_name;  // from getVariants(), or "xN" for mult
+        int variant_idx = 0;
+        uint64_t samples = 0;
+        uint64_t mismatches = 0;
+
+        bool passed() const { return mismatches == 0; }
+    };
+
+    explicit MBAVerifier(uint64_t samples_per_variant = kDefaultSamples)
+        : samples_(samples_per_variant), logger_("MBA_Verifier") {
+        transforms_["add"] = std::make_unique<LLVMMBAAdd>();
+        transforms_["sub"] = std::make_unique<LLVMMBASub>();
+        transforms_["xor"] = std::make_unique<LLVMMBAXor>();
+        transforms_["and"] = std::make_unique<LLVMMBAAnd>();
+        transforms_["or"]  = std::make_unique<LLVMMBAOr>();
+    }
+
+    /**
+     * Audit every variant of every operation
+     *
+     * Binary operations are checked over uniformly random 64-bit pairs;
+     * constant multiplications over the multiplier values each rewrite
+     * path handles.
+     */
+    std::vector<VariantResult> verifyAll() {
+        std::vector<VariantResult> results;
+
+        for (const char* op : {"add", "sub", "xor", "and", "or"}) {
+            auto& transform = transforms_[op];
+            auto variants = transform->getVariants();
+            for (size_t idx = 0; idx < variants.size(); idx++) {
+                results.push_back(verifyBinary(op, static_cast<int>(idx),
+                                               variants[idx].name));
+            }
+        }
+
+        // Multiplier values covering the shift, shift±add, addition-chain
+        // and bit-decomposition rewrite paths
+        LLVMMBAMult mult;
+        for (int64_t k : {2, 3, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                          16, 20, 100, 1034}) {
+            results.push_back(verifyMult(mult, k));
+        }
+
+        return results;
+    }
+
+    uint64_t samplesPerVariant() const { return samples_; }
+
+private:
+    static constexpr uint64_t kDefaultSamples = 1ull << 21;  // ~2M pairs
+    static constexpr size_t kBlock = 4096;
+
+    enum class Op { Add, Sub, Xor, And, Or, Shl, Lshr, Mul };
+
+    /**
+     * One compiled instruction; operands are register slots or an
+     * immediate when the slot index is negative
+     */
+    struct Instr {
+        Op op;
+        int dst;
+        int src1;
+        int src2;
+        uint64_t imm1 = 0;
+        uint64_t imm2 = 0;
+    };
+
+    VariantResult verifyBinary(const std::string& op, int variant_idx,
+                               const std::string& name) {
+        VariantResult result;
+        result.operation = op;
+        result.variant_name = name;
+        result.variant_idx = variant_idx;
+
+        std::string seed = "%__d = " + op + " i64 %__a, %__b";
+        auto lines = expand(*transforms_[op], seed, variant_idx);
+        runProgram(lines, opFromName(op), 0, result);
+        return result;
+    }
+
+    VariantResult verifyMult(LLVMMBAMult& mult, int64_t multiplier) {
+        VariantResult result;
+        result.operation = "mul";
+        result.variant_name = "x" + std::to_string(multiplier);
+        result.variant_idx = static_cast<int>(multiplier);
+
+        std::string seed = "%__d = mul i64 %__a, " + std::to_string(multiplier);
+        auto lines = expand(mult, seed, -1);
+        runProgram(lines, Op::Mul, static_cast<uint64_t>(multiplier), result);
+        return result;
+    }
+
+    std::vector<std::string> expand(LLVMMBATransformation& transform,
+                                    const std::string& seed, int variant_idx) {
+        MBAConfig config;
+        config.enabled = true;
+        config.probability = 1.0;
+        return transform.applyIR(seed, variant_idx, config);
+    }
+
+    static Op opFromName(const std::string& name) {
+        if (name == "add") return Op::Add;
+        if (name == "sub") return Op::Sub;
+        if (name == "xor") return Op::Xor;
+        if (name == "and") return Op::And;
+        if (name == "or")  return Op::Or;
+        return Op::Mul;
+    }
+
+    /**
+     * Compile the emitted IR lines and evaluate them in blocks
+     *
+     * Slot 0/1 hold the operands; the line writing %__d determines the
+     * destination slot. `base_imm` is the multiplier for Op::Mul checks
+     * (the second operand is then the constant, not slot 1).
+     */
+    void runProgram(const std::vector<std::string>& lines, Op base_op,
+                    uint64_t base_imm, VariantResult& result) {
+        if (lines.empty()) {
+            // Expansion refused the seed line - treat as a failed audit
+            result.samples = 0;
+            result.mismatches = 1;
+            return;
+        }
+
+        std::vector<Instr> program;
+        std::unordered_map<std::string, int> slots = {{"%__a", 0}, {"%__b", 1}};
+        int dest_slot = -1;
+
+        for (const auto& line : lines) {
+            Instr instr;
+            std::string dst_name;
+            if (!parseLine(line, instr, dst_name, slots)) {
+                result.mismatches = 1;  // unparseable output is a failure
+                return;
+            }
+            if (dst_name == "%__d") {
+                dest_slot = instr.dst;
+            }
+            program.push_back(instr);
+        }
+        if (dest_slot < 0) {
+            result.mismatches = 1;  // nothing wrote the destination
+            return;
+        }
+
+        std::vector<std::vector<uint64_t>> regs(
+            slots.size(), std::vector<uint64_t>(kBlock));
+
+        // Fixed seed so audits are reproducible run to run
+        LocalRandom rng(0x6d626176657269ull);
+
+        uint64_t remaining = samples_;
+        while (remaining > 0) {
+            size_t n = remaining < kBlock ? static_cast<size_t>(remaining) : kBlock;
+            rng.fillBytes(reinterpret_cast<uint8_t*>(regs[0].data()),
+                          n * sizeof(uint64_t));
+            rng.fillBytes(reinterpret_cast<uint8_t*>(regs[1].data()),
+                          n * sizeof(uint64_t));
+
+            for (const auto& instr : program) {
+                evalBlock(instr, regs, n);
+            }
+
+            const uint64_t* a = regs[0].data();
+            const uint64_t* b = regs[1].data();
+            const uint64_t* d = regs[static_cast<size_t>(dest_slot)].data();
+            uint64_t mismatches = 0;
+            for (size_t i = 0; i < n; i++) {
+                uint64_t expected = applyBase(base_op, a[i],
+                                              base_op == Op::Mul ? base_imm : b[i]);
+                mismatches += (d[i] != expected) ? 1 : 0;
+            }
+
+            result.mismatches += mismatches;
+            result.samples += n;
+            remaining -= n;
+        }
+    }
+
+    bool parseLine(const std::string& line, Instr& instr, std::string& dst_name,
+                   std::unordered_map<std::string, int>& slots) const {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == std::string::npos) return false;
+        size_t eq = line.find(" = ", pos);
+        if (eq == std::string::npos) return false;
+        dst_name = line.substr(pos, eq - pos);
+
+        size_t op_start = eq + 3;
+        size_t op_end = line.find(' ', op_start);
+        if (op_end == std::string::npos) return false;
+        std::string opcode = line.substr(op_start, op_end - op_start);
+        if (opcode == "add")       instr.op = Op::Add;
+        else if (opcode == "sub")  instr.op = Op::Sub;
+        else if (opcode == "xor")  instr.op = Op::Xor;
+        else if (opcode == "and")  instr.op = Op::And;
+        else if (opcode == "or")   instr.op = Op::Or;
+        else if (opcode == "shl")  instr.op = Op::Shl;
+        else if (opcode == "lshr") instr.op = Op::Lshr;
+        else if (opcode == "mul")  instr.op = Op::Mul;
+        else return false;
+
+        size_t type_end = line.find(' ', op_end + 1);  // skip the type token
+        if (type_end == std::string::npos) return false;
+        size_t comma = line.find(',', type_end);
+        if (comma == std::string::npos) return false;
+        std::string op1 = line.substr(type_end + 1, comma - type_end - 1);
+        size_t op2_start = line.find_first_not_of(' ', comma + 1);
+        if (op2_start == std::string::npos) return false;
+        std::string op2 = line.substr(op2_start);
+
+        auto resolve = [&slots](const std::string& name, int& slot,
+                                uint64_t& imm) {
+            if (!name.empty() && name[0] == '%') {
+                auto it = slots.find(name);
+                if (it == slots.end()) {
+                    it = slots.emplace(name,
+                                       static_cast<int>(slots.size())).first;
+                }
+                slot = it->second;
+            } else {
+                slot = -1;
+                imm = static_cast<uint64_t>(std::stoll(name));
+            }
+        };
+        resolve(op1, instr.src1, instr.imm1);
+        resolve(op2, instr.src2, instr.imm2);
+
+        int dst_slot;
+        uint64_t unused = 0;
+        resolve(dst_name, dst_slot, unused);
+        instr.dst = dst_slot;
+        return dst_slot >= 0;
+    }
+
+    static void evalBlock(const Instr& instr,
+                          std::vector<std::vector<uint64_t>>& regs, size_t n) {
+        std::vector<uint64_t>& out = regs[static_cast<size_t>(instr.dst)];
+        const uint64_t* x = instr.src1 >= 0
+            ? regs[static_cast<size_t>(instr.src1)].data() : nullptr;
+        const uint64_t* y = instr.src2 >= 0
+            ? regs[static_cast<size_t>(instr.src2)].data() : nullptr;
+
+        for (size_t i = 0; i < n; i++) {
+            uint64_t a = x ? x[i] : instr.imm1;
+            uint64_t b = y ? y[i] : instr.imm2;
+            out[i] = applyBase(instr.op, a, b);
+        }
+    }
+
+    static uint64_t applyBase(Op op, uint64_t a, uint64_t b) {
+        switch (op) {
+            case Op::Add:  return a + b;
+            case Op::Sub:  return a - b;
+            case Op::Xor:  return a ^ b;
+            case Op::And:  return a & b;
+            case Op::Or:   return a | b;
+            case Op::Shl:  return a << (b & 63);
+            case Op::Lshr: return a >> (b & 63);
+            case Op::Mul:  return a * b;
+        }
+        return 0;
+    }
+
+    uint64_t samples_;
+    Logger logger_;
+    std::unordered_map<std::string, std::unique_ptr<LLVMMBATransformation>> transforms_;
+};
+
+} // namespace mba
+} // namespace morphect
+
+#endif // MORPHECT_MBA_VERIFIER_HPP
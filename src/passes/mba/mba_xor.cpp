@@ -12,7 +12,10 @@
  */
 
 #include "mba_xor.hpp"
+#ifdef MORPHECT_MBA_REGEX_MATCH
 #include <regex>
+#endif
+#include <atomic>
 #include <sstream>
 
 namespace morphect {
@@ -24,7 +27,83 @@ bool MBAXor::applyGimple(void* gsi, void* stmt, int variant_idx,
     return false;
 }
 
-static int g_xor_temp_counter = 300000;
+static std::atomic<int> g_xor_temp_counter{300000};
+
+void resetXorTempCounter() { g_xor_temp_counter.store(300000, std::memory_order_relaxed); }
+
+namespace {
+
+// Variant rewrite tables (placeholder language documented at
+// MBAVariantTemplate in mba_base.hpp). Order matches getVariants().
+
+// (a | b) - (a & b)
+constexpr const char* kXor0[] = {
+    "%1 = or %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%d = sub %T %1, %2",
+};
+// (a + b) - 2 * (a & b)
+constexpr const char* kXor1[] = {
+    "%1 = add %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%3 = shl %T %2, 1",
+    "%d = sub %T %1, %3",
+};
+// (a | b) & ~(a & b)
+constexpr const char* kXor2[] = {
+    "%1 = or %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%3 = xor %T %2, -1",
+    "%d = and %T %1, %3",
+};
+// (~a & b) | (a & ~b)
+constexpr const char* kXor3[] = {
+    "%1 = xor %T %a, -1",
+    "%2 = and %T %1, %b",
+    "%3 = xor %T %b, -1",
+    "%4 = and %T %a, %3",
+    "%d = or %T %2, %4",
+};
+// (a | b) & (~a | ~b)
+constexpr const char* kXor4[] = {
+    "%1 = or %T %a, %b",
+    "%2 = xor %T %a, -1",
+    "%3 = xor %T %b, -1",
+    "%4 = or %T %2, %3",
+    "%d = and %T %1, %4",
+};
+// (a | b) ^ (a & b) - the inner XOR expanded as or/and/sub to avoid
+// infinite recursion
+constexpr const char* kXor5[] = {
+    "%1 = or %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%3 = or %T %1, %2",
+    "%4 = and %T %1, %2",
+    "%d = sub %T %3, %4",
+};
+// (a | b) - (a & b) - same as variant 0 for variety
+constexpr const char* kXor6[] = {
+    "%1 = or %T %a, %b",
+    "%2 = and %T %a, %b",
+    "%d = sub %T %1, %2",
+};
+// Complex: (2*(a|b) - (a+b)) - uses relationship between ops
+constexpr const char* kXor7[] = {
+    "%1 = or %T %a, %b",
+    "%2 = shl %T %1, 1",
+    "%3 = add %T %a, %b",
+    "%d = sub %T %2, %3",
+};
+
+constexpr MBAVariantTemplate kXorVariants[] = {
+    {kXor0, 3}, {kXor1, 4}, {kXor2, 4}, {kXor3, 5},
+    {kXor4, 5}, {kXor5, 5}, {kXor6, 3}, {kXor7, 4},
+};
+
+constexpr size_t kXorVariantCount =
+    sizeof(kXorVariants) / sizeof(kXorVariants[0]);
+
+} // namespace
 
 std::vector<std::string> LLVMMBAXor::applyIR(const std::string& line,
                                               int variant_idx,
@@ -35,7 +114,9 @@ std::vector<std::string> LLVMMBAXor::applyIR(const std::string& line,
         return result;
     }
 
-    // Robust pattern for XOR
+    ArithMatch m;
+#ifdef MORPHECT_MBA_REGEX_MATCH
+    // Reference fallback: the original regex the hand-rolled matcher replaced
     std::regex xor_pattern(
         R"(^(\s*)(%[\w.]+)\s*=\s*xor\s+(<\d+\s*x\s*)?(\w+)(\s*>)?\s+(%[\w.]+),\s*(%[\w.]+|[\d-]+)\s*$)"
     );
@@ -45,108 +126,35 @@ std::vector<std::string> LLVMMBAXor::applyIR(const std::string& line,
         return result;
     }
 
-    std::string indent = match[1];
-    std::string dest = match[2];
-    std::string vec_prefix = match[3];
-    std::string base_type = match[4];
-    std::string vec_suffix = match[5];
-    std::string op1 = match[6];
-    std::string op2 = match[7];
-
-    std::string type = vec_prefix + base_type + vec_suffix;
-
-    // Skip XOR with -1 (NOT operation) - these are generated by our transforms
-    if (op2 == "-1") {
+    m.indent = match[1];
+    m.dest = match[2];
+    m.type = match[3].str() + match[4].str() + match[5].str();
+    m.op1 = match[6];
+    m.op2 = match[7];
+#else
+    if (!matchArithInstruction(line, "xor", /*allow_wrap_flags=*/false,
+                               /*op1_register_only=*/true, m)) {
         return result;
     }
+#endif
 
-    // Skip constant XOR
-    if (op1[0] != '%' && op2[0] != '%') {
+    // Skip XOR with -1 (NOT operation) - these are generated by our transforms
+    if (m.op2 == "-1") {
         return result;
     }
 
-    size_t var_idx = (variant_idx >= 0) ?
-        static_cast<size_t>(variant_idx) % 8 : selectVariant(config);
-
-    int base = g_xor_temp_counter;
-    g_xor_temp_counter += 10;
-    std::string t1 = "%_mba_x" + std::to_string(base);
-    std::string t2 = "%_mba_x" + std::to_string(base + 1);
-    std::string t3 = "%_mba_x" + std::to_string(base + 2);
-    std::string t4 = "%_mba_x" + std::to_string(base + 3);
-    std::string t5 = "%_mba_x" + std::to_string(base + 4);
-
-    switch (var_idx) {
-        case 0:  // (a | b) - (a & b)
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 1:  // (a + b) - 2 * (a & b)
-        {
-            result.push_back(indent + t1 + " = add " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t3 + " = shl " + type + " " + t2 + ", 1");
-            result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t3);
-            break;
-        }
-        case 2:  // (a | b) & ~(a & b)
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t3 + " = xor " + type + " " + t2 + ", -1");
-            result.push_back(indent + dest + " = and " + type + " " + t1 + ", " + t3);
-            break;
-        }
-        case 3:  // (~a & b) | (a & ~b)
-        {
-            result.push_back(indent + t1 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t2 + " = and " + type + " " + t1 + ", " + op2);
-            result.push_back(indent + t3 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t4 + " = and " + type + " " + op1 + ", " + t3);
-            result.push_back(indent + dest + " = or " + type + " " + t2 + ", " + t4);
-            break;
-        }
-        case 4:  // (a | b) & (~a | ~b)
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = xor " + type + " " + op1 + ", -1");
-            result.push_back(indent + t3 + " = xor " + type + " " + op2 + ", -1");
-            result.push_back(indent + t4 + " = or " + type + " " + t2 + ", " + t3);
-            result.push_back(indent + dest + " = and " + type + " " + t1 + ", " + t4);
-            break;
-        }
-        case 5:  // (a | b) ^ (a & b) - recursive but different
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            // Expand this XOR differently to avoid infinite recursion
-            result.push_back(indent + t3 + " = or " + type + " " + t1 + ", " + t2);
-            result.push_back(indent + t4 + " = and " + type + " " + t1 + ", " + t2);
-            result.push_back(indent + dest + " = sub " + type + " " + t3 + ", " + t4);
-            break;
-        }
-        case 6:  // (a | b) - (a & b) - simple verified identity
-        {
-            // a ^ b = (a | b) - (a & b) - same as variant 0 for variety
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = and " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t1 + ", " + t2);
-            break;
-        }
-        case 7:  // Complex: (2*(a|b) - (a+b)) - uses relationship between ops
-        default:
-        {
-            result.push_back(indent + t1 + " = or " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + t2 + " = shl " + type + " " + t1 + ", 1");
-            result.push_back(indent + t3 + " = add " + type + " " + op1 + ", " + op2);
-            result.push_back(indent + dest + " = sub " + type + " " + t2 + ", " + t3);
-            break;
-        }
+    size_t var_idx = ((variant_idx >= 0) ?
+        static_cast<size_t>(variant_idx) : selectVariant(config)) % kXorVariantCount;
+
+    int base = g_xor_temp_counter.fetch_add(10, std::memory_order_relaxed);
+    std::string temps[6];
+    for (int i = 0; i < 6; i++) {
+        temps[i] = "%_mba_x" + std::to_string(base + i);
     }
 
+    expandMBAVariant(kXorVariants[var_idx], m.indent, m.dest, m.type, m.op1,
+                     m.op2, temps, result);
+
     logger_.debug("Applied MBA XOR variant {} to: {}", var_idx, line);
     return result;
 }
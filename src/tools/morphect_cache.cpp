@@ -0,0 +1,248 @@
+/**
+ * Morphect - Multi-Language Code Obfuscator
+ *
+ * morphect_cache.cpp - Whole-invocation result cache (ccache-style)
+ *
+ * Wraps a morphect-ir (or morphect-asm) invocation and returns a
+ * previously produced output file when the same input bytes, config
+ * contents and command line have been seen before, without launching
+ * the pass pipeline at all.
+ *
+ * Usage:
+ *   morphect-cache [--cache-dir <dir>] -- morphect-ir --mba in.ll out.ll
+ *
+ * The cache key covers:
+ *   - the input file contents
+ *   - the --config file contents (if any)
+ *   - the command line (with input/output paths normalized out)
+ *   - the morphect version
+ */
+
+#include "common/incremental_cache.hpp"
+#include "common/mapped_file.hpp"
+#include "common/logging.hpp"
+#include "morphect.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace morphect;
+
+namespace {
+
+/**
+ * Parsed view of the wrapped command line
+ */
+struct WrappedCommand {
+    std::vector<std::string> argv;
+    std::string input_file;    // first positional arg after the program
+    std::string output_file;   // second positional arg
+    std::string config_file;   // value of --config, if present
+};
+
+/**
+ * Options that consume a following value and therefore must not be
+ * treated as positional input/output paths
+ */
+bool takesValue(const std::string& arg) {
+    return arg == "--config" || arg == "--probability" ||
+           arg == "--jobs" || arg == "-j" || arg == "--cache-dir";
+}
+
+bool parseWrapped(const std::vector<std::string>& args, WrappedCommand& cmd) {
+    if (args.empty()) return false;
+
+    cmd.argv = args;
+
+    for (size_t i = 1; i < args.size(); i++) {
+        const std::string& arg = args[i];
+
+        if (takesValue(arg) && i + 1 < args.size()) {
+            if (arg == "--config") {
+                cmd.config_file = args[i + 1];
+            }
+            i++;
+        } else if (!arg.empty() && arg[0] != '-') {
+            if (cmd.input_file.empty()) {
+                cmd.input_file = arg;
+            } else if (cmd.output_file.empty()) {
+                cmd.output_file = arg;
+            }
+        }
+    }
+
+    return !cmd.input_file.empty() && !cmd.output_file.empty();
+}
+
+/**
+ * Hash the command line with the input/output paths replaced by
+ * placeholders, so moving files between directories still hits
+ */
+uint64_t hashCommandLine(const WrappedCommand& cmd) {
+    std::string normalized;
+    for (const auto& arg : cmd.argv) {
+        if (arg == cmd.input_file) {
+            normalized += "<input>";
+        } else if (arg == cmd.output_file) {
+            normalized += "<output>";
+        } else {
+            normalized += arg;
+        }
+        normalized += '\x1f';
+    }
+    return IncrementalCache::hashText(normalized);
+}
+
+uint64_t hashFileContents(const std::string& path) {
+    MappedFile file(path);
+    if (!file.valid()) return 0;
+    return IncrementalCache::hashText(file.view());
+}
+
+bool copyFile(const std::string& from, const std::string& to) {
+    std::ifstream in(from, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    std::ofstream out(to, std::ios::binary);
+    if (!out.is_open()) return false;
+
+    out << in.rdbuf();
+    return out.good();
+}
+
+int runCommand(const std::vector<std::string>& argv) {
+    std::vector<char*> c_argv;
+    c_argv.reserve(argv.size() + 1);
+    for (const auto& arg : argv) {
+        c_argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    c_argv.push_back(nullptr);
+
+    pid_t pid = fork();
+    if (pid < 0) {
+        return -1;
+    }
+    if (pid == 0) {
+        execvp(c_argv[0], c_argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) {
+        return -1;
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program
+              << " [--cache-dir <dir>] -- <morphect-ir command...>" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --cache-dir <dir>   Cache directory (default: $MORPHECT_CACHE_DIR" << std::endl;
+    std::cout << "                      or .morphect-cache)" << std::endl;
+    std::cout << "  --help, -h          Show this help" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Example:" << std::endl;
+    std::cout << "  " << program
+              << " -- morphect-ir --config cfg.json input.ll output.ll" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Logger logger("morphect-cache");
+
+    std::string cache_dir;
+    if (const char* env = getenv("MORPHECT_CACHE_DIR")) {
+        cache_dir = env;
+    } else {
+        cache_dir = ".morphect-cache";
+    }
+
+    std::vector<std::string> wrapped_args;
+
+    int i = 1;
+    for (; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--cache-dir" && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--") {
+            i++;
+            break;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    for (; i < argc; i++) {
+        wrapped_args.push_back(argv[i]);
+    }
+
+    WrappedCommand cmd;
+    if (!parseWrapped(wrapped_args, cmd)) {
+        std::cerr << "Error: wrapped command needs input and output files" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    uint64_t key = hashFileContents(cmd.input_file);
+    if (key == 0) {
+        logger.error("Cannot read input file: {}", cmd.input_file);
+        return 1;
+    }
+    key = IncrementalCache::combine(key, hashCommandLine(cmd));
+    if (!cmd.config_file.empty()) {
+        key = IncrementalCache::combine(key, hashFileContents(cmd.config_file));
+    }
+    key = IncrementalCache::combine(
+        key, IncrementalCache::hashText(MORPHECT_VERSION_STRING));
+
+    IncrementalCache cache;
+    bool cache_ok = cache.open(cache_dir);
+    if (!cache_ok) {
+        logger.warn("Cache directory unusable, running uncached: {}", cache_dir);
+    }
+
+    std::ostringstream key_name;
+    key_name << cache_dir << "/" << std::hex << key << ".out";
+    std::string entry = key_name.str();
+
+    if (cache_ok) {
+        std::ifstream probe(entry, std::ios::binary);
+        if (probe.is_open()) {
+            probe.close();
+            if (copyFile(entry, cmd.output_file)) {
+                logger.info("Cache hit for {}", cmd.input_file);
+                return 0;
+            }
+            logger.warn("Cache entry unreadable, re-running");
+        }
+    }
+
+    int rc = runCommand(cmd.argv);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (cache_ok) {
+        // Store atomically so concurrent build nodes never read half an entry
+        std::string tmp = entry + ".tmp";
+        if (copyFile(cmd.output_file, tmp)) {
+            std::rename(tmp.c_str(), entry.c_str());
+            logger.info("Cached result for {}", cmd.input_file);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * Morphect - Multi-Language Code Obfuscator
+ *
+ * morphect_stats.cpp - Merge per-process stat record files
+ *
+ * Parallel builds (make -j with the GIMPLE plugin, batched morphect-ir
+ * runs) leave one binary record file per build, appended to by every
+ * compiler process via StatRecordFile. This tool reads one or more
+ * record files, sums the counters, and prints the standard statistics
+ * report — or JSON with --json.
+ *
+ * Usage:
+ *   morphect-stats [--json] <records-file> [<records-file>...]
+ */
+
+#include "core/statistics.hpp"
+#include "morphect.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace morphect;
+
+namespace {
+
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [--json] <records-file> [<records-file>...]" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Merges binary stat record files written by parallel obfuscation" << std::endl;
+    std::cerr << "processes into a single report." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --json    Print merged counters as JSON instead of the report" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool json = false;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Statistics merged;
+    bool any_read = false;
+
+    for (const auto& file : files) {
+        if (!StatRecordFile::read(file, merged)) {
+            std::cerr << "Error: Cannot read records file: " << file << std::endl;
+            continue;
+        }
+        any_read = true;
+    }
+
+    if (!any_read) {
+        return 1;
+    }
+
+    if (json) {
+        std::cout << merged.toJson();
+    } else {
+        std::cout << merged.format();
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * Morphect - Multi-Language Code Obfuscator
+ *
+ * morphect_trace.cpp - Replay binary transformation traces
+ *
+ * morphect-ir --transform-trace writes a binary trace of every
+ * transformation (interned strings, fixed-size records). This tool
+ * replays a trace file and pretty-prints it, either record by record
+ * or as a per-function summary.
+ *
+ * Usage:
+ *   morphect-trace [--summary] <trace-file>
+ */
+
+#include "common/transform_trace.hpp"
+
+#include <iostream>
+#include <map>
+#include <string>
+
+using namespace morphect;
+
+namespace {
+
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [--summary] <trace-file>" << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Replays a binary transformation trace written by" << std::endl;
+    std::cerr << "morphect-ir --transform-trace." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --summary   Per-function pass counts instead of raw records" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool summary = false;
+    std::string file;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--summary") {
+            summary = true;
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (file.empty()) {
+            file = arg;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (file.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (summary) {
+        // function -> pass -> count
+        std::map<std::string, std::map<std::string, int>> by_function;
+        size_t total = 0;
+
+        bool ok = TransformTrace::readFile(
+            file, [&](std::string_view function, std::string_view pass,
+                      std::string_view operation, int line) {
+                (void)operation;
+                (void)line;
+                by_function[std::string(function)][std::string(pass)]++;
+                total++;
+            });
+        if (!ok) {
+            std::cerr << "Error: cannot read trace file: " << file << std::endl;
+            return 1;
+        }
+
+        for (const auto& [function, passes] : by_function) {
+            std::cout << function << std::endl;
+            for (const auto& [pass, count] : passes) {
+                std::cout << "  " << pass << ": " << count << std::endl;
+            }
+        }
+        std::cout << "total: " << total << " transformations across "
+                  << by_function.size() << " functions" << std::endl;
+        return 0;
+    }
+
+    bool ok = TransformTrace::readFile(
+        file, [](std::string_view function, std::string_view pass,
+                 std::string_view operation, int line) {
+            std::cout << function << "\t" << pass << "\t" << operation;
+            if (line >= 0) {
+                std::cout << "\t:" << line;
+            }
+            std::cout << std::endl;
+        });
+    if (!ok) {
+        std::cerr << "Error: cannot read trace file: " << file << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * Morphect - Assembly Scanning Benchmarks
+ *
+ * The assembly obfuscator is built on one AsmScanner sweep: the label
+ * table feeds label randomization and the per-line instruction classes
+ * feed the flag-safety lookahead. These benchmarks measure the sweep
+ * and the analyzer queries separately, on synthetic modules of growing
+ * function counts, so a scaling regression names the stage that caused
+ * it. Reports bytes/sec and allocations per iteration (the latter only
+ * ticks when the build compiles the allocation hook).
+ */
+
+#include <benchmark/benchmark.h>
+#include "common/asm_scan.hpp"
+#include "passes/antidisasm/antidisasm.hpp"
+#include "core/statistics.hpp"
+
+using namespace morphect;
+using namespace morphect::antidisasm;
+
+namespace {
+
+/**
+ * A module of `functions` x86-64 functions with local labels, jumps and
+ * flag-setting/flag-using pairs (the patterns the scanner classifies)
+ */
+std::vector<std::string> makeAsmModule(int functions) {
+    std::vector<std::string> lines;
+    lines.push_back("\t.text");
+    for (int f = 0; f < functions; f++) {
+        std::string name = "func_" + std::to_string(f);
+        lines.push_back("\t.globl\t" + name);
+        lines.push_back("\t.type\t" + name + ", @function");
+        lines.push_back(name + ":");
+        lines.push_back("\tpushq\t%rbp");
+        lines.push_back("\tmovq\t%rsp, %rbp");
+        for (int i = 0; i < 8; i++) {
+            std::string label = ".L" + std::to_string(f) + "_" + std::to_string(i);
+            lines.push_back(label + ":");
+            lines.push_back("\taddl\t$1, %eax");
+            lines.push_back("\tcmpl\t$" + std::to_string(i + 8) + ", %eax");
+            lines.push_back("\tjne\t" + label);
+        }
+        lines.push_back("\tjmp\t.Lret_" + std::to_string(f));
+        lines.push_back(".Lret_" + std::to_string(f) + ":");
+        lines.push_back("\tpopq\t%rbp");
+        lines.push_back("\tret");
+        lines.push_back("\t.size\t" + name + ", .-" + name);
+    }
+    return lines;
+}
+
+size_t moduleBytes(const std::vector<std::string>& lines) {
+    size_t bytes = 0;
+    for (const auto& l : lines) bytes += l.size() + 1;
+    return bytes;
+}
+
+} // namespace
+
+static void BM_AsmScanner_Sweep(benchmark::State& state) {
+    auto module = makeAsmModule(static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    size_t allocs_before = AllocationCounter::count().load();
+    for (auto _ : state) {
+        auto scan = AsmScanner::scan(module);
+        benchmark::DoNotOptimize(scan);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_AsmScanner_Sweep)->Arg(16)->Arg(256)->Arg(2048);
+
+static void BM_AssemblyAnalyzer_UnconditionalJumps(benchmark::State& state) {
+    // Insertion-point discovery for junk bytes: the flag-safe positions
+    // after unconditional jumps
+    AssemblyAnalyzer analyzer;
+    auto module = makeAsmModule(static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    for (auto _ : state) {
+        auto jumps = analyzer.findUnconditionalJumps(module);
+        benchmark::DoNotOptimize(jumps);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_AssemblyAnalyzer_UnconditionalJumps)->Arg(16)->Arg(256)->Arg(2048);
+
+static void BM_AssemblyAnalyzer_ProloguePoints(benchmark::State& state) {
+    AssemblyAnalyzer analyzer;
+    auto module = makeAsmModule(static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    for (auto _ : state) {
+        auto points = analyzer.findPrologueInsertPoints(module);
+        benchmark::DoNotOptimize(points);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_AssemblyAnalyzer_ProloguePoints)->Arg(16)->Arg(256)->Arg(2048);
@@ -0,0 +1,103 @@
+/**
+ * Morphect - CFF Pass Benchmarks
+ *
+ * Measures LLVMCFFPass::transformIR end to end (function discovery,
+ * CFG analysis, flattening, splice-back) over synthetic modules of
+ * growing function counts. Reports bytes/sec and allocations per
+ * iteration; the allocation counter only ticks when the build compiles
+ * the allocation hook (MORPHECT_COUNT_ALLOCATIONS).
+ */
+
+#include <benchmark/benchmark.h>
+#include "passes/cff/cff.hpp"
+#include "core/statistics.hpp"
+
+using namespace morphect;
+using namespace morphect::cff;
+
+namespace {
+
+/**
+ * A module of `functions` branchy functions, each with `blocks` basic
+ * blocks chained by conditional branches (the shape CFF flattens)
+ */
+std::vector<std::string> makeBranchyModule(int functions, int blocks) {
+    std::vector<std::string> lines;
+    for (int f = 0; f < functions; f++) {
+        lines.push_back("define i32 @func_" + std::to_string(f) +
+                        "(i32 %a, i32 %b) {");
+        lines.push_back("entry:");
+        lines.push_back("  %cmp = icmp sgt i32 %a, %b");
+        lines.push_back("  br i1 %cmp, label %bb0, label %exit");
+        for (int b = 0; b < blocks; b++) {
+            std::string cur = "bb" + std::to_string(b);
+            std::string next = (b + 1 < blocks) ? "bb" + std::to_string(b + 1)
+                                                : "exit";
+            lines.push_back(cur + ":");
+            lines.push_back("  %v" + std::to_string(f) + "_" + std::to_string(b) +
+                            " = add i32 %a, " + std::to_string(b));
+            lines.push_back("  br label %" + next);
+        }
+        lines.push_back("exit:");
+        lines.push_back("  ret i32 %a");
+        lines.push_back("}");
+        lines.push_back("");
+    }
+    return lines;
+}
+
+size_t moduleBytes(const std::vector<std::string>& lines) {
+    size_t bytes = 0;
+    for (const auto& l : lines) bytes += l.size() + 1;
+    return bytes;
+}
+
+} // namespace
+
+static void BM_LLVMCFFPass_TransformIR(benchmark::State& state) {
+    PassConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+
+    auto module = makeBranchyModule(static_cast<int>(state.range(0)), 6);
+    size_t bytes = moduleBytes(module);
+
+    size_t allocs_before = AllocationCounter::count().load();
+    for (auto _ : state) {
+        LLVMCFFPass pass;
+        pass.initialize(config);
+        std::vector<std::string> copy = module;
+        pass.transformIR(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LLVMCFFPass_TransformIR)->Arg(8)->Arg(64)->Arg(256);
+
+static void BM_LLVMCFFPass_DeepFunction(benchmark::State& state) {
+    // One function whose block count grows: isolates per-function
+    // flattening cost from per-module function discovery
+    PassConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+
+    auto module = makeBranchyModule(1, static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    size_t allocs_before = AllocationCounter::count().load();
+    for (auto _ : state) {
+        LLVMCFFPass pass;
+        pass.initialize(config);
+        std::vector<std::string> copy = module;
+        pass.transformIR(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LLVMCFFPass_DeepFunction)->Arg(16)->Arg(128)->Arg(512);
@@ -0,0 +1,124 @@
+/**
+ * Morphect - Memory-Focused Pass Benchmarks
+ *
+ * Throughput numbers won't catch an RSS blowup, so these benchmarks run
+ * each pass over the synthetic corpus and report memory counters
+ * instead of emphasizing time: total allocation count and bytes per
+ * iteration (ticking only when the build compiles the allocation hook),
+ * the RSS growth across the benchmark, and the process peak RSS.
+ *
+ * Peak RSS is process-wide and monotonic, so within one binary run the
+ * largest input dominates the later benchmarks' peaks; run with
+ * --benchmark_filter to isolate a single pass/size pair. bench_check.py
+ * gates on these counters alongside time.
+ */
+
+#include <benchmark/benchmark.h>
+#include "common/corpus_gen.hpp"
+#include "core/statistics.hpp"
+#include "passes/mba/mba.hpp"
+#include "passes/cff/cff.hpp"
+#include "passes/deadcode/deadcode.hpp"
+#include "passes/data/data.hpp"
+
+using namespace morphect;
+
+namespace {
+
+/**
+ * A synthetic corpus module of `functions` functions with the default
+ * shape (mixed arithmetic/memory/call, 1-8 blocks)
+ */
+std::vector<std::string> makeCorpusModule(int functions) {
+    CorpusShape shape;
+    shape.functions = functions;
+
+    CorpusGenerator gen(shape);
+    std::vector<std::string> lines = gen.irPrelude();
+    for (int f = 0; f < functions; f++) {
+        auto fn = gen.irFunction(f);
+        lines.insert(lines.end(), fn.begin(), fn.end());
+    }
+    return lines;
+}
+
+/**
+ * Shared measurement loop: runs `pass` (freshly constructed per
+ * iteration by `make`) over the corpus and attaches the memory counters
+ */
+template <typename MakePass>
+void runMemoryBenchmark(benchmark::State& state, MakePass make) {
+    auto module = makeCorpusModule(static_cast<int>(state.range(0)));
+
+    size_t allocs_before = AllocationCounter::count().load();
+    size_t alloc_bytes_before = AllocationCounter::bytes().load();
+    size_t rss_before = MemoryTracker::currentRssKb();
+
+    for (auto _ : state) {
+        auto pass = make();
+        std::vector<std::string> copy = module;
+        pass->transformIR(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+    state.counters["alloc_bytes"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::bytes().load() -
+                            alloc_bytes_before),
+        benchmark::Counter::kAvgIterations);
+    state.counters["rss_grew_kb"] = benchmark::Counter(static_cast<double>(
+        MemoryTracker::currentRssKb() - rss_before));
+    state.counters["peak_rss_kb"] = benchmark::Counter(
+        static_cast<double>(MemoryTracker::peakRssKb()));
+}
+
+PassConfig fullConfig() {
+    PassConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.verbosity = 0;
+    return config;
+}
+
+} // namespace
+
+static void BM_Memory_MBA(benchmark::State& state) {
+    runMemoryBenchmark(state, [] {
+        auto pass = std::make_unique<mba::LLVMMBAPass>();
+        pass->initialize(fullConfig());
+        return pass;
+    });
+}
+BENCHMARK(BM_Memory_MBA)->Arg(32)->Arg(256)->Arg(1024);
+
+static void BM_Memory_CFF(benchmark::State& state) {
+    runMemoryBenchmark(state, [] {
+        auto pass = std::make_unique<cff::LLVMCFFPass>();
+        pass->initialize(fullConfig());
+        return pass;
+    });
+}
+BENCHMARK(BM_Memory_CFF)->Arg(32)->Arg(256)->Arg(1024);
+
+static void BM_Memory_DeadCode(benchmark::State& state) {
+    runMemoryBenchmark(state, [] {
+        auto pass = std::make_unique<deadcode::LLVMDeadCodePass>();
+        pass->initialize(fullConfig());
+        return pass;
+    });
+}
+BENCHMARK(BM_Memory_DeadCode)->Arg(32)->Arg(256)->Arg(1024);
+
+static void BM_Memory_StringEncoding(benchmark::State& state) {
+    runMemoryBenchmark(state, [] {
+        auto pass = std::make_unique<data::LLVMStringEncodingPass>();
+        pass->initialize(fullConfig());
+        data::StringEncodingConfig str_config;
+        str_config.enabled = true;
+        pass->configure(str_config);
+        return pass;
+    });
+}
+BENCHMARK(BM_Memory_StringEncoding)->Arg(32)->Arg(256)->Arg(1024);
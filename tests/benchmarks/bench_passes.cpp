@@ -0,0 +1,118 @@
+/**
+ * Morphect - Dead Code and String Encoding Benchmarks
+ *
+ * Measures LLVMDeadCodePass::transformIR and
+ * LLVMStringEncodingPass::transformIR over synthetic modules. Reports
+ * bytes/sec and allocations per iteration (the latter only ticks when
+ * the build compiles the allocation hook).
+ */
+
+#include <benchmark/benchmark.h>
+#include "passes/deadcode/deadcode.hpp"
+#include "passes/data/data.hpp"
+#include "core/statistics.hpp"
+
+using namespace morphect;
+using namespace morphect::data;
+using namespace morphect::deadcode;
+
+namespace {
+
+/**
+ * A module of `functions` straight-line functions (the insertion-point
+ * shape the dead-code pass scans for)
+ */
+std::vector<std::string> makePlainModule(int functions) {
+    std::vector<std::string> lines;
+    for (int f = 0; f < functions; f++) {
+        lines.push_back("define i32 @func_" + std::to_string(f) +
+                        "(i32 %a, i32 %b) {");
+        lines.push_back("entry:");
+        for (int i = 0; i < 6; i++) {
+            lines.push_back("  %t" + std::to_string(i) + " = add i32 %a, " +
+                            std::to_string(i));
+        }
+        lines.push_back("  ret i32 %t5");
+        lines.push_back("}");
+        lines.push_back("");
+    }
+    return lines;
+}
+
+/**
+ * A module whose weight is its string table: `strings` global constants
+ * plus one function referencing them
+ */
+std::vector<std::string> makeStringModule(int strings) {
+    std::vector<std::string> lines;
+    for (int s = 0; s < strings; s++) {
+        std::string text = "diagnostic message number " + std::to_string(s);
+        lines.push_back("@.str." + std::to_string(s) +
+                        " = private unnamed_addr constant [" +
+                        std::to_string(text.size() + 1) + " x i8] c\"" +
+                        text + "\\00\"");
+    }
+    lines.push_back("define i32 @main() {");
+    lines.push_back("entry:");
+    lines.push_back("  ret i32 0");
+    lines.push_back("}");
+    return lines;
+}
+
+size_t moduleBytes(const std::vector<std::string>& lines) {
+    size_t bytes = 0;
+    for (const auto& l : lines) bytes += l.size() + 1;
+    return bytes;
+}
+
+} // namespace
+
+static void BM_LLVMDeadCodePass_TransformIR(benchmark::State& state) {
+    PassConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+
+    auto module = makePlainModule(static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    size_t allocs_before = AllocationCounter::count().load();
+    for (auto _ : state) {
+        LLVMDeadCodePass pass;
+        pass.initialize(config);
+        std::vector<std::string> copy = module;
+        pass.transformIR(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LLVMDeadCodePass_TransformIR)->Arg(8)->Arg(64)->Arg(256);
+
+static void BM_LLVMStringEncodingPass_TransformIR(benchmark::State& state) {
+    PassConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+
+    StringEncodingConfig str_config;
+    str_config.enabled = true;
+
+    auto module = makeStringModule(static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    size_t allocs_before = AllocationCounter::count().load();
+    for (auto _ : state) {
+        LLVMStringEncodingPass pass;
+        pass.initialize(config);
+        pass.configure(str_config);
+        std::vector<std::string> copy = module;
+        pass.transformIR(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_LLVMStringEncodingPass_TransformIR)->Arg(16)->Arg(128)->Arg(1024);
@@ -0,0 +1,112 @@
+/**
+ * Morphect - Whole-Pipeline Benchmarks
+ *
+ * Measures a representative pass pipeline (MBA + CFF + dead code) run
+ * through PassManager over synthetic modules, which is what a real
+ * morphect-ir invocation spends its time on. Reports bytes/sec and
+ * allocations per iteration (the latter only ticks when the build
+ * compiles the allocation hook).
+ */
+
+#include <benchmark/benchmark.h>
+#include "core/pass_manager.hpp"
+#include "core/statistics.hpp"
+#include "passes/mba/mba.hpp"
+#include "passes/cff/cff.hpp"
+#include "passes/deadcode/deadcode.hpp"
+
+using namespace morphect;
+
+namespace {
+
+/**
+ * A module of `functions` mixed-shape functions: arithmetic the MBA
+ * pass rewrites, branches CFF flattens, straight-line runs the
+ * dead-code pass pads
+ */
+std::vector<std::string> makeMixedModule(int functions) {
+    std::vector<std::string> lines;
+    for (int f = 0; f < functions; f++) {
+        lines.push_back("define i32 @func_" + std::to_string(f) +
+                        "(i32 %a, i32 %b) {");
+        lines.push_back("entry:");
+        lines.push_back("  %sum = add i32 %a, %b");
+        lines.push_back("  %mix = xor i32 %sum, %a");
+        lines.push_back("  %cmp = icmp sgt i32 %mix, 0");
+        lines.push_back("  br i1 %cmp, label %then, label %done");
+        lines.push_back("then:");
+        lines.push_back("  %masked = and i32 %mix, %b");
+        lines.push_back("  br label %done");
+        lines.push_back("done:");
+        lines.push_back("  ret i32 %sum");
+        lines.push_back("}");
+        lines.push_back("");
+    }
+    return lines;
+}
+
+size_t moduleBytes(const std::vector<std::string>& lines) {
+    size_t bytes = 0;
+    for (const auto& l : lines) bytes += l.size() + 1;
+    return bytes;
+}
+
+void setupPipeline(PassManager& manager) {
+    manager.registerPass(std::make_unique<mba::LLVMMBAPass>());
+    manager.registerPass(std::make_unique<cff::LLVMCFFPass>());
+    manager.registerPass(std::make_unique<deadcode::LLVMDeadCodePass>());
+
+    PassConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.verbosity = 0;
+    manager.initialize(config);
+}
+
+} // namespace
+
+static void BM_Pipeline_MBA_CFF_DeadCode(benchmark::State& state) {
+    auto module = makeMixedModule(static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    size_t allocs_before = AllocationCounter::count().load();
+    for (auto _ : state) {
+        PassManager manager;
+        setupPipeline(manager);
+        std::vector<std::string> copy = module;
+        manager.runLLVMPasses(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Pipeline_MBA_CFF_DeadCode)->Arg(8)->Arg(64)->Arg(512);
+
+static void BM_Pipeline_MBAOnly_Fused(benchmark::State& state) {
+    // MBA alone is line-local, so PassManager fuses it into one module
+    // sweep — the --fast preset's hot path
+    auto module = makeMixedModule(static_cast<int>(state.range(0)));
+    size_t bytes = moduleBytes(module);
+
+    size_t allocs_before = AllocationCounter::count().load();
+    for (auto _ : state) {
+        PassManager manager;
+        manager.registerPass(std::make_unique<mba::LLVMMBAPass>());
+        PassConfig config;
+        config.enabled = true;
+        config.probability = 1.0;
+        config.verbosity = 0;
+        manager.initialize(config);
+
+        std::vector<std::string> copy = module;
+        manager.runLLVMPasses(copy);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(AllocationCounter::count().load() - allocs_before),
+        benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_Pipeline_MBAOnly_Fused)->Arg(8)->Arg(64)->Arg(512);
@@ -242,3 +242,183 @@ entry:
     // Should preserve debug metadata
     EXPECT_TRUE(irContains(obfuscated, "!dbg") || irContains(obfuscated, "!llvm"));
 }
+
+// ============================================================================
+// Partitioned Mode Tests
+// ============================================================================
+
+TEST_F(IRIntegrationTest, PartitionedModeKeepsEveryFunction) {
+    const char* ir = R"(
+@shared = global i32 42
+
+define i32 @first(i32 %a, i32 %b) {
+entry:
+  %result = xor i32 %a, %b
+  ret i32 %result
+}
+
+define i32 @second(i32 %a, i32 %b) {
+entry:
+  %result = add i32 %a, %b
+  ret i32 %result
+}
+
+define i32 @third(i32 %a, i32 %b) {
+entry:
+  %t = xor i32 %a, %b
+  %result = add i32 %t, %b
+  ret i32 %result
+}
+)";
+
+    auto obfuscated = obfuscateIR(ir, "", "--mba --probability 1.0 --partition 2");
+    ASSERT_FALSE(obfuscated.empty());
+
+    // Every function survives the shard split and merge
+    EXPECT_TRUE(irContains(obfuscated, "@first"));
+    EXPECT_TRUE(irContains(obfuscated, "@second"));
+    EXPECT_TRUE(irContains(obfuscated, "@third"));
+    EXPECT_TRUE(irContains(obfuscated, "ret i32"));
+}
+
+TEST_F(IRIntegrationTest, PartitionedModeSharesGlobalsOnce) {
+    const char* ir = R"(
+@message = global i32 7
+
+define i32 @left(i32 %a, i32 %b) {
+entry:
+  %result = xor i32 %a, %b
+  ret i32 %result
+}
+
+define i32 @right(i32 %a, i32 %b) {
+entry:
+  %result = add i32 %a, %b
+  ret i32 %result
+}
+)";
+
+    auto obfuscated = obfuscateIR(ir, "", "--mba --partition 2");
+    ASSERT_FALSE(obfuscated.empty());
+
+    // The shared prelude goes into every shard input but must appear
+    // exactly once in the merged module
+    size_t count = 0;
+    size_t pos = 0;
+    while ((pos = obfuscated.find("@message = global", pos)) != std::string::npos) {
+        count++;
+        pos++;
+    }
+    EXPECT_EQ(count, 1u);
+}
+
+// ============================================================================
+// Pipe Mode Tests
+// ============================================================================
+
+TEST_F(IRIntegrationTest, PipeModeStreamsThroughStdio) {
+    const char* ir = R"(
+define i32 @pipe_func(i32 %a, i32 %b) {
+entry:
+  %result = xor i32 %a, %b
+  ret i32 %result
+}
+)";
+
+    // Pipe mode: '-' reads stdin and writes the IR to stdout
+    auto input_file = writeSource("pipe_input.ll", ir);
+    std::string cmd = "cat " + input_file.string() + " | " +
+        ir_obf_path_.string() + " --mba --probability 1.0 - -";
+    auto result = runCommand(cmd);
+    ASSERT_EQ(result.exit_code, 0) << result.stderr_output;
+
+    // stdout carries exactly the transformed IR - no banner mixed in
+    EXPECT_NE(result.stdout_output.find("define i32 @pipe_func"),
+              std::string::npos);
+    EXPECT_NE(result.stdout_output.find("_mba_"), std::string::npos);
+    EXPECT_EQ(result.stdout_output.find("Multi-Language"), std::string::npos);
+
+    // Diagnostics still flow, on stderr
+    EXPECT_NE(result.stderr_output.find("[morphect]"), std::string::npos);
+}
+
+// ============================================================================
+// Profile-Driven Layout Tests
+// ============================================================================
+
+TEST_F(IRIntegrationTest, HotLayoutOrdersFunctionsByProfile) {
+    const char* ir = R"(
+define i32 @alpha(i32 %a, i32 %b) {
+entry:
+  %result = add i32 %a, %b
+  ret i32 %result
+}
+
+define i32 @beta(i32 %a, i32 %b) {
+entry:
+  %result = sub i32 %a, %b
+  ret i32 %result
+}
+
+define i32 @gamma(i32 %a, i32 %b) {
+entry:
+  %result = xor i32 %a, %b
+  ret i32 %result
+}
+)";
+
+    // gamma is hottest, alpha warm, beta unprofiled
+    auto profile = writeSource("layout.prof", "gamma 100\nalpha 10\n");
+
+    auto obfuscated = obfuscateIR(ir, "",
+        "--mba --profile " + profile.string() + " --hot-layout");
+    ASSERT_FALSE(obfuscated.empty());
+
+    size_t pos_alpha = obfuscated.find("define i32 @alpha");
+    size_t pos_beta = obfuscated.find("define i32 @beta");
+    size_t pos_gamma = obfuscated.find("define i32 @gamma");
+    ASSERT_NE(pos_alpha, std::string::npos);
+    ASSERT_NE(pos_beta, std::string::npos);
+    ASSERT_NE(pos_gamma, std::string::npos);
+
+    // Hot-first: gamma, then alpha, unprofiled beta last
+    EXPECT_LT(pos_gamma, pos_alpha);
+    EXPECT_LT(pos_alpha, pos_beta);
+}
+
+TEST_F(IRIntegrationTest, HotLayoutSinksGeneratedHelpers) {
+    const char* ir = R"(
+define i32 @hot_path(i32 %a) {
+entry:
+  %result = add i32 %a, 1
+  ret i32 %result
+}
+
+@.str = private constant [14 x i8] c"hello world!!\00"
+
+define i8* @use_string() {
+entry:
+  %p = getelementptr [14 x i8], [14 x i8]* @.str, i32 0, i32 0
+  ret i8* %p
+}
+)";
+
+    auto profile = writeSource("layout2.prof", "hot_path 100\n");
+
+    // String encoding emits __morphect decoder functions; with
+    // --hot-layout they must land after all real code
+    auto obfuscated = obfuscateIR(ir, "",
+        "--mba --strenc --profile " + profile.string() + " --hot-layout");
+    ASSERT_FALSE(obfuscated.empty());
+
+    size_t pos_hot = obfuscated.find("define i32 @hot_path");
+    size_t pos_use = obfuscated.find("define i8* @use_string");
+    size_t pos_decoder = obfuscated.find("define", obfuscated.find("@__morphect"));
+    ASSERT_NE(pos_hot, std::string::npos);
+    ASSERT_NE(pos_use, std::string::npos);
+
+    EXPECT_LT(pos_hot, pos_use);
+    if (pos_decoder != std::string::npos) {
+        EXPECT_LT(pos_use, obfuscated.find("define i8 @__morphect"));
+    }
+}
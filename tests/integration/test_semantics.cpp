@@ -989,6 +989,40 @@ entry:
         << "MBA should transform add to use or/and/xor operations";
 }
 
+TEST_F(SemanticEquivalenceTest, Verify_Mode_Passes_On_Equivalent_Module) {
+    // --verify runs the built-in harness: compile both versions, push
+    // generated argument vectors through both binaries in parallel
+    // sandboxed workers, compare exit codes and output
+    const char* code = R"(
+#include <stdio.h>
+#include <stdlib.h>
+int main(int argc, char** argv) {
+    int acc = 7;
+    for (int i = 1; i < argc; i++) {
+        acc = acc * 31 + (atoi(argv[i]) ^ acc);
+    }
+    printf("%d\n", acc);
+    return 0;
+}
+)";
+    std::string ir = compileToIR(code);
+    ASSERT_FALSE(ir.empty());
+
+    auto ir_file = writeSource("input.ll", ir);
+    auto obf_ir_file = test_dir_ / "obfuscated.ll";
+
+    std::string cmd = ir_obf_path_.string() +
+                      " --mba --probability 1.0 --verify --verify-vectors 6 -j 2 " +
+                      ir_file.string() + " " + obf_ir_file.string();
+    auto result = runCommand(cmd);
+
+    EXPECT_TRUE(result.success())
+        << "--verify should pass on a semantics-preserving run:\n"
+        << result.stderr_output;
+    EXPECT_NE(result.stderr_output.find("Verification passed"), std::string::npos)
+        << result.stderr_output;
+}
+
 TEST_F(SemanticEquivalenceTest, Verify_CFF_Transforms) {
     const char* ir = R"(
 define i32 @test(i32 %n) {
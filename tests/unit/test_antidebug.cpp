@@ -873,3 +873,333 @@ TEST(AntiDebugTest, Integration_AsmWithMultipleFunctions) {
     EXPECT_TRUE(result.success);
     EXPECT_GT(result.generated_code.size(), lines.size());
 }
+
+// ============================================================================
+// Cheap Tier and Budget Tests
+// ============================================================================
+
+TEST(AntiDebugTest, X86_GenerateCheapTimingCheckAsm) {
+    auto code = X86AntiDebugGenerator::generateCheapTimingCheckAsm(
+        4096, ".Lfail");
+
+    EXPECT_FALSE(code.empty());
+
+    int rdtsc_count = 0;
+    bool has_syscall = false;
+    bool has_fail = false;
+
+    for (const auto& line : code) {
+        if (line == "    rdtsc") rdtsc_count++;
+        if (line.find("    syscall") != std::string::npos) has_syscall = true;
+        if (line.find(".Lfail") != std::string::npos) has_fail = true;
+    }
+
+    EXPECT_EQ(rdtsc_count, 2);
+    EXPECT_FALSE(has_syscall);
+    EXPECT_TRUE(has_fail);
+}
+
+TEST(AntiDebugTest, X86_GenerateTrapFlagCheckAsm) {
+    auto code = X86AntiDebugGenerator::generateTrapFlagCheckAsm(".Lfail");
+
+    EXPECT_FALSE(code.empty());
+
+    bool has_pushfq = false;
+    bool has_tf_test = false;
+    bool has_syscall = false;
+
+    for (const auto& line : code) {
+        if (line.find("pushfq") != std::string::npos) has_pushfq = true;
+        if (line.find("0x100") != std::string::npos) has_tf_test = true;
+        if (line.find("    syscall") != std::string::npos) has_syscall = true;
+    }
+
+    EXPECT_TRUE(has_pushfq);
+    EXPECT_TRUE(has_tf_test);
+    EXPECT_FALSE(has_syscall);
+}
+
+TEST(AntiDebugTest, LLVM_GenerateCheapTimingCheck) {
+    auto ir = LLVMAntiDebugGenerator::generateCheapTimingCheck(
+        4096, "_fail");
+
+    EXPECT_FALSE(ir.empty());
+
+    int counter_reads = 0;
+    bool has_libc_call = false;
+
+    for (const auto& line : ir) {
+        if (line.find("llvm.readcyclecounter") != std::string::npos) {
+            counter_reads++;
+        }
+        if (line.find("@getenv") != std::string::npos) has_libc_call = true;
+    }
+
+    EXPECT_EQ(counter_reads, 2);
+    EXPECT_FALSE(has_libc_call);
+}
+
+TEST(AntiDebugTest, Analyzer_FindLoopBodyRanges) {
+    AntiDebugAnalyzer analyzer;
+
+    std::vector<std::string> ir = {
+        "define i32 @f(i32 %n) {",
+        "entry:",
+        "  br label %for.cond",
+        "for.cond:",
+        "  %i = phi i32 [ 0, %entry ], [ %inc, %for.body ]",
+        "  %cmp = icmp slt i32 %i, %n",
+        "  br i1 %cmp, label %for.body, label %exit",
+        "for.body:",
+        "  %inc = add i32 %i, 1",
+        "  br label %for.cond",
+        "exit:",
+        "  ret i32 %i",
+        "}"
+    };
+
+    auto ranges = analyzer.findLoopBodyRanges(ir);
+
+    // One back edge: the br at line 9 to for.cond at line 3
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].first, 3);
+    EXPECT_EQ(ranges[0].second, 9);
+
+    // Lines inside the body are flagged; the header line itself is not
+    // (inserting there lands before the label, outside the loop)
+    EXPECT_TRUE(AntiDebugAnalyzer::isInLoopBody(5, ranges));
+    EXPECT_TRUE(AntiDebugAnalyzer::isInLoopBody(9, ranges));
+    EXPECT_FALSE(AntiDebugAnalyzer::isInLoopBody(3, ranges));
+    EXPECT_FALSE(AntiDebugAnalyzer::isInLoopBody(11, ranges));
+}
+
+TEST(AntiDebugTest, Analyzer_FindAsmLoopBodyRanges) {
+    AntiDebugAnalyzer analyzer;
+
+    std::vector<std::string> asm_lines = {
+        "    .type main, @function",
+        "main:",
+        "    xor ecx, ecx",
+        ".Lloop:",
+        "    add ecx, 1",
+        "    cmp ecx, 100",
+        "    jl .Lloop",
+        "    ret",
+        "    .size main, .-main"
+    };
+
+    auto ranges = analyzer.findAsmLoopBodyRanges(asm_lines);
+
+    ASSERT_EQ(ranges.size(), 1u);
+    EXPECT_EQ(ranges[0].first, 3);
+    EXPECT_EQ(ranges[0].second, 6);
+}
+
+TEST(AntiDebugTest, AsmTransform_CheapTierMakesNoSyscalls) {
+    AssemblyAntiDebugTransformation transformer;
+    AntiDebugConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.use_cheap_checks = true;
+    config.use_timing = true;
+    config.use_ptrace = true;  // Ignored by the cheap tier
+
+    std::vector<std::string> lines = {
+        "    .text",
+        "    .type main, @function",
+        "main:",
+        "    push %rbp",
+        "    ret",
+        "    .size main, .-main"
+    };
+
+    auto result = transformer.transform(lines, config);
+
+    EXPECT_TRUE(result.success);
+    EXPECT_GT(result.checks_inserted, 0);
+    EXPECT_EQ(result.cheap_checks_inserted, result.checks_inserted);
+
+    // No ptrace syscall in the inserted checks (the fail handler may
+    // still exit via syscall - that path only runs on detection)
+    bool has_ptrace = false;
+    bool has_cheap = false;
+    for (const auto& line : result.generated_code) {
+        if (line.find("__NR_ptrace") != std::string::npos) has_ptrace = true;
+        if (line.find("cheap") != std::string::npos) has_cheap = true;
+    }
+    EXPECT_FALSE(has_ptrace);
+    EXPECT_TRUE(has_cheap);
+}
+
+TEST(AntiDebugTest, Budget_CapIsPerFunction) {
+    AssemblyAntiDebugTransformation transformer;
+    AntiDebugConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.max_checks_per_function = 1;
+
+    std::vector<std::string> lines = {
+        "    .type func1, @function",
+        "func1:",
+        "    push %rbp",
+        "    ret",
+        "    .size func1, .-func1",
+        "    .type func2, @function",
+        "func2:",
+        "    push %rbp",
+        "    ret",
+        "    .size func2, .-func2"
+    };
+
+    auto result = transformer.transform(lines, config);
+
+    EXPECT_TRUE(result.success);
+    // The budget is per function, not per module: both entries get their
+    // one check
+    EXPECT_EQ(result.checks_inserted, 2);
+}
+
+TEST(AntiDebugTest, Budget_ZeroDisablesEntryChecks) {
+    AssemblyAntiDebugTransformation transformer;
+    AntiDebugConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.max_checks_per_function = 0;
+
+    std::vector<std::string> lines = {
+        "    .type main, @function",
+        "main:",
+        "    push %rbp",
+        "    ret",
+        "    .size main, .-main"
+    };
+
+    auto result = transformer.transform(lines, config);
+
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.checks_inserted, 0);
+}
+
+// ============================================================================
+// Incremental Analyzer Tests
+// ============================================================================
+
+TEST(AntiDebugTest, Analyzer_AnalyzeIRCachesPerFunction) {
+    AntiDebugAnalyzer analyzer;
+
+    std::vector<std::string> ir = {
+        "define i32 @main() {",
+        "entry:",
+        "  ret i32 0",
+        "}",
+        "",
+        "define void @helper() {",
+        "entry:",
+        "  ret void",
+        "}"
+    };
+
+    auto first = analyzer.analyzeIR(ir);
+    EXPECT_EQ(first.entry_points.size(), 2u);
+    EXPECT_EQ(analyzer.cacheMisses(), 2u);
+    EXPECT_EQ(analyzer.cacheHits(), 0u);
+
+    // Same module again: every function comes from the cache
+    auto second = analyzer.analyzeIR(ir);
+    EXPECT_EQ(second.entry_points, first.entry_points);
+    EXPECT_EQ(analyzer.cacheHits(), 2u);
+    EXPECT_EQ(analyzer.cacheMisses(), 2u);
+}
+
+TEST(AntiDebugTest, Analyzer_AnalyzeIRRecomputesOnlyChangedFunctions) {
+    AntiDebugAnalyzer analyzer;
+
+    std::vector<std::string> ir = {
+        "define i32 @main() {",
+        "entry:",
+        "  ret i32 0",
+        "}",
+        "define void @helper() {",
+        "entry:",
+        "  ret void",
+        "}"
+    };
+
+    analyzer.analyzeIR(ir);
+    EXPECT_EQ(analyzer.cacheMisses(), 2u);
+
+    // Edit helper's body: main must hit, only helper is rescanned
+    ir[6] = "  call void @other()";
+    ir.insert(ir.begin() + 7, "  ret void");
+
+    auto cand = analyzer.analyzeIR(ir);
+    EXPECT_EQ(analyzer.cacheMisses(), 3u);
+    EXPECT_EQ(analyzer.cacheHits(), 1u);
+
+    // Entry points track the new positions
+    ASSERT_EQ(cand.entry_points.size(), 2u);
+    EXPECT_EQ(cand.entry_points[0], 1);
+    EXPECT_EQ(cand.entry_points[1], 5);
+}
+
+TEST(AntiDebugTest, Analyzer_AnalyzeIRRebasesMovedFunctions) {
+    AntiDebugAnalyzer analyzer;
+
+    std::vector<std::string> ir = {
+        "define i32 @f(i32 %n) {",
+        "entry:",
+        "  br label %for.cond",
+        "for.cond:",
+        "  br i1 %cmp, label %for.body, label %exit",
+        "for.body:",
+        "  br label %for.cond",
+        "exit:",
+        "  ret i32 0",
+        "}"
+    };
+
+    auto before = analyzer.analyzeIR(ir);
+    ASSERT_EQ(before.loop_bodies.size(), 1u);
+
+    // Shift the whole function down two lines; the cached relative
+    // offsets must rebase to the new position
+    ir.insert(ir.begin(), "; ModuleID = 'test'");
+    ir.insert(ir.begin() + 1, "");
+
+    auto after = analyzer.analyzeIR(ir);
+    EXPECT_EQ(analyzer.cacheHits(), 1u);
+    ASSERT_EQ(after.loop_bodies.size(), 1u);
+    EXPECT_EQ(after.loop_bodies[0].first, before.loop_bodies[0].first + 2);
+    EXPECT_EQ(after.loop_bodies[0].second, before.loop_bodies[0].second + 2);
+}
+
+TEST(AntiDebugTest, Analyzer_AnalyzeAsmUsesSharedScan) {
+    AntiDebugAnalyzer analyzer;
+
+    std::vector<std::string> asm_lines = {
+        "    .text",
+        "    .type main, @function",
+        "main:",
+        "    push %rbp",
+        "    xor ecx, ecx",
+        ".Lloop:",
+        "    add ecx, 1",
+        "    cmp ecx, 100",
+        "    jl .Lloop",
+        "    ret",
+        "    .size main, .-main"
+    };
+
+    AsmScan scan = AsmScanner::scan(asm_lines);
+    auto cand = analyzer.analyzeAsm(scan, asm_lines);
+
+    ASSERT_EQ(cand.entry_points.size(), 1u);
+    EXPECT_EQ(cand.entry_points[0], 3);
+    ASSERT_EQ(cand.loop_bodies.size(), 1u);
+    EXPECT_EQ(cand.loop_bodies[0].first, 5);
+    EXPECT_EQ(cand.loop_bodies[0].second, 8);
+
+    // Second pass over the same text is all cache hits
+    analyzer.analyzeAsm(scan, asm_lines);
+    EXPECT_EQ(analyzer.cacheHits(), 1u);
+}
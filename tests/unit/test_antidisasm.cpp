@@ -154,6 +154,44 @@ TEST_F(AntiDisasmTest, X86JunkBytes_EmptyInput) {
     EXPECT_TRUE(asm_str.empty());
 }
 
+TEST_F(AntiDisasmTest, X86JunkBytes_DirectiveMatchesBytesToAsmFormat) {
+    std::string directive = X86JunkBytes::junkByteDirective(true, 4);
+
+    // Same shape bytesToAsm produces: "    .byte 0xNN, 0xNN, ..."
+    EXPECT_EQ(directive.rfind("    .byte 0x", 0), 0u);
+    int fragments = 1;
+    size_t pos = 0;
+    while ((pos = directive.find(", ", pos)) != std::string::npos) {
+        fragments++;
+        pos += 2;
+    }
+    EXPECT_EQ(fragments, 4);
+}
+
+TEST_F(AntiDisasmTest, X86JunkBytes_DirectiveDrawsFromPools) {
+    // Every emitted fragment must come from the corresponding pool table
+    for (bool prefer_prefix : {true, false}) {
+        std::string directive = X86JunkBytes::junkByteDirective(prefer_prefix, 8);
+        const char* const* table = prefer_prefix
+            ? X86JunkBytes::kPrefixByteStrs
+            : X86JunkBytes::kInstByteStrs;
+
+        size_t pos = directive.find("0x");
+        while (pos != std::string::npos) {
+            std::string fragment = directive.substr(pos, 4);
+            bool in_pool = false;
+            for (int i = 0; i < 11; i++) {
+                if (fragment == table[i]) {
+                    in_pool = true;
+                    break;
+                }
+            }
+            EXPECT_TRUE(in_pool) << fragment;
+            pos = directive.find("0x", pos + 4);
+        }
+    }
+}
+
 // ============================================================================
 // P5-007: Instruction Overlap Tests
 // ============================================================================
@@ -683,3 +721,47 @@ TEST_F(AntiDisasmTest, Integration_MultipleTransforms) {
     // Code should have grown
     EXPECT_GT(code.size(), getSampleAsm().size());
 }
+
+// ============================================================================
+// Shared Assembly Scan Tests
+// ============================================================================
+
+TEST_F(AntiDisasmTest, AsmScanner_ClassifiesEveryLine) {
+    auto code = getSampleAsm();
+    AsmScan scan = AsmScanner::scan(code);
+
+    ASSERT_EQ(scan.line_class.size(), code.size());
+    EXPECT_EQ(scan.line_class[0], AsmLineClass::Directive);    // .text
+    EXPECT_EQ(scan.line_class[3], AsmLineClass::LabelDef);     // main:
+    EXPECT_EQ(scan.line_class[4], AsmLineClass::Instruction);  // push rbp
+    EXPECT_EQ(scan.line_class[9], AsmLineClass::LabelDef);     // .L3:
+}
+
+TEST_F(AntiDisasmTest, AsmScanner_BuildsLabelTableAndFunctionRanges) {
+    auto code = getSampleAsm();
+    AsmScan scan = AsmScanner::scan(code);
+
+    // main:, .L3:, .L2:
+    ASSERT_EQ(scan.labels.size(), 3u);
+    EXPECT_EQ(scan.labels[0].name, "main");
+    EXPECT_FALSE(scan.labels[0].dotted);
+    EXPECT_EQ(scan.labels[1].name, "L3");
+    EXPECT_TRUE(scan.labels[1].dotted);
+
+    // One function from .type main,@function to .size
+    ASSERT_EQ(scan.functions.size(), 1u);
+    EXPECT_EQ(scan.functions[0].first, 2u);
+    EXPECT_EQ(scan.functions[0].second, code.size() - 1);
+}
+
+TEST_F(AntiDisasmTest, AsmScanner_MatchesAnalyzerQueries) {
+    // The analyzer queries are views over the same scan, so one scan
+    // and three per-query traversals must agree exactly
+    auto code = getSampleAsm();
+    AsmScan scan = AsmScanner::scan(code);
+    AssemblyAnalyzer analyzer;
+
+    EXPECT_EQ(scan.unconditional_jumps, analyzer.findUnconditionalJumps(code));
+    EXPECT_EQ(scan.prologue_points, analyzer.findPrologueInsertPoints(code));
+    EXPECT_EQ(scan.function_entries, analyzer.findFunctionEntries(code));
+}
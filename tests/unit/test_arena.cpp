@@ -0,0 +1,91 @@
+/**
+ * Morphect - Arena Allocator Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/arena.hpp"
+#include "core/pass_manager.hpp"
+
+#include <cstdint>
+
+using namespace morphect;
+
+TEST(ArenaTest, AllocationsAreDistinctAndAligned) {
+    Arena arena;
+
+    void* a = arena.allocate(16);
+    void* b = arena.allocate(16);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % alignof(std::max_align_t), 0u);
+
+    void* c = arena.allocate(1, 1);
+    void* d = arena.allocate(8, 8);
+    EXPECT_NE(c, d);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(d) % 8, 0u);
+
+    EXPECT_EQ(arena.bytesAllocated(), 16u + 16u + 1u + 8u);
+}
+
+TEST(ArenaTest, ResetReusesTheSameMemory) {
+    Arena arena;
+
+    void* first = arena.allocate(64);
+    arena.allocate(128);
+    size_t reserved = arena.bytesReserved();
+
+    arena.reset();
+    EXPECT_EQ(arena.bytesAllocated(), 0u);
+    EXPECT_EQ(arena.bytesReserved(), reserved);  // chunks stay warm
+
+    void* again = arena.allocate(64);
+    EXPECT_EQ(first, again);
+}
+
+TEST(ArenaTest, GrowsPastOneChunk) {
+    Arena arena;
+
+    // Fill well past the first chunk
+    for (int i = 0; i < 100; i++) {
+        arena.allocate(Arena::kChunkSize / 10);
+    }
+    EXPECT_GT(arena.bytesReserved(), Arena::kChunkSize);
+
+    // An allocation bigger than a chunk gets its own block
+    void* big = arena.allocate(Arena::kChunkSize * 2);
+    EXPECT_NE(big, nullptr);
+}
+
+TEST(ArenaTest, ArenaVectorDrawsFromArena) {
+    Arena arena;
+
+    ArenaVector<int> values{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(i);
+    }
+    EXPECT_EQ(values.size(), 1000u);
+    EXPECT_EQ(values[999], 999);
+    EXPECT_GE(arena.bytesAllocated(), 1000 * sizeof(int));
+}
+
+TEST(ArenaTest, ArenaStringDrawsFromArena) {
+    Arena arena;
+
+    ArenaString s{ArenaAllocator<char>(arena)};
+    for (int i = 0; i < 100; i++) {
+        s += "%_cff_tmp";
+    }
+    EXPECT_EQ(s.size(), 900u);
+    EXPECT_GT(arena.bytesAllocated(), 0u);
+}
+
+TEST(ArenaTest, ManagerResetsScratchAfterEachFunction) {
+    PassManager manager;
+    Arena& scratch = manager.scratchArena();
+
+    scratch.allocate(512);
+    EXPECT_EQ(scratch.bytesAllocated(), 512u);
+
+    std::vector<std::string> lines = {"define i32 @f() {", "  ret i32 0", "}"};
+    manager.runLLVMPasses(lines);
+    EXPECT_EQ(scratch.bytesAllocated(), 0u);
+}
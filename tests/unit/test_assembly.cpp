@@ -71,7 +71,7 @@ protected:
         return input_path.string();
     }
 
-    std::string obfuscateAsm(const std::string& input_content) {
+    std::string obfuscateAsm(const std::string& input_content, const std::string& extra_args = "") {
         if (!std::filesystem::exists(asm_obf_path_)) {
             return "";  // Skip if binary not found
         }
@@ -79,7 +79,7 @@ protected:
         auto input_path = writeTestAsm(input_content);
         auto output_path = (test_dir_ / "output.s").string();
 
-        std::string cmd = asm_obf_path_.string() + " " + input_path + " " + output_path + " 2>/dev/null";
+        std::string cmd = asm_obf_path_.string() + " " + extra_args + " " + input_path + " " + output_path + " 2>/dev/null";
         int result = std::system(cmd.c_str());
 
         if (result != 0) {
@@ -419,6 +419,118 @@ TEST_F(AssemblyObfuscatorTest, PreservesLabels) {
     EXPECT_TRUE(containsInstruction(result, "test_function:"));
 }
 
+TEST_F(AssemblyObfuscatorTest, RandomizesLocalLabelsConsistently) {
+    if (!std::filesystem::exists(asm_obf_path_)) {
+        GTEST_SKIP() << "Assembly obfuscator not found";
+    }
+
+    std::string asm_with_labels = R"(
+.text
+.globl func
+func:
+    push rbp
+    cmp rax, 0
+    je .L2
+    jmp .L3
+.L2:
+    mov rax, 1
+.L3:
+    pop rbp
+    ret
+)";
+
+    auto result = obfuscateAsm(asm_with_labels);
+    ASSERT_FALSE(result.empty());
+
+    // Original local labels must be gone
+    EXPECT_FALSE(containsInstruction(result, ".L2"));
+    EXPECT_FALSE(containsInstruction(result, ".L3"));
+
+    // Each jump target must still have a matching definition
+    std::istringstream stream(result);
+    std::string line;
+    while (std::getline(stream, line)) {
+        auto pos = line.find("jmp .");
+        if (pos == std::string::npos) pos = line.find("je .");
+        if (pos == std::string::npos) continue;
+        std::string target = line.substr(line.find('.', pos));
+        target.erase(target.find_last_not_of(" \t\r") + 1);
+        EXPECT_TRUE(containsInstruction(result, target + ":"))
+            << "Missing definition for jump target: " << target;
+    }
+}
+
+TEST_F(AssemblyObfuscatorTest, StreamingModeProducesValidOutput) {
+    if (!std::filesystem::exists(asm_obf_path_)) {
+        GTEST_SKIP() << "Assembly obfuscator not found";
+    }
+
+    auto result = obfuscateAsm(getSampleAsm(), "--stream");
+    ASSERT_FALSE(result.empty());
+
+    // Structure preserved through the sliding-window path
+    EXPECT_TRUE(containsInstruction(result, "test_function:"));
+    EXPECT_TRUE(containsInstruction(result, ".text"));
+    EXPECT_TRUE(containsInstruction(result, ".globl"));
+    EXPECT_TRUE(containsInstruction(result, "ret"));
+}
+
+TEST_F(AssemblyObfuscatorTest, StreamingModeRandomizesLabels) {
+    if (!std::filesystem::exists(asm_obf_path_)) {
+        GTEST_SKIP() << "Assembly obfuscator not found";
+    }
+
+    std::string asm_with_labels = R"(
+.text
+.globl func
+func:
+    cmp rax, 0
+    je .L7
+    jmp .L8
+.L7:
+    mov rax, 1
+.L8:
+    ret
+)";
+
+    auto result = obfuscateAsm(asm_with_labels, "--stream");
+    ASSERT_FALSE(result.empty());
+
+    // The label map from pass one is applied in the rewrite pass
+    EXPECT_FALSE(containsInstruction(result, ".L7"));
+    EXPECT_FALSE(containsInstruction(result, ".L8"));
+}
+
+TEST_F(AssemblyObfuscatorTest, MultiFileModeRewritesAllInputsInPlace) {
+    if (!std::filesystem::exists(asm_obf_path_)) {
+        GTEST_SKIP() << "Assembly obfuscator not found";
+    }
+
+    // Three or more positional files trigger the in-place worker pool
+    std::vector<std::string> paths;
+    for (int i = 0; i < 3; i++) {
+        auto path = test_dir_ / ("multi_" + std::to_string(i) + ".s");
+        std::ofstream file(path);
+        file << getSampleAsm();
+        paths.push_back(path.string());
+    }
+
+    std::string cmd = asm_obf_path_.string() + " --jobs 2 " +
+                      paths[0] + " " + paths[1] + " " + paths[2] + " 2>/dev/null";
+    ASSERT_EQ(std::system(cmd.c_str()), 0);
+
+    for (const auto& path : paths) {
+        std::ifstream file(path);
+        std::stringstream buf;
+        buf << file.rdbuf();
+        std::string result = buf.str();
+
+        EXPECT_FALSE(result.empty());
+        EXPECT_TRUE(containsInstruction(result, "test_function:"));
+        EXPECT_TRUE(containsInstruction(result, "ret"));
+    }
+}
+
 TEST_F(AssemblyObfuscatorTest, PreservesDirectives) {
     if (!std::filesystem::exists(asm_obf_path_)) {
         GTEST_SKIP() << "Assembly obfuscator not found";
@@ -0,0 +1,88 @@
+/**
+ * Morphect - Bounded Queue Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/bounded_queue.hpp"
+
+#include <thread>
+#include <vector>
+#include <numeric>
+
+using namespace morphect;
+
+TEST(BoundedQueueTest, PushPopRoundTrip) {
+    BoundedQueue<int> queue(4);
+
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+
+    int out = 0;
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 1);
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 2);
+}
+
+TEST(BoundedQueueTest, CloseDrainsThenEndsStream) {
+    BoundedQueue<int> queue(4);
+    queue.push(7);
+    queue.close();
+
+    int out = 0;
+    EXPECT_TRUE(queue.pop(out));   // remaining item drains
+    EXPECT_EQ(out, 7);
+    EXPECT_FALSE(queue.pop(out));  // then end-of-stream
+    EXPECT_FALSE(queue.push(8));   // producers give up after close
+}
+
+TEST(BoundedQueueTest, CapacityThrottlesProducer) {
+    BoundedQueue<int> queue(2);
+    queue.push(1);
+    queue.push(2);
+
+    // Third push must block until the consumer makes room
+    std::thread producer([&]() { queue.push(3); });
+
+    int out = 0;
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 1);
+    producer.join();
+
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 2);
+    EXPECT_TRUE(queue.pop(out));
+    EXPECT_EQ(out, 3);
+}
+
+TEST(BoundedQueueTest, ManyProducersOneConsumer) {
+    BoundedQueue<int> queue(8);
+    const int per_producer = 500;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; p++) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < per_producer; i++) {
+                queue.push(p * per_producer + i);
+            }
+        });
+    }
+
+    long long sum = 0;
+    int received = 0;
+    std::thread consumer([&]() {
+        int out;
+        while (queue.pop(out)) {
+            sum += out;
+            received++;
+        }
+    });
+
+    for (auto& t : producers) t.join();
+    queue.close();
+    consumer.join();
+
+    const int total = 4 * per_producer;
+    EXPECT_EQ(received, total);
+    EXPECT_EQ(sum, static_cast<long long>(total) * (total - 1) / 2);
+}
@@ -5,6 +5,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include "passes/cff/cff.hpp"
 
 using namespace morphect;
@@ -114,6 +115,127 @@ TEST_F(OpaquePredicateTest, GetAlwaysFalse_ReturnsFalse) {
     EXPECT_EQ(pred.type, PredicateType::AlwaysFalse);
 }
 
+TEST_F(OpaquePredicateTest, Absorption_AlwaysTrue) {
+    // ((x | y) & x) == x for all x, y
+    for (int x = -50; x <= 50; x++) {
+        for (int y = -50; y <= 50; y++) {
+            EXPECT_EQ((x | y) & x, x) << "Failed for x=" << x << ", y=" << y;
+        }
+    }
+}
+
+TEST_F(OpaquePredicateTest, SubSelfZero_AlwaysTrue) {
+    // x - x == 0 for all x
+    for (int x = -1000; x <= 1000; x++) {
+        EXPECT_EQ(x - x, 0) << "Failed for x=" << x;
+    }
+}
+
+TEST_F(OpaquePredicateTest, AndUgtOr_AlwaysFalse) {
+    // (x & y) >u (x | y) never: AND clears bits OR keeps
+    for (int x = -50; x <= 50; x++) {
+        for (int y = -50; y <= 50; y++) {
+            EXPECT_LE(static_cast<unsigned>(x & y), static_cast<unsigned>(x | y))
+                << "Failed for x=" << x << ", y=" << y;
+        }
+    }
+}
+
+TEST_F(OpaquePredicateTest, CheapTierIsRegisterOnly) {
+    // Cheap-tier draws must be 2-3 ALU ops with no loads and no
+    // multiplies/divides, so they are safe inside hot loops
+    for (int i = 0; i < 50; i++) {
+        auto [code, result] =
+            predicates.generateAlwaysTrue("%a", "%b", PredicateTier::Cheap);
+        EXPECT_FALSE(code.empty());
+        EXPECT_LE(code.size(), 3u);
+        for (const auto& line : code) {
+            EXPECT_EQ(line.find(" mul "), std::string::npos) << line;
+            EXPECT_EQ(line.find(" sdiv "), std::string::npos) << line;
+            EXPECT_EQ(line.find(" load "), std::string::npos) << line;
+        }
+
+        auto [fcode, fresult] =
+            predicates.generateAlwaysFalse("%a", "%b", PredicateTier::Cheap);
+        EXPECT_FALSE(fcode.empty());
+        EXPECT_LE(fcode.size(), 3u);
+        for (const auto& line : fcode) {
+            EXPECT_EQ(line.find(" mul "), std::string::npos) << line;
+            EXPECT_EQ(line.find(" sdiv "), std::string::npos) << line;
+            EXPECT_EQ(line.find(" load "), std::string::npos) << line;
+        }
+    }
+}
+
+TEST_F(OpaquePredicateTest, FullTierKeepsWholePool) {
+    // The Full tier is the tierless draw: over many draws it should
+    // still produce the heavyweight families
+    bool saw_full = false;
+    for (int i = 0; i < 200 && !saw_full; i++) {
+        auto [code, result] =
+            predicates.generateAlwaysTrue("%a", "%b", PredicateTier::Full);
+        for (const auto& line : code) {
+            if (line.find(" mul ") != std::string::npos) saw_full = true;
+        }
+    }
+    EXPECT_TRUE(saw_full);
+}
+
+TEST_F(OpaquePredicateTest, PoolCoversAllPredicates) {
+    // One pregenerated entry per built-in family
+    EXPECT_EQ(9u, predicates.getTruePool().size());
+    EXPECT_EQ(5u, predicates.getFalsePool().size());
+
+    for (const auto& pooled : predicates.getTruePool()) {
+        EXPECT_FALSE(pooled.lines.empty());
+        EXPECT_EQ(PredicateType::AlwaysTrue,
+                  predicates.getAllPredicates()[pooled.predicate_idx].type);
+    }
+    for (const auto& pooled : predicates.getFalsePool()) {
+        EXPECT_FALSE(pooled.lines.empty());
+        EXPECT_EQ(PredicateType::AlwaysFalse,
+                  predicates.getAllPredicates()[pooled.predicate_idx].type);
+    }
+}
+
+TEST_F(OpaquePredicateTest, InstantiatePooled_StampsOperands) {
+    const auto& pooled = predicates.getTruePool()[0];  // even_product
+    auto [code, result_var] = predicates.instantiatePooled(pooled, "%foo", "%bar");
+
+    ASSERT_FALSE(code.empty());
+    EXPECT_FALSE(result_var.empty());
+
+    bool found_operand = false;
+    for (const auto& line : code) {
+        EXPECT_EQ(std::string::npos, line.find("%__")) << line;
+        if (line.find("%foo") != std::string::npos) found_operand = true;
+    }
+    EXPECT_TRUE(found_operand);
+}
+
+TEST_F(OpaquePredicateTest, InstantiatePooled_FreshTempsPerDraw) {
+    const auto& pooled = predicates.getTruePool()[0];
+    auto [code1, result1] = predicates.instantiatePooled(pooled, "%a", "%b");
+    auto [code2, result2] = predicates.instantiatePooled(pooled, "%a", "%b");
+
+    // Same shape, but the temp registers must not collide
+    ASSERT_EQ(code1.size(), code2.size());
+    EXPECT_NE(result1, result2);
+}
+
+TEST_F(OpaquePredicateTest, GeneratedCodeHasNoPlaceholders) {
+    for (int i = 0; i < 20; i++) {
+        auto [code, result_var] = predicates.generateAlwaysTrue("%x1", "%y1");
+        ASSERT_FALSE(code.empty());
+        for (const auto& line : code) {
+            EXPECT_EQ(std::string::npos, line.find("%__")) << line;
+        }
+        EXPECT_EQ(result_var, code.back().substr(
+            code.back().find_first_not_of(" \t"),
+            code.back().find(" = ") - code.back().find_first_not_of(" \t")));
+    }
+}
+
 // ============================================================================
 // CFG Analyzer Tests
 // ============================================================================
@@ -627,6 +749,94 @@ TEST_F(LLVMCFFPassTest, TransformMultiBlockFunction) {
     EXPECT_NE(result, TransformResult::Error);
 }
 
+TEST_F(LLVMCFFPassTest, ParallelAnalysisMatchesSerial) {
+    // Several copies of the same multi-block function; the parallel
+    // analysis phase must produce the same flattening decisions
+    std::vector<std::string> ir;
+    for (int f = 0; f < 8; f++) {
+        std::string name = "@fn" + std::to_string(f);
+        ir.push_back("define i32 " + name + "(i32 %a, i32 %b) {");
+        ir.push_back("entry:");
+        ir.push_back("  %cmp = icmp sgt i32 %a, %b");
+        ir.push_back("  br i1 %cmp, label %then, label %else");
+        ir.push_back("then:");
+        ir.push_back("  %t1 = add i32 %a, 1");
+        ir.push_back("  br label %end");
+        ir.push_back("else:");
+        ir.push_back("  %t2 = add i32 %b, 1");
+        ir.push_back("  br label %end");
+        ir.push_back("end:");
+        ir.push_back("  %result = phi i32 [ %t1, %then ], [ %t2, %else ]");
+        ir.push_back("  ret i32 %result");
+        ir.push_back("}");
+    }
+
+    auto serial_ir = ir;
+    auto serial_result = pass.transformIR(serial_ir);
+
+    CFFConfig parallel = config;
+    parallel.analysis_threads = 4;
+    LLVMCFFPass parallel_pass;
+    parallel_pass.setCFFConfig(parallel);
+    PassConfig pc;
+    pc.enabled = true;
+    pc.probability = 1.0;
+    parallel_pass.initialize(pc);
+
+    auto parallel_ir = ir;
+    auto parallel_result = parallel_pass.transformIR(parallel_ir);
+
+    EXPECT_EQ(serial_result, parallel_result);
+    EXPECT_EQ(serial_ir.size(), parallel_ir.size());
+}
+
+TEST_F(LLVMCFFPassTest, DenseDispatchEmitsContiguousSortedCases) {
+    CFFConfig dense = config;
+    dense.dense_dispatch = true;
+    dense.shuffle_states = true;
+    pass.setCFFConfig(dense);
+
+    std::vector<std::string> ir = {
+        "define i32 @test(i32 %a, i32 %b) {",
+        "entry:",
+        "  %cmp = icmp sgt i32 %a, %b",
+        "  br i1 %cmp, label %then, label %else",
+        "then:",
+        "  %t1 = add i32 %a, 1",
+        "  br label %end",
+        "else:",
+        "  %t2 = add i32 %b, 1",
+        "  br label %end",
+        "end:",
+        "  %result = phi i32 [ %t1, %then ], [ %t2, %else ]",
+        "  ret i32 %result",
+        "}"
+    };
+
+    auto result = pass.transformIR(ir);
+    ASSERT_EQ(TransformResult::Success, result);
+
+    // The dispatcher's case values must be 0..n-1 in ascending order.
+    // The switch is emitted as one multi-line string.
+    std::vector<int> case_values;
+    for (const auto& line : ir) {
+        if (line.find("switch i32") == std::string::npos) continue;
+        std::stringstream ss(line);
+        std::string part;
+        while (std::getline(ss, part)) {
+            size_t pos = part.find("i32 ");
+            if (part.find(", label %state_") != std::string::npos &&
+                pos != std::string::npos) {
+                case_values.push_back(std::atoi(part.c_str() + pos + 4));
+            }
+        }
+    }
+    ASSERT_FALSE(case_values.empty());
+    for (size_t i = 0; i < case_values.size(); i++) {
+        EXPECT_EQ(static_cast<int>(i), case_values[i]);
+    }
+}
+
 TEST_F(LLVMCFFPassTest, SkipSingleBlock) {
     CFFConfig strict = config;
     strict.min_blocks = 10;
@@ -686,6 +896,111 @@ TEST_F(LLVMBogusPassTest, TransformFunction) {
     EXPECT_NE(result, TransformResult::Error);
 }
 
+// ============================================================================
+// Budgeted Bogus CF Tests
+// ============================================================================
+
+namespace {
+
+std::vector<std::string> makeManyBlockFunction(int blocks) {
+    std::vector<std::string> ir;
+    ir.push_back("define i32 @big(i32 %a) {");
+    ir.push_back("entry:");
+    ir.push_back("  br label %bb0");
+    for (int i = 0; i < blocks; i++) {
+        ir.push_back("bb" + std::to_string(i) + ":");
+        ir.push_back("  %v" + std::to_string(i) + " = add i32 %a, " +
+                     std::to_string(i));
+        if (i + 1 < blocks) {
+            ir.push_back("  br label %bb" + std::to_string(i + 1));
+        } else {
+            ir.push_back("  ret i32 %v" + std::to_string(i));
+        }
+    }
+    ir.push_back("}");
+    return ir;
+}
+
+int countFakeBlocks(const std::vector<std::string>& lines) {
+    int count = 0;
+    for (const auto& line : lines) {
+        if (line.compare(0, 5, "fake_") == 0 && line.back() == ':') count++;
+    }
+    return count;
+}
+
+} // namespace
+
+class BudgetedBogusCFTest : public ::testing::Test {
+protected:
+    LLVMBogusControlFlow transformer;
+    BogusConfig config;
+
+    void SetUp() override {
+        config.enabled = true;
+        config.budgeted_insertion = true;
+        config.max_insertions = 50;  // let the size budget be the limit
+    }
+};
+
+TEST_F(BudgetedBogusCFTest, OutputGrowthStaysWithinBudget) {
+    auto ir = makeManyBlockFunction(100);
+    auto result = transformer.transform(ir, config);
+
+    EXPECT_GT(result.size(), ir.size());
+
+    // Budget: size_budget_ratio of the function's lines, with some slack
+    // for the rough per-insertion cost estimate
+    size_t budget = static_cast<size_t>(ir.size() * config.size_budget_ratio);
+    EXPECT_LE(result.size() - ir.size(), budget + budget / 2);
+}
+
+TEST_F(BudgetedBogusCFTest, RespectsMaxInsertions) {
+    config.max_insertions = 3;
+    auto ir = makeManyBlockFunction(100);
+    auto result = transformer.transform(ir, config);
+
+    EXPECT_LE(countFakeBlocks(result), 3);
+    EXPECT_GT(countFakeBlocks(result), 0);
+}
+
+TEST_F(BudgetedBogusCFTest, TinyFunctionLeftAlone) {
+    // Budget too small to afford even one insertion
+    std::vector<std::string> ir = {
+        "define i32 @tiny(i32 %a) {",
+        "entry:",
+        "  br label %bb0",
+        "bb0:",
+        "  %v = add i32 %a, 1",
+        "  ret i32 %v",
+        "}"
+    };
+
+    auto result = transformer.transform(ir, config);
+    EXPECT_EQ(ir.size(), result.size());
+}
+
+TEST_F(BudgetedBogusCFTest, BudgetsAreComputedPerFunction) {
+    // A large and a tiny function in one module: only the large one
+    // should receive insertions
+    auto ir = makeManyBlockFunction(100);
+    ir.push_back("define i32 @tiny(i32 %a) {");
+    ir.push_back("entry:");
+    ir.push_back("  br label %bb0");
+    ir.push_back("bb0:");
+    ir.push_back("  %v = add i32 %a, 1");
+    ir.push_back("  ret i32 %v");
+    ir.push_back("}");
+
+    auto result = transformer.transform(ir, config);
+    EXPECT_GT(result.size(), ir.size());
+
+    // The tiny function's body (its last 4 lines before "}") is untouched
+    ASSERT_GE(result.size(), 4u);
+    EXPECT_EQ("  %v = add i32 %a, 1", result[result.size() - 3]);
+    EXPECT_EQ("  ret i32 %v", result[result.size() - 2]);
+}
+
 // ============================================================================
 // Context-Dependent Predicate Tests
 // ============================================================================
@@ -0,0 +1,113 @@
+/**
+ * Morphect - Checkpoint Manifest Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/checkpoint.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace morphect;
+
+namespace {
+
+std::string tempManifestPath(const char* name) {
+    return std::string("/tmp/morphect_ckpt_") + name + ".manifest";
+}
+
+} // namespace
+
+TEST(CheckpointManifestTest, RoundTripRestoresCompletionSet) {
+    std::string path = tempManifestPath("roundtrip");
+
+    CheckpointManifest writer;
+    ASSERT_TRUE(writer.create(path, 0x1234, 0xabcd));
+    writer.markDone(0);
+    writer.markDone(3);
+    writer.markDone(7);
+    writer.close();
+
+    CheckpointManifest reader;
+    ASSERT_TRUE(reader.load(path, 0x1234, 0xabcd));
+    EXPECT_EQ(reader.doneCount(), 3u);
+    EXPECT_TRUE(reader.isDone(0));
+    EXPECT_TRUE(reader.isDone(3));
+    EXPECT_TRUE(reader.isDone(7));
+    EXPECT_FALSE(reader.isDone(1));
+    reader.close();
+
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointManifestTest, ChangedInputOrConfigRejectsManifest) {
+    std::string path = tempManifestPath("identity");
+
+    CheckpointManifest writer;
+    ASSERT_TRUE(writer.create(path, 0x1111, 0x2222));
+    writer.markDone(5);
+    writer.close();
+
+    // A different input or config must not splice stale regions
+    CheckpointManifest reader;
+    EXPECT_FALSE(reader.load(path, 0x9999, 0x2222));
+    EXPECT_FALSE(reader.load(path, 0x1111, 0x9999));
+    EXPECT_TRUE(reader.load(path, 0x1111, 0x2222));
+    reader.close();
+
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointManifestTest, ResumedRunKeepsAppending) {
+    std::string path = tempManifestPath("append");
+
+    CheckpointManifest first;
+    ASSERT_TRUE(first.create(path, 0x42, 0x43));
+    first.markDone(0);
+    first.markDone(1);
+    first.close();
+
+    // The resumed run appends its own completions to the same manifest
+    CheckpointManifest second;
+    ASSERT_TRUE(second.load(path, 0x42, 0x43));
+    second.markDone(2);
+    second.close();
+
+    CheckpointManifest third;
+    ASSERT_TRUE(third.load(path, 0x42, 0x43));
+    EXPECT_EQ(third.doneCount(), 3u);
+    EXPECT_TRUE(third.isDone(2));
+    third.close();
+
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointManifestTest, MarkDoneIsDurablePerFunction) {
+    std::string path = tempManifestPath("durable");
+
+    // No close(): a killed run must still leave every markDone on disk
+    CheckpointManifest writer;
+    ASSERT_TRUE(writer.create(path, 0x7, 0x8));
+    writer.markDone(11);
+
+    CheckpointManifest reader;
+    ASSERT_TRUE(reader.load(path, 0x7, 0x8));
+    EXPECT_TRUE(reader.isDone(11));
+    reader.close();
+    writer.close();
+
+    std::remove(path.c_str());
+}
+
+TEST(CheckpointManifestTest, MissingOrGarbageFileFailsLoad) {
+    CheckpointManifest manifest;
+    EXPECT_FALSE(manifest.load("/tmp/morphect_ckpt_does_not_exist.manifest", 1, 2));
+
+    std::string path = tempManifestPath("garbage");
+    {
+        std::ofstream out(path);
+        out << "not a checkpoint\n";
+    }
+    EXPECT_FALSE(manifest.load(path, 1, 2));
+    std::remove(path.c_str());
+}
@@ -0,0 +1,102 @@
+/**
+ * Morphect - Compact Emitter Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/compact_emitter.hpp"
+
+using namespace morphect;
+
+TEST(CompactEmitterTest, DropsCommentAndBlankLines) {
+    CompactEmitter emitter;
+    std::string out;
+
+    EXPECT_FALSE(emitter.compactLine("", out));
+    EXPECT_FALSE(emitter.compactLine("   ", out));
+    EXPECT_FALSE(emitter.compactLine("  ; Dead code block (never executed)", out));
+
+    ASSERT_TRUE(emitter.compactLine("  ret i32 %sum", out));
+    EXPECT_EQ(out, "  ret i32 %sum");
+}
+
+TEST(CompactEmitterTest, StripsTrailingComments) {
+    CompactEmitter emitter;
+    std::string out;
+
+    ASSERT_TRUE(emitter.compactLine("  %a = add i32 0, 7809  ; initialize", out));
+    EXPECT_EQ(out, "  %a = add i32 0, 7809");
+
+    // A string constant may contain ';' - the line must survive intact
+    std::string str_line = "@.s = constant [4 x i8] c\"a;b\\00\"";
+    ASSERT_TRUE(emitter.compactLine(str_line, out));
+    EXPECT_EQ(out, str_line);
+}
+
+TEST(CompactEmitterTest, RenamesGeneratedIdentifiersConsistently) {
+    CompactEmitter emitter;
+    std::string out;
+
+    ASSERT_TRUE(emitter.compactLine(
+        "  %_dead3423_opq_v = add i32 0, 322", out));
+    EXPECT_EQ(out, "  %m.0 = add i32 0, 322");
+
+    // Every later use of the same name maps to the same short name
+    ASSERT_TRUE(emitter.compactLine(
+        "  %_dead3423_cond = icmp eq i32 %_dead3423_opq_v, 0", out));
+    EXPECT_EQ(out, "  %m.1 = icmp eq i32 %m.0, 0");
+}
+
+TEST(CompactEmitterTest, SourceIdentifiersSurviveVerbatim) {
+    CompactEmitter emitter;
+    std::string out;
+
+    ASSERT_TRUE(emitter.compactLine("  %sum = add i32 %a, %b", out));
+    EXPECT_EQ(out, "  %sum = add i32 %a, %b");
+
+    ASSERT_TRUE(emitter.compactLine("define i32 @add(i32 %a, i32 %b) {", out));
+    EXPECT_EQ(out, "define i32 @add(i32 %a, i32 %b) {");
+}
+
+TEST(CompactEmitterTest, RenamesGeneratedLabelsAtDefAndUse) {
+    CompactEmitter emitter;
+    std::string out;
+
+    // Branch reference first (labels are forward-referenced in IR)
+    ASSERT_TRUE(emitter.compactLine(
+        "  br i1 %c, label %dead_block3, label %continue3", out));
+    EXPECT_EQ(out, "  br i1 %c, label %m.0, label %m.1");
+
+    ASSERT_TRUE(emitter.compactLine("dead_block3:", out));
+    EXPECT_EQ(out, "m.0:");
+    ASSERT_TRUE(emitter.compactLine("continue3:", out));
+    EXPECT_EQ(out, "m.1:");
+
+    // "continue" followed by non-digits is a source name, not ours
+    ASSERT_TRUE(emitter.compactLine("continue_loop:", out));
+    EXPECT_EQ(out, "continue_loop:");
+}
+
+TEST(CompactEmitterTest, CompactShrinksGeneratedHeavyModule) {
+    CompactEmitter emitter;
+
+    std::vector<std::string> lines = {
+        "define i32 @f(i32 %x) {",
+        "entry:",
+        "  ; Dead code block (never executed)",
+        "  %_dead3423_opq_v = add i32 0, 322",
+        "  %_dead3423_opq_p1 = add i32 %_dead3423_opq_v, 1",
+        "",
+        "  %split__mba_a100000_p1_0 = add i32 %_dead3423_opq_p1, 0",
+        "  ret i32 %split__mba_a100000_p1_0",
+        "}",
+    };
+
+    std::vector<std::string> result = emitter.compact(lines);
+    ASSERT_EQ(result.size(), 7u);  // comment and blank line dropped
+
+    size_t before = 0, after = 0;
+    for (const auto& l : lines) before += l.size();
+    for (const auto& l : result) after += l.size();
+    EXPECT_LT(after, before * 3 / 4);
+    EXPECT_EQ(emitter.renamedCount(), 3u);
+}
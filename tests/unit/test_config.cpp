@@ -0,0 +1,115 @@
+/**
+ * Morphect - Config Preset and Cache Tests
+ */
+
+#include <gtest/gtest.h>
+#include "morphect.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+using namespace morphect;
+
+namespace {
+
+const char* kConfigDir = "/tmp/morphect_config_test";
+
+void wipeConfigDir() {
+    std::string cmd = std::string("rm -rf ") + kConfigDir;
+    (void)system(cmd.c_str());
+    std::filesystem::create_directories(kConfigDir);
+}
+
+std::string writeJson(const std::string& name, const std::string& content) {
+    std::string path = std::string(kConfigDir) + "/" + name;
+    std::ofstream out(path);
+    out << content;
+    return path;
+}
+
+} // namespace
+
+TEST(ConfigPresetTest, FindsShippedPresets) {
+    ASSERT_NE(findConfigPreset("default"), nullptr);
+    ASSERT_NE(findConfigPreset("fast"), nullptr);
+    ASSERT_NE(findConfigPreset("aggressive"), nullptr);
+    EXPECT_EQ(findConfigPreset("bogus"), nullptr);
+}
+
+TEST(ConfigPresetTest, ApplyPresetSetsFields) {
+    MorphectConfig config;
+    ASSERT_TRUE(config.applyPreset("aggressive"));
+    EXPECT_TRUE(config.enable_cff);
+    EXPECT_TRUE(config.enable_bogus_cf);
+    EXPECT_EQ(config.mba_nesting_depth, 2);
+
+    // Unknown preset leaves the config untouched
+    MorphectConfig untouched;
+    EXPECT_FALSE(untouched.applyPreset("nope"));
+    EXPECT_FALSE(untouched.enable_cff);
+}
+
+TEST(ConfigPresetTest, FastPresetDisablesHeavyPasses) {
+    MorphectConfig config;
+    config.applyFastPreset();
+    EXPECT_TRUE(config.enable_mba);
+    EXPECT_EQ(config.mba_complexity, "low");
+    EXPECT_FALSE(config.enable_cff);
+    EXPECT_FALSE(config.enable_string_encoding);
+}
+
+TEST(ConfigCacheTest, WritesAndReloadsCache) {
+    wipeConfigDir();
+    std::string json = writeJson("cfg.json",
+        R"({"global_probability": 0.5, "random_seed": 99})");
+
+    MorphectConfig first;
+    ASSERT_TRUE(first.loadFromFile(json));
+    EXPECT_DOUBLE_EQ(first.global_probability, 0.5);
+    EXPECT_TRUE(first.use_fixed_seed);
+    EXPECT_EQ(first.random_seed, 99u);
+
+    // The compiled cache sits next to the JSON
+    std::string mcfg = std::string(kConfigDir) + "/cfg.mcfg";
+    ASSERT_TRUE(std::filesystem::exists(mcfg));
+
+    // Second load must come from the cache and agree field-for-field
+    MorphectConfig second;
+    ASSERT_TRUE(second.loadFromCache(json));
+    EXPECT_DOUBLE_EQ(second.global_probability, 0.5);
+    EXPECT_TRUE(second.use_fixed_seed);
+    EXPECT_EQ(second.random_seed, 99u);
+}
+
+TEST(ConfigCacheTest, ChangedJsonInvalidatesCache) {
+    wipeConfigDir();
+    std::string json = writeJson("cfg.json",
+        R"({"global_probability": 0.5})");
+
+    MorphectConfig config;
+    ASSERT_TRUE(config.loadFromFile(json));
+
+    // Rewrite the JSON (different size) - the stale cache must lose
+    writeJson("cfg.json", R"({"global_probability": 0.25})");
+    MorphectConfig reloaded;
+    EXPECT_FALSE(reloaded.loadFromCache(json));
+    ASSERT_TRUE(reloaded.loadFromFile(json));
+    EXPECT_DOUBLE_EQ(reloaded.global_probability, 0.25);
+}
+
+TEST(ConfigCacheTest, RejectsCorruptCache) {
+    wipeConfigDir();
+    std::string json = writeJson("cfg.json", R"({"verbosity": 2})");
+
+    MorphectConfig config;
+    ASSERT_TRUE(config.loadFromFile(json));
+
+    // Truncate the record: load must fall back cleanly
+    std::string mcfg = std::string(kConfigDir) + "/cfg.mcfg";
+    std::filesystem::resize_file(mcfg, 8);
+    MorphectConfig reloaded;
+    EXPECT_FALSE(reloaded.loadFromCache(json));
+    EXPECT_TRUE(reloaded.loadFromFile(json));
+    EXPECT_EQ(reloaded.verbosity, 2);
+}
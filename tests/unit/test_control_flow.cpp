@@ -1591,3 +1591,409 @@ TEST_F(CallStackObfEdgeCasesTest, IntrinsicsSkipped) {
     EXPECT_TRUE(result.success);
     EXPECT_EQ(result.calls_proxied, 0);  // Intrinsics not proxied
 }
+
+// ============================================================================
+// Call Site Index Tests
+// ============================================================================
+
+class CallSiteIndexTest : public ::testing::Test {
+protected:
+    LLVMCallSiteAnalyzer analyzer_;
+
+    std::vector<std::string> module_ = {
+        "declare i32 @external_func(i32)",
+        "",
+        "define i32 @compute(i32 %x) {",
+        "entry:",
+        "  %a = call i32 @external_func(i32 %x)",
+        "  %b = call i32 @external_func(i32 %a)",
+        "  ret i32 %b",
+        "}",
+        "",
+        "define void @main() {",
+        "entry:",
+        "  %r = call i32 @compute(i32 5)",
+        "  call void @llvm.donothing()",
+        "  ret void",
+        "}"
+    };
+
+    void SetUp() override {
+        GlobalRandom::setSeed(55555);
+    }
+};
+
+TEST_F(CallSiteIndexTest, MatchesSeparateScans) {
+    auto calls = analyzer_.findCalls(module_);
+    auto functions = analyzer_.extractFunctions(module_);
+
+    auto index = analyzer_.buildIndex(module_);
+
+    ASSERT_EQ(index.calls.size(), calls.size());
+    for (size_t i = 0; i < calls.size(); i++) {
+        EXPECT_EQ(index.calls[i].callee_function, calls[i].callee_function);
+        EXPECT_EQ(index.calls[i].caller_function, calls[i].caller_function);
+        EXPECT_EQ(index.calls[i].line_number, calls[i].line_number);
+    }
+    EXPECT_EQ(index.functions.size(), functions.size());
+    for (const auto& [name, info] : functions) {
+        ASSERT_TRUE(index.functions.find(name) != index.functions.end());
+        EXPECT_EQ(index.functions[name].return_type, info.return_type);
+        EXPECT_EQ(index.functions[name].is_declaration, info.is_declaration);
+    }
+}
+
+TEST_F(CallSiteIndexTest, GroupsByCallerAndCallee) {
+    auto index = analyzer_.buildIndex(module_);
+
+    ASSERT_EQ(index.calls_by_caller["compute"].size(), 2u);
+    ASSERT_EQ(index.calls_by_caller["main"].size(), 1u);
+    ASSERT_EQ(index.calls_by_callee["external_func"].size(), 2u);
+    ASSERT_EQ(index.calls_by_callee["compute"].size(), 1u);
+
+    // Indices point back into the calls vector
+    int idx = index.calls_by_callee["compute"][0];
+    EXPECT_EQ(index.calls[idx].caller_function, "main");
+}
+
+TEST_F(CallSiteIndexTest, ArgumentShape) {
+    auto index = analyzer_.buildIndex(module_);
+
+    ASSERT_FALSE(index.calls.empty());
+    // %a = call i32 @external_func(i32 %x)
+    EXPECT_EQ(CallSiteIndex::argumentShape(index.calls[0]), "i32(i32)");
+}
+
+TEST_F(CallSiteIndexTest, CallStackObfConsumesPrebuiltIndex) {
+    auto index = analyzer_.buildIndex(module_);
+
+    LLVMCallStackObfTransformation transformer;
+    CallStackObfConfig config;
+    config.enabled = true;
+    config.proxy_probability = 1.0;
+    config.fake_call_probability = 0.0;
+
+    auto result = transformer.transform(module_, index, config);
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.calls_proxied, static_cast<int>(index.calls.size()));
+    EXPECT_GT(result.proxy_functions_created, 0);
+}
+
+// ============================================================================
+// Jump Table Manager Tests
+// ============================================================================
+
+class JumpTableManagerTest : public ::testing::Test {
+protected:
+    JumpTableManager manager_;
+
+    JumpTable makeTable(const std::vector<std::string>& targets) {
+        JumpTable table;
+        table.real_entries = targets.size();
+        for (size_t i = 0; i < targets.size(); i++) {
+            JumpTableEntry entry;
+            entry.original_index = static_cast<int>(i);
+            entry.obfuscated_index = static_cast<int>(i);
+            entry.target_label = targets[i];
+            table.entries.push_back(entry);
+        }
+        table.table_size = table.entries.size();
+        return table;
+    }
+
+    void SetUp() override {
+        GlobalRandom::setSeed(13579);
+    }
+};
+
+TEST_F(JumpTableManagerTest, IdenticalTablesShareSlots) {
+    JumpTable a = makeTable({"bb1", "bb2"});
+    JumpTable b = makeTable({"bb1", "bb2"});
+
+    size_t base_a = manager_.registerTable(a);
+    size_t base_b = manager_.registerTable(b);
+
+    EXPECT_EQ(base_a, base_b);
+    EXPECT_EQ(manager_.size(), 2u);
+    EXPECT_EQ(manager_.tablesDeduped(), 1);
+    EXPECT_EQ(manager_.bytesSaved(), 16);  // 2 entries x 8 bytes
+}
+
+TEST_F(JumpTableManagerTest, ContainedTableReusesSlots) {
+    size_t base_big = manager_.registerTable(makeTable({"bb1", "bb2", "bb3"}));
+    size_t base_sub = manager_.registerTable(makeTable({"bb2", "bb3"}));
+
+    EXPECT_EQ(base_big, 0u);
+    EXPECT_EQ(base_sub, 1u);
+    EXPECT_EQ(manager_.size(), 3u);
+    EXPECT_EQ(manager_.tablesDeduped(), 1);
+}
+
+TEST_F(JumpTableManagerTest, OverlappingTableAppendsOnlyTail) {
+    manager_.registerTable(makeTable({"bb1", "bb2"}));
+    size_t base = manager_.registerTable(makeTable({"bb2", "bb3"}));
+
+    // "bb2" is shared between the two tables
+    EXPECT_EQ(base, 1u);
+    EXPECT_EQ(manager_.size(), 3u);
+    EXPECT_EQ(manager_.content()[1], "bb2");
+    EXPECT_EQ(manager_.content()[2], "bb3");
+    EXPECT_EQ(manager_.bytesSaved(), 8);
+}
+
+TEST_F(JumpTableManagerTest, DisjointTablesAppend) {
+    size_t base_a = manager_.registerTable(makeTable({"bb1", "bb2"}));
+    size_t base_b = manager_.registerTable(makeTable({"bb3", "bb4"}));
+
+    EXPECT_EQ(base_a, 0u);
+    EXPECT_EQ(base_b, 2u);
+    EXPECT_EQ(manager_.size(), 4u);
+    EXPECT_EQ(manager_.tablesDeduped(), 0);
+    EXPECT_EQ(manager_.bytesSaved(), 0);
+}
+
+TEST_F(JumpTableManagerTest, TransformEmitsOneSharedTable) {
+    GlobalRandom::setSeed(99999);
+
+    LLVMBranchAnalyzer analyzer;
+    LLVMIndirectBranchTransformation transformer;
+    IndirectBranchConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.add_decoy_entries = false;
+    config.shuffle_entries = false;
+    config.use_mba_for_index = false;
+    config.index_strategy = IndexObfStrategy::Direct;
+    config.dedupe_tables = true;
+
+    // Two functions with the same single-target branch shape
+    std::vector<std::string> lines = {
+        "define void @f() {",
+        "entry:",
+        "  br label %done",
+        "done:",
+        "  ret void",
+        "}",
+        "define void @g() {",
+        "entry:",
+        "  br label %done",
+        "done:",
+        "  ret void",
+        "}"
+    };
+
+    auto branches = analyzer.findBranches(lines);
+    ASSERT_EQ(branches.size(), 2u);
+
+    auto result = transformer.transform(lines, branches, config);
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.tables_created, 2);
+    EXPECT_EQ(result.tables_deduped, 1);
+    EXPECT_GT(result.table_bytes_saved, 0);
+
+    // Exactly one table declaration, named after the shared table
+    int declarations = 0;
+    for (const auto& line : result.transformed_code) {
+        if (line.find("unnamed_addr constant") != std::string::npos) {
+            declarations++;
+            EXPECT_TRUE(line.find("@" + config.shared_table_name) == 0);
+        }
+    }
+    EXPECT_EQ(declarations, 1);
+}
+
+// ============================================================================
+// Proxy Pool Tests
+// ============================================================================
+
+class ProxyPoolTest : public ::testing::Test {
+protected:
+    ProxyPool pool_;
+
+    ProxyFunctionInfo makeProxy(const std::string& name) {
+        ProxyFunctionInfo proxy;
+        proxy.name = name;
+        proxy.return_type = "i32";
+        return proxy;
+    }
+
+    void SetUp() override {
+        GlobalRandom::setSeed(24680);
+    }
+};
+
+TEST_F(ProxyPoolTest, SameSignatureSharesOneProxy) {
+    const auto& a = pool_.acquire("i32(i32)", 1,
+        [&]() { return makeProxy("_proxy_0"); });
+    const auto& b = pool_.acquire("i32(i32)", 1,
+        [&]() { return makeProxy("_proxy_1"); });
+
+    EXPECT_EQ(a.name, "_proxy_0");
+    EXPECT_EQ(b.name, "_proxy_0");  // Second create() never runs
+    EXPECT_EQ(pool_.proxies().size(), 1u);
+    EXPECT_EQ(pool_.reused(), 1);
+}
+
+TEST_F(ProxyPoolTest, FanoutAllowsDiversity) {
+    pool_.acquire("i32(i32)", 2, [&]() { return makeProxy("_proxy_0"); });
+    pool_.acquire("i32(i32)", 2, [&]() { return makeProxy("_proxy_1"); });
+    const auto& third = pool_.acquire("i32(i32)", 2,
+        [&]() { return makeProxy("_proxy_2"); });
+
+    EXPECT_EQ(pool_.proxies().size(), 2u);
+    EXPECT_EQ(pool_.reused(), 1);
+    // Third call site gets one of the two pooled proxies
+    EXPECT_TRUE(third.name == "_proxy_0" || third.name == "_proxy_1");
+}
+
+TEST_F(ProxyPoolTest, DistinctSignaturesGetDistinctProxies) {
+    pool_.acquire("i32(i32)", 1, [&]() { return makeProxy("_proxy_0"); });
+    pool_.acquire("void(i8*)", 1, [&]() { return makeProxy("_proxy_1"); });
+
+    EXPECT_EQ(pool_.proxies().size(), 2u);
+    EXPECT_EQ(pool_.reused(), 0);
+}
+
+TEST_F(ProxyPoolTest, TransformPoolsSameShapeCallSites) {
+    LLVMCallStackObfTransformation transformer;
+    CallStackObfConfig config;
+    config.enabled = true;
+    config.proxy_probability = 1.0;
+    config.fake_call_probability = 0.0;
+
+    std::vector<std::string> lines = {
+        "define i32 @use(i32 %x) {",
+        "entry:",
+        "  %a = call i32 @first(i32 %x)",
+        "  %b = call i32 @second(i32 %a)",
+        "  %c = call i32 @third(i32 %b)",
+        "  ret i32 %c",
+        "}"
+    };
+
+    auto result = transformer.transform(lines, config);
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.calls_proxied, 3);
+    EXPECT_EQ(result.proxy_functions_created, 1);  // One i32(i32) proxy
+    EXPECT_EQ(result.proxy_calls_pooled, 2);
+
+    // Definitions live in one contiguous section
+    bool found_section = false;
+    for (const auto& line : result.transformed_code) {
+        if (line.find("; Proxy section (1 proxies)") != std::string::npos) {
+            found_section = true;
+            break;
+        }
+    }
+    EXPECT_TRUE(found_section);
+}
+
+// ============================================================================
+// Flat Function Table Tests
+// ============================================================================
+
+class FlatFunctionTableTest : public ::testing::Test {
+protected:
+    FunctionTable makeTable(const std::vector<std::string>& names) {
+        FunctionTable table;
+        table.global_xor_key = 0x1234;
+        int index = 0;
+        for (const auto& name : names) {
+            FunctionTableEntry entry;
+            entry.index = index++;
+            entry.function_name = name;
+            entry.function_type = "i32 (i32)";
+            table.entries.push_back(entry);
+        }
+        table.real_functions = table.entries.size();
+        table.table_size = table.entries.size();
+        return table;
+    }
+
+    void SetUp() override {
+        GlobalRandom::setSeed(11223);
+    }
+};
+
+TEST_F(FlatFunctionTableTest, FindsEveryEntry) {
+    std::vector<std::string> names = {"alpha", "beta", "gamma", "delta", "epsilon"};
+    FlatFunctionTable flat;
+    flat.build(makeTable(names));
+
+    for (const auto& name : names) {
+        const auto* entry = flat.find(name);
+        ASSERT_NE(entry, nullptr) << name;
+        EXPECT_EQ(entry->function_name, name);
+        // The stored index is the entry's slot in the flat array
+        EXPECT_EQ(entry->index, entry->index & static_cast<int>(flat.capacity() - 1));
+    }
+    EXPECT_EQ(flat.find("missing"), nullptr);
+}
+
+TEST_F(FlatFunctionTableTest, CapacityIsPowerOfTwoAndHalfFull) {
+    FlatFunctionTable flat;
+    flat.build(makeTable({"a", "b", "c", "d", "e", "f"}));
+
+    EXPECT_EQ(flat.capacity() & (flat.capacity() - 1), 0u);
+    EXPECT_GE(flat.capacity(), 12u);  // At most half full
+}
+
+TEST_F(FlatFunctionTableTest, ApplyLayoutFillsEmptySlots) {
+    FunctionTable table = makeTable({"alpha", "beta"});
+    FlatFunctionTable flat;
+    flat.build(table);
+    flat.applyLayout(table);
+
+    EXPECT_EQ(table.table_size, flat.capacity());
+    EXPECT_EQ(table.entries.size(), flat.capacity());
+
+    // Every slot is callable: real entries keep their name, empty
+    // slots are decoys pointing at a real function
+    for (const auto& entry : table.entries) {
+        EXPECT_FALSE(entry.function_name.empty());
+        if (entry.is_decoy) {
+            EXPECT_EQ(entry.decoy_target, entry.function_name);
+        }
+    }
+}
+
+TEST_F(FlatFunctionTableTest, TransformEmitsSlotArray) {
+    LLVMIndirectCallTransformation transformer;
+    LLVMCallSiteAnalyzer analyzer;
+    IndirectCallConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.add_decoy_entries = false;
+    config.shuffle_entries = false;
+    config.use_flat_table = true;
+
+    std::vector<std::string> lines = {
+        "define i32 @main() {",
+        "entry:",
+        "  %a = call i32 @compute(i32 1)",
+        "  ret i32 %a",
+        "}",
+        "define i32 @compute(i32 %x) {",
+        "entry:",
+        "  ret i32 %x",
+        "}"
+    };
+
+    auto calls = analyzer.findCalls(lines);
+    auto functions = analyzer.extractFunctions(lines);
+    auto result = transformer.transform(lines, calls, functions, config);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.calls_transformed, 1);
+    // Emitted table spans the whole slot array
+    EXPECT_EQ(result.table.table_size & (result.table.table_size - 1), 0u);
+
+    bool found_flat_comment = false;
+    for (const auto& line : result.transformed_code) {
+        if (line.find("flat, open-addressed") != std::string::npos) {
+            found_flat_comment = true;
+            break;
+        }
+    }
+    EXPECT_TRUE(found_flat_comment);
+}
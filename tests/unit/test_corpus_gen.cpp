@@ -0,0 +1,142 @@
+/**
+ * Morphect - Synthetic Corpus Generator Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/corpus_gen.hpp"
+#include "common/asm_scan.hpp"
+#include "passes/cff/cff.hpp"
+
+using namespace morphect;
+
+namespace {
+
+std::vector<std::string> joinModule(const CorpusGenerator& gen, bool ir) {
+    std::vector<std::string> lines = ir ? gen.irPrelude() : gen.asmPrelude();
+    for (int f = 0; f < gen.shape().functions; f++) {
+        auto fn = ir ? gen.irFunction(f) : gen.asmFunction(f);
+        lines.insert(lines.end(), fn.begin(), fn.end());
+    }
+    return lines;
+}
+
+} // namespace
+
+TEST(CorpusGeneratorTest, DeterministicPerSeedAndIndex) {
+    CorpusShape shape;
+    shape.seed = 1234;
+
+    CorpusGenerator a(shape);
+    CorpusGenerator b(shape);
+    EXPECT_EQ(a.irFunction(7), b.irFunction(7));
+    EXPECT_EQ(a.asmFunction(7), b.asmFunction(7));
+
+    // Streaming order must not matter: index alone picks the bytes
+    auto late_first = b.irFunction(9);
+    EXPECT_EQ(a.irFunction(9), late_first);
+
+    shape.seed = 1235;
+    CorpusGenerator c(shape);
+    EXPECT_NE(a.irFunction(7), c.irFunction(7));
+}
+
+TEST(CorpusGeneratorTest, IRFunctionsParseIntoCFG) {
+    CorpusShape shape;
+    shape.min_blocks = 3;
+    shape.max_blocks = 6;
+
+    CorpusGenerator gen(shape);
+    for (int f = 0; f < 5; f++) {
+        auto fn = gen.irFunction(f);
+
+        cff::LLVMCFGAnalyzer analyzer;
+        auto cfg = analyzer.analyze(fn);
+        ASSERT_TRUE(cfg.has_value()) << "function " << f << " did not parse";
+        EXPECT_GE(static_cast<int>(cfg->blocks.size()), shape.min_blocks);
+        EXPECT_LE(static_cast<int>(cfg->blocks.size()), shape.max_blocks);
+    }
+}
+
+TEST(CorpusGeneratorTest, RespectsInstructionBounds) {
+    CorpusShape shape;
+    shape.min_blocks = 1;
+    shape.max_blocks = 1;
+    shape.min_instructions = 4;
+    shape.max_instructions = 4;
+    shape.mem_weight = 0.0;   // arith-only: one line per instruction
+    shape.call_weight = 0.0;
+    shape.arith_weight = 1.0;
+
+    CorpusGenerator gen(shape);
+    auto fn = gen.irFunction(0);
+
+    // define + entry: + 4 instructions + ret + } + trailing blank
+    ASSERT_EQ(fn.size(), 9u);
+    EXPECT_EQ(fn[0].rfind("define", 0), 0u);
+    EXPECT_EQ(fn[1], "entry:");
+    EXPECT_NE(fn[6].find("ret i32"), std::string::npos);
+}
+
+TEST(CorpusGeneratorTest, AsmMatchesScannerPatterns) {
+    CorpusShape shape;
+    shape.functions = 12;
+    shape.min_blocks = 2;
+    shape.max_blocks = 5;
+
+    CorpusGenerator gen(shape);
+    auto module = joinModule(gen, false);
+
+    auto scan = AsmScanner::scan(module);
+    EXPECT_EQ(scan.functions.size(), 12u);
+    EXPECT_FALSE(scan.labels.empty());
+    EXPECT_FALSE(scan.unconditional_jumps.empty());
+}
+
+TEST(CorpusGeneratorTest, StringTableSizeIsControllable) {
+    CorpusShape shape;
+    shape.strings = 9;
+
+    CorpusGenerator gen(shape);
+
+    int ir_strings = 0;
+    for (const auto& line : gen.irPrelude()) {
+        if (line.find("unnamed_addr constant") != std::string::npos) {
+            ir_strings++;
+        }
+    }
+    EXPECT_EQ(ir_strings, 9);
+
+    int asm_strings = 0;
+    for (const auto& line : gen.asmPrelude()) {
+        if (line.find(".string") != std::string::npos) {
+            asm_strings++;
+        }
+    }
+    EXPECT_EQ(asm_strings, 9);
+}
+
+TEST(CorpusGeneratorTest, BranchesOnlyGoForward) {
+    // Forward-only branches keep the emitted IR phi-free and valid
+    CorpusShape shape;
+    shape.min_blocks = 4;
+    shape.max_blocks = 8;
+
+    CorpusGenerator gen(shape);
+    for (int f = 0; f < 5; f++) {
+        int current_block = 0;
+        for (const auto& line : gen.irFunction(f)) {
+            if (line.size() > 2 && line.rfind("bb", 0) == 0 &&
+                line.back() == ':') {
+                current_block = std::stoi(line.substr(2, line.size() - 3));
+                continue;
+            }
+            size_t pos = 0;
+            while ((pos = line.find("label %bb", pos)) != std::string::npos) {
+                pos += 9;
+                int target = std::stoi(line.substr(pos));
+                EXPECT_GT(target, current_block)
+                    << "backward branch in function " << f << ": " << line;
+            }
+        }
+    }
+}
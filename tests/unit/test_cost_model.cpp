@@ -0,0 +1,90 @@
+/**
+ * Morphect - Cost Model Tests
+ */
+
+#include <gtest/gtest.h>
+#include "core/cost_model.hpp"
+#include "core/pass_manager.hpp"
+
+using namespace morphect;
+
+TEST(CostModelTest, CostTableCoversBuiltins) {
+    EXPECT_GT(passCost(PassId::MBA).cycles, 0.0);
+    EXPECT_GT(passCost(PassId::CFF).bytes, 0.0);
+
+    // Flattened dispatch must rank above a dead block that never runs
+    EXPECT_GT(passCost(PassId::CFF).cycles, passCost(PassId::DeadCode).cycles);
+
+    // Passes the table doesn't know are never budget-gated
+    EXPECT_EQ(passCost(PassId::Unknown).cycles, 0.0);
+}
+
+TEST(CostModelTest, UnlimitedBudgetAlwaysFitsAndPredicts) {
+    CostModel model;
+
+    model.beginFunction();
+    EXPECT_TRUE(model.tryCharge(PassId::CFF, 100, 1.0));
+    EXPECT_TRUE(model.tryCharge(PassId::MBA, 100, 1.0));
+    EXPECT_EQ(model.passesSkipped(), 0u);
+
+    double expected = passCost(PassId::CFF).cycles * 100 +
+                      passCost(PassId::MBA).cycles * 100;
+    EXPECT_DOUBLE_EQ(model.predictedTotal(), expected);
+}
+
+TEST(CostModelTest, BudgetSkipsExpensivePassButKeepsCheaper) {
+    CostModel model;
+    model.setBudget(50.0);
+
+    model.beginFunction();
+    // CFF over 10 statements estimates 120 cycles - over budget
+    EXPECT_FALSE(model.tryCharge(PassId::CFF, 10, 1.0));
+    EXPECT_EQ(model.passesSkipped(), 1u);
+    EXPECT_DOUBLE_EQ(model.spent(), 0.0);  // a skipped pass charges nothing
+
+    // Dead code over the same function estimates 20 cycles - still fits
+    EXPECT_TRUE(model.tryCharge(PassId::DeadCode, 10, 1.0));
+    EXPECT_DOUBLE_EQ(model.spent(), 20.0);
+}
+
+TEST(CostModelTest, BeginFunctionRestoresTheBudget) {
+    CostModel model;
+    model.setBudget(100.0);
+
+    model.beginFunction();
+    EXPECT_TRUE(model.tryCharge(PassId::MBA, 10, 1.0));  // 80 cycles
+    EXPECT_FALSE(model.tryCharge(PassId::MBA, 10, 1.0)); // would be 160
+
+    // Next function starts with the full budget again
+    model.beginFunction();
+    EXPECT_TRUE(model.tryCharge(PassId::MBA, 10, 1.0));
+
+    // The prediction keeps accumulating across functions
+    EXPECT_DOUBLE_EQ(model.predictedTotal(), 160.0);
+}
+
+TEST(CostModelTest, ProbabilityScalesTheEstimate) {
+    CostModel model;
+    model.setBudget(100.0);
+
+    model.beginFunction();
+    // 12 * 10 = 120 at full probability, 60 at half
+    EXPECT_TRUE(model.tryCharge(PassId::CFF, 10, 0.5));
+    EXPECT_DOUBLE_EQ(model.spent(), 60.0);
+}
+
+TEST(CostModelTest, ManagerReportsPredictedVsBudget) {
+    PassManager manager;
+
+    PassConfig config;
+    config.overhead_budget = 500.0;
+    manager.initialize(config);
+
+    std::vector<std::string> lines = {"define i32 @f() {", "  ret i32 0", "}"};
+    manager.runLLVMPasses(lines);
+
+    auto stats = manager.getStatistics();
+    EXPECT_TRUE(stats.has("cost_model.predicted_cycles"));
+    EXPECT_DOUBLE_EQ(stats.getDouble("cost_model.budget_per_function"), 500.0);
+    EXPECT_EQ(stats.getInt("cost_model.passes_skipped_budget"), 0);
+}
@@ -235,6 +235,59 @@ TEST_F(VariableSplittingTest, RespectMaxSplitsLimit) {
     // Note: Each split creates multiple lines with split_ prefix
 }
 
+TEST_F(VariableSplittingTest, ManyLocals_AllUsesRewrittenFromIndex) {
+    // Wide function: every %vK is defined once and used once later, so
+    // the single def-use index has to attribute each use correctly
+    config.max_splits_per_function = 100;
+    config.probability = 1.0;
+    pass.configure(config);
+
+    std::vector<std::string> lines;
+    lines.push_back("define i32 @wide() {");
+    const int kVars = 60;
+    for (int i = 0; i < kVars; i++) {
+        lines.push_back("  %v" + std::to_string(i) + " = add i32 " +
+                        std::to_string(i) + ", 1");
+    }
+    lines.push_back("  %acc0 = add i32 %v0, %v1");
+    for (int i = 1; i < kVars - 1; i++) {
+        lines.push_back("  %acc" + std::to_string(i) + " = add i32 %acc" +
+                        std::to_string(i - 1) + ", %v" + std::to_string(i + 1));
+    }
+    lines.push_back("  ret i32 %acc" + std::to_string(kVars - 2));
+    lines.push_back("}");
+
+    auto result = pass.transformIR(lines);
+    EXPECT_EQ(result, morphect::TransformResult::Success);
+
+    // Every remaining use of a split variable must have been replaced by
+    // a reconstruction; no bare %vK or %accK operand may survive a split
+    std::set<std::string> split_names;
+    for (const auto& line : lines) {
+        size_t pos = line.find("%split_");
+        if (pos != std::string::npos && line.find(" = ") != std::string::npos) {
+            size_t p1 = line.find("_p1_");
+            if (p1 != std::string::npos) {
+                // %split_<name>_p1_<n> -> original was %<name>
+                split_names.insert("%" + line.substr(pos + 7, p1 - (pos + 7)));
+            }
+        }
+    }
+    EXPECT_FALSE(split_names.empty());
+
+    for (const auto& line : lines) {
+        for (const auto& name : split_names) {
+            size_t pos = line.find(name + ",");
+            if (pos == std::string::npos) continue;
+            // A surviving reference is only legal inside a reconstruction
+            // or split assignment line
+            EXPECT_TRUE(line.find("%split_") != std::string::npos ||
+                        line.find("%reconst_") != std::string::npos)
+                << "unrewritten use of " << name << " in: " << line;
+        }
+    }
+}
+
 // ============================================================================
 // Mathematical Correctness of Split Strategies
 // ============================================================================
@@ -625,6 +678,56 @@ TEST_F(ConstantObfuscatorTest, ObfuscateShiftAdd_ProducesValidResult) {
     EXPECT_EQ(reconstructed, 1000);
 }
 
+TEST_F(ConstantObfuscatorTest, Memoize_ReusesExpressionPerValueAndStrategy) {
+    config.memoize = true;
+    config.strategies = {morphect::data::ConstantObfStrategy::XOR};
+    obfuscator.configure(config);
+
+    auto first = obfuscator.obfuscate(42);
+    auto second = obfuscator.obfuscate(42);
+
+    // Same value + same (only) strategy: the decomposition runs once
+    EXPECT_EQ(first.expression, second.expression);
+    EXPECT_EQ(first.parts, second.parts);
+    EXPECT_EQ(obfuscator.memoSize(), 1u);
+
+    obfuscator.obfuscate(43);
+    EXPECT_EQ(obfuscator.memoSize(), 2u);
+}
+
+TEST_F(ConstantObfuscatorTest, MemoizeOff_DerivesFreshExpressions) {
+    config.memoize = false;
+    config.strategies = {morphect::data::ConstantObfStrategy::XOR};
+    obfuscator.configure(config);
+
+    // Fresh random keys per occurrence: a handful of draws must not all
+    // collide
+    bool saw_difference = false;
+    auto first = obfuscator.obfuscate(42);
+    for (int i = 0; i < 5 && !saw_difference; i++) {
+        saw_difference = obfuscator.obfuscate(42).expression != first.expression;
+    }
+    EXPECT_TRUE(saw_difference);
+    EXPECT_EQ(obfuscator.memoSize(), 0u);
+}
+
+TEST_F(ConstantObfuscatorTest, Precompute_WarmsOneEntryPerStrategy) {
+    config.memoize = true;
+    config.strategies = {morphect::data::ConstantObfStrategy::XOR,
+                         morphect::data::ConstantObfStrategy::Split};
+    obfuscator.configure(config);
+
+    obfuscator.precompute({0, 1, 42});
+    EXPECT_EQ(obfuscator.memoSize(), 6u);
+
+    // Transform-time lookups hit the warmed entries, nothing new derives
+    for (int i = 0; i < 10; i++) {
+        auto result = obfuscator.obfuscate(42);
+        EXPECT_EQ(result.original, 42);
+    }
+    EXPECT_EQ(obfuscator.memoSize(), 6u);
+}
+
 // ============================================================================
 // Enhanced String Encoding Tests (Phase 3.5)
 // ============================================================================
@@ -867,6 +970,226 @@ TEST_F(StringEncodingTest, ShouldEncode_RespectsExcludePatterns) {
     EXPECT_TRUE(encoder.shouldEncode("Regular message"));
 }
 
+TEST_F(StringEncodingTest, LongInput_XOR_VectorPathRoundTrips) {
+    // 4097 bytes: full 32-byte blocks plus an odd scalar tail, so both
+    // the vector kernel and the remainder loop are exercised
+    std::string original;
+    for (size_t i = 0; i < 4097; i++) {
+        original += static_cast<char>((i * 37 + 11) & 0xFF);
+    }
+
+    auto encoded = encoder.encodeWithMethod(original, morphect::data::StringEncodingMethod::XOR);
+    ASSERT_EQ(encoded.encoded_bytes.size(), original.length());
+
+    std::string decoded = decodeXOR(encoded.encoded_bytes, encoded.key);
+    EXPECT_EQ(decoded, original);
+}
+
+TEST_F(StringEncodingTest, LongInput_RollingXOR_VectorPathRoundTrips) {
+    std::string original;
+    for (size_t i = 0; i < 1023; i++) {
+        original += static_cast<char>((i * 131 + 7) & 0xFF);
+    }
+
+    auto encoded = encoder.encodeWithMethod(original, morphect::data::StringEncodingMethod::RollingXOR);
+    ASSERT_EQ(encoded.encoded_bytes.size(), original.length());
+
+    std::string decoded = decodeRollingXOR(encoded.encoded_bytes, encoded.key);
+    EXPECT_EQ(decoded, original);
+}
+
+TEST_F(StringEncodingTest, LongInput_MultiByteXOR_KeystreamTilesCorrectly) {
+    // Odd key period so the tiled keystream crosses block boundaries
+    config.multi_byte_key = {0x13, 0x37, 0x5A, 0xA5, 0x0F, 0x42, 0x99};
+    encoder.configure(config);
+
+    std::string original;
+    for (size_t i = 0; i < 2000; i++) {
+        original += static_cast<char>((i * 53 + 3) & 0xFF);
+    }
+
+    auto encoded = encoder.encodeWithMethod(original, morphect::data::StringEncodingMethod::MultiByteXOR);
+    ASSERT_EQ(encoded.encoded_bytes.size(), original.length());
+
+    for (size_t i = 0; i < original.length(); i++) {
+        uint8_t k = config.multi_byte_key[i % config.multi_byte_key.size()];
+        EXPECT_EQ(static_cast<uint8_t>(encoded.encoded_bytes[i] ^ k),
+                  static_cast<uint8_t>(original[i]));
+    }
+}
+
+TEST_F(StringEncodingTest, LongInput_RC4_BatchedKeystreamRoundTrips) {
+    std::string original;
+    for (size_t i = 0; i < 3000; i++) {
+        original += static_cast<char>((i * 97 + 29) & 0xFF);
+    }
+    config.rc4_key = {0xDE, 0xAD, 0xBE, 0xEF};
+    encoder.configure(config);
+
+    auto encoded = encoder.encodeWithMethod(original, morphect::data::StringEncodingMethod::RC4);
+    ASSERT_EQ(encoded.encoded_bytes.size(), original.length());
+
+    // RC4 is symmetric: re-running KSA+PRGA over the ciphertext decrypts
+    std::vector<uint8_t> S(256);
+    for (int i = 0; i < 256; i++) S[i] = static_cast<uint8_t>(i);
+    int j = 0;
+    for (int i = 0; i < 256; i++) {
+        j = (j + S[i] + config.rc4_key[i % config.rc4_key.size()]) & 0xFF;
+        std::swap(S[i], S[j]);
+    }
+    std::string decoded;
+    int ii = 0;
+    j = 0;
+    for (uint8_t c : encoded.encoded_bytes) {
+        ii = (ii + 1) & 0xFF;
+        j = (j + S[ii]) & 0xFF;
+        std::swap(S[ii], S[j]);
+        uint8_t k = S[(S[ii] + S[j]) & 0xFF];
+        decoded += static_cast<char>(c ^ k);
+    }
+    EXPECT_EQ(decoded, original);
+}
+
+// ============================================================================
+// String Interning Tests
+// ============================================================================
+
+class StringInterningTest : public ::testing::Test {
+protected:
+    morphect::data::LLVMStringEncodingPass pass;
+
+    void SetUp() override {
+        morphect::data::StringEncodingConfig config;
+        config.enabled = true;
+        config.xor_key = 0x42;
+        config.min_string_length = 3;
+        pass.configure(config);
+    }
+};
+
+TEST_F(StringInterningTest, DuplicateLiteralsShareOneDefinition) {
+    std::vector<std::string> lines = {
+        "@.str = private unnamed_addr constant [18 x i8] c\"connection timeout\\00\"",
+        "@.str.1 = private unnamed_addr constant [18 x i8] c\"connection timeout\\00\"",
+        "@.str.2 = private unnamed_addr constant [18 x i8] c\"connection timeout\\00\"",
+        "define void @f() {",
+        "  %p = getelementptr inbounds [18 x i8], [18 x i8]* @.str.1, i64 0, i64 0",
+        "  %q = getelementptr inbounds [18 x i8], [18 x i8]* @.str.2, i64 0, i64 0",
+        "  ret void",
+        "}",
+    };
+
+    auto result = pass.transformIR(lines);
+    EXPECT_EQ(result, morphect::TransformResult::Success);
+
+    // Both duplicate definitions are gone, all uses point at @.str
+    std::string joined;
+    for (const auto& l : lines) joined += l + "\n";
+    EXPECT_EQ(joined.find("@.str.1 = "), std::string::npos);
+    EXPECT_EQ(joined.find("@.str.2 = "), std::string::npos);
+    EXPECT_NE(joined.find("@.str, i64 0, i64 0"), std::string::npos);
+    EXPECT_EQ(joined.find("@.str.1,"), std::string::npos);
+    EXPECT_EQ(joined.find("@.str.2,"), std::string::npos);
+}
+
+TEST_F(StringInterningTest, RenamesOnlyWholeTokens) {
+    std::vector<std::string> lines = {
+        "@.str.1 = private unnamed_addr constant [6 x i8] c\"hello\\00\"",
+        "@.str.2 = private unnamed_addr constant [6 x i8] c\"hello\\00\"",
+        "@.str.21 = private unnamed_addr constant [6 x i8] c\"world\\00\"",
+        "  %a = getelementptr [6 x i8], [6 x i8]* @.str.2, i64 0, i64 0",
+        "  %b = getelementptr [6 x i8], [6 x i8]* @.str.21, i64 0, i64 0",
+    };
+
+    pass.transformIR(lines);
+
+    std::string joined;
+    for (const auto& l : lines) joined += l + "\n";
+    // @.str.2 collapses into @.str.1; @.str.21 is distinct content and
+    // must keep its own name
+    EXPECT_NE(joined.find("@.str.1, i64 0"), std::string::npos);
+    EXPECT_NE(joined.find("@.str.21, i64 0"), std::string::npos);
+}
+
+TEST_F(StringInterningTest, DistinctLiteralsKeepSeparateDefinitions) {
+    std::vector<std::string> lines = {
+        "@.a = private unnamed_addr constant [6 x i8] c\"alpha\\00\"",
+        "@.b = private unnamed_addr constant [5 x i8] c\"beta\\00\"",
+    };
+
+    pass.transformIR(lines);
+
+    // Both definitions survive (followed by the shared decoder stage)
+    ASSERT_GE(lines.size(), 2u);
+    EXPECT_EQ(lines[0].find("@.a = "), 0u);
+    EXPECT_EQ(lines[1].find("@.b = "), 0u);
+}
+
+// ============================================================================
+// Shared Decoder Emission Tests
+// ============================================================================
+
+TEST_F(StringInterningTest, EmitsOneDecoderSharedByAllStrings) {
+    std::vector<std::string> lines = {
+        "@.a = private unnamed_addr constant [6 x i8] c\"alpha\\00\"",
+        "@.b = private unnamed_addr constant [5 x i8] c\"beta\\00\"",
+        "@.c = private unnamed_addr constant [6 x i8] c\"gamma\\00\"",
+    };
+
+    auto result = pass.transformIR(lines);
+    EXPECT_EQ(result, morphect::TransformResult::Success);
+
+    std::string joined;
+    size_t declares = 0;
+    for (const auto& l : lines) {
+        joined += l + "\n";
+        if (l.find("declare i8* @__morphect_decode_str") == 0) declares++;
+    }
+
+    // One decoder declaration for the single method in play, not one
+    // per string
+    EXPECT_EQ(declares, 1u);
+    EXPECT_NE(joined.find("declare i8* @__morphect_decode_str(i8*, i64, i8)"),
+              std::string::npos);
+}
+
+TEST_F(StringInterningTest, PacksEveryEncodedStringIntoOneTable) {
+    std::vector<std::string> lines = {
+        "@.a = private unnamed_addr constant [6 x i8] c\"alpha\\00\"",
+        "@.b = private unnamed_addr constant [5 x i8] c\"beta\\00\"",
+    };
+
+    pass.transformIR(lines);
+
+    std::string joined;
+    for (const auto& l : lines) joined += l + "\n";
+
+    // One contiguous table with one { ptr, length, key } record per
+    // encoded string
+    EXPECT_NE(joined.find("@__morphect_str_table = private constant "
+                          "[2 x { i8*, i64, i8 }]"),
+              std::string::npos);
+    EXPECT_NE(joined.find("i8]* @.a, i64 0, i64 0), i64 6, i8 66"),
+              std::string::npos);
+    EXPECT_NE(joined.find("i8]* @.b, i64 0, i64 0), i64 5, i8 66"),
+              std::string::npos);
+}
+
+TEST_F(StringInterningTest, NoDecoderStageWhenNothingEncoded) {
+    std::vector<std::string> lines = {
+        "define void @f() {",
+        "  ret void",
+        "}",
+    };
+
+    pass.transformIR(lines);
+
+    std::string joined;
+    for (const auto& l : lines) joined += l + "\n";
+    EXPECT_EQ(joined.find("@__morphect_str_table"), std::string::npos);
+    EXPECT_EQ(joined.find("declare i8* @__morphect_decode_str"), std::string::npos);
+}
+
 // ============================================================================
 // String Encoding Mathematical Correctness Tests
 // ============================================================================
@@ -1161,3 +1484,119 @@ TEST_F(VariableSplittingCoverageTest, AllThreeStrategies_Sequential) {
                     result == morphect::TransformResult::NotApplicable);
     }
 }
+
+// ============================================================================
+// Expansion Budget Tests
+// ============================================================================
+
+class ExpansionBudgetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        morphect::GlobalRandom::setSeed(7);
+    }
+
+    // One function whose body is n constant-bearing instructions
+    std::vector<std::string> makeConstantHeavyFunction(int n) {
+        std::vector<std::string> lines;
+        lines.push_back("define i32 @hot(i32 %a) {");
+        for (int i = 0; i < n; i++) {
+            lines.push_back("  %v" + std::to_string(i) + " = add i32 %a, " +
+                            std::to_string(40 + i));
+        }
+        lines.push_back("  ret i32 %v0");
+        lines.push_back("}");
+        return lines;
+    }
+};
+
+TEST_F(ExpansionBudgetTest, ConstantObf_StopsAtFunctionBudget) {
+    LLVMConstantObfPass pass;
+    ConstantObfConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.strategies = {ConstantObfStrategy::Split};
+    config.max_expansion_ratio = 1.5;
+    pass.configure(config);
+
+    auto lines = makeConstantHeavyFunction(20);
+    size_t input = lines.size();
+    pass.transformIR(lines);
+
+    auto stats = pass.getStatistics();
+    // Some constants decompose, then the budget cuts the pass off
+    EXPECT_GT(stats["constants_obfuscated"], 0);
+    EXPECT_GT(stats["budget_exhausted"], 0);
+    EXPECT_LE(lines.size(), input * 3 / 2 + 2);
+    EXPECT_GE(stats["expansion_percent"], 100);
+}
+
+TEST_F(ExpansionBudgetTest, ConstantObf_UnlimitedByDefault) {
+    LLVMConstantObfPass pass;
+    ConstantObfConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.strategies = {ConstantObfStrategy::Split};
+    pass.configure(config);
+
+    auto lines = makeConstantHeavyFunction(20);
+    pass.transformIR(lines);
+
+    auto stats = pass.getStatistics();
+    EXPECT_EQ(stats["constants_obfuscated"], 20);
+    EXPECT_EQ(stats.count("budget_exhausted"), 0u);
+}
+
+TEST_F(ExpansionBudgetTest, VarSplit_TrimsSelectionToBudget) {
+    LLVMVariableSplittingPass pass;
+    VariableSplittingConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.default_strategy = SplitStrategy::Additive;
+    config.split_phi_nodes = false;
+    config.max_splits_per_function = 10;
+    config.max_expansion_ratio = 1.2;
+    pass.configure(config);
+
+    // 20 variables, each one definition plus one use: a split costs
+    // four extra lines, so a 20% budget on ~41 body lines fits two
+    std::vector<std::string> lines = {"define i32 @wide(i32 %x) {"};
+    for (int i = 0; i < 20; i++) {
+        lines.push_back("  %a" + std::to_string(i) + " = add i32 %x, " +
+                        std::to_string(i + 2));
+        lines.push_back("  %b" + std::to_string(i) + " = mul i32 %a" +
+                        std::to_string(i) + ", 3");
+    }
+    lines.push_back("  ret i32 %x");
+    lines.push_back("}");
+    size_t input = lines.size();
+
+    pass.transformIR(lines);
+
+    auto stats = pass.getStatistics();
+    EXPECT_GT(stats["variables_split"], 0);
+    EXPECT_GT(stats["budget_skipped"], 0);
+    EXPECT_LE(lines.size(), input + input / 5);
+}
+
+TEST_F(ExpansionBudgetTest, VarSplit_ReportsRealizedExpansion) {
+    LLVMVariableSplittingPass pass;
+    VariableSplittingConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.default_strategy = SplitStrategy::Additive;
+    config.split_phi_nodes = false;
+    pass.configure(config);
+
+    std::vector<std::string> lines = {
+        "define i32 @f(i32 %x) {",
+        "  %y = add i32 %x, 1",
+        "  %z = mul i32 %y, 2",
+        "  ret i32 %z",
+        "}",
+    };
+    pass.transformIR(lines);
+
+    auto stats = pass.getStatistics();
+    ASSERT_EQ(stats.count("expansion_percent"), 1u);
+    EXPECT_GE(stats["expansion_percent"], 100);
+}
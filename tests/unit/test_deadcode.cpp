@@ -10,6 +10,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <set>
 #include "passes/deadcode/deadcode.hpp"
 #include "common/random.hpp"
 
@@ -343,21 +344,62 @@ TEST_F(DeadCodeTest, MBADeadCodeGenerator_UsesMBAPattern) {
     std::vector<VariableInfo> vars;
     DeadCodeBlock block = gen.generate(vars, config);
 
-    // MBA pattern: a + b = (a ^ b) + 2*(a & b)
-    // Should have xor, and, and shl (for multiplication by 2)
-    bool has_xor = false;
-    bool has_and = false;
-    bool has_shl = false;
-
+    // Blocks are pre-expanded through the MBA variant tables, so the
+    // body must contain boolean/arithmetic mixing beyond the two
+    // initializer adds - which exact identity shows up depends on the
+    // sampled variant
+    int mba_ops = 0;
     for (const auto& line : block.code) {
-        if (line.find(" xor ") != std::string::npos) has_xor = true;
-        if (line.find(" and ") != std::string::npos) has_and = true;
-        if (line.find(" shl ") != std::string::npos) has_shl = true;
+        if (line.find(" xor ") != std::string::npos ||
+            line.find(" and ") != std::string::npos ||
+            line.find(" or ") != std::string::npos ||
+            line.find(" shl ") != std::string::npos ||
+            line.find(" sub ") != std::string::npos ||
+            line.find(" mul ") != std::string::npos) {
+            mba_ops++;
+        }
     }
+    EXPECT_GE(mba_ops, 2);
+}
 
-    EXPECT_TRUE(has_xor);
-    EXPECT_TRUE(has_and);
-    EXPECT_TRUE(has_shl);
+TEST_F(DeadCodeTest, MBADeadCodeGenerator_EmitsPreExpandedBlocks) {
+    MBADeadCodeGenerator gen;
+    DeadCodeConfig config;
+    std::vector<VariableInfo> vars;
+
+    // Every generated block must already be in its final MBA form: no
+    // bare seed instruction left over, and every created value tagged
+    // with the %_mba_ prefix the MBA pass skips
+    for (int i = 0; i < 10; i++) {
+        DeadCodeBlock block = gen.generate(vars, config);
+        ASSERT_GE(block.code.size(), 5u);  // comment + 2 inits + expansion
+        for (const auto& name : block.vars_created) {
+            EXPECT_EQ(name.rfind("%_mba_", 0), 0u) << name;
+        }
+    }
+}
+
+TEST_F(DeadCodeTest, MBADeadCodeGenerator_DrawsMultipleVariants) {
+    MBADeadCodeGenerator gen;
+    DeadCodeConfig config;
+    std::vector<VariableInfo> vars;
+
+    // Drawing from the variant tables should produce more than the one
+    // hardcoded identity shape across a batch of generations
+    std::set<size_t> body_sizes;
+    std::set<std::string> seed_ops;
+    for (int i = 0; i < 30; i++) {
+        DeadCodeBlock block = gen.generate(vars, config);
+        body_sizes.insert(block.code.size());
+        ASSERT_FALSE(block.code.empty());
+        // The leading comment names the seed operation
+        size_t paren = block.code[0].find("pre-expanded ");
+        if (paren != std::string::npos) {
+            seed_ops.insert(block.code[0].substr(paren));
+        }
+    }
+    EXPECT_GT(seed_ops.size(), 1u);
+    EXPECT_GT(body_sizes.size(), 1u);
 }
 
 TEST_F(DeadCodeTest, MBADeadCodeGenerator_CreatesChainedOps) {
@@ -817,3 +859,204 @@ TEST_F(DeadCodeTest, EdgeCase_MinMaxBlocks) {
     EXPECT_GE(result.blocks_inserted, 0);  // May be 0 if no insertion points
     EXPECT_LE(result.blocks_inserted, config.max_blocks);
 }
+
+// ============================================================================
+// Expansion Budget Tests
+// ============================================================================
+
+TEST_F(DeadCodeTest, ExpansionBudget_SkipsInsertionsOverBudget) {
+    LLVMDeadCodeTransformation transform;
+    DeadCodeConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.min_blocks = 4;
+    config.max_blocks = 4;
+    // A guarded block is ~8 lines; 20% of the ~20-line sample function
+    // never fits one, so every insertion must be skipped
+    config.max_expansion_ratio = 1.2;
+
+    auto original = getSampleIR();
+    auto result = transform.transform(original, config);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.blocks_inserted, 0);
+    EXPECT_GT(result.blocks_budget_skipped, 0);
+    EXPECT_EQ(result.transformed_code.size(), original.size());
+}
+
+TEST_F(DeadCodeTest, ExpansionBudget_GenerousRatioStillInserts) {
+    LLVMDeadCodeTransformation transform;
+    DeadCodeConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.min_blocks = 2;
+    config.max_blocks = 4;
+    config.max_expansion_ratio = 10.0;
+
+    auto original = getSampleIR();
+    auto result = transform.transform(original, config);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_GT(result.blocks_inserted, 0);
+    EXPECT_EQ(result.blocks_budget_skipped, 0);
+}
+
+// ============================================================================
+// Block Pool Tests
+// ============================================================================
+
+TEST_F(DeadCodeTest, BlockPool_BuildsBucketPerGenerator) {
+    DeadArithmeticGenerator arith;
+    DeadMemoryGenerator mem;
+    DeadCodeBlockPool pool;
+    DeadCodeConfig config;
+    config.block_pool_size = 20;
+
+    pool.build({&arith, &mem}, config);
+
+    EXPECT_TRUE(pool.ready());
+    EXPECT_EQ(pool.size(), 20u);
+}
+
+TEST_F(DeadCodeTest, BlockPool_InstantiationsGetFreshNames) {
+    MBADeadCodeGenerator mba;
+    DeadCodeBlockPool pool;
+    DeadCodeConfig config;
+    config.block_pool_size = 1;
+
+    pool.build({&mba}, config);
+
+    auto first = pool.instantiate(mba.getName());
+    auto second = pool.instantiate(mba.getName());
+    ASSERT_FALSE(first.code.empty());
+    ASSERT_FALSE(second.code.empty());
+
+    // Same template, but no SSA name may repeat across instantiations
+    for (const auto& name : first.vars_created) {
+        for (const auto& other : second.vars_created) {
+            EXPECT_NE(name, other);
+        }
+    }
+
+    // No placeholder may survive substitution
+    for (const auto& line : first.code) {
+        EXPECT_EQ(line.find("__tpl"), std::string::npos) << line;
+    }
+}
+
+TEST_F(DeadCodeTest, BlockPool_FreshensNopFunctionNames) {
+    DeadCallGenerator calls;
+    DeadCodeBlockPool pool;
+    DeadCodeConfig config;
+    config.block_pool_size = 1;
+
+    pool.build({&calls}, config);
+
+    auto first = pool.instantiate(calls.getName());
+    auto second = pool.instantiate(calls.getName());
+    ASSERT_FALSE(first.nop_functions_created.empty());
+
+    // Distinct nop names per instantiation, and the call lines must
+    // reference exactly the freshened names
+    for (const auto& name : first.nop_functions_created) {
+        for (const auto& other : second.nop_functions_created) {
+            EXPECT_NE(name, other);
+        }
+        bool referenced = false;
+        for (const auto& line : first.code) {
+            if (line.find("@" + name) != std::string::npos) referenced = true;
+        }
+        EXPECT_TRUE(referenced) << name;
+    }
+}
+
+TEST_F(DeadCodeTest, BlockPool_TransformUsesPool) {
+    LLVMDeadCodeTransformation transform;
+    DeadCodeConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.min_blocks = 2;
+    config.max_blocks = 4;
+    config.use_block_pool = true;
+    config.block_pool_size = 32;
+
+    auto result = transform.transform(getSampleIR(), config);
+
+    ASSERT_TRUE(result.success);
+    EXPECT_GT(result.blocks_inserted, 0);
+
+    // Pooled temps carry the _pool prefix and never a raw placeholder
+    bool saw_pool_name = false;
+    for (const auto& line : result.transformed_code) {
+        if (line.find("%_pool") != std::string::npos) saw_pool_name = true;
+        EXPECT_EQ(line.find("__tpl"), std::string::npos) << line;
+    }
+    EXPECT_TRUE(saw_pool_name);
+}
+
+// ============================================================================
+// Compact Profile Tests
+// ============================================================================
+
+TEST_F(DeadCodeTest, CompactProfile_ArithmeticAnchoredByVolatileSink) {
+    DeadArithmeticGenerator gen;
+    DeadCodeConfig config;
+    config.compact_profile = true;
+
+    std::vector<VariableInfo> vars;
+    DeadCodeBlock block = gen.generate(vars, config);
+
+    // The chain must end in a volatile store so -O2 cannot fold it away
+    ASSERT_GE(block.code.size(), 2u);
+    EXPECT_NE(block.code[block.code.size() - 2].find("_dead_sink"),
+              std::string::npos);
+    EXPECT_NE(block.code.back().find("store volatile i32 "),
+              std::string::npos);
+}
+
+TEST_F(DeadCodeTest, CompactProfile_MemoryUsesVolatileAccesses) {
+    DeadMemoryGenerator gen;
+    DeadCodeConfig config;
+    config.compact_profile = true;
+
+    std::vector<VariableInfo> vars;
+    DeadCodeBlock block = gen.generate(vars, config);
+
+    // Every load/store in a compact block is volatile
+    for (const auto& line : block.code) {
+        if (line.find(" load ") != std::string::npos ||
+            line.find("  store ") != std::string::npos) {
+            EXPECT_NE(line.find("volatile"), std::string::npos) << line;
+        }
+    }
+}
+
+TEST_F(DeadCodeTest, CompactProfile_MBABlockKeepsSink) {
+    MBADeadCodeGenerator gen;
+    DeadCodeConfig config;
+    config.compact_profile = true;
+
+    std::vector<VariableInfo> vars;
+    DeadCodeBlock block = gen.generate(vars, config);
+
+    EXPECT_NE(block.code.back().find("store volatile i32 %_mba_res"),
+              std::string::npos);
+}
+
+TEST_F(DeadCodeTest, CompactProfile_InsertsFewerBlocks) {
+    LLVMDeadCodeTransformation transform;
+    DeadCodeConfig config;
+    config.enabled = true;
+    config.probability = 1.0;
+    config.min_blocks = 4;
+    config.max_blocks = 4;
+    config.compact_profile = true;
+
+    auto original = getSampleIR();
+    auto result = transform.transform(original, config);
+
+    // Compact halves the insertion count the sampler picked
+    ASSERT_TRUE(result.success);
+    EXPECT_GT(result.blocks_inserted, 0);
+    EXPECT_LE(result.blocks_inserted, 2);
+}
@@ -0,0 +1,97 @@
+/**
+ * Morphect - Function Interval Index Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/function_intervals.hpp"
+
+using namespace morphect;
+
+namespace {
+
+FunctionIntervalIndex makeIndex() {
+    FunctionIntervalIndex index;
+    index.add("foo", 2, 8);
+    index.add("bar", 12, 20);
+    index.add("baz", 25, 25);
+    index.build();
+    return index;
+}
+
+} // namespace
+
+TEST(FunctionIntervalIndexTest, ResolvesLinesInsideRegions) {
+    FunctionIntervalIndex index = makeIndex();
+
+    EXPECT_EQ(index.nameAt(2), "foo");    // first line of region
+    EXPECT_EQ(index.nameAt(5), "foo");
+    EXPECT_EQ(index.nameAt(8), "foo");    // last line of region
+    EXPECT_EQ(index.nameAt(15), "bar");
+    EXPECT_EQ(index.nameAt(25), "baz");   // single-line region
+}
+
+TEST(FunctionIntervalIndexTest, LinesOutsideRegionsAreGlobal) {
+    FunctionIntervalIndex index = makeIndex();
+
+    EXPECT_EQ(index.nameAt(0), "<global>");   // before first region
+    EXPECT_EQ(index.nameAt(10), "<global>");  // gap between regions
+    EXPECT_EQ(index.nameAt(24), "<global>");
+    EXPECT_EQ(index.nameAt(100), "<global>"); // past the last region
+    EXPECT_EQ(index.indexAt(10), FunctionIntervalIndex::npos);
+}
+
+TEST(FunctionIntervalIndexTest, MatchesLinearScanOnManyRegions) {
+    FunctionIntervalIndex index;
+    // 100 regions of 5 lines separated by 1-line gaps, added out of order
+    struct Region { int start; int end; };
+    std::vector<Region> regions;
+    for (int i = 99; i >= 0; i--) {
+        int start = i * 6;
+        regions.push_back({start, start + 4});
+        index.add("func_" + std::to_string(i), start, start + 4);
+    }
+    index.build();
+
+    for (int line = 0; line < 100 * 6; line++) {
+        std::string expected = "<global>";
+        for (size_t i = 0; i < regions.size(); i++) {
+            if (line >= regions[i].start && line <= regions[i].end) {
+                expected = "func_" + std::to_string(99 - i);
+                break;
+            }
+        }
+        EXPECT_EQ(index.nameAt(line), expected) << "line " << line;
+    }
+}
+
+TEST(FunctionIntervalIndexTest, ShiftTracksInsertedLines) {
+    FunctionIntervalIndex index = makeIndex();
+
+    // Insert 3 lines between foo and bar: bar/baz move, foo is untouched
+    index.shiftFrom(10, 3);
+    EXPECT_EQ(index.nameAt(5), "foo");
+    EXPECT_EQ(index.nameAt(15), "bar");
+    EXPECT_EQ(index.nameAt(12), "<global>");
+    EXPECT_EQ(index.nameAt(23), "bar");
+    EXPECT_EQ(index.nameAt(28), "baz");
+}
+
+TEST(FunctionIntervalIndexTest, ShiftInsideRegionGrowsIt) {
+    FunctionIntervalIndex index = makeIndex();
+
+    // Insert 2 lines inside foo: its tail grows, later regions move
+    index.shiftFrom(5, 2);
+    EXPECT_EQ(index.nameAt(4), "foo");
+    EXPECT_EQ(index.nameAt(10), "foo");   // old end 8 is now 10
+    EXPECT_EQ(index.nameAt(11), "<global>");
+    EXPECT_EQ(index.nameAt(14), "bar");
+}
+
+TEST(FunctionIntervalIndexTest, ClearEmptiesTheIndex) {
+    FunctionIntervalIndex index = makeIndex();
+    EXPECT_EQ(index.size(), 3u);
+
+    index.clear();
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.nameAt(5), "<global>");
+}
@@ -0,0 +1,83 @@
+/**
+ * Morphect - Identifier Renamer Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/identifier_renamer.hpp"
+
+using namespace morphect;
+
+TEST(IdentifierRenamerTest, WholeTokenReplacement) {
+    IdentifierRenamer r;
+    r.add("%x", "%y");
+
+    std::string line = "  %sum = add i32 %x, %x1";
+    r.applyToLine(line);
+
+    // %x1 must not be touched even though %x is a prefix of it
+    EXPECT_EQ(line, "  %sum = add i32 %y, %x1");
+}
+
+TEST(IdentifierRenamerTest, MultipleNamesInOneScan) {
+    IdentifierRenamer r;
+    r.add("%a", "%r1");
+    r.add("%b.0", "%r2");
+    r.add("@g", "@h");
+
+    std::string line = "  store i32 %a, i32* @g ; %b.0";
+    r.applyToLine(line);
+    EXPECT_EQ(line, "  store i32 %r1, i32* @h ; %r2");
+}
+
+TEST(IdentifierRenamerTest, AssemblyLabels) {
+    IdentifierRenamer r;
+    r.add("L42", "Lx9f");
+    r.add(".L42", ".Lx9f");
+
+    std::string def = "L42:";
+    std::string ref = "    jmp .L42";
+    r.applyToLine(def);
+    r.applyToLine(ref);
+    EXPECT_EQ(def, "Lx9f:");
+    EXPECT_EQ(ref, "    jmp .Lx9f");
+
+    // L420 is a different token
+    std::string other = "    jmp .L420";
+    r.applyToLine(other);
+    EXPECT_EQ(other, "    jmp .L420");
+}
+
+TEST(IdentifierRenamerTest, NoMatchLeavesLineUntouched) {
+    IdentifierRenamer r;
+    r.add("%very_long_name", "%n");
+
+    std::string line = "  br label %exit";
+    std::string before = line;
+    r.applyToLine(line);
+    EXPECT_EQ(line, before);
+}
+
+TEST(IdentifierRenamerTest, ClearResets) {
+    IdentifierRenamer r;
+    r.add("%x", "%y");
+    EXPECT_EQ(r.size(), 1u);
+    r.clear();
+    EXPECT_TRUE(r.empty());
+
+    std::string line = "  ret i32 %x";
+    r.applyToLine(line);
+    EXPECT_EQ(line, "  ret i32 %x");
+}
+
+TEST(IdentifierRenamerTest, ApplyToLines) {
+    IdentifierRenamer r;
+    r.add("%phi1", "%phi1.loaded");
+
+    std::vector<std::string> lines = {
+        "  %cmp = icmp eq i32 %phi1, 0",
+        "  br i1 %cmp, label %a, label %b",
+    };
+    r.applyToLines(lines);
+    EXPECT_EQ(lines[0], "  %cmp = icmp eq i32 %phi1.loaded, 0");
+    EXPECT_EQ(lines[1], "  br i1 %cmp, label %a, label %b");
+}
@@ -0,0 +1,89 @@
+/**
+ * Morphect - Incremental Cache Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/incremental_cache.hpp"
+
+#include <cstdio>
+
+using namespace morphect;
+
+namespace {
+
+const char* kCacheDir = "/tmp/morphect_cache_test";
+
+void wipeCacheDir() {
+    std::string cmd = std::string("rm -rf ") + kCacheDir;
+    (void)system(cmd.c_str());
+}
+
+} // namespace
+
+TEST(IncrementalCacheTest, HashIsStableAndContentSensitive) {
+    EXPECT_EQ(IncrementalCache::hashText("abc"), IncrementalCache::hashText("abc"));
+    EXPECT_NE(IncrementalCache::hashText("abc"), IncrementalCache::hashText("abd"));
+
+    std::vector<std::string> a = {"x", "y"};
+    std::vector<std::string> b = {"x", "z"};
+    EXPECT_NE(IncrementalCache::hashLines(a), IncrementalCache::hashLines(b));
+
+    // Line boundaries matter: {"ab"} != {"a", "b"}
+    std::vector<std::string> joined = {"ab"};
+    std::vector<std::string> split = {"a", "b"};
+    EXPECT_NE(IncrementalCache::hashLines(joined), IncrementalCache::hashLines(split));
+}
+
+TEST(IncrementalCacheTest, StoreAndLookupRoundTrip) {
+    wipeCacheDir();
+    IncrementalCache cache(kCacheDir);
+    ASSERT_TRUE(cache.valid());
+
+    std::vector<std::string> transformed = {
+        "define i32 @f() {",
+        "  ret i32 42",
+        "}",
+    };
+
+    uint64_t key = IncrementalCache::combine(
+        IncrementalCache::hashLines(transformed), 0x1234);
+
+    EXPECT_FALSE(cache.lookup(key).has_value());
+
+    cache.store(key, transformed);
+
+    auto cached = cache.lookup(key);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(*cached, transformed);
+
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+    EXPECT_EQ(cache.stores(), 1u);
+
+    wipeCacheDir();
+}
+
+TEST(IncrementalCacheTest, PersistsAcrossInstances) {
+    wipeCacheDir();
+
+    uint64_t key = 0xdeadbeef;
+    {
+        IncrementalCache cache(kCacheDir);
+        cache.store(key, {"line"});
+    }
+
+    IncrementalCache reopened(kCacheDir);
+    auto cached = reopened.lookup(key);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ((*cached)[0], "line");
+
+    wipeCacheDir();
+}
+
+TEST(IncrementalCacheTest, InvalidDirIsDisabled) {
+    IncrementalCache cache("/proc/definitely/not/writable");
+    EXPECT_FALSE(cache.valid());
+
+    cache.store(1, {"x"});
+    EXPECT_FALSE(cache.lookup(1).has_value());
+}
@@ -0,0 +1,102 @@
+/**
+ * Morphect - IR Tokenizer Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/ir_tokenizer.hpp"
+
+using namespace morphect;
+
+TEST(IRTokenizerTest, ClassifiesEmptyAndComment) {
+    EXPECT_EQ(IRTokenizer::tokenizeLine("").kind, IRLineKind::Empty);
+    EXPECT_EQ(IRTokenizer::tokenizeLine("   ").kind, IRLineKind::Empty);
+    EXPECT_EQ(IRTokenizer::tokenizeLine("; a comment").kind, IRLineKind::Comment);
+}
+
+TEST(IRTokenizerTest, ParsesDefine) {
+    auto rec = IRTokenizer::tokenizeLine(
+        "define dso_local i32 @main(i32 noundef %0, i8** %1) #0 {");
+
+    EXPECT_EQ(rec.kind, IRLineKind::FunctionBegin);
+    EXPECT_EQ(rec.name, "main");
+    ASSERT_EQ(rec.operands.size(), 2u);
+    EXPECT_EQ(rec.operands[0], "%0");
+    EXPECT_EQ(rec.operands[1], "%1");
+}
+
+TEST(IRTokenizerTest, ParsesInstructionWithResult) {
+    auto rec = IRTokenizer::tokenizeLine("  %5 = add nsw i32 %3, %4");
+
+    EXPECT_EQ(rec.kind, IRLineKind::Instruction);
+    EXPECT_EQ(rec.result, "%5");
+    EXPECT_EQ(rec.opcode, "add");
+    ASSERT_EQ(rec.operands.size(), 2u);
+    EXPECT_EQ(rec.operands[0], "%3");
+    EXPECT_EQ(rec.operands[1], "%4");
+}
+
+TEST(IRTokenizerTest, ParsesInstructionWithoutResult) {
+    auto ret = IRTokenizer::tokenizeLine("  ret i32 %7");
+    EXPECT_EQ(ret.kind, IRLineKind::Instruction);
+    EXPECT_EQ(ret.opcode, "ret");
+    ASSERT_EQ(ret.operands.size(), 1u);
+    EXPECT_EQ(ret.operands[0], "%7");
+
+    auto br = IRTokenizer::tokenizeLine("  br i1 %2, label %3, label %4");
+    EXPECT_EQ(br.kind, IRLineKind::Instruction);
+    EXPECT_EQ(br.opcode, "br");
+    EXPECT_EQ(br.operands.size(), 3u);
+}
+
+TEST(IRTokenizerTest, ParsesLabels) {
+    auto named = IRTokenizer::tokenizeLine("entry:");
+    EXPECT_EQ(named.kind, IRLineKind::Label);
+    EXPECT_EQ(named.name, "entry");
+
+    auto numbered = IRTokenizer::tokenizeLine("42:                ; preds = %1");
+    EXPECT_EQ(numbered.kind, IRLineKind::Label);
+    EXPECT_EQ(numbered.name, "42");
+}
+
+TEST(IRTokenizerTest, ParsesGlobalAndDeclare) {
+    auto global = IRTokenizer::tokenizeLine(
+        "@.str = private unnamed_addr constant [6 x i8] c\"hello\\00\"");
+    EXPECT_EQ(global.kind, IRLineKind::Global);
+    EXPECT_EQ(global.name, ".str");
+
+    auto decl = IRTokenizer::tokenizeLine("declare i32 @printf(i8*, ...)");
+    EXPECT_EQ(decl.kind, IRLineKind::Declare);
+    EXPECT_EQ(decl.name, "printf");
+}
+
+TEST(IRTokenizerTest, SkipsQuotedStringsInOperands) {
+    auto rec = IRTokenizer::tokenizeLine(
+        "  %x = call i32 @f(i8* getelementptr ([4 x i8], [4 x i8]* @.s, i64 0, i64 0))");
+
+    EXPECT_EQ(rec.kind, IRLineKind::Instruction);
+    EXPECT_EQ(rec.opcode, "call");
+    // @f and @.s are operands; nothing from inside string constants
+    ASSERT_GE(rec.operands.size(), 2u);
+    EXPECT_EQ(rec.operands[0], "@f");
+    EXPECT_EQ(rec.operands[1], "@.s");
+}
+
+TEST(IRTokenizerTest, TokenizesWholeModule) {
+    std::vector<std::string> lines = {
+        "; ModuleID = 't.c'",
+        "define i32 @f(i32 %0) {",
+        "  %2 = add i32 %0, 1",
+        "  ret i32 %2",
+        "}",
+    };
+
+    auto records = IRTokenizer::tokenizeModule(lines);
+
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(records[0].kind, IRLineKind::Comment);
+    EXPECT_EQ(records[1].kind, IRLineKind::FunctionBegin);
+    EXPECT_EQ(records[2].kind, IRLineKind::Instruction);
+    EXPECT_EQ(records[2].line, 2u);
+    EXPECT_EQ(records[3].kind, IRLineKind::Instruction);
+    EXPECT_EQ(records[4].kind, IRLineKind::FunctionEnd);
+}
@@ -125,3 +125,83 @@ TEST(JsonParserTest, DefaultValues) {
     EXPECT_EQ(json["nonexistent"].asString("default"), "default");
     EXPECT_EQ(json["nonexistent"].asBool(true), true);
 }
+
+TEST(JsonValueTest, VariantStorageHoldsOnlyActiveAlternative) {
+    // A value is exactly one thing at a time; the others read as defaults
+    JsonValue s("text");
+    EXPECT_TRUE(s.isString());
+    EXPECT_FALSE(s.isNumber());
+    EXPECT_EQ(s.asDouble(1.5), 1.5);
+    EXPECT_EQ(s.asString(), "text");
+
+    JsonValue n(3);
+    EXPECT_EQ(n.type(), JsonType::Number);
+    EXPECT_EQ(n.asInt(), 3);
+    EXPECT_EQ(n.asString("fallback"), "fallback");
+}
+
+TEST(JsonValueTest, MakeArrayAndObjectStartEmpty) {
+    JsonValue arr = JsonValue::makeArray();
+    JsonValue obj = JsonValue::makeObject();
+
+    EXPECT_TRUE(arr.isArray());
+    EXPECT_TRUE(obj.isObject());
+    EXPECT_EQ(arr.size(), 0u);
+    EXPECT_EQ(obj.size(), 0u);
+}
+
+TEST(JsonValueTest, FootprintIsCompact) {
+    // The point of the variant layout: no more carrying a bool, double,
+    // string, vector and map in every instance
+    EXPECT_LE(sizeof(JsonValue),
+              sizeof(std::variant<std::monostate, bool, double, std::string,
+                                  std::vector<JsonValue>,
+                                  std::unordered_map<std::string, JsonValue>>) +
+                  alignof(std::max_align_t));
+}
+
+TEST(JsonValueTest, RoundTripThroughSerializer) {
+    auto json = JsonParser::parse(
+        R"({"name":"cfg","values":[1,2.5,true,null],"nested":{"k":"v"}})");
+
+    std::string out = JsonSerializer::serialize(json, false);
+    auto reparsed = JsonParser::parse(out);
+
+    EXPECT_EQ(reparsed["name"].asString(), "cfg");
+    EXPECT_EQ(reparsed["values"].size(), 4u);
+    EXPECT_EQ(reparsed["values"][1].asDouble(), 2.5);
+    EXPECT_TRUE(reparsed["values"][2].asBool());
+    EXPECT_TRUE(reparsed["values"][3].isNull());
+    EXPECT_EQ(reparsed["nested"]["k"].asString(), "v");
+}
+
+TEST(JsonParserTest, ParsesFromNonOwnedBuffer) {
+    // string_view entry point: the buffer is only needed during parse
+    std::string buffer = R"({"key": "plain value", "n": 7})";
+    JsonValue parsed = JsonParser::parse(std::string_view(buffer));
+    buffer.assign(buffer.size(), 'x');   // clobber the source
+
+    EXPECT_EQ(parsed["key"].asString(), "plain value");
+    EXPECT_EQ(parsed["n"].asInt(), 7);
+}
+
+TEST(JsonParserTest, EscapedStringsStillDecode) {
+    // Escapes take the slow path; unescaped neighbors take the slice path
+    auto json = JsonParser::parse(R"({"a": "tab\there", "b": "plain"})");
+    EXPECT_EQ(json["a"].asString(), "tab\there");
+    EXPECT_EQ(json["b"].asString(), "plain");
+}
+
+TEST(JsonParserTest, ParseFileMapsConfig) {
+    const char* path = "/tmp/morphect_json_test.json";
+    {
+        std::ofstream out(path);
+        out << R"({"obfuscation_settings": {"global_probability": 0.5}})";
+    }
+
+    auto json = JsonParser::parseFile(path);
+    EXPECT_DOUBLE_EQ(
+        json["obfuscation_settings"]["global_probability"].asDouble(), 0.5);
+
+    std::remove(path);
+}
@@ -0,0 +1,124 @@
+/**
+ * Morphect - Line Pattern Matcher Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/line_matcher.hpp"
+
+using namespace morphect;
+
+TEST(LineMatcherTest, AnchoredMatchWithCaptures) {
+    static const LinePattern add = line_patterns::asmBinaryRegReg("add");
+
+    LineMatch m;
+    ASSERT_TRUE(add.match("add rax, rbx", m));
+    EXPECT_EQ(m.count, 2);
+    EXPECT_EQ(m.str(0), "rax");
+    EXPECT_EQ(m.str(1), "rbx");
+
+    // match() is whole-line (regex_match semantics)
+    EXPECT_FALSE(add.match("add rax, rbx # note", m));
+    EXPECT_FALSE(add.match("addq rax, rbx", m));
+    EXPECT_FALSE(add.match("add rax, [rbx]", m));
+}
+
+TEST(LineMatcherTest, LiteralsAreCaseInsensitiveWhenAsked) {
+    static const LinePattern add = line_patterns::asmBinaryRegReg("add");
+
+    LineMatch m;
+    ASSERT_TRUE(add.match("ADD RAX,RBX", m));
+    EXPECT_EQ(m.str(0), "RAX");
+
+    // IR patterns stay case-sensitive
+    EXPECT_FALSE(line_patterns::irRetType().search("RET i32 %v", m));
+}
+
+TEST(LineMatcherTest, ImmediateForms) {
+    static const LinePattern mov_imm = line_patterns::asmRegImm("mov");
+    static const LinePattern sub_uimm = line_patterns::asmRegUImm("sub");
+    static const LinePattern add_dec = line_patterns::asmRegDecImm("add");
+
+    LineMatch m;
+    ASSERT_TRUE(mov_imm.match("mov eax, 0xDEAD", m));
+    EXPECT_EQ(m.str(1), "0xDEAD");
+    ASSERT_TRUE(mov_imm.match("mov eax, -42", m));
+    EXPECT_EQ(m.str(1), "-42");
+    EXPECT_FALSE(mov_imm.match("mov eax, ebx", m));
+
+    ASSERT_TRUE(add_dec.match("add rcx, -7", m));
+    EXPECT_TRUE(sub_uimm.match("sub rcx, 7", m));
+    EXPECT_FALSE(sub_uimm.match("sub rcx, -7", m));
+    EXPECT_FALSE(sub_uimm.match("sub rcx, 0x7", m));
+}
+
+TEST(LineMatcherTest, SearchFindsPatternMidLine) {
+    LineMatch m;
+    ASSERT_TRUE(line_patterns::irRetType().search("  ret i32 %val", m));
+    EXPECT_EQ(m.str(0), "i32");
+
+    ASSERT_TRUE(line_patterns::irRetType().search("  ret void", m));
+    EXPECT_EQ(m.str(0), "void");
+
+    ASSERT_TRUE(line_patterns::irRetValue().search("  ret i64 42", m));
+    EXPECT_EQ(m.str(0), "i64");
+    EXPECT_EQ(m.str(1), "42");
+
+    EXPECT_FALSE(line_patterns::irRetValue().search("  br label %done", m));
+}
+
+TEST(LineMatcherTest, PhiPatternAndArgIteration) {
+    LineMatch m;
+    std::string line =
+        "  %x.0 = phi i32 [ %a, %entry ], [ 7, %bb.loop ]";
+    ASSERT_TRUE(line_patterns::irPhi().search(line, m));
+    EXPECT_EQ(m.str(0), "%x.0");
+    EXPECT_EQ(m.str(1), "i32");
+
+    std::string args = m.str(2);
+    std::vector<std::string> values;
+    std::vector<std::string> labels;
+    LineMatch arg;
+    size_t end = 0;
+    size_t pos = 0;
+    while ((pos = line_patterns::irPhiArg().searchFrom(args, pos, arg, end)) !=
+           LinePattern::npos) {
+        values.push_back(arg.str(0));
+        labels.push_back(arg.str(1));
+        pos = end;
+    }
+    ASSERT_EQ(values.size(), 2u);
+    EXPECT_EQ(values[0], "%a");
+    EXPECT_EQ(values[1], "7");
+    EXPECT_EQ(labels[0], "entry");
+    EXPECT_EQ(labels[1], "bb.loop");
+}
+
+TEST(LineMatcherTest, AsciiStringHelper) {
+    std::string content;
+    ASSERT_TRUE(line_patterns::matchAsciiString(
+        "\t.string\t\"hello world\"", content));
+    EXPECT_EQ(content, "hello world");
+
+    ASSERT_TRUE(line_patterns::matchAsciiString(
+        "\t.ascii\t\"no terminator\"", content));
+    EXPECT_EQ(content, "no terminator");
+
+    // Greedy to the last quote, like the regex it replaced
+    ASSERT_TRUE(line_patterns::matchAsciiString(
+        "\t.string\t\"say \\\"hi\\\"\"", content));
+    EXPECT_EQ(content, "say \\\"hi\\\"");
+
+    EXPECT_FALSE(line_patterns::matchAsciiString("\t.byte\t0x41", content));
+}
+
+TEST(LineMatcherTest, RegisterMentionScans) {
+    EXPECT_TRUE(line_patterns::mentionsX64Register("movq %rsp, %rbp"));
+    EXPECT_TRUE(line_patterns::mentionsX64Register("mov R10, rax"));
+    EXPECT_FALSE(line_patterns::mentionsX64Register("movl %eax, %ebx"));
+
+    // Whole-word only: r8d is not the token r8
+    EXPECT_FALSE(line_patterns::mentionsX64Register("mov r8d, eax"));
+
+    EXPECT_TRUE(line_patterns::mentionsX32Register("movl %eax, -4(%rip)"));
+    EXPECT_FALSE(line_patterns::mentionsX32Register("pushq %rbp"));
+}
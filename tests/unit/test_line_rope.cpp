@@ -0,0 +1,95 @@
+/**
+ * Morphect - Line Rope Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/line_rope.hpp"
+
+using namespace morphect;
+
+TEST(LineRopeTest, AppendAndFlatten) {
+    LineRope rope;
+    rope.append("a");
+    rope.append("b");
+    rope.appendChunk({"c", "d"});
+
+    EXPECT_EQ(rope.size(), 4u);
+
+    auto lines = rope.flatten();
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0], "a");
+    EXPECT_EQ(lines[3], "d");
+}
+
+TEST(LineRopeTest, AppendMovedTakesRange) {
+    std::vector<std::string> source = {"one", "two", "three", "four"};
+
+    LineRope rope;
+    rope.appendMoved(source, 1, 3);
+
+    auto lines = rope.flatten();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], "two");
+    EXPECT_EQ(lines[1], "three");
+}
+
+TEST(LineRopeTest, InsertSplitsChunk) {
+    LineRope rope(std::vector<std::string>{"a", "b", "c", "d"});
+
+    rope.insert(2, {"x", "y"});
+
+    EXPECT_EQ(rope.size(), 6u);
+    auto lines = rope.flatten();
+    EXPECT_EQ(lines[1], "b");
+    EXPECT_EQ(lines[2], "x");
+    EXPECT_EQ(lines[3], "y");
+    EXPECT_EQ(lines[4], "c");
+}
+
+TEST(LineRopeTest, InsertAtEnds) {
+    LineRope rope(std::vector<std::string>{"m"});
+
+    rope.insert(0, {"start"});
+    rope.insert(rope.size(), {"end"});
+
+    auto lines = rope.flatten();
+    ASSERT_EQ(lines.size(), 3u);
+    EXPECT_EQ(lines[0], "start");
+    EXPECT_EQ(lines[1], "m");
+    EXPECT_EQ(lines[2], "end");
+}
+
+TEST(LineRopeTest, ReplaceRange) {
+    LineRope rope(std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+    rope.replaceRange(1, 4, {"X"});
+
+    EXPECT_EQ(rope.size(), 3u);
+    auto lines = rope.flatten();
+    EXPECT_EQ(lines[0], "a");
+    EXPECT_EQ(lines[1], "X");
+    EXPECT_EQ(lines[2], "e");
+}
+
+TEST(LineRopeTest, EraseRange) {
+    LineRope rope(std::vector<std::string>{"a", "b", "c", "d"});
+
+    rope.eraseRange(0, 2);
+
+    EXPECT_EQ(rope.size(), 2u);
+    EXPECT_EQ(rope.at(0), "c");
+    EXPECT_EQ(rope.at(1), "d");
+}
+
+TEST(LineRopeTest, SplicesDoNotCopyUnrelatedChunks) {
+    LineRope rope;
+    rope.appendChunk({"a", "b"});
+    rope.appendChunk({"c", "d"});
+
+    EXPECT_EQ(rope.chunkCount(), 2u);
+
+    // Inserting at a chunk boundary should not split anything
+    rope.insert(2, {"mid"});
+    EXPECT_EQ(rope.chunkCount(), 3u);
+    EXPECT_EQ(rope.at(2), "mid");
+}
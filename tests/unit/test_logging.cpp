@@ -0,0 +1,153 @@
+/**
+ * Morphect - Logging Tests (async sink)
+ */
+
+#include <gtest/gtest.h>
+#include "common/logging.hpp"
+
+#include <sstream>
+#include <thread>
+
+using namespace morphect;
+
+TEST(AsyncLogSinkTest, DropsWhenFullInsteadOfBlocking) {
+    AsyncLogSink sink(8);   // not started: nothing drains
+
+    int accepted = 0;
+    for (int i = 0; i < 20; i++) {
+        AsyncLogSink::Record record;
+        record.formatted = "line " + std::to_string(i);
+        if (sink.enqueue(std::move(record))) accepted++;
+    }
+
+    EXPECT_EQ(accepted, 8);
+    EXPECT_EQ(sink.dropped(), 12u);
+}
+
+TEST(AsyncLogSinkTest, StopDrainsQueuedRecords) {
+    auto& config = LogConfig::get();
+    std::ostream* saved_output = config.output;
+
+    std::ostringstream captured;
+    config.output = &captured;
+
+    {
+        AsyncLogSink sink(64);
+        for (int i = 0; i < 10; i++) {
+            AsyncLogSink::Record record;
+            record.formatted = "record " + std::to_string(i);
+            sink.enqueue(std::move(record));
+        }
+        sink.start();
+        sink.stop();
+    }
+
+    config.output = saved_output;
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_NE(captured.str().find("record " + std::to_string(i)),
+                  std::string::npos);
+    }
+}
+
+TEST(AsyncLogSinkTest, ConcurrentProducersLoseNothingWhileDraining) {
+    auto& config = LogConfig::get();
+    std::ostream* saved_output = config.output;
+
+    std::ostringstream captured;
+    config.output = &captured;
+
+    {
+        AsyncLogSink sink(1024);
+        sink.start();
+
+        std::vector<std::thread> producers;
+        for (int t = 0; t < 4; t++) {
+            producers.emplace_back([&sink, t]() {
+                for (int i = 0; i < 100; i++) {
+                    for (;;) {
+                        AsyncLogSink::Record record;
+                        record.formatted =
+                            "t" + std::to_string(t) + "." + std::to_string(i);
+                        if (sink.enqueue(std::move(record))) break;
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+
+        sink.stop();
+        EXPECT_EQ(sink.dropped(), 0u);
+    }
+
+    config.output = saved_output;
+
+    // Spot-check first and last record of each producer
+    for (int t = 0; t < 4; t++) {
+        EXPECT_NE(captured.str().find("t" + std::to_string(t) + ".0"),
+                  std::string::npos);
+        EXPECT_NE(captured.str().find("t" + std::to_string(t) + ".99"),
+                  std::string::npos);
+    }
+}
+
+TEST(AsyncLogSinkTest, LoggerRoutesThroughActiveSink) {
+    auto& config = LogConfig::get();
+    std::ostream* saved_output = config.output;
+    LogLevel saved_level = config.minLevel;
+
+    std::ostringstream captured;
+    config.output = &captured;
+    config.minLevel = LogLevel::Info;
+
+    AsyncLogSink::get().start();
+    Logger logger("async-test");
+    logger.info("queued message {}", 42);
+    AsyncLogSink::get().stop();
+
+    config.output = saved_output;
+    config.minLevel = saved_level;
+
+    EXPECT_NE(captured.str().find("queued message 42"), std::string::npos);
+}
+
+TEST(LogMacroTest, ArgumentsNotEvaluatedWhenLevelFiltered) {
+    auto& config = LogConfig::get();
+    LogLevel saved_level = config.minLevel;
+    config.minLevel = LogLevel::Error;
+
+    int evaluations = 0;
+    auto expensive = [&evaluations]() {
+        evaluations++;
+        return std::string("built");
+    };
+
+    Logger logger("lazy-test");
+    MORPHECT_DEBUG(logger, "value: {}", expensive());
+    MORPHECT_INFO(logger, "value: {}", expensive());
+
+    config.minLevel = saved_level;
+
+    // Both calls were filtered at runtime before touching their arguments
+    EXPECT_EQ(evaluations, 0);
+}
+
+TEST(LogMacroTest, CompiledInLevelsStillLog) {
+    auto& config = LogConfig::get();
+    std::ostream* saved_output = config.output;
+    LogLevel saved_level = config.minLevel;
+
+    std::ostringstream captured;
+    config.output = &captured;
+    config.minLevel = LogLevel::Info;
+
+    Logger logger("macro-test");
+    MORPHECT_INFO(logger, "macro message {}", 7);
+
+    config.output = saved_output;
+    config.minLevel = saved_level;
+
+    EXPECT_NE(captured.str().find("macro message 7"), std::string::npos);
+    EXPECT_TRUE(logLevelCompiledIn(LogLevel::Error));
+}
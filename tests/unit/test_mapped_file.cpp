@@ -0,0 +1,141 @@
+/**
+ * Morphect - Mapped File / Line Table Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/mapped_file.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace morphect;
+
+namespace {
+
+std::string writeTempFile(const std::string& content) {
+    std::string path = "/tmp/morphect_mapped_test.txt";
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+    return path;
+}
+
+} // namespace
+
+TEST(MappedFileTest, MapsExistingFile) {
+    auto path = writeTempFile("line one\nline two\n");
+
+    MappedFile file(path);
+    ASSERT_TRUE(file.valid());
+    EXPECT_EQ(file.size(), 18u);
+    EXPECT_EQ(file.view(), "line one\nline two\n");
+
+    std::remove(path.c_str());
+}
+
+TEST(MappedFileTest, InvalidForMissingFile) {
+    MappedFile file("/tmp/morphect_does_not_exist_12345");
+    EXPECT_FALSE(file.valid());
+}
+
+TEST(MappedFileTest, HandlesEmptyFile) {
+    auto path = writeTempFile("");
+
+    MappedFile file(path);
+    EXPECT_TRUE(file.valid());
+    EXPECT_EQ(file.size(), 0u);
+
+    std::remove(path.c_str());
+}
+
+TEST(LineTableTest, SplitsLines) {
+    LineTable table("a\nbb\nccc\n");
+
+    ASSERT_EQ(table.size(), 3u);
+    EXPECT_EQ(table.get(0), "a");
+    EXPECT_EQ(table.get(1), "bb");
+    EXPECT_EQ(table.get(2), "ccc");
+}
+
+TEST(LineTableTest, HandlesMissingTrailingNewlineAndCRLF) {
+    LineTable table("one\r\ntwo");
+
+    ASSERT_EQ(table.size(), 2u);
+    EXPECT_EQ(table.get(0), "one");
+    EXPECT_EQ(table.get(1), "two");
+}
+
+TEST(LineTableTest, CopyOnWriteOverlay) {
+    std::string buffer = "a\nb\nc\n";
+    LineTable table(buffer);
+
+    EXPECT_EQ(table.modifiedCount(), 0u);
+
+    table.set(1, "B modified");
+
+    EXPECT_TRUE(table.isModified(1));
+    EXPECT_FALSE(table.isModified(0));
+    EXPECT_EQ(table.modifiedCount(), 1u);
+    EXPECT_EQ(table.get(1), "B modified");
+    EXPECT_EQ(table.get(0), "a");  // untouched lines still view the buffer
+
+    EXPECT_EQ(table.join(), "a\nB modified\nc\n");
+}
+
+TEST(LineTableTest, MaterializeProducesOwnedLines) {
+    std::string buffer = "x\ny\n";
+    LineTable table(buffer);
+    table.set(0, "X");
+
+    auto lines = table.materialize();
+
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], "X");
+    EXPECT_EQ(lines[1], "y");
+}
+
+namespace {
+
+std::string readBack(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(in)),
+                        std::istreambuf_iterator<char>());
+    return content;
+}
+
+} // namespace
+
+TEST(MappedOutputFileTest, WritesAndTruncatesToActualSize) {
+    std::string path = "/tmp/morphect_mapped_out_test.txt";
+
+    MappedOutputFile out(path, 4096);  // generous estimate
+    ASSERT_TRUE(out.valid());
+    out.appendLine("define i32 @f() {");
+    out.appendLine("  ret i32 0");
+    out.appendLine("}");
+    EXPECT_TRUE(out.close());
+
+    std::string content = readBack(path);
+    EXPECT_EQ(content, "define i32 @f() {\n  ret i32 0\n}\n");
+    std::remove(path.c_str());
+}
+
+TEST(MappedOutputFileTest, GrowsPastShortEstimate) {
+    std::string path = "/tmp/morphect_mapped_out_test.txt";
+
+    MappedOutputFile out(path, 16);  // estimate far too small
+    ASSERT_TRUE(out.valid());
+
+    std::string line(100, 'x');
+    for (int i = 0; i < 1000; i++) {
+        out.appendLine(line);
+    }
+    EXPECT_TRUE(out.close());
+
+    EXPECT_EQ(readBack(path).size(), 1000u * 101u);
+    std::remove(path.c_str());
+}
+
+TEST(MappedOutputFileTest, InvalidForUncreatableFile) {
+    MappedOutputFile out("/nonexistent_dir/out.txt", 1024);
+    EXPECT_FALSE(out.valid());
+}
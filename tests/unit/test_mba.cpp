@@ -496,6 +496,54 @@ TEST_F(MBAPassTest, NoTransformableLines) {
     EXPECT_EQ(lines.size(), 3u);  // Should not be modified
 }
 
+TEST_F(MBAPassTest, SkipsDeadCodePassOutput) {
+    // Dead-code blocks arrive pre-expanded and tagged with the dead-code
+    // register prefixes; even at probability 1.0 the pass must leave
+    // them untouched and still transform the surrounding real code
+    std::vector<std::string> lines = {
+        "  %_dead1 = add i32 %x, 100",
+        "  %_arith2 = xor i32 %_dead1, 7",
+        "  %_mba_res3 = and i32 %_arith2, %x",
+        "  %_opq_v = add i32 0, 42",
+        "  %_pool4 = or i32 %_opq_v, 1",
+        "  %result = add i32 %a, %b"
+    };
+
+    auto result = pass.transformIR(lines);
+
+    EXPECT_EQ(result, morphect::TransformResult::Success);
+    int dead_lines_kept = 0;
+    for (const auto& line : lines) {
+        if (line == "  %_dead1 = add i32 %x, 100" ||
+            line == "  %_arith2 = xor i32 %_dead1, 7" ||
+            line == "  %_mba_res3 = and i32 %_arith2, %x" ||
+            line == "  %_opq_v = add i32 0, 42" ||
+            line == "  %_pool4 = or i32 %_opq_v, 1") {
+            dead_lines_kept++;
+        }
+        EXPECT_EQ(line.find("  %result = add i32 %a, %b"), std::string::npos);
+    }
+    EXPECT_EQ(dead_lines_kept, 5);
+}
+
+TEST_F(MBAPassTest, SkipsDeadCodeOutputAtDepth2) {
+    // The cached nested path has its own sweep; it must honor the same
+    // dead-code skip
+    config.global.nesting_depth = 2;
+    pass.initializeMBA(config);
+
+    std::vector<std::string> lines = {
+        "  %_mba_res0 = add i32 %_mba_a1, %_mba_b2",
+        "  %result = add i32 %a, %b"
+    };
+
+    auto result = pass.transformIR(lines);
+
+    EXPECT_EQ(result, morphect::TransformResult::Success);
+    EXPECT_EQ(lines[0], "  %_mba_res0 = add i32 %_mba_a1, %_mba_b2");
+    EXPECT_GT(lines.size(), 2u);
+}
+
 // ============================================================================
 // Phase 3.2: Additional MBA Variants Tests
 // ============================================================================
@@ -1525,3 +1573,92 @@ TEST_F(MBASubIRTest, WithNswNuwFlags) {
     // Variant 0 (two's complement) produces 3 instructions
     ASSERT_EQ(3u, result.size());
 }
+
+// ============================================================================
+// Batch verifier - audits the actual emitted IR, not hand-copied identities
+// ============================================================================
+
+#include "../../src/passes/mba/mba_verifier.hpp"
+
+TEST(MBAVerifierTest, AllVariantsHoldOnRandomOperands) {
+    // Small sample count to keep unit runtime down; the full audit runs
+    // via `morphect-ir --verify-mba`
+    morphect::mba::MBAVerifier verifier(1u << 14);
+
+    auto results = verifier.verifyAll();
+    EXPECT_GT(results.size(), 40u);  // 5 ops x 8-10 variants + mult constants
+
+    for (const auto& r : results) {
+        EXPECT_TRUE(r.passed())
+            << r.operation << "/" << r.variant_name << ": "
+            << r.mismatches << " of " << r.samples << " samples mismatch";
+    }
+}
+
+TEST(MBAVerifierTest, SamplesAreAccountedPerVariant) {
+    morphect::mba::MBAVerifier verifier(1000);
+    auto results = verifier.verifyAll();
+    for (const auto& r : results) {
+        EXPECT_EQ(1000u, r.samples)
+            << r.operation << "/" << r.variant_name;
+    }
+}
+
+// ============================================================================
+// Hand-rolled instruction matcher (replaces the per-line std::regex path)
+// ============================================================================
+
+using morphect::mba::ArithMatch;
+using morphect::mba::matchArithInstruction;
+
+TEST(ArithMatcherTest, MatchesPlainInstruction) {
+    ArithMatch m;
+    ASSERT_TRUE(matchArithInstruction("  %r = add i32 %a, %b", "add",
+                                      true, false, m));
+    EXPECT_EQ("  ", m.indent);
+    EXPECT_EQ("%r", m.dest);
+    EXPECT_EQ("i32", m.type);
+    EXPECT_EQ("%a", m.op1);
+    EXPECT_EQ("%b", m.op2);
+}
+
+TEST(ArithMatcherTest, MatchesWrapFlagsAndConstants) {
+    ArithMatch m;
+    ASSERT_TRUE(matchArithInstruction("%x.1 = add nuw nsw i64 %v, -42", "add",
+                                      true, false, m));
+    EXPECT_EQ("%x.1", m.dest);
+    EXPECT_EQ("i64", m.type);
+    EXPECT_EQ("%v", m.op1);
+    EXPECT_EQ("-42", m.op2);
+}
+
+TEST(ArithMatcherTest, MatchesVectorTypes) {
+    ArithMatch m;
+    ASSERT_TRUE(matchArithInstruction("  %r = add <4 x i32> %a, %b", "add",
+                                      true, false, m));
+    EXPECT_EQ("<4 x i32>", m.type);
+}
+
+TEST(ArithMatcherTest, EnforcesRegisterFirstOperand) {
+    ArithMatch m;
+    // xor/and/or take no flags and require a register first operand
+    EXPECT_FALSE(matchArithInstruction("  %r = xor i32 5, %b", "xor",
+                                       false, true, m));
+    EXPECT_FALSE(matchArithInstruction("  %r = xor nsw i32 %a, %b", "xor",
+                                       false, true, m));
+    EXPECT_TRUE(matchArithInstruction("  %r = xor i32 %a, 5", "xor",
+                                      false, true, m));
+}
+
+TEST(ArithMatcherTest, RejectsMalformedLines) {
+    ArithMatch m;
+    EXPECT_FALSE(matchArithInstruction("  %r = add i32 %a", "add",
+                                       true, false, m));
+    EXPECT_FALSE(matchArithInstruction("  %r = add i32 %a, %b ; tail", "add",
+                                       true, false, m));
+    EXPECT_FALSE(matchArithInstruction("  %r = addx i32 %a, %b", "add",
+                                       true, false, m));
+    EXPECT_FALSE(matchArithInstruction("  store i32 %a, i32* %p", "add",
+                                       true, false, m));
+    EXPECT_FALSE(matchArithInstruction("", "add", true, false, m));
+}
@@ -0,0 +1,161 @@
+/**
+ * Morphect - Metrics Exporter Tests
+ */
+
+#include <gtest/gtest.h>
+#include "core/statistics.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace morphect;
+
+namespace {
+
+Statistics sampleStats() {
+    Statistics stats;
+    stats.set("MBA_xor", 5);
+    stats.set("DeadCode", 2);
+    stats.set("cost_model.predicted_cycles", 120.5);
+    stats.set("run_time_ms", 42.25);
+    return stats;
+}
+
+} // namespace
+
+TEST(MetricsExporterTest, PrometheusRenderingTagsAndSanitizesNames) {
+    MetricsExporter exporter("libfoo.so", "00deadbeef001234");
+    std::string text = exporter.toPrometheus(sampleStats());
+
+    // Counters get _total, every sample carries both labels
+    EXPECT_NE(text.find("morphect_MBA_xor_total{target=\"libfoo.so\","
+                        "config=\"00deadbeef001234\"} 5"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE morphect_MBA_xor_total counter"), std::string::npos);
+
+    // Dotted stat names sanitize to the Prometheus alphabet, as gauges
+    EXPECT_NE(text.find("morphect_cost_model_predicted_cycles{"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE morphect_cost_model_predicted_cycles gauge"),
+              std::string::npos);
+    EXPECT_EQ(text.find("cost_model.predicted"), std::string::npos);
+}
+
+TEST(MetricsExporterTest, PrometheusLabelValuesEscaped) {
+    MetricsExporter exporter("weird\"name\\lib", "abc");
+    Statistics stats;
+    stats.set("count", 1);
+
+    std::string text = exporter.toPrometheus(stats);
+    EXPECT_NE(text.find("target=\"weird\\\"name\\\\lib\""), std::string::npos);
+}
+
+TEST(MetricsExporterTest, PrometheusFileWrittenAtomically) {
+    std::string path = "/tmp/morphect_metrics_test.prom";
+    MetricsExporter exporter("module.ll", "feedface");
+    Statistics stats = sampleStats();
+
+    ASSERT_TRUE(exporter.writePrometheusFile(path, stats));
+
+    std::ifstream in(path);
+    ASSERT_TRUE(in.is_open());
+    std::ostringstream content;
+    content << in.rdbuf();
+    EXPECT_EQ(content.str(), exporter.toPrometheus(stats));
+
+    // The temp file must not survive the rename
+    std::ifstream tmp(path + ".tmp");
+    EXPECT_FALSE(tmp.is_open());
+
+    std::remove(path.c_str());
+}
+
+TEST(MetricsExporterTest, StatsdPayloadTypesAndTags) {
+    MetricsExporter exporter("libfoo.so", "cafe");
+    auto payloads = exporter.toStatsdPayloads(sampleStats());
+    ASSERT_FALSE(payloads.empty());
+
+    std::string all;
+    for (const auto& p : payloads) all += p + "\n";
+
+    // Integer counters are |c, timings |ms, other doubles |g
+    EXPECT_NE(all.find("morphect.MBA_xor:5|c|#target:libfoo.so,config:cafe"),
+              std::string::npos);
+    EXPECT_NE(all.find("morphect.run_time_ms:42.2500|ms"), std::string::npos);
+    EXPECT_NE(all.find("morphect.cost_model_predicted_cycles:120.5000|g"),
+              std::string::npos);
+}
+
+TEST(MetricsExporterTest, StatsdPayloadsBatchUnderDatagramLimit) {
+    Statistics stats;
+    for (int i = 0; i < 200; i++) {
+        stats.set("pass_" + std::to_string(i) + "_transformed", i);
+    }
+
+    MetricsExporter exporter("big_module.ll", "0123456789abcdef");
+    auto payloads = exporter.toStatsdPayloads(stats);
+
+    // Batched (far fewer packets than metrics) but never oversized
+    EXPECT_GT(payloads.size(), 1u);
+    EXPECT_LT(payloads.size(), 200u);
+
+    size_t metric_lines = 0;
+    for (const auto& p : payloads) {
+        EXPECT_LE(p.size(), 1400u);
+        metric_lines += static_cast<size_t>(
+            std::count(p.begin(), p.end(), '\n')) + 1;
+    }
+    EXPECT_EQ(metric_lines, 200u);
+}
+
+TEST(MetricsExporterTest, PushStatsdDeliversOverLoopback) {
+    // Stand in for the StatsD daemon: a bound UDP socket on loopback
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(fd, 0);
+
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;  // kernel picks a free port
+    ASSERT_EQ(::bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+
+    socklen_t len = sizeof(addr);
+    ASSERT_EQ(::getsockname(fd, reinterpret_cast<struct sockaddr*>(&addr), &len), 0);
+
+    struct timeval timeout {2, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    Statistics stats;
+    stats.set("total_transformations", 7);
+
+    MetricsExporter exporter("loopback.ll", "0011223344556677");
+    ASSERT_TRUE(exporter.pushStatsd(
+        "127.0.0.1:" + std::to_string(ntohs(addr.sin_port)), stats));
+
+    char buf[2048];
+    ssize_t n = ::recv(fd, buf, sizeof(buf) - 1, 0);
+    ::close(fd);
+    ASSERT_GT(n, 0);
+    buf[n] = '\0';
+
+    EXPECT_NE(std::string(buf).find(
+                  "morphect.total_transformations:7|c"
+                  "|#target:loopback.ll,config:0011223344556677"),
+              std::string::npos);
+}
+
+TEST(MetricsExporterTest, UnresolvableStatsdTargetFails) {
+    MetricsExporter exporter("x.ll", "00");
+    Statistics stats;
+    stats.set("count", 1);
+
+    EXPECT_FALSE(exporter.pushStatsd("no-port-here", stats));
+    EXPECT_FALSE(exporter.pushStatsd(
+        "definitely-not-a-real-host.invalid:8125", stats));
+}
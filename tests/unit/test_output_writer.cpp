@@ -0,0 +1,67 @@
+/**
+ * Morphect - Output Writer Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/output_writer.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace morphect;
+
+namespace {
+
+std::string readBack(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buf;
+    buf << in.rdbuf();
+    return buf.str();
+}
+
+} // namespace
+
+TEST(OutputWriterTest, WritesLinesAcrossFlushes) {
+    std::string path = "/tmp/morphect_output_writer_test.txt";
+
+    {
+        // Tiny buffer forces flushes mid-stream
+        OutputWriter out(path, 16);
+        ASSERT_TRUE(out.valid());
+
+        out.appendLine("first line");
+        out.appendLine("second line longer than the buffer itself");
+        out.appendLine("third");
+        EXPECT_TRUE(out.close());
+        EXPECT_EQ(out.bytesWritten(),
+                  readBack(path).size());
+    }
+
+    EXPECT_EQ(readBack(path),
+              "first line\nsecond line longer than the buffer itself\nthird\n");
+    std::remove(path.c_str());
+}
+
+TEST(OutputWriterTest, AppendBypassesBufferForLargeChunks) {
+    std::string path = "/tmp/morphect_output_writer_large.txt";
+
+    std::string big(4096, 'x');
+    {
+        OutputWriter out(path, 64);
+        ASSERT_TRUE(out.valid());
+        out.append("head:");
+        out.append(big);
+        EXPECT_TRUE(out.close());
+    }
+
+    EXPECT_EQ(readBack(path), "head:" + big);
+    std::remove(path.c_str());
+}
+
+TEST(OutputWriterTest, InvalidForUnwritablePath) {
+    OutputWriter out("/nonexistent_dir_12345/out.txt");
+    EXPECT_FALSE(out.valid());
+    EXPECT_FALSE(out.ok());
+}
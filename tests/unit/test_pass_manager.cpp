@@ -0,0 +1,397 @@
+/**
+ * Morphect - Pass Manager / Analysis Cache Tests
+ */
+
+#include <gtest/gtest.h>
+#include "core/pass_manager.hpp"
+#include "passes/mba/mba_pass.hpp"
+
+using namespace morphect;
+
+namespace {
+
+struct FakeCFG {
+    int blocks = 0;
+};
+
+} // namespace
+
+TEST(AnalysisCacheTest, ComputesOnceAndCachesResult) {
+    AnalysisCache cache;
+    int computes = 0;
+
+    auto compute = [&]() {
+        computes++;
+        return std::make_shared<const FakeCFG>(FakeCFG{3});
+    };
+
+    auto first = cache.getOrCompute<FakeCFG>("cfg", "main", compute);
+    auto second = cache.getOrCompute<FakeCFG>("cfg", "main", compute);
+
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first->blocks, 3);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(computes, 1);
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+}
+
+TEST(AnalysisCacheTest, SeparateEntriesPerKindAndFunction) {
+    AnalysisCache cache;
+
+    auto make = [](int n) {
+        return [n]() { return std::make_shared<const FakeCFG>(FakeCFG{n}); };
+    };
+
+    cache.getOrCompute<FakeCFG>("cfg", "f1", make(1));
+    cache.getOrCompute<FakeCFG>("cfg", "f2", make(2));
+    cache.getOrCompute<FakeCFG>("callsites", "f1", make(3));
+
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST(AnalysisCacheTest, InvalidationDropsAllKindsForFunction) {
+    AnalysisCache cache;
+    int computes = 0;
+
+    auto compute = [&]() {
+        computes++;
+        return std::make_shared<const FakeCFG>(FakeCFG{computes});
+    };
+
+    cache.getOrCompute<FakeCFG>("cfg", "f", compute);
+    cache.getOrCompute<FakeCFG>("callsites", "f", compute);
+    cache.getOrCompute<FakeCFG>("cfg", "other", compute);
+
+    cache.invalidateFunction("f");
+
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.invalidations(), 1u);
+
+    // Recompute after invalidation
+    auto fresh = cache.getOrCompute<FakeCFG>("cfg", "f", compute);
+    EXPECT_EQ(fresh->blocks, 4);
+    EXPECT_EQ(computes, 4);
+}
+
+TEST(AnalysisCacheTest, FailedComputeIsNotCached) {
+    AnalysisCache cache;
+    int computes = 0;
+
+    auto failing = [&]() -> std::shared_ptr<const FakeCFG> {
+        computes++;
+        return nullptr;
+    };
+
+    EXPECT_EQ(cache.getOrCompute<FakeCFG>("cfg", "bad", failing), nullptr);
+    EXPECT_EQ(cache.getOrCompute<FakeCFG>("cfg", "bad", failing), nullptr);
+    EXPECT_EQ(computes, 2);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(PassManagerTest, FusedSweepAppliesLineLocalPasses) {
+    PassManager pm;
+
+    auto mba = std::make_unique<mba::LLVMMBAPass>();
+    mba::MBAPassConfig mba_config;
+    mba_config.global.enabled = true;
+    mba_config.global.probability = 1.0;
+    mba_config.global.nesting_depth = 1;
+    mba->initializeMBA(mba_config);
+
+    EXPECT_TRUE(mba->isLineLocal());
+    pm.registerPass(std::move(mba));
+    pm.setFusionEnabled(true);
+
+    std::vector<std::string> lines = {
+        "define i32 @f(i32 %0, i32 %1) {",
+        "  %3 = add i32 %0, %1",
+        "  ret i32 %3",
+        "}",
+    };
+
+    int transforms = pm.runLLVMPasses(lines);
+
+    EXPECT_GT(transforms, 0);
+    // The plain add must have been rewritten into an MBA expansion
+    bool has_plain_add = false;
+    for (const auto& line : lines) {
+        if (line.find("= add i32 %0, %1") != std::string::npos) {
+            has_plain_add = true;
+        }
+    }
+    EXPECT_FALSE(has_plain_add);
+    EXPECT_GT(lines.size(), 4u);
+}
+
+TEST(PassManagerTest, DeepNestingKeepsMultiSweepPath) {
+    auto mba = std::make_unique<mba::LLVMMBAPass>();
+    mba::MBAPassConfig mba_config;
+    mba_config.global.nesting_depth = 3;
+    mba->initializeMBA(mba_config);
+
+    EXPECT_FALSE(mba->isLineLocal());
+}
+
+TEST(PassManagerTest, ExposesAnalysisCache) {
+    PassManager pm;
+    auto& cache = pm.analysisCache();
+
+    cache.getOrCompute<FakeCFG>("cfg", "f", []() {
+        return std::make_shared<const FakeCFG>(FakeCFG{1});
+    });
+
+    EXPECT_EQ(pm.analysisCache().size(), 1u);
+}
+
+// ============================================================================
+// Summary-gated GIMPLE dispatch
+// ============================================================================
+
+namespace {
+
+class CountingGimplePass : public GimpleTransformationPass {
+public:
+    std::string getName() const override { return "counting_gimple"; }
+    std::string getDescription() const override { return "counts dispatches"; }
+
+    TransformResult transformGimple(void*) override {
+        invocations++;
+        return TransformResult::Success;
+    }
+
+    int invocations = 0;
+};
+
+class CountingLLVMPass : public LLVMTransformationPass {
+public:
+    explicit CountingLLVMPass(uint32_t required = 0) : required_(required) {}
+
+    std::string getName() const override { return "counting_llvm"; }
+    std::string getDescription() const override { return "counts dispatches"; }
+    uint32_t requiredFeatures() const override { return required_; }
+
+    TransformResult transformIR(std::vector<std::string>&) override {
+        invocations++;
+        return TransformResult::Success;
+    }
+
+    int invocations = 0;
+
+private:
+    uint32_t required_;
+};
+
+} // namespace
+
+TEST(PassManagerTest, TrivialFunctionsSkipGimpleDispatch) {
+    PassManager pm;
+    auto pass = std::make_unique<CountingGimplePass>();
+    CountingGimplePass* raw = pass.get();
+    pm.registerPass(std::move(pass));
+
+    PassConfig config;
+    config.min_function_statements = 5;
+    config.min_transformable_ops = 1;
+    pm.initialize(config);
+
+    // Below the statement threshold: no pass runs
+    GimpleFunctionSummary tiny{3, 2};
+    EXPECT_EQ(pm.runGimplePasses(nullptr, tiny), 0);
+    EXPECT_EQ(raw->invocations, 0);
+
+    // Enough statements but nothing transformable: still skipped
+    GimpleFunctionSummary barren{20, 0};
+    EXPECT_EQ(pm.runGimplePasses(nullptr, barren), 0);
+    EXPECT_EQ(raw->invocations, 0);
+    EXPECT_EQ(pm.functionsSkippedTrivial(), 2u);
+
+    // Over both thresholds: dispatch proceeds
+    GimpleFunctionSummary real{20, 4};
+    EXPECT_EQ(pm.runGimplePasses(nullptr, real), 1);
+    EXPECT_EQ(raw->invocations, 1);
+}
+
+TEST(PassManagerTest, SummaryGateDisabledByDefault) {
+    PassManager pm;
+    auto pass = std::make_unique<CountingGimplePass>();
+    CountingGimplePass* raw = pass.get();
+    pm.registerPass(std::move(pass));
+    pm.initialize(PassConfig{});
+
+    // Zero thresholds leave every function on the dispatch path
+    GimpleFunctionSummary tiny{1, 0};
+    EXPECT_EQ(pm.runGimplePasses(nullptr, tiny), 1);
+    EXPECT_EQ(raw->invocations, 1);
+}
+
+TEST(PassManagerTest, FeatureMaskSkipsInapplicablePasses) {
+    PassManager pm;
+    auto pass = std::make_unique<CountingLLVMPass>(
+        ir_features::kIntArith | ir_features::kBitwise);
+    CountingLLVMPass* raw = pass.get();
+    pm.registerPass(std::move(pass));
+    pm.initialize(PassConfig{});
+
+    std::vector<std::string> lines = {"  ret void"};
+
+    // Function with no arithmetic: pass skipped without a scan
+    EXPECT_EQ(pm.runLLVMPasses(lines, ir_features::kMemory), 0);
+    EXPECT_EQ(raw->invocations, 0);
+    EXPECT_EQ(pm.passesSkippedInapplicable(), 1u);
+
+    // Matching feature: dispatch proceeds
+    EXPECT_EQ(pm.runLLVMPasses(lines, ir_features::kIntArith), 1);
+    EXPECT_EQ(raw->invocations, 1);
+
+    // Mask 0 means no requirement
+    auto always = std::make_unique<CountingLLVMPass>(0);
+    CountingLLVMPass* always_raw = always.get();
+    PassManager pm2;
+    pm2.registerPass(std::move(always));
+    pm2.initialize(PassConfig{});
+    EXPECT_EQ(pm2.runLLVMPasses(lines, 0u), 1);
+    EXPECT_EQ(always_raw->invocations, 1);
+}
+
+TEST(PassManagerTest, FeatureGateDisabledWithoutSummary) {
+    PassManager pm;
+    auto pass = std::make_unique<CountingLLVMPass>(ir_features::kIntArith);
+    CountingLLVMPass* raw = pass.get();
+    pm.registerPass(std::move(pass));
+    pm.initialize(PassConfig{});
+
+    // The tierless overload has no bitmap and runs everything
+    std::vector<std::string> lines = {"  ret void"};
+    EXPECT_EQ(pm.runLLVMPasses(lines), 1);
+    EXPECT_EQ(raw->invocations, 1);
+}
+
+TEST(IRFeaturesTest, ScanAndClassify) {
+    std::vector<std::string> lines = {
+        "define i32 @f(i32 %a, i32 %b) {",
+        "entry:",
+        "  %p = alloca i32",
+        "  store i32 %a, ptr %p",
+        "  %v0 = add i32 %a, %b",
+        "  %v1 = xor i32 %v0, 7",
+        "  br label %done",
+        "done:",
+        "  ret i32 %v1",
+        "}",
+    };
+
+    uint32_t features = ir_features::scanLines(lines);
+    EXPECT_TRUE(features & ir_features::kIntArith);
+    EXPECT_TRUE(features & ir_features::kBitwise);
+    EXPECT_TRUE(features & ir_features::kMemory);
+    EXPECT_TRUE(features & ir_features::kBranch);
+    EXPECT_FALSE(features & ir_features::kMul);
+    EXPECT_FALSE(features & ir_features::kCall);
+    EXPECT_FALSE(features & ir_features::kStringConst);
+
+    std::vector<std::string> strings = {
+        "@.str = private unnamed_addr constant [6 x i8] c\"hello\\00\"",
+    };
+    EXPECT_TRUE(ir_features::scanLines(strings) & ir_features::kStringConst);
+
+    // Built-in pass masks line up with what the passes rewrite
+    mba::LLVMMBAPass mba;
+    EXPECT_TRUE(mba.requiredFeatures() & ir_features::kIntArith);
+    EXPECT_FALSE(mba.requiredFeatures() & ir_features::kBranch);
+}
+
+// ============================================================================
+// Pass Registry Tests
+// ============================================================================
+
+TEST(PassRegistryTest, NameAndIdRoundTrip) {
+    static_assert(passIdFromName("MBA") == PassId::MBA,
+                  "registry lookups are compile-time");
+    static_assert(passPriority(PassId::MBA) == PassPriority::MBA,
+                  "priority table is compile-time");
+
+    EXPECT_STREQ(passName(PassId::CFF), "CFF");
+    EXPECT_EQ(passIdFromName("CFF"), PassId::CFF);
+    EXPECT_EQ(passIdFromName("NoSuchPass"), PassId::Unknown);
+    EXPECT_EQ(passName(PassId::Unknown), nullptr);
+}
+
+TEST(PassRegistryTest, TablePrioritiesMatchPassClasses) {
+    // The constexpr table is what dispatch ordering uses; it has to
+    // agree with what the pass classes report
+    mba::LLVMMBAPass mba;
+    EXPECT_EQ(passPriority(passIdFromName(mba.getName())), mba.getPriority());
+}
+
+TEST(PassRegistryTest, ManagerResolvesBuiltinPassById) {
+    PassManager manager;
+    manager.registerPass(std::make_unique<mba::LLVMMBAPass>());
+
+    TransformationPass* by_id = manager.getPass(PassId::MBA);
+    ASSERT_NE(by_id, nullptr);
+    EXPECT_EQ(by_id, manager.getPass("MBA"));
+    EXPECT_EQ(manager.getPass(PassId::CFF), nullptr);
+    EXPECT_EQ(manager.getPass(PassId::Unknown), nullptr);
+}
+
+// ============================================================================
+// Function Matcher Tests
+// ============================================================================
+
+TEST(FunctionMatcherTest, ExactNamesUseHashSets) {
+    FunctionMatcher matcher;
+    matcher.compile({}, {"skip_me", "and_me"});
+
+    EXPECT_FALSE(matcher.shouldProcess("skip_me"));
+    EXPECT_FALSE(matcher.shouldProcess("and_me"));
+    EXPECT_TRUE(matcher.shouldProcess("keep_me"));
+}
+
+TEST(FunctionMatcherTest, IncludeListRestricts) {
+    FunctionMatcher matcher;
+    matcher.compile({"only_this"}, {});
+
+    EXPECT_TRUE(matcher.shouldProcess("only_this"));
+    EXPECT_FALSE(matcher.shouldProcess("anything_else"));
+}
+
+TEST(FunctionMatcherTest, GlobPatterns) {
+    FunctionMatcher matcher;
+    matcher.compile({}, {"test_*", "*_impl", "f?o"});
+
+    EXPECT_FALSE(matcher.shouldProcess("test_main"));
+    EXPECT_FALSE(matcher.shouldProcess("vector_impl"));
+    EXPECT_FALSE(matcher.shouldProcess("foo"));
+    EXPECT_FALSE(matcher.shouldProcess("fxo"));
+    EXPECT_TRUE(matcher.shouldProcess("main"));
+    EXPECT_TRUE(matcher.shouldProcess("fooo"));  // '?' is exactly one char
+}
+
+TEST(FunctionMatcherTest, StarMatchesAcrossSegments) {
+    FunctionMatcher matcher;
+    matcher.compile({"get_*_count"}, {});
+
+    EXPECT_TRUE(matcher.shouldProcess("get_row_count"));
+    EXPECT_TRUE(matcher.shouldProcess("get_a_b_count"));
+    EXPECT_FALSE(matcher.shouldProcess("get_row_size"));
+}
+
+TEST(FunctionMatcherTest, ExcludeWinsOverInclude) {
+    FunctionMatcher matcher;
+    matcher.compile({"handler_*"}, {"handler_debug"});
+
+    EXPECT_TRUE(matcher.shouldProcess("handler_main"));
+    EXPECT_FALSE(matcher.shouldProcess("handler_debug"));
+}
+
+TEST(FunctionMatcherTest, PassInitializeCompilesMatcher) {
+    mba::LLVMMBAPass pass;
+    PassConfig config;
+    config.exclude_functions = {"crypto_*"};
+    ASSERT_TRUE(pass.initialize(config));
+
+    // shouldProcessFunction is protected; reach it through a pass that
+    // exposes behavior - here we just verify glob configs don't break init
+    EXPECT_TRUE(pass.isEnabled());
+}
@@ -0,0 +1,126 @@
+/**
+ * Morphect - Hot Function Profile Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/profile_data.hpp"
+#include "core/pass_manager.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace morphect;
+
+namespace {
+
+std::string writeProfile(const char* name, const std::string& content) {
+    std::string path = std::string("/tmp/morphect_profile_") + name + ".txt";
+    std::ofstream out(path);
+    out << content;
+    return path;
+}
+
+// Minimal pass whose registered name (and therefore PassId, and cost
+// estimate) is chosen by the test
+class NamedProbePass : public LLVMTransformationPass {
+public:
+    explicit NamedProbePass(std::string name) : name_(std::move(name)) {}
+    std::string getName() const override { return name_; }
+    std::string getDescription() const override { return "probe"; }
+    TransformResult transformIR(std::vector<std::string>&) override {
+        return TransformResult::Skipped;
+    }
+    bool wouldProcess(const std::string& func) const {
+        return shouldProcessFunction(func);
+    }
+private:
+    std::string name_;
+};
+
+} // namespace
+
+TEST(HotFunctionProfileTest, AcceptsCsvAndWhitespaceFormats) {
+    std::string path = writeProfile("formats",
+        "# production profile 2026-08\n"
+        "handle_request,9000\n"
+        "parse_header 450\n"
+        "120 format_log\n"
+        "not a valid record line\n");
+
+    HotFunctionProfile profile;
+    ASSERT_TRUE(profile.loadFile(path));
+    EXPECT_EQ(profile.size(), 3u);
+    EXPECT_EQ(profile.samples("handle_request"), 9000u);
+    EXPECT_EQ(profile.samples("parse_header"), 450u);
+    EXPECT_EQ(profile.samples("format_log"), 120u);
+
+    std::remove(path.c_str());
+}
+
+TEST(HotFunctionProfileTest, RepeatedNamesAccumulate) {
+    std::string path = writeProfile("accumulate",
+        "hot_loop 100\n"
+        "hot_loop 250\n");
+
+    HotFunctionProfile profile;
+    ASSERT_TRUE(profile.loadFile(path));
+    EXPECT_EQ(profile.size(), 1u);
+    EXPECT_EQ(profile.samples("hot_loop"), 350u);
+
+    std::remove(path.c_str());
+}
+
+TEST(HotFunctionProfileTest, HottestPercentRanksBySamples) {
+    std::string content;
+    for (int i = 0; i < 10; i++) {
+        content += "func_" + std::to_string(i) + " " + std::to_string((i + 1) * 100) + "\n";
+    }
+    std::string path = writeProfile("ranked", content);
+
+    HotFunctionProfile profile;
+    ASSERT_TRUE(profile.loadFile(path));
+
+    // 20% of 10 functions = the 2 with the most samples
+    auto hottest = profile.hottestPercent(20.0);
+    ASSERT_EQ(hottest.size(), 2u);
+    EXPECT_EQ(hottest[0], "func_9");
+    EXPECT_EQ(hottest[1], "func_8");
+
+    // A tiny percentage still exempts the single hottest function
+    EXPECT_EQ(profile.hottestPercent(0.1).size(), 1u);
+    EXPECT_TRUE(profile.hottestPercent(0.0).empty());
+
+    std::remove(path.c_str());
+}
+
+TEST(HotFunctionProfileTest, MissingFileFailsLoad) {
+    HotFunctionProfile profile;
+    EXPECT_FALSE(profile.loadFile("/tmp/morphect_profile_does_not_exist.txt"));
+}
+
+TEST(HotFunctionProfileTest, ExpensivePassClassificationMatchesIntent) {
+    // Flattening and indirection hurt a hot function; light passes don't
+    EXPECT_TRUE(isExpensivePass(PassId::CFF));
+    EXPECT_TRUE(isExpensivePass(PassId::IndirectCall));
+    EXPECT_FALSE(isExpensivePass(PassId::MBA));
+    EXPECT_FALSE(isExpensivePass(PassId::DeadCode));
+    EXPECT_FALSE(isExpensivePass(PassId::Unknown));
+}
+
+TEST(HotFunctionProfileTest, ManagerExcludesHotOnlyFromExpensivePasses) {
+    PassManager manager;
+    manager.registerPass(std::make_unique<NamedProbePass>("CFF"));
+    manager.registerPass(std::make_unique<NamedProbePass>("MBA"));
+
+    manager.setHotFunctionExclusions({"hot_p99_fn"});
+    manager.initialize(PassConfig{});
+
+    auto* cff = static_cast<NamedProbePass*>(manager.getPass("CFF"));
+    auto* mba = static_cast<NamedProbePass*>(manager.getPass("MBA"));
+    ASSERT_NE(cff, nullptr);
+    ASSERT_NE(mba, nullptr);
+
+    EXPECT_FALSE(cff->wouldProcess("hot_p99_fn"));  // expensive pass skips it
+    EXPECT_TRUE(mba->wouldProcess("hot_p99_fn"));   // cheap pass still runs
+    EXPECT_TRUE(cff->wouldProcess("cold_fn"));
+}
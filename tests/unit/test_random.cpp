@@ -82,3 +82,139 @@ TEST(GlobalRandomTest, BasicUsage) {
     EXPECT_GE(val, 0);
     EXPECT_LE(val, 100);
 }
+
+TEST(LocalRandomTest, SameSeedSameStreamAsRandom) {
+    Random locked(42);
+    LocalRandom unlocked(42);
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(locked.nextInt(0, 1000), unlocked.nextInt(0, 1000));
+    }
+}
+
+TEST(LocalRandomTest, DeriveSeedIsDeterministicAndScopeSensitive) {
+    uint64_t a = LocalRandom::deriveSeed(42, "@main");
+    uint64_t b = LocalRandom::deriveSeed(42, "@main");
+    uint64_t c = LocalRandom::deriveSeed(42, "@helper");
+    uint64_t d = LocalRandom::deriveSeed(43, "@main");
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+    EXPECT_NE(a, d);
+}
+
+TEST(GlobalRandomTest, ScopedLocalOverridesAndRestores) {
+    GlobalRandom::setSeed(12345);
+    EXPECT_EQ(GlobalRandom::threadLocal(), nullptr);
+
+    uint64_t seed = LocalRandom::deriveSeed(12345, "@f");
+    int first, second;
+    {
+        GlobalRandom::ScopedLocal scoped(seed);
+        ASSERT_NE(GlobalRandom::threadLocal(), nullptr);
+        first = GlobalRandom::nextInt(0, 1000000);
+    }
+    {
+        GlobalRandom::ScopedLocal scoped(seed);
+        second = GlobalRandom::nextInt(0, 1000000);
+    }
+
+    // Same derived seed, same draw — regardless of global state in between
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(GlobalRandom::threadLocal(), nullptr);
+}
+
+TEST(GlobalRandomTest, ScopedLocalNests) {
+    GlobalRandom::ScopedLocal outer(1);
+    LocalRandom* outer_ptr = GlobalRandom::threadLocal();
+    {
+        GlobalRandom::ScopedLocal inner(2);
+        EXPECT_NE(GlobalRandom::threadLocal(), outer_ptr);
+    }
+    EXPECT_EQ(GlobalRandom::threadLocal(), outer_ptr);
+}
+
+TEST(RandomTest, FillBytesCoversWholeBuffer) {
+    Random rng(7);
+
+    std::vector<uint8_t> buf(37, 0);
+    rng.fillBytes(buf.data(), buf.size());
+
+    // 37 zero bytes from a decent generator is effectively impossible
+    bool any_nonzero = false;
+    for (uint8_t b : buf) {
+        if (b != 0) any_nonzero = true;
+    }
+    EXPECT_TRUE(any_nonzero);
+
+    EXPECT_EQ(rng.nextBytes(16).size(), 16u);
+}
+
+TEST(RandomTest, NextIntsRespectsBounds) {
+    Random rng(7);
+
+    int buf[100];
+    rng.nextInts(buf, 100, -5, 5);
+    for (int v : buf) {
+        EXPECT_GE(v, -5);
+        EXPECT_LE(v, 5);
+    }
+}
+
+TEST(RandomTest, FillFromDrawsOnlyAlphabetChars) {
+    Random rng(7);
+
+    char out[64];
+    rng.fillFrom("abc", out, sizeof(out));
+    for (char c : out) {
+        EXPECT_TRUE(c == 'a' || c == 'b' || c == 'c');
+    }
+}
+
+TEST(AliasSamplerTest, RespectsWeightsApproximately) {
+    morphect::AliasSampler sampler({0.6, 0.3, 0.1});
+
+    std::vector<int> counts(3, 0);
+    const int draws = 100000;
+    for (int i = 0; i < draws; i++) {
+        size_t idx = sampler.sample();
+        ASSERT_LT(idx, 3u);
+        counts[idx]++;
+    }
+
+    // Loose bounds - just verify the ordering and rough proportions
+    EXPECT_GT(counts[0], counts[1]);
+    EXPECT_GT(counts[1], counts[2]);
+    EXPECT_NEAR(counts[0] / static_cast<double>(draws), 0.6, 0.05);
+    EXPECT_NEAR(counts[2] / static_cast<double>(draws), 0.1, 0.05);
+}
+
+TEST(AliasSamplerTest, NonPositiveWeightsFallBackToUniform) {
+    morphect::AliasSampler sampler({0.0, 0.0, 0.0, 0.0});
+
+    std::vector<int> counts(4, 0);
+    for (int i = 0; i < 40000; i++) {
+        counts[sampler.sample()]++;
+    }
+    for (int c : counts) {
+        EXPECT_NEAR(c / 40000.0, 0.25, 0.05);
+    }
+}
+
+TEST(AliasSamplerTest, MatchesDetectsWeightChanges) {
+    std::vector<double> weights = {0.5, 0.5};
+    morphect::AliasSampler sampler(weights);
+
+    EXPECT_TRUE(sampler.matches(weights));
+    EXPECT_FALSE(sampler.matches({0.5, 0.4}));
+    EXPECT_FALSE(sampler.matches({0.5, 0.5, 0.0}));
+
+    sampler.build({0.5, 0.4});
+    EXPECT_TRUE(sampler.matches({0.5, 0.4}));
+}
+
+TEST(AliasSamplerTest, EmptyWeightsSampleZero) {
+    morphect::AliasSampler sampler;
+    EXPECT_FALSE(sampler.built());
+    EXPECT_EQ(0u, sampler.sample());
+}
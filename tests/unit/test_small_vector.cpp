@@ -0,0 +1,123 @@
+/**
+ * Morphect - Small Vector Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/small_vector.hpp"
+
+#include <algorithm>
+#include <string>
+
+using namespace morphect;
+
+TEST(SmallVectorTest, StaysInlineUnderCapacity) {
+    SmallVector<int, 4> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 4u);
+
+    const int* inline_data = v.data();
+    v.push_back(1);
+    v.push_back(2);
+    v.push_back(3);
+    v.push_back(4);
+
+    // No spill: storage is still the inline buffer
+    EXPECT_EQ(v.data(), inline_data);
+    EXPECT_EQ(v.size(), 4u);
+    EXPECT_EQ(v[0], 1);
+    EXPECT_EQ(v.back(), 4);
+}
+
+TEST(SmallVectorTest, SpillsToHeapAndKeepsOrder) {
+    SmallVector<int, 2> v;
+    for (int i = 0; i < 100; i++) {
+        v.push_back(i);
+    }
+    ASSERT_EQ(v.size(), 100u);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(v[i], i);
+    }
+}
+
+TEST(SmallVectorTest, HandlesNonTrivialElements) {
+    SmallVector<std::string, 2> v;
+    v.push_back("alpha");
+    v.emplace_back("beta");
+    v.push_back("gamma");  // spills
+
+    EXPECT_EQ(v.size(), 3u);
+    EXPECT_EQ(v[0], "alpha");
+    EXPECT_EQ(v[2], "gamma");
+
+    v.pop_back();
+    EXPECT_EQ(v.back(), "beta");
+
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(SmallVectorTest, CopyAndMove) {
+    SmallVector<std::string, 2> a;
+    a.push_back("one");
+    a.push_back("two");
+    a.push_back("three");
+
+    SmallVector<std::string, 2> copy = a;
+    EXPECT_EQ(copy.size(), 3u);
+    EXPECT_EQ(copy[2], "three");
+    EXPECT_EQ(a[2], "three");  // source untouched
+
+    SmallVector<std::string, 2> moved = std::move(a);
+    EXPECT_EQ(moved.size(), 3u);
+    EXPECT_EQ(moved[0], "one");
+    EXPECT_TRUE(a.empty());
+
+    // Move back into a used vector
+    copy = std::move(moved);
+    EXPECT_EQ(copy.size(), 3u);
+    EXPECT_EQ(copy[1], "two");
+}
+
+TEST(SmallVectorTest, InitializerListAndAssignment) {
+    SmallVector<std::string, 4> v = {"a", "b"};
+    EXPECT_EQ(v.size(), 2u);
+
+    v = {"x", "y", "z"};
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_EQ(v[0], "x");
+    EXPECT_EQ(v[2], "z");
+}
+
+TEST(SmallVectorTest, IterationAndAlgorithms) {
+    SmallVector<int, 4> v = {4, 1, 3, 2};
+
+    EXPECT_NE(std::find(v.begin(), v.end(), 3), v.end());
+    EXPECT_EQ(std::find(v.begin(), v.end(), 9), v.end());
+
+    // Reverse iteration (switch-case emission walks cases backwards)
+    SmallVector<int, 4> reversed;
+    for (auto it = v.rbegin(); it != v.rend(); ++it) {
+        reversed.push_back(*it);
+    }
+    EXPECT_EQ(reversed[0], 2);
+    EXPECT_EQ(reversed[3], 4);
+
+    int sum = 0;
+    for (int x : v) sum += x;
+    EXPECT_EQ(sum, 10);
+}
+
+TEST(SmallVectorTest, ResizeGrowsAndShrinks) {
+    SmallVector<std::string, 2> v;
+    v.resize(5);
+    EXPECT_EQ(v.size(), 5u);
+    EXPECT_TRUE(v[4].empty());
+
+    v[4] = "tail";
+    v.resize(1);
+    EXPECT_EQ(v.size(), 1u);
+
+    v.reserve(64);
+    EXPECT_GE(v.capacity(), 64u);
+    EXPECT_EQ(v.size(), 1u);
+}
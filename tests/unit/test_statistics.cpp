@@ -5,6 +5,9 @@
 #include <gtest/gtest.h>
 #include "core/statistics.hpp"
 
+#include <cstdio>
+#include <thread>
+
 using namespace morphect;
 
 TEST(StatisticsTest, SetAndGet) {
@@ -112,3 +115,165 @@ TEST(ScopedTimerTest, AutoRecord) {
 
     EXPECT_GE(target, 0.0);
 }
+
+TEST(ShardedStatisticsTest, LocalShardIsPerThread) {
+    ShardedStatistics stats;
+
+    stats.increment("main_thread", 1);
+
+    std::thread other([&stats]() {
+        stats.increment("other_thread", 2);
+    });
+    other.join();
+
+    EXPECT_EQ(stats.shardCount(), 2u);
+
+    // Each shard only saw its own thread's updates
+    EXPECT_EQ(stats.local().getInt("main_thread"), 1);
+    EXPECT_EQ(stats.local().getInt("other_thread"), 0);
+}
+
+TEST(ShardedStatisticsTest, SnapshotMergesAllShards) {
+    ShardedStatistics stats;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; t++) {
+        workers.emplace_back([&stats]() {
+            for (int i = 0; i < 1000; i++) {
+                stats.increment("transformations", 1);
+            }
+            stats.add("pass_time_ms", 0.5);
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    Statistics merged = stats.snapshot();
+    EXPECT_EQ(merged.getInt("transformations"), 4000);
+    EXPECT_DOUBLE_EQ(merged.getDouble("pass_time_ms"), 2.0);
+}
+
+TEST(ShardedStatisticsTest, ClearResetsEveryShard) {
+    ShardedStatistics stats;
+
+    stats.increment("count", 5);
+    std::thread other([&stats]() { stats.increment("count", 7); });
+    other.join();
+
+    stats.clear();
+    EXPECT_EQ(stats.snapshot().getInt("count"), 0);
+}
+
+TEST(ShardedStatisticsTest, DistinctInstancesDoNotShareShards) {
+    ShardedStatistics a;
+    ShardedStatistics b;
+
+    a.increment("x", 1);
+    b.increment("x", 10);
+
+    EXPECT_EQ(a.snapshot().getInt("x"), 1);
+    EXPECT_EQ(b.snapshot().getInt("x"), 10);
+}
+
+TEST(TraceRecorderTest, DisabledRecorderStaysEmpty) {
+    auto& recorder = TraceRecorder::get();
+    recorder.disable();
+
+    recorder.begin("mba", "pass");
+    recorder.end("mba", "pass");
+    EXPECT_EQ(recorder.eventCount(), 0u);
+}
+
+TEST(TraceRecorderTest, RecordsBeginEndPairsAndExportsJson) {
+    auto& recorder = TraceRecorder::get();
+    recorder.enable();
+
+    {
+        ScopedTrace trace("@main", "function");
+        recorder.begin("mba", "pass");
+        recorder.end("mba", "pass");
+    }
+
+    EXPECT_EQ(recorder.eventCount(), 4u);
+
+    std::string json = recorder.toJson();
+    EXPECT_NE(json.find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"@main\""), std::string::npos);
+    EXPECT_NE(json.find("\"cat\":\"pass\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"B\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"E\""), std::string::npos);
+
+    recorder.disable();
+}
+
+TEST(MemoryTrackerTest, ReportsRssOnLinux) {
+    size_t peak = MemoryTracker::peakRssKb();
+    size_t current = MemoryTracker::currentRssKb();
+
+    // /proc/self/status is always there on the platforms we build for
+    EXPECT_GT(peak, 0u);
+    EXPECT_GT(current, 0u);
+    EXPECT_GE(peak, current ? current / 2 : 0);   // peak never trails far behind
+}
+
+TEST(AllocationCounterTest, RecordAccumulates) {
+    size_t count_before = AllocationCounter::count().load();
+    size_t bytes_before = AllocationCounter::bytes().load();
+
+    AllocationCounter::record(128);
+    AllocationCounter::record(64);
+
+    EXPECT_EQ(AllocationCounter::count().load(), count_before + 2);
+    EXPECT_EQ(AllocationCounter::bytes().load(), bytes_before + 192);
+}
+
+TEST(StatRecordFileTest, AppendAndReadRoundTrip) {
+    std::string path = "/tmp/morphect_stat_records_test.bin";
+    std::remove(path.c_str());
+
+    Statistics first;
+    first.increment("gimple_mba.add_transforms", 3);
+    first.increment("functions_processed", 10);
+
+    Statistics second;
+    second.increment("gimple_mba.add_transforms", 2);
+    second.increment("gimple_mba.xor_transforms", 7);
+    second.increment("functions_processed", 5);
+
+    // Two appenders simulate two compiler processes sharing one file
+    ASSERT_TRUE(StatRecordFile::append(path, first));
+    ASSERT_TRUE(StatRecordFile::append(path, second));
+
+    Statistics merged;
+    ASSERT_TRUE(StatRecordFile::read(path, merged));
+
+    EXPECT_EQ(merged.getInt("gimple_mba.add_transforms"), 5);
+    EXPECT_EQ(merged.getInt("gimple_mba.xor_transforms"), 7);
+    EXPECT_EQ(merged.getInt("functions_processed"), 15);
+
+    std::remove(path.c_str());
+}
+
+TEST(StatRecordFileTest, TruncatesOverlongNames) {
+    std::string path = "/tmp/morphect_stat_records_long.bin";
+    std::remove(path.c_str());
+
+    std::string long_name(80, 'x');
+    Statistics stats;
+    stats.increment(long_name, 4);
+
+    ASSERT_TRUE(StatRecordFile::append(path, stats));
+
+    Statistics merged;
+    ASSERT_TRUE(StatRecordFile::read(path, merged));
+
+    // Names are clamped to the fixed record field, value is preserved
+    std::string truncated(sizeof(StatRecordFile::Record::name) - 1, 'x');
+    EXPECT_EQ(merged.getInt(truncated), 4);
+
+    std::remove(path.c_str());
+}
+
+TEST(StatRecordFileTest, ReadFailsForMissingFile) {
+    Statistics merged;
+    EXPECT_FALSE(StatRecordFile::read("/tmp/morphect_no_such_records.bin", merged));
+}
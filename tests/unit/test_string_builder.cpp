@@ -0,0 +1,47 @@
+/**
+ * Morphect - StringBuilder Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/string_builder.hpp"
+
+using namespace morphect;
+
+TEST(StringBuilderTest, AppendsTextCharsAndIntegers) {
+    StringBuilder out(64);
+    out.append("decode(").append("%str").append(", ")
+       .append(42).append(", ").append(-7).append(')');
+
+    EXPECT_EQ(out.str(), "decode(%str, 42, -7)");
+    EXPECT_EQ(out.size(), out.str().size());
+}
+
+TEST(StringBuilderTest, HandlesUnsignedAndWideValues) {
+    StringBuilder out;
+    out.append(static_cast<size_t>(18446744073709551615ull))
+       .append(' ')
+       .append(static_cast<long long>(-9223372036854775807ll));
+
+    EXPECT_EQ(out.str(), "18446744073709551615 -9223372036854775807");
+}
+
+TEST(StringBuilderTest, TakeMovesOutAndResets) {
+    StringBuilder out;
+    out.append("line");
+
+    std::string taken = out.take();
+    EXPECT_EQ(taken, "line");
+    EXPECT_TRUE(out.empty());
+
+    out.append(1);
+    EXPECT_EQ(out.str(), "1");
+}
+
+TEST(StringBuilderTest, ClearKeepsBuilderUsable) {
+    StringBuilder out;
+    out.append("abc");
+    out.clear();
+    EXPECT_TRUE(out.empty());
+    out.append("def");
+    EXPECT_EQ(out.str(), "def");
+}
@@ -0,0 +1,72 @@
+/**
+ * Morphect - String Interner Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/string_interner.hpp"
+
+using namespace morphect;
+
+TEST(StringInternerTest, SameSpellingGetsSameId) {
+    StringInterner interner;
+
+    auto a = interner.intern("%phi_var_0");
+    auto b = interner.intern("%phi_var_1");
+    auto a2 = interner.intern("%phi_var_0");
+
+    EXPECT_EQ(a, a2);
+    EXPECT_NE(a, b);
+    EXPECT_EQ(interner.size(), 2u);
+}
+
+TEST(StringInternerTest, IdsAreDenseInFirstSeenOrder) {
+    StringInterner interner;
+
+    EXPECT_EQ(interner.intern("entry"), 0u);
+    EXPECT_EQ(interner.intern("loop"), 1u);
+    EXPECT_EQ(interner.intern("exit"), 2u);
+    EXPECT_EQ(interner.intern("loop"), 1u);
+}
+
+TEST(StringInternerTest, ViewRoundTrips) {
+    StringInterner interner;
+
+    auto id = interner.intern("LBB0_3");
+    EXPECT_EQ(interner.view(id), "LBB0_3");
+}
+
+TEST(StringInternerTest, FindDoesNotIntern) {
+    StringInterner interner;
+    interner.intern("known");
+
+    EXPECT_EQ(interner.find("known"), 0u);
+    EXPECT_EQ(interner.find("unknown"), StringInterner::kInvalidSymbol);
+    EXPECT_EQ(interner.size(), 1u);
+}
+
+TEST(StringInternerTest, ViewsStayValidAcrossManyInterns) {
+    StringInterner interner;
+
+    // Force several backing blocks and check early views still resolve
+    auto first = interner.intern("first_symbol");
+    std::string_view first_view = interner.view(first);
+
+    for (int i = 0; i < 20000; i++) {
+        interner.intern("sym_" + std::to_string(i));
+    }
+
+    EXPECT_EQ(first_view, "first_symbol");
+    EXPECT_EQ(interner.view(first), "first_symbol");
+    EXPECT_EQ(interner.find("sym_19999"), interner.size() - 1);
+}
+
+TEST(StringInternerTest, ClearEmptiesTheTable) {
+    StringInterner interner;
+    interner.intern("a");
+    interner.intern("b");
+
+    interner.clear();
+    EXPECT_TRUE(interner.empty());
+    EXPECT_EQ(interner.find("a"), StringInterner::kInvalidSymbol);
+    EXPECT_EQ(interner.intern("c"), 0u);
+}
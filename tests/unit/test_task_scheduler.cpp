@@ -0,0 +1,108 @@
+/**
+ * Morphect - Work-Stealing Scheduler Tests
+ */
+
+#include <gtest/gtest.h>
+#include "core/task_scheduler.hpp"
+
+#include <atomic>
+#include <vector>
+
+using namespace morphect;
+
+TEST(WorkStealingSchedulerTest, RunsEveryTask) {
+    WorkStealingScheduler scheduler;
+    std::atomic<int> ran{0};
+
+    for (int i = 0; i < 100; i++) {
+        scheduler.addTask([&]() { ran++; });
+    }
+    scheduler.run(4);
+
+    EXPECT_EQ(ran.load(), 100);
+}
+
+TEST(WorkStealingSchedulerTest, DependenciesRunBeforeDependents) {
+    WorkStealingScheduler scheduler;
+    std::atomic<bool> first_done{false};
+    std::atomic<bool> ordered{true};
+
+    auto first = scheduler.addTask([&]() { first_done = true; });
+    scheduler.addTask([&]() {
+        if (!first_done.load()) ordered = false;
+    }, {first});
+
+    scheduler.run(4);
+    EXPECT_TRUE(ordered.load());
+}
+
+TEST(WorkStealingSchedulerTest, ChainsRunInOrder) {
+    WorkStealingScheduler scheduler;
+
+    // 8 independent chains of 10 stages each: every stage must see the
+    // chain's counter exactly at its own position
+    std::vector<std::atomic<int>> counters(8);
+    std::atomic<int> violations{0};
+
+    for (int chain = 0; chain < 8; chain++) {
+        counters[chain] = 0;
+        WorkStealingScheduler::TaskId prev = scheduler.addTask(
+            [&, chain]() { counters[chain]++; });
+        for (int stage = 1; stage < 10; stage++) {
+            prev = scheduler.addTask([&, chain, stage]() {
+                if (counters[chain].load() != stage) violations++;
+                counters[chain]++;
+            }, {prev});
+        }
+    }
+
+    scheduler.run(4);
+    EXPECT_EQ(violations.load(), 0);
+    for (int chain = 0; chain < 8; chain++) {
+        EXPECT_EQ(counters[chain].load(), 10);
+    }
+}
+
+TEST(WorkStealingSchedulerTest, DiamondJoinWaitsForBothSides) {
+    WorkStealingScheduler scheduler;
+    std::atomic<int> sides_done{0};
+    std::atomic<int> join_saw{-1};
+
+    auto top = scheduler.addTask([]() {});
+    auto left = scheduler.addTask([&]() { sides_done++; }, {top});
+    auto right = scheduler.addTask([&]() { sides_done++; }, {top});
+    scheduler.addTask([&]() { join_saw = sides_done.load(); }, {left, right});
+
+    scheduler.run(4);
+    EXPECT_EQ(join_saw.load(), 2);
+}
+
+TEST(WorkStealingSchedulerTest, SingleWorkerStillCompletesGraph) {
+    WorkStealingScheduler scheduler;
+    std::atomic<int> ran{0};
+
+    auto a = scheduler.addTask([&]() { ran++; });
+    auto b = scheduler.addTask([&]() { ran++; }, {a});
+    scheduler.addTask([&]() { ran++; }, {b});
+
+    scheduler.run(1);
+    EXPECT_EQ(ran.load(), 3);
+}
+
+TEST(WorkStealingSchedulerTest, SkewedGraphKeepsWorkersBusy) {
+    WorkStealingScheduler scheduler;
+
+    // One long chain next to many short tasks: stealing lets the short
+    // tasks finish on other workers while the chain occupies one
+    std::atomic<int> ran{0};
+    WorkStealingScheduler::TaskId prev = scheduler.addTask([&]() { ran++; });
+    for (int i = 0; i < 50; i++) {
+        prev = scheduler.addTask([&]() { ran++; }, {prev});
+    }
+    for (int i = 0; i < 200; i++) {
+        scheduler.addTask([&]() { ran++; });
+    }
+
+    scheduler.run(4);
+    EXPECT_EQ(ran.load(), 251);
+}
@@ -0,0 +1,132 @@
+/**
+ * Morphect - Transformation Trace Tests
+ */
+
+#include <gtest/gtest.h>
+#include "common/transform_trace.hpp"
+
+#include <cstdio>
+#include <vector>
+#include <tuple>
+
+using namespace morphect;
+
+namespace {
+
+const char* kTraceFile = "/tmp/morphect_trace_test.bin";
+
+using Replayed = std::vector<std::tuple<std::string, std::string, std::string, int>>;
+
+Replayed replay(const std::string& path) {
+    Replayed out;
+    TransformTrace::readFile(path, [&](std::string_view func, std::string_view pass,
+                                       std::string_view op, int line) {
+        out.emplace_back(std::string(func), std::string(pass), std::string(op), line);
+    });
+    return out;
+}
+
+} // namespace
+
+TEST(TransformTraceTest, RecordsAndIteratesInOrder) {
+    TransformTrace trace(16);
+
+    trace.record("main", "MBA", "add_to_mba", 10);
+    trace.record("main", "CFF", "flatten", 12);
+    trace.record("helper", "MBA", "xor_to_mba");
+
+    EXPECT_EQ(trace.size(), 3u);
+    EXPECT_EQ(trace.dropped(), 0u);
+
+    Replayed seen;
+    trace.forEach([&](std::string_view func, std::string_view pass,
+                      std::string_view op, int line) {
+        seen.emplace_back(std::string(func), std::string(pass), std::string(op), line);
+    });
+
+    ASSERT_EQ(seen.size(), 3u);
+    EXPECT_EQ(seen[0], std::make_tuple(std::string("main"), std::string("MBA"),
+                                       std::string("add_to_mba"), 10));
+    EXPECT_EQ(seen[2], std::make_tuple(std::string("helper"), std::string("MBA"),
+                                       std::string("xor_to_mba"), -1));
+}
+
+TEST(TransformTraceTest, RingDropsOldestWhenFull) {
+    TransformTrace trace(4);
+
+    for (int i = 0; i < 10; i++) {
+        trace.record("f", "MBA", "op_" + std::to_string(i));
+    }
+
+    EXPECT_EQ(trace.size(), 4u);
+    EXPECT_EQ(trace.dropped(), 6u);
+
+    std::vector<std::string> ops;
+    trace.forEach([&](std::string_view, std::string_view,
+                      std::string_view op, int) {
+        ops.emplace_back(op);
+    });
+    ASSERT_EQ(ops.size(), 4u);
+    EXPECT_EQ(ops.front(), "op_6");  // oldest retained
+    EXPECT_EQ(ops.back(), "op_9");
+}
+
+TEST(TransformTraceTest, StreamedFileReplaysEveryRecord) {
+    std::remove(kTraceFile);
+    {
+        TransformTrace trace(2);  // tiny ring: the file must keep full fidelity
+        ASSERT_TRUE(trace.openStream(kTraceFile));
+
+        for (int i = 0; i < 50; i++) {
+            trace.record("func_" + std::to_string(i % 5), "DeadCode",
+                         "block_inserted", i);
+        }
+        trace.closeStream();
+    }
+
+    Replayed seen = replay(kTraceFile);
+    ASSERT_EQ(seen.size(), 50u);
+    EXPECT_EQ(std::get<0>(seen[0]), "func_0");
+    EXPECT_EQ(std::get<1>(seen[49]), "DeadCode");
+    EXPECT_EQ(std::get<3>(seen[49]), 49);
+    std::remove(kTraceFile);
+}
+
+TEST(TransformTraceTest, StringsAreStreamedOnce) {
+    std::remove(kTraceFile);
+    {
+        TransformTrace trace;
+        ASSERT_TRUE(trace.openStream(kTraceFile));
+        // 1000 records over 3 distinct strings: file stays near
+        // 1000 x 17 bytes, not 1000 x the spelled-out strings
+        for (int i = 0; i < 1000; i++) {
+            trace.record("a_rather_long_function_name", "MBA", "add_to_mba");
+        }
+        trace.closeStream();
+    }
+
+    std::ifstream in(kTraceFile, std::ios::binary | std::ios::ate);
+    ASSERT_TRUE(in.is_open());
+    size_t bytes = static_cast<size_t>(in.tellg());
+    EXPECT_LT(bytes, 1000 * 17 + 256);
+
+    EXPECT_EQ(replay(kTraceFile).size(), 1000u);
+    std::remove(kTraceFile);
+}
+
+TEST(TransformTraceTest, ReadFileRejectsGarbage) {
+    std::remove(kTraceFile);
+    {
+        std::ofstream out(kTraceFile, std::ios::binary);
+        out << "not a trace";
+    }
+
+    bool called = false;
+    EXPECT_FALSE(TransformTrace::readFile(
+        kTraceFile,
+        [&](std::string_view, std::string_view, std::string_view, int) {
+            called = true;
+        }));
+    EXPECT_FALSE(called);
+    std::remove(kTraceFile);
+}